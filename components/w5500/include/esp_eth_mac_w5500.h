@@ -46,6 +46,42 @@ typedef struct {
 esp_eth_mac_t *esp_eth_mac_new_w5500(const eth_w5500_config_t *w5500_config,
                                      const eth_mac_config_t *mac_config);
 
+/**
+ * @brief Receive frame pool statistics
+ */
+typedef struct {
+    uint32_t frames_total;      /*!< Number of frame buffers in the pool */
+    uint32_t frames_free;       /*!< Buffers currently free */
+    uint32_t frames_min_free;   /*!< Lowest number of free buffers seen */
+    uint32_t frames_received;   /*!< Frames handed to the stack */
+    uint32_t dropped_no_buf;    /*!< Frames dropped because the pool was empty */
+    uint32_t dropped_overload;  /*!< Broadcast/multicast frames dropped to keep the unicast reserve */
+} eth_w5500_rx_pool_stats_t;
+
+/**
+ * @brief Get the receive frame pool statistics
+ *
+ * @param mac: W5500 MAC instance
+ * @param stats: returned statistics
+ *
+ * @return
+ *      - ESP_OK: statistics returned
+ *      - ESP_ERR_INVALID_ARG: invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: the frame pool is disabled (CONFIG_W5500_RX_FRAME_POOL)
+ */
+esp_err_t esp_eth_mac_w5500_get_rx_pool_stats(esp_eth_mac_t *mac, eth_w5500_rx_pool_stats_t *stats);
+
+/**
+ * @brief Release a received frame buffer passed to the stack
+ *
+ * Receive buffers come from the frame pool when CONFIG_W5500_RX_FRAME_POOL is enabled, so the stack
+ * must release them here instead of with free(). Install it as the netif driver_free_rx_buffer.
+ * Falls back to free() when the pool is disabled.
+ *
+ * @param buf: frame buffer received from the stack input path
+ */
+void esp_eth_mac_w5500_free_rx_buf(void *buf);
+
 #ifdef __cplusplus
 }
 #endif
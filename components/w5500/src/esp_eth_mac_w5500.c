@@ -20,6 +20,7 @@
 #include "esp_system.h"
 #include "esp_intr_alloc.h"
 #include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
 #include "esp_cpu.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
@@ -36,14 +37,36 @@ static const char *TAG = "w5500.mac";
 #define W5500_100M_TX_TMO_US (200)
 #define W5500_10M_TX_TMO_US (1500)
 #define W5500_ETH_MAC_RX_BUF_SIZE_AUTO (0)
+// frame header (2 bytes) + largest frame, in whole words so DMA reads land in place
+#define W5500_RX_BUF_SIZE ((ETH_MAX_PACKET_SIZE + 2 + 3) & ~3)
 
 typedef struct {
     uint32_t offset;
     uint32_t copy_len;
     uint32_t rx_len;
     uint32_t remain;
+    uint32_t fetched; // payload bytes already read into rx_buffer along with the header
 } __attribute__((packed)) emac_w5500_auto_buf_info_t;
 
+#if CONFIG_W5500_RX_FRAME_POOL
+// each pool slot starts with a word pointing back at its pool, followed by the frame buffer
+#define W5500_RX_SLOT_HDR_SIZE (4)
+#define W5500_RX_SLOT_SIZE (W5500_RX_SLOT_HDR_SIZE + W5500_RX_BUF_SIZE)
+_Static_assert(sizeof(void *) <= W5500_RX_SLOT_HDR_SIZE, "pool pointer must fit the slot header");
+
+typedef struct {
+    uint8_t *mem;           // all slots, one DMA-capable allocation
+    uint8_t *free_slots[CONFIG_W5500_RX_POOL_FRAMES];
+    uint32_t free_cnt;
+    uint32_t min_free;
+    uint32_t received;
+    uint32_t dropped_no_buf;
+    uint32_t dropped_overload;
+    bool orphaned;          // MAC deleted while the stack still held frames
+    portMUX_TYPE lock;
+} w5500_rx_pool_t;
+#endif
+
 typedef struct {
     spi_device_handle_t hdl;
     SemaphoreHandle_t lock;
@@ -69,6 +92,10 @@ typedef struct {
     uint8_t addr[ETH_ADDR_LEN];
     bool packets_remain;
     uint8_t *rx_buffer;
+    uint8_t *tx_buffer;
+#if CONFIG_W5500_RX_FRAME_POOL
+    w5500_rx_pool_t *rx_pool;
+#endif
     uint8_t mcast_cnt;
     uint32_t tx_tmo;
 } emac_w5500_t;
@@ -131,6 +158,24 @@ static inline bool w5500_spi_unlock(eth_spi_info_t *spi)
     return xSemaphoreGive(spi->lock) == pdTRUE;
 }
 
+/* Longer transfers are queued and completed by the SPI interrupt, so the calling task blocks instead of
+ * spinning while the frame is clocked out. Short register accesses stay polled: at these lengths the
+ * interrupt round-trip would cost more than the transfer itself. */
+static esp_err_t w5500_spi_transmit(eth_spi_info_t *spi, spi_transaction_t *trans, uint32_t len)
+{
+#if CONFIG_W5500_SPI_QUEUED_TRANS
+    if (len > CONFIG_W5500_SPI_POLL_MAX_BYTES) {
+        spi_transaction_t *done = NULL;
+        esp_err_t ret = spi_device_queue_trans(spi->hdl, trans, portMAX_DELAY);
+        if (ret == ESP_OK) {
+            ret = spi_device_get_trans_result(spi->hdl, &done, portMAX_DELAY);
+        }
+        return ret;
+    }
+#endif
+    return spi_device_polling_transmit(spi->hdl, trans);
+}
+
 static esp_err_t w5500_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, const void *value, uint32_t len)
 {
     esp_err_t ret = ESP_OK;
@@ -143,7 +188,7 @@ static esp_err_t w5500_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, con
         .tx_buffer = value
     };
     if (w5500_spi_lock(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (w5500_spi_transmit(spi, &trans, len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -167,7 +212,7 @@ static esp_err_t w5500_spi_read(void *spi_ctx, uint32_t cmd, uint32_t addr, void
         .rx_buffer = value
     };
     if (w5500_spi_lock(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (w5500_spi_transmit(spi, &trans, len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -249,6 +294,22 @@ err:
     return ret;
 }
 
+// RX_RSR and RX_RD are adjacent, so one 4-byte read returns both; RSR is read until stable as above
+static esp_err_t w5500_get_rx_state(emac_w5500_t *emac, uint16_t *size, uint16_t *offset)
+{
+    esp_err_t ret = ESP_OK;
+    uint16_t regs0[2], regs1[2] = {0};
+    do {
+        ESP_GOTO_ON_ERROR(w5500_read(emac, W5500_REG_SOCK_RX_RSR(0), regs0, sizeof(regs0)), err, TAG, "read RX RSR failed");
+        ESP_GOTO_ON_ERROR(w5500_read(emac, W5500_REG_SOCK_RX_RSR(0), regs1, sizeof(regs1)), err, TAG, "read RX RSR failed");
+    } while (regs0[0] != regs1[0]);
+    *size = __builtin_bswap16(regs1[0]);
+    *offset = __builtin_bswap16(regs1[1]);
+
+err:
+    return ret;
+}
+
 static esp_err_t w5500_write_buffer(emac_w5500_t *emac, const void *buffer, uint32_t len, uint16_t offset)
 {
     esp_err_t ret = ESP_OK;
@@ -635,6 +696,11 @@ static esp_err_t emac_w5500_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_t
     // get current write pointer
     ESP_GOTO_ON_ERROR(w5500_read(emac, W5500_REG_SOCK_TX_WR(0), &offset, sizeof(offset)), err, TAG, "read TX WR failed");
     offset = __builtin_bswap16(offset);
+    // stage frames the SPI DMA cannot read in place, instead of the SPI driver allocating a bounce buffer
+    if (emac->tx_buffer && (!esp_ptr_dma_capable(buf) || ((uintptr_t)buf & 3))) {
+        memcpy(emac->tx_buffer, buf, length);
+        buf = emac->tx_buffer;
+    }
     // copy data to tx memory
     ESP_GOTO_ON_ERROR(w5500_write_buffer(emac, buf, length, offset), err, TAG, "write frame failed");
     // update write pointer
@@ -663,6 +729,111 @@ err:
     return ret;
 }
 
+#if CONFIG_W5500_RX_FRAME_POOL
+static w5500_rx_pool_t *w5500_rx_pool_new(void)
+{
+    w5500_rx_pool_t *pool = calloc(1, sizeof(w5500_rx_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+    pool->mem = heap_caps_aligned_alloc(4, CONFIG_W5500_RX_POOL_FRAMES * W5500_RX_SLOT_SIZE, MALLOC_CAP_DMA);
+    if (!pool->mem) {
+        free(pool);
+        return NULL;
+    }
+    for (int i = 0; i < CONFIG_W5500_RX_POOL_FRAMES; i++) {
+        uint8_t *slot = pool->mem + i * W5500_RX_SLOT_SIZE;
+        *(w5500_rx_pool_t **)slot = pool;
+        pool->free_slots[i] = slot + W5500_RX_SLOT_HDR_SIZE;
+    }
+    pool->free_cnt = CONFIG_W5500_RX_POOL_FRAMES;
+    pool->min_free = CONFIG_W5500_RX_POOL_FRAMES;
+    portMUX_INITIALIZE(&pool->lock);
+    return pool;
+}
+
+static void w5500_rx_pool_delete(w5500_rx_pool_t *pool)
+{
+    if (!pool) {
+        return;
+    }
+    bool in_use;
+    portENTER_CRITICAL(&pool->lock);
+    in_use = pool->free_cnt < CONFIG_W5500_RX_POOL_FRAMES;
+    pool->orphaned = in_use;
+    portEXIT_CRITICAL(&pool->lock);
+    if (!in_use) {
+        heap_caps_free(pool->mem);
+        free(pool);
+    }
+    // otherwise the last buffer released by the stack frees the pool
+}
+
+// Take a frame buffer, or NULL to drop the frame. Group (broadcast/multicast) frames are refused once only
+// the unicast reserve is left, so floods on the segment cannot starve the TCP sessions of buffers.
+static uint8_t *w5500_rx_pool_alloc(w5500_rx_pool_t *pool, bool group_addr)
+{
+    uint8_t *buf = NULL;
+    portENTER_CRITICAL(&pool->lock);
+    if (pool->free_cnt == 0) {
+        pool->dropped_no_buf++;
+    } else if (group_addr && pool->free_cnt <= CONFIG_W5500_RX_POOL_UNICAST_RESERVE) {
+        pool->dropped_overload++;
+    } else {
+        buf = pool->free_slots[--pool->free_cnt];
+        if (pool->free_cnt < pool->min_free) {
+            pool->min_free = pool->free_cnt;
+        }
+        pool->received++;
+    }
+    portEXIT_CRITICAL(&pool->lock);
+    return buf;
+}
+#endif
+
+void esp_eth_mac_w5500_free_rx_buf(void *buf)
+{
+    if (!buf) {
+        return;
+    }
+#if CONFIG_W5500_RX_FRAME_POOL
+    w5500_rx_pool_t *pool = *(w5500_rx_pool_t **)((uint8_t *)buf - W5500_RX_SLOT_HDR_SIZE);
+    bool release;
+    portENTER_CRITICAL(&pool->lock);
+    pool->free_slots[pool->free_cnt++] = buf;
+    release = pool->orphaned && pool->free_cnt == CONFIG_W5500_RX_POOL_FRAMES;
+    portEXIT_CRITICAL(&pool->lock);
+    if (release) {
+        heap_caps_free(pool->mem);
+        free(pool);
+    }
+#else
+    free(buf);
+#endif
+}
+
+esp_err_t esp_eth_mac_w5500_get_rx_pool_stats(esp_eth_mac_t *mac, eth_w5500_rx_pool_stats_t *stats)
+{
+    if (!mac || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if CONFIG_W5500_RX_FRAME_POOL
+    emac_w5500_t *emac = __containerof(mac, emac_w5500_t, parent);
+    w5500_rx_pool_t *pool = emac->rx_pool;
+    portENTER_CRITICAL(&pool->lock);
+    stats->frames_total = CONFIG_W5500_RX_POOL_FRAMES;
+    stats->frames_free = pool->free_cnt;
+    stats->frames_min_free = pool->min_free;
+    stats->frames_received = pool->received;
+    stats->dropped_no_buf = pool->dropped_no_buf;
+    stats->dropped_overload = pool->dropped_overload;
+    portEXIT_CRITICAL(&pool->lock);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 static esp_err_t emac_w5500_alloc_recv_buf(emac_w5500_t *emac, uint8_t **buf, uint32_t *length)
 {
     esp_err_t ret = ESP_OK;
@@ -670,27 +841,38 @@ static esp_err_t emac_w5500_alloc_recv_buf(emac_w5500_t *emac, uint8_t **buf, ui
     uint16_t rx_len = 0;
     uint32_t copy_len = 0;
     uint16_t remain_bytes = 0;
+    uint32_t fetch_len = 0;
     *buf = NULL;
 
-    w5500_get_rx_received_size(emac, &remain_bytes);
+    // get received size and current read pointer
+    ESP_GOTO_ON_ERROR(w5500_get_rx_state(emac, &remain_bytes, &offset), err, TAG, "get RX state failed");
     if (remain_bytes) {
-        // get current read pointer
-        ESP_GOTO_ON_ERROR(w5500_read(emac, W5500_REG_SOCK_RX_RD(0), &offset, sizeof(offset)), err, TAG, "read RX RD failed");
-        offset = __builtin_bswap16(offset);
-        // read head
-        ESP_GOTO_ON_ERROR(w5500_read_buffer(emac, &rx_len, sizeof(rx_len), offset), err, TAG, "read frame header failed");
+        // read head and payload in one go: the first frame lies within the received bytes, and reading
+        // past it has no side effects (RX RD only moves when written)
+        fetch_len = (remain_bytes + 3) & ~3;
+        if (fetch_len > W5500_RX_BUF_SIZE) {
+            fetch_len = W5500_RX_BUF_SIZE;
+        }
+        ESP_GOTO_ON_ERROR(w5500_read_buffer(emac, emac->rx_buffer, fetch_len, offset), err, TAG, "read frame failed");
+        memcpy(&rx_len, emac->rx_buffer, sizeof(rx_len));
         rx_len = __builtin_bswap16(rx_len) - 2; // data size includes 2 bytes of header
         // frames larger than expected will be truncated
         copy_len = rx_len > *length ? *length : rx_len;
         // runt frames are not forwarded by W5500 (tested on target), but check the length anyway since it could be corrupted at SPI bus
         ESP_GOTO_ON_FALSE(copy_len >= ETH_MIN_PACKET_SIZE - ETH_CRC_LEN, ESP_ERR_INVALID_SIZE, err, TAG, "invalid frame length %" PRIu32, copy_len);
+#if CONFIG_W5500_RX_FRAME_POOL
+        // the destination address follows the 2-byte header; its I/G bit marks broadcast and multicast
+        *buf = w5500_rx_pool_alloc(emac->rx_pool, emac->rx_buffer[2] & 0x01);
+#else
         *buf = malloc(copy_len);
+#endif
         if (*buf != NULL) {
             emac_w5500_auto_buf_info_t *buff_info = (emac_w5500_auto_buf_info_t *)*buf;
             buff_info->offset = offset;
             buff_info->copy_len = copy_len;
             buff_info->rx_len = rx_len;
             buff_info->remain = remain_bytes;
+            buff_info->fetched = fetch_len - 2;
         } else {
             ret = ESP_ERR_NO_MEM;
             goto err;
@@ -709,6 +891,7 @@ static esp_err_t emac_w5500_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *
     uint16_t rx_len = 0;
     uint16_t copy_len = 0;
     uint16_t remain_bytes = 0;
+    uint32_t fetched = 0;
     emac->packets_remain = false;
 
     if (*length != W5500_ETH_MAC_RX_BUF_SIZE_AUTO) {
@@ -732,12 +915,18 @@ static esp_err_t emac_w5500_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *
         copy_len = buff_info->copy_len;
         rx_len = buff_info->rx_len;
         remain_bytes = buff_info->remain;
+        fetched = buff_info->fetched;
     }
     // 2 bytes of header
     offset += 2;
-    // read the payload
-    ESP_GOTO_ON_ERROR(w5500_read_buffer(emac, emac->rx_buffer, copy_len, offset), err, TAG, "read payload failed, len=%" PRIu16 ", offset=%" PRIu16, rx_len, offset);
-    memcpy(buf, emac->rx_buffer, copy_len);
+    if (fetched >= copy_len) {
+        // payload came with the header
+        memcpy(buf, emac->rx_buffer + 2, copy_len);
+    } else {
+        // read the payload
+        ESP_GOTO_ON_ERROR(w5500_read_buffer(emac, emac->rx_buffer, copy_len, offset), err, TAG, "read payload failed, len=%" PRIu16 ", offset=%" PRIu16, rx_len, offset);
+        memcpy(buf, emac->rx_buffer, copy_len);
+    }
     offset += rx_len;
     // update read pointer
     offset = __builtin_bswap16(offset);
@@ -836,10 +1025,10 @@ static void emac_w5500_task(void *arg)
                         buf_len = W5500_ETH_MAC_RX_BUF_SIZE_AUTO;
                         if (emac->parent.receive(&emac->parent, buffer, &buf_len) == ESP_OK) {
                             if (buf_len == 0) {
-                                free(buffer);
+                                esp_eth_mac_w5500_free_rx_buf(buffer);
                             } else if (frame_len > buf_len) {
                                 ESP_LOGE(TAG, "received frame was truncated");
-                                free(buffer);
+                                esp_eth_mac_w5500_free_rx_buf(buffer);
                             } else {
                                 ESP_LOGD(TAG, "receive len=%" PRIu32, buf_len);
                                 /* pass the buffer to stack (e.g. TCP/IP layer) */
@@ -847,13 +1036,18 @@ static void emac_w5500_task(void *arg)
                             }
                         } else {
                             ESP_LOGE(TAG, "frame read from module failed");
-                            free(buffer);
+                            esp_eth_mac_w5500_free_rx_buf(buffer);
                         }
                     } else if (frame_len) {
                         ESP_LOGE(TAG, "invalid combination of frame_len(%" PRIu32 ") and buffer pointer(%p)", frame_len, buffer);
                     }
                 } else if (ret == ESP_ERR_NO_MEM) {
+#if CONFIG_W5500_RX_FRAME_POOL
+                    /* pool empty or reserved for unicast: drop the frame early, the pool counts it */
+                    ESP_LOGD(TAG, "no free frame buffer, frame dropped");
+#else
                     ESP_LOGE(TAG, "no mem for receive buffer");
+#endif
                     emac_w5500_flush_recv_frame(emac);
                 } else {
                     ESP_LOGE(TAG, "unexpected error 0x%x", ret);
@@ -919,6 +1113,10 @@ static esp_err_t emac_w5500_del(esp_eth_mac_t *mac)
     vTaskDelete(emac->rx_task_hdl);
     emac->spi.deinit(emac->spi.ctx);
     heap_caps_free(emac->rx_buffer);
+    heap_caps_free(emac->tx_buffer);
+#if CONFIG_W5500_RX_FRAME_POOL
+    w5500_rx_pool_delete(emac->rx_pool);
+#endif
     free(emac);
     return ESP_OK;
 }
@@ -985,8 +1183,16 @@ esp_eth_mac_t *esp_eth_mac_new_w5500(const eth_w5500_config_t *w5500_config, con
                                                    mac_config->rx_task_prio, &emac->rx_task_hdl, core_num);
     ESP_GOTO_ON_FALSE(xReturned == pdPASS, NULL, err, TAG, "create w5500 task failed");
 
-    emac->rx_buffer = heap_caps_malloc(ETH_MAX_PACKET_SIZE, MALLOC_CAP_DMA);
+    emac->rx_buffer = heap_caps_aligned_alloc(4, W5500_RX_BUF_SIZE, MALLOC_CAP_DMA);
     ESP_GOTO_ON_FALSE(emac->rx_buffer, NULL, err, TAG, "RX buffer allocation failed");
+#if CONFIG_W5500_SPI_QUEUED_TRANS
+    emac->tx_buffer = heap_caps_aligned_alloc(4, ETH_MAX_PACKET_SIZE, MALLOC_CAP_DMA);
+    ESP_GOTO_ON_FALSE(emac->tx_buffer, NULL, err, TAG, "TX buffer allocation failed");
+#endif
+#if CONFIG_W5500_RX_FRAME_POOL
+    emac->rx_pool = w5500_rx_pool_new();
+    ESP_GOTO_ON_FALSE(emac->rx_pool, NULL, err, TAG, "RX frame pool allocation failed");
+#endif
 
     if (emac->int_gpio_num < 0) {
         const esp_timer_create_args_t poll_timer_args = {
@@ -1012,6 +1218,10 @@ err:
             emac->spi.deinit(emac->spi.ctx);
         }
         heap_caps_free(emac->rx_buffer);
+        heap_caps_free(emac->tx_buffer);
+#if CONFIG_W5500_RX_FRAME_POOL
+        w5500_rx_pool_delete(emac->rx_pool);
+#endif
         free(emac);
     }
     return ret;
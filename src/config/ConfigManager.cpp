@@ -4,8 +4,12 @@
 #include "esp_log.h"
 #include "esp_mac.h"
 #include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "nvs.h"
 #include "nvs_flash.h"
+#include "../utils/JsonWriter.h"
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -13,12 +17,13 @@
 
 static const char *TAG = "ConfigManager";
 
-// NVS namespace and key
+// NVS namespace; each section has its own key (see SECTIONS)
 static const char *NVS_NAMESPACE = "appconfig";
+// Single-blob key used before per-section storage, migrated by init()
 static const char *NVS_KEY_FULLCONFIG = "fullconfig";
 
-// Configuration version
-static const uint32_t CONFIG_VERSION = 3;
+// Configuration version reported in FullConfig (sections have their own)
+static const uint32_t CONFIG_VERSION = 6;
 
 // Current configuration (cached in RAM)
 static ConfigManager::FullConfig s_config;
@@ -30,6 +35,8 @@ namespace ConfigManager {
 
 FullConfig getDefaultConfig() {
   FullConfig config;
+  // Zero the padding too: sections are compared by CRC to skip rewrites
+  memset((void *)&config, 0, sizeof(config));
   config.version = CONFIG_VERSION;
   config.crc32 = 0;
 
@@ -53,6 +60,8 @@ FullConfig getDefaultConfig() {
   config.network.wlanOp.staticIp = {192, 168, 1, 50};
   config.network.wlanOp.netmask = {255, 255, 255, 0};
   config.network.wlanOp.gateway = {192, 168, 1, 1};
+  config.network.wlanOp.profile = WifiProfile::ESTANDAR;
+  config.network.wlanOp.fixedChannel = 0;
 
   // Network - WLAN-SAFE defaults
   strncpy(config.network.wlanSafe.ssid, "DataLogger-AP",
@@ -64,6 +73,8 @@ FullConfig getDefaultConfig() {
   config.network.wlanSafe.apIp = {192, 168, 4, 1};
 
   config.network.webServerPort = 80;
+  config.network.tapPort = 0;
+  config.network.livePushMs = 1000;
 
   // Endpoint defaults
   strncpy(config.endpoint.hostName, "Device01",
@@ -86,6 +97,26 @@ FullConfig getDefaultConfig() {
           sizeof(config.mqtt.topicPub) - 1);
   strncpy(config.mqtt.topicSub, "datalogger/commands",
           sizeof(config.mqtt.topicSub) - 1);
+  config.mqtt.dataEnabled = false;
+  strncpy(config.mqtt.topicData, "datalogger/data",
+          sizeof(config.mqtt.topicData) - 1);
+  config.mqtt.dataBatchSize = 4096;
+  config.mqtt.dataCompress = false;
+
+  // Capture filter defaults (all off)
+  config.filter.stripBytes[0] = '\0';
+  config.filter.dropRunMin = 0;
+  config.filter.dedupeMax = 0;
+
+  // Protocol decoder defaults (off)
+  config.decoder.type = DecoderType::NINGUNO;
+  strncpy(config.decoder.topic, "datalogger/decoded",
+          sizeof(config.decoder.topic) - 1);
+
+  // Second UART defaults (off)
+  config.serial2.enabled = false;
+  config.serial2.baudRate = 115200;
+  config.serial2.rxPin = 4;
 
   // Web user defaults
   strncpy(config.webUser.username, "admin",
@@ -213,6 +244,20 @@ bool validateConfig(FullConfig *config, bool applyDefaults) {
       }
     }
   }
+  if (config->network.wlanOp.profile > WifiProfile::RENDIMIENTO) {
+    ESP_LOGW(TAG, "Invalid WLAN-OP profile (%d), using default",
+             (int)config->network.wlanOp.profile);
+    if (applyDefaults)
+      config->network.wlanOp.profile = defaults.network.wlanOp.profile;
+    isValid = false;
+  }
+  if (config->network.wlanOp.fixedChannel > 13) {
+    ESP_LOGW(TAG, "Invalid WLAN-OP channel (%d), scanning all channels",
+             config->network.wlanOp.fixedChannel);
+    if (applyDefaults)
+      config->network.wlanOp.fixedChannel = 0;
+    isValid = false;
+  }
 
   // Validate WLAN-SAFE (always active)
   if (strlen(config->network.wlanSafe.ssid) == 0) {
@@ -254,6 +299,22 @@ bool validateConfig(FullConfig *config, bool applyDefaults) {
       config->network.webServerPort = defaults.network.webServerPort;
     isValid = false;
   }
+  if (config->network.tapPort != 0 &&
+      config->network.tapPort == config->network.webServerPort) {
+    ESP_LOGW(TAG, "TCP tap port (%d) clashes with web server, disabling tap",
+             config->network.tapPort);
+    if (applyDefaults)
+      config->network.tapPort = defaults.network.tapPort;
+    isValid = false;
+  }
+  if (config->network.livePushMs != 0 &&
+      config->network.livePushMs < 100) { // LiveFeed::MIN_PERIOD_MS
+    ESP_LOGW(TAG, "Live push period %d ms too short, using default",
+             config->network.livePushMs);
+    if (applyDefaults)
+      config->network.livePushMs = defaults.network.livePushMs;
+    isValid = false;
+  }
 
   // Validate endpoint configuration (if device is ENDPOINT)
   if (config->device.type == DeviceType::ENDPOINT) {
@@ -346,6 +407,94 @@ bool validateConfig(FullConfig *config, bool applyDefaults) {
     }
   }
 
+  // Validate MQTT data forwarding (bounds the uplink buffers)
+  if (config->mqtt.dataBatchSize < 256 || config->mqtt.dataBatchSize > 16384) {
+    ESP_LOGW(TAG, "Invalid MQTT data batch size (%u), using default: %u",
+             config->mqtt.dataBatchSize, defaults.mqtt.dataBatchSize);
+    if (applyDefaults)
+      config->mqtt.dataBatchSize = defaults.mqtt.dataBatchSize;
+    isValid = false;
+  }
+  if (config->mqtt.dataEnabled && strlen(config->mqtt.topicData) == 0) {
+    ESP_LOGW(TAG, "Empty MQTT data topic, using default: %s",
+             defaults.mqtt.topicData);
+    if (applyDefaults)
+      strncpy(config->mqtt.topicData, defaults.mqtt.topicData,
+              sizeof(config->mqtt.topicData) - 1);
+    isValid = false;
+  }
+
+  // Validate capture filters (limits of the pipeline stages)
+  const char *strip = config->filter.stripBytes;
+  size_t stripLen = strnlen(strip, sizeof(config->filter.stripBytes));
+  bool stripValid = (stripLen % 2 == 0) &&
+                    stripLen < sizeof(config->filter.stripBytes);
+  for (size_t i = 0; stripValid && i < stripLen; i++) {
+    stripValid = isxdigit((unsigned char)strip[i]);
+  }
+  if (!stripValid) {
+    ESP_LOGW(TAG, "Invalid strip bytes, filter disabled");
+    if (applyDefaults)
+      memset(config->filter.stripBytes, 0,
+             sizeof(config->filter.stripBytes));
+    isValid = false;
+  }
+  if (config->filter.dropRunMin == 1 ||
+      config->filter.dropRunMin > 257) {
+    ESP_LOGW(TAG, "Invalid run length (%u), filter disabled",
+             config->filter.dropRunMin);
+    if (applyDefaults)
+      config->filter.dropRunMin = 0;
+    isValid = false;
+  }
+  if (config->filter.dedupeMax > 256) {
+    ESP_LOGW(TAG, "Invalid dedupe frame size (%u), filter disabled",
+             config->filter.dedupeMax);
+    if (applyDefaults)
+      config->filter.dedupeMax = 0;
+    isValid = false;
+  }
+
+  // Validate protocol decoder
+  if (config->decoder.type > DecoderType::ESC_POS) {
+    ESP_LOGW(TAG, "Invalid decoder type (%d), decoding disabled",
+             (int)config->decoder.type);
+    if (applyDefaults)
+      config->decoder.type = DecoderType::NINGUNO;
+    isValid = false;
+  }
+
+  // Validate second UART (GPIO 6-11 are the flash, above 39 do not exist)
+  if (config->serial2.enabled) {
+    if (config->serial2.baudRate < 9600 ||
+        config->serial2.baudRate > 921600) {
+      ESP_LOGW(TAG, "Invalid second UART baud rate (%lu), using default: %lu",
+               config->serial2.baudRate, defaults.serial2.baudRate);
+      if (applyDefaults)
+        config->serial2.baudRate = defaults.serial2.baudRate;
+      isValid = false;
+    }
+    int8_t rxPin = config->serial2.rxPin;
+    if (rxPin < 0 || rxPin > 39 || (rxPin >= 6 && rxPin <= 11)) {
+      ESP_LOGW(TAG, "Invalid second UART RX pin (%d), second UART disabled",
+               rxPin);
+      if (applyDefaults) {
+        config->serial2.enabled = false;
+        config->serial2.rxPin = defaults.serial2.rxPin;
+      }
+      isValid = false;
+    }
+  }
+  if (config->decoder.type != DecoderType::NINGUNO &&
+      strlen(config->decoder.topic) == 0) {
+    ESP_LOGW(TAG, "Empty decoder topic, using default: %s",
+             defaults.decoder.topic);
+    if (applyDefaults)
+      strncpy(config->decoder.topic, defaults.decoder.topic,
+              sizeof(config->decoder.topic) - 1);
+    isValid = false;
+  }
+
   // Validate web user credentials (always required)
   if (strlen(config->webUser.username) == 0) {
     ESP_LOGW(TAG, "Empty web username, using default: %s",
@@ -366,12 +515,13 @@ bool validateConfig(FullConfig *config, bool applyDefaults) {
   return isValid;
 }
 
-uint32_t calculateCrc32(const FullConfig *config) {
+// CRC32 of a whole-config blob (current or legacy layout)
+template <typename Config> static uint32_t blobCrc32(const Config *config) {
   // Calculate CRC32 of entire structure except the crc32 field and device.id field
   // device.id is generated dynamically from eFuses and never stored in NVS
   const uint8_t *data = (const uint8_t *)config;
-  size_t crcOffset = offsetof(FullConfig, crc32);
-  size_t idOffset = offsetof(FullConfig, device.id);
+  size_t crcOffset = offsetof(Config, crc32);
+  size_t idOffset = offsetof(Config, device.id);
   size_t idSize = sizeof(config->device.id);
   
   uint32_t crc = 0;
@@ -389,7 +539,7 @@ uint32_t calculateCrc32(const FullConfig *config) {
   
   // Skip device.id field
   size_t afterIdOffset = idOffset + idSize;
-  size_t totalSize = sizeof(FullConfig);
+  size_t totalSize = sizeof(Config);
   
   // CRC of data after device.id
   if (afterIdOffset < totalSize) {
@@ -399,6 +549,515 @@ uint32_t calculateCrc32(const FullConfig *config) {
   return crc;
 }
 
+uint32_t calculateCrc32(const FullConfig *config) { return blobCrc32(config); }
+
+// ============== JSON Export ==============
+
+esp_err_t toJson(const FullConfig *config, JsonWriter *json) {
+  if (!config || !json)
+    return ESP_ERR_INVALID_ARG;
+
+  json->beginObject();
+
+  json->key("device");
+  json->beginObject();
+  json->field("type", (int)config->device.type);
+  json->field("name", config->device.name);
+  json->field("id", config->device.id);
+  json->endObject();
+
+  json->key("network");
+  json->beginObject();
+  json->key("lan");
+  json->beginObject();
+  json->field("enabled", config->network.lan.enabled);
+  json->field("useDhcp", config->network.lan.useDhcp);
+  json->key("staticIp");
+  json->valueIp(config->network.lan.staticIp.addr);
+  json->key("netmask");
+  json->valueIp(config->network.lan.netmask.addr);
+  json->key("gateway");
+  json->valueIp(config->network.lan.gateway.addr);
+  json->endObject();
+  json->key("wlanOp");
+  json->beginObject();
+  json->field("enabled", config->network.wlanOp.enabled);
+  json->field("ssid", config->network.wlanOp.ssid);
+  json->field("password", config->network.wlanOp.password);
+  json->field("useDhcp", config->network.wlanOp.useDhcp);
+  json->key("staticIp");
+  json->valueIp(config->network.wlanOp.staticIp.addr);
+  json->key("netmask");
+  json->valueIp(config->network.wlanOp.netmask.addr);
+  json->key("gateway");
+  json->valueIp(config->network.wlanOp.gateway.addr);
+  json->field("profile", (int)config->network.wlanOp.profile);
+  json->field("fixedChannel", config->network.wlanOp.fixedChannel);
+  json->endObject();
+  json->key("wlanSafe");
+  json->beginObject();
+  json->field("ssid", config->network.wlanSafe.ssid);
+  json->field("password", config->network.wlanSafe.password);
+  json->field("channel", config->network.wlanSafe.channel);
+  json->field("hidden", config->network.wlanSafe.hidden);
+  json->key("apIp");
+  json->valueIp(config->network.wlanSafe.apIp.addr);
+  json->endObject();
+  json->field("webServerPort", config->network.webServerPort);
+  json->field("tapPort", config->network.tapPort);
+  json->field("livePushMs", config->network.livePushMs);
+  json->endObject();
+
+  json->key("endpoint");
+  json->beginObject();
+  json->field("hostName", config->endpoint.hostName);
+  json->field("source", (int)config->endpoint.source);
+  json->key("serial");
+  json->beginObject();
+  json->field("interface", (int)config->endpoint.serial.interface);
+  json->field("baudRate", config->endpoint.serial.baudRate);
+  json->field("dataBits", config->endpoint.serial.dataBits);
+  json->field("parity", (int)config->endpoint.serial.parity);
+  json->field("stopBits", (int)config->endpoint.serial.stopBits);
+  json->endObject();
+  json->endObject();
+
+  json->key("mqtt");
+  json->beginObject();
+  json->field("host", config->mqtt.host);
+  json->field("port", config->mqtt.port);
+  json->field("qos", config->mqtt.qos);
+  json->field("useAuth", config->mqtt.useAuth);
+  json->field("username", config->mqtt.username);
+  json->field("password", config->mqtt.password);
+  json->field("topicPub", config->mqtt.topicPub);
+  json->field("topicSub", config->mqtt.topicSub);
+  json->field("dataEnabled", config->mqtt.dataEnabled);
+  json->field("topicData", config->mqtt.topicData);
+  json->field("dataBatchSize", config->mqtt.dataBatchSize);
+  json->field("dataCompress", config->mqtt.dataCompress);
+  json->endObject();
+
+  json->key("filter");
+  json->beginObject();
+  json->field("stripBytes", config->filter.stripBytes);
+  json->field("dropRunMin", config->filter.dropRunMin);
+  json->field("dedupeMax", config->filter.dedupeMax);
+  json->endObject();
+
+  json->key("decoder");
+  json->beginObject();
+  json->field("type", (int)config->decoder.type);
+  json->field("topic", config->decoder.topic);
+  json->endObject();
+
+  json->key("serial2");
+  json->beginObject();
+  json->field("enabled", config->serial2.enabled);
+  json->field("baudRate", config->serial2.baudRate);
+  json->field("rxPin", config->serial2.rxPin);
+  json->endObject();
+
+  json->key("webUser");
+  json->beginObject();
+  json->field("username", config->webUser.username);
+  json->field("password", config->webUser.password);
+  json->endObject();
+
+  json->endObject();
+  return json->status();
+}
+
+// ============== Section Storage ==============
+
+namespace {
+
+/// Stored in front of every section blob
+struct SectionHeader {
+  uint16_t version; // Layout version of this section
+  uint16_t size;    // Payload size, guards against layout changes
+  uint32_t crc32;   // CRC32 of the payload
+};
+
+struct SectionInfo {
+  uint32_t bit;
+  const char *key; // NVS key (max 15 chars)
+  size_t offset;   // Offset in FullConfig
+  size_t size;
+  uint16_t version; // Bump when this section's layout changes
+};
+
+constexpr SectionInfo SECTIONS[] = {
+    {SECTION_DEVICE, "device", offsetof(FullConfig, device),
+     sizeof(FullConfig::device), 1},
+    {SECTION_NETWORK, "network", offsetof(FullConfig, network),
+     sizeof(FullConfig::network), 2},
+    {SECTION_ENDPOINT, "endpoint", offsetof(FullConfig, endpoint),
+     sizeof(FullConfig::endpoint), 1},
+    {SECTION_MQTT, "mqtt", offsetof(FullConfig, mqtt),
+     sizeof(FullConfig::mqtt), 1},
+    {SECTION_WEB_USER, "webuser", offsetof(FullConfig, webUser),
+     sizeof(FullConfig::webUser), 1},
+    {SECTION_FILTER, "filter", offsetof(FullConfig, filter),
+     sizeof(FullConfig::filter), 1},
+    {SECTION_DECODER, "decoder", offsetof(FullConfig, decoder),
+     sizeof(FullConfig::decoder), 1},
+    {SECTION_SERIAL2, "serial2", offsetof(FullConfig, serial2),
+     sizeof(FullConfig::serial2), 1},
+};
+constexpr size_t SECTION_COUNT = sizeof(SECTIONS) / sizeof(SECTIONS[0]);
+
+constexpr size_t maxSectionSize() {
+  size_t max = 0;
+  for (const SectionInfo &section : SECTIONS) {
+    max = section.size > max ? section.size : max;
+  }
+  return max;
+}
+
+/// Header plus the largest section, the size of a blob read or write
+constexpr size_t SECTION_BLOB_SIZE = sizeof(SectionHeader) + maxSectionSize();
+
+} // namespace
+
+static uint32_t s_loaded = 0; // Sections present in s_config
+static uint32_t s_stored = 0; // Sections whose NVS copy has s_storedCrc
+static uint32_t s_storedCrc[SECTION_COUNT] = {};
+static SemaphoreHandle_t s_mutex = nullptr;
+
+// Serialize a section as stored: device.id is generated, never persisted
+static size_t sectionBlob(size_t index, const FullConfig *config,
+                          uint8_t *blob) {
+  const SectionInfo &section = SECTIONS[index];
+  uint8_t *payload = blob + sizeof(SectionHeader);
+  memcpy(payload, (const uint8_t *)config + section.offset, section.size);
+  if (section.bit == SECTION_DEVICE) {
+    memset(payload + offsetof(FullConfig, device.id) - section.offset, 0,
+           sizeof(config->device.id));
+  }
+
+  SectionHeader header = {section.version, (uint16_t)section.size,
+                          esp_crc32_le(0, payload, section.size)};
+  memcpy(blob, &header, sizeof(header));
+  return sizeof(SectionHeader) + section.size;
+}
+
+// Read one section into s_config; defaults are kept if it is missing or bad
+static esp_err_t loadSection(nvs_handle_t handle, size_t index) {
+  const SectionInfo &section = SECTIONS[index];
+  uint8_t blob[SECTION_BLOB_SIZE];
+  size_t len = sizeof(blob);
+  esp_err_t ret = nvs_get_blob(handle, section.key, blob, &len);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  SectionHeader header;
+  memcpy(&header, blob, sizeof(header));
+  const uint8_t *payload = blob + sizeof(SectionHeader);
+  if (header.version != section.version || header.size != section.size ||
+      len != sizeof(SectionHeader) + section.size) {
+    ESP_LOGW(TAG,
+             "Config section '%s' version mismatch (Stored: %u, Current: %u). "
+             "Resetting to defaults.",
+             section.key, header.version, section.version);
+    return ESP_ERR_INVALID_VERSION;
+  }
+  if (esp_crc32_le(0, payload, section.size) != header.crc32) {
+    ESP_LOGE(TAG, "CRITICAL: Config section '%s' CRC mismatch!", section.key);
+    return ESP_ERR_INVALID_CRC;
+  }
+
+  memcpy((uint8_t *)&s_config + section.offset, payload, section.size);
+  s_storedCrc[index] = header.crc32;
+  s_stored |= section.bit;
+  return ESP_OK;
+}
+
+// Write the sections of s_config in @p sections that differ from NVS
+static esp_err_t flushSections(uint32_t sections) {
+  uint8_t blob[SECTION_BLOB_SIZE];
+  uint32_t written = 0;
+  uint32_t crcs[SECTION_COUNT];
+  nvs_handle_t handle = 0;
+  bool opened = false;
+  esp_err_t ret = ESP_OK;
+
+  for (size_t i = 0; i < SECTION_COUNT && ret == ESP_OK; i++) {
+    const SectionInfo &section = SECTIONS[i];
+    if (!(sections & section.bit)) {
+      continue;
+    }
+    size_t len = sectionBlob(i, &s_config, blob);
+    memcpy(&crcs[i], blob + offsetof(SectionHeader, crc32), sizeof(uint32_t));
+    if ((s_stored & section.bit) && crcs[i] == s_storedCrc[i]) {
+      continue; // Unchanged, spare the flash
+    }
+
+    if (!opened) {
+      ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
+        return ret;
+      }
+      opened = true;
+    }
+    ret = nvs_set_blob(handle, section.key, blob, len);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to save config section '%s': %s", section.key,
+               esp_err_to_name(ret));
+    }
+    written |= section.bit;
+  }
+
+  if (!opened) {
+    return ESP_OK; // Nothing changed
+  }
+  if (ret == ESP_OK) {
+    ret = nvs_commit(handle);
+  }
+  nvs_close(handle);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  for (size_t i = 0; i < SECTION_COUNT; i++) {
+    if (written & SECTIONS[i].bit) {
+      s_storedCrc[i] = crcs[i];
+      s_stored |= SECTIONS[i].bit;
+      ESP_LOGI(TAG, "Config section '%s' saved (CRC: 0x%08lX)",
+               SECTIONS[i].key, (unsigned long)crcs[i]);
+    }
+  }
+  return ESP_OK;
+}
+
+// Bring @p sections into s_config, creating missing ones with defaults
+static esp_err_t ensureLoaded(uint32_t sections) {
+  // Endpoint and MQTT are only validated for an ENDPOINT device
+  if (sections & (SECTION_ENDPOINT | SECTION_MQTT)) {
+    sections |= SECTION_DEVICE;
+  }
+  uint32_t missing = sections & SECTION_ALL & ~s_loaded;
+  if (!missing) {
+    return ESP_OK;
+  }
+
+  nvs_handle_t handle;
+  bool opened = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK;
+  FullConfig defaults = getDefaultConfig();
+  for (size_t i = 0; i < SECTION_COUNT; i++) {
+    const SectionInfo &section = SECTIONS[i];
+    if (!(missing & section.bit)) {
+      continue;
+    }
+    s_stored &= ~section.bit;
+    esp_err_t ret = opened ? loadSection(handle, i) : ESP_ERR_NVS_NOT_FOUND;
+    if (ret != ESP_OK) {
+      memcpy((uint8_t *)&s_config + section.offset,
+             (const uint8_t *)&defaults + section.offset, section.size);
+      ESP_LOGI(TAG, "No valid '%s' config section, using defaults",
+               section.key);
+    }
+    s_loaded |= section.bit;
+  }
+  if (opened) {
+    nvs_close(handle);
+  }
+  s_config.version = CONFIG_VERSION;
+
+  if (missing & SECTION_DEVICE) {
+    // Always generate device ID dynamically from eFuses (never stored in NVS)
+    generateDeviceId(s_config.device.id, sizeof(s_config.device.id));
+  }
+
+  // Validate and fix any invalid fields
+  if (!validateConfig(&s_config, true)) {
+    ESP_LOGW(TAG, "Configuration had invalid fields, defaults applied");
+  }
+  // Persist defaults and corrections (unchanged sections are skipped)
+  return flushSections(s_loaded);
+}
+
+// Layout of the single "fullconfig" blob written by version 3 firmware,
+// the last one before per-section storage. It must stay byte for byte as
+// it was: fields are only ever read from it, one by one.
+struct LegacyFullConfigV3 {
+  uint32_t version;
+  uint32_t crc32;
+
+  struct {
+    DeviceType type;
+    char name[32];
+    char id[16];
+  } device;
+
+  struct {
+    struct {
+      bool enabled;
+      bool useDhcp;
+      Network::IpAddress staticIp;
+      Network::IpAddress netmask;
+      Network::IpAddress gateway;
+    } lan;
+
+    struct {
+      bool enabled;
+      char ssid[33];
+      char password[65];
+      bool useDhcp;
+      Network::IpAddress staticIp;
+      Network::IpAddress netmask;
+      Network::IpAddress gateway;
+    } wlanOp;
+
+    struct {
+      char ssid[33];
+      char password[65];
+      uint8_t channel;
+      bool hidden;
+      Network::IpAddress apIp;
+    } wlanSafe;
+
+    uint16_t webServerPort;
+  } network;
+
+  struct {
+    char hostName[32];
+    DataSource source;
+    struct {
+      PhysicalInterface interface;
+      uint32_t baudRate;
+      uint8_t dataBits;
+      uart_parity_t parity;
+      uart_stop_bits_t stopBits;
+    } serial;
+  } endpoint;
+
+  struct {
+    char host[64];
+    uint16_t port;
+    uint8_t qos;
+    bool useAuth;
+    char username[32];
+    char password[64];
+    char topicPub[64];
+    char topicSub[64];
+  } mqtt;
+
+  struct {
+    char username[32];
+    char password[32];
+  } webUser;
+};
+
+static const uint32_t LEGACY_CONFIG_VERSION = 3;
+
+// Copy a string field that may be unterminated in the stored blob
+template <size_t N, size_t M>
+static void copyLegacyString(char (&dst)[N], const char (&src)[M]) {
+  size_t len = strnlen(src, M < N ? M : N - 1);
+  memcpy(dst, src, len);
+  dst[len] = '\0';
+}
+
+// Fields of a version 3 blob over the defaults (newer fields keep them)
+static void applyLegacyConfig(const LegacyFullConfigV3 &legacy,
+                              FullConfig *config) {
+  config->device.type = legacy.device.type;
+  copyLegacyString(config->device.name, legacy.device.name);
+
+  config->network.lan.enabled = legacy.network.lan.enabled;
+  config->network.lan.useDhcp = legacy.network.lan.useDhcp;
+  config->network.lan.staticIp = legacy.network.lan.staticIp;
+  config->network.lan.netmask = legacy.network.lan.netmask;
+  config->network.lan.gateway = legacy.network.lan.gateway;
+
+  config->network.wlanOp.enabled = legacy.network.wlanOp.enabled;
+  copyLegacyString(config->network.wlanOp.ssid, legacy.network.wlanOp.ssid);
+  copyLegacyString(config->network.wlanOp.password,
+                   legacy.network.wlanOp.password);
+  config->network.wlanOp.useDhcp = legacy.network.wlanOp.useDhcp;
+  config->network.wlanOp.staticIp = legacy.network.wlanOp.staticIp;
+  config->network.wlanOp.netmask = legacy.network.wlanOp.netmask;
+  config->network.wlanOp.gateway = legacy.network.wlanOp.gateway;
+
+  copyLegacyString(config->network.wlanSafe.ssid,
+                   legacy.network.wlanSafe.ssid);
+  copyLegacyString(config->network.wlanSafe.password,
+                   legacy.network.wlanSafe.password);
+  config->network.wlanSafe.channel = legacy.network.wlanSafe.channel;
+  config->network.wlanSafe.hidden = legacy.network.wlanSafe.hidden;
+  config->network.wlanSafe.apIp = legacy.network.wlanSafe.apIp;
+
+  config->network.webServerPort = legacy.network.webServerPort;
+
+  copyLegacyString(config->endpoint.hostName, legacy.endpoint.hostName);
+  config->endpoint.source = legacy.endpoint.source;
+  config->endpoint.serial.interface = legacy.endpoint.serial.interface;
+  config->endpoint.serial.baudRate = legacy.endpoint.serial.baudRate;
+  config->endpoint.serial.dataBits = legacy.endpoint.serial.dataBits;
+  config->endpoint.serial.parity = legacy.endpoint.serial.parity;
+  config->endpoint.serial.stopBits = legacy.endpoint.serial.stopBits;
+
+  copyLegacyString(config->mqtt.host, legacy.mqtt.host);
+  config->mqtt.port = legacy.mqtt.port;
+  config->mqtt.qos = legacy.mqtt.qos;
+  config->mqtt.useAuth = legacy.mqtt.useAuth;
+  copyLegacyString(config->mqtt.username, legacy.mqtt.username);
+  copyLegacyString(config->mqtt.password, legacy.mqtt.password);
+  copyLegacyString(config->mqtt.topicPub, legacy.mqtt.topicPub);
+  copyLegacyString(config->mqtt.topicSub, legacy.mqtt.topicSub);
+
+  copyLegacyString(config->webUser.username, legacy.webUser.username);
+  copyLegacyString(config->webUser.password, legacy.webUser.password);
+}
+
+// Split a pre-section "fullconfig" blob into sections, then drop it
+static void migrateLegacyConfig() {
+  nvs_handle_t handle;
+  if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+    return; // Fresh device, nothing to migrate
+  }
+
+  LegacyFullConfigV3 legacy = {};
+  size_t size = sizeof(legacy);
+  esp_err_t ret = nvs_get_blob(handle, NVS_KEY_FULLCONFIG, &legacy, &size);
+  if (ret == ESP_ERR_NVS_NOT_FOUND) {
+    nvs_close(handle);
+    return;
+  }
+
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Legacy config unreadable (%s). Resetting to defaults.",
+             esp_err_to_name(ret));
+  } else if (size != sizeof(legacy) ||
+             legacy.version != LEGACY_CONFIG_VERSION) {
+    ESP_LOGW(TAG,
+             "Legacy config version mismatch (Stored: %lu, %u bytes, "
+             "Expected: %lu). Resetting to defaults.",
+             legacy.version, (unsigned)size, LEGACY_CONFIG_VERSION);
+  } else if (legacy.crc32 != blobCrc32(&legacy)) {
+    ESP_LOGE(TAG, "CRITICAL: Legacy config CRC mismatch!");
+  } else {
+    s_config = getDefaultConfig();
+    applyLegacyConfig(legacy, &s_config);
+    s_loaded = SECTION_ALL;
+    s_stored = 0;
+    generateDeviceId(s_config.device.id, sizeof(s_config.device.id));
+    validateConfig(&s_config, true);
+    if (flushSections(SECTION_ALL) != ESP_OK) {
+      nvs_close(handle);
+      return; // Keep the legacy blob, retry on next boot
+    }
+    ESP_LOGI(TAG, "Legacy configuration migrated to per-section storage");
+  }
+
+  nvs_erase_key(handle, NVS_KEY_FULLCONFIG);
+  nvs_commit(handle);
+  nvs_close(handle);
+}
+
 // ============== NVS Operations ==============
 
 esp_err_t init() {
@@ -420,55 +1079,29 @@ esp_err_t init() {
     return ret;
   }
 
-  // Load configuration
-  ret = load(&s_config);
-  if (ret != ESP_OK) {
-    ESP_LOGI(TAG, "No valid configuration found, using defaults");
-    s_config = getDefaultConfig();
-
-    // Device ID will be generated dynamically when needed (never stored in NVS)
-    // Save defaults (device.id will be cleared before saving)
-    save(&s_config);
+  s_mutex = xSemaphoreCreateMutex();
+  if (!s_mutex) {
+    return ESP_ERR_NO_MEM;
   }
 
+  // Sections are read on first use; only an old single blob is read now
+  migrateLegacyConfig();
+
   s_initialized = true;
   ESP_LOGI(TAG, "Configuration Manager initialized");
   return ESP_OK;
 }
 
 esp_err_t load(FullConfig *config) {
-  nvs_handle_t handle;
-  esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
-  if (ret != ESP_OK) {
-    return ret;
-  }
-
-  size_t size = sizeof(FullConfig);
-  ret = nvs_get_blob(handle, NVS_KEY_FULLCONFIG, config, &size);
-  nvs_close(handle);
-
-  if (ret != ESP_OK) {
-    return ret;
-  }
-
-  // Validate version
-  if (config->version != CONFIG_VERSION) {
-    ESP_LOGW(TAG,
-             "Config version mismatch (Stored: %lu, Current: %lu). Resetting "
-             "to defaults.",
-             config->version, CONFIG_VERSION);
-    return ESP_ERR_INVALID_VERSION;
-  }
-
-  // Validate CRC
-  uint32_t calculatedCrc = calculateCrc32(config);
-  if (config->crc32 != calculatedCrc) {
-    ESP_LOGE(
-        TAG,
-        "CRITICAL: Config CRC mismatch! (stored: 0x%08lX, calculated: 0x%08lX)",
-        config->crc32, calculatedCrc);
-    return ESP_ERR_INVALID_CRC;
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
   }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  // Drop the cache so every section is read back from NVS
+  s_loaded = 0;
+  esp_err_t ret = ensureLoaded(SECTION_ALL);
+  *config = s_config;
+  xSemaphoreGive(s_mutex);
 
   // Log loaded configuration for debugging
   ESP_LOGI(TAG, "Loaded config: LAN enabled=%d, IP=%d.%d.%d.%d",
@@ -477,66 +1110,67 @@ esp_err_t load(FullConfig *config) {
            config->network.lan.staticIp.addr[1],
            config->network.lan.staticIp.addr[2],
            config->network.lan.staticIp.addr[3]);
-
-  // Always generate device ID dynamically from eFuses (never stored in NVS)
-  generateDeviceId(config->device.id, sizeof(config->device.id));
-  ESP_LOGI(TAG, "Device ID generated from eFuses: %s", config->device.id);
-
-  // Validate and fix any invalid fields
-  if (!validateConfig(config, true)) {
-    ESP_LOGW(TAG, "Configuration had invalid fields, defaults applied");
-    // Log after validation
-    ESP_LOGI(TAG, "After validation: LAN enabled=%d",
-             config->network.lan.enabled);
-    // Re-save with corrected values
-    save(config);
-  }
-
-  ESP_LOGI(TAG, "Configuration loaded successfully");
-  return ESP_OK;
+  return ret;
 }
 
-esp_err_t save(const FullConfig *config) {
-  // Create a copy to modify
-  FullConfig configCopy = *config;
-
-  // Clear device.id - it's generated dynamically from eFuses and never stored in NVS
-  configCopy.device.id[0] = '\0';
-
-  // Validate before saving
-  if (!validateConfig(&configCopy, true)) {
-    ESP_LOGW(TAG, "Configuration corrected before saving");
-  }
-
-  // Calculate and set CRC (device.id is excluded from CRC calculation)
-  configCopy.crc32 = calculateCrc32(&configCopy);
-
-  // Save to NVS
-  nvs_handle_t handle;
-  esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+static esp_err_t saveLocked(uint32_t sections, const FullConfig *config) {
+  esp_err_t ret = ensureLoaded(SECTION_ALL);
   if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
     return ret;
   }
 
-  ret =
-      nvs_set_blob(handle, NVS_KEY_FULLCONFIG, &configCopy, sizeof(FullConfig));
+  // Merge the new sections over the current ones and validate the result
+  FullConfig merged = s_config;
+  for (const SectionInfo &section : SECTIONS) {
+    if (sections & section.bit) {
+      memcpy((uint8_t *)&merged + section.offset,
+             (const uint8_t *)config + section.offset, section.size);
+    }
+  }
+  // device.id is generated from eFuses, callers cannot change it
+  memcpy(merged.device.id, s_config.device.id, sizeof(merged.device.id));
+  if (!validateConfig(&merged, true)) {
+    ESP_LOGW(TAG, "Configuration corrected before saving");
+  }
+
+  s_config = merged;
+  ret = flushSections(SECTION_ALL);
   if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to save config: %s", esp_err_to_name(ret));
-    nvs_close(handle);
+    s_loaded = 0; // Cache no longer matches NVS, read it back on next use
     return ret;
   }
+  ESP_LOGI(TAG, "Configuration saved successfully");
+  return ESP_OK;
+}
 
-  ret = nvs_commit(handle);
-  nvs_close(handle);
+esp_err_t save(const FullConfig *config) {
+  return saveSections(SECTION_ALL, config);
+}
 
-  if (ret == ESP_OK) {
-    // Update cached config
-    s_config = configCopy;
-    ESP_LOGI(TAG, "Configuration saved successfully (CRC: 0x%08lX)",
-             configCopy.crc32);
+esp_err_t getSections(uint32_t sections, FullConfig *config) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
   }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  esp_err_t ret = ensureLoaded(sections);
+  for (const SectionInfo &section : SECTIONS) {
+    if (sections & section.bit) {
+      memcpy((uint8_t *)config + section.offset,
+             (const uint8_t *)&s_config + section.offset, section.size);
+    }
+  }
+  config->version = CONFIG_VERSION;
+  xSemaphoreGive(s_mutex);
+  return ret;
+}
 
+esp_err_t saveSections(uint32_t sections, const FullConfig *config) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  esp_err_t ret = saveLocked(sections, config);
+  xSemaphoreGive(s_mutex);
   return ret;
 }
 
@@ -549,9 +1183,14 @@ esp_err_t restore() {
     ESP_LOGE(TAG, "Failed to clear safe mode flag: %s", esp_err_to_name(ret));
     return ret;
   }
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
 
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
   // 2. Get default values directly into cached config to save stack
   s_config = getDefaultConfig();
+  s_loaded = SECTION_ALL; // Nothing left to read from NVS
 
   // 3. Generate Device ID
   generateDeviceId(s_config.device.id, sizeof(s_config.device.id));
@@ -564,8 +1203,9 @@ esp_err_t restore() {
            s_config.network.lan.staticIp.addr[2],
            s_config.network.lan.staticIp.addr[3]);
 
-  // 5. Save to NVS (save() will create its own copy for validation)
-  ret = save(&s_config);
+  // 5. Write the sections that differ from the defaults
+  ret = flushSections(SECTION_ALL);
+  xSemaphoreGive(s_mutex);
   if (ret == ESP_OK) {
     ESP_LOGI(TAG, "Factory defaults restored successfully");
   } else {
@@ -610,29 +1250,30 @@ void generateDeviceId(char *idOut, size_t maxLen) {
 // ============== Legacy API (Aliases) ==============
 
 esp_err_t getConfig(FullConfig *config) {
-  if (!s_initialized) {
-    return ESP_ERR_INVALID_STATE;
-  }
-  *config = s_config;
-  // Always generate device ID dynamically from eFuses (never stored in NVS)
-  generateDeviceId(config->device.id, sizeof(config->device.id));
-  return ESP_OK;
+  return getSections(SECTION_ALL, config);
 }
 
 esp_err_t saveConfig(const FullConfig *config) { return save(config); }
 
 esp_err_t getNetworkConfig(NetworkConfig *config) {
-  if (!s_initialized) {
-    return ESP_ERR_INVALID_STATE;
+  FullConfig full;
+  esp_err_t ret = getSections(SECTION_NETWORK, &full);
+  if (ret != ESP_OK) {
+    return ret;
   }
   config->type = Network::Type::ETHERNET; // Legacy
-  config->webServerPort = s_config.network.webServerPort;
+  config->webServerPort = full.network.webServerPort;
   return ESP_OK;
 }
 
 esp_err_t saveNetworkConfig(const NetworkConfig *config) {
-  s_config.network.webServerPort = config->webServerPort;
-  return save(&s_config);
+  FullConfig full;
+  esp_err_t ret = getSections(SECTION_NETWORK, &full);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  full.network.webServerPort = config->webServerPort;
+  return saveSections(SECTION_NETWORK, &full);
 }
 
 // ============== Safe Mode Management ==============
@@ -5,11 +5,17 @@
 #include <cstddef>
 #include <cstdint>
 
+class JsonWriter;
+
 /**
  * @brief Unified Configuration Manager
  *
  * Single source of truth for all system configuration.
  * Manages NVS persistence, validation, defaults, and JSON import/export.
+ *
+ * Each top-level section of FullConfig is its own NVS blob with its own
+ * version and CRC: a save only rewrites the sections that changed, and a
+ * section is only read from NVS the first time it is asked for.
  */
 
 namespace ConfigManager {
@@ -23,10 +29,16 @@ enum class DataSource : uint8_t { DESHABILITADO = 0, SERIE = 1, PARALELO = 2 };
 /// Physical interface for serial communication
 enum class PhysicalInterface : uint8_t { RS232 = 0, RS485 = 1 };
 
+/// WiFi station tuning (see WifiInterface::Profile)
+enum class WifiProfile : uint8_t { ESTANDAR = 0, AHORRO = 1, RENDIMIENTO = 2 };
+
+/// Protocol decoder of the captured stream
+enum class DecoderType : uint8_t { NINGUNO = 0, MODBUS_RTU = 1, ESC_POS = 2 };
+
 /// Complete unified configuration structure
 struct FullConfig {
   uint32_t version = 2; // Configuration version for migration
-  uint32_t crc32 = 0;   // CRC32 for integrity verification
+  uint32_t crc32 = 0;   // Legacy single-blob CRC (sections carry their own)
 
   // Device Configuration
   struct {
@@ -55,6 +67,8 @@ struct FullConfig {
       Network::IpAddress staticIp = {192, 168, 1, 50};
       Network::IpAddress netmask = {255, 255, 255, 0};
       Network::IpAddress gateway = {192, 168, 1, 1};
+      WifiProfile profile = WifiProfile::ESTANDAR;
+      uint8_t fixedChannel = 0; // AP channel hint, 0 = scan all channels
     } wlanOp;
 
     // WLAN-SAFE (Access Point Mode - Always Active)
@@ -67,6 +81,8 @@ struct FullConfig {
     } wlanSafe;
 
     uint16_t webServerPort = 80;
+    uint16_t tapPort = 0; // Live capture TCP tap (0 = disabled)
+    uint16_t livePushMs = 1000; // Dashboard WebSocket push period (0 = disabled)
   } network;
 
   // Endpoint Configuration (only if device.type == ENDPOINT)
@@ -92,8 +108,33 @@ struct FullConfig {
     char password[64] = "";                     // REQUIRED if useAuth
     char topicPub[64] = "datalogger/telemetry"; // REQUIRED if ENDPOINT
     char topicSub[64] = "datalogger/commands";  // REQUIRED if ENDPOINT
+    bool dataEnabled = false;                   // Forward captured data
+    char topicData[64] = "datalogger/data";     // REQUIRED if dataEnabled
+    uint16_t dataBatchSize = 4096;              // Bytes per data message
+    bool dataCompress = false;                  // LZ4-compress data messages
   } mqtt;
 
+  // Capture filters, applied before data is stored (DataPipeline stages)
+  struct {
+    char stripBytes[17] = ""; // Hex bytes removed everywhere, e.g. "0011"
+    uint16_t dropRunMin = 0;  // Drop runs of one byte this long (0 = off)
+    uint16_t dedupeMax = 0;   // Drop repeated bursts up to this size (0 = off)
+  } filter;
+
+  // Protocol decoding of the capture (FrameDecoders)
+  struct {
+    DecoderType type = DecoderType::NINGUNO;
+    char topic[64] = "datalogger/decoded"; // REQUIRED if type != NINGUNO
+  } decoder;
+
+  // Second UART merged into the serial capture (DataPipeline::addSource),
+  // same framing as endpoint.serial
+  struct {
+    bool enabled = false;
+    uint32_t baudRate = 115200; // REQUIRED if enabled
+    int8_t rxPin = 4;           // UART1 RX GPIO, REQUIRED if enabled
+  } serial2;
+
   // Web User Credentials
   struct {
     char username[32] = "admin"; // REQUIRED
@@ -101,9 +142,23 @@ struct FullConfig {
   } webUser;
 };
 
+/// Top-level FullConfig sections, each persisted under its own NVS key
+enum Section : uint32_t {
+  SECTION_DEVICE = 1 << 0,
+  SECTION_NETWORK = 1 << 1,
+  SECTION_ENDPOINT = 1 << 2,
+  SECTION_MQTT = 1 << 3,
+  SECTION_WEB_USER = 1 << 4,
+  SECTION_FILTER = 1 << 5,
+  SECTION_DECODER = 1 << 6,
+  SECTION_SERIAL2 = 1 << 7,
+  SECTION_ALL = 0xFF
+};
+
 /**
  * @brief Initialize configuration manager
- * Loads configuration from NVS or creates default if not found
+ * Opens NVS and migrates a legacy single-blob configuration; sections are
+ * loaded (or created with defaults) on first access
  * @return ESP_OK on success
  */
 esp_err_t init();
@@ -123,6 +178,28 @@ esp_err_t load(FullConfig *config);
  */
 esp_err_t save(const FullConfig *config);
 
+/**
+ * @brief Get some sections of the configuration
+ * Only the requested sections of @p config are written, and only those
+ * (plus device, which endpoint and MQTT validation depend on) are read
+ * from NVS if not cached yet
+ * @param sections Mask of Section values
+ * @param config Output structure, other sections are left untouched
+ * @return ESP_OK on success
+ */
+esp_err_t getSections(uint32_t sections, FullConfig *config);
+
+/**
+ * @brief Save some sections of the configuration
+ * The other sections keep their current values. The result is validated
+ * as a whole and only sections whose content changed are written to NVS,
+ * so a struct filled by getSections() can be saved with the same mask
+ * @param sections Mask of Section values to take from @p config
+ * @param config Configuration holding the new section values
+ * @return ESP_OK on success
+ */
+esp_err_t saveSections(uint32_t sections, const FullConfig *config);
+
 /**
  * @brief Restore configuration to factory defaults
  * @return ESP_OK on success
@@ -200,11 +277,16 @@ void generateDeviceId(char *idOut, size_t maxLen);
 uint32_t calculateCrc32(const FullConfig *config);
 
 /**
- * @brief Export configuration to JSON string
+ * @brief Export configuration as a JSON object
+ *
+ * Writes the object the web UI loads from /api/config; the caller owns
+ * the writer and calls finish(), so the output can go to a buffer or be
+ * streamed straight to an HTTP response.
  * @param config Configuration to export
- * @return Allocated JSON string (caller must free)
+ * @param json Writer to append the object to
+ * @return ESP_OK, or the writer's error (see JsonWriter::finish())
  */
-char *toJson(const FullConfig *config);
+esp_err_t toJson(const FullConfig *config, JsonWriter *json);
 
 /**
  * @brief Import configuration from JSON string
@@ -238,7 +320,7 @@ struct EthernetConfig {
   int csPin = 21;
   int resetPin = 22;
   int interruptPin = 25;
-  int clockSpeedHz = 20 * 1000 * 1000;
+  int clockSpeedHz = 33 * 1000 * 1000;
   Network::IpMode ipMode = Network::IpMode::DHCP;
   Network::IpAddress staticIp = {192, 168, 1, 100};
   Network::IpAddress staticNetmask = {255, 255, 255, 0};
@@ -8,11 +8,17 @@
  * - Core 0: Transport capture task (UART/PP)
  * - Core 1: Flash writer task
  * - Ring buffer in RAM bridges the two
+ *
+ * Staged boot: capture starts first from the device/endpoint sections of the
+ * configuration and buffers in RAM; flash then comes up on the main task
+ * while Ethernet, WiFi and then web/MQTT initialize in their own tasks.
  */
 
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include <cstdint>
 #include <stdio.h>
@@ -24,260 +30,621 @@
 #include "config/ConfigManager.h"
 #include "esp_event.h"
 #include "network/INetworkInterface.h"
+#include "network/NetworkManager.h"
+#include "network/TcpTap.h"
 #include "network/ethernet/EthernetW5500.h"
 #include "network/wifi/WifiInterface.h"
 #include "pipeline/DataPipeline.h"
+#include "pipeline/PipelineStages.h"
+#include "protocol/EscPosDecoder.h"
+#include "protocol/FrameDecoders.h"
+#include "protocol/ModbusRtuDecoder.h"
 #include "storage/FlashRing.h"
+#include "storage/RecordStore.h"
+#include "storage/SdCardBackend.h"
+#include "storage/StorageTier.h"
 #include "transport/IDataSource.h"
-#include "transport/parallel/ParallelPortCapture.h"
+#include "transport/parallel/ParallelPortDmaCapture.h"
 #include "transport/uart/UartCapture.h"
 #include "webserver/WebServer.h"
 
 #include "utils/ButtonMonitor.h"
 #include "utils/CommandSystem.h"
+#include "utils/DeferredLog.h"
+#include "utils/Housekeeping.h"
+#include "utils/JsonWriter.h"
 #include "utils/LedManager.h"
+#include "utils/MemoryPlan.h"
+#include "utils/OtaUpdate.h"
+#include "utils/TaskProfiler.h"
+#include "mqtt/MqttForwarder.h"
 #include "mqtt/MqttManager.h"
 #include "utils/MqttCommandHandler.h"
 
 static const char *TAG = "DataLogger";
 
+// LZ4 payload compression on the capture pipeline (its buffers are
+// reserved at boot only when enabled)
+static const bool CAPTURE_COMPRESS = false;
+
+// SD card bulk tier. Off by default: on the ESP32 its D0 line is GPIO2, the
+// onboard LED, which is then left dark (pin notes in SdCardBackend.h)
+static const bool SD_CARD_TIER = false;
+
 // Global instances
 static IDataSource *g_dataSource = nullptr;
-static INetworkInterface *g_networkInterface = nullptr;
 static MqttManager g_mqttManager;  // Global to avoid stack overflow
+static ConfigManager::FullConfig g_appConfig; // Shared by the boot tasks
+static UartCapture g_uart;
+static UartCapture g_uart2; // Second line merged into the serial capture
+static ParallelPortDmaCapture g_parallel;
+static EthernetW5500 g_ethernet;
+static SdCardBackend g_sdCard; // Bulk tier, if a card is fitted
+static StripStage g_stripStage;  // Capture filters (ConfigManager filter)
+static RunDropStage g_runDropStage;
+static DedupeStage g_dedupeStage;
+static ModbusRtuDecoder g_modbusDecoder; // Protocol decoders (ConfigManager decoder)
+static EscPosDecoder g_escPosDecoder;
+static WifiInterface g_wifi;
+static bool g_safeMode = false;
+
+// Staged boot
+static SemaphoreHandle_t g_netDone = nullptr;      // Given by each link task
+static SemaphoreHandle_t g_servicesDone = nullptr; // Web/MQTT ready
+static volatile bool g_ethernetUp = false;
+static volatile bool g_wifiUp = false;
+static int64_t g_captureReadyUs = 0;
+static int64_t g_storageReadyUs = 0;
+static int64_t g_networkReadyUs = 0;
+
+// ============== Boot Stage 1: Capture ==============
+
+// Filtros de captura: relleno, rachas y tramas repetidas no llegan a flash
+static void addCaptureFilters(const ConfigManager::FullConfig &cfg) {
+  uint8_t strip[sizeof(cfg.filter.stripBytes) / 2];
+  size_t stripCount = 0;
+  for (const char *p = cfg.filter.stripBytes; p[0] && p[1]; p += 2) {
+    char hex[3] = {p[0], p[1], '\0'};
+    strip[stripCount++] = (uint8_t)strtoul(hex, nullptr, 16);
+  }
+
+  if (stripCount > 0 && g_stripStage.init(strip, stripCount) == ESP_OK)
+    DataPipeline::addStage(&g_stripStage);
+  if (cfg.filter.dropRunMin > 0 &&
+      g_runDropStage.init(cfg.filter.dropRunMin) == ESP_OK)
+    DataPipeline::addStage(&g_runDropStage);
+  if (cfg.filter.dedupeMax > 0 &&
+      g_dedupeStage.init(cfg.filter.dedupeMax) == ESP_OK)
+    DataPipeline::addStage(&g_dedupeStage);
+}
+
+// Decodificador de protocolo: tramas estructuradas además de la captura cruda
+static void startDecoder(const ConfigManager::FullConfig &cfg) {
+  if (cfg.decoder.type == ConfigManager::DecoderType::NINGUNO)
+    return;
+  if (cfg.endpoint.source != ConfigManager::DataSource::SERIE) {
+    ESP_LOGW(TAG, "Decodificador solo disponible con captura serie");
+    return;
+  }
+
+  FrameDecoder *decoder = &g_escPosDecoder;
+  if (cfg.decoder.type == ConfigManager::DecoderType::MODBUS_RTU) {
+    // Start + data + parity + stop bits
+    const auto &serial = cfg.endpoint.serial;
+    uint8_t bits = 1 + serial.dataBits +
+                   (serial.parity != UART_PARITY_DISABLE ? 1 : 0) +
+                   (serial.stopBits == UART_STOP_BITS_2 ? 2 : 1);
+    if (g_modbusDecoder.init(serial.baudRate, bits) != ESP_OK) {
+      ESP_LOGW(TAG, "Decodificador Modbus: baudrate invalido");
+      return;
+    }
+    decoder = &g_modbusDecoder;
+  }
+  if (FrameDecoders::init() == ESP_OK)
+    FrameDecoders::setDecoder(0, decoder);
+}
+
+// Segunda UART: el pipeline intercala ambas líneas por tiempo de captura
+static void startSecondUart(const ConfigManager::FullConfig &cfg) {
+  if (!cfg.serial2.enabled ||
+      cfg.endpoint.source != ConfigManager::DataSource::SERIE)
+    return;
+
+  // Same framing as the first line; UART1 RX only (its default pins are
+  // the flash, so TX stays unrouted). Its buffers come from the heap, the
+  // planned capture regions belong to the first line, so they are smaller.
+  UartCapture::Config uartCfg;
+  uartCfg.uartPort = UART_NUM_1;
+  uartCfg.rxPin = cfg.serial2.rxPin;
+  uartCfg.txPin = UART_PIN_NO_CHANGE;
+  uartCfg.rxBufSize = 8 * 1024;
+  uartCfg.ringBufSize = 16 * 1024;
+  uartCfg.baudRate = cfg.serial2.baudRate;
+  uartCfg.dataBits =
+      (uart_word_length_t)(cfg.endpoint.serial.dataBits - 5); // 5-8 bits
+  uartCfg.parity = cfg.endpoint.serial.parity;
+  uartCfg.stopBits = cfg.endpoint.serial.stopBits;
+  if (g_uart2.init(&uartCfg) != ESP_OK) {
+    ESP_LOGE(TAG, "ERROR al iniciar la segunda UART");
+    return;
+  }
+  uint8_t channel = 0;
+  if (DataPipeline::addSource(&g_uart2, &channel) != ESP_OK) {
+    ESP_LOGE(TAG, "ERROR al unir la segunda UART a la captura");
+    g_uart2.deinit();
+    return;
+  }
+  ESP_LOGI(TAG, "Segunda UART: %lu bps en GPIO %d (canal %u)",
+           uartCfg.baudRate, uartCfg.rxPin, channel);
+}
+
+// Transport from the endpoint configuration; nullptr if nothing to capture
+static IDataSource *startTransport(const ConfigManager::FullConfig &cfg) {
+  if (cfg.device.type != ConfigManager::DeviceType::ENDPOINT) {
+    ESP_LOGI(TAG, "Coordinador: sin captura local");
+    return nullptr;
+  }
 
-// Burst callback - called when a data burst ends
-static void onBurstEnd(bool ended, size_t bytes) {
-  if (ended)
-    DataPipeline::flush();
+  switch (cfg.endpoint.source) {
+  case ConfigManager::DataSource::SERIE: {
+    UartCapture::Config uartCfg;
+    uartCfg.baudRate = cfg.endpoint.serial.baudRate;
+    uartCfg.dataBits =
+        (uart_word_length_t)(cfg.endpoint.serial.dataBits - 5); // 5-8 bits
+    uartCfg.parity = cfg.endpoint.serial.parity;
+    uartCfg.stopBits = cfg.endpoint.serial.stopBits;
+    if (g_uart.init(&uartCfg) != ESP_OK) {
+      ESP_LOGE(TAG, "ERROR al iniciar captura serie");
+      return nullptr;
+    }
+    ESP_LOGI(TAG, "Captura serie: %lu bps", uartCfg.baudRate);
+    return &g_uart;
+  }
+  case ConfigManager::DataSource::PARALELO: {
+    // Clear of the W5500 bus (18/19/21/22/23/25) and the SD slot; 34-39
+    // are input-only. The strobe takes the UART RX pin, unused here.
+    ParallelPortDmaCapture::Config ppCfg;
+    const int dataPins[8] = {32, 33, 34, 35, 36, 39, 26, 27};
+    memcpy(ppCfg.dataPins, dataPins, sizeof(dataPins));
+    ppCfg.strobePin = 16;
+    if (g_parallel.init(&ppCfg) != ESP_OK) {
+      ESP_LOGE(TAG, "ERROR al iniciar captura paralela");
+      return nullptr;
+    }
+    ESP_LOGI(TAG, "Captura paralela (DMA): D0-D7 32,33,34,35,36,39,26,27, "
+                  "strobe 16");
+    return &g_parallel;
+  }
+  default:
+    ESP_LOGI(TAG, "Captura deshabilitada");
+    return nullptr;
+  }
+}
+
+// ============== Boot Stage 2: Network and Services ==============
+
+static void ethernetBootTask(void *arg) {
+  (void)arg;
+  EthernetW5500::Config ethCfg; // USE CORRECT CLASS CONFIG
+  ethCfg.ipMode = g_appConfig.network.lan.useDhcp ? Network::IpMode::DHCP
+                                                  : Network::IpMode::STATIC;
+  ethCfg.staticIp = g_appConfig.network.lan.staticIp;
+  ethCfg.staticNetmask = g_appConfig.network.lan.netmask;
+  ethCfg.staticGateway = g_appConfig.network.lan.gateway;
+
+  // Use default pins defined in EthernetW5500.h or customize here if needed
+  // CS=21, RST=22, INT=25, SCLK=18, MISO=19, MOSI=23
+
+  ESP_LOGI(TAG, "Iniciando LAN W5500 (%d.%d.%d.%d)...",
+           ethCfg.staticIp.addr[0], ethCfg.staticIp.addr[1],
+           ethCfg.staticIp.addr[2], ethCfg.staticIp.addr[3]);
+
+  if (g_ethernet.init(&ethCfg) == ESP_OK && g_ethernet.start() == ESP_OK) {
+    g_ethernetUp = true;
+    ESP_LOGI(TAG, "LAN lista.");
+  } else {
+    ESP_LOGE(TAG, "ERROR al iniciar LAN (Hardware W5500 no responde?)");
+  }
+
+  xSemaphoreGive(g_netDone);
+  vTaskDelete(nullptr);
+}
+
+static void wifiBootTask(void *arg) {
+  (void)arg;
+  WifiInterface::Config wifiCfg;
+
+  // SOLO inicia AP si el Safe Mode está activo.
+  if (g_safeMode) {
+    // Initialize WLAN-SAFE (AP Mode)
+    wifiCfg.enabled = true;
+    wifiCfg.apMode = true;
+    strncpy(wifiCfg.apSsid, g_appConfig.network.wlanSafe.ssid,
+            sizeof(wifiCfg.apSsid) - 1);
+    strncpy(wifiCfg.apPassword, g_appConfig.network.wlanSafe.password,
+            sizeof(wifiCfg.apPassword) - 1);
+    wifiCfg.apChannel = g_appConfig.network.wlanSafe.channel;
+    wifiCfg.staticIp = g_appConfig.network.wlanSafe.apIp;
+
+    ESP_LOGW(TAG, "Iniciando WiFi AP (%s) como MODO SEGURO", wifiCfg.apSsid);
+  } else {
+    // Initialize WLAN-OP (STA Mode)
+    wifiCfg.enabled = true;
+    wifiCfg.apMode = false;
+    strncpy(wifiCfg.ssid, g_appConfig.network.wlanOp.ssid,
+            sizeof(wifiCfg.ssid) - 1);
+    strncpy(wifiCfg.password, g_appConfig.network.wlanOp.password,
+            sizeof(wifiCfg.password) - 1);
+    wifiCfg.ipMode = g_appConfig.network.wlanOp.useDhcp
+                         ? Network::IpMode::DHCP
+                         : Network::IpMode::STATIC;
+    wifiCfg.staticIp = g_appConfig.network.wlanOp.staticIp;
+    wifiCfg.staticNetmask = g_appConfig.network.wlanOp.netmask;
+    wifiCfg.staticGateway = g_appConfig.network.wlanOp.gateway;
+    wifiCfg.profile =
+        (WifiInterface::Profile)g_appConfig.network.wlanOp.profile;
+    wifiCfg.fixedChannel = g_appConfig.network.wlanOp.fixedChannel;
+
+    ESP_LOGI(TAG, "Iniciando WiFi STA (%s)...", wifiCfg.ssid);
+  }
+
+  if (g_wifi.init(&wifiCfg) == ESP_OK && g_wifi.start() == ESP_OK) {
+    g_wifiUp = true;
+    ESP_LOGI(TAG, "WiFi interface initialized (%s)",
+             wifiCfg.apMode ? "AP" : "STA");
+  } else {
+    ESP_LOGE(TAG, "Failed to initialize WiFi");
+  }
+
+  xSemaphoreGive(g_netDone);
+  vTaskDelete(nullptr);
+}
+
+static void initWebServer() {
+  if (WebServer::init(&g_ethernet, &g_wifi, g_appConfig.network.webServerPort,
+                      g_appConfig.network.livePushMs) == ESP_OK) {
+    WebServer::DataLoggerCallbacks callbacks = {
+        .getFlashStats =
+            [](void *s) {
+              return FlashRing::getStats((FlashRing::Stats *)s);
+            },
+        .getTransportStats =
+            [](void *s) {
+              return g_dataSource
+                         ? g_dataSource->getStats((Transport::Stats *)s)
+                         : ESP_FAIL;
+            },
+        .getPipelineStats =
+            [](void *s) {
+              return DataPipeline::getStats((DataPipeline::Stats *)s);
+            },
+        .getTransportTypeName =
+            []() {
+              return g_dataSource
+                         ? (g_dataSource->getType() == Transport::Type::UART
+                                ? "uart"
+                                : "parallel_port")
+                         : "none";
+            },
+        .formatFlash =
+            []() {
+              esp_err_t r = FlashRing::erase();
+              if (r == ESP_OK) {
+                RecordStore::reset();
+                if (g_dataSource)
+                  g_dataSource->resetStats();
+                DataPipeline::resetStats();
+              }
+              return r;
+            },
+        .readFlash = [](uint32_t o, uint32_t l, uint8_t *b,
+                        size_t *r) { return FlashRing::readAt(o, b, l, r); }};
+    WebServer::setDataLoggerCallbacks(&callbacks);
+    ESP_LOGI(TAG, "Web Server ready");
+  }
+
+  // Live capture tap on the same interfaces (optional)
+  if (g_appConfig.network.tapPort != 0 &&
+      TcpTap::init(&g_ethernet, &g_wifi, g_appConfig.network.tapPort) ==
+          ESP_OK) {
+    DataPipeline::setTapCallback(TcpTap::feed);
+  }
+}
+
+// Deferred log warnings and errors, on <topicPub>/log
+static char g_logTopic[80];
+
+static void forwardLog(const DeferredLog::Line &line) {
+  if (!g_mqttManager.isConnected()) {
+    return;
+  }
+  char payload[DeferredLog::LINE_SIZE + 96];
+  JsonWriter json(payload, sizeof(payload));
+  json.beginObject();
+  json.field("t", line.timeMs);
+  json.field("level", line.level == ESP_LOG_ERROR ? "E" : "W");
+  json.field("tag", line.tag);
+  json.field("msg", line.text);
+  if (line.suppressed > 0) {
+    json.field("suppressed", line.suppressed);
+  }
+  json.endObject();
+  if (json.finish() == ESP_OK) {
+    g_mqttManager.sendBinary(g_logTopic, (const uint8_t *)payload,
+                             json.length(), 0, nullptr);
+  }
+}
+
+// CPU profile on <topicPub>/profile, busiest tasks only
+static const uint32_t PROFILE_PUBLISH_MS = 60000;
+static const size_t PROFILE_PUBLISH_TASKS = 12;
+static char g_profileTopic[80];
+
+static void publishProfile(const TaskProfiler::Snapshot &snap) {
+  if (!g_mqttManager.isConnected()) {
+    return;
+  }
+  static char payload[1536];
+  JsonWriter json(payload, sizeof(payload));
+  TaskProfiler::toJson(snap, &json, PROFILE_PUBLISH_TASKS);
+  if (json.finish() == ESP_OK) {
+    g_mqttManager.sendBinary(g_profileTopic, (const uint8_t *)payload,
+                             json.length(), 0, nullptr);
+  }
+}
+
+// Finished firmware updates on <topicPub>/ota
+static char g_otaTopic[80];
+
+static void publishOta(const OtaUpdate::Status &status) {
+  char payload[512];
+  JsonWriter json(payload, sizeof(payload));
+  OtaUpdate::toJson(status, &json);
+  if (json.finish() == ESP_OK) {
+    g_mqttManager.sendBinary(g_otaTopic, (const uint8_t *)payload,
+                             json.length(), 1, nullptr);
+  }
+}
+
+// MQTT can work for both COORDINADOR and ENDPOINT
+static void initMqtt() {
+  if (g_mqttManager.init() != ESP_OK) {
+    ESP_LOGW(TAG, "MQTT Manager initialization failed");
+    return;
+  }
+  ESP_LOGI(TAG, "MQTT Manager initialized");
+
+  // Telemetry and responses survive broker outages in their own partition
+  if (g_mqttManager.enableOfflineQueue("mqttq") != ESP_OK) {
+    ESP_LOGW(TAG, "MQTT offline queue not available");
+  }
+
+  // Initialize MQTT command handler (pass MqttManager, not MqttClient)
+  if (MqttCommandHandler::init(&g_mqttManager) == ESP_OK) {
+    ESP_LOGI(TAG, "MQTT Command Handler initialized");
+  } else {
+    ESP_LOGW(TAG, "MQTT Command Handler initialization failed");
+  }
+
+  // Try to connect MQTT
+  if (g_mqttManager.connect() == ESP_OK) {
+    ESP_LOGI(TAG, "MQTT connecting...");
+  } else {
+    ESP_LOGW(TAG, "MQTT connection failed");
+  }
+
+  // Forward captured data over MQTT (if enabled)
+  if (g_appConfig.mqtt.dataEnabled) {
+    MqttForwarder::Config fwdConfig = {};
+    fwdConfig.topic = g_appConfig.mqtt.topicData;
+    fwdConfig.batchSize = g_appConfig.mqtt.dataBatchSize;
+    fwdConfig.compress = g_appConfig.mqtt.dataCompress;
+    if (MqttForwarder::init(&g_mqttManager, fwdConfig) != ESP_OK) {
+      ESP_LOGW(TAG, "MQTT data forwarding initialization failed");
+    }
+  }
+
+  // Decoded frames on their own topic (if a decoder is configured)
+  if (g_appConfig.decoder.type != ConfigManager::DecoderType::NINGUNO)
+    FrameDecoders::setPublisher(&g_mqttManager, g_appConfig.decoder.topic);
+
+  snprintf(g_logTopic, sizeof(g_logTopic), "%s/log", g_appConfig.mqtt.topicPub);
+  DeferredLog::setSink(forwardLog, ESP_LOG_WARN);
+
+  snprintf(g_profileTopic, sizeof(g_profileTopic), "%s/profile",
+           g_appConfig.mqtt.topicPub);
+  TaskProfiler::setSink(publishProfile, PROFILE_PUBLISH_MS);
+
+  snprintf(g_otaTopic, sizeof(g_otaTopic), "%s/ota", g_appConfig.mqtt.topicPub);
+  OtaUpdate::setDoneCallback(publishOta);
+}
+
+// Uplink moved to another link: MQTT follows it with the same session
+static void onRouteChange(INetworkInterface *from, INetworkInterface *to) {
+  if (from && to && g_mqttManager.isConnected()) {
+    g_mqttManager.reconnect();
+  }
+}
+
+// Waits for the link tasks, then brings up what needs an interface
+static void servicesBootTask(void *arg) {
+  int links = (int)(intptr_t)arg;
+  for (int i = 0; i < links; i++) {
+    xSemaphoreTake(g_netDone, portMAX_DELAY);
+  }
+  g_networkReadyUs = esp_timer_get_time();
+
+  // Both links stay up; uplinks go over the better one (the safe mode AP
+  // is not an uplink)
+  NetworkManager::Config netConfig;
+  netConfig.probeHost = g_appConfig.mqtt.host;
+  netConfig.probePort = g_appConfig.mqtt.port;
+  NetworkManager::setRouteCallback(onRouteChange);
+  NetworkManager::init(g_ethernetUp ? &g_ethernet : nullptr,
+                       g_wifiUp && !g_safeMode ? &g_wifi : nullptr,
+                       netConfig);
+
+  if (g_ethernetUp || g_wifiUp) {
+    initWebServer();
+    initMqtt();
+  }
+
+  xSemaphoreGive(g_servicesDone);
+  vTaskDelete(nullptr);
 }
 
 extern "C" void app_main(void) {
   // 0. Initialize LED Manager early (Startup State)
-  LedManager::init();
+  LedManager::init(SD_CARD_TIER ? LedManager::NO_GPIO
+                                : LedManager::DEFAULT_GPIO);
   LedManager::setState(LedManager::State::STARTUP);
 
   ESP_LOGI(TAG, "======================================");
   ESP_LOGI(TAG, "  ESP32 DataLogger - Startup");
   ESP_LOGI(TAG, "======================================");
 
-  // 1. Core System Components
-  ESP_ERROR_CHECK(esp_netif_init());
-  ESP_ERROR_CHECK(esp_event_loop_create_default());
+  // 1. Minimal configuration: only what capture needs
   ESP_ERROR_CHECK(ConfigManager::init());
-  ESP_ERROR_CHECK(FlashRing::init("datalog"));
-
-  // 2. Load Configuration
-  ConfigManager::FullConfig appConfig;
-  if (ConfigManager::getConfig(&appConfig) != ESP_OK) {
+  if (ConfigManager::getSections(ConfigManager::SECTION_DEVICE |
+                                     ConfigManager::SECTION_ENDPOINT |
+                                     ConfigManager::SECTION_FILTER |
+                                     ConfigManager::SECTION_DECODER |
+                                     ConfigManager::SECTION_SERIAL2,
+                                 &g_appConfig) != ESP_OK) {
     ESP_LOGE(TAG, "FALLO CRÍTICO: No se pudo cargar la configuración.");
   }
 
-  // 2.1 Check for SAFE MODE
-  bool safeModeActive = ConfigManager::getSafeMode();
-  if (safeModeActive) {
+  // 1.1 Check for SAFE MODE
+  g_safeMode = ConfigManager::getSafeMode();
+  if (g_safeMode) {
     ESP_LOGW(TAG, "========================================");
     ESP_LOGW(TAG, "  !!! SAFE MODE DETECTED !!!");
     ESP_LOGW(TAG, "========================================");
 
     // Clear safe mode flag immediately to prevent loop
     ConfigManager::setSafeMode(false);
+  }
 
-    // Disable LAN and WLAN-OP in RAM for this session
-    appConfig.network.lan.enabled = false;
-    appConfig.network.wlanOp.enabled = false;
+  // 1.2 Reserve long-lived buffers and task stacks before anything else
+  // allocates (capture regions only on a capturing endpoint)
+  MemoryPlan::init(!g_safeMode && g_appConfig.device.type ==
+                                      ConfigManager::DeviceType::ENDPOINT,
+                   CAPTURE_COMPRESS);
 
-    ESP_LOGW(TAG, "Safe Mode: LAN/WLAN-OP deshabilitados temporalmente.");
-  } else {
-    ESP_LOGI(TAG, "Arranque Normal. Configuración actual:");
-    ESP_LOGI(TAG, "  - LAN: %s (IP: %d.%d.%d.%d)",
-             appConfig.network.lan.enabled ? "SI" : "NO",
-             appConfig.network.lan.staticIp.addr[0],
-             appConfig.network.lan.staticIp.addr[1],
-             appConfig.network.lan.staticIp.addr[2],
-             appConfig.network.lan.staticIp.addr[3]);
-    ESP_LOGI(TAG, "  - WiFi OP: %s (SSID: %s)",
-             appConfig.network.wlanOp.enabled ? "SI" : "NO",
-             appConfig.network.wlanOp.ssid);
-  }
+  // Shared task for background jobs (flash pre-erase, button, CLI input)
+  ESP_ERROR_CHECK(Housekeeping::init());
+
+  // Hot-path warnings (capture overflow) are rendered by a housekeeping job
+  DeferredLog::init();
 
-  // 3. Initialize Transport
-  // Skip transport initialization in safe mode
-  if (!safeModeActive) {
-    // TODO: Transport needs refactoring to work with new config structure
-    // For now, transport is disabled until proper integration
-    ESP_LOGW(TAG, "Transport initialization temporarily disabled");
+  // CPU use per core and task from boot on (profile command, metrics, MQTT)
+  TaskProfiler::init();
+
+  // 2. Capture first: the transport and pipeline buffer in RAM until flash
+  // is ready, so traffic on the line is not lost during the rest of boot
+  if (!g_safeMode) {
+    g_dataSource = startTransport(g_appConfig);
   } else {
     ESP_LOGW(TAG, "Transport/DataPipeline disabled in SAFE MODE");
   }
 
-  // 4. Initialize Data Pipeline
-  // Only initialize if transport is available and NOT in safe mode
-  if (g_dataSource && !safeModeActive) {
+  if (g_dataSource) {
     DataPipeline::Config pipeConfig = {
-        .writeChunkSize = 12288, .flushTimeoutMs = 500, .autoStart = true};
+        .writeChunkSize = 12288,
+        .flushTimeoutMs = 500,
+        .autoStart = true,
+        .compress = CAPTURE_COMPRESS,
+        .adaptiveFlush = true,
+        .waitForStorage = true};
     ESP_ERROR_CHECK(DataPipeline::init(pipeConfig, g_dataSource));
-  } else {
-    if (safeModeActive) {
-      ESP_LOGW(TAG, "DataPipeline disabled in SAFE MODE");
-    } else {
-      ESP_LOGW(TAG,
-               "DataPipeline initialization skipped - no transport available");
-    }
+    addCaptureFilters(g_appConfig);
+    startSecondUart(g_appConfig);
+    startDecoder(g_appConfig);
+  } else if (!g_safeMode) {
+    ESP_LOGW(TAG,
+             "DataPipeline initialization skipped - no transport available");
   }
+  g_captureReadyUs = esp_timer_get_time();
 
-  // 5. Initialize Network (Ethernet + WiFi)
-  // We'll use either Ethernet, WiFi STA, or WiFi AP (Safe Mode)
-  static EthernetW5500 ethernet;
-  static WifiInterface wifi;
-
-  // Initialize Ethernet if LAN is enabled
-  if (appConfig.network.lan.enabled) {
-    EthernetW5500::Config ethCfg; // USE CORRECT CLASS CONFIG
-    ethCfg.ipMode = appConfig.network.lan.useDhcp ? Network::IpMode::DHCP
-                                                  : Network::IpMode::STATIC;
-    ethCfg.staticIp = appConfig.network.lan.staticIp;
-    ethCfg.staticNetmask = appConfig.network.lan.netmask;
-    ethCfg.staticGateway = appConfig.network.lan.gateway;
-
-    // Use default pins defined in EthernetW5500.h or customize here if needed
-    // CS=21, RST=22, INT=25, SCLK=18, MISO=19, MOSI=23
-
-    ESP_LOGI(TAG, "Iniciando LAN W5500 (%d.%d.%d.%d)...",
-             ethCfg.staticIp.addr[0], ethCfg.staticIp.addr[1],
-             ethCfg.staticIp.addr[2], ethCfg.staticIp.addr[3]);
-
-    if (ethernet.init(&ethCfg) == ESP_OK && ethernet.start() == ESP_OK) {
-      g_networkInterface = &ethernet;
-      ESP_LOGI(TAG, "LAN lista.");
-    } else {
-      ESP_LOGE(TAG, "ERROR al iniciar LAN (Hardware W5500 no responde?)");
-    }
+  // 3. Rest of the configuration, then network in parallel tasks
+  if (ConfigManager::getConfig(&g_appConfig) != ESP_OK) {
+    ESP_LOGE(TAG, "FALLO CRÍTICO: No se pudo cargar la configuración.");
   }
-
-  // Initialize WiFi (STA o AP)
-  // SOLO inicia AP si el Safe Mode está activo.
-  bool startAP = safeModeActive;
-
-  if (startAP || appConfig.network.wlanOp.enabled) {
-    WifiInterface::Config wifiCfg;
-
-    if (startAP) {
-      // Initialize WLAN-SAFE (AP Mode)
-      wifiCfg.enabled = true;
-      wifiCfg.apMode = true;
-      strncpy(wifiCfg.apSsid, appConfig.network.wlanSafe.ssid,
-              sizeof(wifiCfg.apSsid) - 1);
-      strncpy(wifiCfg.apPassword, appConfig.network.wlanSafe.password,
-              sizeof(wifiCfg.apPassword) - 1);
-      wifiCfg.apChannel = appConfig.network.wlanSafe.channel;
-      wifiCfg.staticIp = appConfig.network.wlanSafe.apIp;
-
-      ESP_LOGW(TAG, "Iniciando WiFi AP (%s) como %s", wifiCfg.apSsid,
-               safeModeActive ? "MODO SEGURO" : "MODO FALLBACK");
-    } else {
-      // Initialize WLAN-OP (STA Mode)
-      wifiCfg.enabled = true;
-      wifiCfg.apMode = false;
-      strncpy(wifiCfg.ssid, appConfig.network.wlanOp.ssid,
-              sizeof(wifiCfg.ssid) - 1);
-      strncpy(wifiCfg.password, appConfig.network.wlanOp.password,
-              sizeof(wifiCfg.password) - 1);
-      wifiCfg.ipMode = appConfig.network.wlanOp.useDhcp
-                           ? Network::IpMode::DHCP
-                           : Network::IpMode::STATIC;
-      wifiCfg.staticIp = appConfig.network.wlanOp.staticIp;
-      wifiCfg.staticNetmask = appConfig.network.wlanOp.netmask;
-      wifiCfg.staticGateway = appConfig.network.wlanOp.gateway;
-
-      ESP_LOGI(TAG, "Iniciando WiFi STA (%s)...", wifiCfg.ssid);
-    }
-
-    if (wifi.init(&wifiCfg) == ESP_OK && wifi.start() == ESP_OK) {
-      if (!g_networkInterface) {
-        g_networkInterface = &wifi;
-      }
-      ESP_LOGI(TAG, "WiFi interface initialized (%s)",
-               wifiCfg.apMode ? "AP" : "STA");
-    } else {
-      ESP_LOGE(TAG, "Failed to initialize WiFi");
-    }
+  if (g_safeMode) {
+    // Disable LAN and WLAN-OP in RAM for this session
+    g_appConfig.network.lan.enabled = false;
+    g_appConfig.network.wlanOp.enabled = false;
+    ESP_LOGW(TAG, "Safe Mode: LAN/WLAN-OP deshabilitados temporalmente.");
+  } else {
+    ESP_LOGI(TAG, "Arranque Normal. Configuración actual:");
+    ESP_LOGI(TAG, "  - LAN: %s (IP: %d.%d.%d.%d)",
+             g_appConfig.network.lan.enabled ? "SI" : "NO",
+             g_appConfig.network.lan.staticIp.addr[0],
+             g_appConfig.network.lan.staticIp.addr[1],
+             g_appConfig.network.lan.staticIp.addr[2],
+             g_appConfig.network.lan.staticIp.addr[3]);
+    ESP_LOGI(TAG, "  - WiFi OP: %s (SSID: %s)",
+             g_appConfig.network.wlanOp.enabled ? "SI" : "NO",
+             g_appConfig.network.wlanOp.ssid);
   }
 
-  // 6. Initialize Web Server
-  if (g_networkInterface) {
-    if (WebServer::init(&ethernet, &wifi, appConfig.network.webServerPort) ==
-        ESP_OK) {
-      WebServer::DataLoggerCallbacks callbacks = {
-          .getFlashStats =
-              [](void *s) {
-                return FlashRing::getStats((FlashRing::Stats *)s);
-              },
-          .getTransportStats =
-              [](void *s) {
-                return g_dataSource
-                           ? g_dataSource->getStats((Transport::Stats *)s)
-                           : ESP_FAIL;
-              },
-          .getPipelineStats =
-              [](void *s) {
-                return DataPipeline::getStats((DataPipeline::Stats *)s);
-              },
-          .getTransportTypeName =
-              []() {
-                return g_dataSource
-                           ? (g_dataSource->getType() == Transport::Type::UART
-                                  ? "uart"
-                                  : "parallel_port")
-                           : "none";
-              },
-          .formatFlash =
-              []() {
-                esp_err_t r = FlashRing::erase();
-                if (r == ESP_OK) {
-                  if (g_dataSource)
-                    g_dataSource->resetStats();
-                  DataPipeline::resetStats();
-                }
-                return r;
-              },
-          .readFlash = [](uint32_t o, uint32_t l, uint8_t *b,
-                          size_t *r) { return FlashRing::readAt(o, b, l, r); }};
-      WebServer::setDataLoggerCallbacks(&callbacks);
-      ESP_LOGI(TAG, "Web Server ready");
-    }
+  ESP_ERROR_CHECK(esp_netif_init());
+  ESP_ERROR_CHECK(esp_event_loop_create_default());
+  g_netDone = xSemaphoreCreateCounting(2, 0);
+  g_servicesDone = xSemaphoreCreateBinary();
+  ESP_ERROR_CHECK(g_netDone && g_servicesDone ? ESP_OK : ESP_ERR_NO_MEM);
+
+  int links = 0;
+  if (g_appConfig.network.lan.enabled &&
+      xTaskCreate(ethernetBootTask, "boot_eth", 4096, nullptr, 5, nullptr) ==
+          pdPASS) {
+    links++;
+  }
+  if ((g_safeMode || g_appConfig.network.wlanOp.enabled) &&
+      xTaskCreate(wifiBootTask, "boot_wifi", 4096, nullptr, 5, nullptr) ==
+          pdPASS) {
+    links++;
+  }
+  if (xTaskCreate(servicesBootTask, "boot_services", 6144,
+                  (void *)(intptr_t)links, 5, nullptr) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create services boot task");
+    xSemaphoreGive(g_servicesDone);
   }
 
-  // 7. Start UI/CLI Interfaces
-  CommandSystem::initialize(g_dataSource);
-
-  // 8. Initialize MQTT (if network is available - MQTT can work for both COORDINADOR and ENDPOINT)
-  if (g_networkInterface) {
-    if (g_mqttManager.init() == ESP_OK) {
-      ESP_LOGI(TAG, "MQTT Manager initialized");
-      
-      // Initialize MQTT command handler (pass MqttManager, not MqttClient)
-      if (MqttCommandHandler::init(&g_mqttManager) == ESP_OK) {
-        ESP_LOGI(TAG, "MQTT Command Handler initialized");
-      } else {
-        ESP_LOGW(TAG, "MQTT Command Handler initialization failed");
-      }
-      
-      // Try to connect MQTT
-      if (g_mqttManager.connect() == ESP_OK) {
-        ESP_LOGI(TAG, "MQTT connecting...");
-      } else {
-        ESP_LOGW(TAG, "MQTT connection failed");
+  // 4. Flash meanwhile (may erase pages on a fresh partition)
+  ESP_ERROR_CHECK(FlashRing::init("datalog"));
+  ESP_ERROR_CHECK(RecordStore::init());
+  DataPipeline::storageReady();
+  g_storageReadyUs = esp_timer_get_time();
+
+  // Optional SD card: flash data ages out to it in the background
+  if (SD_CARD_TIER) {
+    if (g_sdCard.init(SdCardBackend::Config()) == ESP_OK) {
+      if (StorageTier::init(&g_sdCard) != ESP_OK) {
+        ESP_LOGW(TAG, "Storage tiering initialization failed");
       }
     } else {
-      ESP_LOGW(TAG, "MQTT Manager initialization failed");
+      ESP_LOGI(TAG, "Sin tarjeta SD: solo flash interna");
     }
   }
 
-  // 9. Start Button Monitor (for SAFE MODE trigger)
+  // 5. Start UI/CLI Interfaces
+  CommandSystem::initialize(g_dataSource);
+  OtaUpdate::init(g_dataSource);
+
+  // 6. Start Button Monitor (for SAFE MODE trigger)
   ESP_ERROR_CHECK(ButtonMonitor::init());
 
+  xSemaphoreTake(g_servicesDone, portMAX_DELAY);
+
+  ESP_LOGI(TAG, "Boot: captura %lld ms, flash %lld ms, red %lld ms",
+           (long long)(g_captureReadyUs / 1000),
+           (long long)(g_storageReadyUs / 1000),
+           (long long)(g_networkReadyUs / 1000));
   ESP_LOGI(TAG, "System Ready. Free heap: %lu bytes", esp_get_free_heap_size());
+  // A freshly updated image is kept only once it gets this far
+  OtaUpdate::confirmImage();
+  MemoryPlan::report();
   esp_log_level_set("*", ESP_LOG_INFO);
 
   // Initialization finished - LED to IDLE
@@ -286,15 +653,21 @@ extern "C" void app_main(void) {
   // Main Monitoring Loop
   uint32_t uptime = 0;
   while (true) {
-    bool connected = g_networkInterface && g_networkInterface->isConnected();
+    bool connected = NetworkManager::isConnected();
     if (connected && !WebServer::isRunning()) {
       ESP_LOGI(TAG, "Network UP - Starting Web Server");
       WebServer::start();
     }
+    if (connected && g_appConfig.network.tapPort != 0 && !TcpTap::isRunning()) {
+      TcpTap::start();
+    }
 
     if (uptime % 60 == 0) {
+      INetworkInterface *uplink = NetworkManager::getActive();
       ESP_LOGI(TAG, "Heartbeat: Uptime=%lu s, Heap=%lu, Net=%s", uptime,
-               esp_get_free_heap_size(), connected ? "UP" : "DOWN");
+               esp_get_free_heap_size(),
+               connected ? NetworkManager::linkName(uplink->getType())
+                         : "DOWN");
     }
     vTaskDelay(pdMS_TO_TICKS(1000));
     uptime++;
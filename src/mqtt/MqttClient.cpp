@@ -14,9 +14,14 @@ static const char *TAG = "MqttClient";
 static const uint32_t RECONNECT_DELAY_MS = 5000;
 static const uint32_t MAX_RECONNECT_DELAY_MS = 60000;
 
+// Límite del outbox: acota el heap usado por mensajes sin confirmar
+static const uint64_t OUTBOX_LIMIT_BYTES = 32 * 1024;
+
 MqttClient::MqttClient()
     : m_client(nullptr), m_state(State::DISCONNECTED), m_autoReconnect(true),
-      m_reconnectAttempts(0), m_lastReconnectAttempt(0), m_port(1883),
+      m_reconnectAttempts(0), m_lastReconnectAttempt(0), m_relinking(false),
+      m_reconnectPending(false), m_reconnectJob(Housekeeping::INVALID_JOB),
+      m_port(1883),
       m_qos(1), m_useAuth(false) {
   m_host[0] = '\0';
   m_username[0] = '\0';
@@ -28,6 +33,7 @@ MqttClient::MqttClient()
 }
 
 MqttClient::~MqttClient() {
+  Housekeeping::remove(m_reconnectJob);
   if (m_client) {
     disconnect();
     esp_mqtt_client_destroy(m_client);
@@ -83,8 +89,11 @@ esp_err_t MqttClient::init() {
 
   mqtt_cfg->broker.address.uri = m_uri;
   mqtt_cfg->session.keepalive = 60;
-  mqtt_cfg->session.disable_clean_session = false;
+  // Sesión persistente: el broker conserva suscripciones y QoS 1 entre
+  // reconexiones (cambio de enlace Ethernet/WiFi)
+  mqtt_cfg->session.disable_clean_session = true;
   mqtt_cfg->session.last_will.topic = nullptr; // Sin Last Will por ahora
+  mqtt_cfg->outbox.limit = OUTBOX_LIMIT_BYTES;
 
   // Configurar autenticación si está habilitada
   if (m_useAuth && strlen(m_username) > 0) {
@@ -113,6 +122,14 @@ esp_err_t MqttClient::init() {
   esp_mqtt_client_register_event(m_client, MQTT_EVENT_ANY, mqttEventHandler,
                                  this);
 
+  // Reinicio del cliente tras el retardo de reconexión: corre en la tarea de
+  // housekeeping, fuera del handler de eventos
+  if (m_reconnectJob == Housekeeping::INVALID_JOB &&
+      Housekeeping::add("mqtt_reconnect", reconnectJob, this,
+                        Housekeeping::IDLE, &m_reconnectJob) != ESP_OK) {
+    ESP_LOGW(TAG, "Sin job de reconexión, solo la del cliente MQTT");
+  }
+
   ESP_LOGI(TAG, "Cliente MQTT inicializado correctamente");
   return ESP_OK;
 }
@@ -207,12 +224,32 @@ esp_err_t MqttClient::disconnect() {
 
   ESP_LOGI(TAG, "Desconectando del broker MQTT...");
   m_autoReconnect = false; // Deshabilitar reconexión automática
+  Housekeeping::schedule(m_reconnectJob, Housekeeping::IDLE); // Cancelar pendiente
+  m_reconnectPending = false;
   esp_err_t ret = esp_mqtt_client_stop(m_client);
   m_state = State::DISCONNECTED;
 
   return ret;
 }
 
+esp_err_t MqttClient::reconnect() {
+  if (!m_client || !m_autoReconnect) {
+    return ESP_ERR_INVALID_STATE; // Sin iniciar o desconectado a pedido
+  }
+
+  ESP_LOGI(TAG, "Reconectando al broker por la nueva ruta...");
+  m_relinking = true;
+  // Cierra el socket (el cliente queda esperando reconexión) y reconecta
+  // sin el retardo de reconexión
+  esp_mqtt_client_disconnect(m_client);
+  esp_err_t ret = esp_mqtt_client_reconnect(m_client);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Reconexión inmediata rechazada: %s", esp_err_to_name(ret));
+    m_relinking = false;
+  }
+  return ret;
+}
+
 esp_err_t MqttClient::publish(const uint8_t *payload, size_t payloadLen,
                               int qos, bool retain) {
   if (strlen(m_topicPub) == 0) {
@@ -255,6 +292,35 @@ esp_err_t MqttClient::publish(const char *topic, const uint8_t *payload,
   return ESP_OK;
 }
 
+esp_err_t MqttClient::enqueue(const char *topic, const uint8_t *payload,
+                              size_t payloadLen, int qos, int *msgId) {
+  if (!m_client || m_state != State::CONNECTED) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (!topic || !payload) {
+    ESP_LOGE(TAG, "Topic o payload inválido");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int id = esp_mqtt_client_enqueue(m_client, topic, (const char *)payload,
+                                   payloadLen, qos, false, true);
+  if (id < 0) {
+    // -2: outbox lleno
+    ESP_LOGD(TAG, "No se pudo encolar mensaje en %s (%d)", topic, id);
+    return (id == -2) ? ESP_ERR_NO_MEM : ESP_FAIL;
+  }
+
+  if (msgId) {
+    *msgId = id;
+  }
+  return ESP_OK;
+}
+
+int MqttClient::getOutboxSize() const {
+  return m_client ? esp_mqtt_client_get_outbox_size(m_client) : 0;
+}
+
 esp_err_t MqttClient::subscribe() {
   if (strlen(m_topicSub) == 0) {
     ESP_LOGE(TAG, "Topic de suscripción no configurado");
@@ -334,6 +400,7 @@ void MqttClient::handleMqttEvent(int32_t event_id, void *event_data) {
     ESP_LOGI(TAG, "Conectado al broker MQTT");
     m_state = State::CONNECTED;
     m_reconnectAttempts = 0;
+    m_relinking = false;
 
     // Notificar callback de conexión
     if (m_connectionCallback) {
@@ -355,8 +422,8 @@ void MqttClient::handleMqttEvent(int32_t event_id, void *event_data) {
       m_connectionCallback(false);
     }
 
-    // Intentar reconectar si está habilitado
-    if (m_autoReconnect) {
+    // Intentar reconectar si está habilitado (reconnect() ya lo hace)
+    if (m_autoReconnect && !m_relinking) {
       attemptReconnect();
     }
     break;
@@ -371,6 +438,9 @@ void MqttClient::handleMqttEvent(int32_t event_id, void *event_data) {
 
   case MQTT_EVENT_PUBLISHED:
     ESP_LOGD(TAG, "Mensaje publicado (msg_id=%d)", event->msg_id);
+    if (m_publishedCallback) {
+      m_publishedCallback(event->msg_id);
+    }
     break;
 
   case MQTT_EVENT_DATA:
@@ -395,8 +465,8 @@ void MqttClient::handleMqttEvent(int32_t event_id, void *event_data) {
     ESP_LOGE(TAG, "Error MQTT: %s", esp_err_to_name(event->error_handle->error_type));
     m_state = State::ERROR;
 
-    // Intentar reconectar si está habilitado
-    if (m_autoReconnect) {
+    // Intentar reconectar si está habilitado (reconnect() ya lo hace)
+    if (m_autoReconnect && !m_relinking) {
       attemptReconnect();
     }
     break;
@@ -408,7 +478,9 @@ void MqttClient::handleMqttEvent(int32_t event_id, void *event_data) {
 }
 
 void MqttClient::attemptReconnect() {
-  uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  if (m_reconnectPending || m_reconnectJob == Housekeeping::INVALID_JOB) {
+    return; // Ya programada (cada intento fallido repite el evento)
+  }
 
   // Calcular delay exponencial
   uint32_t delay = RECONNECT_DELAY_MS;
@@ -419,22 +491,27 @@ void MqttClient::attemptReconnect() {
     }
   }
 
-  // Verificar si ha pasado suficiente tiempo desde el último intento
-  if (now - m_lastReconnectAttempt < delay) {
-    return; // Aún no es momento de reconectar
+  // El reinicio corre en la tarea de housekeeping, sin bloquear este handler
+  m_reconnectPending = true;
+  Housekeeping::schedule(m_reconnectJob, delay);
+}
+
+uint32_t MqttClient::reconnectJob(void *ctx) {
+  MqttClient *self = static_cast<MqttClient *>(ctx);
+  self->m_reconnectPending = false;
+  if (!self->m_client || !self->m_autoReconnect ||
+      self->m_state == State::CONNECTED) {
+    return Housekeeping::IDLE;
   }
 
-  m_lastReconnectAttempt = now;
-  m_reconnectAttempts++;
+  self->m_lastReconnectAttempt = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  self->m_reconnectAttempts++;
 
   ESP_LOGW(TAG, "Intentando reconectar al broker MQTT (intento %lu)...",
-           m_reconnectAttempts);
+           self->m_reconnectAttempts);
 
   // Reiniciar cliente
-  if (m_client) {
-    esp_mqtt_client_stop(m_client);
-    vTaskDelay(pdMS_TO_TICKS(1000)); // Esperar un segundo
-    esp_mqtt_client_start(m_client);
-  }
+  esp_mqtt_client_stop(self->m_client);
+  esp_mqtt_client_start(self->m_client);
+  return Housekeeping::IDLE;
 }
-
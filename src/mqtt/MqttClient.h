@@ -2,6 +2,7 @@
 
 #include "esp_err.h"
 #include "mqtt_client.h"
+#include "utils/Housekeeping.h"
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -29,6 +30,12 @@ public:
    */
   using ConnectionCallback = std::function<void(bool connected)>;
 
+  /**
+   * @brief Callback para confirmaciones de publicación (QoS 1/2)
+   * @param msgId ID devuelto al publicar o encolar el mensaje
+   */
+  using PublishedCallback = std::function<void(int msgId)>;
+
   /**
    * @brief Estado del cliente MQTT
    */
@@ -68,6 +75,17 @@ public:
    */
   esp_err_t disconnect();
 
+  /**
+   * @brief Reconecta al broker de inmediato, conservando la sesión
+   *
+   * Cierra la conexión TCP actual y abre una nueva por la ruta por defecto
+   * (p. ej. tras un cambio de enlace en NetworkManager). La sesión es
+   * persistente y el outbox se conserva, así que las suscripciones y los
+   * mensajes QoS 1 sin confirmar sobreviven al cambio.
+   * @return ESP_OK en éxito
+   */
+  esp_err_t reconnect();
+
   /**
    * @brief Publica un mensaje en el topic configurado
    * @param payload Datos a publicar
@@ -89,6 +107,27 @@ public:
    */
   esp_err_t publish(const char *topic, const uint8_t *payload, size_t payloadLen, int qos = -1, bool retain = false);
 
+  /**
+   * @brief Encola un mensaje en el outbox sin bloquear
+   *
+   * El envío lo realiza la tarea MQTT. Con QoS > 0 la confirmación llega
+   * por PublishedCallback con el mismo msgId.
+   *
+   * @param topic Topic donde publicar
+   * @param payload Datos a publicar
+   * @param payloadLen Longitud de los datos
+   * @param qos Nivel de calidad de servicio (0, 1 o 2)
+   * @param msgId ID del mensaje (salida, puede ser nullptr)
+   * @return ESP_OK en éxito, ESP_ERR_NO_MEM si el outbox está lleno
+   */
+  esp_err_t enqueue(const char *topic, const uint8_t *payload, size_t payloadLen, int qos, int *msgId);
+
+  /**
+   * @brief Bytes pendientes en el outbox (enviados sin confirmar o en cola)
+   * @return Tamaño del outbox en bytes
+   */
+  int getOutboxSize() const;
+
   /**
    * @brief Suscribe al topic configurado
    * @return ESP_OK en éxito
@@ -140,12 +179,23 @@ public:
    */
   void setConnectionCallback(ConnectionCallback callback) { m_connectionCallback = callback; }
 
+  /**
+   * @brief Establece el callback para confirmaciones de publicación
+   * @param callback Función a llamar en MQTT_EVENT_PUBLISHED (tarea MQTT)
+   */
+  void setPublishedCallback(PublishedCallback callback) { m_publishedCallback = callback; }
+
   /**
    * @brief Habilita o deshabilita la reconexión automática
    * @param enabled true para habilitar reconexión automática
    */
   void setAutoReconnect(bool enabled) { m_autoReconnect = enabled; }
 
+  /**
+   * @brief Topic de publicación configurado
+   */
+  const char *getTopicPub() const { return m_topicPub; }
+
   /**
    * @brief Obtiene la configuración MQTT actual desde ConfigManager
    * @return ESP_OK en éxito
@@ -170,15 +220,25 @@ private:
   void handleMqttEvent(int32_t event_id, void *event_data);
 
   /**
-   * @brief Intenta reconectar al broker
+   * @brief Programa la reconexión al broker tras el retardo exponencial
    */
   void attemptReconnect();
 
+  /**
+   * @brief Job de housekeeping: reinicia el cliente MQTT
+   * @param ctx Instancia de MqttClient
+   * @return Housekeeping::IDLE (solo corre cuando se programa)
+   */
+  static uint32_t reconnectJob(void *ctx);
+
   esp_mqtt_client_handle_t m_client;      ///< Handle del cliente MQTT
   State m_state;                          ///< Estado actual
   bool m_autoReconnect;                    ///< Reconexión automática habilitada
   uint32_t m_reconnectAttempts;           ///< Intentos de reconexión
   uint32_t m_lastReconnectAttempt;        ///< Último intento de reconexión (ms)
+  volatile bool m_relinking;              ///< reconnect() en curso, sin reinicio del cliente
+  volatile bool m_reconnectPending;       ///< Reinicio programado en housekeeping
+  Housekeeping::JobId m_reconnectJob;     ///< Job de housekeeping del reinicio
   
   // Configuración desde NVS
   char m_host[64];                        ///< Host del broker
@@ -194,5 +254,6 @@ private:
 
   MessageCallback m_messageCallback;      ///< Callback para mensajes
   ConnectionCallback m_connectionCallback; ///< Callback para conexión
+  PublishedCallback m_publishedCallback;   ///< Callback para confirmaciones
 };
 
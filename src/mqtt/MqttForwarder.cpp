@@ -0,0 +1,322 @@
+#include "MqttForwarder.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "network/NetworkManager.h"
+#include "storage/FlashRing.h"
+#include "utils/Lz4.h"
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+static const char *TAG = "MqttForwarder";
+
+// Cursor name in the FlashRing journal
+static const char *CURSOR_NAME = "mqtt";
+
+// Batches awaiting MQTT_EVENT_PUBLISHED before reading stops
+static const size_t MAX_IN_FLIGHT = 4;
+
+// Outbox size above which no new batch is queued
+static const int OUTBOX_HIGH_WATER = 16 * 1024;
+
+// Oldest batch unconfirmed for this long is considered lost
+static const uint32_t ACK_TIMEOUT_MS = 30000;
+
+// Poll interval while idle or throttled (acks wake the task earlier)
+static const uint32_t IDLE_POLL_MS = 200;
+
+// Cursor positions are journaled at most this often
+static const uint32_t CURSOR_SAVE_INTERVAL_MS = 10000;
+
+// Depth of the ack queue (other QoS 1 publishes are reported too)
+static const size_t ACK_QUEUE_DEPTH = 16;
+
+namespace MqttForwarder {
+
+struct InFlight {
+  int msgId;
+  uint64_t end;       // Logical position after the batch
+  size_t wireBytes;   // Payload bytes sent
+  TickType_t sentAt;
+  int64_t sentUs;     // For the uplink throughput estimate
+  bool acked;
+};
+
+static MqttManager *s_mqtt = nullptr;
+static char s_topic[64] = {};
+static size_t s_batchSize = 0;
+static bool s_compress = false;
+static bool s_initialized = false;
+
+static FlashRing::CursorId s_cursor = -1;
+static uint64_t s_readPos = 0;    // Next byte to send (ahead of the cursor)
+static bool s_cursorMoved = false;
+static TickType_t s_lastCursorSave = 0;
+
+static InFlight s_inFlight[MAX_IN_FLIGHT] = {};
+static size_t s_inFlightHead = 0;
+static size_t s_inFlightCount = 0;
+
+static QueueHandle_t s_ackQueue = nullptr;
+static TaskHandle_t s_taskHandle = nullptr;
+
+// [BatchHeader][raw stream bytes] and, with compression, the same header
+// followed by the LZ4 block
+static uint8_t *s_rawPacket = nullptr;
+static uint8_t *s_lzPacket = nullptr;
+static void *s_lzWork = nullptr;
+
+static Stats s_stats = {};
+
+static void forwarderTask(void *arg);
+
+esp_err_t init(MqttManager *mqtt, const Config &config) {
+  if (s_initialized) {
+    return ESP_OK;
+  }
+  if (!mqtt || !config.topic || config.topic[0] == '\0' ||
+      config.batchSize == 0 || config.batchSize > Lz4::MAX_INPUT_SIZE) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  s_mqtt = mqtt;
+  strncpy(s_topic, config.topic, sizeof(s_topic) - 1);
+  s_batchSize = config.batchSize;
+  s_compress = config.compress;
+
+  esp_err_t ret = FlashRing::openCursor(CURSOR_NAME, &s_cursor);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open cursor: %s", esp_err_to_name(ret));
+    return ret;
+  }
+  FlashRing::CursorInfo info;
+  FlashRing::getCursor(s_cursor, &info);
+  s_readPos = info.position;
+
+  s_rawPacket = (uint8_t *)malloc(sizeof(BatchHeader) + s_batchSize);
+  if (s_compress) {
+    s_lzPacket = (uint8_t *)malloc(sizeof(BatchHeader) +
+                                   Lz4::compressBound(s_batchSize));
+    s_lzWork = malloc(Lz4::WORK_SIZE);
+  }
+  s_ackQueue = xQueueCreate(ACK_QUEUE_DEPTH, sizeof(int));
+  if (!s_rawPacket || (s_compress && (!s_lzPacket || !s_lzWork)) ||
+      !s_ackQueue) {
+    ESP_LOGE(TAG, "Failed to allocate forwarding buffers");
+    free(s_rawPacket);
+    free(s_lzPacket);
+    free(s_lzWork);
+    s_rawPacket = s_lzPacket = nullptr;
+    s_lzWork = nullptr;
+    if (s_ackQueue) {
+      vQueueDelete(s_ackQueue);
+      s_ackQueue = nullptr;
+    }
+    return ESP_ERR_NO_MEM;
+  }
+
+  // Runs in the MQTT task: hand the id over, matching happens in ours
+  s_mqtt->setPublishedCallback([](int msgId) {
+    xQueueSend(s_ackQueue, &msgId, 0);
+  });
+
+  BaseType_t taskRet = xTaskCreate(forwarderTask, "mqtt_forward", 4096,
+                                   nullptr, tskIDLE_PRIORITY + 3, &s_taskHandle);
+  if (taskRet != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create forwarder task");
+    s_mqtt->setPublishedCallback(nullptr);
+    return ESP_ERR_NO_MEM;
+  }
+
+  s_initialized = true;
+  ESP_LOGI(TAG, "Forwarding to '%s' (batch %u bytes%s), %" PRIu64 " bytes pending",
+           s_topic, s_batchSize, s_compress ? ", LZ4" : "", info.pending);
+  return ESP_OK;
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  FlashRing::CursorInfo info;
+  if (FlashRing::getCursor(s_cursor, &info) == ESP_OK) {
+    s_stats.pending = info.pending;
+    s_stats.dropped = info.dropped;
+  }
+  s_stats.inFlight = s_inFlightCount;
+  *stats = s_stats;
+  return ESP_OK;
+}
+
+// Forget unconfirmed batches and continue from the cursor
+static void restartFromCursor() {
+  if (s_inFlightCount > 0) {
+    s_stats.resends++;
+  }
+  s_inFlightCount = 0;
+
+  FlashRing::CursorInfo info;
+  if (FlashRing::getCursor(s_cursor, &info) == ESP_OK) {
+    s_readPos = info.position;
+  }
+}
+
+// Advance the cursor over the confirmed prefix of the in-flight window
+static void handleAck(int msgId) {
+  for (size_t i = 0; i < s_inFlightCount; i++) {
+    InFlight &batch = s_inFlight[(s_inFlightHead + i) % MAX_IN_FLIGHT];
+    if (batch.msgId == msgId) {
+      batch.acked = true;
+      NetworkManager::recordTransfer(
+          batch.wireBytes, (uint32_t)(esp_timer_get_time() - batch.sentUs));
+      break;
+    }
+  }
+
+  while (s_inFlightCount > 0 && s_inFlight[s_inFlightHead].acked) {
+    const InFlight &batch = s_inFlight[s_inFlightHead];
+    FlashRing::CursorInfo info;
+    if (FlashRing::getCursor(s_cursor, &info) == ESP_OK &&
+        batch.end > info.position) {
+      s_stats.bytesAcked += batch.end - info.position;
+      FlashRing::seekCursor(s_cursor, batch.end);
+      s_cursorMoved = true;
+    }
+    s_stats.batchesAcked++;
+    s_inFlightHead = (s_inFlightHead + 1) % MAX_IN_FLIGHT;
+    s_inFlightCount--;
+  }
+}
+
+// Fill the raw packet with stream bytes at s_readPos, returns the count
+static size_t readBatch() {
+  uint8_t *data = s_rawPacket + sizeof(BatchHeader);
+  size_t total = 0;
+
+  while (total < s_batchSize) {
+    size_t bytesRead = 0;
+    esp_err_t ret = FlashRing::readLogical(s_readPos + total, data + total,
+                                           s_batchSize - total, &bytesRead);
+    if (ret == ESP_ERR_NOT_FOUND && total == 0) {
+      // Overwritten before it was sent: the cursor accounts the loss
+      uint64_t tail = FlashRing::getLogicalTail();
+      ESP_LOGW(TAG, "Data overwritten before upload, skipping %" PRIu64 " bytes",
+               tail - s_readPos);
+      s_readPos = tail;
+      continue;
+    }
+    if (ret != ESP_OK || bytesRead == 0) {
+      break;
+    }
+    total += bytesRead;
+  }
+  return total;
+}
+
+// Queue one batch of @p len stream bytes, returns false if the outbox refused it
+static bool sendBatch(size_t len) {
+  BatchHeader header = {};
+  header.magic = BATCH_MAGIC;
+  header.version = BATCH_VERSION;
+  header.offsetLo = (uint32_t)s_readPos;
+  header.offsetHi = (uint32_t)(s_readPos >> 32);
+  header.rawLength = len;
+
+  uint8_t *packet = s_rawPacket;
+  size_t packetLen = sizeof(BatchHeader) + len;
+  if (s_compress) {
+    size_t compressed = Lz4::compress(s_rawPacket + sizeof(BatchHeader), len,
+                                      s_lzPacket + sizeof(BatchHeader),
+                                      Lz4::compressBound(s_batchSize), s_lzWork);
+    if (compressed > 0 && compressed < len) {
+      header.flags |= FLAG_COMPRESSED;
+      packet = s_lzPacket;
+      packetLen = sizeof(BatchHeader) + compressed;
+    }
+  }
+  memcpy(packet, &header, sizeof(header));
+
+  int msgId = -1;
+  esp_err_t ret = s_mqtt->sendBinary(s_topic, packet, packetLen, 1, &msgId);
+  if (ret != ESP_OK) {
+    ESP_LOGD(TAG, "Batch not queued: %s", esp_err_to_name(ret));
+    return false;
+  }
+
+  InFlight &batch =
+      s_inFlight[(s_inFlightHead + s_inFlightCount) % MAX_IN_FLIGHT];
+  batch.msgId = msgId;
+  batch.end = s_readPos + len;
+  batch.wireBytes = packetLen;
+  batch.sentAt = xTaskGetTickCount();
+  batch.sentUs = esp_timer_get_time();
+  batch.acked = false;
+  s_inFlightCount++;
+
+  s_readPos += len;
+  s_stats.batchesSent++;
+  s_stats.bytesOnWire += packetLen - sizeof(BatchHeader);
+  return true;
+}
+
+static void forwarderTask(void *arg) {
+  bool wasConnected = false;
+
+  while (true) {
+    int msgId;
+    while (xQueueReceive(s_ackQueue, &msgId, 0) == pdTRUE) {
+      handleAck(msgId);
+    }
+
+    // Persist progress without journaling every acknowledgement
+    TickType_t now = xTaskGetTickCount();
+    if (s_cursorMoved && (now - s_lastCursorSave) >=
+                             pdMS_TO_TICKS(CURSOR_SAVE_INTERVAL_MS)) {
+      FlashRing::flushMetadataAsync();
+      s_cursorMoved = false;
+      s_lastCursorSave = now;
+    }
+
+    bool connected = s_mqtt->isConnected();
+    if (connected != wasConnected) {
+      wasConnected = connected;
+      restartFromCursor(); // Outbox contents are not trusted across sessions
+    }
+    if (!connected) {
+      vTaskDelay(pdMS_TO_TICKS(IDLE_POLL_MS));
+      continue;
+    }
+
+    if (s_inFlightCount > 0 &&
+        (now - s_inFlight[s_inFlightHead].sentAt) >=
+            pdMS_TO_TICKS(ACK_TIMEOUT_MS)) {
+      ESP_LOGW(TAG, "Batch %d not confirmed, resending",
+               s_inFlight[s_inFlightHead].msgId);
+      restartFromCursor();
+    }
+
+    bool throttled = s_inFlightCount >= MAX_IN_FLIGHT ||
+                     s_mqtt->getOutboxSize() > OUTBOX_HIGH_WATER;
+    size_t len = throttled ? 0 : readBatch();
+    if (len > 0 && !sendBatch(len)) {
+      throttled = true;
+    }
+
+    if (throttled) {
+      s_stats.throttled++;
+    }
+    if (throttled || len == 0) {
+      // Sleep until an acknowledgement arrives or the poll interval ends
+      xQueuePeek(s_ackQueue, &msgId, pdMS_TO_TICKS(IDLE_POLL_MS));
+    }
+  }
+}
+
+} // namespace MqttForwarder
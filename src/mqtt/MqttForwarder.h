@@ -0,0 +1,86 @@
+#pragma once
+
+#include "esp_err.h"
+#include "MqttManager.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief MqttForwarder - Binary uplink of captured data over MQTT
+ *
+ * Drains the FlashRing record stream through its own cursor ("mqtt") and
+ * publishes it in batches of up to batchSize bytes on the data topic, each
+ * batch prefixed with a BatchHeader. Batches are byte ranges of the stream
+ * (records may span batches); the logical offset in the header lets the
+ * receiver reassemble the stream, detect gaps and discard duplicates.
+ *
+ * Delivery is at-least-once: batches go out with QoS 1 and the cursor only
+ * advances when MQTT_EVENT_PUBLISHED confirms them, in order. After a
+ * disconnect or a missing acknowledgement the unconfirmed range is sent
+ * again. Reading is throttled by the number of batches in flight and by
+ * the MQTT outbox size, so a slow broker cannot exhaust the heap; the data
+ * simply waits in flash.
+ *
+ * Headers of records still being written carry RecordStore::LENGTH_OPEN;
+ * their footer holds the final length.
+ */
+namespace MqttForwarder {
+
+/// Batch header magic "MQB1"
+constexpr uint32_t BATCH_MAGIC = 0x3142514D;
+
+/// Batch format version
+constexpr uint8_t BATCH_VERSION = 1;
+
+/// BatchHeader::flags bit: payload is an LZ4 block (see utils/Lz4.h)
+constexpr uint8_t FLAG_COMPRESSED = 0x01;
+
+/// Prefix of every data message (little-endian)
+struct BatchHeader {
+    uint32_t magic;      ///< BATCH_MAGIC
+    uint8_t  version;    ///< BATCH_VERSION
+    uint8_t  flags;      ///< FLAG_COMPRESSED
+    uint16_t reserved;   ///< Zero
+    uint32_t offsetLo;   ///< Logical stream position of the first byte, low word
+    uint32_t offsetHi;   ///< Logical stream position, high word
+    uint32_t rawLength;  ///< Stream bytes in this batch (after decompression)
+};
+static_assert(sizeof(BatchHeader) == 20, "BatchHeader layout");
+
+/// Forwarder configuration
+struct Config {
+    const char* topic;     ///< Data topic
+    size_t batchSize;      ///< Maximum stream bytes per message
+    bool compress;         ///< LZ4-compress batches (sent raw if it does not help)
+};
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t batchesSent;    ///< Batches handed to the MQTT outbox
+    uint32_t batchesAcked;   ///< Batches confirmed by the broker
+    uint32_t resends;        ///< Times the unconfirmed range was sent again
+    uint32_t throttled;      ///< Times reading paused on in-flight/outbox limits
+    uint32_t inFlight;       ///< Batches currently awaiting confirmation
+    uint64_t bytesAcked;     ///< Stream bytes confirmed
+    uint64_t bytesOnWire;    ///< Payload bytes sent (after compression)
+    uint64_t pending;        ///< Stream bytes not yet confirmed
+    uint64_t dropped;        ///< Bytes overwritten before they were sent
+};
+
+/**
+ * @brief Open the "mqtt" cursor and start the forwarding task
+ *
+ * Must be called after FlashRing::init() and MqttManager::init().
+ *
+ * @param mqtt   MQTT manager used for publishing
+ * @param config Forwarder configuration
+ * @return ESP_OK on success
+ */
+esp_err_t init(MqttManager* mqtt, const Config& config);
+
+/**
+ * @brief Get forwarding statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+} // namespace MqttForwarder
@@ -1,19 +1,38 @@
 #include "MqttManager.h"
 #include "esp_log.h"
+#include "esp_random.h"
 #include "esp_sntp.h"
+#include "esp_timer.h"
+#include "storage/OfflineQueue.h"
+#include "utils/JsonWriter.h"
 #include "time.h"
 #include <cstring>
 #include <cmath>
 
 static const char *TAG = "MqttManager";
 
-MqttManager::MqttManager() : m_initialized(false) {
+// Reenvío de la cola offline: un lote cada REPLAY_INTERVAL_MS mientras el
+// outbox tenga menos de REPLAY_OUTBOX_LIMIT bytes; tras reconectar, una
+// espera aleatoria de hasta REPLAY_HOLDOFF_MS reparte la flota
+static const uint32_t REPLAY_INTERVAL_MS = 500;
+static const uint32_t REPLAY_HOLDOFF_MS = 10000;
+static const uint32_t REPLAY_OFFLINE_POLL_MS = 2000;
+static const int REPLAY_OUTBOX_LIMIT = 8 * 1024;
+static const size_t REPLAY_BATCH_SIZE = 2048;
+
+// Envoltura de cada muestra: {"seq":4294967295,"msg":...},
+static const size_t REPLAY_SAMPLE_OVERHEAD = 32;
+
+MqttManager::MqttManager()
+    : m_initialized(false), m_offlineQueue(false), m_replayNotBeforeUs(-1),
+      m_lastReplayUs(0), m_replayJob(Housekeeping::INVALID_JOB) {
   m_jsonBuffer[0] = '\0';
   m_deviceId[0] = '\0';
   m_deviceName[0] = '\0';
 }
 
 MqttManager::~MqttManager() {
+  Housekeeping::remove(m_replayJob);
   if (m_initialized) {
     disconnect();
   }
@@ -27,7 +46,8 @@ esp_err_t MqttManager::init() {
 
   // Load device info from ConfigManager
   ConfigManager::FullConfig config;
-  esp_err_t ret = ConfigManager::getConfig(&config);
+  esp_err_t ret =
+      ConfigManager::getSections(ConfigManager::SECTION_DEVICE, &config);
   if (ret == ESP_OK) {
     strncpy(m_deviceId, config.device.id, sizeof(m_deviceId) - 1);
     m_deviceId[sizeof(m_deviceId) - 1] = '\0';
@@ -68,10 +88,145 @@ esp_err_t MqttManager::disconnect() {
   return m_client.disconnect();
 }
 
+esp_err_t MqttManager::reconnect() {
+  if (!m_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  return m_client.reconnect();
+}
+
 bool MqttManager::isConnected() const {
   return m_initialized && m_client.isConnected();
 }
 
+esp_err_t MqttManager::enableOfflineQueue(const char *partitionLabel) {
+  esp_err_t ret = OfflineQueue::init(partitionLabel);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  if (m_replayJob == Housekeeping::INVALID_JOB) {
+    ret = Housekeeping::add("mqtt_replay", replayJob, this, Housekeeping::IDLE,
+                            &m_replayJob);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+  }
+  m_offlineQueue = true;
+  if (OfflineQueue::pending() > 0) {
+    Housekeeping::notify(m_replayJob); // Pendientes del arranque anterior
+  }
+  ESP_LOGI(TAG, "Cola offline habilitada (%lu pendientes)",
+           OfflineQueue::pending());
+  return ESP_OK;
+}
+
+esp_err_t MqttManager::publishOrQueue(const char *topic, const char *payload,
+                                      size_t len) {
+  // Con mensajes en cola, los nuevos van detrás para mantener el orden
+  if (!m_offlineQueue || (isConnected() && OfflineQueue::pending() == 0)) {
+    esp_err_t ret = topic ? m_client.publish(topic, (const uint8_t *)payload, len)
+                          : m_client.publish((const uint8_t *)payload, len);
+    if (ret == ESP_OK || !m_offlineQueue) {
+      return ret;
+    }
+  }
+
+  esp_err_t ret = OfflineQueue::append(topic, payload, len);
+  if (ret == ESP_OK) {
+    Housekeeping::notify(m_replayJob);
+  }
+  return ret;
+}
+
+uint32_t MqttManager::replayJob(void *ctx) {
+  return static_cast<MqttManager *>(ctx)->replayBatch();
+}
+
+uint32_t MqttManager::replayBatch() {
+  if (OfflineQueue::pending() == 0) {
+    m_replayNotBeforeUs = -1;
+    return Housekeeping::IDLE;
+  }
+  if (!isConnected()) {
+    m_replayNotBeforeUs = -1;
+    return REPLAY_OFFLINE_POLL_MS;
+  }
+  int64_t now = esp_timer_get_time();
+  if (m_replayNotBeforeUs < 0) {
+    m_replayNotBeforeUs =
+        now + (int64_t)(esp_random() % REPLAY_HOLDOFF_MS) * 1000;
+  }
+  // Un append despierta el job antes de tiempo: se respeta la espera
+  if (now < m_replayNotBeforeUs) {
+    return (uint32_t)((m_replayNotBeforeUs - now + 999) / 1000);
+  }
+  int64_t sinceMs = (now - m_lastReplayUs) / 1000;
+  if (sinceMs < REPLAY_INTERVAL_MS) {
+    return REPLAY_INTERVAL_MS - (uint32_t)sinceMs; // Despertado por un append
+  }
+  if (m_client.getOutboxSize() > REPLAY_OUTBOX_LIMIT) {
+    return REPLAY_INTERVAL_MS;
+  }
+
+  // Mensajes consecutivos del mismo topic, mientras quepan en el lote
+  static OfflineQueue::Message msg;
+  static char batch[REPLAY_BATCH_SIZE];
+  static char topic[OfflineQueue::MAX_TOPIC + 1];
+  JsonWriter json(batch, sizeof(batch));
+  json.beginObject();
+  writeDeviceInfo(json);
+  json.field("type", "replay");
+  json.field("pending", OfflineQueue::pending());
+  json.key("samples");
+  json.beginArray();
+
+  uint32_t samples = 0;
+  uint32_t firstSeq = 0;
+  uint32_t lastSeq = 0;
+  OfflineQueue::rewind();
+  while (OfflineQueue::next(&msg) == ESP_OK) {
+    const char *msgTopic = msg.topic[0] ? msg.topic : m_client.getTopicPub();
+    if (samples == 0) {
+      strncpy(topic, msgTopic, sizeof(topic) - 1);
+      topic[sizeof(topic) - 1] = '\0';
+      firstSeq = msg.seq;
+    } else if (strcmp(msgTopic, topic) != 0 ||
+               json.length() + msg.length + REPLAY_SAMPLE_OVERHEAD + 2 >
+                   sizeof(batch)) {
+      break;
+    }
+    json.beginObject();
+    json.field("seq", msg.seq);
+    json.key("msg");
+    json.raw(msg.data, msg.length);
+    json.endObject();
+    lastSeq = msg.seq;
+    samples++;
+  }
+  json.endArray();
+  json.endObject();
+
+  if (samples == 0) {
+    return REPLAY_OFFLINE_POLL_MS; // Error de lectura de la flash
+  }
+  if (json.finish() != ESP_OK) {
+    // Solo si el primer mensaje no cabe en un lote: no se puede reenviar
+    ESP_LOGE(TAG, "Mensaje %lu de la cola offline demasiado grande", firstSeq);
+    OfflineQueue::markDelivered(firstSeq);
+    return 0;
+  }
+
+  m_lastReplayUs = esp_timer_get_time();
+  if (m_client.enqueue(topic, (const uint8_t *)batch, json.length(), 1,
+                       nullptr) != ESP_OK) {
+    return REPLAY_INTERVAL_MS; // Outbox lleno: se reintenta el mismo lote
+  }
+  OfflineQueue::markDelivered(lastSeq);
+  ESP_LOGI(TAG, "Reenviados %lu mensajes hasta seq %lu (%lu pendientes)",
+           samples, lastSeq, OfflineQueue::pending());
+  return REPLAY_INTERVAL_MS;
+}
+
 esp_err_t MqttManager::sendTelemetry(const char* key, float value) {
   return sendTelemetry(key, value, 0);
 }
@@ -113,7 +268,7 @@ esp_err_t MqttManager::sendTelemetry(const char* key, int32_t value, int64_t tim
 }
 
 esp_err_t MqttManager::sendTelemetry(const TelemetryData* data, size_t count, int64_t timestamp) {
-  if (!m_initialized || !isConnected()) {
+  if (!m_initialized || (!isConnected() && !m_offlineQueue)) {
     ESP_LOGW(TAG, "MqttManager no conectado, no se puede enviar telemetría");
     return ESP_ERR_INVALID_STATE;
   }
@@ -130,11 +285,11 @@ esp_err_t MqttManager::sendTelemetry(const TelemetryData* data, size_t count, in
   size_t jsonLen = formatJson(data, count, ts, m_jsonBuffer, sizeof(m_jsonBuffer));
   if (jsonLen == 0) {
     ESP_LOGE(TAG, "Error al formatear JSON");
-    return ESP_FAIL;
+    return ESP_ERR_NO_MEM;
   }
 
-  // Publish via MqttClient
-  return m_client.publish((const uint8_t*)m_jsonBuffer, jsonLen);
+  // Publish via MqttClient (or the offline queue)
+  return publishOrQueue(nullptr, m_jsonBuffer, jsonLen);
 }
 
 esp_err_t MqttManager::sendStatus(const char* status) {
@@ -142,26 +297,20 @@ esp_err_t MqttManager::sendStatus(const char* status) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Format status message as JSON with device info
-  int64_t ts = getCurrentTimestamp();
-  size_t len;
-  
-  if (strlen(m_deviceId) > 0) {
-    len = snprintf(m_jsonBuffer, sizeof(m_jsonBuffer),
-                   "{\"deviceId\":\"%s\",\"deviceName\":\"%s\",\"status\":\"%s\",\"timestamp\":%lld}",
-                   m_deviceId, m_deviceName, status, ts);
-  } else {
-    len = snprintf(m_jsonBuffer, sizeof(m_jsonBuffer),
-                   "{\"deviceName\":\"%s\",\"status\":\"%s\",\"timestamp\":%lld}",
-                   m_deviceName, status, ts);
-  }
-  
-  if (len >= sizeof(m_jsonBuffer)) {
-    ESP_LOGW(TAG, "Buffer JSON truncado para status");
-    len = sizeof(m_jsonBuffer) - 1;
+  // Mensaje de estado en JSON con la info del dispositivo
+  JsonWriter json(m_jsonBuffer, sizeof(m_jsonBuffer));
+  json.beginObject();
+  writeDeviceInfo(json);
+  json.field("status", status);
+  json.field("timestamp", getCurrentTimestamp());
+  json.endObject();
+
+  if (json.finish() != ESP_OK) {
+    ESP_LOGE(TAG, "Buffer JSON insuficiente para status");
+    return ESP_ERR_NO_MEM;
   }
 
-  return m_client.publish((const uint8_t*)m_jsonBuffer, len);
+  return publishOrQueue(nullptr, m_jsonBuffer, json.length());
 }
 
 esp_err_t MqttManager::sendJson(const char* json) {
@@ -188,123 +337,57 @@ esp_err_t MqttManager::sendCommandResponse(const char *topic, const char *reques
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (!isConnected()) {
+  if (!isConnected() && !m_offlineQueue) {
     ESP_LOGW(TAG, "MQTT not connected, cannot send command response");
     return ESP_ERR_INVALID_STATE;
   }
 
-  // Format command response JSON with device info
-  size_t pos = 0;
-
-  // Start JSON object
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "{");
-
-  // Always include device info
-  bool needsComma = false;
-  if (strlen(m_deviceId) > 0) {
-    pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"deviceId\":\"%s\"", m_deviceId);
-    needsComma = true;
-  }
-  if (strlen(m_deviceName) > 0) {
-    if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-    pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"deviceName\":\"%s\"", m_deviceName);
-    needsComma = true;
-  }
-
-  // Add type
-  if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"type\":\"command_response\"");
-  needsComma = true;
-
-  // Add request ID if provided
-  if (requestId && strlen(requestId) > 0) {
-    if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-    pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"id\":\"%s\"", requestId);
-    needsComma = true;
+  // Respuesta al comando en JSON con la info del dispositivo
+  JsonWriter json(m_jsonBuffer, sizeof(m_jsonBuffer));
+  json.beginObject();
+  writeDeviceInfo(json);
+  json.field("type", "command_response");
+  if (requestId && requestId[0] != '\0') {
+    json.field("id", requestId);
   }
+  json.field("command", command);
+  json.field("status", status);
+  json.field("message", message);
 
-  // Add command
-  if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"command\":\"%s\"", command);
-  needsComma = true;
-
-  // Add status
-  if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"status\":\"%s\"", status);
-  needsComma = true;
-
-  // Add message
-  if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-  // Escape message string
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"message\":\"");
-  for (const char *p = message; *p && pos < sizeof(m_jsonBuffer) - 3; p++) {
-    if (*p == '"' || *p == '\\') {
-      pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\\%c", *p);
-    } else if (*p == '\n') {
-      pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\\n");
+  if (data && data[0] != '\0') {
+    json.key("data");
+    if (data[0] == '{') {
+      // Ya es JSON: se embebe tal cual (se asume válido)
+      json.raw(data);
     } else {
-      m_jsonBuffer[pos++] = *p;
+      json.value(data);
     }
   }
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"");
-  needsComma = true;
 
-  // Add data if provided
-  if (data && strlen(data) > 0) {
-    if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-    // Try to parse as JSON, if it's valid JSON, embed it as object
-    if (data[0] == '{') {
-      // It's JSON, embed directly
-      pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"data\":");
-      // Simple copy - assume valid JSON
-      for (const char *p = data; *p && pos < sizeof(m_jsonBuffer) - 2; p++) {
-        m_jsonBuffer[pos++] = *p;
-      }
-      needsComma = true;
-    } else {
-      // It's a string, escape it
-      pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"data\":\"");
-      for (const char *p = data; *p && pos < sizeof(m_jsonBuffer) - 3; p++) {
-        if (*p == '"' || *p == '\\') {
-          pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\\%c", *p);
-        } else if (*p == '\n') {
-          pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\\n");
-        } else {
-          m_jsonBuffer[pos++] = *p;
-        }
-      }
-      pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"");
-      needsComma = true;
-    }
+  if (error && error[0] != '\0') {
+    json.field("error", error);
   }
+  json.endObject();
 
-  // Add error if provided
-  if (error && strlen(error) > 0) {
-    if (needsComma) pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, ",");
-    pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"error\":\"");
-    for (const char *p = error; *p && pos < sizeof(m_jsonBuffer) - 3; p++) {
-      if (*p == '"' || *p == '\\') {
-        pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\\%c", *p);
-      } else if (*p == '\n') {
-        pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\\n");
-      } else {
-        m_jsonBuffer[pos++] = *p;
-      }
-    }
-    pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "\"");
+  if (json.finish() != ESP_OK) {
+    ESP_LOGE(TAG, "Buffer JSON insuficiente para la respuesta de '%s'", command);
+    return ESP_ERR_NO_MEM;
   }
 
-  // Close JSON
-  pos += snprintf(m_jsonBuffer + pos, sizeof(m_jsonBuffer) - pos, "}");
+  // Publish via MqttClient (or the offline queue)
+  return publishOrQueue(topic, m_jsonBuffer, json.length());
+}
 
-  // Ensure null termination
-  if (pos >= sizeof(m_jsonBuffer)) {
-    pos = sizeof(m_jsonBuffer) - 1;
+esp_err_t MqttManager::sendBinary(const char *topic, const uint8_t *payload,
+                                  size_t payloadLen, int qos, int *msgId) {
+  if (!m_initialized || !isConnected()) {
+    return ESP_ERR_INVALID_STATE;
   }
-  m_jsonBuffer[pos] = '\0';
+  return m_client.enqueue(topic, payload, payloadLen, qos, msgId);
+}
 
-  // Publish via MqttClient
-  return m_client.publish(topic, (const uint8_t*)m_jsonBuffer, pos);
+int MqttManager::getOutboxSize() const {
+  return m_initialized ? m_client.getOutboxSize() : 0;
 }
 
 esp_err_t MqttManager::subscribe(const char *topic, int qos) {
@@ -343,6 +426,10 @@ void MqttManager::setConnectionCallback(MqttClient::ConnectionCallback callback)
   m_client.setConnectionCallback(callback);
 }
 
+void MqttManager::setPublishedCallback(MqttClient::PublishedCallback callback) {
+  m_client.setPublishedCallback(callback);
+}
+
 esp_err_t MqttManager::reloadConfig() {
   if (!m_initialized) {
     return ESP_ERR_INVALID_STATE;
@@ -350,7 +437,8 @@ esp_err_t MqttManager::reloadConfig() {
 
   // Reload device info from ConfigManager
   ConfigManager::FullConfig config;
-  esp_err_t ret = ConfigManager::getConfig(&config);
+  esp_err_t ret =
+      ConfigManager::getSections(ConfigManager::SECTION_DEVICE, &config);
   if (ret == ESP_OK) {
     strncpy(m_deviceId, config.device.id, sizeof(m_deviceId) - 1);
     m_deviceId[sizeof(m_deviceId) - 1] = '\0';
@@ -363,110 +451,57 @@ esp_err_t MqttManager::reloadConfig() {
   return m_client.reloadConfig();
 }
 
+void MqttManager::writeDeviceInfo(JsonWriter& json) const {
+  if (m_deviceId[0] != '\0') {
+    json.field("deviceId", m_deviceId);
+  }
+  if (m_deviceName[0] != '\0') {
+    json.field("deviceName", m_deviceName);
+  }
+}
+
 size_t MqttManager::formatJson(const TelemetryData* data, size_t count, int64_t timestamp, char* buffer, size_t bufferSize) {
   if (!data || count == 0 || !buffer || bufferSize == 0) {
     return 0;
   }
 
-  // Start JSON object
-  size_t pos = 0;
-  pos += snprintf(buffer + pos, bufferSize - pos, "{");
+  JsonWriter json(buffer, bufferSize);
+  json.beginObject();
 
-  // Add device ID and name (always included)
-  bool needsComma = false;
-  if (strlen(m_deviceId) > 0) {
-    pos += snprintf(buffer + pos, bufferSize - pos, "\"deviceId\":\"%s\"", m_deviceId);
-    needsComma = true;
-  }
-  if (strlen(m_deviceName) > 0) {
-    if (needsComma) {
-      pos += snprintf(buffer + pos, bufferSize - pos, ",");
-    }
-    pos += snprintf(buffer + pos, bufferSize - pos, "\"deviceName\":\"%s\"", m_deviceName);
-    needsComma = true;
-  }
+  // Info del dispositivo (siempre incluida)
+  writeDeviceInfo(json);
 
-  // Add timestamp if provided
+  // Timestamp si se proporcionó
   if (timestamp > 0) {
-    if (needsComma) {
-      pos += snprintf(buffer + pos, bufferSize - pos, ",");
-    }
-    pos += snprintf(buffer + pos, bufferSize - pos, "\"timestamp\":%lld", timestamp);
-    needsComma = true;
+    json.field("timestamp", timestamp);
   }
 
-  // Add telemetry data
+  // Datos de telemetría
   for (size_t i = 0; i < count; i++) {
-    if (pos >= bufferSize - 1) {
-      ESP_LOGW(TAG, "Buffer JSON lleno");
-      break;
-    }
-
-    // Add comma between fields
-    if (needsComma) {
-      pos += snprintf(buffer + pos, bufferSize - pos, ",");
-    }
-    needsComma = true;
-
-    // Add key
-    pos += snprintf(buffer + pos, bufferSize - pos, "\"%s\":", data[i].key);
-
-    // Add value based on type
+    json.key(data[i].key);
     switch (data[i].type) {
-      case TelemetryData::FLOAT: {
-        float val = data[i].value.fValue;
-        // Check for NaN or Infinity
-        if (std::isnan(val) || std::isinf(val)) {
-          pos += snprintf(buffer + pos, bufferSize - pos, "null");
-        } else {
-          pos += snprintf(buffer + pos, bufferSize - pos, "%.6f", val);
-        }
+      case TelemetryData::FLOAT:
+        // NaN e infinito se escriben como null
+        json.value((double)data[i].value.fValue, 6);
         break;
-      }
       case TelemetryData::INT:
-        pos += snprintf(buffer + pos, bufferSize - pos, "%ld", (long)data[i].value.iValue);
+        json.value(data[i].value.iValue);
         break;
       case TelemetryData::BOOL:
-        pos += snprintf(buffer + pos, bufferSize - pos, "%s", data[i].value.bValue ? "true" : "false");
+        json.value(data[i].value.bValue);
         break;
-      case TelemetryData::STRING: {
-        // Escape JSON string (basic escaping)
-        const char* str = data[i].value.sValue;
-        if (!str) {
-          pos += snprintf(buffer + pos, bufferSize - pos, "null");
-          break;
-        }
-        pos += snprintf(buffer + pos, bufferSize - pos, "\"");
-        // Simple escaping: escape quotes and backslashes
-        for (const char* p = str; *p && pos < bufferSize - 2; p++) {
-          if (*p == '"' || *p == '\\') {
-            pos += snprintf(buffer + pos, bufferSize - pos, "\\%c", *p);
-          } else if (*p == '\n') {
-            pos += snprintf(buffer + pos, bufferSize - pos, "\\n");
-          } else if (*p == '\r') {
-            pos += snprintf(buffer + pos, bufferSize - pos, "\\r");
-          } else if (*p == '\t') {
-            pos += snprintf(buffer + pos, bufferSize - pos, "\\t");
-          } else {
-            buffer[pos++] = *p;
-          }
-        }
-        pos += snprintf(buffer + pos, bufferSize - pos, "\"");
+      case TelemetryData::STRING:
+        json.value(data[i].value.sValue); // nullptr se escribe como null
         break;
-      }
     }
   }
+  json.endObject();
 
-  // Close JSON object
-  pos += snprintf(buffer + pos, bufferSize - pos, "}");
-
-  // Ensure null termination
-  if (pos >= bufferSize) {
-    pos = bufferSize - 1;
+  if (json.finish() != ESP_OK) {
+    ESP_LOGW(TAG, "Buffer JSON lleno (%u campos)", (unsigned)count);
+    return 0;
   }
-  buffer[pos] = '\0';
-
-  return pos;
+  return json.length();
 }
 
 int64_t MqttManager::getCurrentTimestamp() const {
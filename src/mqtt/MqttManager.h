@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <cstddef>
 
+class JsonWriter;
+
 /**
  * @brief MqttManager - High-level MQTT communication manager
  * 
@@ -18,6 +20,20 @@
  *   manager.connect();
  *   manager.sendTelemetry("temperature", 25.5f);
  *   manager.sendStatus("online");
+ *
+ * With enableOfflineQueue(), telemetry, status and command responses that
+ * cannot be published are kept in the OfflineQueue partition, in order
+ * (while anything is queued, new messages queue behind it). A housekeeping
+ * job replays them once the broker is back: after a random hold-off, so a
+ * fleet reconnecting together does not replay at once, it sends one batch
+ * per interval while the outbox is small:
+ *
+ *   {"deviceId":"...","type":"replay","pending":12,
+ *    "samples":[{"seq":41,"msg":{...}},{"seq":42,"msg":{...}}]}
+ *
+ * Each batch holds consecutive messages for one topic, QoS 1. The sequence
+ * numbers are persistent, so the receiver can drop samples it already has
+ * (a batch in the outbox at a reboot is sent again from flash).
  */
 class MqttManager {
 public:
@@ -64,14 +80,31 @@ public:
    */
   esp_err_t disconnect();
 
+  /**
+   * @brief Reconnect now over the current default route, keeping the session
+   * @return ESP_OK on success (see MqttClient::reconnect)
+   */
+  esp_err_t reconnect();
+
   /**
    * @brief Check if connected to broker
    * @return true if connected
    */
   bool isConnected() const;
 
+  /**
+   * @brief Keep messages in the offline queue while the broker is
+   *        unreachable and replay them after reconnect (see above)
+   * @param partitionLabel Data partition of the queue
+   * @return ESP_OK, ESP_ERR_NOT_FOUND if the partition does not exist
+   */
+  esp_err_t enableOfflineQueue(const char *partitionLabel);
+
   /**
    * @brief Send telemetry data (single key-value pair)
+   *
+   * With the offline queue, ESP_OK also when the message was queued.
+   *
    * @param key Key name
    * @param value Float value
    * @return ESP_OK on success
@@ -168,6 +201,23 @@ public:
                                 const char *message, const char *data = nullptr,
                                 const char *error = nullptr);
 
+  /**
+   * @brief Queue a binary message without blocking (see MqttClient::enqueue)
+   * @param topic Topic to publish to
+   * @param payload Message payload
+   * @param payloadLen Payload length
+   * @param qos Quality of Service level (0, 1, or 2)
+   * @param msgId Message ID for PUBLISHED correlation (output, may be nullptr)
+   * @return ESP_OK on success, ESP_ERR_NO_MEM if the outbox is full
+   */
+  esp_err_t sendBinary(const char *topic, const uint8_t *payload, size_t payloadLen,
+                       int qos, int *msgId);
+
+  /**
+   * @brief Bytes waiting in the MQTT outbox
+   */
+  int getOutboxSize() const;
+
   /**
    * @brief Subscribe to an MQTT topic
    * @param topic Topic to subscribe to
@@ -195,6 +245,12 @@ public:
    */
   void setConnectionCallback(MqttClient::ConnectionCallback callback);
 
+  /**
+   * @brief Set callback for publish acknowledgements
+   * @param callback Function to call when a QoS 1/2 message is acknowledged
+   */
+  void setPublishedCallback(MqttClient::PublishedCallback callback);
+
   /**
    * @brief Reload configuration from ConfigManager
    * @return ESP_OK on success
@@ -209,10 +265,30 @@ private:
    * @param timestamp Unix timestamp (0 = use current time)
    * @param buffer Output buffer
    * @param bufferSize Size of output buffer
-   * @return Number of bytes written (excluding null terminator)
+   * @return Number of bytes written (excluding null terminator), 0 if the
+   *         document does not fit in the buffer
    */
   size_t formatJson(const TelemetryData* data, size_t count, int64_t timestamp, char* buffer, size_t bufferSize);
 
+  /**
+   * @brief Write the deviceId/deviceName fields (those that are set)
+   */
+  void writeDeviceInfo(JsonWriter& json) const;
+
+  /**
+   * @brief Publish, or queue while offline (or behind queued messages)
+   * @param topic Topic, nullptr for the configured publish topic
+   */
+  esp_err_t publishOrQueue(const char* topic, const char* payload, size_t len);
+
+  /**
+   * @brief Housekeeping job: replay one batch of the offline queue
+   * @param ctx MqttManager instance
+   * @return Delay until the next batch, IDLE when the queue is empty
+   */
+  static uint32_t replayJob(void* ctx);
+  uint32_t replayBatch();
+
   /**
    * @brief Get current Unix timestamp
    * @return Unix timestamp in seconds
@@ -224,4 +300,8 @@ private:
   char m_jsonBuffer[1024];       ///< Buffer for JSON formatting
   char m_deviceId[16];           ///< Device ID from NVS
   char m_deviceName[32];         ///< Device name from NVS
+  bool m_offlineQueue;           ///< Store-and-forward enabled
+  int64_t m_replayNotBeforeUs;   ///< No batch before this time after reconnect (-1 = not set)
+  int64_t m_lastReplayUs;        ///< Time of the last batch
+  Housekeeping::JobId m_replayJob; ///< Replay job
 };
@@ -0,0 +1,386 @@
+#include "NetworkManager.h"
+#include "esp_eth.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/netdb.h"
+#include "lwip/sockets.h"
+#include "utils/MemoryPlan.h"
+#include <cerrno>
+#include <cstring>
+
+static const char *TAG = "NetworkManager";
+
+// Link state is checked at least this often (link events wake it earlier)
+static const uint32_t POLL_MS = 500;
+
+// Consecutive probe failures after which a connected link is not chosen
+static const uint32_t MAX_PROBE_FAILURES = 2;
+
+namespace NetworkManager {
+
+struct Link {
+  INetworkInterface *iface;
+  bool wasConnected;
+  int64_t nextProbeUs;
+  uint32_t failures; // Consecutive
+  LinkStats stats;
+};
+
+static Link s_links[MAX_LINKS] = {};
+static size_t s_linkCount = 0;
+static Link *volatile s_active = nullptr;
+static Config s_config;
+static char s_probeHost[64] = {};
+static RouteCallback s_routeCallback = nullptr;
+static TaskHandle_t s_taskHandle = nullptr;
+static bool s_initialized = false;
+
+static uint32_t s_switches = 0;
+static uint32_t s_failovers = 0;
+static int64_t s_lastSwitchUs = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void managerTask(void *arg);
+
+// Link up/down and IP events: re-evaluate now instead of at the next poll
+static void linkEventHandler(void *arg, esp_event_base_t eventBase,
+                             int32_t eventId, void *eventData) {
+  (void)arg;
+  (void)eventBase;
+  (void)eventId;
+  (void)eventData;
+  if (s_taskHandle) {
+    xTaskNotifyGive(s_taskHandle);
+  }
+}
+
+static void addLink(INetworkInterface *iface) {
+  Link &link = s_links[s_linkCount++];
+  link.iface = iface;
+  link.stats.type = iface->getType();
+}
+
+esp_err_t init(INetworkInterface *ethInterface,
+               INetworkInterface *wifiInterface, const Config &config) {
+  if (s_initialized) {
+    ESP_LOGW(TAG, "Already initialized");
+    return ESP_OK;
+  }
+  if (!ethInterface && !wifiInterface) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Ethernet first: it wins while nothing has been measured
+  if (ethInterface)
+    addLink(ethInterface);
+  if (wifiInterface)
+    addLink(wifiInterface);
+
+  s_config = config;
+  if (config.probeHost) {
+    strncpy(s_probeHost, config.probeHost, sizeof(s_probeHost) - 1);
+  }
+  s_config.probeHost = s_probeHost[0] ? s_probeHost : nullptr;
+
+  esp_event_handler_register(ETH_EVENT, ETHERNET_EVENT_DISCONNECTED,
+                             &linkEventHandler, nullptr);
+  esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED,
+                             &linkEventHandler, nullptr);
+  esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, &linkEventHandler,
+                             nullptr);
+
+  if (MemoryPlan::createTask(MemoryPlan::Region::TASK_NET_MANAGER, managerTask,
+                             "net_manager", 3072, nullptr, 5, &s_taskHandle,
+                             tskNO_AFFINITY) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create manager task");
+    return ESP_ERR_NO_MEM;
+  }
+
+  s_initialized = true;
+  ESP_LOGI(TAG, "Managing %u link(s), probing %s:%u every %lu ms",
+           (unsigned)s_linkCount, s_config.probeHost ? s_probeHost : "gateway",
+           s_config.probePort, s_config.probeIntervalMs);
+  return ESP_OK;
+}
+
+void setRouteCallback(RouteCallback callback) { s_routeCallback = callback; }
+
+INetworkInterface *getActive() {
+  Link *active = s_active;
+  return active ? active->iface : nullptr;
+}
+
+INetworkInterface *getLink(Network::Type type) {
+  for (size_t i = 0; i < s_linkCount; i++) {
+    if (s_links[i].stats.type == type)
+      return s_links[i].iface;
+  }
+  return nullptr;
+}
+
+bool isConnected() {
+  Link *active = s_active;
+  return active && active->iface->isConnected();
+}
+
+void recordTransfer(size_t bytes, uint32_t elapsedUs) {
+  Link *active = s_active;
+  if (!active || bytes == 0 || elapsedUs == 0) {
+    return;
+  }
+  uint32_t sample = (uint32_t)((uint64_t)bytes * 1000000 / elapsedUs);
+
+  portENTER_CRITICAL(&s_lock);
+  LinkStats &stats = active->stats;
+  stats.throughputBps = stats.throughputBps == 0
+                            ? sample
+                            : (3 * stats.throughputBps + sample) / 4;
+  stats.bytesSent += bytes;
+  portEXIT_CRITICAL(&s_lock);
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  portENTER_CRITICAL(&s_lock);
+  stats->links = s_linkCount;
+  stats->switches = s_switches;
+  stats->failovers = s_failovers;
+  stats->lastSwitchUs = s_lastSwitchUs;
+  for (size_t i = 0; i < s_linkCount; i++) {
+    stats->link[i] = s_links[i].stats;
+    stats->link[i].active = (&s_links[i] == s_active);
+  }
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+const char *linkName(Network::Type type) {
+  return type == Network::Type::ETHERNET ? "eth" : "wifi";
+}
+
+// Probe address: the configured host, or the link's gateway
+static bool probeTarget(Link &link, sockaddr_in *addr) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family = AF_INET;
+  addr->sin_port = htons(s_config.probePort);
+
+  if (s_config.probeHost) {
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *res = nullptr;
+    if (getaddrinfo(s_config.probeHost, nullptr, &hints, &res) == 0 && res) {
+      addr->sin_addr = ((sockaddr_in *)res->ai_addr)->sin_addr;
+      freeaddrinfo(res);
+      return true;
+    }
+  }
+
+  esp_netif_ip_info_t ipInfo;
+  esp_netif_t *netif = link.iface->getNetif();
+  if (!netif || esp_netif_get_ip_info(netif, &ipInfo) != ESP_OK ||
+      ipInfo.gw.addr == 0) {
+    return false;
+  }
+  addr->sin_addr.s_addr = ipInfo.gw.addr;
+  return true;
+}
+
+// Round trip of a TCP handshake over this link only, 0 if it failed
+static uint32_t probeRtt(Link &link) {
+  sockaddr_in addr;
+  esp_netif_t *netif = link.iface->getNetif();
+  if (!netif || !probeTarget(link, &addr)) {
+    return 0;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+  if (fd < 0) {
+    return 0;
+  }
+
+  uint32_t rttUs = 0;
+  ifreq ifr = {};
+  if (esp_netif_get_netif_impl_name(netif, ifr.ifr_name) == ESP_OK &&
+      setsockopt(fd, SOL_SOCKET, SO_BINDTODEVICE, &ifr, sizeof(ifr)) == 0) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    int64_t startUs = esp_timer_get_time();
+    int ret = connect(fd, (sockaddr *)&addr, sizeof(addr));
+    if (ret == 0 || errno == EINPROGRESS) {
+      fd_set writeSet;
+      FD_ZERO(&writeSet);
+      FD_SET(fd, &writeSet);
+      timeval timeout = {
+          .tv_sec = (time_t)(s_config.probeTimeoutMs / 1000),
+          .tv_usec = (suseconds_t)((s_config.probeTimeoutMs % 1000) * 1000)};
+      if (ret == 0 || select(fd + 1, nullptr, &writeSet, nullptr, &timeout) > 0) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        // A refused connection still took one round trip
+        if (err == 0 || err == ECONNREFUSED) {
+          rttUs = (uint32_t)(esp_timer_get_time() - startUs);
+          if (rttUs == 0)
+            rttUs = 1;
+        }
+      }
+    }
+  }
+  close(fd);
+  return rttUs;
+}
+
+static void probeLink(Link &link) {
+  uint32_t rttUs = probeRtt(link);
+
+  portENTER_CRITICAL(&s_lock);
+  LinkStats &stats = link.stats;
+  stats.probes++;
+  if (rttUs > 0) {
+    stats.rttUs = stats.rttUs == 0 ? rttUs : (7 * stats.rttUs + rttUs) / 8;
+    link.failures = 0;
+  } else {
+    stats.probeFailures++;
+    link.failures++;
+  }
+  portEXIT_CRITICAL(&s_lock);
+}
+
+// Expected time to move REFERENCE_BYTES, 0 if the link was never probed
+static uint64_t linkCost(const Link &link) {
+  if (link.stats.rttUs == 0) {
+    return 0;
+  }
+  uint64_t cost = link.stats.rttUs;
+  if (link.stats.throughputBps > 0) {
+    cost += (uint64_t)REFERENCE_BYTES * 1000000 / link.stats.throughputBps;
+  }
+  return cost;
+}
+
+static bool usable(const Link &link) {
+  return link.stats.connected && link.failures < MAX_PROBE_FAILURES;
+}
+
+static void switchTo(Link *link, bool failover) {
+  Link *previous = s_active;
+  if (link == previous) {
+    return;
+  }
+  if (link) {
+    esp_netif_set_default_netif(link->iface->getNetif());
+  }
+
+  portENTER_CRITICAL(&s_lock);
+  s_active = link;
+  if (previous && link) {
+    s_switches++;
+    if (failover)
+      s_failovers++;
+  }
+  s_lastSwitchUs = esp_timer_get_time();
+  portEXIT_CRITICAL(&s_lock);
+
+  if (link) {
+    ESP_LOGI(TAG, "Uplink %s%s (rtt %lu us, %lu B/s)",
+             linkName(link->stats.type), failover ? " (failover)" : "",
+             link->stats.rttUs, link->stats.throughputBps);
+  } else {
+    ESP_LOGW(TAG, "No uplink available");
+  }
+  if (s_routeCallback) {
+    s_routeCallback(previous ? previous->iface : nullptr,
+                    link ? link->iface : nullptr);
+  }
+}
+
+static void selectLink(int64_t nowUs) {
+  Link *active = s_active;
+
+  // Failover: the active link is gone, take the best remaining one at once
+  if (!active || !active->stats.connected) {
+    Link *best = nullptr;
+    for (size_t i = 0; i < s_linkCount; i++) {
+      Link &link = s_links[i];
+      if (link.stats.connected && (!best || (usable(link) && !usable(*best)))) {
+        best = &link;
+      }
+    }
+    switchTo(best, active != nullptr);
+    return;
+  }
+
+  if (nowUs - s_lastSwitchUs < (int64_t)s_config.minDwellMs * 1000) {
+    return;
+  }
+
+  uint64_t activeCost = linkCost(*active);
+  for (size_t i = 0; i < s_linkCount; i++) {
+    Link &link = s_links[i];
+    if (&link == active || !usable(link)) {
+      continue;
+    }
+    uint64_t cost = linkCost(link);
+    if (cost == 0) {
+      continue;
+    }
+    // An unreachable active link loses to any probed one
+    if (!usable(*active) ||
+        (activeCost > 0 &&
+         cost * 100 < activeCost * (100 - s_config.hysteresisPct))) {
+      switchTo(&link, false);
+      return;
+    }
+  }
+}
+
+static void managerTask(void *arg) {
+  (void)arg;
+
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POLL_MS));
+    int64_t nowUs = esp_timer_get_time();
+
+    for (size_t i = 0; i < s_linkCount; i++) {
+      Link &link = s_links[i];
+      bool connected = link.iface->isConnected();
+      link.stats.connected = connected;
+      if (connected && !link.wasConnected) {
+        link.nextProbeUs = nowUs; // Measure a link as soon as it comes up
+        link.failures = 0;
+      }
+      link.wasConnected = connected;
+    }
+
+    // Route first, so a dead link is left before probes spend time on it
+    selectLink(nowUs);
+
+    bool probed = false;
+    for (size_t i = 0; i < s_linkCount; i++) {
+      Link &link = s_links[i];
+      if (link.stats.connected && nowUs >= link.nextProbeUs) {
+        probeLink(link);
+        link.nextProbeUs = nowUs + (int64_t)s_config.probeIntervalMs * 1000;
+        probed = true;
+      }
+    }
+    if (probed) {
+      selectLink(esp_timer_get_time());
+    }
+  }
+}
+
+} // namespace NetworkManager
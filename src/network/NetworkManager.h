@@ -0,0 +1,123 @@
+#pragma once
+
+#include "INetworkInterface.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief NetworkManager - Keeps Ethernet and WiFi up and routes over the best
+ *
+ * Both links stay connected; the manager picks the active one and makes it
+ * the default route (esp_netif_set_default_netif), so every outgoing
+ * connection (MQTT, forwarders) uses it. Servers keep listening on all
+ * interfaces.
+ *
+ * Each connected link is probed every probeIntervalMs with a TCP connect
+ * bound to that interface (SO_BINDTODEVICE) to the probe host, or to the
+ * link's gateway when the host does not resolve; a refused connection still
+ * measures the round trip. Bulk uplinks report acknowledged transfers with
+ * recordTransfer(), which gives the active link a throughput estimate.
+ * A link costs its smoothed RTT plus the time to move REFERENCE_BYTES at its
+ * measured throughput; the manager moves to a link that is cheaper by more
+ * than hysteresisPct, at most once per minDwellMs.
+ *
+ * Failover does not wait for a probe: link down events wake the manager,
+ * which switches to the remaining link at once and calls the route
+ * callback (main reconnects MQTT there, keeping its persistent session).
+ */
+
+namespace NetworkManager {
+
+/// Links managed (Ethernet, WiFi)
+constexpr size_t MAX_LINKS = 2;
+
+/// Transfer size the link cost is evaluated for (one uplink batch)
+constexpr uint32_t REFERENCE_BYTES = 16 * 1024;
+
+/// Manager configuration
+struct Config {
+    const char* probeHost = nullptr;   ///< Probe target (e.g. MQTT broker), nullptr = gateway
+    uint16_t probePort = 1883;         ///< Probe TCP port
+    uint32_t probeIntervalMs = 10000;  ///< Time between probes of each link
+    uint32_t probeTimeoutMs = 1000;    ///< Probe connect timeout
+    uint8_t hysteresisPct = 25;        ///< Cost advantage needed to switch links
+    uint32_t minDwellMs = 30000;       ///< Minimum time on a link between switches
+};
+
+/// Per-link statistics
+struct LinkStats {
+    Network::Type type;
+    bool connected;
+    bool active;            ///< Carries the default route
+    uint32_t rttUs;         ///< Smoothed probe RTT (0 = not measured yet)
+    uint32_t throughputBps; ///< Smoothed uplink throughput (0 = not measured yet)
+    uint32_t probes;
+    uint32_t probeFailures;
+    uint64_t bytesSent;     ///< Bytes reported by recordTransfer() on this link
+};
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t links;       ///< Entries used in link[]
+    uint32_t switches;    ///< Route changes between links
+    uint32_t failovers;   ///< Switches because the active link went down
+    int64_t lastSwitchUs; ///< esp_timer time of the last switch
+    LinkStats link[MAX_LINKS];
+};
+
+/**
+ * @brief Called from the manager task when the default route changes
+ * @param from Previous link (nullptr on the first selection)
+ * @param to New link (nullptr if no link is connected)
+ */
+typedef void (*RouteCallback)(INetworkInterface* from, INetworkInterface* to);
+
+/**
+ * @brief Start managing the given links
+ * @param ethInterface Ethernet interface (optional)
+ * @param wifiInterface WiFi station interface (optional)
+ * @param config Manager configuration (probeHost is copied)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if no link is given
+ */
+esp_err_t init(INetworkInterface* ethInterface,
+               INetworkInterface* wifiInterface, const Config& config);
+
+/**
+ * @brief Set the route change callback
+ */
+void setRouteCallback(RouteCallback callback);
+
+/**
+ * @brief Link currently carrying the default route (nullptr if none)
+ */
+INetworkInterface* getActive();
+
+/**
+ * @brief Managed link of the given type (nullptr if not managed)
+ */
+INetworkInterface* getLink(Network::Type type);
+
+/**
+ * @brief Check if any managed link is carrying traffic
+ */
+bool isConnected();
+
+/**
+ * @brief Report an acknowledged uplink transfer on the active link
+ * @param bytes Bytes confirmed by the peer
+ * @param elapsedUs Time from sending to confirmation
+ */
+void recordTransfer(size_t bytes, uint32_t elapsedUs);
+
+/**
+ * @brief Get manager statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+/**
+ * @brief Short name of a link type ("eth", "wifi")
+ */
+const char* linkName(Network::Type type);
+
+} // namespace NetworkManager
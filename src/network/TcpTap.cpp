@@ -0,0 +1,263 @@
+#include "TcpTap.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+static const char *TAG = "TcpTap";
+
+// Tap task wakes at least this often to accept and reap clients
+static const uint32_t POLL_MS = 50;
+
+namespace TcpTap {
+
+struct Client {
+  int fd;
+  uint32_t readPos; // Ring position of the next byte to send
+};
+
+static INetworkInterface *s_ethInterface = nullptr;
+static INetworkInterface *s_wifiInterface = nullptr;
+static uint16_t s_port = 0;
+static bool s_initialized = false;
+static volatile bool s_running = false;
+static volatile bool s_stopRequested = false;
+static TaskHandle_t s_taskHandle = nullptr;
+static int s_listenFd = -1;
+
+// Single producer (flash writer), single consumer (tap task). Positions are
+// free-running byte counts; the ring index is position % RING_SIZE.
+static uint8_t *s_ring = nullptr;
+static std::atomic<uint32_t> s_writePos{0};
+static std::atomic<uint32_t> s_clientCount{0};
+
+static Client s_clients[MAX_CLIENTS];
+static Stats s_stats = {};
+
+static void tapTask(void *arg);
+
+esp_err_t init(INetworkInterface *ethInterface,
+               INetworkInterface *wifiInterface, uint16_t port) {
+  if (s_initialized) {
+    ESP_LOGW(TAG, "Already initialized");
+    return ESP_OK;
+  }
+  if (port == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  s_ring = (uint8_t *)malloc(RING_SIZE);
+  if (!s_ring) {
+    ESP_LOGE(TAG, "Failed to allocate tap ring");
+    return ESP_ERR_NO_MEM;
+  }
+  for (Client &client : s_clients) {
+    client.fd = -1;
+  }
+
+  s_ethInterface = ethInterface;
+  s_wifiInterface = wifiInterface;
+  s_port = port;
+  s_initialized = true;
+  ESP_LOGI(TAG, "TCP tap initialized (port: %d)", s_port);
+  return ESP_OK;
+}
+
+esp_err_t start() {
+  if (!s_initialized)
+    return ESP_ERR_INVALID_STATE;
+  if (s_running)
+    return ESP_OK;
+
+  int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+  if (fd < 0) {
+    ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+    return ESP_FAIL;
+  }
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(s_port);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(fd, MAX_CLIENTS) != 0) {
+    ESP_LOGE(TAG, "Failed to listen on port %d: errno %d", s_port, errno);
+    close(fd);
+    return ESP_FAIL;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  s_listenFd = fd;
+
+  s_stopRequested = false;
+  BaseType_t ret = xTaskCreate(tapTask, "tcp_tap", 3072, nullptr,
+                               tskIDLE_PRIORITY + 4, &s_taskHandle);
+  if (ret != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create tap task");
+    close(s_listenFd);
+    s_listenFd = -1;
+    return ESP_ERR_NO_MEM;
+  }
+
+  s_running = true;
+  ESP_LOGI(TAG, "Listening on port %d", s_port);
+  return ESP_OK;
+}
+
+esp_err_t stop() {
+  if (!s_running)
+    return ESP_OK;
+
+  s_stopRequested = true;
+  xTaskNotifyGive(s_taskHandle);
+  while (s_taskHandle) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  s_running = false;
+  return ESP_OK;
+}
+
+bool isRunning() { return s_running; }
+
+void feed(const uint8_t *data, size_t len) {
+  if (s_clientCount.load(std::memory_order_relaxed) == 0 || len == 0) {
+    return;
+  }
+
+  uint32_t pos = s_writePos.load(std::memory_order_relaxed);
+  s_stats.bytesFed += len;
+  while (len > 0) {
+    size_t offset = pos % RING_SIZE;
+    size_t n = std::min(len, RING_SIZE - offset);
+    memcpy(s_ring + offset, data, n);
+    pos += n;
+    data += n;
+    len -= n;
+  }
+  s_writePos.store(pos, std::memory_order_release);
+
+  TaskHandle_t task = s_taskHandle;
+  if (task) {
+    xTaskNotifyGive(task);
+  }
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  s_stats.clients = s_clientCount.load(std::memory_order_relaxed);
+  *stats = s_stats;
+  return ESP_OK;
+}
+
+static void closeClient(Client &client) {
+  close(client.fd);
+  client.fd = -1;
+  s_clientCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void acceptClients() {
+  while (true) {
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    int fd = accept(s_listenFd, (struct sockaddr *)&addr, &addrLen);
+    if (fd < 0) {
+      return; // EAGAIN: nothing pending
+    }
+
+    Client *slot = nullptr;
+    for (Client &client : s_clients) {
+      if (client.fd < 0) {
+        slot = &client;
+        break;
+      }
+    }
+    if (!slot) {
+      ESP_LOGW(TAG, "Client limit reached, rejecting connection");
+      close(fd);
+      continue;
+    }
+
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    // Live tap: start at the current write position
+    slot->fd = fd;
+    slot->readPos = s_writePos.load(std::memory_order_acquire);
+    s_clientCount.fetch_add(1, std::memory_order_relaxed);
+    s_stats.accepted++;
+
+    char ip[16];
+    inet_ntoa_r(addr.sin_addr, ip, sizeof(ip));
+    ESP_LOGI(TAG, "Client %s connected", ip);
+  }
+}
+
+// Send pending bytes to one client, returns false if it must be closed
+static bool serviceClient(Client &client) {
+  // Input is ignored; recv() also reports an orderly close
+  uint8_t discard[32];
+  int r = recv(client.fd, discard, sizeof(discard), MSG_DONTWAIT);
+  if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    return false;
+  }
+
+  uint32_t writePos = s_writePos.load(std::memory_order_acquire);
+  while (true) {
+    uint32_t backlog = writePos - client.readPos;
+    if (backlog > SEND_WINDOW) {
+      ESP_LOGW(TAG, "Client too slow (%lu bytes behind), dropping", backlog);
+      s_stats.droppedSlow++;
+      return false;
+    }
+    if (backlog == 0) {
+      return true;
+    }
+
+    size_t offset = client.readPos % RING_SIZE;
+    size_t n = std::min<size_t>(backlog, RING_SIZE - offset);
+    int sent = send(client.fd, s_ring + offset, n, MSG_DONTWAIT);
+    if (sent < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    client.readPos += sent;
+    s_stats.bytesSent += sent;
+    if ((size_t)sent < n) {
+      return true; // Socket buffer full, retry on the next wake-up
+    }
+  }
+}
+
+static void tapTask(void *arg) {
+  while (!s_stopRequested) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POLL_MS));
+    acceptClients();
+
+    for (Client &client : s_clients) {
+      if (client.fd >= 0 && !serviceClient(client)) {
+        ESP_LOGI(TAG, "Client disconnected");
+        closeClient(client);
+      }
+    }
+  }
+
+  for (Client &client : s_clients) {
+    if (client.fd >= 0) {
+      closeClient(client);
+    }
+  }
+  close(s_listenFd);
+  s_listenFd = -1;
+  s_taskHandle = nullptr;
+  vTaskDelete(nullptr);
+}
+
+} // namespace TcpTap
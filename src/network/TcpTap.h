@@ -0,0 +1,83 @@
+#pragma once
+
+#include "INetworkInterface.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief TcpTap - Live capture stream over raw TCP
+ *
+ * Clients connecting to the tap port receive the captured bytes as they
+ * pass through DataPipeline, with no framing (e.g. `nc <ip> <port>`).
+ * Only data captured after the client connected is sent.
+ *
+ * The writer side (feed()) only copies into a shared tap ring and never
+ * blocks. The tap task sends from that ring to each client with
+ * non-blocking sockets; a client that falls more than SEND_WINDOW bytes
+ * behind is disconnected, so a slow client cannot stall the flash writer.
+ *
+ * Listens on all interfaces, so it works over W5500 and WiFi alike.
+ */
+
+namespace TcpTap {
+
+/// Maximum simultaneous clients
+constexpr size_t MAX_CLIENTS = 4;
+
+/// Shared ring holding the most recent captured bytes
+constexpr size_t RING_SIZE = 16 * 1024;
+
+/// Maximum backlog per client before it is dropped
+constexpr size_t SEND_WINDOW = RING_SIZE / 2;
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t clients;        ///< Connected clients
+    uint32_t accepted;       ///< Connections accepted since boot
+    uint32_t droppedSlow;    ///< Clients disconnected for exceeding SEND_WINDOW
+    uint64_t bytesFed;       ///< Bytes fed while at least one client was connected
+    uint64_t bytesSent;      ///< Bytes sent, summed over clients
+};
+
+/**
+ * @brief Initialize the tap
+ * @param ethInterface Ethernet network interface (optional)
+ * @param wifiInterface WiFi network interface (optional)
+ * @param port TCP port to listen on
+ * @return ESP_OK on success
+ */
+esp_err_t init(INetworkInterface *ethInterface,
+               INetworkInterface *wifiInterface, uint16_t port);
+
+/**
+ * @brief Start listening (once the network is up)
+ * @return ESP_OK on success
+ */
+esp_err_t start();
+
+/**
+ * @brief Close all clients and the listening socket
+ * @return ESP_OK on success
+ */
+esp_err_t stop();
+
+/**
+ * @brief Check if the tap is listening
+ */
+bool isRunning();
+
+/**
+ * @brief Hand captured bytes to the tap (DataPipeline::TapCallback)
+ *
+ * Called from the flash writer task. Returns immediately when no client
+ * is connected.
+ */
+void feed(const uint8_t *data, size_t len);
+
+/**
+ * @brief Get tap statistics
+ */
+esp_err_t getStats(Stats *stats);
+
+} // namespace TcpTap
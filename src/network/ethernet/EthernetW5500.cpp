@@ -7,6 +7,8 @@
 #include "esp_mac.h"
 #include "esp_netif.h"
 #include "lwip/inet.h"
+#include "soc/spi_pins.h"
+#include <algorithm>
 #include <cstring>
 
 // W5500 driver headers (available when CONFIG_ETH_SPI_ETHERNET_W5500 is
@@ -19,6 +21,33 @@
 
 static const char *TAG = "EthernetW5500";
 
+// Highest SCLK the W5500 datasheet guarantees (33.3MHz)
+static const int W5500_MAX_CLOCK_HZ = 33333333;
+
+// Whether the bus pins are the host's IOMUX pins (otherwise signals go
+// through the GPIO matrix, which lowers the full-duplex read limit)
+static bool usesIomuxPins(int host, int mosi, int miso, int sclk) {
+  if (host == SPI2_HOST) {
+    return mosi == SPI2_IOMUX_PIN_NUM_MOSI && miso == SPI2_IOMUX_PIN_NUM_MISO &&
+           sclk == SPI2_IOMUX_PIN_NUM_CLK;
+  }
+#ifdef SPI3_IOMUX_PIN_NUM_MOSI
+  if (host == SPI3_HOST) {
+    return mosi == SPI3_IOMUX_PIN_NUM_MOSI && miso == SPI3_IOMUX_PIN_NUM_MISO &&
+           sclk == SPI3_IOMUX_PIN_NUM_CLK;
+  }
+#endif
+  return false;
+}
+
+#if CONFIG_W5500_RX_FRAME_POOL
+// netif release hook: received frames belong to the W5500 driver's frame pool
+static void freeRxFrame(void *handle, void *buffer) {
+  (void)handle;
+  esp_eth_mac_w5500_free_rx_buf(buffer);
+}
+#endif
+
 esp_err_t EthernetW5500::init(const void *config) {
   if (m_initialized) {
     ESP_LOGW(TAG, "Already initialized");
@@ -122,6 +151,7 @@ esp_err_t EthernetW5500::deinit() {
   if (m_ethHandle) {
     esp_eth_driver_uninstall(m_ethHandle);
     m_ethHandle = nullptr;
+    m_mac = nullptr;
   }
 
   // Unregister event handlers
@@ -177,12 +207,29 @@ esp_err_t EthernetW5500::getStats(Network::Stats *stats) {
     return ESP_ERR_INVALID_STATE;
   }
 
-  // TODO: Get statistics from netif when available
-  // For now, return zero stats
+  // Byte and TX counters are not available from the driver; receive counts
+  // come from the W5500 frame pool
   memset(stats, 0, sizeof(Network::Stats));
+#if CONFIG_W5500_RX_FRAME_POOL
+  eth_w5500_rx_pool_stats_t pool;
+  if (esp_eth_mac_w5500_get_rx_pool_stats(m_mac, &pool) == ESP_OK) {
+    stats->packetsReceived = pool.frames_received;
+    stats->errors = pool.dropped_no_buf + pool.dropped_overload;
+  }
+#endif
   return ESP_OK;
 }
 
+esp_err_t EthernetW5500::getRxPoolStats(eth_w5500_rx_pool_stats_t *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!m_mac) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  return esp_eth_mac_w5500_get_rx_pool_stats(m_mac, stats);
+}
+
 void EthernetW5500::ethEventHandler(void *arg, esp_event_base_t eventBase,
                                     int32_t eventId, void *eventData) {
   EthernetW5500 *self = static_cast<EthernetW5500 *>(arg);
@@ -276,7 +323,15 @@ esp_err_t EthernetW5500::initW5500() {
   // SPI device configuration for W5500
   spi_device_interface_config_t spiDevCfg = {};
   spiDevCfg.mode = 0;
-  spiDevCfg.clock_speed_hz = m_config.clockSpeedHz;
+  // Run at the configured clock (the W5500 maximum by default), capped to
+  // what the chip and the pin routing can read back reliably
+  bool iomux = usesIomuxPins(m_config.spiHost, m_config.mosiPin,
+                             m_config.misoPin, m_config.sclkPin);
+  int clockHz = std::min({m_config.clockSpeedHz, W5500_MAX_CLOCK_HZ,
+                          spi_get_freq_limit(!iomux, 0)});
+  ESP_LOGI(TAG, "SPI clock %d kHz (%s pins)", clockHz / 1000,
+           iomux ? "IOMUX" : "GPIO matrix");
+  spiDevCfg.clock_speed_hz = clockHz;
   spiDevCfg.spics_io_num = m_config.csPin;
   spiDevCfg.queue_size = 20;
 
@@ -341,6 +396,17 @@ esp_err_t EthernetW5500::initW5500() {
     return ESP_ERR_NO_MEM;
   }
   esp_netif_attach(m_netif, glue);
+#if CONFIG_W5500_RX_FRAME_POOL
+  // Frames come from the driver's pool, so lwIP must hand them back there
+  // instead of calling free()
+  esp_netif_driver_ifconfig_t driverConfig = {};
+  driverConfig.handle = m_ethHandle;
+  driverConfig.transmit = esp_eth_transmit;
+  driverConfig.transmit_wrap = esp_eth_transmit_vargs;
+  driverConfig.driver_free_rx_buffer = freeRxFrame;
+  esp_netif_set_driver_config(m_netif, &driverConfig);
+#endif
+  m_mac = mac;
 
   // Configure IP
   ret = configureIp();
@@ -348,6 +414,7 @@ esp_err_t EthernetW5500::initW5500() {
     ESP_LOGE(TAG, "Failed to configure IP");
     esp_eth_driver_uninstall(m_ethHandle);
     m_ethHandle = nullptr;
+    m_mac = nullptr;
     phy->del(phy);
     mac->del(mac);
     return ret;
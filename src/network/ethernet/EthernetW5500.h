@@ -3,6 +3,7 @@
 #include "../INetworkInterface.h"
 #include "driver/spi_master.h"
 #include "esp_eth.h"
+#include "esp_eth_mac_w5500.h"
 #include "esp_netif.h"
 #include <cstdint>
 
@@ -25,7 +26,7 @@ public:
         int csPin = 21;                    ///< Chip Select GPIO pin
         int resetPin = 22;                 ///< Reset GPIO pin (-1 to disable)
         int interruptPin = 25;             ///< Interrupt GPIO pin
-        int clockSpeedHz = 20 * 1000 * 1000; ///< SPI clock speed (20MHz default)
+        int clockSpeedHz = 33 * 1000 * 1000; ///< SPI clock speed (W5500 rated maximum, capped to what the pins allow)
         
         // IP configuration
         Network::IpMode ipMode = Network::IpMode::DHCP;
@@ -46,10 +47,17 @@ public:
     esp_err_t getIpAddress(Network::IpAddress* ip) override;
     esp_err_t getStats(Network::Stats* stats) override;
 
+    /**
+     * @brief Get the W5500 receive frame pool statistics
+     * @return ESP_ERR_NOT_SUPPORTED if the pool is disabled in menuconfig
+     */
+    esp_err_t getRxPoolStats(eth_w5500_rx_pool_stats_t* stats);
+
 private:
     Config m_config;
     esp_netif_t* m_netif = nullptr;
     esp_eth_handle_t m_ethHandle = nullptr;
+    esp_eth_mac_t* m_mac = nullptr;    ///< W5500 MAC, for the receive pool stats
     Network::Status m_status = Network::Status::DISCONNECTED;
     bool m_initialized = false;
 
@@ -9,6 +9,29 @@
 
 static const char *TAG = "WifiInterface";
 
+// THROUGHPUT profile buffers: ~26KB more internal RAM for the static RX
+// buffers, the rest is allocated on demand. The RX block ack window must not
+// exceed the dynamic RX buffers nor twice the static ones.
+static const int THROUGHPUT_STATIC_RX_BUF = 16;
+static const int THROUGHPUT_DYNAMIC_RX_BUF = 64;
+static const int THROUGHPUT_DYNAMIC_TX_BUF = 64;
+static const int THROUGHPUT_BA_WIN = 32;
+
+// POWER_SAVE profile: beacon intervals between wakeups, TX power (0.25 dBm)
+static const uint16_t POWER_SAVE_LISTEN_INTERVAL = 3;
+static const int8_t POWER_SAVE_TX_POWER = 60; // 15 dBm
+
+const char *WifiInterface::profileName(Profile profile) {
+  switch (profile) {
+  case Profile::POWER_SAVE:
+    return "power_save";
+  case Profile::THROUGHPUT:
+    return "throughput";
+  default:
+    return "standard";
+  }
+}
+
 esp_err_t WifiInterface::init(const void *config) {
   if (m_initialized) {
     ESP_LOGW(TAG, "Already initialized");
@@ -28,10 +51,18 @@ esp_err_t WifiInterface::init(const void *config) {
   ESP_ERROR_CHECK(esp_event_handler_instance_register(
       IP_EVENT, IP_EVENT_STA_GOT_IP, &wifiEventHandler, this, nullptr));
 
+  // The AP (safe mode) always runs with the standard profile
+  if (m_config.apMode)
+    m_config.profile = Profile::STANDARD;
+
   wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+  applyProfileBuffers(&cfg);
   ESP_ERROR_CHECK(esp_wifi_init(&cfg));
   ESP_ERROR_CHECK(esp_wifi_set_storage(WIFI_STORAGE_RAM));
-  ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_NONE));
+  ESP_ERROR_CHECK(esp_wifi_set_ps(m_config.profile == Profile::POWER_SAVE
+                                      ? WIFI_PS_MAX_MODEM
+                                      : WIFI_PS_NONE));
+  ESP_LOGI(TAG, "WiFi profile: %s", profileName(m_config.profile));
 
   m_initialized = true;
   return ESP_OK;
@@ -67,6 +98,10 @@ esp_err_t WifiInterface::start() {
             sizeof(wifi_config.sta.ssid) - 1);
     strncpy((char *)wifi_config.sta.password, m_config.password,
             sizeof(wifi_config.sta.password) - 1);
+    // Known AP channel: connect without scanning the whole band
+    wifi_config.sta.channel = m_config.fixedChannel;
+    if (m_config.profile == Profile::POWER_SAVE)
+      wifi_config.sta.listen_interval = POWER_SAVE_LISTEN_INTERVAL;
     ESP_LOGI(TAG, "Connecting to SSID: '%s'", m_config.ssid);
   }
 
@@ -104,7 +139,12 @@ esp_err_t WifiInterface::start() {
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_AP, &wifi_config));
   }
 
+  if (mode == WIFI_MODE_STA)
+    applyProfileLink(false);
+
   ESP_ERROR_CHECK(esp_wifi_start());
+  if (mode == WIFI_MODE_STA)
+    applyProfileLink(true);
 
   // Hostname setup
   if (m_netif) {
@@ -153,6 +193,28 @@ esp_err_t WifiInterface::getIpAddress(Network::IpAddress *ip) {
   return ESP_FAIL;
 }
 
+esp_err_t WifiInterface::getLinkInfo(LinkInfo *info) {
+  if (!info)
+    return ESP_ERR_INVALID_ARG;
+  if (!m_initialized)
+    return ESP_ERR_INVALID_STATE;
+
+  memset(info, 0, sizeof(*info));
+  info->profile = m_config.profile;
+  wifi_ps_type_t ps = WIFI_PS_NONE;
+  esp_wifi_get_ps(&ps);
+  info->powerSave = ps != WIFI_PS_NONE;
+
+  wifi_ap_record_t ap;
+  if (m_status == Network::Status::CONNECTED &&
+      esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+    info->rssi = ap.rssi;
+    info->channel = ap.primary;
+    info->ht40 = ap.second != WIFI_SECOND_CHAN_NONE;
+  }
+  return ESP_OK;
+}
+
 esp_err_t WifiInterface::getStats(Network::Stats *stats) {
   // Basic stats placeholder
   if (stats)
@@ -186,7 +248,42 @@ void WifiInterface::onWifiEvent(esp_event_base_t eventBase, int32_t eventId,
     ip_event_got_ip_t *event = (ip_event_got_ip_t *)eventData;
     ESP_LOGI(TAG, "Got IP:" IPSTR, IP2STR(&event->ip_info.ip));
     m_status = Network::Status::CONNECTED;
+    LinkInfo info;
+    if (getLinkInfo(&info) == ESP_OK) {
+      ESP_LOGI(TAG, "Link: channel %u%s, RSSI %d dBm, profile %s",
+               info.channel, info.ht40 ? " HT40" : "", info.rssi,
+               profileName(info.profile));
+    }
+  }
+}
+
+// Buffer counts and block ack windows are fixed at esp_wifi_init()
+void WifiInterface::applyProfileBuffers(wifi_init_config_t *cfg) const {
+  if (m_config.profile != Profile::THROUGHPUT)
+    return;
+  cfg->static_rx_buf_num = THROUGHPUT_STATIC_RX_BUF;
+  cfg->dynamic_rx_buf_num = THROUGHPUT_DYNAMIC_RX_BUF;
+  cfg->tx_buf_type = 1; // Dynamic TX buffers
+  cfg->dynamic_tx_buf_num = THROUGHPUT_DYNAMIC_TX_BUF;
+  cfg->ampdu_rx_enable = 1;
+  cfg->ampdu_tx_enable = 1;
+  cfg->rx_ba_win = THROUGHPUT_BA_WIN;
+}
+
+// Bandwidth before the station connects, TX power once WiFi is started
+void WifiInterface::applyProfileLink(bool started) {
+  esp_err_t err = ESP_OK;
+  if (m_config.profile == Profile::THROUGHPUT && !started) {
+    // 40 MHz when the AP offers it, 20 MHz otherwise
+    esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G |
+                                           WIFI_PROTOCOL_11N);
+    err = esp_wifi_set_bandwidth(WIFI_IF_STA, WIFI_BW_HT40);
+  } else if (m_config.profile == Profile::POWER_SAVE && started) {
+    err = esp_wifi_set_max_tx_power(POWER_SAVE_TX_POWER);
   }
+  if (err != ESP_OK)
+    ESP_LOGW(TAG, "Profile %s not fully applied: %s",
+             profileName(m_config.profile), esp_err_to_name(err));
 }
 
 // Unused helpers
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../INetworkInterface.h"
+#include "esp_wifi.h"
 #include <cstdint>
 
 /**
@@ -21,12 +22,30 @@ public:
     APSTA ///< Both modes simultaneously
   };
 
+  /// Station tuning, same values as ConfigManager::WifiProfile
+  enum class Profile : uint8_t {
+    STANDARD = 0,   ///< No power save, default buffers (previous behaviour)
+    POWER_SAVE = 1, ///< Max modem sleep, reduced TX power
+    THROUGHPUT = 2  ///< No power save, large RX/TX buffers and BA windows, HT40
+  };
+
+  /// Link details for reporting
+  struct LinkInfo {
+    Profile profile;
+    int8_t rssi;        ///< dBm, 0 when not associated
+    uint8_t channel;    ///< Primary channel, 0 when not associated
+    bool ht40;          ///< Negotiated 40 MHz bandwidth
+    bool powerSave;     ///< Modem sleep enabled
+  };
+
   /// Configuration structure - Compatible with ConfigManager::WifiConfig
   struct Config {
     bool enabled = false;    ///< WiFi enabled flag
     char ssid[32] = {0};     ///< Station SSID (array, not pointer)
     char password[64] = {0}; ///< Station password (array, not pointer)
     bool apMode = false;     ///< true = AP mode, false = STA mode
+    Profile profile = Profile::STANDARD; ///< Station tuning (STA mode only)
+    uint8_t fixedChannel = 0; ///< AP channel hint, 0 = scan all channels
 
     // IP configuration
     Network::IpMode ipMode = Network::IpMode::DHCP;
@@ -52,6 +71,17 @@ public:
   esp_err_t getIpAddress(Network::IpAddress *ip) override;
   esp_err_t getStats(Network::Stats *stats) override;
 
+  /**
+   * @brief Get the active profile and association details
+   * @return ESP_ERR_INVALID_STATE if not initialized
+   */
+  esp_err_t getLinkInfo(LinkInfo *info);
+
+  /**
+   * @brief Profile name for logs and reports
+   */
+  static const char *profileName(Profile profile);
+
 private:
   Config m_config;
   esp_netif_t *m_netif = nullptr;
@@ -65,6 +95,8 @@ private:
                    void *eventData);
 
   // Helper functions
+  void applyProfileBuffers(wifi_init_config_t *cfg) const;
+  void applyProfileLink(bool started);
   esp_err_t initWifi();
   esp_err_t configureIp();
 };
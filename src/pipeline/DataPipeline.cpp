@@ -1,9 +1,21 @@
 #include "DataPipeline.h"
 #include "../storage/FlashRing.h"
+#include "../storage/FlashRingBackend.h"
+#include "../storage/RecordStore.h"
+#include "IPipelineStage.h"
 #include "../transport/IDataSource.h"
+#include "../transport/SlotPool.h"
+#include "../transport/StagingRing.h"
+#include "../utils/DeferredLog.h"
 #include "../utils/LedManager.h"
+#include "../utils/Lz4.h"
+#include "../utils/MemoryPlan.h"
+#include "../utils/PerfCounters.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/queue.h"
 #include "freertos/semphr.h"
+#include <algorithm>
 #include <cstring>
 
 static const char *TAG = "DataPipeline";
@@ -12,18 +24,171 @@ namespace DataPipeline {
 
 // Module state
 static Config s_config;
-static IDataSource *s_dataSource = nullptr;
+static FlashRingBackend s_flashRingBackend;
+static IStorageBackend *s_storage = &s_flashRingBackend; // Hot tier
 static TaskHandle_t s_taskHandle = nullptr;
 static SemaphoreHandle_t s_flushSem = nullptr;
 static volatile bool s_running = false;
 static volatile bool s_stopRequested = false;
 static bool s_initialized = false;
+static volatile bool s_storageReady = false; // Flash may be written (staged boot)
+static bool s_firstByteLogged = false;
 
-// Statistics
+// Page buffers cycling between the writer and the FlashRing write engine
+// (ring buffer mode). While one page is being programmed the next is filled.
+static QueueHandle_t s_freeBufQueue = nullptr;
+static uint8_t *s_bufStorage = nullptr;
+static uint8_t *s_pageBuf = nullptr; // Page buffer being filled
+static size_t s_pageFill = 0;
+static SlotPool *s_slotPool = nullptr;
+
+// Record framing: burst lengths reported by each transport split its byte
+// stream into records. A burst's length is queued before any byte of the
+// next burst reaches the ring buffer, so peeking after a receive is enough
+// to find the boundary.
+static constexpr size_t BURST_QUEUE_DEPTH = 16;
+static constexpr size_t FRAME_BUFFERS = 8;
+static constexpr size_t FRAME_BUFFER_SIZE = 32;
+static QueueHandle_t s_freeFrameQueue = nullptr; // Header/footer buffers (slot mode)
+static uint8_t s_frameStorage[FRAME_BUFFERS][FRAME_BUFFER_SIZE];
+
+// Capture times: transports report (stream offset, esp_timer time) marks
+// before handing a chunk over, so the marks for a chunk are queued by the
+// time its bytes are processed. Marks inside a record form its time table;
+// the first one also stamps the header.
+struct ChunkMark {
+  uint32_t streamOffset;
+  int64_t timestampUs;
+};
+static constexpr size_t MARK_QUEUE_DEPTH = 32;
+
+// A filter stage of a channel and its figures
+struct Stage {
+  IPipelineStage *stage;
+  uint64_t bytesIn;
+  uint64_t bytesOut;
+};
+
+// One registered transport; its index is the channel
+struct Source {
+  IDataSource *dataSource;
+  StagingRing *ring;
+  QueueHandle_t burstQueue;
+  QueueHandle_t markQueue;
+  uint32_t streamBytes; // Bytes received from the transport
+  size_t burstBytes;    // Bytes of the current burst already written
+  const uint8_t *item;  // Peeked ring region waiting to be merged
+  size_t itemSize;
+  int64_t itemTimeUs;   // Capture (or arrival) time of the item
+  bool itemTimed;       // itemTimeUs came from a capture time mark
+  Stage stages[MAX_STAGES];
+  volatile size_t stageCount;
+  // Last span through the stages: stream bytes [spanIn, +spanInLen) became
+  // record payload [spanOut, +spanOutLen), to place its time marks
+  uint32_t spanIn;
+  size_t spanInLen;
+  size_t spanOut;
+  size_t spanOutLen;
+};
+static Source s_sources[MAX_SOURCES] = {};
+static volatile size_t s_sourceCount = 0;
+
+// Payload compression (ring buffer mode): bytes collect in a raw block,
+// which is compressed into the output buffer behind its BlockHeader
+static bool s_compressing = false;
+static uint8_t *s_blockRaw = nullptr;
+static size_t s_blockFill = 0;
+static uint8_t *s_blockOut = nullptr;
+static void *s_lzWork = nullptr;
+// All three in one MemoryPlan region: hash table first (16-bit aligned)
+static constexpr size_t LZ4_BUFFER_SIZE =
+    Lz4::WORK_SIZE + RecordStore::BLOCK_RAW_SIZE +
+    sizeof(RecordStore::BlockHeader) +
+    Lz4::compressBound(RecordStore::BLOCK_RAW_SIZE);
+static_assert(LZ4_BUFFER_SIZE <=
+                  MemoryPlan::budget(MemoryPlan::Region::PIPELINE_LZ4),
+              "LZ4 buffers exceed their memory plan budget");
+
+// Stage chains (ring buffer mode): a span goes back and forth between two
+// buffers, each stage may add the bytes it held back to its input
+static constexpr size_t STAGE_BUFFER_SIZE =
+    FlashRing::PAGE_SIZE + MAX_STAGES * IPipelineStage::MAX_HELD;
+static_assert(2 * STAGE_BUFFER_SIZE <=
+                  MemoryPlan::budget(MemoryPlan::Region::PIPELINE_STAGES),
+              "Stage buffers exceed their memory plan budget");
+static uint8_t *s_stageBuf[2] = {};
+
+// Open record
+static Source *s_recordSource = nullptr;
+static uint32_t s_recordStart = 0;  // Stream offset of the open record
+static size_t s_recordPayload = 0;  // Payload bytes written to it (decoded)
+static int64_t s_recordTimeUs = 0;  // Capture time of its first chunk, 0 if untimed
+static RecordStore::TimeMark s_timeMarks[RecordStore::MAX_TIME_MARKS];
+static size_t s_timeMarkCount = 0;
+static uint32_t s_timeMarkStride = 1;
+static uint32_t s_timeMarksSeen = 0;
+static uint8_t s_tableBuf[RecordStore::MAX_TIME_MARKS * sizeof(RecordStore::TimeMark) +
+                          sizeof(RecordStore::TimeTableTrailer)];
+static SemaphoreHandle_t s_tableFree = nullptr; // Slot mode: s_tableBuf not queued
+static constexpr uint32_t TABLE_WAIT_MS = 1000;
+
+// Adaptive flush policy (ring buffer mode): the rate and the average gap
+// between ring buffer items are smoothed over RATE_WINDOW_US windows
+static constexpr int64_t RATE_WINDOW_US = 250 * 1000;
+static constexpr uint32_t IDLE_GAPS = 4;       // Idle window, in average item gaps
+static constexpr size_t BACKLOG_FILL_PCT = 50; // Ring fill that defers partial flushes
+static uint32_t s_rateBps = 0;
+static int64_t s_gapUs = 0;
+static int64_t s_lastDataUs = 0;
+static int64_t s_rateWindowUs = 0;
+static size_t s_rateWindowBytes = 0;
+static int64_t s_pendingSinceUs = 0; // Partial page/block started, 0 if none
+static int64_t s_dirtySinceUs = 0;   // Oldest change not yet flushed, 0 if clean
+static volatile bool s_burstFlushPending = false;
+
+// Live observer of the captured bytes (e.g. TcpTap)
+static volatile TapCallback s_tapCallback = nullptr;
+
+// Observer of the capture chunks (e.g. FrameDecoders)
+static volatile ChunkTapCallback s_chunkTapCallback = nullptr;
+
+// Statistics, updated from the writer, the write engine and the capture
+// tasks. Multi-word counters change under s_statsLock so that getStats()
+// copies a consistent struct.
 static Stats s_stats = {};
+static portMUX_TYPE s_statsLock = portMUX_INITIALIZER_UNLOCKED;
 
 // Task function
+static void deleteSyncObjects();
+static esp_err_t attachSource(Source &src, IDataSource *dataSource,
+                              size_t channel);
+static void detachSource(Source &src);
 static void writerTask(void *arg);
+static void ringWriterLoop();
+static void slotWriterLoop(SlotPool *pool);
+static void emitStream(Source &src, const uint8_t *data, size_t len,
+                       bool frameEnd);
+
+// Per-channel transport callbacks
+static void queueBurst(Source &src, size_t bytesInBurst);
+static void queueMark(Source &src, uint32_t streamOffset, int64_t timestampUs);
+
+template <size_t Channel>
+static void onSourceBurst(bool burstEnded, size_t bytesInBurst) {
+  if (burstEnded) {
+    queueBurst(s_sources[Channel], bytesInBurst);
+  }
+}
+
+template <size_t Channel>
+static void onSourceChunk(uint32_t streamOffset, int64_t timestampUs) {
+  queueMark(s_sources[Channel], streamOffset, timestampUs);
+}
+
+static const Transport::BurstCallback s_burstCallbacks[MAX_SOURCES] = {
+    onSourceBurst<0>, onSourceBurst<1>, onSourceBurst<2>};
+static const Transport::ChunkCallback s_chunkCallbacks[MAX_SOURCES] = {
+    onSourceChunk<0>, onSourceChunk<1>, onSourceChunk<2>};
 
 esp_err_t init(const Config &config, IDataSource *dataSource) {
   if (!dataSource) {
@@ -34,22 +199,44 @@ esp_err_t init(const Config &config, IDataSource *dataSource) {
     ESP_LOGW(TAG, "Already initialized");
     return ESP_OK;
   }
+  // RecordStore seals and reads records on FlashRing itself; appending the
+  // payload anywhere else would split the framing from the data
+  if (config.storage &&
+      config.storage->getType() != Storage::Type::FLASH_RING) {
+    ESP_LOGE(TAG, "Hot tier must be FlashRing (use StorageTier for bulk media)");
+    return ESP_ERR_NOT_SUPPORTED;
+  }
 
   s_config = config;
-  s_dataSource = dataSource;
+  s_storage = config.storage ? config.storage : &s_flashRingBackend;
   memset(&s_stats, 0, sizeof(s_stats));
   s_stopRequested = false;
+  s_firstByteLogged = false;
+  if (!config.waitForStorage) {
+    s_storageReady = true;
+  }
 
-  // Create flush semaphore
+  // Create flush semaphore and framing queues
   s_flushSem = xSemaphoreCreateBinary();
-  if (!s_flushSem) {
+  s_tableFree = xSemaphoreCreateBinary();
+  s_freeFrameQueue = xQueueCreate(FRAME_BUFFERS, sizeof(uint8_t *));
+  if (!s_flushSem || !s_tableFree || !s_freeFrameQueue ||
+      attachSource(s_sources[0], dataSource, 0) != ESP_OK) {
     ESP_LOGE(TAG, "Failed to create semaphore");
+    deleteSyncObjects();
     return ESP_ERR_NO_MEM;
   }
+  for (size_t i = 0; i < FRAME_BUFFERS; i++) {
+    uint8_t *frame = s_frameStorage[i];
+    xQueueSend(s_freeFrameQueue, &frame, 0);
+  }
+  xSemaphoreGive(s_tableFree);
+  s_recordSource = nullptr;
+  s_sourceCount = 1;
 
   // Create writer task pinned to Core 1
-  BaseType_t taskRet = xTaskCreatePinnedToCore(
-      writerTask, "flash_writer",
+  BaseType_t taskRet = MemoryPlan::createTask(
+      MemoryPlan::Region::TASK_FLASH_WRITER, writerTask, "flash_writer",
       4096, // Stack size
       nullptr,
       configMAX_PRIORITIES - 2, // High priority but below UART
@@ -58,8 +245,7 @@ esp_err_t init(const Config &config, IDataSource *dataSource) {
   );
   if (taskRet != pdPASS) {
     ESP_LOGE(TAG, "Failed to create writer task");
-    vSemaphoreDelete(s_flushSem);
-    s_flushSem = nullptr;
+    deleteSyncObjects();
     return ESP_ERR_NO_MEM;
   }
 
@@ -69,12 +255,83 @@ esp_err_t init(const Config &config, IDataSource *dataSource) {
     s_running = true;
   }
 
-  ESP_LOGI(TAG, "Initialized: chunkSize=%u, flushTimeout=%lu ms",
-           config.writeChunkSize, config.flushTimeoutMs);
+  if (config.adaptiveFlush) {
+    ESP_LOGI(TAG, "Initialized: chunkSize=%u, adaptive flush %lu-%lu ms",
+             config.writeChunkSize, config.minFlushMs, config.maxFlushMs);
+  } else {
+    ESP_LOGI(TAG, "Initialized: chunkSize=%u, flushTimeout=%lu ms",
+             config.writeChunkSize, config.flushTimeoutMs);
+  }
 
   return ESP_OK;
 }
 
+esp_err_t addSource(IDataSource *dataSource, uint8_t *channel) {
+  if (!dataSource) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  // Slots are written in place, so only ring buffers can be merged
+  if (s_sources[0].dataSource->getSlotPool() || dataSource->getSlotPool() ||
+      !dataSource->getRing()) {
+    ESP_LOGE(TAG, "Merged capture needs ring buffer mode on every source");
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  size_t index = s_sourceCount;
+  if (index >= MAX_SOURCES) {
+    return ESP_ERR_NO_MEM;
+  }
+  esp_err_t ret = attachSource(s_sources[index], dataSource, index);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  // Published last: the writer only looks at the first s_sourceCount entries
+  s_sourceCount = index + 1;
+  if (channel) {
+    *channel = index;
+  }
+  ESP_LOGI(TAG, "Source added on channel %u (%u merged)", index, index + 1);
+  return ESP_OK;
+}
+
+esp_err_t addStage(IPipelineStage *stage, uint8_t channel) {
+  if (!stage) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_initialized || channel >= s_sourceCount) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  // Slots are written in place, so only ring buffer data can be filtered
+  Source &src = s_sources[channel];
+  if (src.dataSource->getSlotPool() || !src.ring) {
+    ESP_LOGE(TAG, "Stages need ring buffer mode");
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  size_t index = src.stageCount;
+  if (index >= MAX_STAGES) {
+    return ESP_ERR_NO_MEM;
+  }
+  if (!s_stageBuf[0]) {
+    s_stageBuf[0] = (uint8_t *)MemoryPlan::alloc(
+        MemoryPlan::Region::PIPELINE_STAGES, 2 * STAGE_BUFFER_SIZE);
+    if (!s_stageBuf[0]) {
+      return ESP_ERR_NO_MEM;
+    }
+    s_stageBuf[1] = s_stageBuf[0] + STAGE_BUFFER_SIZE;
+  }
+  src.stages[index] = {stage, 0, 0};
+
+  // Published last: the writer only runs the first stageCount stages
+  src.stageCount = index + 1;
+  ESP_LOGI(TAG, "Stage '%s' added on channel %u", stage->getName(), channel);
+  return ESP_OK;
+}
+
 esp_err_t start() {
   if (!s_initialized) {
     return ESP_ERR_INVALID_STATE;
@@ -93,38 +350,153 @@ esp_err_t stop() {
   return ESP_OK;
 }
 
+void storageReady() { s_storageReady = true; }
+
 esp_err_t flush() {
   if (!s_initialized) {
     return ESP_ERR_INVALID_STATE;
   }
 
-  // Signal the writer task to flush
+  // Signal the writer task to flush. The writer submits the partial page
+  // and queues a metadata flush behind it, so the caller (typically the
+  // capture task's burst callback) never waits on flash.
   xSemaphoreGive(s_flushSem);
 
-  // Wait a bit for flush to complete
-  vTaskDelay(pdMS_TO_TICKS(100));
-
-  // Flush flash metadata
-  FlashRing::flushMetadata();
-  s_stats.flushOperations++;
+  return ESP_OK;
+}
 
+esp_err_t endBurst(size_t bytesInBurst) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  queueBurst(s_sources[0], bytesInBurst);
   return ESP_OK;
 }
 
+void markChunk(uint32_t streamOffset, int64_t timestampUs) {
+  if (s_initialized) {
+    queueMark(s_sources[0], streamOffset, timestampUs);
+  }
+}
+
+// Boot figure: the first capture time reported by a transport (queueMark()),
+// else the time the writer first saw data
+static void reportFirstByte(int64_t timestampUs) {
+  if (s_firstByteLogged) {
+    return;
+  }
+  s_firstByteLogged = true;
+  portENTER_CRITICAL(&s_statsLock);
+  if (s_stats.firstByteUs == 0) {
+    s_stats.firstByteUs = timestampUs;
+  }
+  int64_t firstByteUs = s_stats.firstByteUs;
+  portEXIT_CRITICAL(&s_statsLock);
+  ESP_LOGI(TAG, "First byte captured %lld ms after boot",
+           (long long)(firstByteUs / 1000));
+}
+
+static void queueBurst(Source &src, size_t bytesInBurst) {
+  // Never block the capture task; a lost mark merges two bursts
+  if (bytesInBurst > 0 && xQueueSend(src.burstQueue, &bytesInBurst, 0) != pdTRUE) {
+    DLOGW(TAG, "Burst queue full, boundary lost");
+  }
+  if (s_config.adaptiveFlush && !s_slotPool) {
+    s_burstFlushPending = true; // Flushed with the next policy flush
+  } else {
+    flush();
+  }
+}
+
+static void queueMark(Source &src, uint32_t streamOffset, int64_t timestampUs) {
+  if (s_stats.firstByteUs == 0) {
+    portENTER_CRITICAL(&s_statsLock);
+    if (s_stats.firstByteUs == 0) {
+      s_stats.firstByteUs = timestampUs;
+    }
+    portEXIT_CRITICAL(&s_statsLock);
+  }
+  // Never block the capture task; a lost mark only coarsens the timing
+  ChunkMark mark = {streamOffset, timestampUs};
+  if (xQueueSend(src.markQueue, &mark, 0) != pdTRUE) {
+    portENTER_CRITICAL(&s_statsLock);
+    s_stats.timeMarksLost++;
+    portEXIT_CRITICAL(&s_statsLock);
+  }
+}
+
+void setTapCallback(TapCallback callback) { s_tapCallback = callback; }
+
+void setChunkTapCallback(ChunkTapCallback callback) {
+  s_chunkTapCallback = callback;
+}
+
 esp_err_t getStats(Stats *stats) {
   if (!stats) {
     return ESP_ERR_INVALID_ARG;
   }
-  s_stats.running = s_running;
+  portENTER_CRITICAL(&s_statsLock);
   *stats = s_stats;
+  portEXIT_CRITICAL(&s_statsLock);
+  stats->running = s_running;
+  stats->sources = s_sourceCount;
+
+  size_t count = s_sourceCount;
+  stats->ringHighWater = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (s_sources[i].ring) {
+      stats->ringHighWater = std::max(stats->ringHighWater, s_sources[i].ring->highWater());
+    }
+  }
+
+  // Write engine figures come from the storage backend
+  Storage::Stats fs;
+  if (s_storage->getStats(&fs) == ESP_OK) {
+    stats->eraseStalls = fs.eraseStalls;
+    stats->eraseStallUs = fs.eraseStallUs;
+    stats->stallAvoidedUs = fs.stallAvoidedUs;
+    stats->lookAheadPages = fs.lookAheadPages;
+    stats->writeQueueHighWater = fs.writeQueueHighWater;
+  }
+  return ESP_OK;
+}
+
+esp_err_t getStageStats(uint8_t channel, size_t index, StageStats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (channel >= s_sourceCount || index >= s_sources[channel].stageCount) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  const Stage &stage = s_sources[channel].stages[index];
+  stats->name = stage.stage->getName();
+  portENTER_CRITICAL(&s_statsLock);
+  stats->bytesIn = stage.bytesIn;
+  stats->bytesOut = stage.bytesOut;
+  portEXIT_CRITICAL(&s_statsLock);
   return ESP_OK;
 }
 
 void resetStats() {
+  portENTER_CRITICAL(&s_statsLock);
   s_stats.bytesWrittenToFlash = 0;
   s_stats.bytesDropped = 0;
+  s_stats.compressInBytes = 0;
+  s_stats.compressOutBytes = 0;
+  s_stats.stageInBytes = 0;
+  s_stats.stageOutBytes = 0;
+  for (Source &src : s_sources) {
+    for (size_t i = 0; i < MAX_STAGES; i++) {
+      src.stages[i].bytesIn = 0;
+      src.stages[i].bytesOut = 0;
+    }
+  }
+  s_stats.timeMarksLost = 0;
+  s_stats.flushesCoalesced = 0;
+  s_stats.deadlineFlushes = 0;
   s_stats.writeOperations = 0;
   s_stats.flushOperations = 0;
+  portEXIT_CRITICAL(&s_statsLock);
 }
 
 void deinit() {
@@ -132,125 +504,842 @@ void deinit() {
     s_stopRequested = true;
     s_running = false;
 
+    // The writer lands in-flight pages and clears the handle on exit;
+    // only a task still stuck after that is deleted here
+    for (int i = 0; i < 150 && s_taskHandle; i++) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
     if (s_taskHandle) {
-      // Give task time to exit
-      vTaskDelay(pdMS_TO_TICKS(200));
-      vTaskDelete(s_taskHandle);
+      MemoryPlan::deleteTask(MemoryPlan::Region::TASK_FLASH_WRITER,
+                             s_taskHandle);
       s_taskHandle = nullptr;
     }
 
-    if (s_flushSem) {
-      vSemaphoreDelete(s_flushSem);
-      s_flushSem = nullptr;
-    }
+    deleteSyncObjects();
 
     s_initialized = false;
     ESP_LOGI(TAG, "Deinitialized");
   }
 }
 
+static void deleteSyncObjects() {
+  if (s_flushSem) {
+    vSemaphoreDelete(s_flushSem);
+    s_flushSem = nullptr;
+  }
+  if (s_tableFree) {
+    vSemaphoreDelete(s_tableFree);
+    s_tableFree = nullptr;
+  }
+  if (s_freeFrameQueue) {
+    vQueueDelete(s_freeFrameQueue);
+    s_freeFrameQueue = nullptr;
+  }
+  for (Source &src : s_sources) {
+    detachSource(src);
+  }
+  s_sourceCount = 0;
+  MemoryPlan::release(MemoryPlan::Region::PIPELINE_STAGES, s_stageBuf[0]);
+  s_stageBuf[0] = s_stageBuf[1] = nullptr;
+}
+
+// Create the framing queues of a source and route its callbacks here
+static esp_err_t attachSource(Source &src, IDataSource *dataSource,
+                              size_t channel) {
+  src = {};
+  src.burstQueue = xQueueCreate(BURST_QUEUE_DEPTH, sizeof(size_t));
+  src.markQueue = xQueueCreate(MARK_QUEUE_DEPTH, sizeof(ChunkMark));
+  if (!src.burstQueue || !src.markQueue) {
+    detachSource(src);
+    return ESP_ERR_NO_MEM;
+  }
+  src.dataSource = dataSource;
+  src.ring = dataSource->getRing();
+  dataSource->setBurstCallback(s_burstCallbacks[channel]);
+  dataSource->setChunkCallback(s_chunkCallbacks[channel]);
+  return ESP_OK;
+}
+
+static void detachSource(Source &src) {
+  if (src.dataSource) {
+    src.dataSource->setBurstCallback(nullptr);
+    src.dataSource->setChunkCallback(nullptr);
+    src.dataSource = nullptr;
+  }
+  src.stageCount = 0;
+  if (src.burstQueue) {
+    vQueueDelete(src.burstQueue);
+    src.burstQueue = nullptr;
+  }
+  if (src.markQueue) {
+    vQueueDelete(src.markQueue);
+    src.markQueue = nullptr;
+  }
+}
+
 // --- Task implementation ---
 
+static void countDropped(size_t len) {
+  portENTER_CRITICAL(&s_statsLock);
+  s_stats.bytesDropped += len;
+  portEXIT_CRITICAL(&s_statsLock);
+}
+
+static void onPageWritten(const uint8_t *data, size_t len, esp_err_t result,
+                          void *ctx) {
+  portENTER_CRITICAL(&s_statsLock);
+  if (result == ESP_OK) {
+    s_stats.bytesWrittenToFlash += len;
+    s_stats.writeOperations++;
+  } else {
+    s_stats.bytesDropped += len;
+  }
+  portEXIT_CRITICAL(&s_statsLock);
+  if (result != ESP_OK) {
+    ESP_LOGE(TAG, "Flash write failed: %s", esp_err_to_name(result));
+  }
+
+  // Buffer goes back to the writer
+  uint8_t *buf = const_cast<uint8_t *>(data);
+  xQueueSend(s_freeBufQueue, &buf, 0);
+}
+
+static void onPayloadWritten(const uint8_t *data, size_t len, esp_err_t result,
+                             void *ctx) {
+  portENTER_CRITICAL(&s_statsLock);
+  if (result == ESP_OK) {
+    s_stats.bytesWrittenToFlash += len;
+    s_stats.writeOperations++;
+  } else {
+    s_stats.bytesDropped += len;
+  }
+  portEXIT_CRITICAL(&s_statsLock);
+  if (result != ESP_OK) {
+    ESP_LOGE(TAG, "Flash write failed: %s", esp_err_to_name(result));
+  }
+}
+
+static void onFrameWritten(const uint8_t *data, size_t len, esp_err_t result,
+                           void *ctx) {
+  onPayloadWritten(data, len, result, ctx);
+
+  uint8_t *frame = const_cast<uint8_t *>(data);
+  xQueueSend(s_freeFrameQueue, &frame, 0);
+}
+
+static void onTableWritten(const uint8_t *data, size_t len, esp_err_t result,
+                           void *ctx) {
+  onPayloadWritten(data, len, result, ctx);
+  xSemaphoreGive(s_tableFree);
+}
+
+static void onSlotWritten(const uint8_t *data, size_t len, esp_err_t result,
+                          void *ctx) {
+  // Slot goes back to the transport once all its pieces are programmed
+  s_slotPool->release(static_cast<SlotPool::Slot *>(ctx));
+}
+
+static void submitAsync(const uint8_t *data, size_t len,
+                        Storage::WriteCallback callback, void *ctx) {
+  esp_err_t ret = s_storage->writeAsync(data, len, callback, ctx, portMAX_DELAY);
+  if (ret != ESP_OK) {
+    countDropped(len);
+    ESP_LOGE(TAG, "Failed to queue flash write: %s", esp_err_to_name(ret));
+    if (callback) {
+      callback(data, len, ret, ctx);
+    }
+  }
+}
+
+// Hand the page buffer being filled to the write engine (ring buffer mode)
+static void submitPage() {
+  if (!s_pageBuf) {
+    return;
+  }
+  if (s_pageFill > 0) {
+    submitAsync(s_pageBuf, s_pageFill, onPageWritten, nullptr);
+    if (s_dirtySinceUs == 0) {
+      s_dirtySinceUs = esp_timer_get_time(); // Ring metadata moved
+    }
+    s_pendingSinceUs = 0;
+  } else {
+    xQueueSend(s_freeBufQueue, &s_pageBuf, 0);
+  }
+  s_pageBuf = nullptr;
+  s_pageFill = 0;
+}
+
+// Copy bytes into page buffers, submitting each one as it reaches a page
+// boundary (ring buffer mode). Waits while every buffer is in flight.
+static void copyToPages(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    if (!s_pageBuf) {
+      while (xQueueReceive(s_freeBufQueue, &s_pageBuf, pdMS_TO_TICKS(100)) !=
+             pdTRUE) {
+        if (s_stopRequested) {
+          countDropped(len);
+          return;
+        }
+      }
+      s_pageFill = 0;
+    }
+
+    // Fill up to the next page boundary (accounting for queued writes)
+    size_t room = s_storage->getBytesToPageEnd() - s_pageFill;
+    size_t n = std::min(len, room);
+    memcpy(s_pageBuf + s_pageFill, data, n);
+    s_pageFill += n;
+    data += n;
+    len -= n;
+
+    // Page complete: hand it to the write engine and keep filling
+    if (n == room) {
+      ESP_LOGD(TAG, "Queued %u bytes (page completion)", s_pageFill);
+      submitPage();
+    }
+  }
+}
+
+// Logical flash position of the next byte the writer emits
+static uint64_t streamPosition() {
+  return s_storage->getQueuedHead() + s_pageFill;
+}
+
+// Write a record header or footer
+static void emitFrame(const void *frame, size_t len) {
+  if (!s_slotPool) {
+    copyToPages(static_cast<const uint8_t *>(frame), len);
+    return;
+  }
+
+  // Slot mode: frames need their own buffer until programmed
+  uint8_t *buf = nullptr;
+  while (xQueueReceive(s_freeFrameQueue, &buf, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (s_stopRequested) {
+      return;
+    }
+  }
+  memcpy(buf, frame, len);
+  submitAsync(buf, len, onFrameWritten, nullptr);
+}
+
+// Compress and write the pending raw block
+static void flushBlock() {
+  if (s_blockFill == 0) {
+    return;
+  }
+
+  RecordStore::BlockHeader block;
+  block.rawLength = s_blockFill;
+  uint8_t *stored = s_blockOut + sizeof(block);
+  size_t compressed =
+      Lz4::compress(s_blockRaw, s_blockFill, stored,
+                    Lz4::compressBound(RecordStore::BLOCK_RAW_SIZE), s_lzWork);
+  if (compressed == 0 || compressed >= s_blockFill) {
+    memcpy(stored, s_blockRaw, s_blockFill); // Incompressible
+    compressed = s_blockFill;
+  }
+  block.storedLength = compressed;
+  memcpy(s_blockOut, &block, sizeof(block));
+
+  size_t len = sizeof(block) + compressed;
+  RecordStore::appendPayload(s_blockOut, len);
+  copyToPages(s_blockOut, len);
+  portENTER_CRITICAL(&s_statsLock);
+  s_stats.compressInBytes += s_blockFill;
+  s_stats.compressOutBytes += len;
+  portEXIT_CRITICAL(&s_statsLock);
+  s_blockFill = 0;
+}
+
+// Write payload bytes (straight from the slot in zero-copy mode)
+static void emitPayload(const uint8_t *data, size_t len) {
+  s_recordPayload += len;
+  if (s_compressing) {
+    while (len > 0) {
+      size_t n = std::min(len, RecordStore::BLOCK_RAW_SIZE - s_blockFill);
+      memcpy(s_blockRaw + s_blockFill, data, n);
+      s_blockFill += n;
+      data += n;
+      len -= n;
+      if (s_blockFill == RecordStore::BLOCK_RAW_SIZE) {
+        flushBlock();
+      }
+    }
+    return;
+  }
+
+  RecordStore::appendPayload(data, len);
+  if (!s_slotPool) {
+    copyToPages(data, len);
+  } else {
+    submitAsync(data, len, onPayloadWritten, nullptr);
+  }
+}
+
+// Stream offsets wrap at 32 bits
+static inline bool streamBefore(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+// Payload offset in the open record of stream byte @p streamOffset of
+// @p src. Behind stages the byte is placed proportionally within the last
+// filtered span (the next stored byte if the span stored nothing).
+static uint32_t payloadOffset(const Source &src, uint32_t streamOffset) {
+  if (src.stageCount == 0) {
+    return streamOffset - s_recordStart;
+  }
+  uint32_t rel = std::min<uint32_t>(streamOffset - src.spanIn, src.spanInLen);
+  size_t inLen = std::max<size_t>(src.spanInLen, 1);
+  return src.spanOut + (uint32_t)((uint64_t)rel * src.spanOutLen / inLen);
+}
+
+// Add a mark to the open record's time table. When full, every other
+// entry is dropped and only one mark in twice as many is kept.
+static void addTimeMark(const Source &src, const ChunkMark &mark) {
+  uint32_t index = s_timeMarksSeen++;
+  while (true) {
+    if (index % s_timeMarkStride != 0) {
+      return;
+    }
+    if (s_timeMarkCount < RecordStore::MAX_TIME_MARKS) {
+      break;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < s_timeMarkCount; i += 2) {
+      s_timeMarks[kept++] = s_timeMarks[i];
+    }
+    s_timeMarkCount = kept;
+    s_timeMarkStride *= 2;
+  }
+
+  int64_t deltaUs = mark.timestampUs - s_recordTimeUs;
+  s_timeMarks[s_timeMarkCount++] = {payloadOffset(src, mark.streamOffset),
+                                    (uint32_t)std::max<int64_t>(deltaUs, 0)};
+}
+
+// Consume the marks of @p src for stream bytes before @p end
+static void takeMarks(Source &src, uint32_t end) {
+  ChunkMark mark;
+  while (xQueuePeek(src.markQueue, &mark, 0) == pdTRUE &&
+         streamBefore(mark.streamOffset, end)) {
+    xQueueReceive(src.markQueue, &mark, 0);
+    if (s_recordSource == &src && s_recordTimeUs != 0 &&
+        !streamBefore(mark.streamOffset, s_recordStart)) {
+      addTimeMark(src, mark);
+    }
+  }
+}
+
+// Capture time of the chunk holding the next byte of @p src, 0 if unknown
+static int64_t nextChunkTime(Source &src) {
+  takeMarks(src, src.streamBytes);
+  ChunkMark mark;
+  return (xQueuePeek(src.markQueue, &mark, 0) == pdTRUE) ? mark.timestampUs : 0;
+}
+
+// Append the time table as the last payload bytes of the open record
+static void emitTimeTable() {
+  RecordStore::TimeTableTrailer trailer = {(uint32_t)s_timeMarkCount,
+                                           RecordStore::TIME_TABLE_MAGIC};
+  size_t marksLen = s_timeMarkCount * sizeof(RecordStore::TimeMark);
+  size_t len = marksLen + sizeof(trailer);
+
+  // Slot mode writes the table from s_tableBuf itself, so the previous
+  // record's table must have been programmed before the buffer is reused
+  if (s_slotPool &&
+      xSemaphoreTake(s_tableFree, pdMS_TO_TICKS(TABLE_WAIT_MS)) != pdTRUE) {
+    // Without its trailer the record reads as untimed
+    ESP_LOGW(TAG, "Time table buffer busy, record stored untimed");
+    return;
+  }
+  uint8_t *table = s_tableBuf;
+  memcpy(table, s_timeMarks, marksLen);
+  memcpy(table + marksLen, &trailer, sizeof(trailer));
+
+  RecordStore::appendPayload(table, len);
+  if (!s_slotPool) {
+    copyToPages(table, len);
+  } else {
+    submitAsync(table, len, onTableWritten, nullptr);
+  }
+}
+
+// Finish the open record (burst end, or another channel takes over)
+static void closeRecord() {
+  flushBlock();
+  if (s_recordTimeUs != 0) {
+    emitTimeTable();
+  }
+  RecordStore::RecordFooter footer;
+  RecordStore::endRecord(&footer);
+  emitFrame(&footer, sizeof(footer));
+  s_recordSource = nullptr;
+
+  // The header length is filled in behind the footer
+  submitPage();
+  RecordStore::sealRecord();
+  ESP_LOGD(TAG, "Record %lu closed: %lu bytes", footer.seq, footer.length);
+}
+
+// Whether @p src has no bytes waiting for the writer
+static bool sourceDrained(Source &src) {
+  if (src.item) {
+    return false;
+  }
+  if (s_slotPool) {
+    return s_slotPool->filledCount() == 0;
+  }
+  return src.ring->available() == 0;
+}
+
+// Close the burst of @p src once its length has been reached
+static void closeCompletedBurst(Source &src) {
+  size_t burstBytes;
+  if (xQueuePeek(src.burstQueue, &burstBytes, 0) != pdTRUE) {
+    return;
+  }
+  if (src.burstBytes == 0) {
+    // Boundary without payload (e.g. stats reset mid-burst). With hardware
+    // burst detection the boundary can also arrive before the bytes.
+    if (sourceDrained(src)) {
+      xQueueReceive(src.burstQueue, &burstBytes, 0);
+    }
+    return;
+  }
+  if (src.burstBytes < burstBytes) {
+    return;
+  }
+  xQueueReceive(src.burstQueue, &burstBytes, 0);
+  src.burstBytes = 0;
+
+  // Stages release what they held back for the burst
+  if (src.stageCount > 0) {
+    emitStream(src, nullptr, 0, true);
+  }
+  if (s_recordSource == &src) {
+    closeRecord();
+  }
+
+  ChunkTapCallback chunkTap = s_chunkTapCallback;
+  if (chunkTap) {
+    chunkTap((uint8_t)(&src - s_sources), nullptr, 0, 0);
+  }
+}
+
+// Start a record for the next bytes of @p src
+static void openRecord(Source &src) {
+  s_recordSource = &src;
+  s_recordStart = src.streamBytes;
+  s_recordTimeUs = nextChunkTime(src);
+  s_recordPayload = 0;
+  s_timeMarkCount = 0;
+  s_timeMarkStride = 1;
+  s_timeMarksSeen = 0;
+
+  RecordStore::RecordHeader header;
+  RecordStore::beginRecord(src.dataSource->getType(), (uint8_t)(&src - s_sources),
+                           streamPosition(), &header,
+                           s_compressing ? RecordStore::ENCODING_LZ4
+                                         : RecordStore::ENCODING_RAW,
+                           s_recordTimeUs);
+  emitFrame(&header, sizeof(header));
+}
+
+// Run @p len bytes of @p src through its stages, ending the frame if
+// @p frameEnd; returns the output length and points @p out at it
+static size_t runStages(Source &src, const uint8_t *data, size_t len,
+                        bool frameEnd, const uint8_t **out) {
+  size_t count = src.stageCount;
+  size_t lengths[MAX_STAGES + 1];
+  lengths[0] = len;
+  for (size_t i = 0; i < count; i++) {
+    IPipelineStage *stage = src.stages[i].stage;
+    uint8_t *buf = s_stageBuf[i & 1];
+    size_t n = (len > 0) ? stage->process(data, len, buf) : 0;
+    if (frameEnd) {
+      n += stage->endFrame(buf + n);
+    }
+    data = buf;
+    len = n;
+    lengths[i + 1] = n;
+  }
+
+  portENTER_CRITICAL(&s_statsLock);
+  for (size_t i = 0; i < count; i++) {
+    src.stages[i].bytesIn += lengths[i];
+    src.stages[i].bytesOut += lengths[i + 1];
+  }
+  s_stats.stageInBytes += lengths[0];
+  s_stats.stageOutBytes += len;
+  portEXIT_CRITICAL(&s_statsLock);
+
+  *out = data;
+  return len;
+}
+
+// Write payload bytes of @p src (through its stages), opening a record for
+// the first byte that is stored
+static void emitStream(Source &src, const uint8_t *data, size_t len,
+                       bool frameEnd) {
+  size_t inLen = len;
+  if (src.stageCount > 0) {
+    len = runStages(src, data, len, frameEnd, &data);
+  }
+
+  if (len > 0) {
+    // Records hold a single channel
+    if (s_recordSource && s_recordSource != &src) {
+      closeRecord();
+    }
+    if (!s_recordSource) {
+      openRecord(src);
+    }
+  }
+
+  src.spanIn = src.streamBytes;
+  src.spanInLen = inLen;
+  src.spanOut = s_recordPayload;
+  src.spanOutLen = len;
+  if (len > 0) {
+    emitPayload(data, len);
+  }
+}
+
+// Split received bytes of @p src into records and write them
+static void processStream(Source &src, const uint8_t *data, size_t len) {
+  TapCallback tap = s_tapCallback;
+  if (tap) {
+    tap(data, len);
+  }
+
+  while (len > 0) {
+    // A boundary queued after its last bytes were written closes its
+    // burst before these bytes, which belong to the next one
+    closeCompletedBurst(src);
+
+    // Stop at the burst boundary, the rest belongs to the next record
+    size_t n = len;
+    size_t burstBytes;
+    if (xQueuePeek(src.burstQueue, &burstBytes, 0) == pdTRUE &&
+        burstBytes > src.burstBytes && burstBytes - src.burstBytes < n) {
+      n = burstBytes - src.burstBytes;
+    }
+
+    // The chunk tap sees the capture chunks as they were received: stop
+    // after the last byte of the next one
+    ChunkTapCallback chunkTap = s_chunkTapCallback;
+    int64_t chunkEndUs = 0;
+    ChunkMark mark;
+    if (chunkTap && xQueuePeek(src.markQueue, &mark, 0) == pdTRUE &&
+        mark.streamOffset - src.streamBytes < n) {
+      n = mark.streamOffset - src.streamBytes + 1;
+      chunkEndUs = mark.timestampUs;
+    }
+
+    emitStream(src, data, n, false);
+    src.burstBytes += n;
+    src.streamBytes += n;
+    if (chunkTap) {
+      chunkTap((uint8_t)(&src - s_sources), data, n, chunkEndUs);
+    }
+    data += n;
+    len -= n;
+    takeMarks(src, src.streamBytes);
+
+    closeCompletedBurst(src);
+  }
+}
+
+// Peek the next ring region of @p src (up to a page) if it has none pending
+static void fetchItem(Source &src) {
+  if (src.item) {
+    return;
+  }
+  src.itemSize = src.ring->peek(&src.item, FlashRing::PAGE_SIZE);
+  if (src.itemSize == 0) {
+    src.item = nullptr;
+  } else {
+    int64_t captured = nextChunkTime(src);
+    src.itemTimeUs = captured ? captured : esp_timer_get_time();
+    src.itemTimed = (captured != 0);
+  }
+}
+
+// Nothing readable anywhere: sleep until a source has a page readable or
+// 10 ms passed (smaller amounts are taken on the timeout). The producers
+// notify this task, so they do not signal per chunk.
+static void waitForData(size_t count) {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  for (size_t i = 0; i < count; i++) {
+    if (!s_sources[i].ring->armWake(self, FlashRing::PAGE_SIZE)) {
+      return;
+    }
+  }
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+}
+
+// Pick the pending item to write next: the oldest one, but while another
+// source has nothing pending an item is held until it is mergeSkewMs old,
+// so that older data still on its way from that source goes first
+static Source *pickItem(size_t count) {
+  Source *oldest = nullptr;
+  bool allPending = true;
+  for (size_t i = 0; i < count; i++) {
+    Source &src = s_sources[i];
+    if (!src.item) {
+      allPending = false;
+    } else if (!oldest || src.itemTimeUs < oldest->itemTimeUs) {
+      oldest = &src;
+    }
+  }
+
+  if (!oldest || allPending || count == 1) {
+    return oldest;
+  }
+  int64_t ageUs = esp_timer_get_time() - oldest->itemTimeUs;
+  return (ageUs >= (int64_t)s_config.mergeSkewMs * 1000) ? oldest : nullptr;
+}
+
+// Track the ingest rate of the ring writer after @p len bytes arrived
+static void noteIngest(size_t len, int64_t nowUs) {
+  if (s_lastDataUs != 0) {
+    // An idle period counts as at most one maximum window
+    int64_t gapUs = std::min<int64_t>(nowUs - s_lastDataUs,
+                                      (int64_t)s_config.maxFlushMs * 1000);
+    s_gapUs = (3 * s_gapUs + gapUs) / 4;
+  }
+  s_lastDataUs = nowUs;
+  s_rateWindowBytes += len;
+}
+
+// Resize the idle window and partial page hold time from the smoothed
+// rate and the ring buffer fill (once per RATE_WINDOW_US)
+static void updateFlushPolicy(int64_t nowUs, size_t count) {
+  int64_t elapsedUs = nowUs - s_rateWindowUs;
+  if (elapsedUs < RATE_WINDOW_US) {
+    return;
+  }
+  uint32_t sample = (uint32_t)(s_rateWindowBytes * 1000000ULL / elapsedUs);
+  s_rateBps = (3 * s_rateBps + sample) / 4;
+  s_rateWindowUs = nowUs;
+  s_rateWindowBytes = 0;
+
+  size_t fillPct = 0;
+  for (size_t i = 0; i < count; i++) {
+    StagingRing *ring = s_sources[i].ring;
+    fillPct = std::max<size_t>(fillPct, ring->available() * 100 / ring->size());
+  }
+
+  uint32_t minMs = s_config.minFlushMs;
+  uint32_t maxMs = std::max(s_config.maxFlushMs, minMs);
+  uint32_t windowMs = maxMs;
+  uint32_t deadlineMs = maxMs;
+  if (fillPct < BACKLOG_FILL_PCT) {
+    windowMs = std::clamp<uint32_t>(IDLE_GAPS * s_gapUs / 1000, minMs, maxMs);
+    if (s_rateBps > 0) {
+      // About the time the current rate takes to fill a page
+      deadlineMs = std::clamp<uint32_t>(
+          (uint32_t)(FlashRing::PAGE_SIZE * 1000ULL / s_rateBps), windowMs, maxMs);
+    }
+  }
+
+  if (windowMs != s_stats.flushWindowMs || deadlineMs != s_stats.flushDeadlineMs) {
+    ESP_LOGD(TAG, "Flush policy: %lu B/s, fill %u%%, window %lu ms, hold %lu ms",
+             s_rateBps, fillPct, windowMs, deadlineMs);
+  }
+  portENTER_CRITICAL(&s_statsLock);
+  s_stats.ingestRateBps = s_rateBps;
+  s_stats.ringFillPct = fillPct;
+  s_stats.flushWindowMs = windowMs;
+  s_stats.flushDeadlineMs = deadlineMs;
+  portEXIT_CRITICAL(&s_statsLock);
+}
+
+// Whether pending data or metadata should be flushed now (adaptive policy)
+static bool adaptiveFlushDue(int64_t nowUs) {
+  if (s_burstFlushPending) {
+    s_burstFlushPending = false;
+    if (s_dirtySinceUs != 0) {
+      portENTER_CRITICAL(&s_statsLock);
+      s_stats.flushesCoalesced++;
+      portEXIT_CRITICAL(&s_statsLock);
+    } else {
+      s_dirtySinceUs = nowUs;
+    }
+  }
+  if ((s_pageFill > 0 || s_blockFill > 0) && s_pendingSinceUs == 0) {
+    s_pendingSinceUs = nowUs;
+  }
+  if (s_pendingSinceUs == 0 && s_dirtySinceUs == 0) {
+    return false;
+  }
+
+  if (nowUs - s_lastDataUs >= (int64_t)s_stats.flushWindowMs * 1000) {
+    return true; // Stream went idle
+  }
+  if ((s_pendingSinceUs != 0 &&
+       nowUs - s_pendingSinceUs >= (int64_t)s_stats.flushDeadlineMs * 1000) ||
+      (s_dirtySinceUs != 0 &&
+       nowUs - s_dirtySinceUs >= (int64_t)s_config.maxFlushMs * 1000)) {
+    portENTER_CRITICAL(&s_statsLock);
+    s_stats.deadlineFlushes++;
+    portEXIT_CRITICAL(&s_statsLock);
+    return true;
+  }
+  return false;
+}
+
 static void writerTask(void *arg) {
-  if (!s_dataSource) {
+  IDataSource *dataSource = s_sources[0].dataSource;
+  if (!dataSource) {
     ESP_LOGE(TAG, "DataSource not initialized!");
-    vTaskDelete(nullptr);
+    s_taskHandle = nullptr;
+    MemoryPlan::exitTask(MemoryPlan::Region::TASK_FLASH_WRITER);
     return;
   }
 
-  RingbufHandle_t ringBuf = s_dataSource->getRingBuffer();
+  // Staged boot: capture fills the transport's RAM buffers until flash is up
+  if (!s_storageReady) {
+    ESP_LOGI(TAG, "Flash not ready, buffering capture in RAM");
+    while (!s_storageReady && !s_stopRequested) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+  }
+
+  // Zero-copy mode: the transport hands over filled page slots
+  SlotPool *pool = dataSource->getSlotPool();
+  StagingRing *ring = dataSource->getRing();
 
-  if (!ringBuf) {
+  if (pool) {
+    s_slotPool = pool;
+    slotWriterLoop(pool);
+  } else if (ring) {
+    ringWriterLoop();
+  } else {
     ESP_LOGE(TAG, "No ring buffer available!");
-    vTaskDelete(nullptr);
+    s_taskHandle = nullptr;
+    MemoryPlan::exitTask(MemoryPlan::Region::TASK_FLASH_WRITER);
     return;
   }
 
-  // Allocate write buffer (12KB to hold data while writing to flash)
-  uint8_t *writeBuf = (uint8_t *)malloc(s_config.writeChunkSize);
-  if (!writeBuf) {
-    ESP_LOGE(TAG, "Failed to allocate write buffer");
-    vTaskDelete(nullptr);
+  // Let in-flight pages land before their buffers go away
+  s_storage->waitIdle(pdMS_TO_TICKS(1000));
+
+  if (s_freeBufQueue) {
+    vQueueDelete(s_freeBufQueue);
+    s_freeBufQueue = nullptr;
+  }
+  MemoryPlan::release(MemoryPlan::Region::PIPELINE_PAGES, s_bufStorage);
+  s_bufStorage = nullptr;
+  s_slotPool = nullptr;
+
+  ESP_LOGI(TAG, "Writer task exiting");
+  s_taskHandle = nullptr;
+  MemoryPlan::exitTask(MemoryPlan::Region::TASK_FLASH_WRITER);
+}
+
+static void ringWriterLoop() {
+  // Split the write chunk budget (12KB) into page buffers, at least two so
+  // that one can be filled while the other is programmed
+  size_t bufCount = s_config.writeChunkSize / FlashRing::PAGE_SIZE;
+  if (bufCount < 2) {
+    bufCount = 2;
+  }
+
+  s_bufStorage = (uint8_t *)MemoryPlan::alloc(
+      MemoryPlan::Region::PIPELINE_PAGES, bufCount * FlashRing::PAGE_SIZE);
+  s_freeBufQueue = xQueueCreate(bufCount, sizeof(uint8_t *));
+  if (!s_bufStorage || !s_freeBufQueue) {
+    ESP_LOGE(TAG, "Failed to allocate write buffers");
     return;
   }
+  for (size_t i = 0; i < bufCount; i++) {
+    uint8_t *buf = s_bufStorage + i * FlashRing::PAGE_SIZE;
+    xQueueSend(s_freeBufQueue, &buf, 0);
+  }
+
+  if (s_config.compress) {
+    uint8_t *lz4 = (uint8_t *)MemoryPlan::alloc(
+        MemoryPlan::Region::PIPELINE_LZ4, LZ4_BUFFER_SIZE);
+    s_lzWork = lz4;
+    s_blockRaw = lz4 ? lz4 + Lz4::WORK_SIZE : nullptr;
+    s_blockOut = lz4 ? s_blockRaw + RecordStore::BLOCK_RAW_SIZE : nullptr;
+    s_compressing = (lz4 != nullptr);
+    if (!s_compressing) {
+      ESP_LOGW(TAG, "No memory for compression, storing raw");
+    }
+    s_blockFill = 0;
+  }
 
-  ESP_LOGI(TAG, "Flash writer task started on Core %d", xPortGetCoreID());
+  ESP_LOGI(TAG, "Flash writer task started on Core %d (%u page buffers)",
+           xPortGetCoreID(), bufCount);
 
-  size_t pendingBytes = 0;
   TickType_t lastDataTime = xTaskGetTickCount();
 
+  s_rateBps = 0;
+  s_gapUs = 0;
+  s_lastDataUs = 0;
+  s_rateWindowUs = esp_timer_get_time();
+  s_rateWindowBytes = 0;
+  s_pendingSinceUs = 0;
+  s_dirtySinceUs = 0;
+  s_burstFlushPending = false;
+  portENTER_CRITICAL(&s_statsLock);
+  s_stats.flushWindowMs = s_config.maxFlushMs;
+  s_stats.flushDeadlineMs = s_config.maxFlushMs;
+  portEXIT_CRITICAL(&s_statsLock);
+
   while (!s_stopRequested) {
     if (!s_running) {
       vTaskDelay(pdMS_TO_TICKS(100));
       continue;
     }
 
-    // Try to receive data from ring buffer
-    size_t itemSize;
-    void *item = xRingbufferReceiveUpTo(
-        ringBuf, &itemSize,
-        pdMS_TO_TICKS(10), // Reduced latency for faster response
-        s_config.writeChunkSize - pendingBytes);
+    // Keep one item per source pending and write the oldest first
+    size_t count = s_sourceCount;
+    bool anyPending = false;
+    for (size_t i = 0; i < count; i++) {
+      fetchItem(s_sources[i]);
+      anyPending |= (s_sources[i].item != nullptr);
+    }
+
+    Source *src = pickItem(count);
+    if (!src) {
+      if (anyPending) {
+        vTaskDelay(1); // Holding an item for the merge skew
+      } else {
+        waitForData(count);
+        for (size_t i = 0; i < count; i++) {
+          fetchItem(s_sources[i]);
+        }
+        src = pickItem(count);
+      }
+    }
 
-    if (item && itemSize > 0) {
+    if (src && src->itemSize > 0) {
       // Data received, signal LED activity
       LedManager::setDataActivity(true);
 
-      // Copy to write buffer
-      memcpy(writeBuf + pendingBytes, item, itemSize);
-      pendingBytes += itemSize;
+      if (src->itemTimed) {
+        PerfCounters::recordSince(PerfCounters::Stage::RING_TO_WRITER, src->itemTimeUs);
+      }
+      reportFirstByte(src->itemTimed ? src->itemTimeUs : esp_timer_get_time());
+      PerfCounters::addBytes(PerfCounters::Counter::CAPTURED, src->itemSize);
+      processStream(*src, src->item, src->itemSize);
 
-      // Return item to ring buffer
-      vRingbufferReturnItem(ringBuf, item);
+      // Hand the region back to the transport
+      src->ring->release(src->itemSize);
+      src->item = nullptr;
 
       lastDataTime = xTaskGetTickCount();
+      noteIngest(src->itemSize, esp_timer_get_time());
+    }
 
-      // ... (rest of processing)
-
-      // Page-aligned writing: write when we can complete current page + full
-      // pages
-      size_t bytesToPageEnd = FlashRing::getBytesToPageEnd();
-
-      // If we have enough to complete current page, write it
-      if (pendingBytes >= bytesToPageEnd && bytesToPageEnd > 0) {
-        // Write to complete current page
-        esp_err_t ret = FlashRing::write(writeBuf, bytesToPageEnd);
-        if (ret == ESP_OK) {
-          s_stats.bytesWrittenToFlash += bytesToPageEnd;
-          s_stats.writeOperations++;
-          ESP_LOGD(TAG, "Wrote %u bytes (page completion)", bytesToPageEnd);
-        } else {
-          s_stats.bytesDropped += bytesToPageEnd;
-          ESP_LOGE(TAG, "Flash write failed: %s", esp_err_to_name(ret));
-        }
-
-        // Shift remaining data
-        size_t remaining = pendingBytes - bytesToPageEnd;
-        if (remaining > 0) {
-          memmove(writeBuf, writeBuf + bytesToPageEnd, remaining);
-        }
-        pendingBytes = remaining;
-      }
-
-      // Write full pages (4096 bytes each)
-      while (pendingBytes >= FlashRing::PAGE_SIZE) {
-        esp_err_t ret = FlashRing::write(writeBuf, FlashRing::PAGE_SIZE);
-        if (ret == ESP_OK) {
-          s_stats.bytesWrittenToFlash += FlashRing::PAGE_SIZE;
-          s_stats.writeOperations++;
-          ESP_LOGD(TAG, "Wrote %u bytes (full page)", FlashRing::PAGE_SIZE);
-        } else {
-          s_stats.bytesDropped += FlashRing::PAGE_SIZE;
-          ESP_LOGE(TAG, "Flash write failed: %s", esp_err_to_name(ret));
-        }
-
-        // Shift remaining data
-        size_t remaining = pendingBytes - FlashRing::PAGE_SIZE;
-        if (remaining > 0) {
-          memmove(writeBuf, writeBuf + FlashRing::PAGE_SIZE, remaining);
-        }
-        pendingBytes = remaining;
-      }
+    // Burst end reported after its last byte was processed
+    for (size_t i = 0; i < count; i++) {
+      closeCompletedBurst(s_sources[i]);
     }
 
     // Check for flush signal or timeout
@@ -260,50 +1349,101 @@ static void writerTask(void *arg) {
       shouldFlush = true;
     }
 
-    // Flush on timeout if we have pending data
-    if (pendingBytes > 0) {
+    if (s_config.adaptiveFlush) {
+      int64_t nowUs = esp_timer_get_time();
+      updateFlushPolicy(nowUs, count);
+      shouldFlush |= adaptiveFlushDue(nowUs);
+    } else if (s_pageFill > 0 || s_blockFill > 0) {
+      // Flush on timeout if we have pending data
       TickType_t elapsed = xTaskGetTickCount() - lastDataTime;
       if (elapsed > pdMS_TO_TICKS(s_config.flushTimeoutMs)) {
         shouldFlush = true;
       }
     }
 
-    if (shouldFlush && pendingBytes > 0) {
-      // calculated usage...
-      // ... (rest of flush logic)
-      esp_err_t ret = FlashRing::write(writeBuf, pendingBytes);
-      if (ret == ESP_OK) {
-        s_stats.bytesWrittenToFlash += pendingBytes;
-        s_stats.writeOperations++;
-      } else {
-        s_stats.bytesDropped += pendingBytes;
-        ESP_LOGE(TAG, "Flash write failed on flush: %s", esp_err_to_name(ret));
-      }
-      pendingBytes = 0;
-
-      // Check if ring buffer is also empty to clear LED activity
-      size_t rb_waiting = 0;
-      vRingbufferGetInfo(ringBuf, NULL, NULL, NULL, NULL, &rb_waiting);
-      if (rb_waiting == 0) {
-        LedManager::setDataActivity(false);
-      }
+    if (shouldFlush) {
+      flushBlock();
+      submitPage();
 
-      // Also flush metadata
-      FlashRing::flushMetadata();
+      // Persist metadata once the queued pages are programmed
+      s_storage->flushAsync();
+      portENTER_CRITICAL(&s_statsLock);
       s_stats.flushOperations++;
-    } else if (pendingBytes == 0) {
-      // Even if no flush, check if system is idle to clear LED
-      size_t rb_waiting = 0;
-      vRingbufferGetInfo(ringBuf, NULL, NULL, NULL, NULL, &rb_waiting);
-      if (rb_waiting == 0) {
+      portEXIT_CRITICAL(&s_statsLock);
+      s_pendingSinceUs = 0;
+      s_dirtySinceUs = 0;
+    }
+
+    if (s_pageFill == 0 && s_blockFill == 0) {
+      // Check if ring buffers are also empty to clear LED activity
+      bool drained = true;
+      for (size_t i = 0; i < count; i++) {
+        drained &= sourceDrained(s_sources[i]);
+      }
+      if (drained) {
         LedManager::setDataActivity(false);
       }
     }
   }
 
-  free(writeBuf);
-  ESP_LOGI(TAG, "Writer task exiting");
-  vTaskDelete(nullptr);
+  for (Source &src : s_sources) {
+    src.item = nullptr; // Peeked regions need no return
+  }
+
+  if (s_pageBuf) {
+    xQueueSend(s_freeBufQueue, &s_pageBuf, 0);
+    s_pageBuf = nullptr;
+    s_pageFill = 0;
+  }
+
+  s_compressing = false;
+  s_blockFill = 0;
+  MemoryPlan::release(MemoryPlan::Region::PIPELINE_LZ4, s_lzWork);
+  s_blockRaw = s_blockOut = nullptr;
+  s_lzWork = nullptr;
+}
+
+static void slotWriterLoop(SlotPool *pool) {
+  ESP_LOGI(TAG, "Flash writer task started on Core %d (zero-copy, %u slots)",
+           xPortGetCoreID(), pool->slotCount());
+  if (s_config.compress) {
+    ESP_LOGW(TAG, "Compression needs page buffers, storing raw in zero-copy mode");
+  }
+
+  while (!s_stopRequested) {
+    if (!s_running) {
+      vTaskDelay(pdMS_TO_TICKS(100));
+      continue;
+    }
+
+    SlotPool::Slot *slot = pool->receive(pdMS_TO_TICKS(10));
+    if (slot) {
+      LedManager::setDataActivity(true);
+      reportFirstByte(esp_timer_get_time());
+
+      // Slot data goes to flash without being copied (split only at record
+      // boundaries); the slot returns to the pool once all of it is
+      // programmed
+      PerfCounters::addBytes(PerfCounters::Counter::CAPTURED, slot->len);
+      processStream(s_sources[0], slot->data, slot->len);
+      submitAsync(slot->data, 0, onSlotWritten, slot);
+    }
+
+    closeCompletedBurst(s_sources[0]);
+
+    // Partial slots are committed by the transport at burst end, so a
+    // flush request only needs to persist metadata
+    if (xSemaphoreTake(s_flushSem, 0) == pdTRUE) {
+      s_storage->flushAsync();
+      portENTER_CRITICAL(&s_statsLock);
+      s_stats.flushOperations++;
+      portEXIT_CRITICAL(&s_statsLock);
+    }
+
+    if (pool->filledCount() == 0) {
+      LedManager::setDataActivity(false);
+    }
+  }
 }
 
 } // namespace DataPipeline
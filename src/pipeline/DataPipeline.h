@@ -6,6 +6,8 @@
 
 // Forward declarations
 class IDataSource;
+class IPipelineStage;
+class IStorageBackend;
 
 /**
  * @brief DataPipeline - Coordinates data capture to Flash storage
@@ -16,28 +18,108 @@ class IDataSource;
  * This achieves dual-core separation:
  * - Core 0: Transport ISR and capture task
  * - Core 1: Flash write operations
+ *
+ * Pages are handed to the FlashRing write engine asynchronously, so the
+ * writer keeps draining the transport while a page is erased/programmed.
+ * The write engine is reached through IStorageBackend (Config::storage);
+ * RecordStore frames records in place on FlashRing, so the hot tier is a
+ * FlashRingBackend and bulk media are fed from it by StorageTier.
+ *
+ * If the transport exposes a SlotPool (zero-copy mode), page-sized slots
+ * filled by the transport are written to FlashRing as-is and no
+ * intermediate write buffer is used.
+ *
+ * With compression enabled (ring buffer mode), record payloads are stored
+ * as LZ4 blocks of up to RecordStore::BLOCK_RAW_SIZE bytes; blocks that do
+ * not shrink are stored uncompressed.
+ *
+ * Up to MAX_SOURCES transports can be merged (addSource), e.g. two UARTs
+ * sniffing both directions of a link. Each source is a channel; records
+ * are tagged with it and hold data of one channel only. Pending chunks are
+ * written oldest capture time first, waiting at most mergeSkewMs for a
+ * source that has nothing pending.
+ *
+ * Chunk capture times reported by the transport (markChunk) stamp each
+ * record with the capture time of its first chunk and are stored as the
+ * record's time table (see RecordStore).
+ *
+ * With adaptiveFlush (ring buffer mode), flushes follow the ingest rate
+ * instead of the fixed flushTimeoutMs: pending data is flushed once the
+ * stream has been idle for a few average chunk gaps, and a partial page
+ * is held for about the time the current rate needs to fill it. Burst
+ * ends are coalesced into that flush. Both windows stay within
+ * [minFlushMs, maxFlushMs] and stretch to maxFlushMs while a ring buffer
+ * is backed up, so the writer spends flash time on full pages.
+ *
+ * Each channel can run its payload through a chain of IPipelineStage
+ * filters before it is stored (addStage, ring buffer mode), e.g. to drop
+ * idle fill or repeated status frames. Records then hold the filtered
+ * stream; their time marks point at the stored byte nearest to where the
+ * captured chunk ended. A record is only opened once a byte makes it
+ * through the chain.
  */
 
 namespace DataPipeline {
 
+/// Maximum merged sources (one per UART)
+constexpr size_t MAX_SOURCES = 3;
+
+/// Maximum stages per channel
+constexpr size_t MAX_STAGES = 4;
+
 /// Configuration
 struct Config {
-  size_t writeChunkSize = 12288;  ///< Buffer size (12KB) to accumulate data while writing
+  size_t writeChunkSize = 12288;  ///< Page buffer budget (12KB = 3 pages in flight, ring buffer mode)
   uint32_t flushTimeoutMs = 500; ///< Flush remaining data after this timeout
   bool autoStart = true;         ///< Start pipeline immediately
+  bool compress = false;         ///< LZ4-compress payloads (ring buffer mode only)
+  uint32_t mergeSkewMs = 20;     ///< Maximum reordering window between merged sources
+  bool adaptiveFlush = false;    ///< Flush by ingest rate instead of flushTimeoutMs (ring buffer mode)
+  uint32_t minFlushMs = 20;      ///< Adaptive: shortest idle window before a flush
+  uint32_t maxFlushMs = 2000;    ///< Adaptive: latency bound for unflushed data
+  bool waitForStorage = false;   ///< Hold flash writes until storageReady() (capture buffers in RAM)
+  IStorageBackend *storage = nullptr; ///< Hot tier the writer appends to (nullptr = FlashRing; must be a FlashRing backend)
 };
 
 /**
  * @brief Initialize the data pipeline
  *
- * Must be called after FlashRing::init() and transport source init()
+ * Must be called after FlashRing::init() and transport source init().
+ * The source becomes channel 0; the pipeline installs its own burst and
+ * chunk callbacks on it.
  *
  * @param config Configuration parameters
  * @param dataSource Pointer to initialized IDataSource transport
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if Config::storage is not
+ *         a FlashRing backend
  */
 esp_err_t init(const Config &config, IDataSource* dataSource);
 
+/**
+ * @brief Merge another transport into the pipeline
+ *
+ * Ring buffer mode only: fails with ESP_ERR_NOT_SUPPORTED if this source
+ * or the one passed to init() uses a SlotPool.
+ *
+ * @param dataSource Initialized transport
+ * @param channel    Channel assigned to it (output, optional)
+ * @return ESP_OK, or ESP_ERR_NO_MEM once MAX_SOURCES are registered
+ */
+esp_err_t addSource(IDataSource* dataSource, uint8_t* channel = nullptr);
+
+/**
+ * @brief Append a filter stage to a channel's chain
+ *
+ * Stages run in the order they are added. The stage must outlive the
+ * pipeline. Ring buffer mode only: fails with ESP_ERR_NOT_SUPPORTED if
+ * the channel's transport uses a SlotPool.
+ *
+ * @param stage   Stage to append
+ * @param channel Channel it filters
+ * @return ESP_OK, or ESP_ERR_NO_MEM once MAX_STAGES are registered
+ */
+esp_err_t addStage(IPipelineStage* stage, uint8_t channel = 0);
+
 /**
  * @brief Start the pipeline (if autoStart was false)
  */
@@ -48,11 +130,77 @@ esp_err_t start();
  */
 esp_err_t stop();
 
+/**
+ * @brief Report that FlashRing and RecordStore are initialized
+ *
+ * With Config::waitForStorage the writer leaves captured data in the
+ * transport's RAM buffers until this is called, so capture can start
+ * before the (possibly slow) flash bring-up at boot.
+ */
+void storageReady();
+
 /**
  * @brief Force flush any pending data to flash
  */
 esp_err_t flush();
 
+/**
+ * @brief Mark the end of a burst on channel 0 and flush
+ *
+ * Installed by init() as the transport BurstCallback. The writer closes the current
+ * record (see RecordStore) after @p bytesInBurst payload bytes.
+ *
+ * @param bytesInBurst Bytes the transport delivered for the burst
+ */
+esp_err_t endBurst(size_t bytesInBurst);
+
+/**
+ * @brief Report the capture time of a chunk on channel 0
+ *
+ * Installed by init() as the transport ChunkCallback; called from the
+ * capture task before the chunk is handed over. Never
+ * blocks; marks that do not fit in the queue are dropped.
+ *
+ * @param streamOffset Transport stream offset of the chunk's last byte
+ * @param timestampUs  esp_timer time the byte had been captured by
+ */
+void markChunk(uint32_t streamOffset, int64_t timestampUs);
+
+/**
+ * @brief Observer of the captured byte stream (record payload only)
+ *
+ * Runs in the flash writer task and must not block.
+ */
+using TapCallback = void (*)(const uint8_t *data, size_t len);
+
+/**
+ * @brief Install a tap on the captured stream (nullptr to remove)
+ */
+void setTapCallback(TapCallback callback);
+
+/**
+ * @brief Observer of the captured stream, split at the capture chunks
+ *
+ * Receives the payload of every channel before the filter stages, cut
+ * after the last byte of each transport chunk (see markChunk), and a call
+ * with @p len 0 at each burst end. Decoders use the chunk times to find
+ * gaps in the wire traffic. Runs in the flash writer task and must not
+ * block.
+ *
+ * @param channel    Channel of the bytes
+ * @param data       Payload bytes (nullptr at a burst end)
+ * @param len        Payload length, 0 at a burst end
+ * @param chunkEndUs Capture time of the last byte if it ended a chunk,
+ *                   0 if the chunk continues (or its mark was lost)
+ */
+using ChunkTapCallback = void (*)(uint8_t channel, const uint8_t *data,
+                                  size_t len, int64_t chunkEndUs);
+
+/**
+ * @brief Install the chunk tap (nullptr to remove)
+ */
+void setChunkTapCallback(ChunkTapCallback callback);
+
 /**
  * @brief Get pipeline statistics
  */
@@ -62,10 +210,44 @@ struct Stats {
   uint32_t writeOperations;
   uint32_t flushOperations;
   bool running;
+  uint32_t eraseStalls;         ///< Page writes that had to wait for an erase
+  uint64_t eraseStallUs;        ///< Time the write engine waited on erases
+  uint64_t stallAvoidedUs;      ///< Erase time hidden by the look-ahead window
+  uint32_t lookAheadPages;      ///< Current erase look-ahead window (pages)
+  uint32_t writeQueueHighWater; ///< Maximum page writes in flight
+  uint64_t compressInBytes;     ///< Payload bytes fed to the compressor
+  uint64_t compressOutBytes;    ///< Bytes stored for them (block headers included)
+  uint64_t stageInBytes;        ///< Payload bytes fed to the stage chains
+  uint64_t stageOutBytes;       ///< Bytes the chains passed on to be stored
+  uint32_t timeMarksLost;       ///< Chunk capture times dropped (mark queue full)
+  uint32_t sources;             ///< Merged sources (channels)
+  uint32_t ingestRateBps;       ///< Smoothed ingest rate (adaptive flush)
+  uint32_t ringFillPct;         ///< Fullest source ring buffer at the last update
+  uint32_t flushWindowMs;       ///< Current idle window before a flush
+  uint32_t flushDeadlineMs;     ///< Current hold time for a partial page
+  uint32_t flushesCoalesced;    ///< Burst-end flushes merged into a pending one
+  uint32_t deadlineFlushes;     ///< Flushes forced by a hold time or maxFlushMs
+  size_t ringHighWater;         ///< Peak fill of the fullest source ring (bytes)
+  int64_t firstByteUs;          ///< Capture time of the first byte since boot (0 = none yet)
 };
 
 esp_err_t getStats(Stats *stats);
 
+/// Figures of one stage
+struct StageStats {
+  const char *name;  ///< IPipelineStage::getName()
+  uint64_t bytesIn;  ///< Bytes fed to the stage
+  uint64_t bytesOut; ///< Bytes it passed on
+};
+
+/**
+ * @brief Get the statistics of a stage
+ * @param channel Channel of the chain
+ * @param index   Position in the chain
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND past the end of the chain
+ */
+esp_err_t getStageStats(uint8_t channel, size_t index, StageStats *stats);
+
 /**
  * @brief Reset statistics to zero
  */
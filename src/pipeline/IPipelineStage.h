@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Abstract interface for DataPipeline stream stages
+ *
+ * A stage filters or transforms the captured payload of one channel
+ * between the transport ring buffer and flash (DataPipeline::addStage),
+ * e.g. to drop idle fill before it evicts useful history. Stages run on
+ * the flash writer task and are called once per contiguous span (up to
+ * a page), never per byte.
+ *
+ * A stage may hold back up to MAX_HELD bytes while it cannot tell yet
+ * whether they are kept (a run that may still grow, a frame that may
+ * repeat the previous one). Held bytes come out of a later process()
+ * call or of endFrame(), which the pipeline calls at each burst end.
+ */
+class IPipelineStage {
+public:
+    /// Most bytes a stage may hold back between calls
+    static constexpr size_t MAX_HELD = 256;
+
+    virtual ~IPipelineStage() = default;
+
+    /**
+     * @brief Short name reported in the pipeline stats
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Process the next span of the stream
+     * @param data Input bytes
+     * @param len  Input length (> 0)
+     * @param out  Output buffer with room for len + MAX_HELD bytes; never
+     *             overlaps data
+     * @return Bytes written to out
+     */
+    virtual size_t process(const uint8_t* data, size_t len, uint8_t* out) = 0;
+
+    /**
+     * @brief End of a burst: release or discard the held bytes
+     * @param out Output buffer with room for MAX_HELD bytes
+     * @return Bytes written to out
+     */
+    virtual size_t endFrame(uint8_t* out) { (void)out; return 0; }
+};
@@ -0,0 +1,147 @@
+#include "PipelineStages.h"
+#include <algorithm>
+#include <cstring>
+
+// ============== StripStage ==============
+
+esp_err_t StripStage::init(const uint8_t* bytes, size_t count) {
+    if (!bytes || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(m_strip, 0, sizeof(m_strip));
+    for (size_t i = 0; i < count; i++) {
+        m_strip[bytes[i]] = true;
+    }
+    return ESP_OK;
+}
+
+size_t StripStage::process(const uint8_t* data, size_t len, uint8_t* out) {
+    // Branch-free: every byte is copied, stripped ones are overwritten
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        out[n] = data[i];
+        n += !m_strip[data[i]];
+    }
+    return n;
+}
+
+// ============== RunDropStage ==============
+
+esp_err_t RunDropStage::init(size_t minRun) {
+    if (minRun < 2 || minRun > MAX_HELD + 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    m_minRun = minRun;
+    m_count = 0;
+    return ESP_OK;
+}
+
+// Emit the pending run if it was too short to drop
+size_t RunDropStage::finishRun(uint8_t* out) {
+    size_t n = (m_count < m_minRun) ? m_count : 0;
+    memset(out, m_byte, n);
+    m_count = 0;
+    return n;
+}
+
+size_t RunDropStage::process(const uint8_t* data, size_t len, uint8_t* out) {
+    size_t n = 0;
+    size_t i = 0;
+    while (i < len) {
+        uint8_t byte = data[i];
+        size_t end = i + 1;
+        while (end < len && data[end] == byte) {
+            end++;
+        }
+        if (m_count == 0 || byte != m_byte) {
+            n += finishRun(out + n);
+            m_byte = byte;
+        }
+        // The last run of the span stays pending, it may continue
+        m_count = std::min(m_count + (end - i), m_minRun);
+        i = end;
+    }
+    return n;
+}
+
+size_t RunDropStage::endFrame(uint8_t* out) {
+    return finishRun(out);
+}
+
+// ============== DedupeStage ==============
+
+esp_err_t DedupeStage::init(size_t maxFrame) {
+    if (maxFrame == 0 || maxFrame > MAX_HELD) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    m_maxFrame = maxFrame;
+    m_prevLen = 0;
+    m_framesDropped = 0;
+    startFrame();
+    return ESP_OK;
+}
+
+void DedupeStage::startFrame() {
+    m_curLen = 0;
+    m_matched = 0;
+    m_matching = (m_prevLen > 0);
+}
+
+size_t DedupeStage::process(const uint8_t* data, size_t len, uint8_t* out) {
+    uint8_t* cur = m_frames[m_prev ^ 1];
+    size_t n = 0;
+
+    if (m_matching) {
+        const uint8_t* prev = m_frames[m_prev];
+        size_t limit = std::min(len, m_prevLen - m_matched);
+        size_t i = 0;
+        while (i < limit && data[i] == prev[m_matched + i]) {
+            i++;
+        }
+        m_matched += i;
+        if (i == len) {
+            return 0; // A repeat so far: hold it
+        }
+
+        // Differs or runs longer: a new frame, release what was held
+        m_matching = false;
+        memcpy(out, prev, m_matched);
+        memcpy(cur, prev, m_matched);
+        m_curLen = m_matched;
+        n = m_matched;
+        data += i;
+        len -= i;
+    }
+
+    memcpy(out + n, data, len);
+    n += len;
+    if (m_curLen + len <= m_maxFrame) {
+        memcpy(cur + m_curLen, data, len);
+    }
+    m_curLen = std::min(m_curLen + len, m_maxFrame + 1);
+    return n;
+}
+
+size_t DedupeStage::endFrame(uint8_t* out) {
+    size_t n = 0;
+    if (m_matching) {
+        if (m_matched == 0) {
+            return 0; // Empty frame
+        }
+        if (m_matched == m_prevLen) {
+            m_framesDropped++;
+        } else {
+            // A prefix of the previous frame: new, and compared next time
+            memcpy(out, m_frames[m_prev], m_matched);
+            n = m_matched;
+            m_prevLen = m_matched;
+        }
+    } else if (m_curLen <= m_maxFrame) {
+        m_prev ^= 1;
+        m_prevLen = m_curLen;
+    } else {
+        m_prevLen = 0;
+    }
+    startFrame();
+    return n;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "IPipelineStage.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief StripStage - Removes fill characters from the stream
+ *
+ * Every byte of the configured set is dropped wherever it appears (NUL
+ * padding, XON/XOFF, 0xFF line idle, ...). Holds nothing back.
+ */
+class StripStage : public IPipelineStage {
+public:
+    /**
+     * @brief Set the bytes to remove
+     * @param bytes Byte values
+     * @param count Number of values (> 0)
+     * @return ESP_OK, ESP_ERR_INVALID_ARG if the set is empty
+     */
+    esp_err_t init(const uint8_t* bytes, size_t count);
+
+    const char* getName() const override { return "strip"; }
+    size_t process(const uint8_t* data, size_t len, uint8_t* out) override;
+
+private:
+    bool m_strip[256] = {};
+};
+
+/**
+ * @brief RunDropStage - Drops runs of one repeated byte
+ *
+ * A run of at least minRun identical bytes is removed entirely; shorter
+ * runs pass unchanged. The current run is held back until a different
+ * byte or the burst end shows how long it was, so at most minRun - 1
+ * bytes are delayed.
+ */
+class RunDropStage : public IPipelineStage {
+public:
+    /**
+     * @brief Set the shortest run that is dropped
+     * @param minRun Run length, 2 to MAX_HELD + 1
+     * @return ESP_OK, ESP_ERR_INVALID_ARG if out of range
+     */
+    esp_err_t init(size_t minRun);
+
+    const char* getName() const override { return "runDrop"; }
+    size_t process(const uint8_t* data, size_t len, uint8_t* out) override;
+    size_t endFrame(uint8_t* out) override;
+
+private:
+    size_t m_minRun = 0;
+    uint8_t m_byte = 0;   // Byte of the pending run
+    size_t m_count = 0;   // Length of the pending run (capped at m_minRun)
+
+    size_t finishRun(uint8_t* out);
+};
+
+/**
+ * @brief DedupeStage - Drops bursts identical to the previous one
+ *
+ * Polls, keep-alives and status frames that repeat unchanged are stored
+ * once. Each burst (frame) of up to maxFrame bytes is compared with the
+ * previous one as it arrives: while it matches, its bytes are held back;
+ * at the first difference they are released and the frame passes
+ * unchanged. A frame that matches to its end is dropped. Longer frames
+ * are never deduplicated.
+ */
+class DedupeStage : public IPipelineStage {
+public:
+    /**
+     * @brief Set the longest frame considered
+     * @param maxFrame Frame length, 1 to MAX_HELD
+     * @return ESP_OK, ESP_ERR_INVALID_ARG if out of range
+     */
+    esp_err_t init(size_t maxFrame);
+
+    const char* getName() const override { return "dedupe"; }
+    size_t process(const uint8_t* data, size_t len, uint8_t* out) override;
+    size_t endFrame(uint8_t* out) override;
+
+    /// Frames dropped as repeats
+    uint32_t framesDropped() const { return m_framesDropped; }
+
+private:
+    size_t m_maxFrame = 0;
+    uint8_t m_frames[2][MAX_HELD] = {};  // Previous and current frame
+    size_t m_prev = 0;                   // Index of the previous frame
+    size_t m_prevLen = 0;                // 0 = nothing to compare with
+    size_t m_curLen = 0;                 // Current frame bytes (> m_maxFrame = too long)
+    size_t m_matched = 0;                // Leading bytes equal to the previous frame
+    bool m_matching = false;             // Current frame still equals the previous one
+    uint32_t m_framesDropped = 0;
+
+    void startFrame();
+};
@@ -0,0 +1,234 @@
+#include "EscPosDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+// Command prefixes
+static constexpr uint8_t DLE = 0x10;
+static constexpr uint8_t ESC = 0x1B;
+static constexpr uint8_t FS = 0x1C;
+static constexpr uint8_t GS = 0x1D;
+
+// Fixed parameter bytes after the command byte; variable-length data
+// behind them is handled in finishCommand()
+static uint8_t paramCount(uint8_t prefix, uint8_t command) {
+    switch (prefix) {
+    case ESC:
+        switch (command) {
+        case '2': case '<': case '@': case 'D': case 'L': case 'S':
+        case 'i': case 'm': case 'v':
+            return 0;
+        case '$': case '\\': case 'c': case 'B':
+            return 2;
+        case '&': case '*': case 'p':
+            return 3;
+        case 'W':
+            return 8;
+        default:
+            return 1;
+        }
+    case GS:
+        switch (command) {
+        case ':':
+            return 0;
+        case '$': case '*': case 'L': case 'P': case 'W': case '\\':
+            return 2;
+        case '(': case '^':
+            return 3;
+        case 'v':
+            return 6;
+        default:
+            return 1;
+        }
+    case FS:
+        switch (command) {
+        case '&': case '.':
+            return 0;
+        case 'S': case 'p':
+            return 2;
+        default:
+            return 1;
+        }
+    default: // DLE
+        return (command == 0x14) ? 3 : 1;
+    }
+}
+
+void EscPosDecoder::feed(const uint8_t *data, size_t len, int64_t chunkEndUs) {
+    if (chunkEndUs != 0) {
+        m_timeUs = chunkEndUs;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (m_state == State::SKIP) {
+            // Image data comes in large blocks
+            size_t n = std::min<size_t>(m_skip, len - i);
+            m_wireBytes += n;
+            m_skip -= n;
+            i += n - 1;
+            if (m_skip == 0) {
+                m_state = State::TEXT;
+            }
+            continue;
+        }
+        onByte(data[i]);
+    }
+}
+
+void EscPosDecoder::endBurst() {
+    // Text the printer still holds for its line feed
+    if (m_state == State::TEXT) {
+        emitLine();
+    }
+}
+
+void EscPosDecoder::onByte(uint8_t b) {
+    m_wireBytes++;
+    switch (m_state) {
+    case State::TEXT:
+        if (b == ESC || b == GS || b == FS || b == DLE) {
+            m_prefix = b;
+            m_state = State::COMMAND;
+        } else if (b == '\n' || b == '\f') {
+            emitLine();
+        } else if (b == '\t') {
+            onText(' ');
+        } else if (b >= 0x20 && b != 0x7F) {
+            onText(b);
+        }
+        break;
+
+    case State::COMMAND:
+        startCommand(b);
+        break;
+
+    case State::PARAMS:
+        m_params[m_paramCount++] = b;
+        if (m_paramCount == m_paramNeed) {
+            finishCommand();
+        }
+        break;
+
+    case State::UNTIL_NUL:
+        if (b == 0) {
+            m_state = State::TEXT;
+        }
+        break;
+
+    case State::SKIP:
+        break; // Handled in feed()
+    }
+}
+
+void EscPosDecoder::onText(uint8_t b) {
+    if (m_lineChars < sizeof(m_line)) {
+        m_line[m_lineChars] = b;
+    }
+    m_lineChars++;
+}
+
+void EscPosDecoder::startCommand(uint8_t command) {
+    m_command = command;
+    m_paramCount = 0;
+    m_paramNeed = std::min<uint8_t>(paramCount(m_prefix, command),
+                                    sizeof(m_params));
+    if (m_paramNeed > 0) {
+        m_state = State::PARAMS;
+    } else {
+        finishCommand();
+    }
+}
+
+// Act on a command whose fixed parameters are complete
+void EscPosDecoder::finishCommand() {
+    const uint8_t *p = m_params;
+    m_state = State::TEXT;
+    m_skip = 0;
+
+    if (m_prefix == ESC) {
+        switch (m_command) {
+        case '*': // Bit image: columns of 1 or 3 bytes
+            m_skip = (uint32_t)(p[1] | p[2] << 8) * ((p[0] & 0x20) ? 3 : 1);
+            break;
+        case 'D': // Tab positions
+            m_state = State::UNTIL_NUL;
+            break;
+        case 'd': // Print and feed
+        case 'J':
+            emitLine();
+            break;
+        case 'i': // Cut (obsolete form)
+        case 'm':
+            emitLine();
+            emitEvent(FrameKind::ESCPOS_CUT, 0, m_receiptLines);
+            m_receiptLines = 0;
+            break;
+        case 'p': // Drawer kick: pin, on time
+            emitEvent(FrameKind::ESCPOS_DRAWER, p[0] & 0x01, p[1]);
+            break;
+        }
+    } else if (m_prefix == GS) {
+        switch (m_command) {
+        case '(': // Extended function: pL pH bytes after the fn byte
+            m_skip = (uint32_t)(p[1] | p[2] << 8);
+            break;
+        case '*': // Downloaded bit image
+            m_skip = (uint32_t)p[0] * p[1] * 8;
+            break;
+        case 'v': // Raster image: (xL xH) bytes x (yL yH) rows
+            m_skip = (uint32_t)(p[2] | p[3] << 8) * (uint32_t)(p[4] | p[5] << 8);
+            break;
+        case 'k': // Barcode: NUL-terminated (m <= 6) or counted data
+            if (p[0] <= 6) {
+                m_state = State::UNTIL_NUL;
+            } else if (m_paramCount == 1) {
+                m_paramNeed = 2;
+                m_state = State::PARAMS;
+            } else {
+                m_skip = p[1];
+            }
+            break;
+        case 'V': // Cut, with a feed amount for some modes
+            if (m_paramCount == 1 && (p[0] == 65 || p[0] == 66 || p[0] == 97 ||
+                                      p[0] == 98 || p[0] == 103 || p[0] == 104)) {
+                m_paramNeed = 2;
+                m_state = State::PARAMS;
+                break;
+            }
+            emitLine();
+            emitEvent(FrameKind::ESCPOS_CUT, 0, m_receiptLines);
+            m_receiptLines = 0;
+            break;
+        }
+    }
+
+    if (m_skip > 0) {
+        m_state = State::SKIP;
+    }
+}
+
+void EscPosDecoder::emitLine() {
+    if (m_lineChars == 0) {
+        return;
+    }
+    DecodedFrame frame = {};
+    frame.timeUs = m_timeUs;
+    frame.kind = FrameKind::ESCPOS_LINE;
+    frame.wireLength = (uint16_t)std::min<uint32_t>(m_wireBytes, UINT16_MAX);
+    frame.value = m_lineChars;
+    frame.dataLen = (uint8_t)std::min<size_t>(m_lineChars, sizeof(m_line));
+    memcpy(frame.data, m_line, frame.dataLen);
+    m_lineChars = 0;
+    m_wireBytes = 0;
+    m_receiptLines++;
+    emit(frame);
+}
+
+void EscPosDecoder::emitEvent(FrameKind kind, uint8_t address, uint32_t value) {
+    DecodedFrame frame = {};
+    frame.timeUs = m_timeUs;
+    frame.kind = kind;
+    frame.wireLength = (uint16_t)std::min<uint32_t>(m_wireBytes, UINT16_MAX);
+    frame.address = address;
+    frame.value = value;
+    m_wireBytes = 0;
+    emit(frame);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "FrameDecoder.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief EscPosDecoder - Receipt text and events from ESC/POS printer data
+ *
+ * Follows the printer command stream: ESC, GS, FS and DLE commands are
+ * skipped with their parameters, including the variable-length ones
+ * (raster and bit images, barcodes, GS ( functions), so image data is
+ * never taken for text. What remains is the printed text, reported one
+ * ESCPOS_LINE per line feed, an ESCPOS_CUT at each paper cut (the end of
+ * a receipt) and an ESCPOS_DRAWER for each cash drawer kick.
+ *
+ * Empty lines produce no record. Characters are reported as received
+ * (the printer code page is not translated).
+ */
+class EscPosDecoder : public FrameDecoder {
+public:
+    const char* getName() const override { return "escpos"; }
+    void feed(const uint8_t* data, size_t len, int64_t chunkEndUs) override;
+    void endBurst() override;
+
+private:
+    enum class State : uint8_t {
+        TEXT,       // Printable data
+        COMMAND,    // Prefix seen, command byte next
+        PARAMS,     // Collecting the fixed parameters
+        SKIP,       // Skipping image or barcode data
+        UNTIL_NUL   // Skipping up to a NUL terminator
+    };
+
+    State m_state = State::TEXT;
+    uint8_t m_prefix = 0;          // ESC, GS, FS or DLE
+    uint8_t m_command = 0;
+    uint8_t m_params[6] = {};
+    uint8_t m_paramCount = 0;
+    uint8_t m_paramNeed = 0;
+    uint32_t m_skip = 0;
+
+    uint8_t m_line[sizeof(DecodedFrame::data)];
+    uint32_t m_lineChars = 0;      // Characters of the line (may exceed m_line)
+    uint32_t m_wireBytes = 0;      // Bytes since the previous record
+    uint32_t m_receiptLines = 0;   // Lines since the previous cut
+    int64_t m_timeUs = 0;          // Capture time of the current chunk
+
+    void onByte(uint8_t b);
+    void onText(uint8_t b);
+    void startCommand(uint8_t command);
+    void finishCommand();
+    void emitLine();
+    void emitEvent(FrameKind kind, uint8_t address, uint32_t value);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Record types produced by the decoders
+enum class FrameKind : uint8_t {
+    MODBUS_REQUEST = 1,    ///< Master request
+    MODBUS_RESPONSE = 2,   ///< Slave response
+    MODBUS_EXCEPTION = 3,  ///< Slave exception response
+    ESCPOS_LINE = 16,      ///< Printed text line
+    ESCPOS_CUT = 17,       ///< Paper cut (end of a receipt)
+    ESCPOS_DRAWER = 18     ///< Cash drawer kick
+};
+
+/**
+ * @brief Compact structured record of one decoded protocol frame
+ *
+ * Field meaning depends on the kind:
+ * - Modbus: address and function code; data holds the PDU after the
+ *   function code; value is the first register (requests with one) or
+ *   the exception code.
+ * - ESC/POS line: data holds the first text bytes, value the line length.
+ * - ESC/POS cut: value is the number of lines since the previous cut.
+ * - ESC/POS drawer: address is the pin, value the pulse on time (x 2 ms).
+ */
+struct DecodedFrame {
+    int64_t timeUs;         ///< Capture time of the last byte, 0 if unknown
+    uint32_t value;         ///< Kind specific, see above
+    uint16_t wireLength;    ///< Bytes the frame took on the wire
+    uint8_t channel;        ///< DataPipeline channel
+    FrameKind kind;
+    uint8_t address;
+    uint8_t function;
+    uint8_t dataLen;        ///< Valid bytes in data
+    uint8_t data[32];       ///< Payload, truncated
+};
+
+/**
+ * @brief Base class of the protocol decoders (see FrameDecoders)
+ *
+ * A decoder turns the raw capture of one channel into DecodedFrame
+ * records. It is fed the stream split at the transport chunks, with the
+ * capture time of each chunk end, so decoders can use the inter-character
+ * timing of the line and not just the bytes. Decoders run on the flash
+ * writer task and must not block.
+ */
+class FrameDecoder {
+public:
+    /// Receives each decoded frame
+    typedef void (*OutputCallback)(const DecodedFrame& frame, void* ctx);
+
+    virtual ~FrameDecoder() = default;
+
+    /**
+     * @brief Protocol name reported in the records and stats
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Process the next received bytes
+     * @param data       Bytes
+     * @param len        Length (> 0)
+     * @param chunkEndUs Capture time of the last byte if it ended a
+     *                   transport chunk, 0 if the chunk continues
+     */
+    virtual void feed(const uint8_t* data, size_t len, int64_t chunkEndUs) = 0;
+
+    /**
+     * @brief The line went idle: finish or discard any partial frame
+     */
+    virtual void endBurst() {}
+
+    /**
+     * @brief Set where frames go and the channel they are tagged with
+     */
+    void setOutput(OutputCallback callback, void* ctx, uint8_t channel) {
+        m_output = callback;
+        m_outputCtx = ctx;
+        m_channel = channel;
+    }
+
+    /// Frames decoded
+    uint32_t framesDecoded() const { return m_frames; }
+
+    /// Bytes that did not belong to any frame
+    uint32_t bytesDiscarded() const { return m_bytesDiscarded; }
+
+protected:
+    uint32_t m_frames = 0;
+    uint32_t m_bytesDiscarded = 0;
+
+    /// Tag and hand out a frame
+    void emit(DecodedFrame& frame) {
+        frame.channel = m_channel;
+        m_frames++;
+        if (m_output) {
+            m_output(frame, m_outputCtx);
+        }
+    }
+
+private:
+    OutputCallback m_output = nullptr;
+    void* m_outputCtx = nullptr;
+    uint8_t m_channel = 0;
+};
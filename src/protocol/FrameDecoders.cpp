@@ -0,0 +1,308 @@
+#include "FrameDecoders.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "pipeline/DataPipeline.h"
+#include <cstring>
+
+static const char *TAG = "FrameDecoders";
+
+// Frames waiting for the consumer task
+static const size_t FRAME_QUEUE_DEPTH = 32;
+
+// Publish a batch this long after its first frame at the latest
+static const uint32_t BATCH_INTERVAL_MS = 1000;
+
+// Batch message: {"frames":[...]}
+static const char BATCH_PREFIX[] = "{\"frames\":[";
+static const char BATCH_SUFFIX[] = "]}";
+static const size_t BATCH_SIZE = 1024;
+
+namespace FrameDecoders {
+
+static FrameDecoder *volatile s_decoders[DataPipeline::MAX_SOURCES] = {};
+static QueueHandle_t s_queue = nullptr;
+static bool s_initialized = false;
+
+static DecodedFrame s_recent[RECENT_FRAMES] = {};
+static size_t s_recentHead = 0; // Next slot to write
+static size_t s_recentCount = 0;
+static SemaphoreHandle_t s_recentMutex = nullptr;
+
+static MqttManager *volatile s_mqtt = nullptr;
+static char s_topic[64] = {};
+
+// Batch being built by the consumer task
+static char s_batch[BATCH_SIZE];
+static size_t s_batchLen = 0;
+static uint32_t s_batchFrames = 0;
+static TickType_t s_batchStart = 0;
+
+static Stats s_stats = {};
+static portMUX_TYPE s_statsLock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *kindName(FrameKind kind) {
+  switch (kind) {
+  case FrameKind::MODBUS_REQUEST:
+    return "request";
+  case FrameKind::MODBUS_RESPONSE:
+    return "response";
+  case FrameKind::MODBUS_EXCEPTION:
+    return "exception";
+  case FrameKind::ESCPOS_LINE:
+    return "line";
+  case FrameKind::ESCPOS_CUT:
+    return "cut";
+  case FrameKind::ESCPOS_DRAWER:
+    return "drawer";
+  }
+  return "unknown";
+}
+
+void writeFrame(const DecodedFrame &frame, JsonWriter &json) {
+  static const char HEX[] = "0123456789ABCDEF";
+
+  json.beginObject();
+  json.field("t", (long long)(frame.timeUs / 1000));
+  json.field("ch", frame.channel);
+  bool modbus = frame.kind <= FrameKind::MODBUS_EXCEPTION;
+  json.field("proto", modbus ? "modbus" : "escpos");
+  json.field("kind", kindName(frame.kind));
+  json.field("len", frame.wireLength);
+
+  switch (frame.kind) {
+  case FrameKind::MODBUS_REQUEST:
+  case FrameKind::MODBUS_RESPONSE:
+  case FrameKind::MODBUS_EXCEPTION: {
+    json.field("addr", frame.address);
+    json.field("fn", frame.function & 0x7F);
+    uint8_t fn = frame.function;
+    if (frame.kind == FrameKind::MODBUS_EXCEPTION) {
+      json.field("code", frame.value);
+    } else if (frame.kind == FrameKind::MODBUS_REQUEST &&
+               (fn <= 6 || fn == 15 || fn == 16 || fn == 23)) {
+      json.field("reg", frame.value);
+    }
+    char hex[2 * sizeof(frame.data)];
+    for (size_t i = 0; i < frame.dataLen; i++) {
+      hex[2 * i] = HEX[frame.data[i] >> 4];
+      hex[2 * i + 1] = HEX[frame.data[i] & 0x0F];
+    }
+    json.key("data");
+    json.value(hex, 2 * frame.dataLen);
+    break;
+  }
+  case FrameKind::ESCPOS_LINE: {
+    // The printer code page is unknown: non-ASCII shows as '?'
+    char text[sizeof(frame.data)];
+    for (size_t i = 0; i < frame.dataLen; i++) {
+      text[i] = (frame.data[i] < 0x80) ? (char)frame.data[i] : '?';
+    }
+    json.key("text");
+    json.value(text, frame.dataLen);
+    json.field("chars", frame.value);
+    break;
+  }
+  case FrameKind::ESCPOS_CUT:
+    json.field("lines", frame.value);
+    break;
+  case FrameKind::ESCPOS_DRAWER:
+    json.field("pin", frame.address);
+    json.field("pulseMs", frame.value * 2);
+    break;
+  }
+  json.endObject();
+}
+
+// Hand the open batch to MQTT
+static void publishBatch() {
+  if (s_batchFrames == 0) {
+    return;
+  }
+  memcpy(s_batch + s_batchLen, BATCH_SUFFIX, sizeof(BATCH_SUFFIX) - 1);
+  size_t len = s_batchLen + sizeof(BATCH_SUFFIX) - 1;
+
+  MqttManager *mqtt = s_mqtt;
+  bool sent = mqtt && mqtt->isConnected() &&
+              mqtt->sendBinary(s_topic, (const uint8_t *)s_batch, len, 0,
+                               nullptr) == ESP_OK;
+  portENTER_CRITICAL(&s_statsLock);
+  if (sent) {
+    s_stats.framesPublished += s_batchFrames;
+    s_stats.batchesPublished++;
+  } else {
+    s_stats.framesUnsent += s_batchFrames;
+  }
+  portEXIT_CRITICAL(&s_statsLock);
+  s_batchFrames = 0;
+}
+
+// Append a frame to the batch, publishing first if it does not fit
+static void addToBatch(const DecodedFrame &frame) {
+  char obj[256];
+  JsonWriter json(obj, sizeof(obj));
+  writeFrame(frame, json);
+  if (json.finish() != ESP_OK) {
+    return;
+  }
+  size_t len = json.length();
+
+  if (s_batchFrames > 0 &&
+      s_batchLen + 1 + len + sizeof(BATCH_SUFFIX) - 1 > sizeof(s_batch)) {
+    publishBatch();
+  }
+  if (s_batchFrames == 0) {
+    memcpy(s_batch, BATCH_PREFIX, sizeof(BATCH_PREFIX) - 1);
+    s_batchLen = sizeof(BATCH_PREFIX) - 1;
+    s_batchStart = xTaskGetTickCount();
+  } else {
+    s_batch[s_batchLen++] = ',';
+  }
+  memcpy(s_batch + s_batchLen, obj, len);
+  s_batchLen += len;
+  s_batchFrames++;
+}
+
+static void consumerTask(void *arg) {
+  DecodedFrame frame;
+  while (true) {
+    TickType_t wait = portMAX_DELAY;
+    if (s_batchFrames > 0) {
+      TickType_t age = xTaskGetTickCount() - s_batchStart;
+      TickType_t interval = pdMS_TO_TICKS(BATCH_INTERVAL_MS);
+      wait = (age < interval) ? interval - age : 0;
+    }
+
+    if (xQueueReceive(s_queue, &frame, wait) != pdTRUE) {
+      publishBatch();
+      continue;
+    }
+
+    xSemaphoreTake(s_recentMutex, portMAX_DELAY);
+    s_recent[s_recentHead] = frame;
+    s_recentHead = (s_recentHead + 1) % RECENT_FRAMES;
+    if (s_recentCount < RECENT_FRAMES) {
+      s_recentCount++;
+    }
+    xSemaphoreGive(s_recentMutex);
+
+    if (s_mqtt) {
+      addToBatch(frame);
+    }
+  }
+}
+
+// Decoder output, on the flash writer task
+static void onFrame(const DecodedFrame &frame, void *ctx) {
+  (void)ctx;
+  DecodedFrame timed = frame;
+  if (timed.timeUs == 0) {
+    timed.timeUs = esp_timer_get_time(); // Chunk mark lost
+  }
+  if (xQueueSend(s_queue, &timed, 0) != pdTRUE) {
+    portENTER_CRITICAL(&s_statsLock);
+    s_stats.framesDropped++;
+    portEXIT_CRITICAL(&s_statsLock);
+  }
+}
+
+// DataPipeline chunk tap, on the flash writer task
+static void onChunk(uint8_t channel, const uint8_t *data, size_t len,
+                    int64_t chunkEndUs) {
+  FrameDecoder *decoder =
+      (channel < DataPipeline::MAX_SOURCES) ? s_decoders[channel] : nullptr;
+  if (!decoder) {
+    return;
+  }
+  if (len == 0) {
+    decoder->endBurst();
+    return;
+  }
+  decoder->feed(data, len, chunkEndUs);
+  portENTER_CRITICAL(&s_statsLock);
+  s_stats.bytesIn += len;
+  portEXIT_CRITICAL(&s_statsLock);
+}
+
+esp_err_t init() {
+  if (s_initialized) {
+    return ESP_OK;
+  }
+  s_queue = xQueueCreate(FRAME_QUEUE_DEPTH, sizeof(DecodedFrame));
+  s_recentMutex = xSemaphoreCreateMutex();
+  if (!s_queue || !s_recentMutex) {
+    ESP_LOGE(TAG, "Failed to create queue");
+    return ESP_ERR_NO_MEM;
+  }
+  // Idle + 3, like the MQTT uplink; the decoders themselves run on the writer
+  if (xTaskCreate(consumerTask, "frame_dec", 3584, nullptr,
+                  tskIDLE_PRIORITY + 3, nullptr) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create task");
+    return ESP_ERR_NO_MEM;
+  }
+  DataPipeline::setChunkTapCallback(onChunk);
+  s_initialized = true;
+  return ESP_OK;
+}
+
+esp_err_t setDecoder(uint8_t channel, FrameDecoder *decoder) {
+  if (channel >= DataPipeline::MAX_SOURCES) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (decoder) {
+    decoder->setOutput(onFrame, nullptr, channel);
+    ESP_LOGI(TAG, "Channel %u: %s decoder", channel, decoder->getName());
+  }
+  s_decoders[channel] = decoder;
+  return ESP_OK;
+}
+
+void setPublisher(MqttManager *mqtt, const char *topic) {
+  if (mqtt && topic) {
+    strncpy(s_topic, topic, sizeof(s_topic) - 1);
+    ESP_LOGI(TAG, "Publishing decoded frames on %s", s_topic);
+  }
+  s_mqtt = mqtt;
+}
+
+size_t getRecent(DecodedFrame *frames, size_t maxFrames) {
+  if (!frames || !s_recentMutex) {
+    return 0;
+  }
+  xSemaphoreTake(s_recentMutex, portMAX_DELAY);
+  size_t count = (s_recentCount < maxFrames) ? s_recentCount : maxFrames;
+  size_t first = (s_recentHead + RECENT_FRAMES - count) % RECENT_FRAMES;
+  for (size_t i = 0; i < count; i++) {
+    frames[i] = s_recent[(first + i) % RECENT_FRAMES];
+  }
+  xSemaphoreGive(s_recentMutex);
+  return count;
+}
+
+const char *getDecoderName(uint8_t channel) {
+  FrameDecoder *decoder =
+      (channel < DataPipeline::MAX_SOURCES) ? s_decoders[channel] : nullptr;
+  return decoder ? decoder->getName() : nullptr;
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  portENTER_CRITICAL(&s_statsLock);
+  *stats = s_stats;
+  portEXIT_CRITICAL(&s_statsLock);
+  for (size_t i = 0; i < DataPipeline::MAX_SOURCES; i++) {
+    FrameDecoder *decoder = s_decoders[i];
+    if (decoder) {
+      stats->frames += decoder->framesDecoded();
+      stats->bytesDiscarded += decoder->bytesDiscarded();
+    }
+  }
+  return ESP_OK;
+}
+
+} // namespace FrameDecoders
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "FrameDecoder.h"
+#include "esp_err.h"
+#include "mqtt/MqttManager.h"
+#include "utils/JsonWriter.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief FrameDecoders - Protocol decoding of the captured channels
+ *
+ * Runs a FrameDecoder per DataPipeline channel on the same chunks that
+ * are stored (the pipeline chunk tap, before the filter stages), so the
+ * backend can receive a few bytes of meaning per frame instead of
+ * re-parsing the raw capture. The raw data is still stored as before.
+ *
+ * Decoders run on the flash writer task and hand their frames to a queue;
+ * a consumer task at idle + 3 keeps the most recent ones for getRecent()
+ * and, with a publisher set, sends them as JSON batches on their own MQTT
+ * topic:
+ *
+ *   {"frames":[{"t":1234,"ch":0,"proto":"modbus","kind":"request",...}]}
+ *
+ * A batch goes out when it is full (about 1 KB) or a second after its
+ * first frame. Frames are dropped, never waited for, when the queue is
+ * full or MQTT is not connected; the raw capture keeps them anyway.
+ */
+namespace FrameDecoders {
+
+/// Frames kept for getRecent()
+constexpr size_t RECENT_FRAMES = 32;
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint64_t bytesIn;          ///< Bytes fed to the decoders
+    uint32_t bytesDiscarded;   ///< Bytes that belonged to no frame
+    uint32_t frames;           ///< Frames decoded
+    uint32_t framesDropped;    ///< Lost because the queue was full
+    uint32_t framesPublished;  ///< Frames in batches handed to MQTT
+    uint32_t batchesPublished; ///< Batches handed to MQTT
+    uint32_t framesUnsent;     ///< Not published (offline, outbox full)
+};
+
+/**
+ * @brief Start the consumer task and install the pipeline chunk tap
+ *
+ * Must be called after DataPipeline::init().
+ */
+esp_err_t init();
+
+/**
+ * @brief Set the decoder of a channel (nullptr for none)
+ *
+ * Call before the channel carries data; the decoder must outlive the
+ * pipeline.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a channel out of range
+ */
+esp_err_t setDecoder(uint8_t channel, FrameDecoder* decoder);
+
+/**
+ * @brief Publish the decoded frames on @p topic (nullptr mqtt to stop)
+ */
+void setPublisher(MqttManager* mqtt, const char* topic);
+
+/**
+ * @brief Copy the most recent frames, oldest first
+ * @return Frames copied
+ */
+size_t getRecent(DecodedFrame* frames, size_t maxFrames);
+
+/**
+ * @brief Name of the decoder of a channel, nullptr if it has none
+ */
+const char* getDecoderName(uint8_t channel);
+
+/**
+ * @brief Get decoding statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+/**
+ * @brief Write a frame as a JSON object (the batch format)
+ */
+void writeFrame(const DecodedFrame& frame, JsonWriter& json);
+
+} // namespace FrameDecoders
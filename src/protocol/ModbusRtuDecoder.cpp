@@ -0,0 +1,215 @@
+#include "ModbusRtuDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+// Address, function code and CRC
+static constexpr size_t MIN_FRAME = 4;
+
+// Highest unicast address (0 is broadcast)
+static constexpr uint8_t MAX_ADDRESS = 247;
+
+// Above this rate the inter-frame silence is fixed
+static constexpr uint32_t FIXED_GAP_BAUD = 19200;
+static constexpr uint32_t FIXED_GAP_US = 1750;
+
+// Modbus CRC-16 (polynomial 0xA001 reflected, initial 0xFFFF)
+static uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+// Length of a request frame, 0 for an unknown function; more than
+// @p avail if the byte count has not been received yet
+static size_t requestLength(const uint8_t *f, size_t avail) {
+    switch (f[1]) {
+    case 1: case 2: case 3: case 4: case 5: case 6: // Read / write single
+    case 8:                                         // Diagnostics
+        return 8;
+    case 7: case 11: case 12: case 17:              // No data
+        return 4;
+    case 15: case 16:                               // Write multiple
+        return (avail > 6) ? 9 + f[6] : avail + 1;
+    case 22:                                        // Mask write register
+        return 10;
+    case 23:                                        // Read/write multiple
+        return (avail > 10) ? 13 + f[10] : avail + 1;
+    default:
+        return 0;
+    }
+}
+
+// Length of a response frame, as requestLength()
+static size_t responseLength(const uint8_t *f, size_t avail) {
+    if (f[1] & 0x80) {
+        // Exception: only for functions a slave can answer
+        uint8_t base[2] = {f[0], (uint8_t)(f[1] & 0x7F)};
+        return (requestLength(base, MIN_FRAME) != 0) ? 5 : 0;
+    }
+    switch (f[1]) {
+    case 1: case 2: case 3: case 4: case 12: case 17: case 23: // Byte count
+        return (avail > 2) ? 5 + f[2] : avail + 1;
+    case 5: case 6: case 8: case 11: case 15: case 16:
+        return 8;
+    case 7:
+        return 5;
+    case 22:
+        return 10;
+    default:
+        return 0;
+    }
+}
+
+esp_err_t ModbusRtuDecoder::init(uint32_t baudRate, uint8_t bitsPerChar,
+                                 uint8_t idleChars) {
+    if (baudRate == 0 || bitsPerChar == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    m_charNs = (uint32_t)(bitsPerChar * 1000000000ULL / baudRate);
+    // 3.5 characters
+    uint32_t silenceUs = (baudRate > FIXED_GAP_BAUD)
+                             ? FIXED_GAP_US
+                             : (uint32_t)(7ULL * m_charNs / 2000);
+    m_gapUs = silenceUs + (uint32_t)charsUs(idleChars);
+    m_len = 0;
+    m_chunkBytes = 0;
+    m_lastChunkEndUs = 0;
+    m_awaiting = false;
+    return ESP_OK;
+}
+
+ModbusRtuDecoder::Match ModbusRtuDecoder::match(const uint8_t *f, size_t avail,
+                                                size_t *length,
+                                                FrameKind *kind) const {
+    if (avail > 0 && f[0] > MAX_ADDRESS) {
+        return Match::NONE;
+    }
+    if (avail < MIN_FRAME) {
+        return Match::NEED_MORE;
+    }
+
+    // Try the layout the last request makes likely first
+    bool reply = m_awaiting && f[0] == m_awaitAddress &&
+                 (f[1] & 0x7F) == m_awaitFunction;
+    size_t lengths[2] = {requestLength(f, avail),
+                         (f[0] != 0) ? responseLength(f, avail) : 0};
+    bool needMore = false;
+    for (size_t i = 0; i < 2; i++) {
+        size_t which = reply ? 1 - i : i;
+        size_t len = lengths[which];
+        if (len == 0) {
+            continue;
+        }
+        if (len > avail) {
+            needMore = true;
+            continue;
+        }
+        uint16_t crc = crc16(f, len - 2);
+        if (f[len - 2] == (crc & 0xFF) && f[len - 1] == (crc >> 8)) {
+            *length = len;
+            *kind = (which == 0)     ? FrameKind::MODBUS_REQUEST
+                    : (f[1] & 0x80) ? FrameKind::MODBUS_EXCEPTION
+                                    : FrameKind::MODBUS_RESPONSE;
+            return Match::FOUND;
+        }
+    }
+    return needMore ? Match::NEED_MORE : Match::NONE;
+}
+
+void ModbusRtuDecoder::emitFrame(const uint8_t *f, size_t length,
+                                 FrameKind kind, int64_t timeUs) {
+    DecodedFrame frame = {};
+    frame.timeUs = timeUs;
+    frame.wireLength = (uint16_t)length;
+    frame.kind = kind;
+    frame.address = f[0];
+    frame.function = f[1];
+    frame.dataLen = (uint8_t)std::min(length - MIN_FRAME, sizeof(frame.data));
+    memcpy(frame.data, f + 2, frame.dataLen);
+
+    if (kind == FrameKind::MODBUS_EXCEPTION) {
+        frame.value = f[2];
+    } else if (kind == FrameKind::MODBUS_REQUEST &&
+               (f[1] <= 6 || f[1] == 15 || f[1] == 16 || f[1] == 23)) {
+        frame.value = (uint32_t)(f[2] << 8 | f[3]); // First register / coil
+    }
+
+    if (kind == FrameKind::MODBUS_REQUEST) {
+        m_awaiting = (f[0] != 0); // Broadcasts get no response
+        m_awaitAddress = f[0];
+        m_awaitFunction = f[1];
+    } else {
+        m_awaiting = false;
+    }
+    emit(frame);
+}
+
+// Decode the frames among the first @p end buffered bytes, the last of
+// which was captured at @p endUs. With @p closed no frame continues past
+// them and whatever is left is discarded.
+void ModbusRtuDecoder::parse(size_t end, int64_t endUs, bool closed) {
+    size_t pos = 0;
+    while (pos < end) {
+        size_t avail = end - pos;
+        const uint8_t *f = m_buf + pos;
+        size_t length = 0;
+        FrameKind kind;
+        Match result = match(f, avail, &length, &kind);
+        if (result == Match::FOUND) {
+            pos += length;
+            emitFrame(f, length, kind,
+                      endUs ? endUs - charsUs(end - pos) : 0);
+            continue;
+        }
+        if (result == Match::NEED_MORE && !closed && avail < MAX_FRAME) {
+            break;
+        }
+        // No frame starts here: resynchronise on the next byte
+        pos++;
+        m_bytesDiscarded++;
+    }
+
+    memmove(m_buf, m_buf + pos, m_len - pos);
+    m_len -= pos;
+}
+
+void ModbusRtuDecoder::feed(const uint8_t *data, size_t len,
+                            int64_t chunkEndUs) {
+    while (len > 0) {
+        size_t n = std::min(len, BUFFER_SIZE - m_len);
+        memcpy(m_buf + m_len, data, n);
+        m_len += n;
+        m_chunkBytes += n;
+        data += n;
+        len -= n;
+        if (m_len == BUFFER_SIZE) {
+            // Leaves less than a frame pending
+            parse(m_len, 0, false);
+        }
+    }
+    if (chunkEndUs == 0) {
+        return;
+    }
+
+    // Bytes left from before a gap in front of this chunk cannot be
+    // completed by it
+    size_t before = m_len - std::min(m_chunkBytes, m_len);
+    int64_t startUs = chunkEndUs - charsUs(m_chunkBytes);
+    if (before > 0 && m_lastChunkEndUs != 0 &&
+        startUs - m_lastChunkEndUs > (int64_t)m_gapUs) {
+        parse(before, m_lastChunkEndUs, true);
+    }
+    m_lastChunkEndUs = chunkEndUs;
+    m_chunkBytes = 0;
+    parse(m_len, chunkEndUs, false);
+}
+
+void ModbusRtuDecoder::endBurst() {
+    parse(m_len, m_lastChunkEndUs, true);
+    m_chunkBytes = 0;
+}
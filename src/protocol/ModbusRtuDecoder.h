@@ -0,0 +1,68 @@
+#pragma once
+
+#include "FrameDecoder.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief ModbusRtuDecoder - Modbus RTU frames from a passive line capture
+ *
+ * RTU frames are delimited by at least 3.5 character times of silence
+ * (a fixed 1750 us above 19200 baud). The capture does not time single
+ * bytes, so the gap in front of each transport chunk is estimated from
+ * the chunk end times and the character time. A chunk end is reported up
+ * to the UART RX timeout after its last byte, so only gaps longer than
+ * the silence plus that timeout are certain; frames never span them,
+ * which bounds resynchronisation after noise.
+ *
+ * Within the bytes between gaps, frames are found by their length (from
+ * the function code, and the byte count where there is one) and a valid
+ * CRC-16. Bytes that start no valid frame are discarded one at a time.
+ * Whether a frame is a request or a response follows from which layout
+ * matches, and for functions where both have the same layout (write
+ * single coil/register, diagnostics) from the last request seen.
+ */
+class ModbusRtuDecoder : public FrameDecoder {
+public:
+    /// Longest RTU frame (ADU)
+    static constexpr size_t MAX_FRAME = 256;
+
+    /**
+     * @brief Set the line timing
+     * @param baudRate    Line baud rate
+     * @param bitsPerChar Bits per character including start, parity and
+     *                    stop bits (11 for 8E1 / 8N2, 10 for 8N1)
+     * @param idleChars   Capture RX timeout in characters (10 is the UART
+     *                    driver default)
+     * @return ESP_OK, ESP_ERR_INVALID_ARG if baudRate or bitsPerChar is 0
+     */
+    esp_err_t init(uint32_t baudRate, uint8_t bitsPerChar = 11,
+                   uint8_t idleChars = 10);
+
+    const char* getName() const override { return "modbus"; }
+    void feed(const uint8_t* data, size_t len, int64_t chunkEndUs) override;
+    void endBurst() override;
+
+private:
+    // Bytes kept while frames are incomplete; twice the longest frame so
+    // that a full buffer can always discard its head
+    static constexpr size_t BUFFER_SIZE = 2 * MAX_FRAME;
+
+    enum class Match { FOUND, NEED_MORE, NONE };
+
+    uint32_t m_charNs = 0;         // Character time
+    uint32_t m_gapUs = 0;          // Estimated gap that surely separates frames
+    uint8_t m_buf[BUFFER_SIZE];
+    size_t m_len = 0;
+    size_t m_chunkBytes = 0;       // Bytes of the current chunk so far
+    int64_t m_lastChunkEndUs = 0;  // 0 until the first timed chunk
+    bool m_awaiting = false;       // A request is waiting for its response
+    uint8_t m_awaitAddress = 0;
+    uint8_t m_awaitFunction = 0;
+
+    void parse(size_t end, int64_t endUs, bool closed);
+    Match match(const uint8_t* f, size_t avail, size_t* length, FrameKind* kind) const;
+    void emitFrame(const uint8_t* f, size_t length, FrameKind kind, int64_t timeUs);
+    int64_t charsUs(size_t chars) const { return (int64_t)chars * m_charNs / 1000; }
+};
@@ -1,46 +1,192 @@
 #include "FlashRing.h"
+#include "../utils/Housekeeping.h"
+#include "../utils/MemoryPlan.h"
+#include "../utils/PerfCounters.h"
+#include "esp_crc.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs.h"
-#include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
 
 static const char *TAG = "FlashRing";
 
-// NVS namespace and keys
-static const char *NVS_NAMESPACE = "flashring";
-static const char *NVS_KEY_META = "meta";
+// Metadata used to live in NVS; the stale blob is dropped on first boot
+static const char *LEGACY_NVS_NAMESPACE = "flashring";
+static const char *LEGACY_NVS_KEY_META = "meta";
 
 // Magic number for validation
-static const uint32_t MAGIC_NUMBER = 0x464C5249; // "FLRI" (new version with pre-erase)
+static const uint32_t MAGIC_NUMBER = 0x464C5233; // "FLR3" (journaled metadata)
+
+// Journal entry marker for cursor records ("CUR1")
+static const uint32_t CURSOR_MAGIC = 0x31525543;
+
+// Journaled position of a closed cursor
+static const uint64_t CURSOR_CLOSED = UINT64_MAX;
+
+// Journal entry flag (flags are kept set in blank flash): the head page
+// came from the erase window, so recovery may scan it for data programmed
+// after the entry. Cleared while the head waits on a page boundary for a
+// page that still holds old data.
+static const uint32_t ENTRY_HEAD_PAGE_OPEN = 1u << 0;
+
+// Initial estimate for one 4KB sector erase, refined at runtime
+static const uint32_t DEFAULT_ERASE_US = 45000;
+
+// Pre-erase retry while the next page still holds unread data, or after a
+// failed erase
+static const uint32_t ERASE_RETRY_MS = 100;
 
 namespace FlashRing {
 
+/// Queued write (data == nullptr requests a metadata flush)
+struct WriteRequest {
+  const uint8_t *data;
+  size_t len;
+  WriteCallback callback;
+  void *ctx;
+  uint64_t amendAt; ///< Logical position to reprogram, NO_AMEND to append
+};
+
+static constexpr uint64_t NO_AMEND = UINT64_MAX;
+
+/// Cursor position as recorded in the journal
+struct CursorRecord {
+  uint32_t magic;                 ///< CURSOR_MAGIC
+  uint32_t positionLo;            ///< Logical position, low word
+  uint32_t positionHi;            ///< Logical position, high word
+  char name[CURSOR_NAME_LEN];     ///< Not terminated when all used
+};
+static_assert(sizeof(CursorRecord) == sizeof(Metadata), "Journal body size");
+
+/// One metadata journal record, programmed into blank journal flash
+struct JournalEntry {
+  union {
+    Metadata meta;       ///< Ring state (meta.magic == MAGIC_NUMBER)
+    CursorRecord cursor; ///< Cursor state (cursor.magic == CURSOR_MAGIC)
+  };
+  uint32_t seq;      ///< Monotonic sequence number, highest wins on recovery
+  uint32_t flags;    ///< ENTRY_* bits, unused ones left blank (set)
+  uint32_t crc32;    ///< CRC of all preceding fields
+};
+static_assert(sizeof(JournalEntry) == 32, "JournalEntry must stay 32 bytes");
+
+static constexpr size_t JOURNAL_SLOTS = PAGE_SIZE / sizeof(JournalEntry);
+
+/// State of the journal sector that is not being appended to
+enum class SpareState { CLEAN, DIRTY, ERASING };
+
 // Module state
 static const esp_partition_t *s_partition = nullptr;
 static Metadata s_meta = {};
-static size_t s_partitionSize = 0;
+static size_t s_partitionSize = 0; // Ring data area (journal sectors excluded)
 static size_t s_totalPages = 0;
 static bool s_initialized = false;
-
-// Pre-erase task state
-static TaskHandle_t s_eraseTaskHandle = nullptr;
-static SemaphoreHandle_t s_eraseMutex = nullptr;
-static size_t s_erasedPages[PRE_ERASE_PAGES] = {SIZE_MAX, SIZE_MAX};
-static volatile bool s_eraseTaskRunning = false;
+static SemaphoreHandle_t s_stateMutex = nullptr; // Guards s_meta and erase window
+static SemaphoreHandle_t s_writeMutex = nullptr; // Serializes flash programming
+
+// Erase look-ahead window: s_erasedAhead pages, starting at the first page
+// the head has not entered yet, are known to be erased. Pages are only
+// handed to the writer from this window, so the tail is always moved out
+// of a page before it is erased. The window is refilled by a housekeeping
+// job, one page per run.
+static Housekeeping::JobId s_eraseJob = Housekeeping::INVALID_JOB;
+static SemaphoreHandle_t s_eraseDoneSem = nullptr;
+static size_t s_erasedAhead = 0;
+static size_t s_erasingPage = SIZE_MAX;
+static size_t s_lookAheadPages = MIN_PRE_ERASE_PAGES;
+// The head sits on a page boundary and the writer has already taken that
+// page from the window (the head has entered it)
+static bool s_headPageTaken = false;
+
+// Metadata journal: JOURNAL_SECTORS sectors after the ring data area. The
+// active sector is appended to until full, then the (pre-erased) spare
+// takes over and the old one is erased in the background.
+static SemaphoreHandle_t s_journalMutex = nullptr;
+static size_t s_journalOffset = 0;
+static size_t s_journalSector = 0;
+static size_t s_journalSlot = 0;
+static uint32_t s_journalSeq = 0;
+static Metadata s_journaledMeta = {};
+static uint32_t s_journaledFlags = UINT32_MAX;
+static SpareState s_spareState = SpareState::CLEAN;
+
+// Named read cursors (guarded by s_stateMutex); dirty ones are journaled
+// with the next metadata save
+struct Cursor {
+  bool used;
+  bool dirty;
+  char name[CURSOR_NAME_LEN + 1];
+  uint64_t position;
+  uint64_t dropped;
+};
+static Cursor s_cursors[MAX_CURSORS] = {};
+
+// Memory-mapped read windows (guarded by s_mapMutex). A pinned window backs
+// spans a caller still holds; unpinned ones stay mapped for the next read
+// and are recycled least recently used first.
+struct MapWindow {
+  const uint8_t *base; // nullptr while unmapped
+  esp_partition_mmap_handle_t handle;
+  size_t offset;       // Partition offset of base
+  size_t size;
+  uint16_t pins;
+  uint32_t lastUse;
+};
+static MapWindow s_windows[MMAP_WINDOWS] = {};
+static uint32_t s_mapClock = 0;
+static SemaphoreHandle_t s_mapMutex = nullptr;
+
+// Asynchronous write engine
+static QueueHandle_t s_writeQueue = nullptr;
+static TaskHandle_t s_programTaskHandle = nullptr;
+static size_t s_queuedBytes = 0;    // Bytes submitted but not yet programmed
+static size_t s_inFlight = 0;       // Requests submitted but not yet completed
+static volatile bool s_programTaskRunning = false;
+
+// Write engine statistics
+static uint32_t s_eraseStalls = 0;
+static uint64_t s_eraseStallUs = 0;
+static uint64_t s_stallAvoidedUs = 0;
+static uint32_t s_avgEraseUs = DEFAULT_ERASE_US;
+static uint32_t s_ingestRate = 0;
+static int64_t s_rateWindowStart = 0;
+static size_t s_rateWindowBytes = 0;
+static size_t s_queueHighWater = 0;
 
 // Forward declarations
 static esp_err_t loadMetadata();
 static esp_err_t saveMetadata();
+static esp_err_t eraseJournalSector(size_t sector);
+static void eraseSpareJournal();
+static void recoverHead();
+static esp_err_t appendEntry(JournalEntry &entry);
+static void makeCursorEntry(const Cursor &cursor, JournalEntry *entry);
+static void clampCursors();
+static uint64_t lowestCursor();
+static void dropLegacyMetadata();
 static size_t getUsedBytes();
 static size_t getFreeBytes();
-static void eraseTask(void *arg);
-static bool isPageErased(size_t pageNum);
-static void markPageErased(size_t pageNum);
-static esp_err_t ensurePageErased(size_t pageNum);
+static size_t firstUnwrittenPage();
+static uint32_t entryFlags();
+static bool reclaimPage(size_t pageNum);
+static bool pageHoldsUnread(size_t pageNum);
+static esp_err_t erasePageTimed(size_t pageNum);
+static esp_err_t acquirePage(size_t pageNum);
+static esp_err_t programChunk(const uint8_t *data, size_t len);
+static esp_err_t programAmend(uint64_t position, const uint8_t *data, size_t len);
+static uint64_t logicalHead();
+static void updateIngestRate(size_t bytes);
+static uint32_t eraseJob(void *ctx);
+static void programTask(void *arg);
+
+static inline void lockState() { xSemaphoreTake(s_stateMutex, portMAX_DELAY); }
+static inline void unlockState() { xSemaphoreGive(s_stateMutex); }
 
 esp_err_t init(const char *partitionLabel) {
   if (s_initialized) {
@@ -48,16 +194,6 @@ esp_err_t init(const char *partitionLabel) {
     return ESP_OK;
   }
 
-  // Initialize NVS
-  esp_err_t ret = nvs_flash_init();
-  if (ret == ESP_ERR_NVS_NO_FREE_PAGES ||
-      ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-    ESP_LOGW(TAG, "NVS partition truncated, erasing...");
-    ESP_ERROR_CHECK(nvs_flash_erase());
-    ret = nvs_flash_init();
-  }
-  ESP_ERROR_CHECK(ret);
-
   // Find the data partition
   s_partition = esp_partition_find_first(
       ESP_PARTITION_TYPE_DATA, static_cast<esp_partition_subtype_t>(0x80),
@@ -68,59 +204,103 @@ esp_err_t init(const char *partitionLabel) {
     return ESP_ERR_NOT_FOUND;
   }
 
-  s_partitionSize = s_partition->size;
-  s_totalPages = s_partitionSize / PAGE_SIZE;
-  
-  ESP_LOGI(TAG, "Found partition '%s': size=%lu bytes, %u pages",
-           partitionLabel, s_partitionSize, s_totalPages);
-
-  // Create mutex for erase coordination
-  s_eraseMutex = xSemaphoreCreateMutex();
-  if (!s_eraseMutex) {
-    ESP_LOGE(TAG, "Failed to create mutex");
+  // The last sectors hold the metadata journal, the rest is ring data
+  size_t partitionPages = s_partition->size / PAGE_SIZE;
+  if (partitionPages < JOURNAL_SECTORS + 4) {
+    ESP_LOGE(TAG, "Partition '%s' too small (%lu bytes)", partitionLabel,
+             s_partition->size);
+    s_partition = nullptr;
+    return ESP_ERR_INVALID_SIZE;
+  }
+  s_totalPages = partitionPages - JOURNAL_SECTORS;
+  s_partitionSize = s_totalPages * PAGE_SIZE;
+  s_journalOffset = s_partitionSize;
+
+  ESP_LOGI(TAG, "Found partition '%s': %lu bytes data (%u pages) + %u journal sectors",
+           partitionLabel, s_partitionSize, s_totalPages, JOURNAL_SECTORS);
+
+  // Create synchronization primitives
+  s_stateMutex = xSemaphoreCreateMutex();
+  s_writeMutex = xSemaphoreCreateMutex();
+  s_journalMutex = xSemaphoreCreateMutex();
+  s_mapMutex = xSemaphoreCreateMutex();
+  s_eraseDoneSem = xSemaphoreCreateBinary();
+  s_writeQueue = xQueueCreate(WRITE_QUEUE_DEPTH, sizeof(WriteRequest));
+  if (!s_stateMutex || !s_writeMutex || !s_journalMutex || !s_mapMutex ||
+      !s_eraseDoneSem || !s_writeQueue) {
+    ESP_LOGE(TAG, "Failed to create synchronization primitives");
+    deinit();
     return ESP_ERR_NO_MEM;
   }
 
-  // Load or initialize metadata
-  ret = loadMetadata();
-  if (ret != ESP_OK || s_meta.magic != MAGIC_NUMBER) {
+  s_erasedAhead = 0;
+  s_erasingPage = SIZE_MAX;
+  s_headPageTaken = false;
+  s_lookAheadPages = MIN_PRE_ERASE_PAGES;
+  s_queuedBytes = 0;
+  s_inFlight = 0;
+
+  // Recover the latest state from the journal, or initialize metadata
+  esp_err_t ret = loadMetadata();
+  if (ret == ESP_OK) {
+    // Data programmed after the last journal entry is still in the head page
+    recoverHead();
+  } else {
     ESP_LOGW(TAG, "No valid metadata, initializing fresh");
     s_meta.magic = MAGIC_NUMBER;
     s_meta.head = 0;
     s_meta.tail = 0;
     s_meta.totalWritten = 0;
     s_meta.wrapCount = 0;
-    
-    // Initialize erased pages array
-    for (size_t i = 0; i < PRE_ERASE_PAGES; i++) {
-      s_meta.erasedPages[i] = SIZE_MAX; // Empty
+
+    s_journalSector = 0;
+    s_journalSlot = 0;
+    s_journalSeq = 0;
+    s_journaledMeta = {};
+    s_journaledFlags = UINT32_MAX;
+    memset(s_cursors, 0, sizeof(s_cursors));
+    if (eraseJournalSector(0) != ESP_OK || eraseJournalSector(1) != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to erase metadata journal");
+      deinit();
+      return ESP_FAIL;
     }
-    
+    s_spareState = SpareState::CLEAN;
+
     // Erase first few pages for fresh start
     ESP_LOGI(TAG, "Erasing initial pages...");
-    for (size_t i = 0; i < PRE_ERASE_PAGES + 1; i++) {
-      esp_partition_erase_range(s_partition, i * PAGE_SIZE, PAGE_SIZE);
-      markPageErased(i);
+    for (size_t i = 0; i < MIN_PRE_ERASE_PAGES + 1; i++) {
+      if (esp_partition_erase_range(s_partition, i * PAGE_SIZE, PAGE_SIZE) != ESP_OK) {
+        break;
+      }
+      s_erasedAhead++;
     }
     saveMetadata();
-  } else {
-    // Load erased pages from metadata to RAM cache
-    xSemaphoreTake(s_eraseMutex, portMAX_DELAY);
-    for (size_t i = 0; i < PRE_ERASE_PAGES; i++) {
-      s_erasedPages[i] = s_meta.erasedPages[i];
-    }
-    xSemaphoreGive(s_eraseMutex);
+    dropLegacyMetadata();
   }
+  // Otherwise nothing ahead of the head is trusted to be erased until the
+  // erase job has rebuilt the window (the rest of a partially written
+  // head page is still blank, since pages are only written forward).
 
   ESP_LOGI(TAG, "Initialized: head=%lu, tail=%lu, wraps=%lu", s_meta.head,
            s_meta.tail, s_meta.wrapCount);
 
-  // Start pre-erase task
-  s_eraseTaskRunning = true;
-  xTaskCreatePinnedToCore(eraseTask, "flash_erase", 4096, nullptr, 
-                          tskIDLE_PRIORITY + 1, &s_eraseTaskHandle, 1);
-
   s_initialized = true;
+
+  // Start pre-erasing
+  esp_err_t jobRet =
+      Housekeeping::add("flash_erase", eraseJob, nullptr, 0, &s_eraseJob);
+  if (jobRet != ESP_OK) {
+    ESP_LOGW(TAG, "No pre-erase job, pages are erased on demand: %s",
+             esp_err_to_name(jobRet));
+  }
+
+  // Start program task, just below the pipeline writer so filling the next
+  // page always preempts programming the previous one
+  s_programTaskRunning = true;
+  MemoryPlan::createTask(MemoryPlan::Region::TASK_FLASH_PROGRAM, programTask,
+                         "flash_program", 4096, nullptr,
+                         configMAX_PRIORITIES - 3, &s_programTaskHandle, 1);
+
   return ESP_OK;
 }
 
@@ -137,56 +317,111 @@ esp_err_t write(const uint8_t *data, size_t len) {
     return ESP_ERR_INVALID_SIZE;
   }
 
-  size_t bytesWritten = 0;
+  // Keep ordering with writes already queued
+  waitIdle(portMAX_DELAY);
 
-  while (bytesWritten < len) {
-    // Calculate bytes to end of current page
-    size_t offsetInPage = s_meta.head % PAGE_SIZE;
-    size_t bytesToPageEnd = PAGE_SIZE - offsetInPage;
-    
-    // Calculate how much to write in this iteration
-    size_t toEndOfPartition = s_partitionSize - s_meta.head;
-    size_t remaining = len - bytesWritten;
-    size_t chunkSize = std::min({remaining, bytesToPageEnd, toEndOfPartition});
+  xSemaphoreTake(s_writeMutex, portMAX_DELAY);
+  esp_err_t ret = programChunk(data, len);
+  xSemaphoreGive(s_writeMutex);
+  return ret;
+}
 
-    // Calculate new head position
-    size_t newHead = (s_meta.head + chunkSize) % s_partitionSize;
+esp_err_t writeAsync(const uint8_t *data, size_t len, WriteCallback callback,
+                     void *ctx, TickType_t wait) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!data) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (len > s_partitionSize) {
+    ESP_LOGE(TAG, "Write size %u exceeds partition size %u", len,
+             s_partitionSize);
+    return ESP_ERR_INVALID_SIZE;
+  }
 
-    // Check if we need to advance tail (overwrite old data)
-    if (getUsedBytes() + chunkSize >= s_partitionSize) {
-      s_meta.tail = (s_meta.tail + chunkSize) % s_partitionSize;
-      if (s_meta.wrapCount == 0 || newHead < s_meta.head) {
-        s_meta.wrapCount++;
-        ESP_LOGD(TAG, "Buffer wrapped, count=%lu", s_meta.wrapCount);
-      }
-    }
+  lockState();
+  s_queuedBytes += len;
+  s_inFlight++;
+  if (s_inFlight > s_queueHighWater) {
+    s_queueHighWater = s_inFlight;
+  }
+  unlockState();
+
+  WriteRequest req = {data, len, callback, ctx, NO_AMEND};
+  if (xQueueSend(s_writeQueue, &req, wait) != pdTRUE) {
+    lockState();
+    s_queuedBytes -= len;
+    s_inFlight--;
+    unlockState();
+    return ESP_ERR_TIMEOUT;
+  }
+  return ESP_OK;
+}
 
-    // Ensure the page we're writing to is erased
-    size_t currentPage = s_meta.head / PAGE_SIZE;
-    ensurePageErased(currentPage);
+esp_err_t flushMetadataAsync() {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
 
-    // Write the chunk
-    esp_err_t ret = esp_partition_write(s_partition, s_meta.head, 
-                                         data + bytesWritten, chunkSize);
-    if (ret != ESP_OK) {
-      ESP_LOGE(TAG, "esp_partition_write failed at offset %lu: %s", s_meta.head,
-               esp_err_to_name(ret));
-      return ret;
-    }
+  lockState();
+  s_inFlight++;
+  unlockState();
 
-    s_meta.head = newHead;
-    s_meta.totalWritten += chunkSize;
-    bytesWritten += chunkSize;
-    
-    // If we completed a page, it's no longer "erased" (it has data now)
-    // The erase task will handle erasing ahead
+  WriteRequest req = {nullptr, 0, nullptr, nullptr, NO_AMEND};
+  if (xQueueSend(s_writeQueue, &req, 0) != pdTRUE) {
+    lockState();
+    s_inFlight--;
+    unlockState();
+    return ESP_ERR_TIMEOUT;
   }
+  return ESP_OK;
+}
 
-  ESP_LOGD(TAG, "Wrote %u bytes, head=%lu, tail=%lu", len, s_meta.head,
-           s_meta.tail);
+esp_err_t amendAsync(uint64_t position, const uint8_t *data, size_t len,
+                     WriteCallback callback, void *ctx) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!data || len == 0 || len > PAGE_SIZE) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  s_inFlight++;
+  unlockState();
+
+  WriteRequest req = {data, len, callback, ctx, position};
+  if (xQueueSend(s_writeQueue, &req, portMAX_DELAY) != pdTRUE) {
+    lockState();
+    s_inFlight--;
+    unlockState();
+    return ESP_ERR_TIMEOUT;
+  }
   return ESP_OK;
 }
 
+esp_err_t waitIdle(TickType_t wait) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  TickType_t start = xTaskGetTickCount();
+  while (true) {
+    lockState();
+    size_t inFlight = s_inFlight;
+    unlockState();
+
+    if (inFlight == 0) {
+      return ESP_OK;
+    }
+    if (xTaskGetTickCount() - start >= wait) {
+      return ESP_ERR_TIMEOUT;
+    }
+    vTaskDelay(1);
+  }
+}
+
 esp_err_t read(uint8_t *data, size_t len, size_t *bytesRead) {
   return readAt(0, data, len, bytesRead);
 }
@@ -196,21 +431,25 @@ esp_err_t readAt(size_t offset, uint8_t *data, size_t len, size_t *bytesRead) {
     return ESP_ERR_INVALID_STATE;
   }
 
+  lockState();
   size_t available = getUsedBytes();
+  size_t tail = s_meta.tail;
+  unlockState();
+
   if (offset >= available) {
     *bytesRead = 0;
     return ESP_OK;
   }
 
   size_t toRead = std::min(len, available - offset);
-  size_t readPos = (s_meta.tail + offset) % s_partitionSize;
+  size_t readPos = (tail + offset) % s_partitionSize;
   size_t totalRead = 0;
 
   while (totalRead < toRead) {
     size_t toEndOfPartition = s_partitionSize - readPos;
     size_t chunkSize = std::min(toRead - totalRead, toEndOfPartition);
 
-    esp_err_t ret = esp_partition_read(s_partition, readPos, 
+    esp_err_t ret = esp_partition_read(s_partition, readPos,
                                         data + totalRead, chunkSize);
     if (ret != ESP_OK) {
       ESP_LOGE(TAG, "esp_partition_read failed at offset %u: %s", readPos,
@@ -226,17 +465,369 @@ esp_err_t readAt(size_t offset, uint8_t *data, size_t len, size_t *bytesRead) {
   return ESP_OK;
 }
 
+esp_err_t readLogical(uint64_t position, uint8_t *data, size_t len,
+                      size_t *bytesRead) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  lockState();
+  uint64_t head = logicalHead();
+  uint64_t tail = head - getUsedBytes();
+  unlockState();
+
+  if (position < tail) {
+    // Already overwritten
+    *bytesRead = 0;
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (position >= head) {
+    *bytesRead = 0;
+    return ESP_OK;
+  }
+
+  size_t toRead = (size_t)std::min<uint64_t>(len, head - position);
+  size_t readPos = (size_t)(position % s_partitionSize);
+  size_t totalRead = 0;
+
+  while (totalRead < toRead) {
+    size_t toEndOfPartition = s_partitionSize - readPos;
+    size_t chunkSize = std::min(toRead - totalRead, toEndOfPartition);
+
+    esp_err_t ret = esp_partition_read(s_partition, readPos,
+                                        data + totalRead, chunkSize);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "esp_partition_read failed at offset %u: %s", readPos,
+               esp_err_to_name(ret));
+      return ret;
+    }
+
+    readPos = (readPos + chunkSize) % s_partitionSize;
+    totalRead += chunkSize;
+  }
+
+  *bytesRead = totalRead;
+  return ESP_OK;
+}
+
+// Map and pin the window holding partition offset @p phys; nullptr if every
+// window is pinned or mapping failed. Called with s_mapMutex held.
+static MapWindow *pinWindow(size_t phys) {
+  size_t offset = phys - phys % MMAP_WINDOW_SIZE;
+  MapWindow *victim = nullptr;
+  for (MapWindow &window : s_windows) {
+    if (window.base && window.offset == offset) {
+      window.pins++;
+      window.lastUse = ++s_mapClock;
+      return &window;
+    }
+    // Prefer an unmapped window, then the least recently used one
+    if (window.pins == 0 &&
+        (!victim || (victim->base && (!window.base ||
+                                      window.lastUse < victim->lastUse)))) {
+      victim = &window;
+    }
+  }
+  if (!victim) {
+    return nullptr;
+  }
+
+  if (victim->base) {
+    esp_partition_munmap(victim->handle);
+    victim->base = nullptr;
+  }
+  size_t size = std::min(MMAP_WINDOW_SIZE, s_partitionSize - offset);
+  const void *ptr = nullptr;
+  esp_partition_mmap_handle_t handle;
+  esp_err_t ret = esp_partition_mmap(s_partition, offset, size,
+                                     ESP_PARTITION_MMAP_DATA, &ptr, &handle);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "esp_partition_mmap failed at offset %u: %s", offset,
+             esp_err_to_name(ret));
+    return nullptr;
+  }
+  victim->base = static_cast<const uint8_t *>(ptr);
+  victim->handle = handle;
+  victim->offset = offset;
+  victim->size = size;
+  victim->pins = 1;
+  victim->lastUse = ++s_mapClock;
+  return victim;
+}
+
+esp_err_t mapLogical(uint64_t position, size_t len, Span spans[2],
+                     size_t *count) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!spans || !count) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *count = 0;
+
+  lockState();
+  uint64_t head = logicalHead();
+  uint64_t tail = head - getUsedBytes();
+  unlockState();
+
+  if (position < tail) {
+    return ESP_ERR_NOT_FOUND; // Already overwritten
+  }
+  if (position >= head) {
+    return ESP_OK;
+  }
+
+  size_t remaining = (size_t)std::min<uint64_t>(len, head - position);
+  size_t phys = (size_t)(position % s_partitionSize);
+
+  xSemaphoreTake(s_mapMutex, portMAX_DELAY);
+  while (remaining > 0 && *count < 2) {
+    MapWindow *window = pinWindow(phys);
+    if (!window) {
+      break;
+    }
+    size_t chunk = std::min(remaining, window->offset + window->size - phys);
+    spans[*count] = {window->base + (phys - window->offset), chunk};
+    (*count)++;
+    remaining -= chunk;
+    phys = (phys + chunk) % s_partitionSize;
+  }
+  xSemaphoreGive(s_mapMutex);
+
+  return (*count == 0) ? ESP_ERR_NO_MEM : ESP_OK;
+}
+
+void unmapSpans(const Span spans[2], size_t count) {
+  if (!spans || !s_mapMutex) {
+    return;
+  }
+  xSemaphoreTake(s_mapMutex, portMAX_DELAY);
+  for (size_t i = 0; i < count && i < 2; i++) {
+    for (MapWindow &window : s_windows) {
+      if (window.base && window.pins > 0 && spans[i].data >= window.base &&
+          spans[i].data < window.base + window.size) {
+        window.pins--;
+        break;
+      }
+    }
+  }
+  xSemaphoreGive(s_mapMutex);
+}
+
+uint64_t getLogicalHead() {
+  lockState();
+  uint64_t head = logicalHead();
+  unlockState();
+  return head;
+}
+
+uint64_t getLogicalTail() {
+  lockState();
+  uint64_t tail = logicalHead() - getUsedBytes();
+  unlockState();
+  return tail;
+}
+
+uint64_t getQueuedHead() {
+  lockState();
+  uint64_t head = logicalHead() + s_queuedBytes;
+  unlockState();
+  return head;
+}
+
+esp_err_t openCursor(const char *name, CursorId *id) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!name || !id || name[0] == '\0' || strlen(name) > CURSOR_NAME_LEN) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  int freeSlot = -1;
+  for (int i = 0; i < (int)MAX_CURSORS; i++) {
+    if (s_cursors[i].used && strcmp(s_cursors[i].name, name) == 0) {
+      unlockState();
+      *id = i;
+      return ESP_OK;
+    }
+    if (!s_cursors[i].used && freeSlot < 0) {
+      freeSlot = i;
+    }
+  }
+  if (freeSlot < 0) {
+    unlockState();
+    ESP_LOGE(TAG, "No free cursor slot for '%s'", name);
+    return ESP_ERR_NO_MEM;
+  }
+
+  // New consumers start at the oldest stored data
+  Cursor &cursor = s_cursors[freeSlot];
+  cursor.used = true;
+  snprintf(cursor.name, sizeof(cursor.name), "%s", name);
+  cursor.position = logicalHead() - getUsedBytes();
+  cursor.dropped = 0;
+  cursor.dirty = true;
+  unlockState();
+
+  *id = freeSlot;
+  ESP_LOGI(TAG, "Cursor '%s' created", name);
+  return saveMetadata();
+}
+
+esp_err_t findCursor(const char *name, CursorId *id) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!name || !id) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  for (int i = 0; i < (int)MAX_CURSORS; i++) {
+    if (s_cursors[i].used && strcmp(s_cursors[i].name, name) == 0) {
+      unlockState();
+      *id = i;
+      return ESP_OK;
+    }
+  }
+  unlockState();
+  return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t closeCursor(CursorId id) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (id < 0 || id >= (int)MAX_CURSORS) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  Cursor closed = s_cursors[id];
+  s_cursors[id] = {};
+  unlockState();
+
+  if (!closed.used) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // Record the close right away so the cursor does not come back at boot
+  closed.position = CURSOR_CLOSED;
+  JournalEntry entry;
+  makeCursorEntry(closed, &entry);
+  xSemaphoreTake(s_journalMutex, portMAX_DELAY);
+  esp_err_t ret = appendEntry(entry);
+  xSemaphoreGive(s_journalMutex);
+  return ret;
+}
+
+esp_err_t getCursor(CursorId id, CursorInfo *info) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (id < 0 || id >= (int)MAX_CURSORS || !info) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  const Cursor &cursor = s_cursors[id];
+  if (!cursor.used) {
+    unlockState();
+    return ESP_ERR_NOT_FOUND;
+  }
+  snprintf(info->name, sizeof(info->name), "%s", cursor.name);
+  info->position = cursor.position;
+  info->pending = logicalHead() - cursor.position;
+  info->dropped = cursor.dropped;
+  unlockState();
+
+  return ESP_OK;
+}
+
+esp_err_t readCursor(CursorId id, uint8_t *data, size_t len, size_t *bytesRead) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (id < 0 || id >= (int)MAX_CURSORS) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // The cursor is clamped to the tail on overrun, so one retry is enough
+  // if the writer overtakes it between the lookup and the read
+  esp_err_t ret = ESP_ERR_NOT_FOUND;
+  for (int attempt = 0; attempt < 2 && ret == ESP_ERR_NOT_FOUND; attempt++) {
+    lockState();
+    bool used = s_cursors[id].used;
+    uint64_t position = s_cursors[id].position;
+    unlockState();
+
+    if (!used) {
+      return ESP_ERR_NOT_FOUND;
+    }
+    ret = readLogical(position, data, len, bytesRead);
+  }
+  return ret;
+}
+
+esp_err_t advanceCursor(CursorId id, size_t len) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (id < 0 || id >= (int)MAX_CURSORS) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  Cursor &cursor = s_cursors[id];
+  if (!cursor.used) {
+    unlockState();
+    return ESP_ERR_NOT_FOUND;
+  }
+  cursor.position = std::min<uint64_t>(cursor.position + len, logicalHead());
+  cursor.dirty = true;
+  unlockState();
+
+  return ESP_OK;
+}
+
+esp_err_t seekCursor(CursorId id, uint64_t position) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (id < 0 || id >= (int)MAX_CURSORS) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  lockState();
+  Cursor &cursor = s_cursors[id];
+  if (!cursor.used) {
+    unlockState();
+    return ESP_ERR_NOT_FOUND;
+  }
+  uint64_t head = logicalHead();
+  uint64_t tail = head - getUsedBytes();
+  cursor.position = std::max(tail, std::min(position, head));
+  cursor.dirty = true;
+  unlockState();
+
+  return ESP_OK;
+}
+
 esp_err_t consume(size_t len) {
   if (!s_initialized) {
     return ESP_ERR_INVALID_STATE;
   }
 
+  lockState();
   size_t available = getUsedBytes();
   size_t toConsume = std::min(len, available);
   s_meta.tail = (s_meta.tail + toConsume) % s_partitionSize;
+  clampCursors();
+  unlockState();
 
   ESP_LOGD(TAG, "Consumed %u bytes, tail=%lu", toConsume, s_meta.tail);
-  return ESP_OK;
+  return saveMetadata();
 }
 
 esp_err_t getStats(Stats *stats) {
@@ -244,11 +835,29 @@ esp_err_t getStats(Stats *stats) {
     return ESP_ERR_INVALID_STATE;
   }
 
+  lockState();
   stats->partitionSize = s_partitionSize;
   stats->usedBytes = getUsedBytes();
   stats->freeBytes = getFreeBytes();
   stats->wrapCount = s_meta.wrapCount;
   stats->totalWritten = s_meta.totalWritten;
+  stats->lookAheadPages = s_lookAheadPages;
+  stats->erasedAhead = s_erasedAhead;
+  stats->ingestRate = s_ingestRate;
+  stats->avgEraseUs = s_avgEraseUs;
+  stats->eraseStalls = s_eraseStalls;
+  stats->eraseStallUs = s_eraseStallUs;
+  stats->stallAvoidedUs = s_stallAvoidedUs;
+  stats->writeQueueDepth = s_inFlight;
+  stats->writeQueueHighWater = s_queueHighWater;
+  stats->cursorCount = 0;
+  for (const Cursor &cursor : s_cursors) {
+    stats->cursorCount += cursor.used ? 1 : 0;
+  }
+  uint64_t lowest = lowestCursor();
+  stats->unreadBytes = (lowest == UINT64_MAX) ? 0 : logicalHead() - lowest;
+  unlockState();
+  stats->journalSeq = s_journalSeq;
 
   return ESP_OK;
 }
@@ -260,27 +869,48 @@ esp_err_t erase() {
 
   ESP_LOGI(TAG, "Erasing all data...");
 
-  // Erase the entire partition
+  // Let queued writes land, then keep the program task out while erasing
+  waitIdle(portMAX_DELAY);
+  xSemaphoreTake(s_writeMutex, portMAX_DELAY);
+
+  // Wait for an in-progress pre-erase to finish
+  lockState();
+  while (s_erasingPage != SIZE_MAX) {
+    unlockState();
+    xSemaphoreTake(s_eraseDoneSem, pdMS_TO_TICKS(100));
+    lockState();
+  }
+  s_erasingPage = 0; // Blocks the erase job during the full erase
+  unlockState();
+
+  // Erase the ring data area; the journal keeps its history
   esp_err_t ret = esp_partition_erase_range(s_partition, 0, s_partitionSize);
+
+  lockState();
+  s_erasingPage = SIZE_MAX;
+  if (ret == ESP_OK) {
+    // Reset metadata, every page is now blank
+    s_meta.head = 0;
+    s_meta.tail = 0;
+    s_meta.totalWritten = 0;
+    s_meta.wrapCount = 0;
+    s_erasedAhead = s_totalPages;
+    s_headPageTaken = false;
+    for (Cursor &cursor : s_cursors) {
+      if (cursor.used) {
+        cursor.position = 0;
+        cursor.dirty = true;
+      }
+    }
+  }
+  unlockState();
+  xSemaphoreGive(s_writeMutex);
+
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "esp_partition_erase_range failed: %s", esp_err_to_name(ret));
     return ret;
   }
 
-  // Reset metadata
-  s_meta.head = 0;
-  s_meta.tail = 0;
-  s_meta.totalWritten = 0;
-  s_meta.wrapCount = 0;
-
-  // Mark first pages as erased
-  xSemaphoreTake(s_eraseMutex, portMAX_DELAY);
-  for (size_t i = 0; i < PRE_ERASE_PAGES; i++) {
-    s_erasedPages[i] = i;
-    s_meta.erasedPages[i] = i;
-  }
-  xSemaphoreGive(s_eraseMutex);
-
   return saveMetadata();
 }
 
@@ -296,68 +926,423 @@ size_t getHead() {
 }
 
 size_t getBytesToPageEnd() {
-  size_t offsetInPage = s_meta.head % PAGE_SIZE;
+  lockState();
+  size_t queuedHead = (s_meta.head + s_queuedBytes) % s_partitionSize;
+  unlockState();
+
+  size_t offsetInPage = queuedHead % PAGE_SIZE;
   return PAGE_SIZE - offsetInPage;
 }
 
 void deinit() {
   if (s_initialized) {
-    // Stop erase task
-    s_eraseTaskRunning = false;
-    if (s_eraseTaskHandle) {
-      vTaskDelay(pdMS_TO_TICKS(100));
-      vTaskDelete(s_eraseTaskHandle);
-      s_eraseTaskHandle = nullptr;
-    }
-    
-    if (s_eraseMutex) {
-      vSemaphoreDelete(s_eraseMutex);
-      s_eraseMutex = nullptr;
-    }
-    
+    // Drain queued writes, then stop the engine
+    waitIdle(pdMS_TO_TICKS(1000));
+
+    // Waits for a page erase in progress
+    Housekeeping::remove(s_eraseJob);
+    s_eraseJob = Housekeeping::INVALID_JOB;
+
+    // The program task clears its handle on exit; it is only deleted here
+    // if still stuck after that
+    s_programTaskRunning = false;
+    for (int i = 0; i < 30 && s_programTaskHandle; i++) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    if (s_programTaskHandle) {
+      MemoryPlan::deleteTask(MemoryPlan::Region::TASK_FLASH_PROGRAM,
+                             s_programTaskHandle);
+      s_programTaskHandle = nullptr;
+    }
+
     saveMetadata();
-    s_partition = nullptr;
     s_initialized = false;
     ESP_LOGI(TAG, "Deinitialized");
   }
+
+  if (s_writeQueue) {
+    vQueueDelete(s_writeQueue);
+    s_writeQueue = nullptr;
+  }
+  if (s_eraseDoneSem) {
+    vSemaphoreDelete(s_eraseDoneSem);
+    s_eraseDoneSem = nullptr;
+  }
+  if (s_writeMutex) {
+    vSemaphoreDelete(s_writeMutex);
+    s_writeMutex = nullptr;
+  }
+  if (s_journalMutex) {
+    vSemaphoreDelete(s_journalMutex);
+    s_journalMutex = nullptr;
+  }
+  for (MapWindow &window : s_windows) {
+    if (window.base) {
+      esp_partition_munmap(window.handle);
+    }
+    window = {};
+  }
+  if (s_mapMutex) {
+    vSemaphoreDelete(s_mapMutex);
+    s_mapMutex = nullptr;
+  }
+  if (s_stateMutex) {
+    vSemaphoreDelete(s_stateMutex);
+    s_stateMutex = nullptr;
+  }
+  s_partition = nullptr;
 }
 
 // --- Private functions ---
 
+static size_t journalAddress(size_t sector, size_t slot) {
+  return s_journalOffset + sector * PAGE_SIZE + slot * sizeof(JournalEntry);
+}
+
+static uint32_t journalCrc(const JournalEntry &entry) {
+  return esp_crc32_le(0, reinterpret_cast<const uint8_t *>(&entry),
+                      offsetof(JournalEntry, crc32));
+}
+
+static bool isBlank(const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (data[i] != 0xFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Scan both journal sectors for the entry with the highest sequence number
 static esp_err_t loadMetadata() {
-  nvs_handle_t handle;
-  esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
-  if (ret != ESP_OK) {
-    return ret;
+  JournalEntry *entries = (JournalEntry *)malloc(PAGE_SIZE);
+  if (!entries) {
+    return ESP_ERR_NO_MEM;
   }
 
-  size_t size = sizeof(Metadata);
-  ret = nvs_get_blob(handle, NVS_KEY_META, &s_meta, &size);
-  nvs_close(handle);
+  bool found = false;
+  JournalEntry best = {};
+  size_t bestSector = 0;
+  size_t usedSlots[JOURNAL_SECTORS] = {};
+  uint32_t newestSeq[JOURNAL_SECTORS] = {};
+
+  for (size_t sector = 0; sector < JOURNAL_SECTORS; sector++) {
+    esp_err_t ret = esp_partition_read(s_partition, journalAddress(sector, 0),
+                                       entries, PAGE_SIZE);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Journal read failed: %s", esp_err_to_name(ret));
+      free(entries);
+      return ret;
+    }
+
+    for (size_t slot = 0; slot < JOURNAL_SLOTS; slot++) {
+      const JournalEntry &entry = entries[slot];
+      if (isBlank(reinterpret_cast<const uint8_t *>(&entry), sizeof(entry))) {
+        continue;
+      }
+      // Torn or corrupt entries still occupy their slot
+      usedSlots[sector] = slot + 1;
+
+      if (entry.crc32 != journalCrc(entry)) {
+        continue;
+      }
+      newestSeq[sector] = std::max(newestSeq[sector], entry.seq);
+
+      if (entry.meta.magic != MAGIC_NUMBER ||
+          entry.meta.head >= s_partitionSize ||
+          entry.meta.tail >= s_partitionSize) {
+        continue;
+      }
+      if (!found || entry.seq > best.seq) {
+        found = true;
+        best = entry;
+      }
+    }
+  }
+
+  if (!found) {
+    free(entries);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // Appends go to the sector holding the newest entry. A sector switch
+  // copies every open cursor there first, so cursors are only taken from
+  // this sector (entries of cursors closed before the switch stay behind).
+  bestSector = (newestSeq[1] > newestSeq[0]) ? 1 : 0;
+  memset(s_cursors, 0, sizeof(s_cursors));
+  uint32_t cursorSeq[MAX_CURSORS] = {};
+  esp_err_t ret = esp_partition_read(s_partition, journalAddress(bestSector, 0),
+                                     entries, PAGE_SIZE);
+  for (size_t slot = 0; ret == ESP_OK && slot < usedSlots[bestSector]; slot++) {
+    const JournalEntry &entry = entries[slot];
+    if (entry.cursor.magic != CURSOR_MAGIC || entry.crc32 != journalCrc(entry)) {
+      continue;
+    }
+
+    char name[CURSOR_NAME_LEN + 1] = {};
+    memcpy(name, entry.cursor.name, CURSOR_NAME_LEN);
+    int index = -1;
+    for (int i = 0; i < (int)MAX_CURSORS; i++) {
+      if ((s_cursors[i].used || cursorSeq[i] > 0) &&
+          strcmp(s_cursors[i].name, name) == 0) {
+        index = i;
+        break;
+      }
+      if (index < 0 && !s_cursors[i].used && cursorSeq[i] == 0) {
+        index = i; // First free slot, unless the name shows up later
+      }
+    }
+    if (index < 0 || entry.seq < cursorSeq[index]) {
+      continue;
+    }
 
+    uint64_t position = ((uint64_t)entry.cursor.positionHi << 32) |
+                        entry.cursor.positionLo;
+    Cursor &cursor = s_cursors[index];
+    memcpy(cursor.name, name, sizeof(cursor.name));
+    cursor.used = (position != CURSOR_CLOSED);
+    cursor.position = position;
+    cursor.dropped = 0;
+    cursor.dirty = false;
+    cursorSeq[index] = entry.seq;
+  }
+  free(entries);
+
+  s_meta = best.meta;
+  s_journaledMeta = best.meta;
+  s_journaledFlags = best.flags;
+  s_journalSeq = std::max(newestSeq[0], newestSeq[1]);
+  s_journalSector = bestSector;
+  s_journalSlot = usedSlots[bestSector];
+  s_spareState = usedSlots[1 - bestSector] > 0 ? SpareState::DIRTY
+                                               : SpareState::CLEAN;
+
+  ESP_LOGI(TAG, "Journal: seq=%lu, sector=%u, slot=%u", s_journalSeq,
+           s_journalSector, s_journalSlot);
+  return ESP_OK;
+}
+
+static void makeMetaEntry(const Metadata &meta, uint32_t flags,
+                          JournalEntry *entry) {
+  memset(entry, 0xFF, sizeof(*entry));
+  entry->meta = meta;
+  entry->flags = flags;
+}
+
+static void makeCursorEntry(const Cursor &cursor, JournalEntry *entry) {
+  memset(entry, 0xFF, sizeof(*entry));
+  entry->cursor.magic = CURSOR_MAGIC;
+  entry->cursor.positionLo = (uint32_t)cursor.position;
+  entry->cursor.positionHi = (uint32_t)(cursor.position >> 32);
+  memset(entry->cursor.name, 0, CURSOR_NAME_LEN);
+  memcpy(entry->cursor.name, cursor.name, strnlen(cursor.name, CURSOR_NAME_LEN));
+}
+
+// Program one entry at the next free slot. Caller holds s_journalMutex.
+static esp_err_t programEntry(JournalEntry &entry) {
+  entry.seq = s_journalSeq + 1;
+  entry.crc32 = journalCrc(entry);
+
+  esp_err_t ret = esp_partition_write(
+      s_partition, journalAddress(s_journalSector, s_journalSlot), &entry,
+      sizeof(entry));
+
+  // A failed program may leave a partial entry behind, never reuse the slot
+  s_journalSlot++;
+  if (ret == ESP_OK) {
+    s_journalSeq = entry.seq;
+    if (entry.meta.magic == MAGIC_NUMBER) {
+      s_journaledMeta = entry.meta;
+      s_journaledFlags = entry.flags;
+    }
+  } else {
+    ESP_LOGE(TAG, "Failed to save metadata: %s", esp_err_to_name(ret));
+  }
   return ret;
 }
 
+// Move appends to the spare sector and carry the live state over, since
+// the retired sector is erased next. Caller holds s_journalMutex.
+static esp_err_t switchJournalSector() {
+  while (s_spareState == SpareState::ERASING) {
+    xSemaphoreGive(s_journalMutex);
+    vTaskDelay(pdMS_TO_TICKS(5));
+    xSemaphoreTake(s_journalMutex, portMAX_DELAY);
+  }
+  size_t spare = 1 - s_journalSector;
+  if (s_spareState == SpareState::DIRTY) {
+    ESP_LOGW(TAG, "Journal spare not erased yet, erasing now...");
+    esp_err_t ret = eraseJournalSector(spare);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to erase journal sector: %s", esp_err_to_name(ret));
+      return ret;
+    }
+  }
+  s_journalSector = spare;
+  s_journalSlot = 0;
+  s_spareState = SpareState::DIRTY;
+
+  lockState();
+  Metadata meta = s_meta;
+  uint32_t flags = entryFlags();
+  Cursor cursors[MAX_CURSORS];
+  memcpy(cursors, s_cursors, sizeof(cursors));
+  unlockState();
+
+  JournalEntry entry;
+  makeMetaEntry(meta, flags, &entry);
+  esp_err_t ret = programEntry(entry);
+  for (const Cursor &cursor : cursors) {
+    if (cursor.used) {
+      makeCursorEntry(cursor, &entry);
+      programEntry(entry);
+    }
+  }
+
+  Housekeeping::notify(s_eraseJob);
+  return ret;
+}
+
+// Caller holds s_journalMutex
+static esp_err_t appendEntry(JournalEntry &entry) {
+  if (s_journalSlot >= JOURNAL_SLOTS) {
+    esp_err_t ret = switchJournalSector();
+    if (ret != ESP_OK) {
+      return ret;
+    }
+  }
+  return programEntry(entry);
+}
+
+// Append the current metadata and any moved cursors to the journal
+// (nothing is written if unchanged)
 static esp_err_t saveMetadata() {
-  nvs_handle_t handle;
-  esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
-  if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
-    return ret;
+  xSemaphoreTake(s_journalMutex, portMAX_DELAY);
+
+  lockState();
+  Metadata snapshot = s_meta;
+  uint32_t flags = entryFlags();
+  Cursor dirty[MAX_CURSORS];
+  size_t dirtyCount = 0;
+  for (Cursor &cursor : s_cursors) {
+    if (cursor.used && cursor.dirty) {
+      dirty[dirtyCount++] = cursor;
+      cursor.dirty = false;
+    }
+  }
+  unlockState();
+
+  esp_err_t ret = ESP_OK;
+  JournalEntry entry;
+  if (s_journalSeq == 0 || flags != s_journaledFlags ||
+      memcmp(&snapshot, &s_journaledMeta, sizeof(Metadata)) != 0) {
+    makeMetaEntry(snapshot, flags, &entry);
+    ret = appendEntry(entry);
+  }
+  for (size_t i = 0; i < dirtyCount; i++) {
+    makeCursorEntry(dirty[i], &entry);
+    esp_err_t cursorRet = appendEntry(entry);
+    if (ret == ESP_OK) {
+      ret = cursorRet;
+    }
   }
 
-  ret = nvs_set_blob(handle, NVS_KEY_META, &s_meta, sizeof(Metadata));
-  if (ret == ESP_OK) {
-    ret = nvs_commit(handle);
+  xSemaphoreGive(s_journalMutex);
+  return ret;
+}
+
+static esp_err_t eraseJournalSector(size_t sector) {
+  return esp_partition_erase_range(s_partition, journalAddress(sector, 0),
+                                   PAGE_SIZE);
+}
+
+// Erase the retired journal sector so the next switch is instant.
+// Called from the erase job.
+static void eraseSpareJournal() {
+  xSemaphoreTake(s_journalMutex, portMAX_DELAY);
+  if (s_spareState != SpareState::DIRTY) {
+    xSemaphoreGive(s_journalMutex);
+    return;
   }
-  nvs_close(handle);
+  size_t spare = 1 - s_journalSector;
+  s_spareState = SpareState::ERASING;
+  xSemaphoreGive(s_journalMutex);
+
+  esp_err_t ret = eraseJournalSector(spare);
+
+  xSemaphoreTake(s_journalMutex, portMAX_DELAY);
+  s_spareState = (ret == ESP_OK) ? SpareState::CLEAN : SpareState::DIRTY;
+  xSemaphoreGive(s_journalMutex);
 
   if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to save metadata: %s", esp_err_to_name(ret));
+    ESP_LOGE(TAG, "Failed to erase journal sector %u: %s", spare,
+             esp_err_to_name(ret));
   }
-  return ret;
 }
 
+// A journal entry is appended whenever the head enters a new page, so data
+// written after the last entry can only be in the head page. Everything
+// past the last programmed byte of that page is still blank.
+static void recoverHead() {
+  size_t head = s_meta.head;
+  if (head % PAGE_SIZE == 0 && !(s_journaledFlags & ENTRY_HEAD_PAGE_OPEN)) {
+    // The writer had not entered the page yet: it still holds old data
+    // (or a torn erase), none of it written after the entry
+    return;
+  }
+  size_t pageEnd = (head / PAGE_SIZE + 1) * PAGE_SIZE;
+  size_t newHead = head;
+
+  uint8_t buf[256];
+  for (size_t pos = head; pos < pageEnd; pos += sizeof(buf)) {
+    size_t chunk = std::min(sizeof(buf), pageEnd - pos);
+    if (esp_partition_read(s_partition, pos, buf, chunk) != ESP_OK) {
+      ESP_LOGW(TAG, "Head page read failed, keeping journaled head");
+      return;
+    }
+    for (size_t i = chunk; i > 0; i--) {
+      if (buf[i - 1] != 0xFF) {
+        newHead = pos + i;
+        break;
+      }
+    }
+  }
+
+  if (newHead == head) {
+    return;
+  }
+
+  size_t recovered = newHead - head;
+  s_meta.totalWritten += recovered;
+  if (newHead == s_partitionSize) {
+    newHead = 0;
+    s_meta.wrapCount++;
+  }
+  s_meta.head = newHead;
+  ESP_LOGI(TAG, "Recovered %u bytes written after the last journal entry",
+           recovered);
+}
+
+// Remove the metadata blob left in NVS by older firmware
+static void dropLegacyMetadata() {
+  nvs_handle_t handle;
+  if (nvs_open(LEGACY_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+    return;
+  }
+  if (nvs_erase_key(handle, LEGACY_NVS_KEY_META) == ESP_OK) {
+    nvs_commit(handle);
+    ESP_LOGI(TAG, "Removed legacy NVS metadata");
+  }
+  nvs_close(handle);
+}
+
+// Callers hold s_stateMutex. Position of the head counted from the last
+// erase, is congruent to the physical head modulo the ring size.
+static uint64_t logicalHead() {
+  return (uint64_t)s_meta.wrapCount * s_partitionSize + s_meta.head;
+}
+
+// Callers hold s_stateMutex
 static size_t getUsedBytes() {
   if (s_meta.head >= s_meta.tail) {
     return s_meta.head - s_meta.tail;
@@ -366,93 +1351,380 @@ static size_t getUsedBytes() {
   }
 }
 
+// Callers hold s_stateMutex
 static size_t getFreeBytes() {
   return s_partitionSize - getUsedBytes() - 1;
 }
 
-static bool isPageErased(size_t pageNum) {
-  xSemaphoreTake(s_eraseMutex, portMAX_DELAY);
-  bool erased = false;
-  for (size_t i = 0; i < PRE_ERASE_PAGES; i++) {
-    if (s_erasedPages[i] == pageNum) {
-      erased = true;
-      break;
+// Callers hold s_stateMutex
+static size_t firstUnwrittenPage() {
+  size_t page = (s_meta.head + PAGE_SIZE - 1) / PAGE_SIZE;
+  if (s_headPageTaken) {
+    page++;
+  }
+  return page % s_totalPages;
+}
+
+// Callers hold s_stateMutex. Flags for a metadata entry of the current state.
+static uint32_t entryFlags() {
+  bool open = (s_meta.head % PAGE_SIZE != 0) || s_headPageTaken;
+  return open ? UINT32_MAX : UINT32_MAX & ~ENTRY_HEAD_PAGE_OPEN;
+}
+
+// Callers hold s_stateMutex. Lowest cursor position, UINT64_MAX if none.
+static uint64_t lowestCursor() {
+  uint64_t lowest = UINT64_MAX;
+  for (const Cursor &cursor : s_cursors) {
+    if (cursor.used && cursor.position < lowest) {
+      lowest = cursor.position;
     }
   }
-  xSemaphoreGive(s_eraseMutex);
-  return erased;
+  return lowest;
 }
 
-static void markPageErased(size_t pageNum) {
-  xSemaphoreTake(s_eraseMutex, portMAX_DELAY);
-  // Find empty slot or oldest entry
-  for (size_t i = 0; i < PRE_ERASE_PAGES; i++) {
-    if (s_erasedPages[i] == SIZE_MAX || s_erasedPages[i] == pageNum) {
-      s_erasedPages[i] = pageNum;
-      // Update metadata
-      s_meta.erasedPages[i] = pageNum;
-      xSemaphoreGive(s_eraseMutex);
-      return;
+// Callers hold s_stateMutex. Cursors the tail has passed lose that data.
+static void clampCursors() {
+  uint64_t tail = logicalHead() - getUsedBytes();
+  for (Cursor &cursor : s_cursors) {
+    if (cursor.used && cursor.position < tail) {
+      cursor.dropped += tail - cursor.position;
+      cursor.position = tail;
+      cursor.dirty = true;
+      ESP_LOGW(TAG, "Cursor '%s' overrun", cursor.name);
     }
   }
-  // Replace first slot if all full
-  s_erasedPages[0] = pageNum;
-  s_meta.erasedPages[0] = pageNum;
-  xSemaphoreGive(s_eraseMutex);
 }
 
-static esp_err_t ensurePageErased(size_t pageNum) {
-  if (isPageErased(pageNum)) {
-    return ESP_OK;
+// Callers hold s_stateMutex. True if erasing the page would destroy data
+// some cursor has not read yet.
+static bool pageHoldsUnread(size_t pageNum) {
+  size_t pageStart = pageNum * PAGE_SIZE;
+  if (getUsedBytes() == 0 || s_meta.tail < pageStart ||
+      s_meta.tail >= pageStart + PAGE_SIZE) {
+    return false;
+  }
+  uint64_t tail = logicalHead() - getUsedBytes();
+  uint64_t newTail = tail + (pageStart + PAGE_SIZE - s_meta.tail);
+  return lowestCursor() < newTail;
+}
+
+// Callers hold s_stateMutex. Moves the tail out of a page about to be
+// erased; returns true if it did, in which case the new tail must be
+// journaled before the erase starts.
+static bool reclaimPage(size_t pageNum) {
+  size_t pageStart = pageNum * PAGE_SIZE;
+  if (getUsedBytes() > 0 && s_meta.tail >= pageStart &&
+      s_meta.tail < pageStart + PAGE_SIZE) {
+    s_meta.tail = ((pageNum + 1) % s_totalPages) * PAGE_SIZE;
+    clampCursors();
+    ESP_LOGD(TAG, "Overwriting oldest page %u, tail=%lu", pageNum, s_meta.tail);
+    return true;
   }
-  
-  // Page not pre-erased, need to erase now (blocking)
-  ESP_LOGW(TAG, "Page %u not pre-erased, erasing now...", pageNum);
-  esp_err_t ret = esp_partition_erase_range(s_partition, 
-                                             pageNum * PAGE_SIZE, PAGE_SIZE);
+  return false;
+}
+
+static esp_err_t erasePageTimed(size_t pageNum) {
+  int64_t start = esp_timer_get_time();
+  esp_err_t ret = esp_partition_erase_range(s_partition, pageNum * PAGE_SIZE,
+                                            PAGE_SIZE);
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+  PerfCounters::record(PerfCounters::Stage::FLASH_ERASE, elapsed);
+
   if (ret == ESP_OK) {
-    markPageErased(pageNum);
+    lockState();
+    // Exponential moving average, 1/8 weight for the new sample
+    s_avgEraseUs = s_avgEraseUs - (s_avgEraseUs >> 3) + (elapsed >> 3);
+    unlockState();
   }
   return ret;
 }
 
-static void eraseTask(void *arg) {
-  ESP_LOGI(TAG, "Pre-erase task started");
-  
-  while (s_eraseTaskRunning) {
-    if (!s_initialized) {
-      vTaskDelay(pdMS_TO_TICKS(100));
+// Take the next page for writing from the erase window. Called by the
+// writer (s_writeMutex held) when the head sits on a page boundary.
+static esp_err_t acquirePage(size_t pageNum) {
+  int64_t start = esp_timer_get_time();
+  bool stalled = false;
+  esp_err_t ret = ESP_OK;
+
+  while (true) {
+    lockState();
+    if (s_erasedAhead > 0) {
+      s_erasedAhead--;
+      s_headPageTaken = true;
+      unlockState();
+      break;
+    }
+
+    if (s_erasingPage == pageNum) {
+      // The erase job is already on it
+      unlockState();
+      stalled = true;
+      xSemaphoreTake(s_eraseDoneSem, pdMS_TO_TICKS(100));
       continue;
     }
-    
-    // Get current page
-    size_t currentPage = s_meta.head / PAGE_SIZE;
-    
-    // Check and erase pages ahead
-    for (size_t i = 1; i <= PRE_ERASE_PAGES; i++) {
-      size_t targetPage = (currentPage + i) % s_totalPages;
-      
-      if (!isPageErased(targetPage)) {
-        ESP_LOGD(TAG, "Pre-erasing page %u", targetPage);
-        esp_err_t ret = esp_partition_erase_range(s_partition, 
-                                                   targetPage * PAGE_SIZE, 
-                                                   PAGE_SIZE);
-        if (ret == ESP_OK) {
-          markPageErased(targetPage);
-        } else {
-          ESP_LOGE(TAG, "Failed to pre-erase page %u: %s", 
-                   targetPage, esp_err_to_name(ret));
-        }
-        // Only erase one page per iteration to not block too long
-        break;
+
+    if (s_erasingPage != SIZE_MAX) {
+      // Another page is being erased (full format), wait for it
+      unlockState();
+      xSemaphoreTake(s_eraseDoneSem, pdMS_TO_TICKS(100));
+      continue;
+    }
+
+    // Window is empty: erase synchronously
+    s_erasingPage = pageNum;
+    bool tailMoved = reclaimPage(pageNum);
+    unlockState();
+
+    if (tailMoved) {
+      saveMetadata();
+    }
+
+    stalled = true;
+    ESP_LOGW(TAG, "Page %u not pre-erased, erasing now...", pageNum);
+    ret = erasePageTimed(pageNum);
+
+    lockState();
+    s_erasingPage = SIZE_MAX;
+    s_headPageTaken = (ret == ESP_OK);
+    unlockState();
+    xSemaphoreGive(s_eraseDoneSem);
+    break;
+  }
+
+  lockState();
+  if (stalled) {
+    s_eraseStalls++;
+    s_eraseStallUs += (uint64_t)(esp_timer_get_time() - start);
+  } else {
+    s_stallAvoidedUs += s_avgEraseUs;
+  }
+  unlockState();
+
+  // Refill the window
+  Housekeeping::notify(s_eraseJob);
+
+  // Journal the page boundary (and that the page is now open) so recovery
+  // only has to scan the head page
+  if (ret == ESP_OK) {
+    saveMetadata();
+  }
+  return ret;
+}
+
+// Program data at the head. Caller holds s_writeMutex.
+static esp_err_t programChunk(const uint8_t *data, size_t len) {
+  size_t bytesWritten = 0;
+
+  while (bytesWritten < len) {
+    // Only the writer moves the head, so it can be read without the lock
+    size_t head = s_meta.head;
+
+    // Calculate bytes to end of current page
+    size_t offsetInPage = head % PAGE_SIZE;
+    size_t bytesToPageEnd = PAGE_SIZE - offsetInPage;
+
+    // Calculate how much to write in this iteration
+    size_t toEndOfPartition = s_partitionSize - head;
+    size_t remaining = len - bytesWritten;
+    size_t chunkSize = std::min({remaining, bytesToPageEnd, toEndOfPartition});
+
+    // Entering a new page: it must come from the erase window
+    if (offsetInPage == 0) {
+      esp_err_t ret = acquirePage(head / PAGE_SIZE);
+      if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to erase page %u: %s", head / PAGE_SIZE,
+                 esp_err_to_name(ret));
+        return ret;
       }
     }
-    
-    vTaskDelay(pdMS_TO_TICKS(50));
+
+    // Filling the page up to the tail would make the full ring look empty
+    // (head == tail): drop the oldest page first. Only happens when the
+    // erase window has run dry and the tail starts the next page.
+    lockState();
+    if (getUsedBytes() > 0 && (head + chunkSize) % s_partitionSize == s_meta.tail) {
+      reclaimPage(s_meta.tail / PAGE_SIZE);
+    }
+    unlockState();
+
+    // Write the chunk
+    int64_t writeStart = esp_timer_get_time();
+    esp_err_t ret = esp_partition_write(s_partition, head,
+                                         data + bytesWritten, chunkSize);
+    PerfCounters::recordSince(PerfCounters::Stage::FLASH_WRITE, writeStart);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "esp_partition_write failed at offset %u: %s", head,
+               esp_err_to_name(ret));
+      return ret;
+    }
+
+    size_t newHead = (head + chunkSize) % s_partitionSize;
+
+    lockState();
+    s_meta.head = newHead;
+    s_headPageTaken = false;
+    s_meta.totalWritten += chunkSize;
+    if (newHead < head) {
+      s_meta.wrapCount++;
+      ESP_LOGD(TAG, "Buffer wrapped, count=%lu", s_meta.wrapCount);
+    }
+    unlockState();
+
+    bytesWritten += chunkSize;
+    PerfCounters::addBytes(PerfCounters::Counter::FLASHED, chunkSize);
   }
-  
-  ESP_LOGI(TAG, "Pre-erase task stopped");
-  vTaskDelete(nullptr);
+
+  updateIngestRate(len);
+
+  ESP_LOGD(TAG, "Wrote %u bytes, head=%lu, tail=%lu", len, s_meta.head,
+           s_meta.tail);
+  return ESP_OK;
+}
+
+// Reprogram bytes already written (only 1 -> 0 bit transitions take effect).
+// Caller holds s_writeMutex.
+static esp_err_t programAmend(uint64_t position, const uint8_t *data, size_t len) {
+  lockState();
+  uint64_t head = logicalHead();
+  uint64_t tail = head - getUsedBytes();
+  unlockState();
+
+  if (position < tail || position + len > head) {
+    ESP_LOGW(TAG, "Amend outside stored data, skipped");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  size_t done = 0;
+  while (done < len) {
+    size_t phys = (size_t)((position + done) % s_partitionSize);
+    size_t chunk = std::min(len - done, s_partitionSize - phys);
+    esp_err_t ret = esp_partition_write(s_partition, phys, data + done, chunk);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Amend failed at offset %u: %s", phys, esp_err_to_name(ret));
+      return ret;
+    }
+    done += chunk;
+  }
+  return ESP_OK;
+}
+
+// Track the write rate and size the erase window to cover
+// LOOKAHEAD_HORIZON_MS of ingest (or a few erase durations, if longer)
+static void updateIngestRate(size_t bytes) {
+  int64_t now = esp_timer_get_time();
+  if (s_rateWindowStart == 0) {
+    s_rateWindowStart = now;
+  }
+  s_rateWindowBytes += bytes;
+
+  int64_t elapsed = now - s_rateWindowStart;
+  if (elapsed < 1000000) {
+    return;
+  }
+
+  uint32_t rate = (uint32_t)((uint64_t)s_rateWindowBytes * 1000000 / elapsed);
+  s_rateWindowStart = now;
+  s_rateWindowBytes = 0;
+
+  lockState();
+  // Moving average, 1/4 weight for the new sample
+  s_ingestRate = s_ingestRate - (s_ingestRate >> 2) + (rate >> 2);
+
+  uint64_t horizonUs = std::max<uint64_t>(LOOKAHEAD_HORIZON_MS * 1000ULL,
+                                          4ULL * s_avgEraseUs);
+  size_t pages = (size_t)(((uint64_t)s_ingestRate * horizonUs / 1000000 +
+                           PAGE_SIZE - 1) / PAGE_SIZE);
+  size_t maxPages = std::min(MAX_PRE_ERASE_PAGES, s_totalPages / 4);
+  s_lookAheadPages = std::max(MIN_PRE_ERASE_PAGES, std::min(pages, maxPages));
+  unlockState();
+}
+
+// Pre-erase job: erases the spare journal sector when needed and extends
+// the window by one page per run. Notified whenever the writer enters a new
+// page or the journal moves on; the window only needs more pages after that.
+static uint32_t eraseJob(void *ctx) {
+  (void)ctx;
+  eraseSpareJournal();
+
+  lockState();
+  if (s_erasedAhead >= s_lookAheadPages || s_erasingPage != SIZE_MAX ||
+      s_erasedAhead + 2 > s_totalPages) {
+    unlockState();
+    return Housekeeping::IDLE;
+  }
+
+  // Extend the window by one page, dropping the oldest data if the tail
+  // lives there. Beyond the minimum window, data that a cursor has not read
+  // yet is only overwritten when the writer needs it; retry once cursors
+  // had time to move on.
+  size_t targetPage = (firstUnwrittenPage() + s_erasedAhead) % s_totalPages;
+  if (s_erasedAhead >= MIN_PRE_ERASE_PAGES && pageHoldsUnread(targetPage)) {
+    unlockState();
+    return ERASE_RETRY_MS;
+  }
+  s_erasingPage = targetPage;
+  bool tailMoved = reclaimPage(targetPage);
+  unlockState();
+
+  if (tailMoved) {
+    saveMetadata();
+  }
+
+  ESP_LOGD(TAG, "Pre-erasing page %u", targetPage);
+  esp_err_t ret = erasePageTimed(targetPage);
+
+  lockState();
+  s_erasingPage = SIZE_MAX;
+  if (ret == ESP_OK) {
+    s_erasedAhead++;
+  }
+  unlockState();
+  xSemaphoreGive(s_eraseDoneSem);
+
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to pre-erase page %u: %s", targetPage,
+             esp_err_to_name(ret));
+    return ERASE_RETRY_MS;
+  }
+  return 0; // Next page after the other due jobs
+}
+
+static void programTask(void *arg) {
+  ESP_LOGI(TAG, "Program task started on Core %d", xPortGetCoreID());
+
+  WriteRequest req;
+  while (s_programTaskRunning) {
+    if (xQueueReceive(s_writeQueue, &req, pdMS_TO_TICKS(100)) != pdTRUE) {
+      continue;
+    }
+
+    esp_err_t ret = ESP_OK;
+    bool append = (req.amendAt == NO_AMEND);
+    if (req.data) {
+      xSemaphoreTake(s_writeMutex, portMAX_DELAY);
+      ret = append ? programChunk(req.data, req.len)
+                   : programAmend(req.amendAt, req.data, req.len);
+      xSemaphoreGive(s_writeMutex);
+    } else {
+      // Barrier: persist the state reached by all earlier writes
+      ret = saveMetadata();
+    }
+
+    lockState();
+    if (append) {
+      s_queuedBytes -= req.len;
+    }
+    s_inFlight--;
+    unlockState();
+
+    if (req.callback) {
+      req.callback(req.data, req.len, ret, req.ctx);
+    }
+  }
+
+  ESP_LOGI(TAG, "Program task stopped");
+  s_programTaskHandle = nullptr;
+  MemoryPlan::exitTask(MemoryPlan::Region::TASK_FLASH_PROGRAM);
 }
 
 } // namespace FlashRing
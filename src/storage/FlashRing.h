@@ -4,6 +4,7 @@
 #include <cstddef>
 #include "esp_err.h"
 #include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
 
 /**
  * @brief FlashRing - Circular buffer on raw flash partition (direct access)
@@ -14,10 +15,15 @@
  * 
  * Features:
  * - Direct flash access for maximum speed
- * - Persistent metadata in NVS (survives reboots)
+ * - Persistent metadata in an append-only journal kept in the last
+ *   JOURNAL_SECTORS sectors of the partition (survives reboots)
  * - Block-aligned writes for efficiency
  * - Automatic wrap-around with oldest data discard
  * - Circular writing distributes wear naturally
+ * - Asynchronous write engine: a program task drains an in-flight queue
+ *   while the caller fills the next page
+ * - Erase look-ahead window sized from the observed ingest rate
+ * - Zero-copy reads through memory-mapped windows (mapLogical())
  */
 
 namespace FlashRing {
@@ -25,17 +31,49 @@ namespace FlashRing {
 /// Block size for flash operations (must match flash page size)
 constexpr size_t PAGE_SIZE = 4096;
 
-/// Number of pages to pre-erase ahead of write position
-constexpr size_t PRE_ERASE_PAGES = 2;
+/// Minimum number of pages kept pre-erased ahead of the write position
+constexpr size_t MIN_PRE_ERASE_PAGES = 2;
 
-/// Metadata structure stored in NVS
+/// Upper bound for the adaptive erase look-ahead window
+constexpr size_t MAX_PRE_ERASE_PAGES = 16;
+
+/// Ingest time the look-ahead window should cover
+constexpr uint32_t LOOKAHEAD_HORIZON_MS = 250;
+
+/// Maximum number of asynchronous writes in flight
+constexpr size_t WRITE_QUEUE_DEPTH = 8;
+
+/// Sectors reserved at the end of the partition for the metadata journal
+constexpr size_t JOURNAL_SECTORS = 2;
+
+/// Maximum number of named read cursors
+constexpr size_t MAX_CURSORS = 4;
+
+/// Maximum cursor name length
+constexpr size_t CURSOR_NAME_LEN = 8;
+
+/// Handle returned by openCursor()
+using CursorId = int;
+
+/// Bytes covered by one memory-mapped window (one MMU page)
+constexpr size_t MMAP_WINDOW_SIZE = 64 * 1024;
+
+/// Windows kept mapped at once, shared by all readers
+constexpr size_t MMAP_WINDOWS = 4;
+
+/// Read-only view of stored bytes, returned by mapLogical()
+struct Span {
+    const uint8_t* data; ///< Mapped flash, do not write
+    size_t len;          ///< Bytes at data
+};
+
+/// Metadata snapshot recorded in each journal entry
 struct Metadata {
     uint32_t magic;         ///< Validation magic number
     uint32_t head;          ///< Next write position (bytes from partition start)
     uint32_t tail;          ///< Oldest data position (bytes from partition start)
     uint32_t totalWritten;  ///< Total bytes written (lifetime, wraps at 4GB)
     uint32_t wrapCount;     ///< Number of times buffer has wrapped
-    uint32_t erasedPages[PRE_ERASE_PAGES]; ///< Pages that are pre-erased (SIZE_MAX = empty)
 };
 
 /// Statistics for debugging and monitoring
@@ -45,13 +83,47 @@ struct Stats {
     size_t   freeBytes;      ///< Bytes available before wrap
     uint32_t wrapCount;      ///< Times buffer has wrapped
     uint32_t totalWritten;   ///< Total bytes written (lifetime)
+    uint32_t lookAheadPages; ///< Current erase look-ahead target
+    uint32_t erasedAhead;    ///< Pages currently pre-erased ahead of head
+    uint32_t ingestRate;     ///< Smoothed write rate in bytes/s
+    uint32_t avgEraseUs;     ///< Smoothed duration of one sector erase
+    uint32_t eraseStalls;    ///< Page writes that had to wait for an erase
+    uint64_t eraseStallUs;   ///< Total time spent waiting for erases
+    uint64_t stallAvoidedUs; ///< Erase time hidden by the look-ahead window
+    uint32_t writeQueueDepth;     ///< Asynchronous writes currently in flight
+    uint32_t writeQueueHighWater; ///< Maximum writes in flight
+    uint32_t journalSeq;          ///< Sequence number of the latest journal entry
+    uint32_t cursorCount;         ///< Open read cursors
+    uint64_t unreadBytes;         ///< Bytes behind the lowest cursor's position
+};
+
+/// State of one read cursor
+struct CursorInfo {
+    char     name[CURSOR_NAME_LEN + 1]; ///< Cursor name
+    uint64_t position;  ///< Logical position of the next unread byte
+    uint64_t pending;   ///< Bytes written but not yet read
+    uint64_t dropped;   ///< Unread bytes lost to overwrite since boot
 };
 
+/**
+ * @brief Completion callback for writeAsync()
+ *
+ * Runs in the flash program task once the data has been programmed (or
+ * failed). The buffer may be reused from this point on.
+ *
+ * @param data   Buffer passed to writeAsync()
+ * @param len    Length passed to writeAsync()
+ * @param result ESP_OK or the flash error
+ * @param ctx    User context passed to writeAsync()
+ */
+using WriteCallback = void (*)(const uint8_t* data, size_t len, esp_err_t result, void* ctx);
+
 /**
  * @brief Initialize the FlashRing module
  * 
- * Mounts the wear leveling partition and loads metadata from NVS.
- * If no valid metadata exists, initializes fresh.
+ * Recovers the latest metadata by scanning the journal sectors, then
+ * extends the head over any data programmed after the last entry.
+ * If no valid entry exists, initializes fresh.
  * 
  * @param partitionLabel Label of the data partition (e.g., "datalog")
  * @return ESP_OK on success, error code otherwise
@@ -70,6 +142,54 @@ esp_err_t init(const char* partitionLabel);
  */
 esp_err_t write(const uint8_t* data, size_t len);
 
+/**
+ * @brief Queue data for writing without waiting for the flash
+ *
+ * The buffer must stay valid until the callback runs. Writes are
+ * programmed in submission order, after any write() already in progress.
+ *
+ * @param data     Pointer to data to write
+ * @param len      Number of bytes to write
+ * @param callback Completion callback (may be nullptr)
+ * @param ctx      User context for the callback
+ * @param wait     Ticks to wait for a free queue entry
+ * @return ESP_OK if queued, ESP_ERR_TIMEOUT if the queue stayed full
+ */
+esp_err_t writeAsync(const uint8_t* data, size_t len, WriteCallback callback,
+                     void* ctx, TickType_t wait);
+
+/**
+ * @brief Queue a metadata flush behind the pending asynchronous writes
+ *
+ * @return ESP_OK if queued
+ */
+esp_err_t flushMetadataAsync();
+
+/**
+ * @brief Queue an in-place update of bytes that are already written
+ *
+ * Flash programming can only clear bits, so this is meant for fields
+ * written as 0xFF and filled in later (e.g. a record length). Ordered with
+ * the other queued writes; skipped if the position has been overwritten.
+ *
+ * @param position Logical position (see getLogicalHead())
+ * @param data     New contents, must stay valid until the callback runs
+ * @param len      Number of bytes (at most PAGE_SIZE)
+ * @param callback Completion callback (may be nullptr)
+ * @param ctx      User context for the callback
+ * @return ESP_OK if queued
+ */
+esp_err_t amendAsync(uint64_t position, const uint8_t* data, size_t len,
+                     WriteCallback callback, void* ctx);
+
+/**
+ * @brief Wait until all asynchronous writes have been programmed
+ *
+ * @param wait Maximum ticks to wait
+ * @return ESP_OK when idle, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t waitIdle(TickType_t wait);
+
 /**
  * @brief Read data from the circular buffer
  * 
@@ -94,6 +214,122 @@ esp_err_t read(uint8_t* data, size_t len, size_t* bytesRead);
  */
 esp_err_t readAt(size_t offset, uint8_t* data, size_t len, size_t* bytesRead);
 
+/**
+ * @brief Read data at a logical position
+ *
+ * Logical positions count bytes written since the last erase() and never
+ * wrap, so they stay valid as the ring rotates until the data is
+ * overwritten.
+ *
+ * @param position  Logical position to read from
+ * @param data      Buffer to read into
+ * @param len       Maximum bytes to read
+ * @param bytesRead Actual bytes read (output, clipped at the head)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if the position was overwritten
+ */
+esp_err_t readLogical(uint64_t position, uint8_t* data, size_t len, size_t* bytesRead);
+
+/**
+ * @brief Map data at a logical position without copying it
+ *
+ * Returns up to two spans pointing straight into the memory-mapped
+ * partition: a second span covers data past the wrap point or the end
+ * of a window. The spans can be passed directly to a socket or an MQTT
+ * publish. Windows stay mapped between calls, so sequential reads do not
+ * remap.
+ *
+ * The flash behind a span is not locked against the writer. After using
+ * the spans, check that getLogicalTail() is still <= @p position, or the
+ * data may have been overwritten in the meantime. Release the spans with
+ * unmapSpans() once done.
+ *
+ * @param position Logical position to map from
+ * @param len      Maximum bytes to map
+ * @param spans    Two spans (output)
+ * @param count    Spans filled (output, 0 at the head), total may be < len
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the position was overwritten, or
+ *         ESP_ERR_NO_MEM if all windows are in use (use readLogical())
+ */
+esp_err_t mapLogical(uint64_t position, size_t len, Span spans[2], size_t* count);
+
+/**
+ * @brief Release spans returned by mapLogical()
+ *
+ * Their windows stay mapped for the next read but may be reused.
+ */
+void unmapSpans(const Span spans[2], size_t count);
+
+/**
+ * @brief Logical position of the head (programmed data only)
+ */
+uint64_t getLogicalHead();
+
+/**
+ * @brief Logical position of the oldest stored byte
+ */
+uint64_t getLogicalTail();
+
+/**
+ * @brief Logical position the next writeAsync() data will land at
+ */
+uint64_t getQueuedHead();
+
+/**
+ * @brief Open (or create) a named read cursor
+ *
+ * Cursors let several consumers drain the ring independently. Positions
+ * are journaled with the metadata, so a consumer resumes where it left off
+ * after a reboot. A new cursor starts at the oldest stored data.
+ *
+ * Data below the lowest cursor may be pre-erased freely; unread data is
+ * only overwritten when the writer runs out of space, in which case the
+ * affected cursors jump to the tail and count the loss in `dropped`.
+ *
+ * @param name Cursor name (1..CURSOR_NAME_LEN characters)
+ * @param id   Cursor handle (output)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if all MAX_CURSORS slots are taken
+ */
+esp_err_t openCursor(const char* name, CursorId* id);
+
+/**
+ * @brief Look up an existing cursor by name, without creating it
+ * @return ESP_ERR_NOT_FOUND if no cursor has that name
+ */
+esp_err_t findCursor(const char* name, CursorId* id);
+
+/**
+ * @brief Remove a cursor (its position is forgotten)
+ */
+esp_err_t closeCursor(CursorId id);
+
+/**
+ * @brief Get the state of a cursor
+ */
+esp_err_t getCursor(CursorId id, CursorInfo* info);
+
+/**
+ * @brief Read unread data at the cursor without advancing it
+ *
+ * @param id        Cursor handle
+ * @param data      Buffer to read into
+ * @param len       Maximum bytes to read
+ * @param bytesRead Actual bytes read (output, 0 when caught up)
+ * @return ESP_OK on success
+ */
+esp_err_t readCursor(CursorId id, uint8_t* data, size_t len, size_t* bytesRead);
+
+/**
+ * @brief Mark bytes as read (e.g. once acknowledged by the uplink)
+ *
+ * Persisted with the next metadata save.
+ */
+esp_err_t advanceCursor(CursorId id, size_t len);
+
+/**
+ * @brief Move a cursor to a logical position (clamped to the stored data)
+ */
+esp_err_t seekCursor(CursorId id, uint64_t position);
+
 /**
  * @brief Consume (discard) data from the buffer
  * 
@@ -122,9 +358,10 @@ esp_err_t getStats(Stats* stats);
 esp_err_t erase();
 
 /**
- * @brief Flush metadata to NVS
+ * @brief Append the current metadata to the journal
  * 
- * Called periodically or after burst to ensure persistence.
+ * Called periodically or after burst to ensure persistence. A single
+ * 32-byte program; nothing is written if the state has not changed.
  * 
  * @return ESP_OK on success
  */
@@ -138,6 +375,10 @@ size_t getHead();
 
 /**
  * @brief Get bytes remaining until end of current page
+ *
+ * Accounts for asynchronous writes still in flight, so a caller filling
+ * page buffers can align the next submission to a page boundary.
+ *
  * @return Bytes until page boundary
  */
 size_t getBytesToPageEnd();
@@ -0,0 +1,58 @@
+#include "FlashRingBackend.h"
+#include "FlashRing.h"
+
+esp_err_t FlashRingBackend::writeAsync(const uint8_t* data, size_t len,
+                                       Storage::WriteCallback callback, void* ctx,
+                                       TickType_t wait) {
+    return FlashRing::writeAsync(data, len, callback, ctx, wait);
+}
+
+esp_err_t FlashRingBackend::flushAsync() {
+    return FlashRing::flushMetadataAsync();
+}
+
+esp_err_t FlashRingBackend::waitIdle(TickType_t wait) {
+    return FlashRing::waitIdle(wait);
+}
+
+esp_err_t FlashRingBackend::readLogical(uint64_t position, uint8_t* data, size_t len,
+                                        size_t* bytesRead) {
+    return FlashRing::readLogical(position, data, len, bytesRead);
+}
+
+uint64_t FlashRingBackend::getLogicalHead() {
+    return FlashRing::getLogicalHead();
+}
+
+uint64_t FlashRingBackend::getLogicalTail() {
+    return FlashRing::getLogicalTail();
+}
+
+uint64_t FlashRingBackend::getQueuedHead() {
+    return FlashRing::getQueuedHead();
+}
+
+size_t FlashRingBackend::getBytesToPageEnd() {
+    return FlashRing::getBytesToPageEnd();
+}
+
+esp_err_t FlashRingBackend::getStats(Storage::Stats* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    FlashRing::Stats fs;
+    esp_err_t ret = FlashRing::getStats(&fs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    *stats = {};
+    stats->capacity = fs.partitionSize;
+    stats->usedBytes = fs.usedBytes;
+    stats->totalWritten = fs.totalWritten;
+    stats->writeQueueHighWater = fs.writeQueueHighWater;
+    stats->eraseStalls = fs.eraseStalls;
+    stats->eraseStallUs = fs.eraseStallUs;
+    stats->stallAvoidedUs = fs.stallAvoidedUs;
+    stats->lookAheadPages = fs.lookAheadPages;
+    return ESP_OK;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "IStorageBackend.h"
+
+/**
+ * @brief FlashRingBackend - IStorageBackend over the FlashRing partition
+ *
+ * Thin adapter: FlashRing stays a namespace module (RecordStore and the
+ * web/CLI readers use it directly), this class only exposes its write
+ * engine through the backend interface. FlashRing::init() must have been
+ * called before use.
+ */
+class FlashRingBackend : public IStorageBackend {
+public:
+    esp_err_t writeAsync(const uint8_t* data, size_t len, Storage::WriteCallback callback,
+                         void* ctx, TickType_t wait) override;
+    esp_err_t flushAsync() override;
+    esp_err_t waitIdle(TickType_t wait) override;
+    esp_err_t readLogical(uint64_t position, uint8_t* data, size_t len,
+                          size_t* bytesRead) override;
+    uint64_t getLogicalHead() override;
+    uint64_t getLogicalTail() override;
+    uint64_t getQueuedHead() override;
+    size_t getBytesToPageEnd() override;
+    esp_err_t getStats(Storage::Stats* stats) override;
+    Storage::Type getType() const override { return Storage::Type::FLASH_RING; }
+};
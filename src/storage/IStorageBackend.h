@@ -0,0 +1,92 @@
+#pragma once
+
+#include "FlashRing.h"
+#include "StorageTypes.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+/**
+ * @brief Abstract interface for storage backends
+ *
+ * This interface allows DataPipeline and the storage tiering to write to
+ * any append-only store (internal flash ring, SD card, ...) without
+ * knowing the specific details of each medium, the way IDataSource
+ * abstracts transports.
+ *
+ * Data is appended in submission order and addressed by logical
+ * positions: bytes written since the store was last erased, never
+ * wrapping. When a backend is full its oldest data is dropped, which
+ * moves the logical tail forward.
+ *
+ * Writes are at most PAGE_SIZE bytes, the unit DataPipeline fills.
+ */
+class IStorageBackend {
+public:
+    /// Largest single write (one flash page)
+    static constexpr size_t PAGE_SIZE = FlashRing::PAGE_SIZE;
+
+    virtual ~IStorageBackend() = default;
+
+    /**
+     * @brief Queue data for writing without waiting for the medium
+     *
+     * The buffer must stay valid until the callback runs.
+     * @param data     Pointer to data to write
+     * @param len      Number of bytes to write (at most PAGE_SIZE)
+     * @param callback Completion callback (may be nullptr)
+     * @param ctx      User context for the callback
+     * @param wait     Ticks to wait for a free queue entry
+     * @return ESP_OK if queued, ESP_ERR_TIMEOUT if the queue stayed full
+     */
+    virtual esp_err_t writeAsync(const uint8_t* data, size_t len, Storage::WriteCallback callback,
+                                 void* ctx, TickType_t wait) = 0;
+
+    /**
+     * @brief Queue a metadata save behind the pending writes
+     *
+     * Afterwards the data written so far survives a reset.
+     */
+    virtual esp_err_t flushAsync() = 0;
+
+    /**
+     * @brief Wait until all queued writes are stored
+     * @return ESP_OK when idle, ESP_ERR_TIMEOUT otherwise
+     */
+    virtual esp_err_t waitIdle(TickType_t wait) = 0;
+
+    /**
+     * @brief Read data at a logical position
+     * @return ESP_OK, or ESP_ERR_NOT_FOUND if the position was dropped
+     */
+    virtual esp_err_t readLogical(uint64_t position, uint8_t* data, size_t len,
+                                  size_t* bytesRead) = 0;
+
+    /// Logical position of the newest stored byte + 1
+    virtual uint64_t getLogicalHead() = 0;
+
+    /// Logical position of the oldest stored byte
+    virtual uint64_t getLogicalTail() = 0;
+
+    /// Logical position the next writeAsync() data will land at
+    virtual uint64_t getQueuedHead() = 0;
+
+    /**
+     * @brief Bytes until the end of the medium's current write unit
+     *
+     * Writers that fill pages use it to keep writes aligned. Backends
+     * without alignment needs keep this default.
+     */
+    virtual size_t getBytesToPageEnd() { return PAGE_SIZE - (size_t)(getQueuedHead() % PAGE_SIZE); }
+
+    /**
+     * @brief Get backend statistics
+     * @param stats Pointer to stats structure (output)
+     * @return ESP_OK on success
+     */
+    virtual esp_err_t getStats(Storage::Stats* stats) = 0;
+
+    /**
+     * @brief Get backend type
+     */
+    virtual Storage::Type getType() const = 0;
+};
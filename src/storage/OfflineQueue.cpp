@@ -0,0 +1,515 @@
+#include "OfflineQueue.h"
+#include "esp_crc.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <cstring>
+
+static const char *TAG = "OfflineQueue";
+
+// Sector header magic "OFQ1"
+static const uint32_t SECTOR_MAGIC = 0x3151464F;
+
+// EntryHeader::delivered: blank while pending, programmed to zero after
+static const uint32_t ENTRY_PENDING = 0xFFFFFFFF;
+static const uint32_t ENTRY_DELIVERED = 0;
+
+static const size_t SECTOR_SIZE = 4096;
+static const size_t MAX_SECTORS = 16;
+
+namespace OfflineQueue {
+
+/// Start of every sector
+struct SectorHeader {
+  uint32_t magic;    ///< SECTOR_MAGIC
+  uint32_t age;      ///< Increases with every sector opened (newest = highest)
+  uint32_t firstSeq; ///< Sequence number of the first entry
+  uint32_t crc32;    ///< CRC of the fields above
+};
+
+/// Start of every entry, followed by topic and message
+struct EntryHeader {
+  uint32_t seq;
+  uint16_t length;   ///< Topic + message bytes
+  uint8_t topicLen;
+  uint8_t reserved;  ///< 0xFF
+  uint32_t crc32;    ///< CRC of the fields above and the body
+  uint32_t delivered; ///< ENTRY_PENDING or ENTRY_DELIVERED
+};
+static_assert(sizeof(SectorHeader) == 16 && sizeof(EntryHeader) == 16,
+              "Flash layout");
+
+static constexpr size_t ENTRY_CRC_SPAN = offsetof(EntryHeader, crc32);
+
+struct SectorInfo {
+  uint32_t age; ///< 0: erased or invalid
+  size_t end;   ///< Offset after the last entry
+};
+
+/// Entry position: sector index and offset in it
+struct Position {
+  size_t sector;
+  size_t offset;
+};
+
+static bool s_ready = false;
+static const esp_partition_t *s_partition = nullptr;
+static SemaphoreHandle_t s_mutex = nullptr;
+static size_t s_sectorCount = 0;
+static SectorInfo s_sectors[MAX_SECTORS] = {};
+static size_t s_writeSector = 0; // Newest sector
+static bool s_writeOpen = false; // Appends may go to s_writeSector
+static uint32_t s_age = 0;
+static Position s_read = {};     // Oldest pending entry (if s_pending > 0)
+static Position s_peek = {};     // Next entry returned by next()
+static uint32_t s_nextSeq = 1;
+static uint32_t s_pending = 0;
+static uint32_t s_pendingBytes = 0;
+static uint32_t s_stored = 0;
+static uint32_t s_delivered = 0;
+static uint32_t s_dropped = 0;
+
+// Entry staging, guarded by s_mutex
+static uint8_t s_entry[sizeof(EntryHeader) + MAX_TOPIC + MAX_MESSAGE + 3];
+
+static size_t entrySize(uint16_t length) {
+  return (sizeof(EntryHeader) + length + 3) & ~(size_t)3;
+}
+
+static uint32_t entryCrc(const EntryHeader &header, const uint8_t *body) {
+  uint32_t crc = esp_crc32_le(0, (const uint8_t *)&header, ENTRY_CRC_SPAN);
+  return esp_crc32_le(crc, body, header.length);
+}
+
+static size_t sectorAddress(size_t sector) { return sector * SECTOR_SIZE; }
+
+static Position writePosition() {
+  return {s_writeSector, s_sectors[s_writeSector].end};
+}
+
+static bool atEnd(const Position &pos) {
+  return pos.sector == s_writeSector &&
+         pos.offset >= s_sectors[s_writeSector].end;
+}
+
+// Next valid sector after @p sector in ring order, ending at the newest
+static Position nextSector(size_t sector) {
+  for (size_t i = 1; i <= s_sectorCount; i++) {
+    size_t s = (sector + i) % s_sectorCount;
+    if (s_sectors[s].age != 0 || s == s_writeSector) {
+      return {s, sizeof(SectorHeader)};
+    }
+  }
+  return writePosition();
+}
+
+// Move past the end of older sectors (an empty one included)
+static void normalize(Position *pos) {
+  while (pos->sector != s_writeSector &&
+         pos->offset >= s_sectors[pos->sector].end) {
+    *pos = nextSector(pos->sector);
+  }
+}
+
+static void advance(Position *pos, const EntryHeader &header) {
+  pos->offset += entrySize(header.length);
+  normalize(pos);
+}
+
+static esp_err_t readHeader(const Position &pos, EntryHeader *header) {
+  return esp_partition_read(s_partition, sectorAddress(pos.sector) + pos.offset,
+                            header, sizeof(*header));
+}
+
+// Read and check the entry at @p offset of @p sector, body into s_entry
+// (caller holds s_mutex, or is recovering); false at blank flash or a torn
+// or corrupt entry
+static bool readEntry(size_t sector, size_t offset, EntryHeader *header) {
+  if (offset + sizeof(EntryHeader) > SECTOR_SIZE ||
+      readHeader({sector, offset}, header) != ESP_OK) {
+    return false;
+  }
+  if (header->seq == 0xFFFFFFFF || header->topicLen > MAX_TOPIC ||
+      header->length < header->topicLen ||
+      header->length > header->topicLen + MAX_MESSAGE ||
+      offset + entrySize(header->length) > SECTOR_SIZE) {
+    return false;
+  }
+  uint8_t *body = s_entry + sizeof(EntryHeader);
+  if (esp_partition_read(s_partition,
+                         sectorAddress(sector) + offset + sizeof(EntryHeader),
+                         body, header->length) != ESP_OK) {
+    return false;
+  }
+  return entryCrc(*header, body) == header->crc32;
+}
+
+static void recover() {
+  // Sector headers: the newest one takes appends
+  bool any = false;
+  for (size_t s = 0; s < s_sectorCount; s++) {
+    SectorHeader header;
+    s_sectors[s] = {};
+    if (esp_partition_read(s_partition, sectorAddress(s), &header,
+                           sizeof(header)) != ESP_OK ||
+        header.magic != SECTOR_MAGIC ||
+        esp_crc32_le(0, (const uint8_t *)&header, offsetof(SectorHeader, crc32)) !=
+            header.crc32) {
+      continue;
+    }
+    s_sectors[s].age = header.age;
+    if (!any || header.age > s_age) {
+      s_age = header.age;
+      s_writeSector = s;
+      s_nextSeq = header.firstSeq;
+      any = true;
+    }
+  }
+  if (!any) {
+    s_writeSector = s_sectorCount - 1; // First append opens sector 0
+    s_writeOpen = false;
+    s_read = s_peek = writePosition();
+    return;
+  }
+
+  // Entries, oldest sector first
+  bool foundPending = false;
+  Position pos = nextSector(s_writeSector);
+  while (true) {
+    size_t offset = sizeof(SectorHeader);
+    EntryHeader header;
+    while (readEntry(pos.sector, offset, &header)) {
+      if (header.seq >= s_nextSeq) {
+        s_nextSeq = header.seq + 1;
+      }
+      if (header.delivered == ENTRY_PENDING) {
+        if (!foundPending) {
+          s_read = {pos.sector, offset};
+          foundPending = true;
+        }
+        s_pending++;
+        s_pendingBytes += header.length - header.topicLen;
+      }
+      offset += entrySize(header.length);
+    }
+    s_sectors[pos.sector].end = offset;
+
+    if (pos.sector == s_writeSector) {
+      // A torn entry ends the sector: append in a fresh one
+      EntryHeader blank;
+      s_writeOpen = offset + sizeof(EntryHeader) > SECTOR_SIZE ||
+                    (readHeader({pos.sector, offset}, &blank) == ESP_OK &&
+                     blank.seq == 0xFFFFFFFF);
+      break;
+    }
+    pos = nextSector(pos.sector);
+  }
+  if (!foundPending) {
+    s_read = writePosition();
+  }
+  normalize(&s_read);
+  s_peek = s_read;
+}
+
+// Count the pending entries from s_read on again (after a bad entry)
+static void recount() {
+  s_pending = 0;
+  s_pendingBytes = 0;
+  Position pos = s_read;
+  normalize(&pos);
+  while (!atEnd(pos)) {
+    EntryHeader header;
+    if (!readEntry(pos.sector, pos.offset, &header)) {
+      // The sector ends here; the rest of it is not trusted
+      s_sectors[pos.sector].end = pos.offset;
+      if (pos.sector == s_writeSector) {
+        s_writeOpen = false;
+      }
+      normalize(&pos);
+      continue;
+    }
+    if (header.delivered == ENTRY_PENDING) {
+      s_pending++;
+      s_pendingBytes += header.length - header.topicLen;
+    }
+    advance(&pos, header);
+  }
+  normalize(&s_read);
+  if (s_pending == 0) {
+    s_read = pos;
+  }
+}
+
+// The entry at @p pos failed its checks after recovery (flash corruption):
+// end its sector there and count the queue again
+static void dropCorrupt(const Position &pos) {
+  ESP_LOGE(TAG, "Corrupt entry at sector %u offset %u, rest of sector dropped",
+           (unsigned)pos.sector, (unsigned)pos.offset);
+  uint32_t pendingBefore = s_pending;
+  s_sectors[pos.sector].end = pos.offset;
+  if (pos.sector == s_writeSector) {
+    s_writeOpen = false;
+  }
+  recount();
+  s_dropped += pendingBefore - s_pending;
+}
+
+esp_err_t init(const char *partitionLabel) {
+  if (s_ready) {
+    return ESP_OK;
+  }
+  s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                         ESP_PARTITION_SUBTYPE_ANY,
+                                         partitionLabel);
+  if (!s_partition) {
+    ESP_LOGW(TAG, "Partition '%s' not found", partitionLabel);
+    return ESP_ERR_NOT_FOUND;
+  }
+  s_sectorCount = s_partition->size / SECTOR_SIZE;
+  if (s_sectorCount < 2) {
+    ESP_LOGE(TAG, "Partition '%s' too small", partitionLabel);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if (s_sectorCount > MAX_SECTORS) {
+    s_sectorCount = MAX_SECTORS;
+  }
+  if (!s_mutex) {
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  s_age = 0;
+  s_nextSeq = 1;
+  s_pending = 0;
+  s_pendingBytes = 0;
+  s_stored = s_delivered = s_dropped = 0;
+  recover();
+  s_ready = true;
+
+  ESP_LOGI(TAG, "%u sectors, %lu pending (%lu bytes), next seq %lu",
+           (unsigned)s_sectorCount, s_pending, s_pendingBytes, s_nextSeq);
+  return ESP_OK;
+}
+
+void deinit() {
+  if (s_mutex) {
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+  }
+  s_ready = false;
+  if (s_mutex) {
+    xSemaphoreGive(s_mutex);
+  }
+}
+
+bool isReady() { return s_ready; }
+
+// Drop the undelivered entries of the oldest sector before it is erased
+static void dropSector(size_t sector) {
+  if (s_pending == 0 || s_read.sector != sector) {
+    return;
+  }
+  uint32_t dropped = 0;
+  Position pos = s_read;
+  while (s_pending > 0 && pos.offset < s_sectors[sector].end) {
+    EntryHeader header;
+    if (readHeader(pos, &header) != ESP_OK) {
+      break;
+    }
+    s_pending--;
+    s_pendingBytes -= header.length - header.topicLen;
+    dropped++;
+    pos.offset += entrySize(header.length);
+  }
+  s_dropped += dropped;
+  ESP_LOGW(TAG, "Queue full, %lu undelivered messages dropped", dropped);
+}
+
+static esp_err_t openSector() {
+  size_t sector = (s_writeSector + 1) % s_sectorCount;
+  dropSector(sector);
+  s_sectors[sector] = {};
+
+  esp_err_t ret = esp_partition_erase_range(s_partition, sectorAddress(sector),
+                                            SECTOR_SIZE);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  SectorHeader header = {SECTOR_MAGIC, s_age + 1, s_nextSeq, 0};
+  header.crc32 =
+      esp_crc32_le(0, (const uint8_t *)&header, offsetof(SectorHeader, crc32));
+  ret = esp_partition_write(s_partition, sectorAddress(sector), &header,
+                            sizeof(header));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  bool readDropped = (s_read.sector == sector);
+  s_age++;
+  s_sectors[sector] = {s_age, sizeof(SectorHeader)};
+  s_writeSector = sector;
+  s_writeOpen = true;
+  if (s_pending == 0) {
+    s_read = writePosition();
+  } else if (readDropped) {
+    s_read = nextSector(sector); // Oldest surviving sector
+    normalize(&s_read);
+  }
+  s_peek = s_read;
+  return ESP_OK;
+}
+
+esp_err_t append(const char *topic, const char *data, size_t len) {
+  if (!data) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t topicLen = topic ? strlen(topic) : 0;
+  if (topicLen > MAX_TOPIC || len > MAX_MESSAGE) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if (!s_ready) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  EntryHeader header = {s_nextSeq, (uint16_t)(topicLen + len),
+                        (uint8_t)topicLen, 0xFF, 0, ENTRY_PENDING};
+  size_t size = entrySize(header.length);
+
+  esp_err_t ret = ESP_OK;
+  if (!s_writeOpen || s_sectors[s_writeSector].end + size > SECTOR_SIZE) {
+    ret = openSector();
+  }
+  if (ret == ESP_OK) {
+    uint8_t *body = s_entry + sizeof(EntryHeader);
+    memcpy(body, topic, topicLen);
+    memcpy(body + topicLen, data, len);
+    memset(body + header.length, 0xFF, size - sizeof(EntryHeader) - header.length);
+    header.crc32 = entryCrc(header, body);
+    memcpy(s_entry, &header, sizeof(header));
+
+    Position pos = writePosition();
+    ret = esp_partition_write(s_partition, sectorAddress(pos.sector) + pos.offset,
+                              s_entry, size);
+    if (ret != ESP_OK) {
+      // A failed program may have landed partly: the sector ends before it
+      // and the next append opens a fresh one
+      s_writeOpen = false;
+    } else {
+      s_sectors[pos.sector].end += size;
+      if (s_pending == 0) {
+        s_read = s_peek = pos;
+      }
+      s_nextSeq++;
+      s_pending++;
+      s_pendingBytes += len;
+      s_stored++;
+    }
+  }
+  xSemaphoreGive(s_mutex);
+
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Append failed: %s", esp_err_to_name(ret));
+  }
+  return ret;
+}
+
+uint32_t pending() { return s_pending; }
+
+void rewind() {
+  if (!s_ready) {
+    return;
+  }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  s_peek = s_read;
+  xSemaphoreGive(s_mutex);
+}
+
+esp_err_t next(Message *msg) {
+  if (!msg) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_ready) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  esp_err_t ret = ESP_ERR_NOT_FOUND;
+  while (s_pending > 0 && !atEnd(s_peek)) {
+    EntryHeader header;
+    if (!readEntry(s_peek.sector, s_peek.offset, &header)) {
+      dropCorrupt(s_peek);
+      normalize(&s_peek);
+      continue;
+    }
+    // Lengths are checked against MAX_TOPIC and MAX_MESSAGE by readEntry()
+    const uint8_t *body = s_entry + sizeof(EntryHeader);
+    size_t dataLen = header.length - header.topicLen;
+    memcpy(msg->topic, body, header.topicLen);
+    msg->topic[header.topicLen] = '\0';
+    memcpy(msg->data, body + header.topicLen, dataLen);
+    msg->seq = header.seq;
+    msg->length = (uint16_t)dataLen;
+    advance(&s_peek, header);
+    ret = ESP_OK;
+    break;
+  }
+  xSemaphoreGive(s_mutex);
+  return ret;
+}
+
+esp_err_t markDelivered(uint32_t seq) {
+  if (!s_ready) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  esp_err_t ret = ESP_OK;
+  while (s_pending > 0 && !atEnd(s_read)) {
+    EntryHeader header;
+    if (!readEntry(s_read.sector, s_read.offset, &header)) {
+      dropCorrupt(s_read);
+      continue;
+    }
+    if (header.seq > seq) {
+      break;
+    }
+    static const uint32_t delivered = ENTRY_DELIVERED;
+    ret = esp_partition_write(s_partition,
+                              sectorAddress(s_read.sector) + s_read.offset +
+                                  offsetof(EntryHeader, delivered),
+                              &delivered, sizeof(delivered));
+    if (ret != ESP_OK) {
+      break;
+    }
+    s_pending--;
+    s_pendingBytes -= header.length - header.topicLen;
+    s_delivered++;
+    advance(&s_read, header);
+  }
+  s_peek = s_read;
+  xSemaphoreGive(s_mutex);
+  return ret;
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(stats, 0, sizeof(*stats));
+  if (!s_ready) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  stats->pending = s_pending;
+  stats->pendingBytes = s_pendingBytes;
+  stats->stored = s_stored;
+  stats->delivered = s_delivered;
+  stats->dropped = s_dropped;
+  stats->nextSeq = s_nextSeq;
+  stats->sectors = (uint32_t)s_sectorCount;
+  xSemaphoreGive(s_mutex);
+  return ESP_OK;
+}
+
+} // namespace OfflineQueue
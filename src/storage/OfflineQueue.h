@@ -0,0 +1,106 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief OfflineQueue - Persistent FIFO of MQTT messages kept while offline
+ *
+ * Telemetry, status and command responses that cannot be published go to
+ * a small partition of their own ("mqttq") instead of being lost, and are
+ * replayed after the broker is back (see MqttManager).
+ *
+ * The partition is a ring of 4KB sectors. Each sector starts with a header
+ * (age, first sequence number) followed by entries; an entry is a header
+ * with a sequence number and CRC, then the topic and the message. Every
+ * message gets the next sequence number, which survives reboots, so the
+ * receiver can discard replays it has already seen.
+ *
+ * Delivered entries are marked by programming one word of their header to
+ * zero (no erase), so progress survives a reboot too. When the ring is full
+ * the oldest sector is erased and its undelivered entries are counted as
+ * dropped: the newest data wins.
+ *
+ * Reading is a peek: rewind() and next() walk the pending entries without
+ * consuming them, markDelivered() consumes up to a sequence number once the
+ * batch built from them is handed to MQTT. All calls are thread-safe.
+ */
+namespace OfflineQueue {
+
+/// Longest topic stored with a message
+constexpr size_t MAX_TOPIC = 63;
+
+/// Longest message (the MqttManager JSON buffer)
+constexpr size_t MAX_MESSAGE = 1024;
+
+/// A pending message
+struct Message {
+    uint32_t seq;
+    char topic[MAX_TOPIC + 1]; ///< Empty: the default publish topic
+    uint16_t length;
+    char data[MAX_MESSAGE];    ///< Not NUL-terminated
+};
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t pending;       ///< Messages waiting for delivery
+    uint32_t pendingBytes;  ///< Their message bytes
+    uint32_t stored;        ///< Messages stored since boot
+    uint32_t delivered;     ///< Messages marked delivered since boot
+    uint32_t dropped;       ///< Overwritten before delivery since boot
+    uint32_t nextSeq;       ///< Sequence number of the next message
+    uint32_t sectors;       ///< Sectors in the partition
+};
+
+/**
+ * @brief Open the queue on a data partition and recover its content
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the partition does not exist
+ */
+esp_err_t init(const char* partitionLabel);
+
+/**
+ * @brief Close the queue (everything stays in flash)
+ */
+void deinit();
+
+/**
+ * @brief Whether init() succeeded
+ */
+bool isReady();
+
+/**
+ * @brief Append a message
+ * @param topic Topic, nullptr or "" for the default publish topic
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if it does not fit in an entry,
+ *         ESP_ERR_INVALID_STATE before init()
+ */
+esp_err_t append(const char* topic, const char* data, size_t len);
+
+/**
+ * @brief Messages waiting for delivery
+ */
+uint32_t pending();
+
+/**
+ * @brief Restart next() at the oldest pending message
+ */
+void rewind();
+
+/**
+ * @brief Copy the next pending message after the last one returned
+ * @return ESP_OK, ESP_ERR_NOT_FOUND at the end
+ */
+esp_err_t next(Message* msg);
+
+/**
+ * @brief Mark every pending message up to @p seq delivered
+ */
+esp_err_t markDelivered(uint32_t seq);
+
+/**
+ * @brief Get queue statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+} // namespace OfflineQueue
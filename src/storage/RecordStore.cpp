@@ -0,0 +1,781 @@
+#include "RecordStore.h"
+#include "FlashRing.h"
+#include "../utils/Lz4.h"
+#include "../utils/MemoryPlan.h"
+#include "esp_crc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+
+static const char *TAG = "RecordStore";
+
+namespace RecordStore {
+
+/// One sparse index entry
+struct IndexEntry {
+  uint32_t seq;
+  uint64_t offset;      // Logical position of the header
+  uint64_t timestampUs;
+};
+static_assert(INDEX_CAPACITY * sizeof(IndexEntry) <=
+                  MemoryPlan::budget(MemoryPlan::Region::RECORD_INDEX),
+              "Sparse index exceeds its memory plan budget");
+
+/// Record ended by the writer, waiting for its header length update
+struct PendingSeal {
+  uint32_t seq;
+  uint64_t offset;
+  uint64_t timestampUs;
+  uint64_t end;         // Logical position after the footer
+  uint32_t length;      // Programmed into the header
+};
+
+// Every amend occupies a FlashRing queue entry, plus one just ended
+static constexpr size_t SEAL_QUEUE_SIZE = FlashRing::WRITE_QUEUE_DEPTH + 2;
+
+static constexpr size_t FRAME_OVERHEAD = sizeof(RecordHeader) + sizeof(RecordFooter);
+
+// Module state
+static bool s_initialized = false;
+static SemaphoreHandle_t s_mutex = nullptr; // Guards index, anchor and seal queue
+static IndexEntry *s_index = nullptr;
+static size_t s_indexCount = 0;
+static uint32_t s_indexStride = 1;
+static uint32_t s_recovered = 0;
+
+// Newest sealed record, anchor for walking backwards
+static bool s_haveLast = false;
+static uint32_t s_lastSeq = 0;
+static uint64_t s_lastEnd = 0;
+
+// Writer side
+static uint32_t s_nextSeq = 0;
+static bool s_open = false;
+static RecordHeader s_openHeader = {};
+static uint64_t s_openOffset = 0;
+static uint32_t s_openCrc = 0;
+static uint32_t s_openLength = 0;
+static bool s_endedQueued = false;
+static PendingSeal s_seals[SEAL_QUEUE_SIZE];
+static size_t s_sealHead = 0;
+static size_t s_sealCount = 0;
+
+// Forward declarations
+static void addToIndex(uint32_t seq, uint64_t offset, uint64_t timestampUs);
+static void pruneIndex();
+static esp_err_t readExact(uint64_t position, void *data, size_t len);
+static esp_err_t readRecordAt(uint64_t offset, RecordInfo *info);
+static esp_err_t readRecordEndingAt(uint64_t end, RecordInfo *info,
+                                    bool *headerOpen);
+static esp_err_t closeInterruptedRecord();
+static esp_err_t rebuildIndex();
+static void onSealed(const uint8_t *data, size_t len, esp_err_t result,
+                     void *ctx);
+
+static inline void lock() { xSemaphoreTake(s_mutex, portMAX_DELAY); }
+static inline void unlock() { xSemaphoreGive(s_mutex); }
+
+static uint64_t nowUs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+esp_err_t init() {
+  if (s_initialized) {
+    ESP_LOGW(TAG, "Already initialized");
+    return ESP_OK;
+  }
+
+  s_mutex = xSemaphoreCreateMutex();
+  s_index = (IndexEntry *)MemoryPlan::alloc(MemoryPlan::Region::RECORD_INDEX,
+                                            INDEX_CAPACITY * sizeof(IndexEntry));
+  if (!s_mutex || !s_index) {
+    ESP_LOGE(TAG, "Failed to allocate index");
+    if (s_mutex) {
+      vSemaphoreDelete(s_mutex);
+      s_mutex = nullptr;
+    }
+    MemoryPlan::release(MemoryPlan::Region::RECORD_INDEX, s_index);
+    s_index = nullptr;
+    return ESP_ERR_NO_MEM;
+  }
+
+  s_initialized = true;
+
+  esp_err_t ret = closeInterruptedRecord();
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Could not close interrupted record: %s",
+             esp_err_to_name(ret));
+  }
+
+  ret = rebuildIndex();
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Index rebuild stopped: %s", esp_err_to_name(ret));
+  }
+
+  ESP_LOGI(TAG, "Initialized: %u index entries (stride %lu), next seq %lu",
+           s_indexCount, s_indexStride, s_nextSeq);
+  return ESP_OK;
+}
+
+void beginRecord(Transport::Type type, uint8_t channel, uint64_t position,
+                 RecordHeader *header, uint8_t encoding, int64_t captureTimeUs) {
+  header->magic = HEADER_MAGIC;
+  header->version = FORMAT_VERSION;
+  header->transport = static_cast<uint8_t>(type) | (uint8_t)(channel << CHANNEL_SHIFT);
+  header->encoding = encoding;
+  header->timing = captureTimeUs ? TIMING_TABLE : TIMING_NONE;
+  header->seq = s_nextSeq++;
+  header->length = LENGTH_OPEN;
+  header->timestampUs = nowUs();
+  if (captureTimeUs) {
+    // esp_timer time to wall clock: the capture happened this long ago
+    int64_t ageUs = esp_timer_get_time() - captureTimeUs;
+    if (ageUs > 0) {
+      header->timestampUs -= ageUs;
+    }
+  }
+
+  s_openHeader = *header;
+  s_openOffset = position;
+  s_openCrc = 0;
+  s_openLength = 0;
+  s_open = true;
+}
+
+void appendPayload(const uint8_t *data, size_t len) {
+  s_openCrc = esp_crc32_le(s_openCrc, data, len);
+  s_openLength += len;
+}
+
+void endRecord(RecordFooter *footer) {
+  footer->magic = FOOTER_MAGIC;
+  footer->seq = s_openHeader.seq;
+  footer->length = s_openLength;
+  footer->crc32 = s_openCrc;
+  s_open = false;
+
+  lock();
+  s_endedQueued = (s_sealCount < SEAL_QUEUE_SIZE);
+  if (s_endedQueued) {
+    PendingSeal &seal = s_seals[(s_sealHead + s_sealCount) % SEAL_QUEUE_SIZE];
+    seal.seq = s_openHeader.seq;
+    seal.offset = s_openOffset;
+    seal.timestampUs = s_openHeader.timestampUs;
+    seal.end = s_openOffset + FRAME_OVERHEAD + s_openLength;
+    seal.length = s_openLength;
+    s_sealCount++;
+  }
+  unlock();
+
+  if (!s_endedQueued) {
+    ESP_LOGE(TAG, "Seal queue full, record %lu left open", footer->seq);
+  }
+}
+
+esp_err_t sealRecord() {
+  if (!s_endedQueued) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  s_endedQueued = false;
+
+  lock();
+  PendingSeal *seal = &s_seals[(s_sealHead + s_sealCount - 1) % SEAL_QUEUE_SIZE];
+  unlock();
+
+  esp_err_t ret = FlashRing::amendAsync(
+      seal->offset + offsetof(RecordHeader, length),
+      reinterpret_cast<const uint8_t *>(&seal->length), sizeof(seal->length),
+      onSealed, nullptr);
+  if (ret != ESP_OK) {
+    // Nothing queued after it yet, drop it from the back
+    lock();
+    s_sealCount--;
+    unlock();
+    ESP_LOGE(TAG, "Failed to seal record %lu: %s", seal->seq,
+             esp_err_to_name(ret));
+  }
+  return ret;
+}
+
+bool isRecordOpen() {
+  return s_open;
+}
+
+esp_err_t findBySeq(uint32_t seq, RecordInfo *info) {
+  if (!s_initialized || !info) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  lock();
+  pruneIndex();
+  if (!s_haveLast || seq > s_lastSeq) {
+    unlock();
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // First indexed record at or after seq
+  const IndexEntry *entry = std::lower_bound(
+      s_index, s_index + s_indexCount, seq,
+      [](const IndexEntry &e, uint32_t s) { return e.seq < s; });
+
+  uint64_t anchor;
+  uint32_t anchorSeq;
+  if (entry != s_index + s_indexCount) {
+    if (entry->seq == seq) {
+      uint64_t offset = entry->offset;
+      unlock();
+      return readRecordAt(offset, info);
+    }
+    anchor = entry->offset;
+    anchorSeq = entry->seq;
+  } else {
+    // Past the last index entry: walk back from the newest record
+    anchor = s_lastEnd;
+    anchorSeq = s_lastSeq + 1;
+  }
+  unlock();
+
+  // Walk back through the footers
+  while (anchorSeq > seq) {
+    esp_err_t ret = readRecordEndingAt(anchor, info, nullptr);
+    if (ret != ESP_OK || info->seq != anchorSeq - 1) {
+      return ESP_ERR_NOT_FOUND;
+    }
+    anchor = info->offset;
+    anchorSeq = info->seq;
+  }
+  return ESP_OK;
+}
+
+esp_err_t findByTime(uint64_t timestampUs, RecordInfo *info) {
+  if (!s_initialized || !info) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  lock();
+  pruneIndex();
+  if (!s_haveLast) {
+    unlock();
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // First indexed record captured at or after the time
+  const IndexEntry *entry = std::lower_bound(
+      s_index, s_index + s_indexCount, timestampUs,
+      [](const IndexEntry &e, uint64_t t) { return e.timestampUs < t; });
+
+  // The answer lies between the previous index entry and this one
+  uint64_t anchor = (entry != s_index + s_indexCount) ? entry->offset : s_lastEnd;
+  bool haveLowerBound = (entry != s_index);
+  uint32_t lowerSeq = haveLowerBound ? (entry - 1)->seq : 0;
+  bool anchorIsRecord = (entry != s_index + s_indexCount);
+  unlock();
+
+  bool found = false;
+  if (anchorIsRecord) {
+    esp_err_t ret = readRecordAt(anchor, info);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    found = true;
+  }
+
+  RecordInfo prev;
+  while (!haveLowerBound || !found || info->seq > lowerSeq + 1) {
+    if (readRecordEndingAt(anchor, &prev, nullptr) != ESP_OK ||
+        prev.timestampUs < timestampUs) {
+      break;
+    }
+    *info = prev;
+    found = true;
+    anchor = prev.offset;
+  }
+
+  return found ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t next(const RecordInfo &current, RecordInfo *info) {
+  if (!s_initialized || !info) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  uint64_t nextOffset = current.payloadOffset + current.length + sizeof(RecordFooter);
+
+  lock();
+  bool available = s_haveLast && nextOffset < s_lastEnd;
+  unlock();
+
+  if (!available) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  return readRecordAt(nextOffset, info);
+}
+
+esp_err_t readPayload(const RecordInfo &info, size_t offset, uint8_t *data,
+                      size_t len, size_t *bytesRead) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (offset >= info.dataLength) {
+    *bytesRead = 0;
+    return ESP_OK;
+  }
+
+  size_t toRead = std::min(len, (size_t)info.dataLength - offset);
+  return FlashRing::readLogical(info.payloadOffset + offset, data, toRead,
+                                bytesRead);
+}
+
+esp_err_t readTimeMarks(const RecordInfo &info, TimeMark *marks, size_t max,
+                        size_t *count) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!marks || !count) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  *count = std::min<size_t>(info.timeMarks, max);
+  if (*count == 0) {
+    return ESP_OK;
+  }
+  esp_err_t ret = readExact(info.payloadOffset + info.dataLength, marks,
+                            *count * sizeof(TimeMark));
+  if (ret != ESP_OK) {
+    *count = 0;
+  }
+  return ret;
+}
+
+esp_err_t readBlock(const RecordInfo &info, size_t *offset, uint8_t *data,
+                    size_t capacity, size_t *rawLen) {
+  if (!s_initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!offset || !data || !rawLen) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *rawLen = 0;
+  if (*offset >= info.dataLength) {
+    return ESP_OK;
+  }
+
+  if (info.encoding != ENCODING_LZ4) {
+    esp_err_t ret = readPayload(info, *offset, data, capacity, rawLen);
+    if (ret == ESP_OK) {
+      *offset += *rawLen;
+    }
+    return ret;
+  }
+
+  BlockHeader block;
+  uint64_t position = info.payloadOffset + *offset;
+  esp_err_t ret = readExact(position, &block, sizeof(block));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  if (block.rawLength > BLOCK_RAW_SIZE || block.storedLength > block.rawLength ||
+      block.storedLength > info.dataLength - *offset - sizeof(block)) {
+    return ESP_ERR_INVALID_CRC;
+  }
+  if (block.rawLength > capacity) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  position += sizeof(block);
+
+  if (block.storedLength == block.rawLength) {
+    ret = readExact(position, data, block.storedLength);
+  } else {
+    uint8_t *stored = (uint8_t *)malloc(block.storedLength);
+    if (!stored) {
+      return ESP_ERR_NO_MEM;
+    }
+    ret = readExact(position, stored, block.storedLength);
+    if (ret == ESP_OK && Lz4::decompress(stored, block.storedLength, data,
+                                         block.rawLength) != block.rawLength) {
+      ret = ESP_ERR_INVALID_CRC;
+    }
+    free(stored);
+  }
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  *offset += sizeof(block) + block.storedLength;
+  *rawLen = block.rawLength;
+  return ESP_OK;
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!s_initialized || !stats) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  lock();
+  pruneIndex();
+  stats->firstSeq = s_indexCount > 0 ? s_index[0].seq : s_nextSeq;
+  stats->nextSeq = s_nextSeq;
+  stats->indexEntries = s_indexCount;
+  stats->indexStride = s_indexStride;
+  stats->recovered = s_recovered;
+  unlock();
+
+  return ESP_OK;
+}
+
+void reset() {
+  if (!s_initialized) {
+    return;
+  }
+
+  lock();
+  s_indexCount = 0;
+  s_indexStride = 1;
+  s_haveLast = false;
+  unlock();
+  ESP_LOGI(TAG, "Index reset");
+}
+
+// --- Private functions ---
+
+// Callers hold s_mutex. Keeps one entry every s_indexStride records; when
+// full, every other entry is dropped and the stride doubles.
+static void addToIndex(uint32_t seq, uint64_t offset, uint64_t timestampUs) {
+  while (true) {
+    if (seq % s_indexStride != 0) {
+      return;
+    }
+    if (s_indexCount < INDEX_CAPACITY) {
+      break;
+    }
+
+    uint32_t stride = s_indexStride * 2;
+    size_t kept = 0;
+    for (size_t i = 0; i < s_indexCount; i++) {
+      if (s_index[i].seq % stride == 0) {
+        s_index[kept++] = s_index[i];
+      }
+    }
+    s_indexCount = kept;
+    s_indexStride = stride;
+  }
+
+  s_index[s_indexCount++] = {seq, offset, timestampUs};
+}
+
+// Callers hold s_mutex. Drops entries for records the ring has overwritten.
+static void pruneIndex() {
+  uint64_t tail = FlashRing::getLogicalTail();
+  uint64_t head = FlashRing::getLogicalHead();
+
+  if (s_haveLast && head < s_lastEnd) {
+    // The ring was erased underneath us
+    s_indexCount = 0;
+    s_indexStride = 1;
+    s_haveLast = false;
+    return;
+  }
+
+  size_t drop = 0;
+  while (drop < s_indexCount && s_index[drop].offset < tail) {
+    drop++;
+  }
+  if (drop > 0) {
+    memmove(s_index, s_index + drop, (s_indexCount - drop) * sizeof(IndexEntry));
+    s_indexCount -= drop;
+  }
+  if (s_haveLast && s_lastEnd <= tail) {
+    s_haveLast = false;
+  }
+}
+
+static esp_err_t readExact(uint64_t position, void *data, size_t len) {
+  size_t bytesRead = 0;
+  esp_err_t ret = FlashRing::readLogical(position, (uint8_t *)data, len, &bytesRead);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  return (bytesRead == len) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+static void fillInfo(const RecordHeader &header, uint64_t offset,
+                     uint32_t length, RecordInfo *info) {
+  info->seq = header.seq;
+  info->transport = static_cast<Transport::Type>(
+      header.transport & ((1 << CHANNEL_SHIFT) - 1));
+  info->channel = header.transport >> CHANNEL_SHIFT;
+  info->offset = offset;
+  info->payloadOffset = offset + sizeof(RecordHeader);
+  info->length = length;
+  info->dataLength = length;
+  info->timeMarks = 0;
+  info->timestampUs = header.timestampUs;
+  info->encoding = header.encoding;
+}
+
+// Locate the time table of a TIMING_TABLE record. Records closed at boot
+// after a reset have no trailer and keep their whole payload as data.
+static esp_err_t readTimeTable(uint8_t timing, RecordInfo *info) {
+  if (timing != TIMING_TABLE || info->length < sizeof(TimeTableTrailer)) {
+    return ESP_OK;
+  }
+
+  TimeTableTrailer trailer;
+  esp_err_t ret = readExact(info->payloadOffset + info->length - sizeof(trailer),
+                            &trailer, sizeof(trailer));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  size_t tableLen = sizeof(trailer) + (size_t)trailer.count * sizeof(TimeMark);
+  if (trailer.magic != TIME_TABLE_MAGIC || trailer.count > MAX_TIME_MARKS ||
+      tableLen > info->length) {
+    return ESP_OK;
+  }
+
+  info->dataLength = info->length - tableLen;
+  info->timeMarks = trailer.count;
+  return ESP_OK;
+}
+
+// Read a sealed record starting at offset
+static esp_err_t readRecordAt(uint64_t offset, RecordInfo *info) {
+  RecordHeader header;
+  esp_err_t ret = readExact(offset, &header, sizeof(header));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  if (header.magic != HEADER_MAGIC || header.version != FORMAT_VERSION ||
+      header.length == LENGTH_OPEN) {
+    return ESP_ERR_INVALID_CRC;
+  }
+
+  fillInfo(header, offset, header.length, info);
+  return readTimeTable(header.timing, info);
+}
+
+// Read the record whose footer ends at end. headerOpen (optional) reports
+// a header whose length was never filled in.
+static esp_err_t readRecordEndingAt(uint64_t end, RecordInfo *info,
+                                    bool *headerOpen) {
+  uint64_t tail = FlashRing::getLogicalTail();
+  if (end < tail + FRAME_OVERHEAD) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  RecordFooter footer;
+  esp_err_t ret = readExact(end - sizeof(footer), &footer, sizeof(footer));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  if (footer.magic != FOOTER_MAGIC ||
+      footer.length > end - tail - FRAME_OVERHEAD) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  uint64_t start = end - FRAME_OVERHEAD - footer.length;
+  RecordHeader header;
+  ret = readExact(start, &header, sizeof(header));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  if (header.magic != HEADER_MAGIC || header.version != FORMAT_VERSION ||
+      header.seq != footer.seq ||
+      (header.length != footer.length && header.length != LENGTH_OPEN)) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  if (headerOpen) {
+    *headerOpen = (header.length == LENGTH_OPEN);
+  }
+  fillInfo(header, start, footer.length, info);
+  return readTimeTable(header.timing, info);
+}
+
+// Fill in a header length synchronously (boot only)
+static esp_err_t amendLengthNow(uint64_t offset, uint32_t length) {
+  esp_err_t ret = FlashRing::amendAsync(
+      offset + offsetof(RecordHeader, length),
+      reinterpret_cast<const uint8_t *>(&length), sizeof(length), nullptr,
+      nullptr);
+  if (ret == ESP_OK) {
+    ret = FlashRing::waitIdle(pdMS_TO_TICKS(1000));
+  }
+  return ret;
+}
+
+// A reset during a burst leaves a header without a footer at the head.
+// Find that header and close the record with the payload that made it to
+// flash.
+static esp_err_t closeInterruptedRecord() {
+  uint64_t head = FlashRing::getLogicalHead();
+  uint64_t tail = FlashRing::getLogicalTail();
+  if (head - tail < sizeof(RecordHeader)) {
+    return ESP_OK;
+  }
+
+  RecordInfo info;
+  if (readRecordEndingAt(head, &info, nullptr) == ESP_OK) {
+    return ESP_OK; // Head is on a record boundary
+  }
+
+  // Search backwards for the header magic
+  uint8_t buf[256];
+  const uint8_t magic[4] = {(uint8_t)HEADER_MAGIC, (uint8_t)(HEADER_MAGIC >> 8),
+                            (uint8_t)(HEADER_MAGIC >> 16),
+                            (uint8_t)(HEADER_MAGIC >> 24)};
+  uint64_t windowEnd = head - sizeof(RecordHeader) + sizeof(magic);
+  bool found = false;
+  uint64_t start = 0;
+  RecordHeader header;
+
+  while (!found && windowEnd >= tail + sizeof(magic)) {
+    uint64_t windowStart = std::max<uint64_t>(tail, windowEnd - sizeof(buf));
+    size_t len = (size_t)(windowEnd - windowStart);
+    esp_err_t ret = readExact(windowStart, buf, len);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+
+    for (size_t i = len - sizeof(magic) + 1; i-- > 0;) {
+      if (memcmp(buf + i, magic, sizeof(magic)) != 0) {
+        continue;
+      }
+      uint64_t candidate = windowStart + i;
+      if (readExact(candidate, &header, sizeof(header)) == ESP_OK &&
+          header.version == FORMAT_VERSION &&
+          (header.encoding == ENCODING_RAW || header.encoding == ENCODING_LZ4) &&
+          header.length == LENGTH_OPEN) {
+        start = candidate;
+        found = true;
+        break;
+      }
+    }
+
+    // Overlap so a magic split across windows is still seen
+    windowEnd = windowStart + sizeof(magic) - 1;
+    if (windowStart == tail) {
+      break;
+    }
+  }
+
+  if (!found) {
+    ESP_LOGW(TAG, "Data at head is not framed, skipping");
+    return ESP_OK;
+  }
+
+  // CRC over the payload that reached flash
+  uint64_t payloadStart = start + sizeof(RecordHeader);
+  uint32_t length = (uint32_t)(head - payloadStart);
+  uint32_t crc = 0;
+  for (uint64_t pos = payloadStart; pos < head;) {
+    size_t chunk = (size_t)std::min<uint64_t>(sizeof(buf), head - pos);
+    esp_err_t ret = readExact(pos, buf, chunk);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    crc = esp_crc32_le(crc, buf, chunk);
+    pos += chunk;
+  }
+
+  RecordFooter footer = {FOOTER_MAGIC, header.seq, length, crc};
+  esp_err_t ret = FlashRing::write(reinterpret_cast<const uint8_t *>(&footer),
+                                   sizeof(footer));
+  if (ret == ESP_OK) {
+    ret = amendLengthNow(start, length);
+  }
+  if (ret == ESP_OK) {
+    s_recovered++;
+    ESP_LOGW(TAG, "Closed interrupted record %lu (%lu bytes)", header.seq,
+             length);
+  }
+  return ret;
+}
+
+// Walk back from the head and index every sealed record
+static esp_err_t rebuildIndex() {
+  uint64_t end = FlashRing::getLogicalHead();
+  RecordInfo info;
+  bool headerOpen = false;
+  bool first = true;
+  uint32_t expectedSeq = 0;
+  esp_err_t ret = ESP_OK;
+
+  lock();
+  s_indexCount = 0;
+  s_indexStride = 1;
+  s_haveLast = false;
+  unlock();
+
+  while (true) {
+    ret = readRecordEndingAt(end, &info, &headerOpen);
+    if (ret != ESP_OK) {
+      // Reached the tail or unframed data
+      ret = (ret == ESP_ERR_NOT_FOUND) ? ESP_OK : ret;
+      break;
+    }
+    if (!first && info.seq != expectedSeq) {
+      ESP_LOGW(TAG, "Sequence gap at record %lu", info.seq);
+      break;
+    }
+
+    // Footer made it but the header length update did not
+    if (headerOpen) {
+      amendLengthNow(info.offset, info.length);
+    }
+
+    lock();
+    if (first) {
+      s_haveLast = true;
+      s_lastSeq = info.seq;
+      s_lastEnd = end;
+      s_nextSeq = info.seq + 1;
+    }
+    addToIndex(info.seq, info.offset, info.timestampUs);
+    unlock();
+
+    first = false;
+    if (info.seq == 0) {
+      break;
+    }
+    expectedSeq = info.seq - 1;
+    end = info.offset;
+  }
+
+  // Walked newest first
+  lock();
+  std::reverse(s_index, s_index + s_indexCount);
+  unlock();
+
+  return ret;
+}
+
+// Runs in the FlashRing program task once the header length is programmed
+static void onSealed(const uint8_t *data, size_t len, esp_err_t result,
+                     void *ctx) {
+  lock();
+  PendingSeal seal = s_seals[s_sealHead];
+  s_sealHead = (s_sealHead + 1) % SEAL_QUEUE_SIZE;
+  s_sealCount--;
+
+  if (result == ESP_OK) {
+    addToIndex(seal.seq, seal.offset, seal.timestampUs);
+    s_haveLast = true;
+    s_lastSeq = seal.seq;
+    s_lastEnd = seal.end;
+  }
+  unlock();
+
+  if (result != ESP_OK) {
+    ESP_LOGW(TAG, "Record %lu not sealed: %s", seal.seq, esp_err_to_name(result));
+  }
+}
+
+} // namespace RecordStore
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+#include "../transport/TransportTypes.h"
+
+/**
+ * @brief RecordStore - Burst framing and index on top of FlashRing
+ *
+ * Every burst is stored as one record:
+ *
+ *   [RecordHeader][payload ...][RecordFooter]
+ *
+ * With several capture channels (see DataPipeline::addSource) the header
+ * carries the channel, and a burst is split into several records wherever
+ * data of another channel was merged in between.
+ *
+ * The header is written before the burst length is known, with its length
+ * field left blank (0xFFFFFFFF); it is filled in place once the burst ends.
+ * The footer repeats the length together with the payload CRC, so records
+ * can be walked both forwards (header) and backwards from the head
+ * (footer).
+ *
+ * An in-RAM sparse index (sequence -> logical flash position) is rebuilt at
+ * boot by walking back from the head, so "burst N" or "bursts since time T"
+ * are found with a binary search plus a short walk instead of a scan.
+ *
+ * With ENCODING_LZ4 the payload is a sequence of independently decodable
+ * blocks, each [BlockHeader][LZ4 block or raw bytes], so readers decompress
+ * one block at a time (see readBlock()). Lengths and the footer CRC always
+ * refer to the stored bytes.
+ *
+ * When the transport reports chunk capture times, the header timestamp is
+ * the capture time of the first chunk and the payload ends with a time
+ * table (TIMING_TABLE): one TimeMark per chunk followed by a
+ * TimeTableTrailer. A record interrupted by a reset has no trailer and
+ * reads as untimed.
+ *
+ * Positions are FlashRing logical positions (see FlashRing::readLogical).
+ * The writer side is used by DataPipeline only.
+ */
+
+namespace RecordStore {
+
+/// Header magic "RECH"
+constexpr uint32_t HEADER_MAGIC = 0x48434552;
+
+/// Footer magic "RECF"
+constexpr uint32_t FOOTER_MAGIC = 0x46434552;
+
+/// Record format version
+constexpr uint8_t FORMAT_VERSION = 1;
+
+/// Header length value of a record that is still being written
+constexpr uint32_t LENGTH_OPEN = 0xFFFFFFFF;
+
+/// Header encoding of a payload stored as captured (blank flash value, so
+/// records written before encodings existed read as raw)
+constexpr uint8_t ENCODING_RAW = 0xFF;
+
+/// Header encoding of a payload stored as LZ4 blocks
+constexpr uint8_t ENCODING_LZ4 = 0x01;
+
+/// Header timing of a record without capture times (blank flash value)
+constexpr uint8_t TIMING_NONE = 0xFF;
+
+/// Header timing of a record whose payload ends with a time table
+constexpr uint8_t TIMING_TABLE = 0x01;
+
+/// Time table trailer magic "RECT"
+constexpr uint32_t TIME_TABLE_MAGIC = 0x54434552;
+
+/// Header transport byte: Transport::Type in the low nibble, capture
+/// channel in the high nibble (0 for single-source capture)
+constexpr uint8_t CHANNEL_SHIFT = 4;
+
+/// Maximum capture channels a header can tag
+constexpr uint8_t MAX_CHANNELS = 16;
+
+/// Maximum entries in a record's time table (extra marks are decimated)
+constexpr size_t MAX_TIME_MARKS = 64;
+
+/// Maximum uncompressed bytes per payload block
+constexpr size_t BLOCK_RAW_SIZE = 4096;
+
+/// Maximum entries in the RAM index (older entries are decimated)
+constexpr size_t INDEX_CAPACITY = 256;
+
+/// Written at the start of each record
+struct RecordHeader {
+    uint32_t magic;        ///< HEADER_MAGIC
+    uint8_t  version;      ///< FORMAT_VERSION
+    uint8_t  transport;    ///< Transport::Type of the source | channel << CHANNEL_SHIFT
+    uint8_t  encoding;     ///< ENCODING_RAW or ENCODING_LZ4
+    uint8_t  timing;       ///< TIMING_NONE or TIMING_TABLE
+    uint32_t seq;          ///< Record sequence number
+    uint32_t length;       ///< Payload bytes, LENGTH_OPEN until the burst ends
+    uint64_t timestampUs;  ///< Capture time of the first chunk (µs since epoch once SNTP is synced)
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout");
+
+/// Written after the payload
+struct RecordFooter {
+    uint32_t magic;   ///< FOOTER_MAGIC
+    uint32_t seq;     ///< Same as the header
+    uint32_t length;  ///< Payload bytes
+    uint32_t crc32;   ///< CRC of the payload
+};
+static_assert(sizeof(RecordFooter) == 16, "RecordFooter layout");
+
+/// Prefix of each block of an ENCODING_LZ4 payload
+struct BlockHeader {
+    uint16_t rawLength;     ///< Bytes after decoding (at most BLOCK_RAW_SIZE)
+    uint16_t storedLength;  ///< Bytes that follow; equal to rawLength if stored uncompressed
+};
+static_assert(sizeof(BlockHeader) == 4, "BlockHeader layout");
+
+/// Capture time of one chunk, relative to its record
+struct TimeMark {
+    uint32_t offset;   ///< Decoded payload offset of the chunk's last byte
+    uint32_t deltaUs;  ///< Captured this long after the header timestampUs
+};
+static_assert(sizeof(TimeMark) == 8, "TimeMark layout");
+
+/// Last bytes of a TIMING_TABLE payload, right after its TimeMark entries
+struct TimeTableTrailer {
+    uint32_t count;  ///< TimeMark entries before the trailer
+    uint32_t magic;  ///< TIME_TABLE_MAGIC
+};
+static_assert(sizeof(TimeTableTrailer) == 8, "TimeTableTrailer layout");
+
+/// Location and attributes of one stored record
+struct RecordInfo {
+    uint32_t seq;            ///< Record sequence number
+    Transport::Type transport; ///< Source transport
+    uint8_t channel;         ///< Capture channel of the source
+    uint64_t offset;         ///< Logical position of the header
+    uint64_t payloadOffset;  ///< Logical position of the first payload byte
+    uint32_t length;         ///< Stored payload bytes
+    uint32_t dataLength;     ///< Stored payload bytes before the time table
+    uint32_t timeMarks;      ///< Entries in the time table
+    uint64_t timestampUs;    ///< Capture time
+    uint8_t encoding;        ///< ENCODING_RAW or ENCODING_LZ4
+};
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t firstSeq;      ///< Oldest indexed record still stored
+    uint32_t nextSeq;       ///< Sequence number of the next record
+    uint32_t indexEntries;  ///< Entries currently in the RAM index
+    uint32_t indexStride;   ///< One index entry every indexStride records
+    uint32_t recovered;     ///< Records closed at boot after an interrupted burst
+};
+
+/**
+ * @brief Rebuild the index from the records in FlashRing
+ *
+ * A record left open by a reset is closed with the data it holds.
+ * Must be called after FlashRing::init().
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t init();
+
+/**
+ * @brief Start a record (writer side)
+ *
+ * With a capture time the header is marked TIMING_TABLE, and the writer
+ * must append the time table as the last payload bytes.
+ *
+ * @param type          Source transport
+ * @param channel       Capture channel of the source (below MAX_CHANNELS)
+ * @param position      Logical position the header will be written at
+ * @param header        Header to write (output)
+ * @param encoding      Payload encoding
+ * @param captureTimeUs esp_timer time of the first chunk, 0 to stamp the
+ *                      record with the current time and no time table
+ */
+void beginRecord(Transport::Type type, uint8_t channel, uint64_t position,
+                 RecordHeader* header,
+                 uint8_t encoding = ENCODING_RAW, int64_t captureTimeUs = 0);
+
+/**
+ * @brief Account payload bytes of the open record (writer side)
+ */
+void appendPayload(const uint8_t* data, size_t len);
+
+/**
+ * @brief Finish the open record (writer side)
+ *
+ * @param footer Footer to write right after the payload (output)
+ */
+void endRecord(RecordFooter* footer);
+
+/**
+ * @brief Fill in the header length of the last ended record (writer side)
+ *
+ * Must be called once the header, payload and footer have been submitted
+ * to FlashRing. The record becomes visible to readers when the update has
+ * been programmed.
+ *
+ * @return ESP_OK if queued
+ */
+esp_err_t sealRecord();
+
+/**
+ * @brief Whether a record is currently open (writer side)
+ */
+bool isRecordOpen();
+
+/**
+ * @brief Find a record by sequence number
+ *
+ * @param seq  Sequence number
+ * @param info Record location (output)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if overwritten or not yet sealed
+ */
+esp_err_t findBySeq(uint32_t seq, RecordInfo* info);
+
+/**
+ * @brief Find the oldest record captured at or after a time
+ *
+ * @param timestampUs Capture time in µs
+ * @param info        Record location (output)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if no such record is stored
+ */
+esp_err_t findByTime(uint64_t timestampUs, RecordInfo* info);
+
+/**
+ * @brief Get the record following @p current
+ *
+ * @param current Record returned by a previous lookup
+ * @param info    Next record (output)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if @p current is the newest
+ */
+esp_err_t next(const RecordInfo& current, RecordInfo* info);
+
+/**
+ * @brief Read payload bytes of a record
+ *
+ * Stops at dataLength; the time table is read with readTimeMarks().
+ *
+ * @param info      Record to read
+ * @param offset    Offset inside the payload
+ * @param data      Buffer to read into
+ * @param len       Maximum bytes to read
+ * @param bytesRead Actual bytes read (output)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if the record was overwritten
+ */
+esp_err_t readPayload(const RecordInfo& info, size_t offset, uint8_t* data,
+                      size_t len, size_t* bytesRead);
+
+/**
+ * @brief Read the time table of a record
+ *
+ * @param info  Record to read
+ * @param marks Buffer for up to @p max entries
+ * @param max   Buffer capacity
+ * @param count Entries read (output, 0 for records without a table)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if the record was overwritten
+ */
+esp_err_t readTimeMarks(const RecordInfo& info, TimeMark* marks, size_t max,
+                        size_t* count);
+
+/**
+ * @brief Read and decode the next block of a record's payload
+ *
+ * Works for both encodings (raw payloads are returned in chunks of up to
+ * @p capacity bytes). Start with @p offset = 0 and call until @p rawLen
+ * is 0.
+ *
+ * @param info     Record to read
+ * @param offset   Stored payload offset of the block (in/out)
+ * @param data     Buffer for the decoded bytes
+ * @param capacity Buffer size (BLOCK_RAW_SIZE fits any block)
+ * @param rawLen   Decoded bytes (output, 0 at the end of the payload)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if overwritten, ESP_ERR_INVALID_SIZE if
+ *         a block does not fit in @p capacity, ESP_ERR_INVALID_CRC if a
+ *         block is malformed
+ */
+esp_err_t readBlock(const RecordInfo& info, size_t* offset, uint8_t* data,
+                    size_t capacity, size_t* rawLen);
+
+/**
+ * @brief Get index statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+/**
+ * @brief Drop the index (after FlashRing::erase())
+ */
+void reset();
+
+} // namespace RecordStore
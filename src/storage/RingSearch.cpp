@@ -0,0 +1,208 @@
+#include "RingSearch.h"
+#include "FlashRing.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+static const char *TAG = "RingSearch";
+
+// Bytes mapped per step
+static const size_t SCAN_CHUNK = 16 * 1024;
+
+// Bytes scanned between sleeps, so the Core 0 idle task (and its watchdog)
+// still runs during a long search
+static const size_t YIELD_BYTES = 64 * 1024;
+
+// Matches waiting for the caller before the scan blocks
+static const size_t RESULT_QUEUE_DEPTH = 4;
+
+namespace RingSearch {
+
+// Queue entry; done marks the end of the scan
+struct Event {
+  bool done;
+  Match match;
+};
+
+// Shared by search() and the scan task, which search() outlives
+struct Job {
+  PatternSearch matcher;
+  Options options;
+  QueueHandle_t events;
+  volatile bool cancel;
+  Summary summary;
+  uint8_t fallback[512]; // Copy used when every map window is taken
+};
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_busy = false;
+
+// Fill in a match with its context and hand it to the caller
+static bool onMatch(uint64_t position, void *arg) {
+  Job *job = static_cast<Job *>(arg);
+
+  Event event;
+  event.done = false;
+  Match &m = event.match;
+  m.position = position;
+  m.offset = position - job->summary.start;
+  m.matchLen = (uint8_t)job->matcher.length();
+
+  size_t before = std::min<uint64_t>(job->options.context,
+                                     position - job->summary.start);
+  size_t want = before + m.matchLen + job->options.context;
+  size_t bytesRead = 0;
+  if (FlashRing::readLogical(position - before, m.data, want, &bytesRead) !=
+      ESP_OK) {
+    // The context start was overwritten meanwhile: keep the match itself
+    before = 0;
+    want = m.matchLen + job->options.context;
+    if (FlashRing::readLogical(position, m.data, want, &bytesRead) != ESP_OK) {
+      bytesRead = 0;
+    }
+  }
+  m.before = (uint8_t)before;
+  m.length = (uint8_t)bytesRead;
+
+  xQueueSend(job->events, &event, portMAX_DELAY);
+  job->summary.matches++;
+  if (job->options.maxMatches > 0 &&
+      job->summary.matches >= job->options.maxMatches) {
+    job->summary.truncated = true;
+    return false;
+  }
+  return !job->cancel;
+}
+
+static void scanTask(void *arg) {
+  Job *job = static_cast<Job *>(arg);
+  Summary &summary = job->summary;
+  int64_t startUs = esp_timer_get_time();
+
+  uint64_t pos = summary.start;
+  size_t sinceYield = 0;
+  bool running = true;
+  job->matcher.reset(pos);
+  while (running && pos < summary.end && !job->cancel) {
+    size_t want = (size_t)std::min<uint64_t>(SCAN_CHUNK, summary.end - pos);
+    FlashRing::Span spans[2];
+    size_t count = 0;
+    esp_err_t ret = FlashRing::mapLogical(pos, want, spans, &count);
+    bool mapped = (ret == ESP_OK);
+    if (ret == ESP_ERR_NOT_FOUND) {
+      // The writer overtook the scan: continue from the new tail
+      uint64_t tail = std::min(FlashRing::getLogicalTail(), summary.end);
+      summary.skipped += tail - pos;
+      pos = tail;
+      job->matcher.reset(pos);
+      continue;
+    }
+    if (ret == ESP_ERR_NO_MEM) {
+      size_t bytesRead = 0;
+      ret = FlashRing::readLogical(pos, job->fallback,
+                                   std::min(want, sizeof(job->fallback)),
+                                   &bytesRead);
+      spans[0] = {job->fallback, bytesRead};
+      count = (bytesRead > 0) ? 1 : 0;
+    }
+    if (ret != ESP_OK || count == 0) {
+      ESP_LOGW(TAG, "Scan stopped at %" PRIu64 ": %s", pos,
+               esp_err_to_name(ret));
+      break;
+    }
+
+    for (size_t i = 0; i < count && running; i++) {
+      running = job->matcher.feed(spans[i].data, spans[i].len, onMatch, job);
+      pos += spans[i].len;
+      summary.scanned += spans[i].len;
+      sinceYield += spans[i].len;
+    }
+    if (mapped) {
+      FlashRing::unmapSpans(spans, count);
+    }
+
+    if (sinceYield >= YIELD_BYTES) {
+      sinceYield = 0;
+      vTaskDelay(1);
+    }
+  }
+
+  summary.elapsedMs = (uint32_t)((esp_timer_get_time() - startUs) / 1000);
+  Event done = {};
+  done.done = true;
+  xQueueSend(job->events, &done, portMAX_DELAY);
+  vTaskDelete(nullptr); // The job belongs to search() from here on
+}
+
+esp_err_t search(const Options &options, MatchCallback callback, void *ctx,
+                 Summary *summary) {
+  if (!options.pattern || !callback || options.context > MAX_CONTEXT) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  portENTER_CRITICAL(&s_lock);
+  bool busy = s_busy;
+  s_busy = true;
+  portEXIT_CRITICAL(&s_lock);
+  if (busy) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  esp_err_t ret = ESP_OK;
+  Job *job = (Job *)calloc(1, sizeof(Job));
+  if (!job) {
+    ret = ESP_ERR_NO_MEM;
+  } else if (job->matcher.compile(options.pattern, options.ignoreCase) !=
+             ESP_OK) {
+    ret = ESP_ERR_INVALID_ARG;
+  } else {
+    job->options = options;
+    job->summary.start = FlashRing::getLogicalTail();
+    job->summary.end = FlashRing::getLogicalHead();
+    job->events = xQueueCreate(RESULT_QUEUE_DEPTH, sizeof(Event));
+    // Idle + 1 on Core 0: capture preempts it, the writer is on Core 1
+    if (!job->events ||
+        xTaskCreatePinnedToCore(scanTask, "ring_search", 3072, job,
+                                tskIDLE_PRIORITY + 1, nullptr, 0) != pdPASS) {
+      ESP_LOGE(TAG, "Failed to start scan task");
+      ret = ESP_ERR_NO_MEM;
+    }
+  }
+
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "Searching %" PRIu64 " bytes for \"%s\"",
+             job->summary.end - job->summary.start, options.pattern);
+    Event event;
+    while (xQueueReceive(job->events, &event, portMAX_DELAY) == pdTRUE &&
+           !event.done) {
+      // Keep draining after a cancel, the scan stops at its next match
+      if (!job->cancel && !callback(event.match, ctx)) {
+        job->cancel = true;
+      }
+    }
+    ESP_LOGI(TAG, "%" PRIu32 " matches in %" PRIu64 " bytes, %" PRIu32 " ms",
+             job->summary.matches, job->summary.scanned,
+             job->summary.elapsedMs);
+    if (summary) {
+      *summary = job->summary;
+    }
+  }
+
+  if (job && job->events) {
+    vQueueDelete(job->events);
+  }
+  free(job);
+
+  portENTER_CRITICAL(&s_lock);
+  s_busy = false;
+  portEXIT_CRITICAL(&s_lock);
+  return ret;
+}
+
+} // namespace RingSearch
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "esp_err.h"
+#include "utils/PatternSearch.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief RingSearch - On-device search of the FlashRing contents
+ *
+ * Scans the stored data from tail to head for a PatternSearch pattern,
+ * so a field issue can be located without downloading the whole ring.
+ *
+ * The scan runs on its own task at idle + 1 pinned to Core 0. The pipeline
+ * writer and the flash program task run on Core 1 and capture preempts
+ * the scan on Core 0. Pages are read through the FlashRing memory map, so
+ * the scan does not wait for the SPI flash lock the program task uses.
+ * search() runs on the caller's task and passes matches to the callback as
+ * the scan finds them. A slow consumer (a socket, the console) pauses the
+ * scan instead of buffering results.
+ *
+ * One search runs at a time.
+ */
+namespace RingSearch {
+
+/// Most context bytes kept on each side of a match
+constexpr size_t MAX_CONTEXT = 32;
+
+/// Search parameters
+struct Options {
+    const char* pattern;  ///< PatternSearch syntax
+    bool ignoreCase;      ///< Letters match either case
+    uint32_t maxMatches;  ///< Stop after this many (0 = no limit)
+    size_t context;       ///< Context bytes around each match (<= MAX_CONTEXT)
+};
+
+/// One match with its surroundings
+struct Match {
+    uint64_t position;    ///< Logical position of the first matched byte
+    uint64_t offset;      ///< Position from the tail at the start of the search
+    uint8_t before;       ///< Context bytes preceding the match in data
+    uint8_t matchLen;     ///< Matched bytes following them
+    uint8_t length;       ///< Valid bytes in data (clipped at tail and head)
+    uint8_t data[2 * MAX_CONTEXT + PatternSearch::MAX_PATTERN];
+};
+
+/// Outcome of a search
+struct Summary {
+    uint64_t start;       ///< Logical tail when the scan started
+    uint64_t end;         ///< Logical head when the scan started (exclusive)
+    uint64_t scanned;     ///< Bytes scanned
+    uint64_t skipped;     ///< Bytes overwritten before the scan reached them
+    uint32_t matches;     ///< Matches reported
+    bool truncated;       ///< Stopped at maxMatches
+    uint32_t elapsedMs;   ///< Scan time
+};
+
+/**
+ * @brief Called on the caller's task for each match, in stream order
+ * @return false to stop the search
+ */
+typedef bool (*MatchCallback)(const Match& match, void* ctx);
+
+/**
+ * @brief Search the ring and wait for the scan to finish
+ *
+ * Data written after the search starts is not scanned.
+ *
+ * @param options  Pattern and limits
+ * @param callback Receives each match
+ * @param ctx      User context for the callback
+ * @param summary  Outcome (output, may be nullptr)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a malformed pattern,
+ *         ESP_ERR_INVALID_STATE if a search is already running,
+ *         ESP_ERR_NO_MEM if the scan task could not start
+ */
+esp_err_t search(const Options& options, MatchCallback callback, void* ctx,
+                 Summary* summary);
+
+} // namespace RingSearch
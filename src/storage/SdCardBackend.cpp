@@ -0,0 +1,566 @@
+#include "SdCardBackend.h"
+#include "esp_crc.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_vfs_fat.h"
+#include "soc/soc_caps.h"
+#include <dirent.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if SOC_SDMMC_HOST_SUPPORTED
+#include "driver/sdmmc_host.h"
+#endif
+
+static const char* TAG = "SdCardBackend";
+
+// Segment chain directory under the mount point
+static const char* CHAIN_DIR = "DLOG";
+
+// The two index copies (8.3 names: long file names may be disabled)
+static const char* INDEX_NAMES[2] = {"INDEX0.BIN", "INDEX1.BIN"};
+
+// Fraction of the card used when Config::maxSegments is 0
+static const uint32_t CARD_USE_PCT = 90;
+
+// Job::len of the message that stops the write task
+static const size_t QUIT_JOB = SIZE_MAX;
+
+SdCardBackend::~SdCardBackend() {
+    deinit();
+}
+
+esp_err_t SdCardBackend::init(const Config& config) {
+    if (m_card) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_OK;
+    }
+    if (!config.mountPoint || config.segmentSize < PAGE_SIZE ||
+        config.segmentSize % PAGE_SIZE != 0 || config.writeBufferSize == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if SOC_SDMMC_HOST_SUPPORTED
+    m_config = config;
+
+    sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+    host.max_freq_khz = SDMMC_FREQ_HIGHSPEED;
+
+    sdmmc_slot_config_t slot = SDMMC_SLOT_CONFIG_DEFAULT();
+    slot.width = config.fourBitBus ? 4 : 1;
+#if SOC_SDMMC_USE_GPIO_MATRIX
+    slot.clk = (gpio_num_t)config.clkPin;
+    slot.cmd = (gpio_num_t)config.cmdPin;
+    slot.d0 = (gpio_num_t)config.d0Pin;
+    slot.d1 = (gpio_num_t)config.d1Pin;
+    slot.d2 = (gpio_num_t)config.d2Pin;
+    slot.d3 = (gpio_num_t)config.d3Pin;
+#endif
+    slot.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+
+    // Large clusters keep the FAT small and long writes contiguous
+    esp_vfs_fat_sdmmc_mount_config_t mountConfig = {};
+    mountConfig.format_if_mount_failed = false;
+    mountConfig.max_files = 4;
+    mountConfig.allocation_unit_size = 64 * 1024;
+
+    esp_err_t ret = esp_vfs_fat_sdmmc_mount(config.mountPoint, &host, &slot,
+                                            &mountConfig, &m_card);
+    if (ret != ESP_OK) {
+        m_card = nullptr;
+        ESP_LOGW(TAG, "No SD card mounted: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    snprintf(m_dir, sizeof(m_dir), "%s/%s", config.mountPoint, CHAIN_DIR);
+    mkdir(m_dir, 0775);
+
+    uint64_t cardBytes = 0;
+    uint64_t freeBytes = 0;
+    esp_vfs_fat_info(config.mountPoint, &cardBytes, &freeBytes);
+    m_maxSegments = config.maxSegments;
+    if (m_maxSegments == 0) {
+        m_maxSegments = (uint32_t)(cardBytes / 100 * CARD_USE_PCT / config.segmentSize);
+    }
+    if (m_maxSegments < 2) {
+        ESP_LOGE(TAG, "Card too small for %" PRIu32 "-byte segments", config.segmentSize);
+        unmount();
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (loadIndex() != ESP_OK) {
+        ESP_LOGW(TAG, "No valid index, starting a new segment chain");
+        resetChain();
+    }
+
+    m_fileBuffer = (char*)heap_caps_malloc(config.writeBufferSize,
+                                           MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    m_queue = xQueueCreate(QUEUE_DEPTH, sizeof(Job));
+    if (!m_fileBuffer || !m_queue) {
+        ESP_LOGE(TAG, "Failed to allocate write buffers");
+        unmount();
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = openSegment(m_head);
+    if (ret != ESP_OK) {
+        unmount();
+        return ret;
+    }
+
+    // Same priority as the FlashRing writer: both only wait on their medium
+    if (xTaskCreate(writeTaskEntry, "sd_write", 4096, this, tskIDLE_PRIORITY + 5,
+                    &m_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create write task");
+        unmount();
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "SD card %s: %" PRIu64 " MB, %" PRIu32 " x %" PRIu32 " KB segments, "
+             "data %" PRIu64 "..%" PRIu64,
+             m_card->cid.name, cardBytes / (1024 * 1024), m_maxSegments,
+             config.segmentSize / 1024, m_tail, m_durableHead);
+    return ESP_OK;
+#else
+    (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void SdCardBackend::deinit() {
+    if (!m_card) {
+        return;
+    }
+    if (m_task) {
+        Job quit = {nullptr, QUIT_JOB, nullptr, nullptr};
+        xQueueSend(m_queue, &quit, portMAX_DELAY);
+        while (m_task) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    unmount();
+}
+
+void SdCardBackend::unmount() {
+    closeFile();
+    if (m_card) {
+        esp_vfs_fat_sdcard_unmount(m_config.mountPoint, m_card);
+        m_card = nullptr;
+    }
+    if (m_queue) {
+        vQueueDelete(m_queue);
+        m_queue = nullptr;
+    }
+    heap_caps_free(m_fileBuffer);
+    m_fileBuffer = nullptr;
+}
+
+esp_err_t SdCardBackend::writeAsync(const uint8_t* data, size_t len,
+                                    Storage::WriteCallback callback, void* ctx,
+                                    TickType_t wait) {
+    if (!m_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!data || len == 0 || len > PAGE_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_queuedHead += len;
+    m_inFlight++;
+    if (m_inFlight > m_queueHighWater) {
+        m_queueHighWater = m_inFlight;
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    Job job = {data, len, callback, ctx};
+    if (xQueueSend(m_queue, &job, wait) != pdTRUE) {
+        portENTER_CRITICAL(&m_lock);
+        m_queuedHead -= len;
+        m_inFlight--;
+        portEXIT_CRITICAL(&m_lock);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+esp_err_t SdCardBackend::flushAsync() {
+    if (!m_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_inFlight++;
+    portEXIT_CRITICAL(&m_lock);
+
+    Job job = {nullptr, 0, nullptr, nullptr};
+    if (xQueueSend(m_queue, &job, portMAX_DELAY) != pdTRUE) {
+        portENTER_CRITICAL(&m_lock);
+        m_inFlight--;
+        portEXIT_CRITICAL(&m_lock);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+esp_err_t SdCardBackend::waitIdle(TickType_t wait) {
+    if (!m_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    while (true) {
+        portENTER_CRITICAL(&m_lock);
+        uint32_t inFlight = m_inFlight;
+        portEXIT_CRITICAL(&m_lock);
+
+        if (inFlight == 0) {
+            return ESP_OK;
+        }
+        if (xTaskGetTickCount() - start >= wait) {
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+}
+
+esp_err_t SdCardBackend::readLogical(uint64_t position, uint8_t* data, size_t len,
+                                     size_t* bytesRead) {
+    if (!m_card) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!data || !bytesRead) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *bytesRead = 0;
+
+    portENTER_CRITICAL(&m_lock);
+    uint64_t tail = m_tail;
+    uint64_t head = m_durableHead;
+    portEXIT_CRITICAL(&m_lock);
+
+    if (position < tail) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (position >= head) {
+        return ESP_OK;
+    }
+
+    // One segment per call; the caller loops like with FlashRing
+    uint32_t offset = (uint32_t)(position % m_config.segmentSize);
+    uint64_t available = head - position;
+    size_t toRead = len;
+    if (toRead > available) {
+        toRead = (size_t)available;
+    }
+    if (toRead > m_config.segmentSize - offset) {
+        toRead = m_config.segmentSize - offset;
+    }
+
+    char path[48];
+    segmentPath((uint32_t)(position / m_config.segmentSize), path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return ESP_ERR_NOT_FOUND; // Recycled since the tail was sampled
+    }
+    esp_err_t ret = ESP_OK;
+    if (fseek(file, (long)offset, SEEK_SET) != 0) {
+        ret = ESP_FAIL;
+    } else {
+        *bytesRead = fread(data, 1, toRead, file);
+        if (*bytesRead == 0) {
+            ret = ESP_FAIL;
+        }
+    }
+    fclose(file);
+    return ret;
+}
+
+uint64_t SdCardBackend::getLogicalHead() {
+    portENTER_CRITICAL(&m_lock);
+    uint64_t head = m_durableHead;
+    portEXIT_CRITICAL(&m_lock);
+    return head;
+}
+
+uint64_t SdCardBackend::getLogicalTail() {
+    portENTER_CRITICAL(&m_lock);
+    uint64_t tail = m_tail;
+    portEXIT_CRITICAL(&m_lock);
+    return tail;
+}
+
+uint64_t SdCardBackend::getQueuedHead() {
+    portENTER_CRITICAL(&m_lock);
+    uint64_t head = m_queuedHead;
+    portEXIT_CRITICAL(&m_lock);
+    return head;
+}
+
+esp_err_t SdCardBackend::getStats(Storage::Stats* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = {};
+    stats->capacity = (uint64_t)m_maxSegments * m_config.segmentSize;
+
+    portENTER_CRITICAL(&m_lock);
+    stats->usedBytes = m_durableHead - m_tail;
+    stats->totalWritten = m_totalWritten;
+    stats->writeErrors = m_writeErrors;
+    stats->writeQueueHighWater = m_queueHighWater;
+    portEXIT_CRITICAL(&m_lock);
+    return ESP_OK;
+}
+
+void SdCardBackend::writeTaskEntry(void* arg) {
+    static_cast<SdCardBackend*>(arg)->writeTask();
+}
+
+void SdCardBackend::writeTask() {
+    Job job;
+    while (xQueueReceive(m_queue, &job, portMAX_DELAY) == pdTRUE) {
+        if (job.len == QUIT_JOB) {
+            break;
+        }
+
+        esp_err_t result = job.data ? writeChunk(job.data, job.len) : flush();
+        if (result != ESP_OK) {
+            portENTER_CRITICAL(&m_lock);
+            m_writeErrors++;
+            portEXIT_CRITICAL(&m_lock);
+        }
+        if (job.callback) {
+            job.callback(job.data, job.len, result, job.ctx);
+        }
+
+        portENTER_CRITICAL(&m_lock);
+        m_inFlight--;
+        portEXIT_CRITICAL(&m_lock);
+    }
+
+    flush();
+    m_task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+esp_err_t SdCardBackend::writeChunk(const uint8_t* data, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        if (!m_file) {
+            esp_err_t ret = openSegment(m_head);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+
+        uint32_t room = m_config.segmentSize - (uint32_t)(m_head % m_config.segmentSize);
+        size_t n = len - done;
+        if (n > room) {
+            n = room;
+        }
+        if (fwrite(data + done, 1, n, m_file) != n) {
+            ESP_LOGE(TAG, "Write failed at %" PRIu64, m_head);
+            closeFile(); // Reopened and repositioned on the next write
+            return ESP_FAIL;
+        }
+        m_head += n;
+        done += n;
+
+        portENTER_CRITICAL(&m_lock);
+        m_totalWritten += n;
+        portEXIT_CRITICAL(&m_lock);
+
+        if (m_head % m_config.segmentSize == 0) {
+            // Segment full: make it durable before starting the next one
+            esp_err_t ret = flush();
+            closeFile();
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t SdCardBackend::flush() {
+    if (m_file) {
+        if (fflush(m_file) != 0 || fsync(fileno(m_file)) != 0) {
+            ESP_LOGE(TAG, "Sync failed");
+            closeFile();
+            return ESP_FAIL;
+        }
+    }
+
+    uint64_t previousHead = getLogicalHead();
+    portENTER_CRITICAL(&m_lock);
+    m_durableHead = m_head;
+    portEXIT_CRITICAL(&m_lock);
+
+    esp_err_t ret = saveIndex();
+    if (ret != ESP_OK) {
+        // Data is on the card but a reset would not find it: stay readable
+        // only up to what the index covers
+        portENTER_CRITICAL(&m_lock);
+        m_durableHead = previousHead;
+        portEXIT_CRITICAL(&m_lock);
+    }
+    return ret;
+}
+
+// Open the segment holding @p position, creating or recycling it when the
+// position is at its start
+esp_err_t SdCardBackend::openSegment(uint64_t position) {
+    closeFile();
+
+    uint32_t segment = (uint32_t)(position / m_config.segmentSize);
+    uint32_t offset = (uint32_t)(position % m_config.segmentSize);
+    char path[48];
+    segmentPath(segment, path, sizeof(path));
+
+    m_file = fopen(path, "r+b");
+    if (!m_file && offset == 0) {
+        uint64_t tail = getLogicalTail();
+        if (segment - (uint32_t)(tail / m_config.segmentSize) >= m_maxSegments) {
+            // Chain full: the oldest file becomes the new segment, already
+            // allocated at full size
+            char oldest[48];
+            segmentPath((uint32_t)(tail / m_config.segmentSize), oldest, sizeof(oldest));
+            portENTER_CRITICAL(&m_lock);
+            m_tail = tail + m_config.segmentSize;
+            portEXIT_CRITICAL(&m_lock);
+            if (rename(oldest, path) == 0) {
+                m_file = fopen(path, "r+b");
+            } else {
+                unlink(oldest);
+            }
+        }
+        if (!m_file) {
+            // New file: seek past the end so FAT allocates every cluster now
+            m_file = fopen(path, "w+b");
+            if (m_file && (fseek(m_file, (long)m_config.segmentSize - 1, SEEK_SET) != 0 ||
+                           fputc(0, m_file) == EOF || fflush(m_file) != 0)) {
+                closeFile();
+                unlink(path);
+            }
+        }
+    }
+    if (!m_file) {
+        ESP_LOGE(TAG, "Cannot open segment %s", path);
+        return ESP_FAIL;
+    }
+
+    setvbuf(m_file, m_fileBuffer, _IOFBF, m_config.writeBufferSize);
+    if (fseek(m_file, (long)offset, SEEK_SET) != 0) {
+        closeFile();
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void SdCardBackend::closeFile() {
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void SdCardBackend::segmentPath(uint32_t segment, char* path, size_t size) const {
+    snprintf(path, size, "%s/%08" PRIX32 ".BIN", m_dir, segment);
+}
+
+esp_err_t SdCardBackend::loadIndex() {
+    Index best = {};
+    bool found = false;
+    for (const char* name : INDEX_NAMES) {
+        char path[48];
+        snprintf(path, sizeof(path), "%s/%s", m_dir, name);
+        FILE* file = fopen(path, "rb");
+        if (!file) {
+            continue;
+        }
+        Index index;
+        size_t n = fread(&index, 1, sizeof(index), file);
+        fclose(file);
+
+        uint32_t crc = esp_crc32_le(0, reinterpret_cast<const uint8_t*>(&index),
+                                    offsetof(Index, crc32));
+        if (n != sizeof(index) || index.magic != INDEX_MAGIC || index.crc32 != crc ||
+            index.segmentSize != m_config.segmentSize || index.head < index.tail) {
+            continue;
+        }
+        if (!found || index.sequence > best.sequence) {
+            best = index;
+            found = true;
+        }
+    }
+    if (!found) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    m_indexSequence = best.sequence;
+    m_head = best.head;
+    m_tail = best.tail;
+    m_durableHead = best.head;
+    m_queuedHead = best.head;
+
+    // A smaller maxSegments than before drops the oldest segments
+    uint64_t limit = (uint64_t)m_maxSegments * m_config.segmentSize;
+    while (m_head - m_tail >= limit) {
+        char path[48];
+        segmentPath((uint32_t)(m_tail / m_config.segmentSize), path, sizeof(path));
+        unlink(path);
+        m_tail += m_config.segmentSize;
+    }
+    return ESP_OK;
+}
+
+esp_err_t SdCardBackend::saveIndex() {
+    Index index = {};
+    index.magic = INDEX_MAGIC;
+    index.sequence = m_indexSequence + 1;
+    index.segmentSize = m_config.segmentSize;
+    index.tail = getLogicalTail();
+    index.head = m_head;
+    index.crc32 = esp_crc32_le(0, reinterpret_cast<const uint8_t*>(&index),
+                               offsetof(Index, crc32));
+
+    // Alternate copies, so a reset mid-write leaves the previous one intact
+    char path[48];
+    snprintf(path, sizeof(path), "%s/%s", m_dir, INDEX_NAMES[index.sequence & 1]);
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return ESP_FAIL;
+    }
+    bool ok = fwrite(&index, 1, sizeof(index), file) == sizeof(index) &&
+              fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+    if (!ok) {
+        ESP_LOGE(TAG, "Index write failed");
+        return ESP_FAIL;
+    }
+    m_indexSequence = index.sequence;
+    return ESP_OK;
+}
+
+// Forget whatever the directory holds and start at position 0
+void SdCardBackend::resetChain() {
+    DIR* dir = opendir(m_dir);
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            char path[48 + sizeof(entry->d_name)];
+            snprintf(path, sizeof(path), "%s/%s", m_dir, entry->d_name);
+            unlink(path);
+        }
+        closedir(dir);
+    }
+    m_indexSequence = 0;
+    m_head = 0;
+    m_tail = 0;
+    m_durableHead = 0;
+    m_queuedHead = 0;
+}
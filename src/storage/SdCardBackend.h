@@ -0,0 +1,150 @@
+#pragma once
+
+#include "IStorageBackend.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "sdmmc_cmd.h"
+#include <stdio.h>
+
+/**
+ * @brief SdCardBackend - Bulk storage on an SD card (SDMMC, 1- or 4-bit bus)
+ *
+ * The card holds a chain of preallocated segment files of segmentSize
+ * bytes in <mountPoint>/DLOG. Segment n stores logical positions
+ * [n * segmentSize, (n + 1) * segmentSize). Files are created at full size,
+ * so FAT clusters are allocated once, not on every append. When the chain
+ * reaches maxSegments, the oldest file is renamed to become the next
+ * segment. The card therefore works like a ring and is never reformatted.
+ *
+ * Writes are buffered in a large stdio buffer, so the card gets multi-sector
+ * sequential writes rather than one small write per page. flushAsync()
+ * syncs the file and records head and tail in an index file, kept in two
+ * alternating copies. Only data up to the last flush is readable and
+ * survives a reset.
+ *
+ * On the ESP32 the SDMMC slot 1 pins are fixed (CLK 14, CMD 15, D0-D3 on
+ * 2/4/12/13), which leaves the W5500 SPI pins free. The ESP32-S3 routes the
+ * bus through the GPIO matrix with the pins in Config.
+ *
+ * Pin sharing on the ESP32:
+ * - D0 is GPIO2, the onboard LED of most boards: the LED manager must be
+ *   started without an LED while the card is in use.
+ * - D2 is GPIO12 (MTDI), the strapping pin that selects the flash voltage.
+ *   The 10k pull-up every SD data line needs holds it high at reset, which
+ *   selects 1.8V and stops a 3.3V flash module from booting. The 4-bit bus
+ *   therefore needs the strap disabled first (espefuse.py
+ *   set_flash_voltage 3.3V, one-time); otherwise keep the default 1-bit bus,
+ *   where GPIO12 is left unconnected.
+ * - CMD, D0 and D3 (card select at power-up) need the external pull-ups in
+ *   either mode; the internal ones are enabled too but are too weak alone.
+ */
+class SdCardBackend : public IStorageBackend {
+public:
+    /// Backend configuration
+    struct Config {
+        const char* mountPoint = "/sd";        ///< VFS mount point
+        uint32_t segmentSize = 8 * 1024 * 1024; ///< Bytes per segment file
+        uint32_t maxSegments = 0;               ///< Segments kept (0 = 90% of the card)
+        size_t writeBufferSize = 32 * 1024;     ///< stdio buffer per open segment
+        bool fourBitBus = false;                ///< true = D0-D3 (ESP32: GPIO12 strap, see above)
+        int clkPin = 14;                        ///< CLK GPIO (GPIO matrix targets only)
+        int cmdPin = 15;                        ///< CMD GPIO (GPIO matrix targets only)
+        int d0Pin = 2;                          ///< D0 GPIO (GPIO matrix targets only)
+        int d1Pin = 4;                          ///< D1 GPIO (GPIO matrix targets only)
+        int d2Pin = 12;                         ///< D2 GPIO (GPIO matrix targets only)
+        int d3Pin = 13;                         ///< D3 GPIO (GPIO matrix targets only)
+    };
+
+    SdCardBackend() = default;
+    ~SdCardBackend() override;
+
+    SdCardBackend(const SdCardBackend&) = delete;
+    SdCardBackend& operator=(const SdCardBackend&) = delete;
+
+    /**
+     * @brief Mount the card and resume the segment chain
+     *
+     * If the index is missing or was written with another segment size,
+     * the chain starts again from position 0. No retries are made: a
+     * missing card fails fast.
+     * @return ESP_OK, ESP_ERR_NOT_SUPPORTED without an SDMMC host,
+     *         or the mount error
+     */
+    esp_err_t init(const Config& config);
+
+    /// Flush, stop the write task and unmount
+    void deinit();
+
+    bool isMounted() const { return m_card != nullptr; }
+
+    esp_err_t writeAsync(const uint8_t* data, size_t len, Storage::WriteCallback callback,
+                         void* ctx, TickType_t wait) override;
+    esp_err_t flushAsync() override;
+    esp_err_t waitIdle(TickType_t wait) override;
+    esp_err_t readLogical(uint64_t position, uint8_t* data, size_t len,
+                          size_t* bytesRead) override;
+    uint64_t getLogicalHead() override;
+    uint64_t getLogicalTail() override;
+    uint64_t getQueuedHead() override;
+    esp_err_t getStats(Storage::Stats* stats) override;
+    Storage::Type getType() const override { return Storage::Type::SD_CARD; }
+
+private:
+    /// Write task job; data == nullptr means flush, len == SIZE_MAX means quit
+    struct Job {
+        const uint8_t* data;
+        size_t len;
+        Storage::WriteCallback callback;
+        void* ctx;
+    };
+
+    /// Index copy, written alternately to two files
+    struct Index {
+        uint32_t magic;
+        uint32_t sequence;     ///< Newer copy wins
+        uint32_t segmentSize;
+        uint32_t reserved;
+        uint64_t tail;
+        uint64_t head;
+        uint32_t crc32;        ///< CRC of the fields above
+    };
+
+    static constexpr uint32_t INDEX_MAGIC = 0x58444453; // "SDDX"
+    static constexpr size_t QUEUE_DEPTH = 8;
+
+    Config m_config;
+    char m_dir[24] = {};
+    sdmmc_card_t* m_card = nullptr;
+    uint32_t m_maxSegments = 0;
+
+    QueueHandle_t m_queue = nullptr;
+    TaskHandle_t m_task = nullptr;
+    portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Owned by the write task
+    FILE* m_file = nullptr;
+    char* m_fileBuffer = nullptr;
+    uint64_t m_head = 0;           ///< Next byte written to the file
+    uint32_t m_indexSequence = 0;
+
+    // Shared, under m_lock
+    uint64_t m_tail = 0;
+    uint64_t m_durableHead = 0;
+    uint64_t m_queuedHead = 0;
+    uint32_t m_inFlight = 0;
+    uint32_t m_queueHighWater = 0;
+    uint32_t m_writeErrors = 0;
+    uint64_t m_totalWritten = 0;
+
+    static void writeTaskEntry(void* arg);
+    void writeTask();
+    esp_err_t writeChunk(const uint8_t* data, size_t len);
+    esp_err_t flush();
+    esp_err_t openSegment(uint64_t position);
+    esp_err_t loadIndex();
+    esp_err_t saveIndex();
+    void resetChain();
+    void segmentPath(uint32_t segment, char* path, size_t size) const;
+    void closeFile();
+    void unmount();
+};
@@ -0,0 +1,208 @@
+#include "StorageTier.h"
+#include "FlashRing.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cinttypes>
+#include <cstdlib>
+
+static const char *TAG = "StorageTier";
+
+// Cursor name in the FlashRing journal
+static const char *CURSOR_NAME = "tier";
+
+// Buffers handed to the bulk backend before waiting for it
+static const size_t BUFFER_COUNT = 4;
+
+// Copied bytes that trigger a bulk flush and a cursor advance
+static const uint64_t COMMIT_BYTES = 256 * 1024;
+
+// Poll interval once caught up with the ring
+static const uint32_t IDLE_POLL_MS = 500;
+
+// Pause after a failed commit (card removed, full, ...)
+static const uint32_t ERROR_BACKOFF_MS = 5000;
+
+// Cursor positions are journaled at most this often
+static const uint32_t CURSOR_SAVE_INTERVAL_MS = 10000;
+
+namespace StorageTier {
+
+static IStorageBackend *s_bulk = nullptr;
+static FlashRing::CursorId s_cursor = -1;
+static TaskHandle_t s_taskHandle = nullptr;
+
+static uint8_t *s_buffers[BUFFER_COUNT] = {};
+static size_t s_buffersQueued = 0;
+
+static uint64_t s_readPos = 0;     // Next byte to copy (ahead of the cursor)
+static uint64_t s_uncommitted = 0; // Copied but not flushed by the bulk tier
+static uint32_t s_bulkErrors = 0;  // Bulk writeErrors at the last commit
+static bool s_cursorMoved = false;
+static TickType_t s_lastCursorSave = 0;
+
+static Stats s_stats = {};
+
+static void tierTask(void *arg);
+
+esp_err_t init(IStorageBackend *bulk) {
+  if (s_taskHandle) {
+    return ESP_OK;
+  }
+  if (!bulk) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  s_bulk = bulk;
+
+  esp_err_t ret = FlashRing::openCursor(CURSOR_NAME, &s_cursor);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open cursor: %s", esp_err_to_name(ret));
+    return ret;
+  }
+  FlashRing::CursorInfo info;
+  FlashRing::getCursor(s_cursor, &info);
+  s_readPos = info.position;
+
+  for (size_t i = 0; i < BUFFER_COUNT; i++) {
+    s_buffers[i] = (uint8_t *)malloc(IStorageBackend::PAGE_SIZE);
+    if (!s_buffers[i]) {
+      ESP_LOGE(TAG, "Failed to allocate copy buffers");
+      for (size_t j = 0; j < i; j++) {
+        free(s_buffers[j]);
+        s_buffers[j] = nullptr;
+      }
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  Storage::Stats bulkStats;
+  s_bulk->getStats(&bulkStats);
+  s_bulkErrors = bulkStats.writeErrors;
+
+  // Below the MQTT forwarder: the uplink is more urgent than the archive
+  if (xTaskCreate(tierTask, "storage_tier", 3072, nullptr,
+                  tskIDLE_PRIORITY + 2, &s_taskHandle) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create tier task");
+    for (size_t i = 0; i < BUFFER_COUNT; i++) {
+      free(s_buffers[i]);
+      s_buffers[i] = nullptr;
+    }
+    return ESP_ERR_NO_MEM;
+  }
+
+  ESP_LOGI(TAG, "Copying flash ring from %" PRIu64 " (%" PRIu64 " bytes pending)",
+           info.position, info.pending);
+  return ESP_OK;
+}
+
+bool isRunning() { return s_taskHandle != nullptr; }
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *stats = s_stats;
+  FlashRing::CursorInfo info;
+  if (s_taskHandle && FlashRing::getCursor(s_cursor, &info) == ESP_OK) {
+    stats->pending = info.pending;
+    stats->dropped = info.dropped;
+  }
+  return ESP_OK;
+}
+
+// Fill @p buffer from the ring at s_readPos, returns the bytes read
+static size_t readChunk(uint8_t *buffer) {
+  size_t total = 0;
+  while (total < IStorageBackend::PAGE_SIZE) {
+    size_t bytesRead = 0;
+    esp_err_t ret = FlashRing::readLogical(s_readPos + total, buffer + total,
+                                           IStorageBackend::PAGE_SIZE - total,
+                                           &bytesRead);
+    if (ret == ESP_ERR_NOT_FOUND && total == 0) {
+      // Overwritten before it was copied: the cursor accounts the loss
+      uint64_t tail = FlashRing::getLogicalTail();
+      ESP_LOGW(TAG, "Data overwritten before archiving, skipping %" PRIu64
+               " bytes", tail - s_readPos);
+      s_readPos = tail;
+      continue;
+    }
+    if (ret != ESP_OK || bytesRead == 0) {
+      break;
+    }
+    total += bytesRead;
+  }
+  return total;
+}
+
+// Make the copied range durable on the bulk tier, then move the cursor
+static bool commit() {
+  s_bulk->flushAsync();
+  s_bulk->waitIdle(portMAX_DELAY);
+  s_buffersQueued = 0;
+
+  Storage::Stats bulkStats;
+  s_bulk->getStats(&bulkStats);
+  if (bulkStats.writeErrors != s_bulkErrors) {
+    s_bulkErrors = bulkStats.writeErrors;
+    s_stats.writeErrors++;
+    FlashRing::CursorInfo info;
+    FlashRing::getCursor(s_cursor, &info);
+    ESP_LOGW(TAG, "Bulk write failed, copying again from %" PRIu64,
+             info.position);
+    s_readPos = info.position;
+    s_uncommitted = 0;
+    return false;
+  }
+
+  FlashRing::seekCursor(s_cursor, s_readPos);
+  s_stats.bytesCopied += s_uncommitted;
+  s_stats.commits++;
+  s_uncommitted = 0;
+  s_cursorMoved = true;
+  return true;
+}
+
+static void tierTask(void *arg) {
+  size_t next = 0;
+
+  while (true) {
+    bool ok = true;
+    size_t len = readChunk(s_buffers[next]);
+    if (len > 0) {
+      if (s_bulk->writeAsync(s_buffers[next], len, nullptr, nullptr,
+                             portMAX_DELAY) == ESP_OK) {
+        s_readPos += len;
+        s_uncommitted += len;
+        next = (next + 1) % BUFFER_COUNT;
+        // Buffers are reused in order: wait for all of them at once
+        if (++s_buffersQueued == BUFFER_COUNT) {
+          s_bulk->waitIdle(portMAX_DELAY);
+          s_buffersQueued = 0;
+        }
+      } else {
+        ok = false;
+      }
+    }
+
+    if (ok && (s_uncommitted >= COMMIT_BYTES || (len == 0 && s_uncommitted > 0))) {
+      ok = commit();
+    }
+
+    // Persist progress without journaling every commit
+    TickType_t now = xTaskGetTickCount();
+    if (s_cursorMoved && (now - s_lastCursorSave) >=
+                             pdMS_TO_TICKS(CURSOR_SAVE_INTERVAL_MS)) {
+      FlashRing::flushMetadataAsync();
+      s_cursorMoved = false;
+      s_lastCursorSave = now;
+    }
+
+    if (!ok) {
+      vTaskDelay(pdMS_TO_TICKS(ERROR_BACKOFF_MS));
+    } else if (len == 0) {
+      vTaskDelay(pdMS_TO_TICKS(IDLE_POLL_MS));
+    }
+  }
+}
+
+} // namespace StorageTier
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "IStorageBackend.h"
+#include "esp_err.h"
+#include <cstdint>
+
+/**
+ * @brief StorageTier - Background copy of the flash ring to a bulk backend
+ *
+ * Internal flash stays the hot tier: DataPipeline and RecordStore write
+ * there at capture rate. This module drains the ring through its own
+ * cursor ("tier") and appends the stream to a larger, slower backend (an
+ * SD card), so data survives after FlashRing has overwritten it.
+ *
+ * The cursor only advances once the bulk backend has flushed the copied
+ * range. Copying is therefore at-least-once: after a reset, the bytes
+ * between the last flushed position and the last journaled cursor are
+ * copied again. The task runs below capture and the uplink, and only
+ * reads what FlashRing has already stored.
+ */
+namespace StorageTier {
+
+/// Statistics for debugging and monitoring
+struct Stats {
+  uint64_t bytesCopied;  ///< Stream bytes committed to the bulk tier
+  uint64_t pending;      ///< Bytes in flash not yet committed
+  uint64_t dropped;      ///< Bytes overwritten in flash before they were copied
+  uint32_t commits;      ///< Bulk flushes that advanced the cursor
+  uint32_t writeErrors;  ///< Failed bulk writes (the range is copied again)
+};
+
+/**
+ * @brief Open the "tier" cursor and start the copy task
+ *
+ * Must be called after FlashRing::init(). @p bulk must be initialized and
+ * must stay valid for the lifetime of the program.
+ *
+ * @param bulk Backend that receives the aged-out data
+ * @return ESP_OK on success
+ */
+esp_err_t init(IStorageBackend *bulk);
+
+/**
+ * @brief Check if the copy task is running
+ */
+bool isRunning();
+
+/**
+ * @brief Get tiering statistics
+ */
+esp_err_t getStats(Stats *stats);
+
+} // namespace StorageTier
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief Common types and definitions for storage backends
+ */
+
+namespace Storage {
+
+/**
+ * @brief Completion callback for IStorageBackend::writeAsync()
+ *
+ * Runs in the backend's write task once the data is stored (or failed).
+ * The buffer may be reused from this point on.
+ */
+using WriteCallback = void (*)(const uint8_t* data, size_t len, esp_err_t result, void* ctx);
+
+/// Statistics structure common to all backends
+struct Stats {
+    uint64_t capacity;            ///< Bytes the backend can hold
+    uint64_t usedBytes;           ///< Bytes currently stored
+    uint64_t totalWritten;        ///< Bytes written since init
+    uint32_t writeErrors;         ///< Failed writes since init
+    uint32_t writeQueueHighWater; ///< Maximum writes in flight
+    uint32_t eraseStalls;         ///< Writes that had to wait for an erase (flash)
+    uint64_t eraseStallUs;        ///< Time spent waiting for erases (flash)
+    uint64_t stallAvoidedUs;      ///< Erase time hidden by pre-erasing (flash)
+    uint32_t lookAheadPages;      ///< Current pre-erase window in pages (flash)
+};
+
+/// Backend type enumeration
+enum class Type {
+    FLASH_RING,  ///< Internal flash partition (FlashRing)
+    SD_CARD      ///< Preallocated files on an SD card
+};
+
+} // namespace Storage
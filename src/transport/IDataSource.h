@@ -2,7 +2,9 @@
 
 #include "TransportTypes.h"
 #include "esp_err.h"
-#include "freertos/ringbuf.h"
+
+class SlotPool;
+class StagingRing;
 
 /**
  * @brief Abstract interface for data source transports
@@ -23,10 +25,21 @@ public:
     virtual esp_err_t init(const void* config) = 0;
 
     /**
-     * @brief Get the ring buffer handle for reading captured data
-     * @return RingbufHandle_t or nullptr if not initialized
+     * @brief Get the ring the captured data is read from (consumer side)
+     * @return StagingRing or nullptr if not initialized
+     */
+    virtual StagingRing* getRing() = 0;
+
+    /**
+     * @brief Get the slot pool when the transport runs in zero-copy mode
+     *
+     * In zero-copy mode the transport fills page-sized slots in place and
+     * getRing() returns nullptr. Transports that only support the
+     * ring buffer keep this default.
+     *
+     * @return SlotPool pointer or nullptr if zero-copy mode is not active
      */
-    virtual RingbufHandle_t getRingBuffer() = 0;
+    virtual SlotPool* getSlotPool() { return nullptr; }
 
     /**
      * @brief Set callback for burst events
@@ -34,6 +47,15 @@ public:
      */
     virtual void setBurstCallback(Transport::BurstCallback callback) = 0;
 
+    /**
+     * @brief Set callback for chunk capture times
+     *
+     * Transports that do not timestamp their chunks keep this default.
+     *
+     * @param callback Function to call for each captured chunk
+     */
+    virtual void setChunkCallback(Transport::ChunkCallback callback) { (void)callback; }
+
     /**
      * @brief Get transport statistics
      * @param stats Pointer to stats structure (output)
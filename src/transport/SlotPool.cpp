@@ -0,0 +1,104 @@
+#include "SlotPool.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <cstdlib>
+
+static const char *TAG = "SlotPool";
+
+SlotPool::~SlotPool() {
+    deinit();
+}
+
+esp_err_t SlotPool::init(size_t slotCount) {
+    if (m_storage) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_OK;
+    }
+
+    if (slotCount < 2) {
+        ESP_LOGE(TAG, "At least 2 slots required (got %u)", slotCount);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 32-bit aligned internal RAM: slots are handed directly to the flash driver
+    m_storage = static_cast<uint8_t*>(
+        heap_caps_aligned_alloc(4, slotCount * SLOT_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    m_slots = static_cast<Slot*>(calloc(slotCount, sizeof(Slot)));
+    m_freeQueue = xQueueCreate(slotCount, sizeof(Slot*));
+    m_filledQueue = xQueueCreate(slotCount, sizeof(Slot*));
+
+    if (!m_storage || !m_slots || !m_freeQueue || !m_filledQueue) {
+        ESP_LOGE(TAG, "Failed to allocate %u slots", slotCount);
+        deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    m_slotCount = slotCount;
+    for (size_t i = 0; i < slotCount; i++) {
+        Slot* slot = &m_slots[i];
+        slot->data = m_storage + i * SLOT_SIZE;
+        slot->len = 0;
+        xQueueSend(m_freeQueue, &slot, 0);
+    }
+
+    ESP_LOGI(TAG, "Initialized: %u slots x %u bytes", slotCount, SLOT_SIZE);
+    return ESP_OK;
+}
+
+void SlotPool::deinit() {
+    if (m_filledQueue) {
+        vQueueDelete(m_filledQueue);
+        m_filledQueue = nullptr;
+    }
+    if (m_freeQueue) {
+        vQueueDelete(m_freeQueue);
+        m_freeQueue = nullptr;
+    }
+    free(m_slots);
+    m_slots = nullptr;
+    heap_caps_free(m_storage);
+    m_storage = nullptr;
+    m_slotCount = 0;
+}
+
+SlotPool::Slot* SlotPool::acquire(TickType_t wait) {
+    Slot* slot = nullptr;
+    if (!m_freeQueue || xQueueReceive(m_freeQueue, &slot, wait) != pdTRUE) {
+        return nullptr;
+    }
+    slot->len = 0;
+    return slot;
+}
+
+void SlotPool::commit(Slot* slot) {
+    if (!slot) {
+        return;
+    }
+    // Never block the producer: the pool is sized so both queues can hold every slot
+    QueueHandle_t target = (slot->len > 0) ? m_filledQueue : m_freeQueue;
+    xQueueSend(target, &slot, 0);
+}
+
+SlotPool::Slot* SlotPool::receive(TickType_t wait) {
+    Slot* slot = nullptr;
+    if (!m_filledQueue || xQueueReceive(m_filledQueue, &slot, wait) != pdTRUE) {
+        return nullptr;
+    }
+    return slot;
+}
+
+void SlotPool::release(Slot* slot) {
+    if (!slot) {
+        return;
+    }
+    slot->len = 0;
+    xQueueSend(m_freeQueue, &slot, 0);
+}
+
+size_t SlotPool::filledCount() const {
+    return m_filledQueue ? uxQueueMessagesWaiting(m_filledQueue) : 0;
+}
+
+size_t SlotPool::freeCount() const {
+    return m_freeQueue ? uxQueueMessagesWaiting(m_freeQueue) : 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief SlotPool - Preallocated pool of flash-page-sized buffers
+ *
+ * Zero-copy handoff between a transport and the flash writer. The transport
+ * acquires an empty slot, fills it in place (e.g. uart_read_bytes straight
+ * into the slot), and commits it. The writer receives the slot pointer,
+ * passes the data to FlashRing::writeAsync as-is, and releases it back to the
+ * pool once programmed. Bytes are never copied between the two tasks.
+ *
+ * Both directions are FreeRTOS queues of Slot pointers, so one producer
+ * and one consumer can run on different cores without extra locking.
+ */
+class SlotPool {
+public:
+    /// Slot capacity, one flash page
+    static constexpr size_t SLOT_SIZE = 4096;
+
+    /// A page-sized buffer owned by either the producer or the consumer
+    struct Slot {
+        uint8_t* data; ///< SLOT_SIZE bytes of storage
+        size_t len;    ///< Valid bytes in data
+    };
+
+    ~SlotPool();
+
+    /**
+     * @brief Allocate the pool
+     * @param slotCount Number of slots (at least 2)
+     * @return ESP_OK on success
+     */
+    esp_err_t init(size_t slotCount);
+
+    /**
+     * @brief Release all storage
+     */
+    void deinit();
+
+    /**
+     * @brief Get an empty slot (producer side)
+     * @param wait Ticks to wait for a free slot
+     * @return Slot with len == 0, or nullptr if none available
+     */
+    Slot* acquire(TickType_t wait);
+
+    /**
+     * @brief Hand a filled slot to the consumer (producer side)
+     * @param slot Slot obtained from acquire(); empty slots are recycled
+     */
+    void commit(Slot* slot);
+
+    /**
+     * @brief Get the next filled slot (consumer side)
+     * @param wait Ticks to wait for data
+     * @return Filled slot, or nullptr on timeout
+     */
+    Slot* receive(TickType_t wait);
+
+    /**
+     * @brief Return a consumed slot to the pool (consumer side)
+     * @param slot Slot obtained from receive()
+     */
+    void release(Slot* slot);
+
+    /**
+     * @brief Number of filled slots waiting for the consumer
+     */
+    size_t filledCount() const;
+
+    /**
+     * @brief Number of empty slots available to the producer
+     */
+    size_t freeCount() const;
+
+    /**
+     * @brief Total number of slots in the pool
+     */
+    size_t slotCount() const { return m_slotCount; }
+
+private:
+    uint8_t* m_storage = nullptr;
+    Slot* m_slots = nullptr;
+    size_t m_slotCount = 0;
+    QueueHandle_t m_freeQueue = nullptr;
+    QueueHandle_t m_filledQueue = nullptr;
+};
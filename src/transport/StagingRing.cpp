@@ -0,0 +1,147 @@
+#include "StagingRing.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cstring>
+
+static const char *TAG = "StagingRing";
+
+// Largest power of two not above n
+static size_t floorPow2(size_t n) {
+    size_t p = 1;
+    while (p <= n / 2) {
+        p *= 2;
+    }
+    return p;
+}
+
+StagingRing::~StagingRing() {
+    deinit();
+}
+
+esp_err_t StagingRing::init(size_t internalSize, size_t psramSize,
+                            bool planned) {
+    if (m_storage) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_OK;
+    }
+    if (internalSize < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t size = 0;
+    if (psramSize >= 2) {
+        size = floorPow2(psramSize);
+        m_region = planned ? MemoryPlan::Region::CAPTURE_RING_PSRAM
+                           : MemoryPlan::Region::NONE;
+        m_storage = static_cast<uint8_t*>(
+            planned ? MemoryPlan::alloc(m_region, size)
+                    : heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+        if (!m_storage) {
+            ESP_LOGW(TAG, "No %uKB of PSRAM, using %uKB of internal RAM",
+                     size / 1024, floorPow2(internalSize) / 1024);
+        }
+    }
+    m_inPsram = (m_storage != nullptr);
+
+    if (!m_storage) {
+        size = floorPow2(internalSize);
+        m_region = planned ? MemoryPlan::Region::CAPTURE_RING
+                           : MemoryPlan::Region::NONE;
+        m_storage = static_cast<uint8_t*>(
+            planned ? MemoryPlan::alloc(m_region, size)
+                    : heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+        if (!m_storage) {
+            ESP_LOGE(TAG, "Failed to allocate %uKB ring", size / 1024);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    m_size = size;
+    m_mask = size - 1;
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_wakeArmed.store(false, std::memory_order_relaxed);
+    m_highWater = 0;
+    ESP_LOGI(TAG, "Created: %uKB in %s", size / 1024, m_inPsram ? "PSRAM" : "internal RAM");
+    return ESP_OK;
+}
+
+void StagingRing::deinit() {
+    MemoryPlan::release(m_region, m_storage);
+    m_storage = nullptr;
+    m_region = MemoryPlan::Region::NONE;
+    m_size = 0;
+    m_mask = 0;
+    m_inPsram = false;
+}
+
+size_t StagingRing::reserve(uint8_t** data) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    size_t offset = head & m_mask;
+    *data = m_storage + offset;
+    return std::min(m_size - (head - tail), m_size - offset);
+}
+
+void StagingRing::commit(size_t len) {
+    size_t head = m_head.load(std::memory_order_relaxed) + len;
+    m_head.store(head, std::memory_order_seq_cst);
+
+    size_t used = head - m_tail.load(std::memory_order_relaxed);
+    if (used > m_highWater) {
+        m_highWater = used;
+    }
+
+    // Pairs with armWake(): the consumer re-checks the fill after arming
+    if (m_wakeArmed.load(std::memory_order_seq_cst) && used >= m_wakeLevel &&
+        m_wakeArmed.exchange(false, std::memory_order_acq_rel)) {
+        xTaskNotifyGive(m_wakeTask);
+    }
+}
+
+bool StagingRing::push(const void* data, size_t len) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    if (m_size - (head - tail) < len) {
+        m_highWater = m_size;  // As full as it gets for this producer
+        return false;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    size_t offset = head & m_mask;
+    size_t first = std::min(len, m_size - offset);
+    memcpy(m_storage + offset, src, first);
+    memcpy(m_storage, src + first, len - first);
+    commit(len);
+    return true;
+}
+
+size_t StagingRing::peek(const uint8_t** data, size_t maxLen) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+    size_t offset = tail & m_mask;
+    *data = m_storage + offset;
+    return std::min({head - tail, m_size - offset, maxLen});
+}
+
+void StagingRing::release(size_t len) {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+}
+
+bool StagingRing::armWake(TaskHandle_t task, size_t level) {
+    m_wakeTask = task;
+    m_wakeLevel = std::min(level, m_size);
+    m_wakeArmed.store(true, std::memory_order_seq_cst);
+
+    // Data committed before the flag was visible did not notify
+    if (available() >= m_wakeLevel) {
+        m_wakeArmed.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+size_t StagingRing::available() const {
+    return m_head.load(std::memory_order_seq_cst) - m_tail.load(std::memory_order_acquire);
+}
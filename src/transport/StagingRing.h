@@ -0,0 +1,135 @@
+#pragma once
+
+#include "esp_err.h"
+#include "../utils/MemoryPlan.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief StagingRing - Lock-free SPSC byte ring between capture and writer
+ *
+ * Single producer (the transport capture task, Core 0) and single consumer
+ * (the flash writer, Core 1). Head and tail are free-running positions on
+ * separate cache lines, published with release stores and read with
+ * acquire loads, so neither side takes a lock or enters a critical
+ * section. The capacity is a power of two.
+ *
+ * Both sides work on contiguous regions in place: the producer reserves
+ * free space, fills it and commits; the consumer peeks readable bytes,
+ * processes them and releases. push() is the copying all-or-nothing
+ * shorthand for the producer.
+ *
+ * The consumer blocks on its task notification: armWake() asks the
+ * producer to notify it once a wake level (e.g. a page) is readable, so
+ * the producer does not signal per chunk. Smaller amounts are picked up
+ * when the consumer's wait times out.
+ *
+ * Storage is internal RAM, or PSRAM for a multi-megabyte tier absorbing
+ * long bursts while the writer drains it at the rate flash sustains. If
+ * PSRAM is not available the internal size is used instead. A planned
+ * ring (the capture transport's) takes its storage from the MemoryPlan
+ * capture regions.
+ *
+ * Tracks the peak fill to size the tier from field captures.
+ */
+class StagingRing {
+public:
+    ~StagingRing();
+
+    /**
+     * @brief Allocate the ring
+     *
+     * Sizes are rounded down to a power of two.
+     *
+     * @param internalSize Size in internal RAM (used when psramSize is 0 or
+     *                     PSRAM allocation fails)
+     * @param psramSize    Size in PSRAM (0 = internal RAM only)
+     * @param planned      Storage from the MemoryPlan capture regions
+     * @return ESP_OK on success
+     */
+    esp_err_t init(size_t internalSize, size_t psramSize = 0,
+                   bool planned = false);
+
+    /**
+     * @brief Release the storage (neither side may be using the ring)
+     */
+    void deinit();
+
+    // --- Producer side ---
+
+    /**
+     * @brief Get the contiguous free region
+     * @param data Start of the region (output)
+     * @return Region length, 0 if the ring is full
+     */
+    size_t reserve(uint8_t** data);
+
+    /**
+     * @brief Publish @p len bytes written into the reserved region
+     */
+    void commit(size_t len);
+
+    /**
+     * @brief Copy bytes in, all or nothing, without blocking
+     * @return false if they did not fit (overflow)
+     */
+    bool push(const void* data, size_t len);
+
+    // --- Consumer side ---
+
+    /**
+     * @brief Get the contiguous readable region
+     * @param data Start of the region (output)
+     * @param maxLen Largest length to return
+     * @return Region length, 0 if the ring is empty
+     */
+    size_t peek(const uint8_t** data, size_t maxLen);
+
+    /**
+     * @brief Free @p len bytes from the start of the readable region
+     */
+    void release(size_t len);
+
+    /**
+     * @brief Ask for a notification of @p task once @p level bytes are readable
+     * @return false if that much is already readable (no notification follows)
+     */
+    bool armWake(TaskHandle_t task, size_t level);
+
+    // --- Either side ---
+
+    /// Readable bytes
+    size_t available() const;
+
+    /// Capacity in bytes (0 before init)
+    size_t size() const { return m_size; }
+
+    /// Whether the storage lives in PSRAM
+    bool inPsram() const { return m_inPsram; }
+
+    /// Peak fill in bytes since init or resetHighWater()
+    size_t highWater() const { return m_highWater; }
+
+    void resetHighWater() { m_highWater = 0; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    uint8_t* m_storage = nullptr;
+    MemoryPlan::Region m_region = MemoryPlan::Region::NONE; // Of m_storage
+    size_t m_size = 0;
+    size_t m_mask = 0;
+    bool m_inPsram = false;
+    size_t m_highWater = 0;
+
+    // Written by the consumer before arming, read by the producer
+    TaskHandle_t m_wakeTask = nullptr;
+    size_t m_wakeLevel = 0;
+    std::atomic<bool> m_wakeArmed{false};
+
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};  // Producer position
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};  // Consumer position
+};
@@ -4,7 +4,6 @@
 #include <stdint.h>
 
 #include "esp_err.h"
-#include "freertos/ringbuf.h"
 
 /**
  * @brief Common types and definitions for transport layer
@@ -15,6 +14,17 @@ namespace Transport {
 /// Callback for burst events (start/end of data burst)
 using BurstCallback = void (*)(bool burstEnded, size_t bytesInBurst);
 
+/**
+ * @brief Callback for chunk capture times
+ *
+ * Reports that the byte at @p streamOffset had been captured by
+ * @p timestampUs (esp_timer time). Offsets count the bytes handed to the
+ * ring buffer or slot pool since init (wrapping at 32 bits), so transports
+ * report the last byte of each chunk. Called from the capture task before
+ * the chunk is handed over, once per DMA block or UART event.
+ */
+using ChunkCallback = void (*)(uint32_t streamOffset, int64_t timestampUs);
+
 /// Statistics structure common to all transports
 struct Stats {
     size_t totalBytesReceived;      ///< Total bytes received since init
@@ -22,12 +32,15 @@ struct Stats {
     uint32_t burstCount;             ///< Number of bursts detected
     uint32_t overflowCount;           ///< Number of buffer overflows
     bool burstActive;                 ///< Whether a burst is currently active
+    size_t ringSize;                  ///< Ring buffer capacity (0 in zero-copy mode)
+    size_t ringHighWater;             ///< Peak ring buffer fill in bytes since reset
 };
 
 /// Transport type enumeration
 enum class Type {
     UART,           ///< UART serial interface
-    PARALLEL_PORT   ///< 8-bit parallel port with strobe
+    PARALLEL_PORT,  ///< 8-bit parallel port with strobe
+    SYNTHETIC       ///< Pattern generator (benchmarks)
 };
 
 } // namespace Transport
@@ -1,5 +1,8 @@
 #include "ParallelPortCapture.h"
+#include "../../utils/DeferredLog.h"
+#include "../../utils/PerfCounters.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
@@ -23,6 +26,7 @@ esp_err_t ParallelPortCapture::init(const void* config) {
     m_config.strobePin = cfg->strobePin;
     m_config.strobeActiveHigh = cfg->strobeActiveHigh;
     m_config.ringBufSize = cfg->ringBufSize;
+    m_config.psramRingSize = cfg->psramRingSize;
     m_config.timeoutMs = cfg->timeoutMs;
     
     // Copy data pins array
@@ -31,6 +35,7 @@ esp_err_t ParallelPortCapture::init(const void* config) {
     }
     
     memset(&m_stats, 0, sizeof(m_stats));
+    m_streamOffset = 0;
 
     // Validate GPIO pins
     for (int i = 0; i < 8; i++) {
@@ -76,16 +81,14 @@ esp_err_t ParallelPortCapture::init(const void* config) {
     }
 
     // Create queue for strobe events from ISR
-    m_strobeQueue = xQueueCreate(100, sizeof(uint32_t)); // Queue of timestamps
+    m_strobeQueue = xQueueCreate(100, sizeof(int64_t)); // Queue of timestamps (µs)
     if (!m_strobeQueue) {
         ESP_LOGE(TAG, "Failed to create strobe queue");
         return ESP_ERR_NO_MEM;
     }
 
     // Create ring buffer for inter-task communication
-    m_ringBuf = xRingbufferCreate(m_config.ringBufSize, RINGBUF_TYPE_BYTEBUF);
-    if (!m_ringBuf) {
-        ESP_LOGE(TAG, "Failed to create ring buffer");
+    if (m_ring.init(m_config.ringBufSize, m_config.psramRingSize) != ESP_OK) {
         vQueueDelete(m_strobeQueue);
         m_strobeQueue = nullptr;
         return ESP_ERR_NO_MEM;
@@ -95,8 +98,7 @@ esp_err_t ParallelPortCapture::init(const void* config) {
     ret = gpio_install_isr_service(0);
     if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
         ESP_LOGE(TAG, "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
-        vRingbufferDelete(m_ringBuf);
-        m_ringBuf = nullptr;
+        m_ring.deinit();
         vQueueDelete(m_strobeQueue);
         m_strobeQueue = nullptr;
         return ret;
@@ -106,8 +108,7 @@ esp_err_t ParallelPortCapture::init(const void* config) {
     ret = gpio_isr_handler_add((gpio_num_t)m_config.strobePin, strobeISR, this);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to add ISR handler: %s", esp_err_to_name(ret));
-        vRingbufferDelete(m_ringBuf);
-        m_ringBuf = nullptr;
+        m_ring.deinit();
         vQueueDelete(m_strobeQueue);
         m_strobeQueue = nullptr;
         return ret;
@@ -125,35 +126,40 @@ esp_err_t ParallelPortCapture::init(const void* config) {
     if (taskRet != pdPASS) {
         ESP_LOGE(TAG, "Failed to create task");
         gpio_isr_handler_remove((gpio_num_t)m_config.strobePin);
-        vRingbufferDelete(m_ringBuf);
-        m_ringBuf = nullptr;
+        m_ring.deinit();
         vQueueDelete(m_strobeQueue);
         m_strobeQueue = nullptr;
         return ESP_ERR_NO_MEM;
     }
 
     m_initialized = true;
-    ESP_LOGI(TAG, "Initialized: Data pins [%d,%d,%d,%d,%d,%d,%d,%d], Strobe=%d (%s edge), ringBuf=%uKB",
+    ESP_LOGI(TAG, "Initialized: Data pins [%d,%d,%d,%d,%d,%d,%d,%d], Strobe=%d (%s edge), ringBuf=%uKB%s",
              m_config.dataPins[0], m_config.dataPins[1], m_config.dataPins[2], m_config.dataPins[3],
              m_config.dataPins[4], m_config.dataPins[5], m_config.dataPins[6], m_config.dataPins[7],
              m_config.strobePin, m_config.strobeActiveHigh ? "rising" : "falling",
-             m_config.ringBufSize / 1024);
+             m_ring.size() / 1024, m_ring.inPsram() ? " (PSRAM)" : "");
 
     return ESP_OK;
 }
 
-RingbufHandle_t ParallelPortCapture::getRingBuffer() {
-    return m_ringBuf;
+StagingRing* ParallelPortCapture::getRing() {
+    return (m_ring.size() > 0) ? &m_ring : nullptr;
 }
 
 void ParallelPortCapture::setBurstCallback(Transport::BurstCallback callback) {
     m_burstCallback = callback;
 }
 
+void ParallelPortCapture::setChunkCallback(Transport::ChunkCallback callback) {
+    m_chunkCallback = callback;
+}
+
 esp_err_t ParallelPortCapture::getStats(Transport::Stats* stats) {
     if (!stats) {
         return ESP_ERR_INVALID_ARG;
     }
+    m_stats.ringSize = m_ring.size();
+    m_stats.ringHighWater = m_ring.highWater();
     *stats = m_stats;
     return ESP_OK;
 }
@@ -164,6 +170,7 @@ void ParallelPortCapture::resetStats() {
     m_stats.burstCount = 0;
     m_stats.overflowCount = 0;
     m_stats.burstActive = false;
+    m_ring.resetHighWater();
 }
 
 esp_err_t ParallelPortCapture::deinit() {
@@ -176,10 +183,7 @@ esp_err_t ParallelPortCapture::deinit() {
             m_taskHandle = nullptr;
         }
 
-        if (m_ringBuf) {
-            vRingbufferDelete(m_ringBuf);
-            m_ringBuf = nullptr;
-        }
+        m_ring.deinit();
 
         if (m_strobeQueue) {
             vQueueDelete(m_strobeQueue);
@@ -200,8 +204,8 @@ void IRAM_ATTR ParallelPortCapture::strobeISR(void* arg) {
         return;
     }
 
-    // Send timestamp to queue (from ISR)
-    uint32_t timestamp = xTaskGetTickCountFromISR();
+    // Send edge time to queue (from ISR), before the task's latency adds up
+    int64_t timestamp = esp_timer_get_time();
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     xQueueSendFromISR(instance->m_strobeQueue, &timestamp, &xHigherPriorityTaskWoken);
     
@@ -222,7 +226,7 @@ void ParallelPortCapture::captureTask(void *arg) {
 
     ESP_LOGI(TAG, "Parallel port capture task started on Core %d", xPortGetCoreID());
 
-    uint32_t timestamp;
+    int64_t timestamp;
 
     while (true) {
         // Wait for strobe event with timeout
@@ -239,14 +243,26 @@ void ParallelPortCapture::captureTask(void *arg) {
                 ESP_LOGD(TAG, "Burst %lu started", instance->m_stats.burstCount);
             }
 
+            // Capture time of the first byte of the burst and of every
+            // TIME_MARK_INTERVAL-th byte after it
+            const bool timeMark =
+                instance->m_stats.bytesInCurrentBurst % TIME_MARK_INTERVAL == 0;
+            if (timeMark && instance->m_chunkCallback) {
+                instance->m_chunkCallback(instance->m_streamOffset, timestamp);
+            }
+
             // Send to ring buffer (non-blocking)
-            BaseType_t sent = xRingbufferSend(instance->m_ringBuf, &data, 1, 0);
-            if (sent != pdTRUE) {
+            if (!instance->m_ring.push(&data, 1)) {
                 instance->m_stats.overflowCount++;
-                ESP_LOGW(TAG, "Ring buffer overflow! Lost 1 byte");
+                DLOGW(TAG, "Ring buffer overflow! Lost 1 byte");
             } else {
                 instance->m_stats.totalBytesReceived++;
                 instance->m_stats.bytesInCurrentBurst++;
+                instance->m_streamOffset++;
+                if (timeMark) {
+                    // Sampled with the time marks, not per byte
+                    PerfCounters::recordSince(PerfCounters::Stage::CAPTURE_TO_RING, timestamp);
+                }
             }
         } else {
             // Timeout - check if burst ended
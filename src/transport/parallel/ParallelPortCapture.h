@@ -1,11 +1,11 @@
 #pragma once
 
 #include "../IDataSource.h"
+#include "../StagingRing.h"
 #include "../TransportTypes.h"
 #include "driver/gpio.h"
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/ringbuf.h"
 #include "freertos/task.h"
 #include <cstddef>
 #include <cstdint>
@@ -20,6 +20,8 @@
  * - Edge-triggered capture on strobe signal
  * - 8-bit data bus (GPIO pins)
  * - Burst detection via timeout
+ * - Strobe edges timestamped in the ISR (esp_timer µs), reported at burst
+ *   start and every TIME_MARK_INTERVAL bytes
  * - Pinned to Core 0 for deterministic timing
  */
 class ParallelPortCapture : public IDataSource {
@@ -30,24 +32,31 @@ public:
         int strobePin;                ///< GPIO pin for strobe signal (active edge)
         bool strobeActiveHigh = true; ///< true = rising edge, false = falling edge
         size_t ringBufSize = 32 * 1024; ///< Ring buffer size for processing
+        size_t psramRingSize = 0;       ///< Ring buffer in PSRAM instead (0 = internal ringBufSize)
         uint32_t timeoutMs = 100;    ///< Burst end detection timeout
     };
 
     // IDataSource interface implementation
     esp_err_t init(const void* config) override;
-    RingbufHandle_t getRingBuffer() override;
+    StagingRing* getRing() override;
     void setBurstCallback(Transport::BurstCallback callback) override;
+    void setChunkCallback(Transport::ChunkCallback callback) override;
     esp_err_t getStats(Transport::Stats* stats) override;
     void resetStats() override;
     esp_err_t deinit() override;
     Transport::Type getType() const override { return Transport::Type::PARALLEL_PORT; }
 
 private:
+    /// Bytes between reported capture times inside a burst
+    static constexpr uint32_t TIME_MARK_INTERVAL = 256;
+
     Config m_config;
-    RingbufHandle_t m_ringBuf = nullptr;
+    StagingRing m_ring;
     TaskHandle_t m_taskHandle = nullptr;
     QueueHandle_t m_strobeQueue = nullptr;  // Queue for strobe events from ISR
     Transport::BurstCallback m_burstCallback = nullptr;
+    Transport::ChunkCallback m_chunkCallback = nullptr;
+    uint32_t m_streamOffset = 0;            // Bytes pushed to the ring buffer since init
     bool m_initialized = false;
     Transport::Stats m_stats = {};
 
@@ -0,0 +1,632 @@
+#include "ParallelPortDmaCapture.h"
+#include "../../utils/PerfCounters.h"
+#include "driver/gpio.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "soc/soc_caps.h"
+#include <cstring>
+
+#if SOC_I2S_SUPPORTS_LCD_CAMERA
+#include "esp32/rom/lldesc.h"
+#include "esp_private/periph_ctrl.h"
+#include "esp_rom_gpio.h"
+#include "soc/gpio_sig_map.h"
+#include "soc/i2s_reg.h"
+#include "soc/i2s_struct.h"
+#endif
+
+static const char *TAG = "ParallelDma";
+
+#if SOC_I2S_SUPPORTS_LCD_CAMERA
+
+// GPIO matrix input that always reads as logic high (ESP32)
+static constexpr uint32_t GPIO_MATRIX_CONST_HIGH = 0x38;
+
+// I2S camera sampling mode 3 (SM_0A00_0B00): one sample per 32-bit word
+static constexpr uint32_t I2S_RX_FIFO_MODE_ONE_PER_WORD = 3;
+
+// Byte offset of the sample inside each DMA word for sampling mode 3
+static constexpr size_t SAMPLE_BYTE_OFFSET = 2;
+
+// Time for the I2S FIFO to reach RAM after the last counted strobe
+static constexpr uint32_t DMA_SETTLE_US = 5;
+
+esp_err_t ParallelPortDmaCapture::init(const void* config) {
+    if (m_initialized) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_OK;
+    }
+
+    if (!config) {
+        ESP_LOGE(TAG, "Config is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_config = *static_cast<const Config*>(config);
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_samplesConsumed = 0;
+    m_ringPos = 0;
+    m_streamOffset = 0;
+
+    // Validate GPIO pins
+    for (int i = 0; i < 8; i++) {
+        if (m_config.dataPins[i] < 0 || m_config.dataPins[i] >= GPIO_NUM_MAX) {
+            ESP_LOGE(TAG, "Invalid data pin[%d]: %d", i, m_config.dataPins[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    if (m_config.strobePin < 0 || m_config.strobePin >= GPIO_NUM_MAX) {
+        ESP_LOGE(TAG, "Invalid strobe pin: %d", m_config.strobePin);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_blockCount = m_config.dmaBufferSize / DMA_BLOCK_BYTES;
+    if (m_blockCount < 2) {
+        ESP_LOGE(TAG, "DMA buffer too small: %u bytes (min %u)",
+                 m_config.dmaBufferSize, 2 * DMA_BLOCK_BYTES);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Configure data pins as inputs with pull-down
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = 0;
+    io_conf.pull_down_en = GPIO_PULLDOWN_ENABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+
+    for (int i = 0; i < 8; i++) {
+        io_conf.pin_bit_mask |= (1ULL << m_config.dataPins[i]);
+    }
+
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure data pins: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Strobe edge counter (also configures the strobe pin as input)
+    ret = initPulseCounter();
+    if (ret != ESP_OK) {
+        releaseResources();
+        return ret;
+    }
+
+    ret = initDma();
+    if (ret != ESP_OK) {
+        releaseResources();
+        return ret;
+    }
+
+    // Route the bus into I2S0: D0-D7 on the upper data lane, strobe as the
+    // sample clock, sync/enable inputs tied high so every edge is sampled
+    for (int i = 0; i < 8; i++) {
+        esp_rom_gpio_connect_in_signal(m_config.dataPins[i], I2S0I_DATA_IN8_IDX + i, false);
+    }
+    esp_rom_gpio_connect_in_signal(m_config.strobePin, I2S0I_WS_IN_IDX, !m_config.strobeActiveHigh);
+    esp_rom_gpio_connect_in_signal(GPIO_MATRIX_CONST_HIGH, I2S0I_V_SYNC_IDX, false);
+    esp_rom_gpio_connect_in_signal(GPIO_MATRIX_CONST_HIGH, I2S0I_H_SYNC_IDX, false);
+    esp_rom_gpio_connect_in_signal(GPIO_MATRIX_CONST_HIGH, I2S0I_H_ENABLE_IDX, false);
+
+    initI2s();
+
+    // IRAM interrupt so DMA blocks keep being accounted during flash writes
+    ret = esp_intr_alloc(ETS_I2S0_INTR_SOURCE, ESP_INTR_FLAG_IRAM, dmaISR, this, &m_intrHandle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to allocate I2S interrupt: %s", esp_err_to_name(ret));
+        releaseResources();
+        return ret;
+    }
+
+    if (m_config.slotCount > 0) {
+        // Zero-copy mode: samples are compacted straight into page slots
+        ret = m_slotPool.init(m_config.slotCount);
+        if (ret != ESP_OK) {
+            releaseResources();
+            return ret;
+        }
+    } else {
+        // Create ring buffer for inter-task communication
+        if (m_ring.init(m_config.ringBufSize, m_config.psramRingSize) != ESP_OK) {
+            releaseResources();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // Create capture task pinned to Core 0
+    BaseType_t taskRet = xTaskCreatePinnedToCore(
+        captureTask, "parallel_dma",
+        4096, // Stack size
+        this, // Pass instance pointer
+        configMAX_PRIORITIES - 1, // High priority
+        &m_taskHandle,
+        0 // Core 0
+    );
+    if (taskRet != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create task");
+        releaseResources();
+        return ESP_ERR_NO_MEM;
+    }
+
+    startI2s();
+
+    m_initialized = true;
+    ESP_LOGI(TAG, "Initialized: Data pins [%d,%d,%d,%d,%d,%d,%d,%d], Strobe=%d (%s edge), "
+             "DMA=%u blocks (%u samples), ringBuf=%uKB%s",
+             m_config.dataPins[0], m_config.dataPins[1], m_config.dataPins[2], m_config.dataPins[3],
+             m_config.dataPins[4], m_config.dataPins[5], m_config.dataPins[6], m_config.dataPins[7],
+             m_config.strobePin, m_config.strobeActiveHigh ? "rising" : "falling",
+             m_blockCount, m_blockCount * SAMPLES_PER_BLOCK, m_ring.size() / 1024, m_ring.inPsram() ? " (PSRAM)" : "");
+
+    return ESP_OK;
+}
+
+StagingRing* ParallelPortDmaCapture::getRing() {
+    return (m_ring.size() > 0) ? &m_ring : nullptr;
+}
+
+SlotPool* ParallelPortDmaCapture::getSlotPool() {
+    return (m_config.slotCount > 0) ? &m_slotPool : nullptr;
+}
+
+void ParallelPortDmaCapture::setBurstCallback(Transport::BurstCallback callback) {
+    m_burstCallback = callback;
+}
+
+void ParallelPortDmaCapture::setChunkCallback(Transport::ChunkCallback callback) {
+    m_chunkCallback = callback;
+}
+
+esp_err_t ParallelPortDmaCapture::getStats(Transport::Stats* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    m_stats.ringSize = m_ring.size();
+    m_stats.ringHighWater = m_ring.highWater();
+    *stats = m_stats;
+    return ESP_OK;
+}
+
+void ParallelPortDmaCapture::resetStats() {
+    m_stats.totalBytesReceived = 0;
+    m_stats.bytesInCurrentBurst = 0;
+    m_stats.burstCount = 0;
+    m_stats.overflowCount = 0;
+    m_stats.burstActive = false;
+    m_ring.resetHighWater();
+}
+
+esp_err_t ParallelPortDmaCapture::deinit() {
+    if (m_initialized) {
+        stopI2s();
+
+        if (m_taskHandle) {
+            vTaskDelete(m_taskHandle);
+            m_taskHandle = nullptr;
+        }
+
+        releaseResources();
+
+        m_initialized = false;
+        ESP_LOGI(TAG, "Deinitialized");
+    }
+    return ESP_OK;
+}
+
+// --- Hardware setup ---
+
+esp_err_t ParallelPortDmaCapture::initPulseCounter() {
+    pcnt_unit_config_t unitConfig = {};
+    unitConfig.low_limit = -1;
+    unitConfig.high_limit = 32767;
+    unitConfig.flags.accum_count = 1; // Keep counting past the 16-bit hardware limit
+
+    esp_err_t ret = pcnt_new_unit(&unitConfig, &m_pcntUnit);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PCNT unit: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (m_config.glitchFilterNs > 0) {
+        pcnt_glitch_filter_config_t filterConfig = {};
+        filterConfig.max_glitch_ns = m_config.glitchFilterNs;
+        ret = pcnt_unit_set_glitch_filter(m_pcntUnit, &filterConfig);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Glitch filter not applied: %s", esp_err_to_name(ret));
+        }
+    }
+
+    pcnt_chan_config_t chanConfig = {};
+    chanConfig.edge_gpio_num = m_config.strobePin;
+    chanConfig.level_gpio_num = -1;
+
+    ret = pcnt_new_channel(m_pcntUnit, &chanConfig, &m_pcntChannel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PCNT channel: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Count the same edge the I2S peripheral samples on
+    if (m_config.strobeActiveHigh) {
+        pcnt_channel_set_edge_action(m_pcntChannel, PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+                                     PCNT_CHANNEL_EDGE_ACTION_HOLD);
+    } else {
+        pcnt_channel_set_edge_action(m_pcntChannel, PCNT_CHANNEL_EDGE_ACTION_HOLD,
+                                     PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    }
+
+    ret = pcnt_unit_add_watch_point(m_pcntUnit, unitConfig.high_limit);
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_enable(m_pcntUnit);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_clear_count(m_pcntUnit);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure PCNT: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t ParallelPortDmaCapture::initDma() {
+    m_dmaBuffer = static_cast<uint8_t*>(
+        heap_caps_malloc(m_blockCount * DMA_BLOCK_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+    lldesc_t* desc = static_cast<lldesc_t*>(
+        heap_caps_calloc(m_blockCount, sizeof(lldesc_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+    m_descriptors = desc;
+
+    if (!m_dmaBuffer || !desc) {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes of DMA memory", m_blockCount * DMA_BLOCK_BYTES);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Circular descriptor chain, one block per descriptor
+    for (size_t i = 0; i < m_blockCount; i++) {
+        desc[i].size = DMA_BLOCK_BYTES;
+        desc[i].length = DMA_BLOCK_BYTES;
+        desc[i].offset = 0;
+        desc[i].sosf = 0;
+        desc[i].eof = 0;
+        desc[i].owner = 1;
+        desc[i].buf = m_dmaBuffer + i * DMA_BLOCK_BYTES;
+        desc[i].qe.stqe_next = &desc[(i + 1) % m_blockCount];
+    }
+    return ESP_OK;
+}
+
+void ParallelPortDmaCapture::initI2s() {
+    periph_module_enable(PERIPH_I2S0_MODULE);
+    m_i2sEnabled = true;
+
+    I2S0.conf.rx_reset = 1;
+    I2S0.conf.rx_reset = 0;
+    I2S0.conf.rx_fifo_reset = 1;
+    I2S0.conf.rx_fifo_reset = 0;
+    I2S0.lc_conf.in_rst = 1;
+    I2S0.lc_conf.in_rst = 0;
+    I2S0.lc_conf.ahbm_fifo_rst = 1;
+    I2S0.lc_conf.ahbm_fifo_rst = 0;
+    I2S0.lc_conf.ahbm_rst = 1;
+    I2S0.lc_conf.ahbm_rst = 0;
+
+    // Slave receiver clocked by the strobe (WS input)
+    I2S0.conf.rx_slave_mod = 1;
+    I2S0.conf.rx_right_first = 0;
+    I2S0.conf.rx_msb_right = 0;
+    I2S0.conf.rx_msb_shift = 0;
+    I2S0.conf.rx_mono = 0;
+    I2S0.conf.rx_short_sync = 0;
+
+    // Parallel camera input mode
+    I2S0.conf2.lcd_en = 1;
+    I2S0.conf2.camera_en = 1;
+
+    I2S0.clkm_conf.clkm_div_a = 0;
+    I2S0.clkm_conf.clkm_div_b = 0;
+    I2S0.clkm_conf.clkm_div_num = 2;
+
+    I2S0.fifo_conf.dscr_en = 1;
+    I2S0.fifo_conf.rx_fifo_mod = I2S_RX_FIFO_MODE_ONE_PER_WORD;
+    I2S0.fifo_conf.rx_fifo_mod_force_en = 1;
+
+    I2S0.conf_chan.rx_chan_mod = 1;
+    I2S0.sample_rate_conf.rx_bits_mod = 0;
+    I2S0.timing.val = 0;
+    I2S0.timing.rx_dsync_sw = 1;
+
+    // Single-word AHB transfers: samples land in RAM as soon as they are latched
+    I2S0.lc_conf.indscr_burst_en = 0;
+    I2S0.lc_conf.check_owner = 0;
+
+    // One end-of-frame interrupt per DMA block
+    I2S0.rx_eof_num = SAMPLES_PER_BLOCK;
+    I2S0.int_ena.val = 0;
+    I2S0.int_clr.val = ~0u;
+}
+
+void ParallelPortDmaCapture::startI2s() {
+    I2S0.int_clr.val = ~0u;
+    I2S0.int_ena.in_suc_eof = 1;
+    I2S0.in_link.addr = reinterpret_cast<uint32_t>(m_descriptors) & 0xfffff;
+
+    // Counter and sampler must start on the same edge so that strobe count N
+    // always maps to DMA sample N
+    portDISABLE_INTERRUPTS();
+    pcnt_unit_start(m_pcntUnit);
+    I2S0.in_link.start = 1;
+    I2S0.conf.rx_start = 1;
+    portENABLE_INTERRUPTS();
+}
+
+void ParallelPortDmaCapture::stopI2s() {
+    I2S0.conf.rx_start = 0;
+    I2S0.in_link.stop = 1;
+    I2S0.int_ena.val = 0;
+    I2S0.int_clr.val = ~0u;
+    if (m_pcntUnit) {
+        pcnt_unit_stop(m_pcntUnit);
+    }
+}
+
+void ParallelPortDmaCapture::releaseResources() {
+    if (m_intrHandle) {
+        esp_intr_free(m_intrHandle);
+        m_intrHandle = nullptr;
+    }
+
+    m_ring.deinit();
+
+    m_currentSlot = nullptr;
+    m_slotPool.deinit();
+
+    if (m_pcntChannel) {
+        pcnt_del_channel(m_pcntChannel);
+        m_pcntChannel = nullptr;
+    }
+
+    if (m_pcntUnit) {
+        pcnt_unit_disable(m_pcntUnit);
+        pcnt_del_unit(m_pcntUnit);
+        m_pcntUnit = nullptr;
+    }
+
+    if (m_descriptors) {
+        heap_caps_free(m_descriptors);
+        m_descriptors = nullptr;
+    }
+
+    if (m_dmaBuffer) {
+        heap_caps_free(m_dmaBuffer);
+        m_dmaBuffer = nullptr;
+    }
+
+    if (m_i2sEnabled) {
+        periph_module_disable(PERIPH_I2S0_MODULE);
+        m_i2sEnabled = false;
+    }
+}
+
+// --- ISR Handler ---
+
+void IRAM_ATTR ParallelPortDmaCapture::dmaISR(void* arg) {
+    ParallelPortDmaCapture* instance = static_cast<ParallelPortDmaCapture*>(arg);
+    uint32_t status = I2S0.int_st.val;
+    I2S0.int_clr.val = status;
+
+    if (!instance || !instance->m_taskHandle || !(status & I2S_IN_SUC_EOF_INT_ST_M)) {
+        return;
+    }
+
+    // One wake-up per completed DMA block
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(instance->m_taskHandle, &xHigherPriorityTaskWoken);
+
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// --- Task Implementation ---
+
+void ParallelPortDmaCapture::commitSlot() {
+    if (m_currentSlot && m_currentSlot->len > 0) {
+        m_slotPool.commit(m_currentSlot);
+        m_currentSlot = nullptr;
+    }
+}
+
+uint32_t ParallelPortDmaCapture::readStrobeCount() const {
+    int count = 0;
+    pcnt_unit_get_count(m_pcntUnit, &count);
+    return static_cast<uint32_t>(count);
+}
+
+size_t ParallelPortDmaCapture::drainSamples(uint32_t upTo, int64_t capturedUs,
+                                            uint8_t* staging) {
+    const size_t capacity = m_blockCount * SAMPLES_PER_BLOCK;
+    uint32_t pending = upTo - m_samplesConsumed;
+
+    // DMA lapped the reader: the oldest block is being overwritten, skip it
+    if (pending > capacity - SAMPLES_PER_BLOCK) {
+        uint32_t lost = pending - (capacity - SAMPLES_PER_BLOCK);
+        m_stats.overflowCount++;
+        ESP_LOGW(TAG, "DMA overrun! Lost %lu bytes", lost);
+        m_ringPos = (m_ringPos + lost) % capacity;
+        m_samplesConsumed += lost;
+        pending -= lost;
+    }
+
+    // The newest sample had been latched when the counter was read
+    if (m_chunkCallback && pending > 0) {
+        m_chunkCallback(m_streamOffset + pending - 1, capturedUs);
+    }
+
+    size_t pushed = 0;
+    while (pending > 0) {
+        size_t count = pending;
+        if (count > capacity - m_ringPos) {
+            count = capacity - m_ringPos;
+        }
+
+        uint8_t* dst = staging;
+        if (m_config.slotCount > 0) {
+            if (!m_currentSlot) {
+                m_currentSlot = m_slotPool.acquire(0);
+                if (!m_currentSlot) {
+                    // Writer is behind: samples wait in DMA memory
+                    break;
+                }
+            }
+            if (count > SlotPool::SLOT_SIZE - m_currentSlot->len) {
+                count = SlotPool::SLOT_SIZE - m_currentSlot->len;
+            }
+            dst = m_currentSlot->data + m_currentSlot->len;
+        } else if (count > STAGING_SIZE) {
+            count = STAGING_SIZE;
+        }
+
+        // Compact one byte out of every DMA word
+        const uint8_t* src = m_dmaBuffer + m_ringPos * BYTES_PER_SAMPLE + SAMPLE_BYTE_OFFSET;
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = src[i * BYTES_PER_SAMPLE];
+        }
+
+        if (m_config.slotCount > 0) {
+            m_currentSlot->len += count;
+            m_stats.totalBytesReceived += count;
+            m_stats.bytesInCurrentBurst += count;
+            m_streamOffset += count;
+            pushed += count;
+            if (m_currentSlot->len == SlotPool::SLOT_SIZE) {
+                commitSlot();
+            }
+        } else if (!m_ring.push(staging, count)) {
+            // Send to ring buffer (non-blocking)
+            m_stats.overflowCount++;
+            ESP_LOGW(TAG, "Ring buffer overflow! Lost %u bytes", count);
+        } else {
+            m_stats.totalBytesReceived += count;
+            m_stats.bytesInCurrentBurst += count;
+            m_streamOffset += count;
+            pushed += count;
+        }
+
+        m_ringPos = (m_ringPos + count) % capacity;
+        m_samplesConsumed += count;
+        pending -= count;
+    }
+
+    if (pushed > 0) {
+        PerfCounters::recordSince(PerfCounters::Stage::CAPTURE_TO_RING, capturedUs);
+    }
+    return pushed;
+}
+
+void ParallelPortDmaCapture::captureTask(void *arg) {
+    ParallelPortDmaCapture* instance = static_cast<ParallelPortDmaCapture*>(arg);
+    if (!instance) {
+        ESP_LOGE(TAG, "Invalid instance pointer");
+        vTaskDelete(nullptr);
+        return;
+    }
+
+    uint8_t* staging = (uint8_t*)malloc(STAGING_SIZE);
+    if (!staging) {
+        ESP_LOGE(TAG, "Failed to allocate staging buffer");
+        vTaskDelete(nullptr);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Parallel DMA capture task started on Core %d", xPortGetCoreID());
+
+    // Poll a few times per burst timeout so partially filled blocks are
+    // forwarded without waiting for the DMA end-of-block interrupt
+    TickType_t pollTicks = pdMS_TO_TICKS(instance->m_config.timeoutMs / 4);
+    if (pollTicks == 0) {
+        pollTicks = 1;
+    }
+    const TickType_t burstTimeout = pdMS_TO_TICKS(instance->m_config.timeoutMs);
+    TickType_t lastActivity = xTaskGetTickCount();
+
+    while (true) {
+        // Woken by the DMA ISR on every completed block, or by the poll timeout
+        ulTaskNotifyTake(pdTRUE, pollTicks);
+
+        uint32_t strobes = instance->readStrobeCount();
+        int64_t capturedUs = esp_timer_get_time();
+        if (strobes != instance->m_samplesConsumed) {
+            // Check if burst started
+            if (!instance->m_stats.burstActive) {
+                instance->m_stats.burstActive = true;
+                instance->m_stats.bytesInCurrentBurst = 0;
+                instance->m_stats.burstCount++;
+                ESP_LOGD(TAG, "Burst %lu started", instance->m_stats.burstCount);
+            }
+
+            // Let the last counted samples leave the I2S FIFO
+            esp_rom_delay_us(DMA_SETTLE_US);
+            instance->drainSamples(strobes, capturedUs, staging);
+            lastActivity = xTaskGetTickCount();
+        } else if (instance->m_stats.burstActive &&
+                   (xTaskGetTickCount() - lastActivity) >= burstTimeout) {
+            // No strobe edges for timeoutMs, burst ended
+            instance->commitSlot();
+            instance->m_stats.burstActive = false;
+            ESP_LOGI(TAG, "Burst %lu ended: %lu bytes", instance->m_stats.burstCount,
+                     instance->m_stats.bytesInCurrentBurst);
+
+            if (instance->m_burstCallback) {
+                instance->m_burstCallback(true, instance->m_stats.bytesInCurrentBurst);
+            }
+        }
+    }
+
+    free(staging);
+}
+
+#else // !SOC_I2S_SUPPORTS_LCD_CAMERA
+
+esp_err_t ParallelPortDmaCapture::init(const void* config) {
+    (void)config;
+    ESP_LOGE(TAG, "DMA parallel capture requires the I2S camera mode (ESP32 only)");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+StagingRing* ParallelPortDmaCapture::getRing() {
+    return nullptr;
+}
+
+SlotPool* ParallelPortDmaCapture::getSlotPool() {
+    return nullptr;
+}
+
+void ParallelPortDmaCapture::setBurstCallback(Transport::BurstCallback callback) {
+    m_burstCallback = callback;
+}
+
+void ParallelPortDmaCapture::setChunkCallback(Transport::ChunkCallback callback) {
+    m_chunkCallback = callback;
+}
+
+esp_err_t ParallelPortDmaCapture::getStats(Transport::Stats* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = m_stats;
+    return ESP_OK;
+}
+
+void ParallelPortDmaCapture::resetStats() {
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+esp_err_t ParallelPortDmaCapture::deinit() {
+    return ESP_OK;
+}
+
+#endif // SOC_I2S_SUPPORTS_LCD_CAMERA
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../IDataSource.h"
+#include "../SlotPool.h"
+#include "../StagingRing.h"
+#include "../TransportTypes.h"
+#include "driver/pulse_cnt.h"
+#include "esp_err.h"
+#include "esp_intr_alloc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief ParallelPortDmaCapture - DMA-backed 8-bit parallel port transport
+ *
+ * Same wiring and IDataSource contract as ParallelPortCapture, but the data
+ * bus is sampled by hardware instead of one GPIO interrupt per byte:
+ *
+ * - I2S0 runs in camera (parallel input) mode with the strobe routed to its
+ *   sample clock, so every active strobe edge latches D0-D7 into RAM via a
+ *   circular DMA descriptor chain.
+ * - A PCNT unit counts the same strobe edges, which tells the capture task
+ *   exactly how many samples are valid inside a partially filled block.
+ * - The ISR only fires once per DMA block (in_suc_eof) and notifies the
+ *   capture task; bytes are compacted and pushed to the ring buffer in bulk,
+ *   or straight into SlotPool pages when slotCount > 0 (zero-copy mode).
+ *
+ * Each drain is timestamped once (esp_timer µs, right after the strobe
+ * counter is read) and reported through the ChunkCallback, so capture
+ * times cost one timer read per DMA block or poll, not one per byte.
+ *
+ * Burst end is detected when the strobe counter stops moving for timeoutMs.
+ * Only available on targets with an I2S camera mode (ESP32); init() returns
+ * ESP_ERR_NOT_SUPPORTED elsewhere.
+ */
+class ParallelPortDmaCapture : public IDataSource {
+public:
+    /// Configuration structure
+    struct Config {
+        int dataPins[8];              ///< GPIO pins for data bits D0-D7
+        int strobePin;                ///< GPIO pin for strobe signal (active edge)
+        bool strobeActiveHigh = true; ///< true = rising edge, false = falling edge
+        size_t ringBufSize = 32 * 1024; ///< Ring buffer size for processing
+        size_t psramRingSize = 0;       ///< Ring buffer in PSRAM instead (0 = internal ringBufSize)
+        size_t dmaBufferSize = 32 * 1024; ///< Total DMA buffer (4 bytes per sample)
+        uint32_t glitchFilterNs = 100; ///< Strobe glitch filter (0 = disabled)
+        uint32_t timeoutMs = 100;    ///< Burst end detection timeout
+        size_t slotCount = 0;        ///< Zero-copy page slots (0 = ring buffer mode)
+    };
+
+    // IDataSource interface implementation
+    esp_err_t init(const void* config) override;
+    StagingRing* getRing() override;
+    SlotPool* getSlotPool() override;
+    void setBurstCallback(Transport::BurstCallback callback) override;
+    void setChunkCallback(Transport::ChunkCallback callback) override;
+    esp_err_t getStats(Transport::Stats* stats) override;
+    void resetStats() override;
+    esp_err_t deinit() override;
+    Transport::Type getType() const override { return Transport::Type::PARALLEL_PORT; }
+
+private:
+    /// Maximum DMA descriptor payload, rounded down to whole samples
+    static constexpr size_t DMA_BLOCK_BYTES = 4092;
+    /// Each sample occupies one 32-bit word in camera sampling mode 3
+    static constexpr size_t BYTES_PER_SAMPLE = 4;
+    static constexpr size_t SAMPLES_PER_BLOCK = DMA_BLOCK_BYTES / BYTES_PER_SAMPLE;
+    /// Compaction buffer used for bulk ring buffer sends
+    static constexpr size_t STAGING_SIZE = 1024;
+
+    Config m_config;
+    StagingRing m_ring;
+    TaskHandle_t m_taskHandle = nullptr;
+    Transport::BurstCallback m_burstCallback = nullptr;
+    Transport::ChunkCallback m_chunkCallback = nullptr;
+    bool m_initialized = false;
+    Transport::Stats m_stats = {};
+
+    void* m_descriptors = nullptr;     // lldesc_t[m_blockCount], DMA capable
+    uint8_t* m_dmaBuffer = nullptr;    // m_blockCount * DMA_BLOCK_BYTES, DMA capable
+    size_t m_blockCount = 0;
+    intr_handle_t m_intrHandle = nullptr;
+    bool m_i2sEnabled = false;
+    pcnt_unit_handle_t m_pcntUnit = nullptr;
+    pcnt_channel_handle_t m_pcntChannel = nullptr;
+    uint32_t m_samplesConsumed = 0;    // Strobe count already pushed to the ring buffer
+    size_t m_ringPos = 0;              // Sample index inside the DMA buffer
+    uint32_t m_streamOffset = 0;       // Bytes handed downstream since init
+    SlotPool m_slotPool;
+    SlotPool::Slot* m_currentSlot = nullptr; // Slot being filled (zero-copy mode)
+
+    esp_err_t initPulseCounter();
+    esp_err_t initDma();
+    void initI2s();
+    void startI2s();
+    void stopI2s();
+    void releaseResources();
+
+    // Hand the partially filled slot to the writer (zero-copy mode)
+    void commitSlot();
+
+    /**
+     * @brief Move samples up to strobe count @p upTo out of DMA memory
+     *
+     * Samples go to the ring buffer, or into slots in zero-copy mode. When
+     * no slot is free the remaining samples stay in DMA memory for the next call.
+     *
+     * @param upTo Strobe counter value to drain up to
+     * @param capturedUs Time the strobe counter read @p upTo (esp_timer µs)
+     * @param staging Compaction buffer of STAGING_SIZE bytes (ring buffer mode)
+     * @return Number of bytes handed downstream
+     */
+    size_t drainSamples(uint32_t upTo, int64_t capturedUs, uint8_t* staging);
+
+    uint32_t readStrobeCount() const;
+
+    // DMA end-of-block interrupt
+    static void IRAM_ATTR dmaISR(void* arg);
+
+    // Task that compacts DMA blocks into the ring buffer
+    static void captureTask(void *arg);
+};
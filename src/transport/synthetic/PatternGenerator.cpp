@@ -0,0 +1,240 @@
+#include "PatternGenerator.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <algorithm>
+#include <cstring>
+
+static const char *TAG = "PatternGen";
+
+esp_err_t PatternGenerator::init(const void* config) {
+    if (m_initialized) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_OK;
+    }
+
+    if (!config) {
+        ESP_LOGE(TAG, "Config is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_config = *static_cast<const Config*>(config);
+    if (m_config.chunkSize == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_streamOffset = 0;
+    m_prbsState = 1;
+    m_bytesGenerated = 0;
+    m_bytesDropped = 0;
+    m_running = false;
+
+    if (m_ring.init(m_config.ringBufSize, m_config.psramRingSize) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create ring buffer");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Same core and priority as the capture tasks it stands in for
+    BaseType_t ret =
+        xTaskCreatePinnedToCore(generatorTask, "pattern_gen",
+                                3072, // Stack size
+                                this, // Pass instance pointer
+                                configMAX_PRIORITIES - 1, // High priority
+                                &m_taskHandle,
+                                0 // Core 0
+        );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create generator task");
+        m_ring.deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    m_initialized = true;
+    ESP_LOGI(TAG, "Initialized: %lu B/s, burst %u B, gap %lu ms, %s",
+             m_config.rateBps, (unsigned)m_config.burstBytes, m_config.gapMs,
+             m_config.pattern == Pattern::PRBS ? "prbs" : "counter");
+    return ESP_OK;
+}
+
+StagingRing* PatternGenerator::getRing() {
+    return (m_ring.size() > 0) ? &m_ring : nullptr;
+}
+
+void PatternGenerator::setBurstCallback(Transport::BurstCallback callback) {
+    m_burstCallback = callback;
+}
+
+void PatternGenerator::setChunkCallback(Transport::ChunkCallback callback) {
+    m_chunkCallback = callback;
+}
+
+esp_err_t PatternGenerator::getStats(Transport::Stats* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    m_stats.ringSize = m_ring.size();
+    m_stats.ringHighWater = m_ring.highWater();
+    *stats = m_stats;
+    return ESP_OK;
+}
+
+void PatternGenerator::resetStats() {
+    m_stats.totalBytesReceived = 0;
+    m_stats.burstCount = 0;
+    m_stats.overflowCount = 0;
+    m_bytesGenerated = 0;
+    m_bytesDropped = 0;
+    m_ring.resetHighWater();
+}
+
+esp_err_t PatternGenerator::start() {
+    if (!m_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    m_running = true;
+    xTaskNotifyGive(m_taskHandle);
+    return ESP_OK;
+}
+
+esp_err_t PatternGenerator::stop() {
+    if (!m_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    m_running = false;
+    xTaskNotifyGive(m_taskHandle);
+
+    // The task closes the open burst within one tick
+    while (m_stats.burstActive) {
+        vTaskDelay(1);
+    }
+    return ESP_OK;
+}
+
+esp_err_t PatternGenerator::deinit() {
+    if (m_initialized) {
+        stop();
+        if (m_taskHandle) {
+            vTaskDelete(m_taskHandle);
+            m_taskHandle = nullptr;
+        }
+        m_ring.deinit();
+        m_initialized = false;
+        ESP_LOGI(TAG, "Deinitialized");
+    }
+    return ESP_OK;
+}
+
+// --- Task implementation ---
+
+void PatternGenerator::fill(uint8_t* dst, size_t len) {
+    if (m_config.pattern == Pattern::COUNTER) {
+        uint32_t offset = m_streamOffset;
+        for (size_t i = 0; i < len; i++) {
+            dst[i] = (uint8_t)(offset + i);
+        }
+        return;
+    }
+
+    uint32_t x = m_prbsState;
+    for (size_t i = 0; i < len; i += sizeof(x)) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        memcpy(dst + i, &x, std::min(sizeof(x), len - i));
+    }
+    m_prbsState = x;
+}
+
+size_t PatternGenerator::produceChunk(size_t len) {
+    uint8_t* dst = nullptr;
+    size_t space = m_ring.reserve(&dst);
+    if (space == 0) {
+        if (m_config.rateBps == 0) {
+            return 0; // Unthrottled: wait for the writer instead of dropping
+        }
+        m_stats.overflowCount++;
+        m_bytesDropped += len;
+        m_bytesGenerated += len;
+        return len;
+    }
+
+    // A chunk that reaches the end of the ring is split at the wrap
+    size_t n = std::min(len, space);
+    fill(dst, n);
+    if (m_chunkCallback) {
+        m_chunkCallback(m_streamOffset + n - 1, esp_timer_get_time());
+    }
+    m_ring.commit(n);
+
+    m_streamOffset += n;
+    m_stats.totalBytesReceived += n;
+    m_stats.bytesInCurrentBurst += n;
+    m_bytesGenerated += n;
+    return n;
+}
+
+void PatternGenerator::endBurst() {
+    ESP_LOGD(TAG, "Burst %lu ended: %u bytes", m_stats.burstCount,
+             (unsigned)m_stats.bytesInCurrentBurst);
+
+    if (m_burstCallback) {
+        m_burstCallback(true, m_stats.bytesInCurrentBurst);
+    }
+    // Cleared last: stop() returns once the burst end has been reported
+    m_stats.burstActive = false;
+}
+
+void PatternGenerator::generatorTask(void* arg) {
+    PatternGenerator* self = static_cast<PatternGenerator*>(arg);
+    const Config& config = self->m_config;
+
+    while (true) {
+        if (!self->m_running) {
+            if (self->m_stats.burstActive) {
+                self->endBurst();
+            }
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        if (!self->m_stats.burstActive) {
+            self->m_stats.burstActive = true;
+            self->m_stats.bytesInCurrentBurst = 0;
+            self->m_stats.burstCount++;
+            self->m_burstStartUs = esp_timer_get_time();
+            self->m_burstProduced = 0;
+        }
+
+        // Bytes this burst may have produced by now
+        size_t budget = config.chunkSize;
+        if (config.rateBps > 0) {
+            uint64_t elapsedUs = esp_timer_get_time() - self->m_burstStartUs;
+            uint64_t allowed = elapsedUs * config.rateBps / 1000000;
+            if (allowed <= self->m_burstProduced) {
+                vTaskDelay(1);
+                continue;
+            }
+            budget = std::min<uint64_t>(budget, allowed - self->m_burstProduced);
+        }
+        if (config.burstBytes > 0) {
+            budget = std::min<uint64_t>(budget,
+                                        config.burstBytes - self->m_burstProduced);
+        }
+
+        size_t produced = self->produceChunk(budget);
+        if (produced == 0) {
+            vTaskDelay(1); // Ring full (unthrottled)
+            continue;
+        }
+        self->m_burstProduced += produced;
+
+        if (config.burstBytes > 0 && self->m_burstProduced >= config.burstBytes) {
+            self->endBurst();
+            if (config.gapMs > 0) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config.gapMs));
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../IDataSource.h"
+#include "../StagingRing.h"
+#include "../TransportTypes.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief PatternGenerator - Synthetic transport for throughput benchmarks
+ *
+ * Feeds DataPipeline like a capture transport, without any hardware, so
+ * the writer and FlashRing can be driven at a known rate and the numbers
+ * compared between builds and boards.
+ *
+ * Features:
+ * - Pinned to Core 0 at capture priority, like the real transports
+ * - Paced to a target rate (token bucket on esp_timer), or unthrottled:
+ *   as fast as the writer frees ring space
+ * - Burst shape: burstBytes per burst, gapMs idle between bursts, with the
+ *   usual burst-end and chunk-time callbacks
+ * - Counter pattern (compressible) or PRBS (incompressible)
+ *
+ * Paced chunks that do not fit in the ring are dropped and counted, just
+ * like a transport overflow. Generation only runs between start() and
+ * stop().
+ */
+class PatternGenerator : public IDataSource {
+public:
+    /// Byte pattern
+    enum class Pattern : uint8_t {
+        COUNTER,    ///< Incrementing stream offset (byte-wise)
+        PRBS        ///< xorshift32 pseudo-random bytes
+    };
+
+    /// Configuration structure
+    struct Config {
+        uint32_t rateBps = 1024 * 1024; ///< Target rate in bytes/s within a burst (0 = unthrottled)
+        size_t burstBytes = 0;          ///< Bytes per burst (0 = one continuous burst)
+        uint32_t gapMs = 0;             ///< Idle time between bursts
+        Pattern pattern = Pattern::COUNTER;
+        size_t chunkSize = 512;         ///< Bytes per generated chunk (one time mark each)
+        size_t ringBufSize = 32 * 1024; ///< Ring buffer size
+        size_t psramRingSize = 0;       ///< Ring buffer in PSRAM instead (0 = internal ringBufSize)
+    };
+
+    // IDataSource interface implementation
+    esp_err_t init(const void* config) override;
+    StagingRing* getRing() override;
+    void setBurstCallback(Transport::BurstCallback callback) override;
+    void setChunkCallback(Transport::ChunkCallback callback) override;
+    esp_err_t getStats(Transport::Stats* stats) override;
+    void resetStats() override;
+    esp_err_t deinit() override;
+    Transport::Type getType() const override { return Transport::Type::SYNTHETIC; }
+
+    /**
+     * @brief Start generating (restarts the pacing clock)
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Stop generating; an open burst is ended and reported
+     */
+    esp_err_t stop();
+
+    /// Bytes generated, including dropped ones
+    uint64_t bytesGenerated() const { return m_bytesGenerated; }
+
+    /// Bytes dropped because the ring was full
+    uint64_t bytesDropped() const { return m_bytesDropped; }
+
+private:
+    Config m_config;
+    StagingRing m_ring;
+    TaskHandle_t m_taskHandle = nullptr;
+    Transport::BurstCallback m_burstCallback = nullptr;
+    Transport::ChunkCallback m_chunkCallback = nullptr;
+    uint32_t m_streamOffset = 0;  // Bytes handed downstream since init
+    uint32_t m_prbsState = 1;
+    bool m_initialized = false;
+    volatile bool m_running = false;
+    Transport::Stats m_stats = {};
+    uint64_t m_bytesGenerated = 0;
+    uint64_t m_bytesDropped = 0;
+
+    // Pacing state (generator task)
+    int64_t m_burstStartUs = 0;
+    uint64_t m_burstProduced = 0;  // Bytes produced since m_burstStartUs
+
+    void fill(uint8_t* dst, size_t len);
+
+    // Produce one chunk of up to @p len bytes; returns the bytes consumed
+    // from the budget (0 if an unthrottled generator found the ring full)
+    size_t produceChunk(size_t len);
+
+    void endBurst();
+
+    static void generatorTask(void* arg);
+};
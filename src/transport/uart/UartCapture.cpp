@@ -1,11 +1,53 @@
 #include "UartCapture.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "hal/uart_ll.h"
+#include "../../utils/DeferredLog.h"
+#include "../../utils/MemoryPlan.h"
+#include <algorithm>
 #include <cstring>
 
 static const char *TAG = "UartCapture";
 
+// Maximum baud periods between the delimiter characters
+static constexpr int PATTERN_CHR_TOUT = 9;
+
+// Delimiter positions the driver keeps for unread data
+static constexpr int PATTERN_QUEUE_SIZE = 16;
+
+// Auto-baud: RX edges needed before a window's pulse widths are trusted
+static constexpr uint32_t AUTOBAUD_MIN_EDGES = 64;
+
+// Auto-baud: measurement window, also the task wake-up period while unlocked
+static constexpr uint32_t AUTOBAUD_WINDOW_MS = 50;
+
+// Auto-baud: max deviation (percent) between the estimate and a standard rate
+static constexpr uint32_t AUTOBAUD_TOLERANCE_PCT = 5;
+
+// Auto-baud: consecutive off-rate windows before relocking
+static constexpr uint8_t AUTOBAUD_RELOCK_WINDOWS = 2;
+
+// Auto-baud: framing/parity errors in one window that drop the lock
+static constexpr uint32_t AUTOBAUD_MAX_FRAME_ERRORS = 8;
+
+static const uint32_t STANDARD_BAUD_RATES[] = {
+    1200,   2400,   4800,   9600,   14400,  19200,  38400,   57600,
+    115200, 230400, 250000, 460800, 500000, 921600, 1000000, 2000000,
+};
+
+// Closest standard rate within tolerance, 0 if none (noise or glitches)
+static uint32_t snapBaudRate(uint32_t estimate) {
+    for (uint32_t rate : STANDARD_BAUD_RATES) {
+        uint32_t diff = (estimate > rate) ? estimate - rate : rate - estimate;
+        if (diff * 100 <= rate * AUTOBAUD_TOLERANCE_PCT) {
+            return rate;
+        }
+    }
+    return 0;
+}
+
 esp_err_t UartCapture::init(const void* config) {
     if (m_initialized) {
         ESP_LOGW(TAG, "Already initialized");
@@ -19,6 +61,7 @@ esp_err_t UartCapture::init(const void* config) {
 
     m_config = *static_cast<const Config*>(config);
     memset(&m_stats, 0, sizeof(m_stats));
+    m_streamOffset = 0;
 
     // Configure UART
     uart_config_t uart_config = {
@@ -61,52 +104,107 @@ esp_err_t UartCapture::init(const void* config) {
         return ret;
     }
 
-    // Create ring buffer for inter-task communication
-    m_ringBuf = xRingbufferCreate(m_config.ringBufSize, RINGBUF_TYPE_BYTEBUF);
-    if (!m_ringBuf) {
-        ESP_LOGE(TAG, "Failed to create ring buffer");
-        uart_driver_delete(m_config.uartPort);
-        return ESP_ERR_NO_MEM;
+    // Hardware burst end: the driver reports RX idle through timeout_flag
+    if (m_config.idleSymbols > 0) {
+        ret = uart_set_rx_timeout(m_config.uartPort, m_config.idleSymbols);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "uart_set_rx_timeout(%u) failed: %s", m_config.idleSymbols,
+                     esp_err_to_name(ret));
+            uart_driver_delete(m_config.uartPort);
+            return ret;
+        }
+    }
+
+    // Hardware record delimiter
+    if (m_config.patternChar >= 0) {
+        ret = uart_enable_pattern_det_baud_intr(m_config.uartPort, (char)m_config.patternChar,
+                                                m_config.patternCount, PATTERN_CHR_TOUT,
+                                                0, 0);
+        if (ret == ESP_OK) {
+            ret = uart_pattern_queue_reset(m_config.uartPort, PATTERN_QUEUE_SIZE);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Pattern detection setup failed: %s", esp_err_to_name(ret));
+            uart_driver_delete(m_config.uartPort);
+            return ret;
+        }
+    }
+
+    if (m_config.slotCount > 0) {
+        // Zero-copy mode: the writer consumes page slots instead of a ring buffer
+        ret = m_slotPool.init(m_config.slotCount);
+        if (ret != ESP_OK) {
+            uart_driver_delete(m_config.uartPort);
+            return ret;
+        }
+    } else {
+        // Create ring buffer for inter-task communication
+        if (m_ring.init(m_config.ringBufSize, m_config.psramRingSize,
+                        true) != ESP_OK) {
+            uart_driver_delete(m_config.uartPort);
+            return ESP_ERR_NO_MEM;
+        }
     }
 
     // Create capture task pinned to Core 0
     // Pass 'this' pointer to task
-    BaseType_t taskRet =
-        xTaskCreatePinnedToCore(uartTask, "uart_capture",
-                                4096, // Stack size
-                                this, // Pass instance pointer
-                                configMAX_PRIORITIES - 1, // High priority
-                                &m_taskHandle,
-                                0 // Core 0
-        );
+    BaseType_t taskRet = MemoryPlan::createTask(
+        MemoryPlan::Region::TASK_CAPTURE, uartTask, "uart_capture",
+        4096, // Stack size
+        this, // Pass instance pointer
+        configMAX_PRIORITIES - 1, // High priority
+        &m_taskHandle,
+        0 // Core 0
+    );
     if (taskRet != pdPASS) {
         ESP_LOGE(TAG, "Failed to create task");
-        vRingbufferDelete(m_ringBuf);
-        m_ringBuf = nullptr;
+        m_ring.deinit();
+        m_slotPool.deinit();
         uart_driver_delete(m_config.uartPort);
         return ESP_ERR_NO_MEM;
     }
 
     m_initialized = true;
-    ESP_LOGI(TAG, "Initialized: UART%d @ %lu bps, RX=%d, ringBuf=%uKB",
-             m_config.uartPort, m_config.baudRate, m_config.rxPin,
-             m_config.ringBufSize / 1024);
+    m_baudLocked = !m_config.autoBaud;
+    if (m_config.autoBaud) {
+        restartBaudWindow();
+        ESP_LOGI(TAG, "Auto-baud enabled, capture starts once the rate is locked");
+    }
+    if (m_config.slotCount > 0) {
+        ESP_LOGI(TAG, "Initialized: UART%d @ %lu bps, RX=%d, zero-copy %u slots",
+                 m_config.uartPort, m_config.baudRate, m_config.rxPin,
+                 m_config.slotCount);
+    } else {
+        ESP_LOGI(TAG, "Initialized: UART%d @ %lu bps, RX=%d, ringBuf=%uKB%s",
+                 m_config.uartPort, m_config.baudRate, m_config.rxPin,
+                 m_ring.size() / 1024, m_ring.inPsram() ? " (PSRAM)" : "");
+    }
 
     return ESP_OK;
 }
 
-RingbufHandle_t UartCapture::getRingBuffer() {
-    return m_ringBuf;
+StagingRing* UartCapture::getRing() {
+    return (m_ring.size() > 0) ? &m_ring : nullptr;
+}
+
+SlotPool* UartCapture::getSlotPool() {
+    return (m_config.slotCount > 0) ? &m_slotPool : nullptr;
 }
 
 void UartCapture::setBurstCallback(Transport::BurstCallback callback) {
     m_burstCallback = callback;
 }
 
+void UartCapture::setChunkCallback(Transport::ChunkCallback callback) {
+    m_chunkCallback = callback;
+}
+
 esp_err_t UartCapture::getStats(Transport::Stats* stats) {
     if (!stats) {
         return ESP_ERR_INVALID_ARG;
     }
+    m_stats.ringSize = m_ring.size();
+    m_stats.ringHighWater = m_ring.highWater();
     *stats = m_stats;
     return ESP_OK;
 }
@@ -117,6 +215,7 @@ void UartCapture::resetStats() {
     m_stats.burstCount = 0;
     m_stats.overflowCount = 0;
     m_stats.burstActive = false;
+    m_ring.resetHighWater();
 }
 
 esp_err_t UartCapture::setBaudRate(uint32_t baudRate) {
@@ -127,6 +226,8 @@ esp_err_t UartCapture::setBaudRate(uint32_t baudRate) {
     esp_err_t ret = uart_set_baudrate(m_config.uartPort, baudRate);
     if (ret == ESP_OK) {
         m_config.baudRate = baudRate;
+        m_config.autoBaud = false;
+        m_baudLocked = true;
         ESP_LOGI(TAG, "Baudrate changed to %lu bps", baudRate);
     } else {
         ESP_LOGE(TAG, "Failed to set baudrate: %s", esp_err_to_name(ret));
@@ -138,16 +239,38 @@ uint32_t UartCapture::getBaudRate() const {
     return m_config.baudRate;
 }
 
+esp_err_t UartCapture::setAutoBaud(bool enable) {
+    if (!m_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (enable && !m_config.autoBaud) {
+        restartBaudWindow();
+        m_baudLocked = false;
+    } else if (!enable) {
+        m_baudLocked = true;
+    }
+    m_config.autoBaud = enable;
+    ESP_LOGI(TAG, "Auto-baud %s", enable ? "enabled" : "disabled");
+    return ESP_OK;
+}
+
+bool UartCapture::isBaudLocked() const {
+    return m_baudLocked;
+}
+
+void UartCapture::setBaudCallback(BaudCallback callback) {
+    m_baudCallback = callback;
+}
+
 esp_err_t UartCapture::deinit() {
     if (m_initialized) {
         if (m_taskHandle) {
-            vTaskDelete(m_taskHandle);
+            MemoryPlan::deleteTask(MemoryPlan::Region::TASK_CAPTURE, m_taskHandle);
             m_taskHandle = nullptr;
         }
-        if (m_ringBuf) {
-            vRingbufferDelete(m_ringBuf);
-            m_ringBuf = nullptr;
-        }
+        m_ring.deinit();
+        m_currentSlot = nullptr;
+        m_slotPool.deinit();
         uart_driver_delete(m_config.uartPort);
         m_initialized = false;
         ESP_LOGI(TAG, "Deinitialized");
@@ -157,72 +280,269 @@ esp_err_t UartCapture::deinit() {
 
 // --- Task implementation ---
 
+void UartCapture::commitSlot() {
+    if (m_currentSlot && m_currentSlot->len > 0) {
+        m_slotPool.commit(m_currentSlot);
+        m_currentSlot = nullptr;
+    }
+}
+
+void UartCapture::beginBurst() {
+    m_stats.burstActive = true;
+    m_stats.bytesInCurrentBurst = 0;
+    m_stats.burstCount++;
+    ESP_LOGD(TAG, "Burst %lu started", m_stats.burstCount);
+}
+
+void UartCapture::endBurst(const char* reason) {
+    commitSlot();
+    m_stats.burstActive = false;
+    // Once per burst on the capture task: deferred (reason is a literal)
+    DLOGI(TAG, "Burst %lu ended (%s): %lu bytes", m_stats.burstCount, reason,
+          m_stats.bytesInCurrentBurst);
+
+    if (m_burstCallback) {
+        m_burstCallback(true, m_stats.bytesInCurrentBurst);
+    }
+}
+
+void UartCapture::restartBaudWindow() {
+    // Toggling the enable bit clears the edge and pulse width counters
+    uart_dev_t* hw = UART_LL_GET_HW(m_config.uartPort);
+    uart_ll_set_autobaud_en(hw, false);
+    uart_ll_set_autobaud_en(hw, true);
+    m_frameErrors = 0;
+    m_lastBaudCheckUs = esp_timer_get_time();
+}
+
+void UartCapture::lockBaudRate(uint32_t baudRate) {
+    uint32_t oldBaud = m_baudLocked ? m_config.baudRate : 0;
+    if (m_stats.burstActive) {
+        endBurst("baud change");
+    }
+
+    esp_err_t ret = uart_set_baudrate(m_config.uartPort, baudRate);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set baudrate: %s", esp_err_to_name(ret));
+        return;
+    }
+    // Bytes decoded at the old rate are noise
+    uart_flush_input(m_config.uartPort);
+    m_config.baudRate = baudRate;
+    m_baudLocked = true;
+    m_baudMismatches = 0;
+    ESP_LOGI(TAG, "Baud rate locked at %lu bps", baudRate);
+
+    if (m_baudCallback) {
+        m_baudCallback(oldBaud, baudRate);
+    }
+}
+
+void UartCapture::dropBaudLock(const char* reason) {
+    if (m_stats.burstActive) {
+        endBurst("baud lost");
+    }
+    uart_flush_input(m_config.uartPort);
+    m_baudLocked = false;
+    m_baudMismatches = 0;
+    restartBaudWindow();
+    ESP_LOGW(TAG, "Baud lock lost (%s), re-detecting", reason);
+
+    if (m_baudCallback) {
+        m_baudCallback(m_config.baudRate, 0);
+    }
+}
+
+void UartCapture::trackBaudRate() {
+    if (esp_timer_get_time() - m_lastBaudCheckUs < AUTOBAUD_WINDOW_MS * 1000) {
+        return;
+    }
+
+    uart_dev_t* hw = UART_LL_GET_HW(m_config.uartPort);
+    if (uart_ll_get_rxd_edge_cnt(hw) < AUTOBAUD_MIN_EDGES) {
+        // Too little traffic: keep accumulating into the same window
+        return;
+    }
+
+    // The shortest pulse seen is one bit time (start or stop bit at worst),
+    // counted in UART source clock cycles
+    uint32_t pulse = std::min(uart_ll_get_low_pulse_cnt(hw), uart_ll_get_high_pulse_cnt(hw));
+    uint32_t sclkHz = 0;
+    uart_get_sclk_freq(UART_SCLK_DEFAULT, &sclkHz);
+    uint32_t rate = (pulse > 0) ? snapBaudRate(sclkHz / pulse) : 0;
+    restartBaudWindow();
+
+    if (rate == 0) {
+        ESP_LOGD(TAG, "No standard rate matches pulse width %lu", pulse);
+        return;
+    }
+    if (!m_baudLocked) {
+        lockBaudRate(rate);
+    } else if (rate == m_config.baudRate) {
+        m_baudMismatches = 0;
+    } else if (++m_baudMismatches >= AUTOBAUD_RELOCK_WINDOWS) {
+        ESP_LOGW(TAG, "Line rate changed: %lu -> %lu bps", m_config.baudRate, rate);
+        lockBaudRate(rate);
+    }
+}
+
+bool UartCapture::readAvailable(uint8_t* tempBuf) {
+    if (!m_baudLocked) {
+        // Rate unknown: whatever was decoded is noise, keep it out of the ring
+        uart_flush_input(m_config.uartPort);
+        return true;
+    }
+
+    size_t bufferedLen = 0;
+    uart_get_buffered_data_len(m_config.uartPort, &bufferedLen);
+
+    // Everything the driver buffered so far had been received by now
+    if (m_chunkCallback && bufferedLen > 0) {
+        m_chunkCallback(m_streamOffset + bufferedLen - 1, esp_timer_get_time());
+    }
+
+    // Read all available data
+    while (bufferedLen > 0) {
+        if (!m_stats.burstActive) {
+            beginBurst();
+        }
+
+        // Never read past a delimiter found by the pattern detector: the
+        // record ends right after it. Positions are relative to the driver
+        // buffer and dropped by the driver once read.
+        size_t limit = bufferedLen;
+        bool delimited = false;
+        if (m_config.patternChar >= 0) {
+            int pos = uart_pattern_get_pos(m_config.uartPort);
+            if (pos >= 0 && (size_t)pos + m_config.patternCount <= bufferedLen) {
+                limit = pos + m_config.patternCount;
+                delimited = true;
+            }
+        }
+
+        int len = 0;
+
+        if (m_config.slotCount > 0) {
+            if (!m_currentSlot) {
+                m_currentSlot = m_slotPool.acquire(pdMS_TO_TICKS(10));
+                if (!m_currentSlot) {
+                    // Writer is behind: leave the bytes in the UART driver
+                    // buffer and retry on the next event or timeout
+                    ESP_LOGD(TAG, "No free slot, %u bytes left buffered", bufferedLen);
+                    return false;
+                }
+            }
+
+            // Read directly into the slot, never past its end
+            size_t space = SlotPool::SLOT_SIZE - m_currentSlot->len;
+            size_t toRead = (limit > space) ? space : limit;
+            len = uart_read_bytes(m_config.uartPort, m_currentSlot->data + m_currentSlot->len, toRead, 0);
+
+            if (len > 0) {
+                m_currentSlot->len += len;
+                m_stats.totalBytesReceived += len;
+                m_stats.bytesInCurrentBurst += len;
+                m_streamOffset += len;
+            }
+            if (m_currentSlot->len == SlotPool::SLOT_SIZE) {
+                commitSlot();
+            }
+        } else {
+            // Read straight into the ring, never past its contiguous free region
+            uint8_t* dst = nullptr;
+            size_t space = m_ring.reserve(&dst);
+            size_t toRead = (limit > READ_CHUNK) ? READ_CHUNK : limit;
+
+            if (space > 0) {
+                toRead = (toRead > space) ? space : toRead;
+                len = uart_read_bytes(m_config.uartPort, dst, toRead, 0);
+                if (len > 0) {
+                    m_ring.commit(len);
+                    m_stats.totalBytesReceived += len;
+                    m_stats.bytesInCurrentBurst += len;
+                    m_streamOffset += len;
+                }
+            } else {
+                // Ring full: keep draining the driver so it does not overflow
+                len = uart_read_bytes(m_config.uartPort, tempBuf, toRead, 0);
+                if (len > 0) {
+                    m_stats.overflowCount++;
+                    DLOGW(TAG, "Ring buffer overflow! Lost %d bytes", len);
+                }
+            }
+        }
+
+        if (delimited && len == (int)limit) {
+            endBurst("delimiter");
+        }
+
+        uart_get_buffered_data_len(m_config.uartPort, &bufferedLen);
+    }
+    return true;
+}
+
 void UartCapture::uartTask(void *arg) {
     UartCapture* instance = static_cast<UartCapture*>(arg);
     if (!instance) {
         ESP_LOGE(TAG, "Invalid instance pointer");
-        vTaskDelete(nullptr);
+        MemoryPlan::exitTask(MemoryPlan::Region::TASK_CAPTURE);
         return;
     }
 
     uart_event_t event;
-    uint8_t *tempBuf = (uint8_t *)malloc(512); // Temporary buffer for reads
-
-    if (!tempBuf) {
-        ESP_LOGE(TAG, "Failed to allocate temp buffer");
-        vTaskDelete(nullptr);
-        return;
-    }
+    uint8_t *tempBuf = instance->m_readBuf;
 
     ESP_LOGI(TAG, "UART capture task started on Core %d", xPortGetCoreID());
 
+    // With hardware idle detection the task only wakes on UART events,
+    // plus a short retry while bytes wait for a free slot. Auto-baud adds
+    // a periodic wake-up to evaluate its measurement window.
+    const bool hardwareIdle = instance->m_config.idleSymbols > 0;
+    bool lineIdle = false; // RX timeout seen, burst ends once drained
+    bool drained = true;
+
     while (true) {
+        TickType_t wait = pdMS_TO_TICKS(instance->m_config.timeoutMs);
+        if (hardwareIdle) {
+            wait = !drained                      ? pdMS_TO_TICKS(10)
+                   : instance->m_config.autoBaud ? pdMS_TO_TICKS(AUTOBAUD_WINDOW_MS)
+                                                 : portMAX_DELAY;
+        }
+        drained = true;
+
         // Wait for UART event with timeout
-        if (xQueueReceive(instance->m_uartQueue, &event, pdMS_TO_TICKS(instance->m_config.timeoutMs))) {
+        if (xQueueReceive(instance->m_uartQueue, &event, wait)) {
             switch (event.type) {
-            case UART_DATA: {
-                // Data available in UART buffer
-                size_t bufferedLen = 0;
-                uart_get_buffered_data_len(instance->m_config.uartPort, &bufferedLen);
-
-                if (!instance->m_stats.burstActive && bufferedLen > 0) {
-                    instance->m_stats.burstActive = true;
-                    instance->m_stats.bytesInCurrentBurst = 0;
-                    instance->m_stats.burstCount++;
-                    ESP_LOGD(TAG, "Burst %lu started", instance->m_stats.burstCount);
-                }
+            case UART_DATA:
+                // Data available in UART buffer; timeout_flag reports the
+                // RX line idle for idleSymbols after the last byte
+                lineIdle = hardwareIdle && event.timeout_flag;
+                drained = instance->readAvailable(tempBuf);
+                break;
 
-                // Read all available data
-                while (bufferedLen > 0) {
-                    size_t toRead = (bufferedLen > 512) ? 512 : bufferedLen;
-                    int len = uart_read_bytes(instance->m_config.uartPort, tempBuf, toRead, 0);
-
-                    if (len > 0) {
-                        // Send to ring buffer (non-blocking)
-                        BaseType_t sent = xRingbufferSend(instance->m_ringBuf, tempBuf, len, 0);
-                        if (sent != pdTRUE) {
-                            instance->m_stats.overflowCount++;
-                            ESP_LOGW(TAG, "Ring buffer overflow! Lost %d bytes", len);
-                        } else {
-                            instance->m_stats.totalBytesReceived += len;
-                            instance->m_stats.bytesInCurrentBurst += len;
-                        }
-                    }
-
-                    uart_get_buffered_data_len(instance->m_config.uartPort, &bufferedLen);
-                }
+            case UART_PATTERN_DET:
+                // Delimiter detected, readAvailable() splits the record there
+                drained = instance->readAvailable(tempBuf);
                 break;
-            }
 
             case UART_FIFO_OVF:
-                ESP_LOGE(TAG, "UART FIFO overflow!");
+                DLOGE(TAG, "UART FIFO overflow!");
                 instance->m_stats.overflowCount++;
                 uart_flush_input(instance->m_config.uartPort);
                 xQueueReset(instance->m_uartQueue);
                 break;
 
+            case UART_FRAME_ERR:
+            case UART_PARITY_ERR:
+                // A run of these at a locked rate means the line changed
+                if (instance->m_config.autoBaud && instance->m_baudLocked &&
+                    ++instance->m_frameErrors >= AUTOBAUD_MAX_FRAME_ERRORS) {
+                    instance->dropBaudLock("framing errors");
+                }
+                break;
+
             case UART_BUFFER_FULL:
-                ESP_LOGE(TAG, "UART buffer full!");
+                DLOGE(TAG, "UART buffer full!");
                 instance->m_stats.overflowCount++;
                 uart_flush_input(instance->m_config.uartPort);
                 xQueueReset(instance->m_uartQueue);
@@ -232,26 +552,36 @@ void UartCapture::uartTask(void *arg) {
                 ESP_LOGD(TAG, "UART event type: %d", event.type);
                 break;
             }
+        } else if (hardwareIdle) {
+            // Retry bytes left behind while waiting for a free slot
+            drained = instance->readAvailable(tempBuf);
         } else {
             // Timeout - check if burst ended
             if (instance->m_stats.burstActive) {
                 size_t bufferedLen = 0;
                 uart_get_buffered_data_len(instance->m_config.uartPort, &bufferedLen);
 
-                if (bufferedLen == 0) {
+                if (bufferedLen > 0) {
+                    // Bytes left behind while waiting for a free slot
+                    instance->readAvailable(tempBuf);
+                } else {
                     // No more data, burst ended
-                    instance->m_stats.burstActive = false;
-                    ESP_LOGI(TAG, "Burst %lu ended: %lu bytes", instance->m_stats.burstCount,
-                             instance->m_stats.bytesInCurrentBurst);
+                    instance->endBurst("timeout");
+                }
+            }
+        }
 
-                    if (instance->m_burstCallback) {
-                        instance->m_burstCallback(true, instance->m_stats.bytesInCurrentBurst);
-                    }
+        if (instance->m_config.autoBaud) {
+            instance->trackBaudRate();
+        }
+
+        if (hardwareIdle) {
+            if (lineIdle && drained) {
+                lineIdle = false;
+                if (instance->m_stats.burstActive) {
+                    instance->endBurst("idle");
                 }
             }
         }
     }
-
-    free(tempBuf);
 }
-
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../IDataSource.h"
+#include "../SlotPool.h"
+#include "../StagingRing.h"
 #include "../TransportTypes.h"
 #include "driver/uart.h"
 #include "esp_err.h"
@@ -16,7 +18,16 @@
  * - Event-driven reception (no polling)
  * - Large hardware buffer to absorb bursts
  * - Pinned to Core 0 for deterministic timing
- * - Timeout detection for end-of-burst
+ * - Timeout detection for end-of-burst, in software (timeoutMs) or from the
+ *   UART RX idle timeout (idleSymbols)
+ * - Optional record delimiter found by the UART pattern detector: a record
+ *   ends right after each patternCount x patternChar sequence
+ * - Optional zero-copy mode: reads straight into page-sized SlotPool slots
+ * - One capture timestamp (esp_timer µs) per UART event
+ * - Optional auto-baud: the rate is measured from RX pulse widths with the
+ *   UART autobaud counters and snapped to a standard rate. Nothing is
+ *   captured until the rate is locked; the lock is re-checked while
+ *   capturing and dropped on a rate change or a run of framing errors.
  */
 class UartCapture : public IDataSource {
 public:
@@ -31,13 +42,28 @@ public:
         uart_stop_bits_t stopBits = UART_STOP_BITS_1;   ///< Stop bits (1, 1.5, 2)
         size_t rxBufSize = 16 * 1024;   ///< Hardware RX buffer size
         size_t ringBufSize = 32 * 1024; ///< Ring buffer size for processing
-        uint32_t timeoutMs = 100;       ///< Burst end detection timeout
+        size_t psramRingSize = 0;       ///< Ring buffer in PSRAM instead (0 = internal ringBufSize)
+        uint32_t timeoutMs = 100;       ///< Burst end detection timeout (software)
+        uint8_t idleSymbols = 0;        ///< Burst ends after this many idle symbol times on RX (0 = use timeoutMs)
+        int patternChar = -1;           ///< Record delimiter byte (-1 = none)
+        uint8_t patternCount = 1;       ///< Consecutive patternChar bytes forming the delimiter
+        size_t slotCount = 0;           ///< Zero-copy page slots (0 = ring buffer mode)
+        bool autoBaud = false;          ///< Detect the baud rate (baudRate is only the initial guess)
     };
 
+    /**
+     * @brief Called from the capture task when the locked baud rate changes
+     * @param oldBaud Previous locked rate (0 = was not locked)
+     * @param newBaud New locked rate (0 = lock lost, data is discarded)
+     */
+    using BaudCallback = void (*)(uint32_t oldBaud, uint32_t newBaud);
+
     // IDataSource interface implementation
     esp_err_t init(const void* config) override;
-    RingbufHandle_t getRingBuffer() override;
+    StagingRing* getRing() override;
+    SlotPool* getSlotPool() override;
     void setBurstCallback(Transport::BurstCallback callback) override;
+    void setChunkCallback(Transport::ChunkCallback callback) override;
     esp_err_t getStats(Transport::Stats* stats) override;
     void resetStats() override;
     esp_err_t deinit() override;
@@ -45,7 +71,7 @@ public:
 
     // UART-specific methods
     /**
-     * @brief Change baudrate at runtime
+     * @brief Change baudrate at runtime (disables auto-baud)
      * @param baudRate New baudrate
      * @return ESP_OK on success
      */
@@ -57,14 +83,68 @@ public:
      */
     uint32_t getBaudRate() const;
 
+    /**
+     * @brief Enable or disable auto-baud at runtime
+     *
+     * Enabling drops the current lock: data is discarded until a rate has
+     * been measured. Disabling keeps capturing at the current rate.
+     */
+    esp_err_t setAutoBaud(bool enable);
+
+    /**
+     * @brief Check if data is being captured at a known rate
+     * @return Always true when auto-baud is disabled
+     */
+    bool isBaudLocked() const;
+
+    void setBaudCallback(BaudCallback callback);
+
 private:
     Config m_config;
-    RingbufHandle_t m_ringBuf = nullptr;
+    StagingRing m_ring;
     TaskHandle_t m_taskHandle = nullptr;
     QueueHandle_t m_uartQueue = nullptr;
     Transport::BurstCallback m_burstCallback = nullptr;
+    Transport::ChunkCallback m_chunkCallback = nullptr;
+    uint32_t m_streamOffset = 0;  // Bytes handed downstream since init
     bool m_initialized = false;
     Transport::Stats m_stats = {};
+    SlotPool m_slotPool;
+    SlotPool::Slot* m_currentSlot = nullptr;  // Slot being filled (zero-copy mode)
+
+    // Auto-baud state (capture task)
+    BaudCallback m_baudCallback = nullptr;
+    volatile bool m_baudLocked = true;
+    uint8_t m_baudMismatches = 0;   // Consecutive estimates off the locked rate
+    uint32_t m_frameErrors = 0;     // Framing/parity errors in the current window
+    int64_t m_lastBaudCheckUs = 0;
+
+    // Capture task read buffer, part of the object (no heap at task start)
+    static constexpr size_t READ_CHUNK = 512;
+    uint8_t m_readBuf[READ_CHUNK];
+
+    // Move everything buffered by the UART driver downstream, splitting
+    // records at delimiters. Returns false if bytes were left behind.
+    bool readAvailable(uint8_t* tempBuf);
+
+    void beginBurst();
+
+    // Close the current burst and report it
+    void endBurst(const char* reason);
+
+    // Hand the partially filled slot to the writer (zero-copy mode)
+    void commitSlot();
+
+    // Restart the autobaud pulse counters for a new measurement window
+    void restartBaudWindow();
+
+    // Re-estimate the line rate, lock or relock on a change (rate-limited)
+    void trackBaudRate();
+
+    void lockBaudRate(uint32_t baudRate);
+
+    // Stop capturing until the rate has been measured again
+    void dropBaudLock(const char* reason);
 
     static void uartTask(void *arg);
 };
@@ -1,8 +1,10 @@
 #include "ButtonMonitor.h"
 #include "../config/ConfigManager.h"
+#include "Housekeeping.h"
 #include "LedManager.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -14,101 +16,113 @@ static const uint32_t HOLD_SAFE_MS = 3000;
 static const uint32_t HOLD_FACTORY_MS = 8000;
 static const uint32_t POLL_INTERVAL_MS = 100;
 
-static TaskHandle_t s_taskHandle = nullptr;
+static Housekeeping::JobId s_job = Housekeeping::INVALID_JOB;
 static bool s_running = false;
 
+// Hold state, only touched by the job
+static bool s_wasPressed = false;
+static int64_t s_pressedAtUs = 0;
+static bool s_safeThresholdReached = false;
+static bool s_factoryThresholdReached = false;
+
+// Press edge: start polling the hold time
+static void buttonIsr(void *arg) {
+  (void)arg;
+  BaseType_t woken = pdFALSE;
+  Housekeeping::notifyFromIsr(s_job, &woken);
+  if (woken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
 /**
- * @brief Button monitor task
+ * @brief Button monitor job
  *
- * Monitors GPIO 0 (BOOT button) and triggers safe mode or factory reset
+ * Woken by the press interrupt on GPIO 0 (BOOT button), then polls every
+ * POLL_INTERVAL_MS until release to trigger safe mode or factory reset.
+ * Idle (no wakeups) while the button is up.
  */
-static void buttonMonitorTask(void *pvParameters) {
-  uint32_t pressedTime = 0;
-  bool wasPressed = false;
-  bool safeThresholdReached = false;
-  bool factoryThresholdReached = false;
-
-  ESP_LOGI(TAG, "Button monitor task started");
-
-  while (s_running) {
-    // Read button state (active LOW - pressed when 0)
-    int buttonState = gpio_get_level(BOOT_BUTTON_GPIO);
-    bool isPressed = (buttonState == 0);
-
-    if (isPressed) {
-      if (!wasPressed) {
-        wasPressed = true;
-        pressedTime = 0;
-        safeThresholdReached = false;
-        factoryThresholdReached = false;
-        ESP_LOGI(TAG, "BOOT button pressed");
-        LedManager::setState(LedManager::State::HOLD_3S);
-      } else {
-        pressedTime += POLL_INTERVAL_MS;
-
-        // Stage 3: Factory Reset threshold (>8s)
-        if (pressedTime >= HOLD_FACTORY_MS && !factoryThresholdReached) {
-          ESP_LOGW(TAG,
-                   "FACTORY RESET threshold reached! Release now to reset.");
-          LedManager::setState(LedManager::State::FACTORY_READY);
-          factoryThresholdReached = true;
-        }
-        // Stage 2: Safe Mode threshold (>3s)
-        else if (pressedTime >= HOLD_SAFE_MS && !safeThresholdReached) {
-          ESP_LOGW(
-              TAG,
-              "SAFE MODE threshold reached. Keep holding for factory reset.");
-          LedManager::setState(LedManager::State::HOLD_8S);
-          safeThresholdReached = true;
-        }
-      }
-    } else {
-      // Button released
-      if (wasPressed) {
-        ESP_LOGI(TAG, "BOOT button released after %lu ms", pressedTime);
-
-        if (factoryThresholdReached) {
-          ESP_LOGE(TAG, "PERFORMING FACTORY RESET...");
-
-          // Clear safe mode flag first
-          ConfigManager::setSafeMode(false);
-
-          // Restore everything to defaults
-          if (ConfigManager::restore() == ESP_OK) {
-            ESP_LOGI(TAG, "Factory reset complete. Rebooting in 2s...");
-            vTaskDelay(pdMS_TO_TICKS(
-                2000)); // Give time for NVS and for user to release button
-            esp_restart();
-          } else {
-            ESP_LOGE(TAG, "Factory reset FAILED!");
-            LedManager::setState(LedManager::State::IDLE);
-          }
-        } else if (safeThresholdReached) {
-          ESP_LOGW(TAG, "Triggering SAFE MODE...");
-          if (ConfigManager::setSafeMode(true) == ESP_OK) {
-            ESP_LOGI(TAG, "Safe mode flag set. Rebooting in 1s...");
-            vTaskDelay(pdMS_TO_TICKS(1000));
-            esp_restart();
-          } else {
-            ESP_LOGE(TAG, "Failed to set safe mode flag");
-            LedManager::setState(LedManager::State::IDLE);
-          }
-        } else {
-          // Normal short release
-          LedManager::setState(LedManager::State::IDLE);
-        }
-
-        wasPressed = false;
-        pressedTime = 0;
-        safeThresholdReached = false;
-        factoryThresholdReached = false;
-      }
+static uint32_t buttonMonitorJob(void *ctx) {
+  (void)ctx;
+
+  // Read button state (active LOW - pressed when 0)
+  int buttonState = gpio_get_level(BOOT_BUTTON_GPIO);
+  bool isPressed = (buttonState == 0);
+
+  if (isPressed) {
+    if (!s_wasPressed) {
+      s_wasPressed = true;
+      s_pressedAtUs = esp_timer_get_time();
+      s_safeThresholdReached = false;
+      s_factoryThresholdReached = false;
+      ESP_LOGI(TAG, "BOOT button pressed");
+      LedManager::setState(LedManager::State::HOLD_3S);
+      return POLL_INTERVAL_MS;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(POLL_INTERVAL_MS));
+    uint32_t pressedTime =
+        (uint32_t)((esp_timer_get_time() - s_pressedAtUs) / 1000);
+    // Stage 3: Factory Reset threshold (>8s)
+    if (pressedTime >= HOLD_FACTORY_MS && !s_factoryThresholdReached) {
+      ESP_LOGW(TAG, "FACTORY RESET threshold reached! Release now to reset.");
+      LedManager::setState(LedManager::State::FACTORY_READY);
+      s_factoryThresholdReached = true;
+    }
+    // Stage 2: Safe Mode threshold (>3s)
+    else if (pressedTime >= HOLD_SAFE_MS && !s_safeThresholdReached) {
+      ESP_LOGW(TAG,
+               "SAFE MODE threshold reached. Keep holding for factory reset.");
+      LedManager::setState(LedManager::State::HOLD_8S);
+      s_safeThresholdReached = true;
+    }
+    return POLL_INTERVAL_MS;
+  }
+
+  if (!s_wasPressed) {
+    // Bounce, or released before the first poll
+    return Housekeeping::IDLE;
   }
 
-  vTaskDelete(nullptr);
+  // Button released
+  uint32_t pressedTime =
+      (uint32_t)((esp_timer_get_time() - s_pressedAtUs) / 1000);
+  ESP_LOGI(TAG, "BOOT button released after %lu ms", pressedTime);
+
+  if (s_factoryThresholdReached) {
+    ESP_LOGE(TAG, "PERFORMING FACTORY RESET...");
+
+    // Clear safe mode flag first
+    ConfigManager::setSafeMode(false);
+
+    // Restore everything to defaults
+    if (ConfigManager::restore() == ESP_OK) {
+      ESP_LOGI(TAG, "Factory reset complete. Rebooting in 2s...");
+      vTaskDelay(pdMS_TO_TICKS(
+          2000)); // Give time for NVS and for user to release button
+      esp_restart();
+    } else {
+      ESP_LOGE(TAG, "Factory reset FAILED!");
+      LedManager::setState(LedManager::State::IDLE);
+    }
+  } else if (s_safeThresholdReached) {
+    ESP_LOGW(TAG, "Triggering SAFE MODE...");
+    if (ConfigManager::setSafeMode(true) == ESP_OK) {
+      ESP_LOGI(TAG, "Safe mode flag set. Rebooting in 1s...");
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      esp_restart();
+    } else {
+      ESP_LOGE(TAG, "Failed to set safe mode flag");
+      LedManager::setState(LedManager::State::IDLE);
+    }
+  } else {
+    // Normal short release
+    LedManager::setState(LedManager::State::IDLE);
+  }
+
+  s_wasPressed = false;
+  s_safeThresholdReached = false;
+  s_factoryThresholdReached = false;
+  return Housekeeping::IDLE;
 }
 
 esp_err_t init() {
@@ -117,9 +131,9 @@ esp_err_t init() {
     return ESP_OK;
   }
 
-  // Configure GPIO 0 (BOOT button) as input with pull-up
+  // Configure GPIO 0 (BOOT button) as input with pull-up, interrupt on press
   gpio_config_t io_conf = {};
-  io_conf.intr_type = GPIO_INTR_DISABLE;
+  io_conf.intr_type = GPIO_INTR_NEGEDGE;
   io_conf.mode = GPIO_MODE_INPUT;
   io_conf.pin_bit_mask = (1ULL << BOOT_BUTTON_GPIO);
   io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
@@ -132,21 +146,30 @@ esp_err_t init() {
     return ret;
   }
 
-  // Create button monitor task with very low priority
-  // Increased stack size to prevent overflow when calling restore()
-  s_running = true;
-  BaseType_t taskRet = xTaskCreate(buttonMonitorTask, "button_monitor",
-                                   4096,                 // Stack size (increased from 2048)
-                                   nullptr,              // Parameters
-                                   tskIDLE_PRIORITY + 1, // Very low priority
-                                   &s_taskHandle);
-
-  if (taskRet != pdPASS) {
-    ESP_LOGE(TAG, "Failed to create button monitor task");
-    s_running = false;
-    return ESP_FAIL;
+  // Shared with the Ethernet and parallel port drivers
+  ret = gpio_install_isr_service(0);
+  if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+    ESP_LOGE(TAG, "Failed to install GPIO ISR service: %s",
+             esp_err_to_name(ret));
+    return ret;
+  }
+
+  // First run checks a button already held at boot
+  ret = Housekeeping::add("button", buttonMonitorJob, nullptr, 0, &s_job);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register button monitor job");
+    return ret;
   }
 
+  ret = gpio_isr_handler_add(BOOT_BUTTON_GPIO, buttonIsr, nullptr);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to add BOOT button ISR: %s", esp_err_to_name(ret));
+    Housekeeping::remove(s_job);
+    s_job = Housekeeping::INVALID_JOB;
+    return ret;
+  }
+  s_running = true;
+
   ESP_LOGI(
       TAG,
       "Button monitor initialized (GPIO %d, Safe: %lu ms, Factory: %lu ms)",
@@ -164,12 +187,10 @@ void deinit() {
   }
 
   s_running = false;
-
-  if (s_taskHandle != nullptr) {
-    // Task will delete itself when s_running becomes false
-    vTaskDelay(pdMS_TO_TICKS(200)); // Give task time to exit
-    s_taskHandle = nullptr;
-  }
+  gpio_isr_handler_remove(BOOT_BUTTON_GPIO);
+  gpio_set_intr_type(BOOT_BUTTON_GPIO, GPIO_INTR_DISABLE);
+  Housekeeping::remove(s_job);
+  s_job = Housekeeping::INVALID_JOB;
 
   ESP_LOGI(TAG, "Button monitor deinitialized");
 }
@@ -5,18 +5,19 @@
 namespace ButtonMonitor {
 
 /**
- * @brief Initialize the button monitor task
+ * @brief Initialize the button monitor
  *
- * Starts a low-priority FreeRTOS task that monitors the BOOT button (GPIO 0).
- * If the button is held for more than 3 seconds, it triggers safe mode on
- * release.
+ * Registers a housekeeping job that monitors the BOOT button (GPIO 0). The
+ * press interrupt wakes it; it only polls while the button is held. If the
+ * button is held for more than 3 seconds, it triggers safe mode on release
+ * (factory reset after 8 seconds).
  *
  * @return ESP_OK on success
  */
 esp_err_t init();
 
 /**
- * @brief Stop the button monitor task
+ * @brief Stop the button monitor
  */
 void deinit();
 
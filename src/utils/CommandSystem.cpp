@@ -1,11 +1,27 @@
 #include "CommandSystem.h"
 #include "config/ConfigManager.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "network/NetworkManager.h"
+#include "network/wifi/WifiInterface.h"
 #include "pipeline/DataPipeline.h"
+#include "protocol/FrameDecoders.h"
 #include "storage/FlashRing.h"
+#include "storage/OfflineQueue.h"
+#include "storage/RecordStore.h"
+#include "storage/RingSearch.h"
+#include "storage/StorageTier.h"
+#include "utils/DeferredLog.h"
+#include "utils/Housekeeping.h"
+#include "utils/JsonWriter.h"
+#include "utils/OtaUpdate.h"
+#include "utils/PerfCounters.h"
+#include "utils/TaskProfiler.h"
+#include "transport/synthetic/PatternGenerator.h"
 #include "transport/uart/UartCapture.h"
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -16,7 +32,6 @@ namespace CommandSystem {
 
 // Maximum number of registered commands
 static constexpr size_t MAX_COMMANDS = 32;
-static constexpr size_t MAX_RESPONSE_DATA = 1024;
 
 // Command registry
 static Command s_commands[MAX_COMMANDS];
@@ -35,11 +50,18 @@ static size_t s_callbackCount = 0;
 // Global data source reference
 static IDataSource *s_dataSource = nullptr;
 
-// UART CLI task
-static TaskHandle_t s_cliTaskHandle = nullptr;
+// UART CLI: a housekeeping job collects console input, each complete line
+// runs in a short-lived task of its own (commands like bench or grep take
+// seconds), one at a time
+static constexpr uint32_t CLI_POLL_MS = 50;
+static constexpr uint32_t CLI_COMMAND_STACK = 4096;
+static Housekeeping::JobId s_cliJob = Housekeeping::INVALID_JOB;
+static char s_cliInput[64];
+static size_t s_cliInputLen = 0;
+static char s_cliLine[64];
+static volatile bool s_cliBusy = false;
 
-// Static response data buffer (for commands that return data)
-static char s_responseDataBuffer[MAX_RESPONSE_DATA];
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
 
 // --- Helper Functions ---
 
@@ -56,7 +78,8 @@ static const char *mediumToString(Medium medium) {
   }
 }
 
-static void sendResponse(Medium medium, const CommandResult *result) {
+static void sendResponse(const Context *ctx, const CommandResult *result) {
+  Medium medium = ctx->medium;
   // Try to find registered callback
   for (size_t i = 0; i < s_callbackCount; i++) {
     if (s_responseCallbacks[i].medium == medium &&
@@ -69,7 +92,10 @@ static void sendResponse(Medium medium, const CommandResult *result) {
   
   // If no callback registered, default behavior based on medium
   if (medium == Medium::DEBUG) {
-    // For DEBUG/UART, print to console
+    // For DEBUG/UART, print to console (streamed output is already out)
+    if (ctx->sink && ctx->length > 0) {
+      printf("\n");
+    }
     printf("%s", result->message);
     if (result->status != ESP_OK) {
       printf(": %s", esp_err_to_name(result->status));
@@ -104,13 +130,15 @@ static const char *parseCommandName(const char *cmdStr, char *outName,
 
 // --- Command Handlers ---
 
-static esp_err_t handleFormat(const char *args, size_t argsLen,
-                              CommandResult *result) {
+static esp_err_t handleFormat(Context *ctx, const char *args,
+                              size_t argsLen, CommandResult *result) {
+  (void)ctx;
   (void)args;
   (void)argsLen;
 
   ESP_LOGI(TAG, "Erasing flash and resetting stats...");
   if (FlashRing::erase() == ESP_OK) {
+    RecordStore::reset();
     if (s_dataSource) {
       s_dataSource->resetStats();
     }
@@ -130,10 +158,28 @@ static esp_err_t handleFormat(const char *args, size_t argsLen,
   return result->status;
 }
 
-static esp_err_t handleStats(const char *args, size_t argsLen,
-                             CommandResult *result) {
-  (void)args;
-  (void)argsLen;
+static esp_err_t handleStats(Context *ctx, const char *args,
+                             size_t argsLen, CommandResult *result) {
+  // Streamed through a small staging buffer, whatever the medium
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+
+  // "stats metrics": latency histograms, throughput windows and CPU use
+  if (argsLen == 7 && strncmp(args, "metrics", 7) == 0) {
+    PerfCounters::Snapshot snap;
+    PerfCounters::snapshot(&snap);
+    json.beginObject();
+    PerfCounters::writeFields(snap, &json, true);
+    static TaskProfiler::Snapshot cpu; // Too large for the caller's stack
+    if (TaskProfiler::getSnapshot(&cpu) == ESP_OK) {
+      json.key("cpu");
+      TaskProfiler::toJson(cpu, &json);
+    }
+    json.endObject();
+    result->status = json.finish();
+    result->message = (result->status == ESP_OK) ? "METRICS_DATA" : "METRICS_FAIL";
+    return result->status;
+  }
 
   FlashRing::Stats fs;
   FlashRing::getStats(&fs);
@@ -142,43 +188,102 @@ static esp_err_t handleStats(const char *args, size_t argsLen,
   float usedPercent = fs.partitionSize > 0 
       ? (100.0f * fs.usedBytes / fs.partitionSize)
       : 0.0f;
-  snprintf(s_responseDataBuffer, MAX_RESPONSE_DATA,
-           "{\"flash\":{\"usedBytes\":%u,\"partitionSize\":%u,"
-           "\"freeBytes\":%u,\"wrapCount\":%u,\"totalWritten\":%u,"
-           "\"usedPercent\":%.1f}",
-           (unsigned int)fs.usedBytes, (unsigned int)fs.partitionSize,
-           (unsigned int)fs.freeBytes, (unsigned int)fs.wrapCount,
-           (unsigned int)fs.totalWritten, usedPercent);
+  json.beginObject();
+  json.key("flash");
+  json.beginObject();
+  json.field("usedBytes", fs.usedBytes);
+  json.field("partitionSize", fs.partitionSize);
+  json.field("freeBytes", fs.freeBytes);
+  json.field("wrapCount", fs.wrapCount);
+  json.field("totalWritten", fs.totalWritten);
+  json.field("usedPercent", usedPercent, 1);
+  json.endObject();
 
   if (s_dataSource) {
     Transport::Stats ts;
     if (s_dataSource->getStats(&ts) == ESP_OK) {
-      snprintf(s_responseDataBuffer + strlen(s_responseDataBuffer),
-               MAX_RESPONSE_DATA - strlen(s_responseDataBuffer),
-               ",\"transport\":{\"totalBytesReceived\":%zu,"
-               "\"burstCount\":%lu,\"overflowCount\":%lu,\"burstActive\":%s}",
-               ts.totalBytesReceived, (unsigned long)ts.burstCount, (unsigned long)ts.overflowCount,
-               ts.burstActive ? "true" : "false");
+      json.key("transport");
+      json.beginObject();
+      json.field("totalBytesReceived", ts.totalBytesReceived);
+      json.field("burstCount", ts.burstCount);
+      json.field("overflowCount", ts.overflowCount);
+      json.field("burstActive", ts.burstActive);
+      json.field("ringSize", ts.ringSize);
+      json.field("ringHighWater", ts.ringHighWater);
+      json.endObject();
     }
   }
 
   DataPipeline::Stats ps;
   if (DataPipeline::getStats(&ps) == ESP_OK) {
-    snprintf(s_responseDataBuffer + strlen(s_responseDataBuffer),
-             MAX_RESPONSE_DATA - strlen(s_responseDataBuffer),
-             ",\"pipeline\":{\"bytesWrittenToFlash\":%zu,"
-             "\"bytesDropped\":%zu,\"writeOperations\":%lu,"
-             "\"flushOperations\":%lu,\"running\":%s}",
-             ps.bytesWrittenToFlash, ps.bytesDropped, (unsigned long)ps.writeOperations,
-             (unsigned long)ps.flushOperations, ps.running ? "true" : "false");
+    json.key("pipeline");
+    json.beginObject();
+    json.field("bytesWrittenToFlash", ps.bytesWrittenToFlash);
+    json.field("bytesDropped", ps.bytesDropped);
+    json.field("writeOperations", ps.writeOperations);
+    json.field("flushOperations", ps.flushOperations);
+    json.field("running", ps.running);
+    json.field("ringHighWater", ps.ringHighWater);
+    json.field("firstByteMs", ps.firstByteUs / 1000); // Since boot
+    json.field("stageInBytes", ps.stageInBytes);
+    json.field("stageOutBytes", ps.stageOutBytes);
+
+    // Filter chains, with how much each stage removes
+    json.key("stages");
+    json.beginArray();
+    DataPipeline::StageStats ss;
+    for (uint32_t ch = 0; ch < ps.sources; ch++) {
+      for (size_t i = 0; DataPipeline::getStageStats(ch, i, &ss) == ESP_OK; i++) {
+        json.beginObject();
+        json.field("channel", ch);
+        json.field("name", ss.name);
+        json.field("bytesIn", ss.bytesIn);
+        json.field("bytesOut", ss.bytesOut);
+        json.field("reductionPct",
+                   ss.bytesIn > 0
+                       ? 100.0f * (ss.bytesIn - ss.bytesOut) / ss.bytesIn
+                       : 0.0f,
+                   1);
+        json.endObject();
+      }
+    }
+    json.endArray();
+    json.endObject();
   }
 
-  strcat(s_responseDataBuffer, "}");
+  StorageTier::Stats ts;
+  if (StorageTier::isRunning() && StorageTier::getStats(&ts) == ESP_OK) {
+    json.key("tier");
+    json.beginObject();
+    json.field("bytesCopied", ts.bytesCopied);
+    json.field("pending", ts.pending);
+    json.field("dropped", ts.dropped);
+    json.field("commits", ts.commits);
+    json.field("writeErrors", ts.writeErrors);
+    json.endObject();
+  }
 
-  result->status = ESP_OK;
+  OfflineQueue::Stats qs;
+  if (OfflineQueue::getStats(&qs) == ESP_OK) {
+    json.key("mqttQueue");
+    json.beginObject();
+    json.field("pending", qs.pending);
+    json.field("pendingBytes", qs.pendingBytes);
+    json.field("stored", qs.stored);
+    json.field("delivered", qs.delivered);
+    json.field("dropped", qs.dropped);
+    json.field("nextSeq", qs.nextSeq);
+    json.endObject();
+  }
+  json.endObject();
+
+  result->status = json.finish();
+  if (result->status != ESP_OK) {
+    ESP_LOGE(TAG, "Stats output aborted: %s", esp_err_to_name(result->status));
+    result->message = "STATS_FAIL";
+    return result->status;
+  }
   result->message = "STATS_DATA";
-  result->data = s_responseDataBuffer;
-  result->dataLen = strlen(s_responseDataBuffer);
 
   ESP_LOGI(TAG, "Flash: %u/%u bytes (%u%%), wraps=%lu", fs.usedBytes,
            fs.partitionSize, (fs.usedBytes * 100) / fs.partitionSize,
@@ -187,8 +292,26 @@ static esp_err_t handleStats(const char *args, size_t argsLen,
   return ESP_OK;
 }
 
-static esp_err_t handleRead(const char *args, size_t argsLen,
-                            CommandResult *result) {
+// Write @p len bytes as hex lines of 16, labelled from @p address
+static void dumpHex(Context *ctx, const uint8_t *data, size_t len,
+                    unsigned int address) {
+  for (size_t i = 0; i < len; i += 16) {
+    char line[12 + 16 * 3]; // "XXXXXXXX: ", 16 "XX ", newline
+    int lineLen = snprintf(line, sizeof(line), "%04X: ",
+                           (unsigned int)(address + i));
+    for (size_t j = 0; j < 16 && (i + j) < len; j++) {
+      line[lineLen++] = HEX_DIGITS[data[i + j] >> 4];
+      line[lineLen++] = HEX_DIGITS[data[i + j] & 0x0F];
+      line[lineLen++] = ' ';
+    }
+    line[lineLen++] = '\n';
+    if (write(ctx, line, lineLen) != ESP_OK)
+      break;
+  }
+}
+
+static esp_err_t handleRead(Context *ctx, const char *args,
+                            size_t argsLen, CommandResult *result) {
   unsigned int offset = 0, len = 0;
   if (sscanf(args, "%u %u", &offset, &len) != 2) {
     result->status = ESP_ERR_INVALID_ARG;
@@ -198,68 +321,459 @@ static esp_err_t handleRead(const char *args, size_t argsLen,
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (len > 256)
-    len = 256;
+  // Dump straight from mapped flash a page at a time, so any length streams
+  // in constant memory; collecting mediums stop once their buffer is full.
+  // Offsets are taken from the tail at the start of the command.
+  uint8_t block[256];
+  uint64_t base = FlashRing::getLogicalTail() + offset;
+  size_t done = 0;
+  esp_err_t ret = ESP_OK;
+  while (done < len && ctx->outputStatus == ESP_OK) {
+    size_t want = len - done;
+    if (want > FlashRing::PAGE_SIZE)
+      want = FlashRing::PAGE_SIZE;
+    FlashRing::Span spans[2];
+    size_t count = 0;
+    ret = FlashRing::mapLogical(base + done, want, spans, &count);
+    bool mapped = (ret == ESP_OK);
+    if (ret == ESP_ERR_NO_MEM) {
+      // Every window is held by other readers: copy a block instead
+      size_t bytesRead = 0;
+      ret = FlashRing::readLogical(base + done, block,
+                                   want < sizeof(block) ? want : sizeof(block),
+                                   &bytesRead);
+      spans[0] = {block, bytesRead};
+      count = (bytesRead > 0) ? 1 : 0;
+    }
+    if (ret != ESP_OK || count == 0)
+      break;
 
-  uint8_t *buf = (uint8_t *)malloc(len);
-  if (!buf) {
-    result->status = ESP_ERR_NO_MEM;
-    result->message = "READ_FAIL";
-    result->data = "Memory allocation failed";
-    result->dataLen = strlen(result->data);
-    return ESP_ERR_NO_MEM;
+    for (size_t k = 0; k < count; k++) {
+      dumpHex(ctx, spans[k].data, spans[k].len, offset + done);
+      done += spans[k].len;
+    }
+    if (mapped)
+      FlashRing::unmapSpans(spans, count);
   }
 
-  size_t bytesRead = 0;
-  esp_err_t ret = FlashRing::readAt(offset, buf, len, &bytesRead);
-
   if (ret == ESP_OK) {
-    // Format as hex dump
-    size_t hexLen = 0;
-    for (size_t i = 0; i < bytesRead && hexLen < MAX_RESPONSE_DATA - 100;
-         i += 16) {
-      char line[80];
-      int lineLen = snprintf(line, sizeof(line), "%04X: ", (unsigned int)(i + offset));
-      
-      for (size_t j = 0; j < 16 && (i + j) < bytesRead; j++) {
-        lineLen += snprintf(line + lineLen, sizeof(line) - lineLen, "%02X ", buf[i + j]);
-      }
-      lineLen += snprintf(line + lineLen, sizeof(line) - lineLen, "\n");
-      
-      if (hexLen + lineLen < MAX_RESPONSE_DATA - 1) {
-        memcpy(s_responseDataBuffer + hexLen, line, lineLen);
-        hexLen += lineLen;
-      }
-    }
-    s_responseDataBuffer[hexLen] = '\0';
-
     result->status = ESP_OK;
     result->message = "READ_OK";
-    result->data = s_responseDataBuffer;
-    result->dataLen = hexLen;
   } else {
     result->status = ret;
     result->message = "READ_FAIL";
     result->data = "Flash read failed";
     result->dataLen = strlen(result->data);
   }
+  return result->status;
+}
+
+// grep defaults and limits
+static const uint32_t GREP_MAX_MATCHES = 50;
+static const uint32_t GREP_MATCH_LIMIT = 1000;
+static const size_t GREP_CONTEXT = 16;
+
+struct GrepOutput {
+  JsonWriter *json;
+  const RingSearch::Options *options;
+  bool started;
+};
 
-  free(buf);
+// Header goes out with the first match, so a failed search prints nothing
+static void beginGrepOutput(GrepOutput *out) {
+  if (out->started)
+    return;
+  out->started = true;
+  out->json->beginObject();
+  out->json->field("pattern", out->options->pattern);
+  out->json->key("matches");
+  out->json->beginArray();
+}
+
+static bool grepMatch(const RingSearch::Match &match, void *arg) {
+  GrepOutput *out = static_cast<GrepOutput *>(arg);
+  beginGrepOutput(out);
+
+  // Exact bytes in hex, and a printable rendering for reading
+  char text[sizeof(match.data)];
+  char hex[2 * sizeof(match.data)];
+  for (size_t i = 0; i < match.length; i++) {
+    uint8_t c = match.data[i];
+    text[i] = (c >= 0x20 && c < 0x7F) ? (char)c : '.';
+    hex[2 * i] = HEX_DIGITS[c >> 4];
+    hex[2 * i + 1] = HEX_DIGITS[c & 0x0F];
+  }
+
+  JsonWriter &json = *out->json;
+  json.beginObject();
+  json.field("position", match.position);
+  json.field("offset", match.offset);
+  json.field("before", match.before);
+  json.field("length", match.matchLen);
+  json.key("text");
+  json.value(text, match.length);
+  json.key("hex");
+  json.value(hex, 2 * match.length);
+  json.endObject();
+  return json.status() == ESP_OK;
+}
+
+static esp_err_t handleGrep(Context *ctx, const char *args,
+                            size_t argsLen, CommandResult *result) {
+  (void)argsLen;
+  RingSearch::Options options = {};
+  options.maxMatches = GREP_MAX_MATCHES;
+  options.context = GREP_CONTEXT;
+
+  // Options come first; "--" ends them so a pattern may start with '-'
+  const char *p = args;
+  while (p && p[0] == '-') {
+    if (strncmp(p, "-- ", 3) == 0) {
+      p += 3;
+      break;
+    }
+    if (strncmp(p, "-i ", 3) == 0) {
+      options.ignoreCase = true;
+      p += 3;
+      continue;
+    }
+    if ((p[1] != 'm' && p[1] != 'C') || p[2] != ' ')
+      break;
+    char *end = nullptr;
+    unsigned long n = strtoul(p + 3, &end, 10);
+    if (end == p + 3 || *end != ' ') {
+      p = nullptr;
+      break;
+    }
+    if (p[1] == 'm')
+      options.maxMatches = n < GREP_MATCH_LIMIT ? n : GREP_MATCH_LIMIT;
+    else
+      options.context = n < RingSearch::MAX_CONTEXT ? n : RingSearch::MAX_CONTEXT;
+    p = end + 1;
+  }
+  if (!p || *p == '\0') {
+    result->status = ESP_ERR_INVALID_ARG;
+    result->message = "GREP_USAGE";
+    result->data = "Usage: grep [-i] [-m max] [-C context] [--] <pattern>";
+    result->dataLen = strlen(result->data);
+    return ESP_ERR_INVALID_ARG;
+  }
+  options.pattern = p;
+
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+  GrepOutput out = {&json, &options, false};
+  RingSearch::Summary summary = {};
+  esp_err_t ret = RingSearch::search(options, grepMatch, &out, &summary);
+  if (ret != ESP_OK) {
+    result->status = ret;
+    result->message = (ret == ESP_ERR_INVALID_ARG)     ? "GREP_BAD_PATTERN"
+                      : (ret == ESP_ERR_INVALID_STATE) ? "GREP_BUSY"
+                                                       : "GREP_FAIL";
+    result->data = (ret == ESP_ERR_INVALID_ARG) ? "Invalid pattern"
+                   : (ret == ESP_ERR_INVALID_STATE)
+                       ? "Another search is running"
+                       : "Search failed";
+    result->dataLen = strlen(result->data);
+    return ret;
+  }
+
+  beginGrepOutput(&out);
+  json.endArray();
+  json.field("count", summary.matches);
+  json.field("truncated", summary.truncated);
+  json.field("start", summary.start);
+  json.field("end", summary.end);
+  json.field("scanned", summary.scanned);
+  json.field("skipped", summary.skipped);
+  json.field("ms", summary.elapsedMs);
+  json.endObject();
+
+  result->status = json.finish();
+  result->message = (result->status == ESP_OK) ? "GREP_DATA" : "GREP_FAIL";
   return result->status;
 }
 
-static esp_err_t handleBaud(const char *args, size_t argsLen,
+static esp_err_t handleDecoded(Context *ctx, const char *args,
+                               size_t argsLen, CommandResult *result) {
+  (void)args;
+  (void)argsLen;
+  DecodedFrame *frames = (DecodedFrame *)malloc(
+      FrameDecoders::RECENT_FRAMES * sizeof(DecodedFrame));
+  if (!frames) {
+    result->status = ESP_ERR_NO_MEM;
+    result->message = "DECODED_FAIL";
+    return result->status;
+  }
+  size_t count = FrameDecoders::getRecent(frames, FrameDecoders::RECENT_FRAMES);
+  FrameDecoders::Stats stats = {};
+  FrameDecoders::getStats(&stats);
+
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+  json.beginObject();
+  json.key("decoders");
+  json.beginArray();
+  for (uint8_t ch = 0; ch < DataPipeline::MAX_SOURCES; ch++) {
+    const char *name = FrameDecoders::getDecoderName(ch);
+    if (name) {
+      json.beginObject();
+      json.field("channel", ch);
+      json.field("protocol", name);
+      json.endObject();
+    }
+  }
+  json.endArray();
+  json.field("bytesIn", stats.bytesIn);
+  json.field("bytesDiscarded", stats.bytesDiscarded);
+  json.field("frames", stats.frames);
+  json.field("framesDropped", stats.framesDropped);
+  json.field("framesPublished", stats.framesPublished);
+  json.field("batchesPublished", stats.batchesPublished);
+  json.field("framesUnsent", stats.framesUnsent);
+  json.key("recent");
+  json.beginArray();
+  for (size_t i = 0; i < count; i++) {
+    FrameDecoders::writeFrame(frames[i], json);
+  }
+  json.endArray();
+  json.endObject();
+  free(frames);
+
+  result->status = json.finish();
+  result->message = (result->status == ESP_OK) ? "DECODED_DATA" : "DECODED_FAIL";
+  return result->status;
+}
+
+static esp_err_t handleNet(Context *ctx, const char *args, size_t argsLen,
+                           CommandResult *result) {
+  (void)args;
+  (void)argsLen;
+  NetworkManager::Stats stats;
+  if (NetworkManager::getStats(&stats) != ESP_OK) {
+    result->status = ESP_ERR_INVALID_STATE;
+    result->message = "NET_FAIL";
+    return result->status;
+  }
+
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+  json.beginObject();
+  json.field("switches", stats.switches);
+  json.field("failovers", stats.failovers);
+  json.field("lastSwitchMs", stats.lastSwitchUs / 1000); // Since boot
+  json.key("links");
+  json.beginArray();
+  for (uint32_t i = 0; i < stats.links; i++) {
+    const NetworkManager::LinkStats &link = stats.link[i];
+    json.beginObject();
+    json.field("name", NetworkManager::linkName(link.type));
+    json.field("connected", link.connected);
+    json.field("active", link.active);
+    json.field("rttMs", link.rttUs / 1000.0f, 1);
+    json.field("throughputBps", link.throughputBps);
+    json.field("probes", link.probes);
+    json.field("probeFailures", link.probeFailures);
+    json.field("bytesSent", link.bytesSent);
+    // Measured throughput above is what the profile delivers on this site
+    WifiInterface::LinkInfo wifi;
+    if (link.type == Network::Type::WIFI &&
+        static_cast<WifiInterface *>(NetworkManager::getLink(link.type))
+                ->getLinkInfo(&wifi) == ESP_OK) {
+      json.field("profile", WifiInterface::profileName(wifi.profile));
+      json.field("powerSave", wifi.powerSave);
+      json.field("rssi", wifi.rssi);
+      json.field("channel", wifi.channel);
+      json.field("ht40", wifi.ht40);
+    }
+    json.endObject();
+  }
+  json.endArray();
+  json.endObject();
+
+  result->status = json.finish();
+  result->message = (result->status == ESP_OK) ? "NET_DATA" : "NET_FAIL";
+  return result->status;
+}
+
+static esp_err_t handleJobs(Context *ctx, const char *args, size_t argsLen,
                             CommandResult *result) {
+  (void)args;
+  (void)argsLen;
+  static Housekeeping::Stats stats; // Too large for the caller's stack
+  if (Housekeeping::getStats(&stats) != ESP_OK) {
+    result->status = ESP_ERR_INVALID_STATE;
+    result->message = "JOBS_FAIL";
+    return result->status;
+  }
+  int64_t now = esp_timer_get_time();
+
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+  json.beginObject();
+  json.field("wakeups", stats.wakeups);
+  json.field("busyMs", stats.busyUs / 1000);
+  json.key("jobs");
+  json.beginArray();
+  for (uint32_t i = 0; i < stats.jobs; i++) {
+    const Housekeeping::JobStats &job = stats.job[i];
+    json.beginObject();
+    json.field("name", job.name);
+    json.field("runs", job.runs);
+    json.field("notifies", job.notifies);
+    json.field("lastUs", job.lastRunUs);
+    json.field("maxUs", job.maxRunUs);
+    json.field("avgUs", job.runs ? (uint32_t)(job.totalRunUs / job.runs) : 0);
+    json.field("totalMs", job.totalRunUs / 1000);
+    // -1 while waiting for a notify
+    int64_t nextMs = -1;
+    if (job.nextRunUs >= 0) {
+      nextMs = job.nextRunUs > now ? (job.nextRunUs - now) / 1000 : 0;
+    }
+    json.field("nextMs", nextMs);
+    json.endObject();
+  }
+  json.endArray();
+
+  // The deferred log renderer is one of the jobs above
+  DeferredLog::Stats log;
+  DeferredLog::getStats(&log);
+  json.key("log");
+  json.beginObject();
+  json.field("written", log.written);
+  json.field("rendered", log.rendered);
+  json.field("dropped", log.dropped);
+  json.field("suppressed", log.suppressed);
+  json.field("forwarded", log.forwarded);
+  json.field("maxQueued", log.maxQueued);
+  json.endObject();
+  json.endObject();
+
+  result->status = json.finish();
+  result->message = (result->status == ESP_OK) ? "JOBS_DATA" : "JOBS_FAIL";
+  return result->status;
+}
+
+static esp_err_t handleProfile(Context *ctx, const char *args,
+                               size_t argsLen, CommandResult *result) {
+  (void)args;
+  (void)argsLen;
+  static TaskProfiler::Snapshot snap; // Too large for the caller's stack
+  esp_err_t ret = TaskProfiler::getSnapshot(&snap);
+  if (ret != ESP_OK) {
+    result->status = ret;
+    result->message = "PROFILE_FAIL";
+    result->data = "CPU profiling not running";
+    result->dataLen = strlen(result->data);
+    return result->status;
+  }
+
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+  TaskProfiler::toJson(snap, &json);
+  result->status = json.finish();
+  result->message = (result->status == ESP_OK) ? "PROFILE_DATA" : "PROFILE_FAIL";
+  return result->status;
+}
+
+// cursor: list FlashRing read cursors
+// cursor open|close <name>: create or remove one (e.g. for an HTTP puller)
+static esp_err_t handleCursor(Context *ctx, const char *args, size_t argsLen,
+                              CommandResult *result) {
+  char action[8] = "", name[FlashRing::CURSOR_NAME_LEN + 2] = "";
+  static_assert(FlashRing::CURSOR_NAME_LEN == 8, "Update the sscanf width");
+  int parsed = (argsLen > 0) ? sscanf(args, "%7s %9s", action, name) : 0;
+
+  if (parsed == 2 && strlen(name) <= FlashRing::CURSOR_NAME_LEN) {
+    FlashRing::CursorId id = -1;
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+    if (strcmp(action, "open") == 0) {
+      ret = FlashRing::openCursor(name, &id);
+    } else if (strcmp(action, "close") == 0) {
+      ret = FlashRing::findCursor(name, &id);
+      if (ret == ESP_OK) {
+        ret = FlashRing::closeCursor(id);
+      }
+    }
+    result->status = ret;
+    result->message = (ret == ESP_OK) ? "CURSOR_OK" : "CURSOR_FAIL";
+    if (ret != ESP_OK) {
+      result->data = esp_err_to_name(ret);
+      result->dataLen = strlen(result->data);
+    }
+    return result->status;
+  }
+  if (parsed != 0) {
+    result->status = ESP_ERR_INVALID_ARG;
+    result->message = "CURSOR_FAIL";
+    result->data = "Usage: cursor [open|close <name>]";
+    result->dataLen = strlen(result->data);
+    return result->status;
+  }
+
+  for (FlashRing::CursorId id = 0; id < (int)FlashRing::MAX_CURSORS; id++) {
+    FlashRing::CursorInfo info;
+    if (FlashRing::getCursor(id, &info) == ESP_OK) {
+      print(ctx, "%-8s pos %llu pending %llu dropped %llu\n", info.name,
+            (unsigned long long)info.position,
+            (unsigned long long)info.pending,
+            (unsigned long long)info.dropped);
+    }
+  }
+  result->status = ESP_OK;
+  result->message = "CURSOR_LIST";
+  return result->status;
+}
+
+// ota: status of the current or last update
+// ota <url> [rateKBps] [reboot]: download and write a new image
+static esp_err_t handleOta(Context *ctx, const char *args, size_t argsLen,
+                           CommandResult *result) {
+  if (argsLen == 0 || args[0] == '\0') {
+    OtaUpdate::Status status;
+    OtaUpdate::getStatus(&status);
+    char stage[128];
+    JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+    OtaUpdate::toJson(status, &json);
+    result->status = json.finish();
+    result->message = (result->status == ESP_OK) ? "OTA_STATUS" : "OTA_FAIL";
+    return result->status;
+  }
+
+  static_assert(OtaUpdate::MAX_URL == 159, "Update the sscanf width");
+  char url[OtaUpdate::MAX_URL + 1];
+  unsigned int rateKBps = 0;
+  char reboot[8] = "";
+  esp_err_t ret = ESP_ERR_INVALID_ARG;
+  if (strcspn(args, " ") <= OtaUpdate::MAX_URL &&
+      sscanf(args, "%159s %u %7s", url, &rateKBps, reboot) >= 1) {
+    ret = OtaUpdate::startDownload(url, rateKBps,
+                                   strcmp(reboot, "reboot") == 0);
+  }
+  result->status = ret;
+  if (ret == ESP_OK) {
+    result->message = "OTA_STARTED";
+    print(ctx, "Downloading %s", url);
+  } else {
+    result->message = "OTA_FAIL";
+    result->data = (ret == ESP_ERR_INVALID_STATE)
+                       ? "Update already running"
+                       : "Usage: ota [<url> [rateKBps] [reboot]]";
+    result->dataLen = strlen(result->data);
+  }
+  return result->status;
+}
+
+static esp_err_t handleBaud(Context *ctx, const char *args,
+                            size_t argsLen, CommandResult *result) {
   if (argsLen == 0 || args[0] == '\0') {
     // Get current baudrate
     if (s_dataSource && s_dataSource->getType() == Transport::Type::UART) {
       UartCapture *uart = static_cast<UartCapture *>(s_dataSource);
       uint32_t currentBaud = uart->getBaudRate();
-      snprintf(s_responseDataBuffer, MAX_RESPONSE_DATA, "%lu", currentBaud);
+      print(ctx, "%lu", currentBaud);
       result->status = ESP_OK;
       result->message = "BAUD";
-      result->data = s_responseDataBuffer;
-      result->dataLen = strlen(s_responseDataBuffer);
       ESP_LOGI(TAG, "Current baudrate: %lu", currentBaud);
     } else {
       result->status = ESP_ERR_NOT_SUPPORTED;
@@ -273,18 +787,23 @@ static esp_err_t handleBaud(const char *args, size_t argsLen,
   // Set baudrate
   if (s_dataSource && s_dataSource->getType() == Transport::Type::UART) {
     unsigned int newBaud = 0;
-    if (sscanf(args, "%u", &newBaud) == 1) {
+    if (argsLen == 4 && strncmp(args, "auto", 4) == 0) {
+      // Measure the line rate; nothing is captured until it locks
+      UartCapture *uart = static_cast<UartCapture *>(s_dataSource);
+      result->status = uart->setAutoBaud(true);
+      result->message = (result->status == ESP_OK) ? "BAUD_OK" : "BAUD_FAIL";
+      write(ctx, "auto", 4);
+      ESP_LOGI(TAG, "Baudrate set to auto-detect");
+    } else if (sscanf(args, "%u", &newBaud) == 1) {
       UartCapture *uart = static_cast<UartCapture *>(s_dataSource);
       if (uart->setBaudRate(newBaud) == ESP_OK) {
         ConfigManager::FullConfig fullConfig;
         if (ConfigManager::getConfig(&fullConfig) == ESP_OK) {
           ConfigManager::saveConfig(&fullConfig);
         }
-        snprintf(s_responseDataBuffer, MAX_RESPONSE_DATA, "%u", newBaud);
+        print(ctx, "%u", newBaud);
         result->status = ESP_OK;
         result->message = "BAUD_OK";
-        result->data = s_responseDataBuffer;
-        result->dataLen = strlen(s_responseDataBuffer);
         ESP_LOGI(TAG, "Baudrate set to %u", newBaud);
       } else {
         result->status = ESP_FAIL;
@@ -295,7 +814,7 @@ static esp_err_t handleBaud(const char *args, size_t argsLen,
     } else {
       result->status = ESP_ERR_INVALID_ARG;
       result->message = "BAUD_USAGE";
-      result->data = "Usage: baud <baudrate>";
+      result->data = "Usage: baud <baudrate|auto>";
       result->dataLen = strlen(result->data);
     }
   } else {
@@ -307,35 +826,225 @@ static esp_err_t handleBaud(const char *args, size_t argsLen,
   return result->status;
 }
 
-static esp_err_t handleConfig(const char *args, size_t argsLen,
-                              CommandResult *result) {
+// Longest bench run (the calling medium blocks meanwhile)
+static constexpr unsigned int BENCH_MAX_SECONDS = 60;
+
+static PatternGenerator s_benchGenerator;
+static PerfCounters::Snapshot s_benchBefore;
+static PerfCounters::Snapshot s_benchAfter;
+
+// Idle task run time per core (esp_timer µs), 0 without run time stats
+static void readIdleTime(uint32_t idleUs[portNUM_PROCESSORS]) {
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    idleUs[core] = ulTaskGetIdleRunTimeCounterForCore(core);
+#else
+    idleUs[core] = 0;
+#endif
+  }
+}
+
+// Append a stage's latency percentiles over the bench run
+static void writeBenchLatency(JsonWriter &json, const char *name,
+                              PerfCounters::Stage stage) {
+  const PerfCounters::Histogram &a = s_benchBefore.stages[(size_t)stage];
+  const PerfCounters::Histogram &b = s_benchAfter.stages[(size_t)stage];
+  PerfCounters::Histogram h = b;
+  h.count -= a.count;
+  h.totalUs -= a.totalUs;
+  for (size_t i = 0; i < PerfCounters::BUCKETS; i++) {
+    h.buckets[i] -= a.buckets[i];
+  }
+
+  json.key(name);
+  json.beginObject();
+  json.field("count", h.count);
+  json.field("avgUs", h.count ? h.totalUs / h.count : 0);
+  json.field("p50Us", PerfCounters::percentileUs(h, 50));
+  json.field("p90Us", PerfCounters::percentileUs(h, 90));
+  json.field("p99Us", PerfCounters::percentileUs(h, 99));
+  json.field("maxUs", h.maxUs);
+  json.endObject();
+}
+
+static esp_err_t handleBench(Context *ctx, const char *args,
+                             size_t argsLen, CommandResult *result) {
+  (void)argsLen;
+  unsigned int rateKBps = 0, seconds = 0, burstBytes = 0, gapMs = 0;
+  char pattern[8] = "counter";
+  int parsed = sscanf(args, "%u %u %u %u %7s", &rateKBps, &seconds,
+                      &burstBytes, &gapMs, pattern);
+  bool prbs = strcmp(pattern, "prbs") == 0;
+  if (parsed < 2 || seconds == 0 || seconds > BENCH_MAX_SECONDS ||
+      (!prbs && strcmp(pattern, "counter") != 0)) {
+    result->status = ESP_ERR_INVALID_ARG;
+    result->message = "BENCH_USAGE";
+    result->data = "Usage: bench <rateKBps|0> <seconds> [burstBytes] [gapMs] "
+                   "[counter|prbs]";
+    result->dataLen = strlen(result->data);
+    return result->status;
+  }
+
+  // The generator stands in for the transport, so no capture may be running
+  if (s_dataSource) {
+    result->status = ESP_ERR_INVALID_STATE;
+    result->message = "BENCH_BUSY";
+    result->data = "Bench needs an idle pipeline (transport active)";
+    result->dataLen = strlen(result->data);
+    return result->status;
+  }
+
+  PatternGenerator::Config genConfig;
+  genConfig.rateBps = rateKBps * 1024;
+  genConfig.burstBytes = burstBytes;
+  genConfig.gapMs = gapMs;
+  genConfig.pattern =
+      prbs ? PatternGenerator::Pattern::PRBS : PatternGenerator::Pattern::COUNTER;
+
+  // Same pipeline setup as a capture session
+  DataPipeline::Config pipeConfig = {.writeChunkSize = 12288,
+                                     .flushTimeoutMs = 500,
+                                     .autoStart = true,
+                                     .compress = false,
+                                     .adaptiveFlush = true};
+  esp_err_t ret = s_benchGenerator.init(&genConfig);
+  if (ret == ESP_OK) {
+    ret = DataPipeline::init(pipeConfig, &s_benchGenerator);
+    if (ret != ESP_OK) {
+      s_benchGenerator.deinit();
+    }
+  }
+  if (ret != ESP_OK) {
+    result->status = ret;
+    result->message = "BENCH_FAIL";
+    result->data = "Failed to set up generator and pipeline";
+    result->dataLen = strlen(result->data);
+    return result->status;
+  }
+
+  ESP_LOGI(TAG, "Bench: %u KB/s for %u s (burst %u B, gap %u ms, %s)",
+           rateKBps, seconds, burstBytes, gapMs, pattern);
+
+  uint32_t idleBefore[portNUM_PROCESSORS], idleAfter[portNUM_PROCESSORS];
+  PerfCounters::snapshot(&s_benchBefore);
+  readIdleTime(idleBefore);
+  int64_t startUs = esp_timer_get_time();
+
+  s_benchGenerator.start();
+  vTaskDelay(pdMS_TO_TICKS(seconds * 1000));
+  s_benchGenerator.stop();
+
+  int64_t elapsedUs = esp_timer_get_time() - startUs;
+  readIdleTime(idleAfter);
+  PerfCounters::snapshot(&s_benchAfter);
+
+  // Drain what is still buffered so the drop counts are final
+  DataPipeline::flush();
+  FlashRing::waitIdle(pdMS_TO_TICKS(1000));
+  DataPipeline::Stats ps;
+  DataPipeline::getStats(&ps);
+  Transport::Stats ts;
+  s_benchGenerator.getStats(&ts);
+  uint64_t generated = s_benchGenerator.bytesGenerated();
+  uint64_t genDropped = s_benchGenerator.bytesDropped();
+  DataPipeline::deinit();
+  s_benchGenerator.deinit();
+
+  uint64_t flashed =
+      s_benchAfter.counters[(size_t)PerfCounters::Counter::FLASHED].totalBytes -
+      s_benchBefore.counters[(size_t)PerfCounters::Counter::FLASHED].totalBytes;
+  float mbps = elapsedUs > 0 ? (float)flashed / (float)elapsedUs : 0.0f;
+
+  char stage[128];
+  JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+  json.beginObject();
+  json.key("bench");
+  json.beginObject();
+  json.field("seconds", elapsedUs / 1e6, 2);
+  json.field("targetBps", genConfig.rateBps);
+  json.field("generatedBytes", generated);
+  json.field("flashedBytes", flashed);
+  json.field("mbps", mbps, 3);
+  json.field("peakBps",
+             s_benchAfter.counters[(size_t)PerfCounters::Counter::FLASHED]
+                 .peakBps);
+  json.field("droppedGenerator", genDropped);
+  json.field("overflows", ts.overflowCount);
+  json.field("droppedPipeline", ps.bytesDropped);
+  json.field("ringHighWater", ts.ringHighWater);
+  json.field("bursts", ts.burstCount);
+  writeBenchLatency(json, "flashWrite", PerfCounters::Stage::FLASH_WRITE);
+  writeBenchLatency(json, "flashErase", PerfCounters::Stage::FLASH_ERASE);
+  writeBenchLatency(json, "ringToWriter", PerfCounters::Stage::RING_TO_WRITER);
+
+  // CPU load per core: share of the run not spent in the idle task
+  json.key("cpuLoadPct");
+  json.beginArray();
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    uint32_t idleUs = idleAfter[core] - idleBefore[core];
+    float load = elapsedUs > 0 ? 100.0f * (1.0f - (float)idleUs / elapsedUs)
+                               : 0.0f;
+    json.value(load < 0.0f ? 0.0f : load, 1);
+#else
+    json.valueNull();
+#endif
+  }
+  json.endArray();
+  json.endObject();
+  json.endObject();
+  json.finish();
+
+  result->status = ESP_OK;
+  result->message = "BENCH_DATA";
+
+  ESP_LOGI(TAG, "Bench: %.3f MB/s sustained, %llu B dropped by generator, "
+           "%zu B by pipeline", mbps, (unsigned long long)genDropped,
+           ps.bytesDropped);
+  return ESP_OK;
+}
+
+static esp_err_t handleConfig(Context *ctx, const char *args,
+                              size_t argsLen, CommandResult *result) {
   (void)args;
   (void)argsLen;
 
   ConfigManager::FullConfig config;
   if (ConfigManager::getConfig(&config) == ESP_OK) {
     // Format as JSON
-    snprintf(s_responseDataBuffer, MAX_RESPONSE_DATA,
-             "{\"device\":{\"name\":\"%s\",\"id\":\"%s\",\"type\":%d},"
-             "\"network\":{\"lan\":{\"enabled\":%s,"
-             "\"staticIp\":\"%d.%d.%d.%d\"},"
-             "\"wlanOp\":{\"enabled\":%s,\"ssid\":\"%s\"},"
-             "\"wlanSafe\":{\"ssid\":\"%s\",\"channel\":%d}}}",
-             config.device.name, config.device.id,
-             (int)config.device.type,
-             config.network.lan.enabled ? "true" : "false",
-             config.network.lan.staticIp.addr[0],
-             config.network.lan.staticIp.addr[1],
-             config.network.lan.staticIp.addr[2],
-             config.network.lan.staticIp.addr[3],
-             config.network.wlanOp.enabled ? "true" : "false",
-             config.network.wlanOp.ssid, config.network.wlanSafe.ssid,
-             config.network.wlanSafe.channel);
+    char stage[128];
+    JsonWriter json(stage, sizeof(stage), jsonSink, ctx);
+    json.beginObject();
+    json.key("device");
+    json.beginObject();
+    json.field("name", config.device.name);
+    json.field("id", config.device.id);
+    json.field("type", (int)config.device.type);
+    json.endObject();
+    json.key("network");
+    json.beginObject();
+    json.key("lan");
+    json.beginObject();
+    json.field("enabled", config.network.lan.enabled);
+    json.key("staticIp");
+    json.valueIp(config.network.lan.staticIp.addr);
+    json.endObject();
+    json.key("wlanOp");
+    json.beginObject();
+    json.field("enabled", config.network.wlanOp.enabled);
+    json.field("ssid", config.network.wlanOp.ssid);
+    json.endObject();
+    json.key("wlanSafe");
+    json.beginObject();
+    json.field("ssid", config.network.wlanSafe.ssid);
+    json.field("channel", config.network.wlanSafe.channel);
+    json.endObject();
+    json.endObject();
+    json.endObject();
+    json.finish();
 
     result->status = ESP_OK;
     result->message = "CONFIG_DATA";
-    result->data = s_responseDataBuffer;
-    result->dataLen = strlen(s_responseDataBuffer);
 
     ESP_LOGI(TAG, "Device: %s (ID: %s)", config.device.name, config.device.id);
   } else {
@@ -347,8 +1056,9 @@ static esp_err_t handleConfig(const char *args, size_t argsLen,
   return result->status;
 }
 
-static esp_err_t handleReset(const char *args, size_t argsLen,
-                             CommandResult *result) {
+static esp_err_t handleReset(Context *ctx, const char *args,
+                             size_t argsLen, CommandResult *result) {
+  (void)ctx;
   (void)args;
   (void)argsLen;
 
@@ -368,32 +1078,71 @@ static esp_err_t handleReset(const char *args, size_t argsLen,
   return ESP_OK;
 }
 
-static esp_err_t handleHelp(const char *args, size_t argsLen,
-                            CommandResult *result) {
+static esp_err_t handleHelp(Context *ctx, const char *args,
+                            size_t argsLen, CommandResult *result) {
   (void)args;
   (void)argsLen;
 
-  size_t helpLen = 0;
-  helpLen = snprintf(s_responseDataBuffer, MAX_RESPONSE_DATA,
-                     "Available commands:\n");
-
-  for (size_t i = 0; i < s_commandCount && helpLen < MAX_RESPONSE_DATA - 100;
-       i++) {
-    int len = snprintf(s_responseDataBuffer + helpLen,
-                       MAX_RESPONSE_DATA - helpLen, "  %s - %s\n",
-                       s_commands[i].name, s_commands[i].description);
-    if (len > 0)
-      helpLen += len;
+  print(ctx, "Available commands:\n");
+  for (size_t i = 0; i < s_commandCount; i++) {
+    if (print(ctx, "  %s - %s\n", s_commands[i].name,
+              s_commands[i].description) != ESP_OK)
+      break;
   }
 
   result->status = ESP_OK;
   result->message = "HELP";
-  result->data = s_responseDataBuffer;
-  result->dataLen = helpLen;
 
   return ESP_OK;
 }
 
+// DEBUG medium output: the console UART
+static bool consoleSink(void *ctx, const char *data, size_t len) {
+  (void)ctx;
+  return fwrite(data, 1, len, stdout) == len;
+}
+
+// Runs one console line, then exits (the stack is only held meanwhile)
+static void cliCommandTask(void *arg) {
+  (void)arg;
+  // Output goes straight to the console as it is produced;
+  // executeCommand will send the result line automatically
+  Context ctx = {.medium = Medium::DEBUG, .sink = consoleSink};
+  executeCommand(&ctx, s_cliLine);
+  s_cliBusy = false;
+  vTaskDelete(nullptr);
+}
+
+// Collects console input; input stays buffered in stdin while a command runs
+static uint32_t cliInputJob(void *arg) {
+  (void)arg;
+  if (s_cliBusy) {
+    return CLI_POLL_MS;
+  }
+
+  int c;
+  while ((c = getchar()) != EOF) {
+    if (c == '\n' || c == '\r') {
+      if (s_cliInputLen == 0) {
+        continue;
+      }
+      memcpy(s_cliLine, s_cliInput, s_cliInputLen);
+      s_cliLine[s_cliInputLen] = '\0';
+      s_cliInputLen = 0;
+      s_cliBusy = true;
+      if (xTaskCreate(cliCommandTask, "cli_cmd", CLI_COMMAND_STACK, nullptr, 5,
+                      nullptr) != pdPASS) {
+        ESP_LOGE(TAG, "No memory to run command: %s", s_cliLine);
+        s_cliBusy = false;
+      }
+      break;
+    } else if (s_cliInputLen < sizeof(s_cliInput) - 1) {
+      s_cliInput[s_cliInputLen++] = (char)c;
+    }
+  }
+  return CLI_POLL_MS;
+}
+
 // --- Public API Implementation ---
 
 esp_err_t initialize(IDataSource *dataSource) {
@@ -419,7 +1168,7 @@ esp_err_t initialize(IDataSource *dataSource) {
                    .allowedMediums = (MediumMask)Medium::DEBUG |
                                      (MediumMask)Medium::WEB |
                                      (MediumMask)Medium::MQTT,
-                   .description = "Get system statistics"});
+                   .description = "Get system statistics (usage: stats [metrics])"});
 
   registerCommand({.name = "read",
                    .handler = handleRead,
@@ -427,6 +1176,56 @@ esp_err_t initialize(IDataSource *dataSource) {
                        (MediumMask)Medium::DEBUG | (MediumMask)Medium::WEB,
                    .description = "Read data from flash (usage: read <offset> <length>)"});
 
+  registerCommand({.name = "grep",
+                   .handler = handleGrep,
+                   .allowedMediums =
+                       (MediumMask)Medium::DEBUG | (MediumMask)Medium::WEB,
+                   .description = "Search stored data (usage: grep [-i] [-m max] "
+                                  "[-C context] [--] <pattern>)"});
+
+  registerCommand({.name = "decoded",
+                   .handler = handleDecoded,
+                   .allowedMediums =
+                       (MediumMask)Medium::DEBUG | (MediumMask)Medium::WEB,
+                   .description = "Recent decoded protocol frames"});
+
+  registerCommand({.name = "net",
+                   .handler = handleNet,
+                   .allowedMediums = (MediumMask)Medium::DEBUG |
+                                     (MediumMask)Medium::WEB |
+                                     (MediumMask)Medium::MQTT,
+                   .description = "Uplink links, RTT and active route"});
+
+  registerCommand({.name = "jobs",
+                   .handler = handleJobs,
+                   .allowedMediums = (MediumMask)Medium::DEBUG |
+                                     (MediumMask)Medium::WEB |
+                                     (MediumMask)Medium::MQTT,
+                   .description = "Housekeeping jobs and their run times"});
+
+  registerCommand({.name = "profile",
+                   .handler = handleProfile,
+                   .allowedMediums = (MediumMask)Medium::DEBUG |
+                                     (MediumMask)Medium::WEB |
+                                     (MediumMask)Medium::MQTT,
+                   .description = "CPU load per core and per task, stack "
+                                  "high-water marks"});
+
+  // Debug console only: a cursor nobody reads holds back the erase window
+  registerCommand({.name = "cursor",
+                   .handler = handleCursor,
+                   .allowedMediums = (MediumMask)Medium::DEBUG,
+                   .description = "FlashRing read cursors (usage: cursor "
+                                  "[open|close <name>])"});
+
+  registerCommand({.name = "ota",
+                   .handler = handleOta,
+                   .allowedMediums = (MediumMask)Medium::DEBUG |
+                                     (MediumMask)Medium::WEB |
+                                     (MediumMask)Medium::MQTT,
+                   .description = "Firmware update status, or download one "
+                                  "(usage: ota [<url> [rateKBps] [reboot]])"});
+
   registerCommand({.name = "baud",
                    .handler = handleBaud,
                    .allowedMediums =
@@ -434,6 +1233,13 @@ esp_err_t initialize(IDataSource *dataSource) {
                    .description =
                        "Get or set UART baudrate (usage: baud [rate])"});
 
+  registerCommand({.name = "bench",
+                   .handler = handleBench,
+                   .allowedMediums = (MediumMask)Medium::DEBUG,
+                   .description = "Pipeline throughput benchmark (usage: bench "
+                                  "<rateKBps|0> <seconds> [burstBytes] [gapMs] "
+                                  "[counter|prbs])"});
+
   registerCommand({.name = "config",
                    .handler = handleConfig,
                    .allowedMediums = (MediumMask)Medium::DEBUG |
@@ -460,40 +1266,18 @@ esp_err_t initialize(IDataSource *dataSource) {
                                      (MediumMask)Medium::MQTT,
                    .description = "Show available commands"});
 
-  // Start UART CLI task
-  BaseType_t ret = xTaskCreate(
-      [](void *arg) {
-        (void)arg;
-        char cmdBuf[64];
-        int cmdIdx = 0;
-
-        while (true) {
-          int c = getchar();
-          if (c != EOF) {
-            if (c == '\n' || c == '\r') {
-              if (cmdIdx > 0) {
-                cmdBuf[cmdIdx] = '\0';
-                // executeCommand will send response automatically
-                executeCommand(Medium::DEBUG, cmdBuf);
-                cmdIdx = 0;
-              }
-            } else if (cmdIdx < (int)sizeof(cmdBuf) - 1) {
-              cmdBuf[cmdIdx++] = (char)c;
-            }
-          }
-          vTaskDelay(pdMS_TO_TICKS(10));
-        }
-      },
-      "cli_task", 4096, nullptr, 5, &s_cliTaskHandle);
-
-  return (ret == pdPASS) ? ESP_OK : ESP_FAIL;
+  // Start UART CLI input
+  esp_err_t ret =
+      Housekeeping::add("cli", cliInputJob, nullptr, CLI_POLL_MS, &s_cliJob);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register CLI input job");
+  }
+  return ret;
 }
 
 void deinit() {
-  if (s_cliTaskHandle) {
-    vTaskDelete(s_cliTaskHandle);
-    s_cliTaskHandle = nullptr;
-  }
+  Housekeeping::remove(s_cliJob);
+  s_cliJob = Housekeeping::INVALID_JOB;
   s_commandCount = 0;
   s_callbackCount = 0;
   s_dataSource = nullptr;
@@ -515,7 +1299,55 @@ esp_err_t registerCommand(const Command &cmd) {
   return ESP_OK;
 }
 
-CommandResult executeCommand(Medium medium, const char *cmdStr) {
+esp_err_t write(Context *ctx, const char *data, size_t len) {
+  if (ctx->outputStatus != ESP_OK || len == 0) {
+    return ctx->outputStatus;
+  }
+  if (ctx->sink) {
+    if (!ctx->sink(ctx->sinkCtx, data, len)) {
+      ctx->outputStatus = ESP_FAIL;
+      return ESP_FAIL;
+    }
+  } else {
+    // Keep what fits so a truncated dump is still readable
+    size_t room = ctx->bufSize > ctx->length ? ctx->bufSize - ctx->length - 1 : 0;
+    if (len > room) {
+      len = room;
+      ctx->outputStatus = ESP_ERR_NO_MEM;
+    }
+    memcpy(ctx->buf + ctx->length, data, len);
+    ctx->buf[ctx->length + len] = '\0';
+  }
+  ctx->length += len;
+  return ctx->outputStatus;
+}
+
+esp_err_t print(Context *ctx, const char *fmt, ...) {
+  char line[160];
+  va_list ap;
+  va_start(ap, fmt);
+  int len = vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  if (len < 0) {
+    return ESP_FAIL;
+  }
+  return write(ctx, line, (size_t)len < sizeof(line) ? len : sizeof(line) - 1);
+}
+
+bool jsonSink(void *ctx, const char *data, size_t len) {
+  return write((Context *)ctx, data, len) == ESP_OK;
+}
+
+CommandResult executeCommand(Context *ctx, const char *cmdStr) {
+  Medium medium = ctx->medium;
+  ctx->length = 0;
+  ctx->outputStatus = (ctx->sink || (ctx->buf && ctx->bufSize > 0))
+                          ? ESP_OK
+                          : ESP_ERR_INVALID_ARG; // Nowhere to put output
+  if (!ctx->sink && ctx->buf && ctx->bufSize > 0) {
+    ctx->buf[0] = '\0';
+  }
+
   CommandResult result = {};
   result.status = ESP_ERR_NOT_FOUND;
   result.message = "COMMAND_NOT_FOUND";
@@ -572,11 +1404,23 @@ CommandResult executeCommand(Medium medium, const char *cmdStr) {
   }
 
   // Execute command
-  esp_err_t ret = cmd->handler(args ? args : "", argsLen, &result);
+  result.data = nullptr;
+  result.dataLen = 0;
+  esp_err_t ret = cmd->handler(ctx, args ? args : "", argsLen, &result);
   if (ret != ESP_OK && result.status == ESP_ERR_NOT_FOUND) {
     result.status = ret;
   }
 
+  // Collected output becomes the data payload
+  if (!ctx->sink && !result.data && ctx->length > 0) {
+    result.data = ctx->buf;
+    result.dataLen = ctx->length;
+  }
+  if (ctx->outputStatus == ESP_ERR_NO_MEM) {
+    ESP_LOGW(TAG, "[%s] Output of %s truncated to %u bytes",
+             mediumToString(medium), cmdName, (unsigned)ctx->length);
+  }
+
   // Log result to DEBUG UART (always, regardless of origin medium)
   if (result.status == ESP_OK) {
     ESP_LOGI(TAG, "[%s] Command %s executed successfully: %s",
@@ -590,7 +1434,7 @@ CommandResult executeCommand(Medium medium, const char *cmdStr) {
   // Send response through registered callback
   // Note: For reset/reboot, the handler will delay before rebooting to allow
   // the response to be sent first
-  sendResponse(medium, &result);
+  sendResponse(ctx, &result);
 
   return result;
 }
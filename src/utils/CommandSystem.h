@@ -38,15 +38,51 @@ struct CommandResult {
   size_t dataLen;        ///< Data payload length
 };
 
+/**
+ * @brief Output stream supplied by a medium
+ * @return false to abort the output (reported as ESP_FAIL)
+ */
+typedef bool (*OutputSink)(void *ctx, const char *data, size_t len);
+
+/// Output buffer most mediums collect a response in
+constexpr size_t DEFAULT_OUTPUT_SIZE = 1024;
+
+/**
+ * @brief Per-invocation context
+ *
+ * Owned by the caller of executeCommand(), so mediums can run commands
+ * concurrently. Handlers emit their data payload with write()/print();
+ * it is either collected in @c buf (and returned as CommandResult::data)
+ * or, when @c sink is set, streamed to the medium as it is produced, which
+ * lets large outputs (hex dumps, stats) run at line rate in constant memory.
+ *
+ * @code
+ *   char out[CommandSystem::DEFAULT_OUTPUT_SIZE];
+ *   CommandSystem::Context ctx = {.medium = CommandSystem::Medium::WEB,
+ *                                 .buf = out, .bufSize = sizeof(out)};
+ *   CommandSystem::CommandResult r = CommandSystem::executeCommand(&ctx, "stats");
+ * @endcode
+ */
+struct Context {
+  Medium medium;                ///< Medium running the command
+  char *buf = nullptr;          ///< Collects the output when sink is nullptr
+  size_t bufSize = 0;           ///< Size of buf (one byte is kept for the terminator)
+  OutputSink sink = nullptr;    ///< Streams the output instead of collecting it
+  void *sinkCtx = nullptr;      ///< Passed to sink
+  size_t length = 0;            ///< Output bytes so far (collected or streamed)
+  esp_err_t outputStatus = ESP_OK; ///< ESP_ERR_NO_MEM once buf filled up, ESP_FAIL if sink refused
+};
+
 /**
  * @brief Command handler function type
+ * @param ctx Invocation context (output goes through write()/print())
  * @param args Command arguments (parsed from command string)
  * @param argsLen Length of arguments string
  * @param result Output result structure
  * @return ESP_OK if command executed successfully
  */
-typedef esp_err_t (*CommandHandler)(const char *args, size_t argsLen,
-                                    CommandResult *result);
+typedef esp_err_t (*CommandHandler)(Context *ctx, const char *args,
+                                    size_t argsLen, CommandResult *result);
 
 /**
  * @brief Response callback function type
@@ -88,12 +124,37 @@ void deinit();
 esp_err_t registerCommand(const Command &cmd);
 
 /**
- * @brief Execute a command from a specific medium
- * @param medium Medium that originated the command
+ * @brief Execute a command
+ *
+ * When the output is collected, CommandResult::data points into ctx->buf;
+ * when it is streamed, data is only set for error text and ctx->length
+ * tells how much went to the sink.
+ * @param ctx Invocation context, output state is reset first
  * @param cmdStr Full command string (e.g., "format", "stats", "read 0 256")
  * @return CommandResult with execution result
  */
-CommandResult executeCommand(Medium medium, const char *cmdStr);
+CommandResult executeCommand(Context *ctx, const char *cmdStr);
+
+/**
+ * @brief Emit command output
+ *
+ * Errors are sticky in ctx->outputStatus; handlers producing long output
+ * stop when this fails.
+ * @return ESP_OK, ESP_ERR_NO_MEM if the collect buffer is full, ESP_FAIL if
+ *         the sink refused data
+ */
+esp_err_t write(Context *ctx, const char *data, size_t len);
+
+/**
+ * @brief printf-style write()
+ */
+esp_err_t print(Context *ctx, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Adapter to use write() as a JsonWriter sink (ctx is the Context)
+ */
+bool jsonSink(void *ctx, const char *data, size_t len);
 
 /**
  * @brief Register response callback for a medium
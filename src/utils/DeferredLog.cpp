@@ -0,0 +1,213 @@
+#include "DeferredLog.h"
+#include "Housekeeping.h"
+#include "esp_timer.h"
+#include <cstdio>
+
+static const char *TAG = "DeferredLog";
+
+// Records rendered per job run; the job runs again at once if more remain
+static const size_t RENDER_BATCH = 16;
+
+// Rendered later than this, the line says how long ago it was written
+static const uint32_t LATE_MS = 50;
+
+namespace DeferredLog {
+
+static_assert((RING_RECORDS & (RING_RECORDS - 1)) == 0,
+              "RING_RECORDS must be a power of two");
+
+struct Record {
+  const Site *site;
+  const char *tag;
+  uint32_t timeMs;
+  uint32_t suppressed;
+  uintptr_t args[MAX_ARGS];
+};
+
+// Bounded MPMC queue with a sequence number per slot (used here with one
+// consumer). A slot is free for write position pos when its sequence is
+// pos, and holds the record of pos when it is pos + 1. The sequence is
+// stored relative to the slot index so the zero-initialized ring is ready
+// before init(), for records written during early boot.
+struct Slot {
+  std::atomic<uint32_t> seq;
+  Record record;
+};
+
+static Slot s_ring[RING_RECORDS] = {};
+static std::atomic<uint32_t> s_writePos{0};
+static uint32_t s_readPos = 0; // Renderer only
+static std::atomic<bool> s_wakeArmed{false};
+static Housekeeping::JobId s_job = Housekeeping::INVALID_JOB;
+static std::atomic<SinkFn> s_sink{nullptr};
+static esp_log_level_t s_sinkLevel = ESP_LOG_WARN;
+
+static std::atomic<uint32_t> s_written{0};
+static std::atomic<uint32_t> s_dropped{0};
+static std::atomic<uint32_t> s_suppressed{0};
+static uint32_t s_rendered = 0;
+static uint32_t s_forwarded = 0;
+static uint32_t s_maxQueued = 0;
+
+static uint32_t slotSeq(uint32_t pos) {
+  return s_ring[pos % RING_RECORDS].seq.load(std::memory_order_acquire) +
+         (uint32_t)(pos % RING_RECORDS);
+}
+
+static void setSlotSeq(uint32_t pos, uint32_t seq) {
+  s_ring[pos % RING_RECORDS].seq.store(seq - (uint32_t)(pos % RING_RECORDS),
+                                       std::memory_order_release);
+}
+
+static bool push(const Record &record) {
+  uint32_t pos = s_writePos.load(std::memory_order_relaxed);
+  while (true) {
+    int32_t diff = (int32_t)(slotSeq(pos) - pos);
+    if (diff == 0) {
+      if (s_writePos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false; // Full
+    } else {
+      pos = s_writePos.load(std::memory_order_relaxed);
+    }
+  }
+  s_ring[pos % RING_RECORDS].record = record;
+  setSlotSeq(pos, pos + 1);
+  return true;
+}
+
+static bool pop(Record *record) {
+  if ((int32_t)(slotSeq(s_readPos) - (s_readPos + 1)) < 0) {
+    return false; // Empty, or the next record is still being written
+  }
+  *record = s_ring[s_readPos % RING_RECORDS].record;
+  setSlotSeq(s_readPos, s_readPos + RING_RECORDS);
+  s_readPos++;
+  return true;
+}
+
+void post(Site *site, const char *tag, const uintptr_t *args, size_t argc) {
+  int64_t now = esp_timer_get_time();
+  int64_t last = site->lastUs.load(std::memory_order_relaxed);
+  if (site->intervalMs > 0 && last >= 0 &&
+      now - last < (int64_t)site->intervalMs * 1000) {
+    site->suppressed.fetch_add(1, std::memory_order_relaxed);
+    s_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  site->lastUs.store(now, std::memory_order_relaxed);
+
+  Record record;
+  record.site = site;
+  record.tag = tag;
+  record.timeMs = (uint32_t)(now / 1000);
+  record.suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < MAX_ARGS; i++) {
+    record.args[i] = (i < argc) ? args[i] : 0;
+  }
+
+  if (!push(record)) {
+    // Counted on the site again so the next record still reports them
+    site->suppressed.fetch_add(record.suppressed + 1, std::memory_order_relaxed);
+    s_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  s_written.fetch_add(1, std::memory_order_relaxed);
+
+  Housekeeping::JobId job = s_job;
+  if (job != Housekeeping::INVALID_JOB && !s_wakeArmed.exchange(true)) {
+    Housekeeping::notify(job);
+  }
+}
+
+static void render(const Record &record) {
+  const Site *site = record.site;
+  char text[LINE_SIZE];
+  int len = snprintf(text, sizeof(text), site->fmt, record.args[0],
+                     record.args[1], record.args[2], record.args[3]);
+  len = (len < 0) ? 0 : (len >= (int)sizeof(text)) ? (int)sizeof(text) - 1 : len;
+  if (record.suppressed > 0) {
+    len += snprintf(text + len, sizeof(text) - len, " (+%lu suppressed)",
+                    (unsigned long)record.suppressed);
+  }
+  uint32_t age = (uint32_t)(esp_timer_get_time() / 1000) - record.timeMs;
+  if (age >= LATE_MS && len < (int)sizeof(text)) {
+    snprintf(text + len, sizeof(text) - len, " [%lu ms ago]",
+             (unsigned long)age);
+  }
+
+  ESP_LOG_LEVEL(site->level, record.tag, "%s", text);
+  s_rendered++;
+
+  SinkFn sink = s_sink.load();
+  if (sink && site->level != ESP_LOG_NONE && site->level <= s_sinkLevel) {
+    Line line = {site->level, record.tag, record.timeMs, record.suppressed,
+                 text};
+    sink(line);
+    s_forwarded++;
+  }
+}
+
+// Renders at most @p max records; returns true if more are queued
+static bool drain(size_t max) {
+  uint32_t queued = s_writePos.load(std::memory_order_relaxed) - s_readPos;
+  if (queued > s_maxQueued) {
+    s_maxQueued = queued;
+  }
+  Record record;
+  for (size_t n = 0; n < max; n++) {
+    if (!pop(&record)) {
+      return false;
+    }
+    render(record);
+  }
+  return s_writePos.load(std::memory_order_relaxed) != s_readPos;
+}
+
+static uint32_t renderJob(void *ctx) {
+  (void)ctx;
+  s_wakeArmed.store(false);
+  return drain(RENDER_BATCH) ? 0 : Housekeeping::IDLE;
+}
+
+esp_err_t init() {
+  if (s_job != Housekeeping::INVALID_JOB) {
+    return ESP_OK;
+  }
+  Housekeeping::JobId job = Housekeeping::INVALID_JOB;
+  esp_err_t ret = Housekeeping::add("log_render", renderJob, nullptr, 0, &job);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register renderer: %s", esp_err_to_name(ret));
+    return ret;
+  }
+  s_job = job;
+  return ESP_OK;
+}
+
+void setSink(SinkFn sink, esp_log_level_t minLevel) {
+  s_sinkLevel = minLevel;
+  s_sink.store(sink);
+}
+
+void flush() {
+  while (drain(RENDER_BATCH)) {
+  }
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  stats->written = s_written.load();
+  stats->rendered = s_rendered;
+  stats->dropped = s_dropped.load();
+  stats->suppressed = s_suppressed.load();
+  stats->forwarded = s_forwarded;
+  stats->maxQueued = s_maxQueued;
+  return ESP_OK;
+}
+
+} // namespace DeferredLog
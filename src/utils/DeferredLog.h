@@ -0,0 +1,153 @@
+#pragma once
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief DeferredLog - Non-blocking logging for the capture hot paths
+ *
+ * ESP_LOGx formats the line and writes it to UART0 on the calling task,
+ * which blocks for the whole line at 115200 baud. On the capture tasks that
+ * is lost input, and the messages worth logging there (ring overflow) come
+ * exactly when the line is busiest.
+ *
+ * DLOGE/DLOGW/DLOGI instead store a record of a few words in a lock-free
+ * RAM ring: the call site (level, format) plus up to MAX_ARGS arguments,
+ * each an integer or a pointer. Nothing is formatted on the caller. A
+ * housekeeping job renders the records later through ESP_LOG_LEVEL, so the
+ * usual level filtering applies, and hands warnings and errors to an
+ * optional sink (MQTT).
+ *
+ * Every call site is rate limited: after a record, further calls within
+ * its interval only count, and the next record carries the count
+ * ("+N suppressed"). When the ring is full the record is dropped and
+ * counted; the caller never waits.
+ *
+ * Format arguments must be integers or pointers that stay valid (string
+ * literals, static buffers): they are read when the record is rendered.
+ */
+
+namespace DeferredLog {
+
+/// Records the ring holds (power of two)
+constexpr size_t RING_RECORDS = 64;
+
+/// Format arguments per record
+constexpr size_t MAX_ARGS = 4;
+
+/// Default rate limit of a call site
+constexpr uint32_t DEFAULT_INTERVAL_MS = 1000;
+
+/// Rendered text, message only (the tag is separate)
+constexpr size_t LINE_SIZE = 160;
+
+/// One call site (a static per DLOGx use)
+struct Site {
+    esp_log_level_t level;
+    const char* fmt;
+    uint32_t intervalMs;               ///< 0 = no rate limit
+    std::atomic<int64_t> lastUs{-1};   ///< Time of the last record
+    std::atomic<uint32_t> suppressed{0};
+};
+
+/// A rendered record, as given to the sink
+struct Line {
+    esp_log_level_t level;
+    const char* tag;
+    uint32_t timeMs;     ///< Time of the call (esp_timer)
+    uint32_t suppressed; ///< Calls folded into this one by the rate limit
+    const char* text;
+};
+
+/**
+ * @brief Sink for rendered records, on the housekeeping task
+ *
+ * Must not block (e.g. MqttManager::sendBinary, not publish).
+ */
+typedef void (*SinkFn)(const Line& line);
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t written;    ///< Records stored in the ring
+    uint32_t rendered;   ///< Records rendered
+    uint32_t dropped;    ///< Lost because the ring was full
+    uint32_t suppressed; ///< Calls folded by the rate limit
+    uint32_t forwarded;  ///< Records given to the sink
+    uint32_t maxQueued;  ///< Most records waiting at once
+};
+
+/**
+ * @brief Register the renderer job (records written before are kept)
+ */
+esp_err_t init();
+
+/**
+ * @brief Forward records at @p minLevel or more severe to @p sink
+ *        (nullptr to stop)
+ */
+void setSink(SinkFn sink, esp_log_level_t minLevel);
+
+/**
+ * @brief Render everything queued now, on the calling task
+ *
+ * Only without init() (host tests): the ring has a single reader, which
+ * is otherwise the housekeeping job.
+ */
+void flush();
+
+/**
+ * @brief Get logger statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+/**
+ * @brief Store a record (use the DLOGx macros)
+ *
+ * Safe from any task, never blocks. Not for ISRs.
+ */
+void post(Site* site, const char* tag, const uintptr_t* args, size_t argc);
+
+template <typename T> inline uintptr_t toArg(T value) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value ||
+                      std::is_pointer<T>::value,
+                  "DeferredLog arguments must be integers or pointers");
+    static_assert(sizeof(T) <= sizeof(uintptr_t),
+                  "DeferredLog arguments must fit in a pointer");
+    if constexpr (std::is_pointer<T>::value) {
+        return (uintptr_t)value;
+    } else {
+        return (uintptr_t)(intptr_t)value; // Sign-extended for %d
+    }
+}
+
+template <typename... Args>
+inline void write(Site* site, const char* tag, Args... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "Too many DeferredLog arguments");
+    const uintptr_t values[MAX_ARGS + 1] = {toArg(args)...};
+    post(site, tag, values, sizeof...(Args));
+}
+
+} // namespace DeferredLog
+
+/**
+ * @brief Deferred ESP_LOGx with a rate limit of @p intervalMs per call site
+ */
+#define DLOG_LEVEL(level, intervalMs, tag, format, ...)                        \
+    do {                                                                       \
+        static DeferredLog::Site dlogSite{level, format, intervalMs};          \
+        DeferredLog::write(&dlogSite, tag, ##__VA_ARGS__);                     \
+    } while (0)
+
+#define DLOGE(tag, format, ...)                                                \
+    DLOG_LEVEL(ESP_LOG_ERROR, DeferredLog::DEFAULT_INTERVAL_MS, tag, format,   \
+               ##__VA_ARGS__)
+#define DLOGW(tag, format, ...)                                                \
+    DLOG_LEVEL(ESP_LOG_WARN, DeferredLog::DEFAULT_INTERVAL_MS, tag, format,    \
+               ##__VA_ARGS__)
+#define DLOGI(tag, format, ...)                                                \
+    DLOG_LEVEL(ESP_LOG_INFO, DeferredLog::DEFAULT_INTERVAL_MS, tag, format,    \
+               ##__VA_ARGS__)
@@ -0,0 +1,286 @@
+#include "Housekeeping.h"
+#include "MemoryPlan.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include <cstring>
+
+static const char *TAG = "Housekeeping";
+
+// Low priority, and off Core 1 so the pipeline writer and the flash program
+// task are not interrupted by background wakeups. Large enough for the
+// jobs that touch NVS (factory reset) or restart the MQTT client.
+static const uint32_t TASK_STACK = 4096;
+static const UBaseType_t TASK_PRIORITY = tskIDLE_PRIORITY + 1;
+static const BaseType_t TASK_CORE = 0;
+
+// Deadline of an idle job
+static const int64_t NEVER = INT64_MAX;
+
+namespace Housekeeping {
+
+struct Job {
+  bool used;
+  const char *name;
+  JobFn fn;
+  void *ctx;
+  int64_t dueUs; // NEVER while idle
+  JobStats stats;
+};
+
+static Job s_jobs[MAX_JOBS] = {};
+static uint32_t s_pending = 0; // notify() bits, one per job
+static JobId s_running = INVALID_JOB;
+static TaskHandle_t s_taskHandle = nullptr;
+static bool s_started = false;
+static uint32_t s_wakeups = 0;
+static uint64_t s_busyUs = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static_assert(MAX_JOBS <= 32, "One pending bit per job");
+
+static void housekeepingTask(void *arg);
+
+static bool validId(JobId id) { return id >= 0 && id < (JobId)MAX_JOBS; }
+
+static int64_t deadline(uint32_t delayMs) {
+  if (delayMs == IDLE) {
+    return NEVER;
+  }
+  return esp_timer_get_time() + (int64_t)delayMs * 1000;
+}
+
+static void wake() {
+  if (s_taskHandle) {
+    xTaskNotifyGive(s_taskHandle);
+  }
+}
+
+esp_err_t init() {
+  portENTER_CRITICAL(&s_lock);
+  bool started = s_started;
+  s_started = true;
+  portEXIT_CRITICAL(&s_lock);
+  if (started) {
+    return ESP_OK;
+  }
+
+  if (MemoryPlan::createTask(MemoryPlan::Region::TASK_HOUSEKEEPING,
+                             housekeepingTask, "housekeeping", TASK_STACK,
+                             nullptr, TASK_PRIORITY, &s_taskHandle,
+                             TASK_CORE) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create housekeeping task");
+    portENTER_CRITICAL(&s_lock);
+    s_started = false;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
+esp_err_t add(const char *name, JobFn fn, void *ctx, uint32_t firstRunMs,
+              JobId *id) {
+  if (!fn || !id) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_err_t ret = init();
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  JobId slot = INVALID_JOB;
+  portENTER_CRITICAL(&s_lock);
+  for (size_t i = 0; i < MAX_JOBS; i++) {
+    if (!s_jobs[i].used) {
+      slot = (JobId)i;
+      Job &job = s_jobs[i];
+      job = {};
+      job.used = true;
+      job.name = name ? name : "?";
+      job.fn = fn;
+      job.ctx = ctx;
+      job.dueUs = deadline(firstRunMs);
+      job.stats.name = job.name;
+      s_pending &= ~(1u << i);
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&s_lock);
+
+  if (slot == INVALID_JOB) {
+    ESP_LOGE(TAG, "Job table full, %s not registered", name ? name : "?");
+    return ESP_ERR_NO_MEM;
+  }
+  *id = slot;
+  wake();
+  return ESP_OK;
+}
+
+void remove(JobId id) {
+  if (!validId(id)) {
+    return;
+  }
+  portENTER_CRITICAL(&s_lock);
+  s_jobs[id].used = false;
+  s_pending &= ~(1u << id);
+  portEXIT_CRITICAL(&s_lock);
+
+  // A run already in progress finishes first
+  if (xTaskGetCurrentTaskHandle() != s_taskHandle) {
+    while (s_running == id) {
+      vTaskDelay(pdMS_TO_TICKS(1));
+    }
+  }
+}
+
+void notify(JobId id) {
+  if (!validId(id)) {
+    return;
+  }
+  portENTER_CRITICAL(&s_lock);
+  if (s_jobs[id].used) {
+    s_pending |= 1u << id;
+    s_jobs[id].stats.notifies++;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  wake();
+}
+
+void notifyFromIsr(JobId id, BaseType_t *woken) {
+  if (!validId(id)) {
+    return;
+  }
+  portENTER_CRITICAL_ISR(&s_lock);
+  s_pending |= 1u << id;
+  portEXIT_CRITICAL_ISR(&s_lock);
+  if (s_taskHandle) {
+    vTaskNotifyGiveFromISR(s_taskHandle, woken);
+  }
+}
+
+void schedule(JobId id, uint32_t delayMs) {
+  if (!validId(id)) {
+    return;
+  }
+  int64_t due = deadline(delayMs);
+  portENTER_CRITICAL(&s_lock);
+  if (s_jobs[id].used) {
+    s_jobs[id].dueUs = due;
+    s_jobs[id].stats.notifies++;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  wake();
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(stats, 0, sizeof(*stats));
+  portENTER_CRITICAL(&s_lock);
+  stats->wakeups = s_wakeups;
+  stats->busyUs = s_busyUs;
+  for (size_t i = 0; i < MAX_JOBS; i++) {
+    const Job &job = s_jobs[i];
+    if (!job.used) {
+      continue;
+    }
+    JobStats &out = stats->job[stats->jobs++];
+    out = job.stats;
+    out.nextRunUs = (s_pending & (1u << i)) ? esp_timer_get_time()
+                    : (job.dueUs == NEVER)  ? -1
+                                            : job.dueUs;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+// Run one job if it is due, then apply its next deadline
+static void runJob(JobId id, int64_t now) {
+  portENTER_CRITICAL(&s_lock);
+  Job &job = s_jobs[id];
+  uint32_t bit = 1u << id;
+  if (!job.used || (!(s_pending & bit) && job.dueUs > now)) {
+    portEXIT_CRITICAL(&s_lock);
+    return;
+  }
+  s_pending &= ~bit;
+  job.dueUs = NEVER; // schedule() during the run sets a new one
+  JobFn fn = job.fn;
+  void *ctx = job.ctx;
+  s_running = id;
+  portEXIT_CRITICAL(&s_lock);
+
+  int64_t start = esp_timer_get_time();
+  uint32_t nextMs = fn(ctx);
+  int64_t end = esp_timer_get_time();
+  uint32_t elapsed = (uint32_t)(end - start);
+
+  portENTER_CRITICAL(&s_lock);
+  if (job.used && job.fn == fn) {
+    job.stats.runs++;
+    job.stats.lastRunUs = elapsed;
+    job.stats.totalRunUs += elapsed;
+    if (elapsed > job.stats.maxRunUs) {
+      job.stats.maxRunUs = elapsed;
+    }
+    if (nextMs != IDLE) {
+      int64_t due = end + (int64_t)nextMs * 1000;
+      if (due < job.dueUs) {
+        job.dueUs = due;
+      }
+    }
+  }
+  s_busyUs += elapsed;
+  s_running = INVALID_JOB;
+  portEXIT_CRITICAL(&s_lock);
+}
+
+static void housekeepingTask(void *arg) {
+  (void)arg;
+  ESP_LOGI(TAG, "Housekeeping task started on Core %d", xPortGetCoreID());
+
+  size_t first = 0;
+  while (true) {
+    // One pass over the table, starting after the job that ran first last
+    // time, so a job that keeps returning 0 cannot starve the others
+    int64_t now = esp_timer_get_time();
+    for (size_t n = 0; n < MAX_JOBS; n++) {
+      runJob((JobId)((first + n) % MAX_JOBS), now);
+    }
+    first = (first + 1) % MAX_JOBS;
+
+    // Sleep until the nearest deadline or a notify
+    int64_t next = NEVER;
+    portENTER_CRITICAL(&s_lock);
+    bool pending = s_pending != 0;
+    for (const Job &job : s_jobs) {
+      if (job.used && job.dueUs < next) {
+        next = job.dueUs;
+      }
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    TickType_t wait = portMAX_DELAY;
+    if (pending) {
+      wait = 0;
+    } else if (next != NEVER) {
+      // At least one tick, even for a job that asked to run again at once,
+      // so the idle task on this core still gets to run
+      int64_t waitUs = next - esp_timer_get_time();
+      wait = waitUs <= 0 ? 1
+                         : pdMS_TO_TICKS((uint32_t)((waitUs + 999) / 1000));
+      if (wait == 0) {
+        wait = 1;
+      }
+    }
+    if (wait != 0) {
+      ulTaskNotifyTake(pdTRUE, wait);
+      portENTER_CRITICAL(&s_lock);
+      s_wakeups++;
+      portEXIT_CRITICAL(&s_lock);
+    }
+  }
+}
+
+} // namespace Housekeeping
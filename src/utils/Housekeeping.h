@@ -0,0 +1,111 @@
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Housekeeping - One low-priority task for background jobs
+ *
+ * Background work that used to own a FreeRTOS task and wake up on a fixed
+ * sleep (flash pre-erase, BOOT button, console input, MQTT reconnect
+ * backoff) registers here as a job instead. Each job is a callback that
+ * returns when it wants to run again; the scheduler keeps one deadline per
+ * job and sleeps until the nearest one, or until a job is notified.
+ *
+ * Jobs run one at a time on the housekeeping task, so they must not block
+ * for long: a job with more work left returns 0 and runs again after the
+ * other due jobs. Long-running work (e.g. console commands) is handed off
+ * to a task of its own.
+ *
+ * Run time is measured per job and reported by getStats().
+ */
+
+namespace Housekeeping {
+
+/// Maximum number of registered jobs
+constexpr size_t MAX_JOBS = 16;
+
+/// Job return value: run again only when notified or scheduled
+constexpr uint32_t IDLE = UINT32_MAX;
+
+/// Job handle (index in the job table)
+typedef int JobId;
+
+/// No job
+constexpr JobId INVALID_JOB = -1;
+
+/**
+ * @brief Job callback, run on the housekeeping task
+ * @param ctx Context given to add()
+ * @return Milliseconds until the next run (0 = as soon as possible), or IDLE
+ */
+typedef uint32_t (*JobFn)(void* ctx);
+
+/// Per-job statistics
+struct JobStats {
+    const char* name;
+    uint32_t runs;
+    uint32_t notifies;   ///< notify()/schedule() calls
+    uint32_t lastRunUs;  ///< Duration of the last run
+    uint32_t maxRunUs;   ///< Longest run
+    uint64_t totalRunUs; ///< Time spent in the job since registration
+    int64_t nextRunUs;   ///< esp_timer time of the next run, -1 if idle
+};
+
+/// Statistics for debugging and monitoring
+struct Stats {
+    uint32_t jobs;       ///< Entries used in job[]
+    uint32_t wakeups;    ///< Times the task woke up
+    uint64_t busyUs;     ///< Time spent running jobs
+    JobStats job[MAX_JOBS];
+};
+
+/**
+ * @brief Start the housekeeping task (idempotent, also done by add())
+ * @return ESP_OK on success, ESP_FAIL if the task cannot be created
+ */
+esp_err_t init();
+
+/**
+ * @brief Register a job
+ * @param name Job name for statistics (not copied)
+ * @param fn Job callback
+ * @param ctx Context passed to fn
+ * @param firstRunMs Delay before the first run, IDLE to wait for a notify
+ * @param id Output: job handle
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the table is full
+ */
+esp_err_t add(const char* name, JobFn fn, void* ctx, uint32_t firstRunMs,
+              JobId* id);
+
+/**
+ * @brief Unregister a job, waiting for it to finish if it is running
+ *
+ * Must not be called from the job itself.
+ */
+void remove(JobId id);
+
+/**
+ * @brief Run the job as soon as possible
+ */
+void notify(JobId id);
+
+/**
+ * @brief Run the job as soon as possible (from an ISR)
+ * @param woken Set to pdTRUE if a context switch is needed
+ */
+void notifyFromIsr(JobId id, BaseType_t* woken);
+
+/**
+ * @brief Run the job after delayMs, replacing its pending deadline
+ */
+void schedule(JobId id, uint32_t delayMs);
+
+/**
+ * @brief Get scheduler and per-job statistics
+ */
+esp_err_t getStats(Stats* stats);
+
+} // namespace Housekeeping
@@ -0,0 +1,358 @@
+#include "JsonTokenizer.h"
+#include <cstring>
+
+static bool isContainer(const JsonTokenizer::Token &tok) {
+  return tok.type == JsonTokenizer::Type::OBJECT ||
+         tok.type == JsonTokenizer::Type::ARRAY;
+}
+
+// strchr() would also match the terminator
+static bool isOneOf(char c, const char *set) {
+  return c != '\0' && strchr(set, c) != nullptr;
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+JsonTokenizer::JsonTokenizer(Token *tokens, size_t maxTokens)
+    : m_tokens(tokens), m_max(tokens ? maxTokens : 0) {
+  if (m_max > INT16_MAX) {
+    m_max = INT16_MAX; // Token::parent is 16 bits
+  }
+}
+
+JsonTokenizer::Token *JsonTokenizer::alloc(Type type, uint32_t start,
+                                           int parent) {
+  if (m_count == m_max) {
+    return nullptr;
+  }
+  Token *tok = &m_tokens[m_count++];
+  tok->type = type;
+  tok->size = 0;
+  tok->parent = (int16_t)parent;
+  tok->start = start;
+  tok->end = 0;
+  if (parent >= 0) {
+    m_tokens[parent].size++;
+  }
+  return tok;
+}
+
+esp_err_t JsonTokenizer::parse(const char *json, size_t len) {
+  m_json = json;
+  m_count = 0;
+  if (!json || len > UINT32_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_err_t ret = tokenize(len);
+  if (ret != ESP_OK) {
+    m_count = 0;
+  }
+  return ret;
+}
+
+// What the grammar allows at the next non-blank byte
+enum class Expect : uint8_t {
+  VALUE,          // Top level, after ':' or after ',' in an array
+  VALUE_OR_CLOSE, // Right after '['
+  KEY,            // After ',' in an object
+  KEY_OR_CLOSE,   // Right after '{'
+  COLON,          // After a key
+  COMMA_OR_CLOSE, // After a member or an element
+  END             // After the top-level value
+};
+
+// true, false, null or a number as RFC 8259 spells it
+static bool validPrimitive(const char *p, size_t len) {
+  if ((len == 4 && memcmp(p, "true", 4) == 0) ||
+      (len == 5 && memcmp(p, "false", 5) == 0) ||
+      (len == 4 && memcmp(p, "null", 4) == 0)) {
+    return true;
+  }
+  const char *end = p + len;
+  auto digits = [&p, end]() {
+    const char *first = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+      p++;
+    }
+    return p > first;
+  };
+  if (p < end && *p == '-') {
+    p++;
+  }
+  if (p < end && *p == '0') {
+    p++; // No leading zeros
+  } else if (!digits()) {
+    return false;
+  }
+  if (p < end && *p == '.') {
+    p++;
+    if (!digits()) {
+      return false;
+    }
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    if (p < end && (*p == '+' || *p == '-')) {
+      p++;
+    }
+    if (!digits()) {
+      return false;
+    }
+  }
+  return p == end;
+}
+
+esp_err_t JsonTokenizer::tokenize(size_t len) {
+  const char *json = m_json;
+  int super = -1; // Token new tokens are attached to
+  Expect expect = Expect::VALUE;
+  // A value just ended: back from its key to the object, or done
+  auto valueDone = [this, &super, &expect]() {
+    if (super >= 0 && !isContainer(m_tokens[super])) {
+      super = m_tokens[super].parent;
+    }
+    expect = (super >= 0) ? Expect::COMMA_OR_CLOSE : Expect::END;
+  };
+  auto valueAllowed = [&expect]() {
+    return expect == Expect::VALUE || expect == Expect::VALUE_OR_CLOSE;
+  };
+
+  size_t pos = 0;
+  while (pos < len) {
+    char c = json[pos];
+    switch (c) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      pos++;
+      continue;
+
+    case '{':
+    case '[': {
+      if (!valueAllowed()) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      Token *tok = alloc(c == '{' ? Type::OBJECT : Type::ARRAY, pos, super);
+      if (!tok) {
+        return ESP_ERR_NO_MEM;
+      }
+      super = (int)m_count - 1;
+      expect = (c == '{') ? Expect::KEY_OR_CLOSE : Expect::VALUE_OR_CLOSE;
+      pos++;
+      continue;
+    }
+
+    case '}':
+    case ']': {
+      Type type = (c == '}') ? Type::OBJECT : Type::ARRAY;
+      bool emptyClose = (type == Type::OBJECT)
+                            ? expect == Expect::KEY_OR_CLOSE
+                            : expect == Expect::VALUE_OR_CLOSE;
+      // After a member or element super is its container
+      if ((expect != Expect::COMMA_OR_CLOSE && !emptyClose) ||
+          m_tokens[super].type != type) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      m_tokens[super].end = pos + 1;
+      super = m_tokens[super].parent;
+      valueDone();
+      pos++;
+      continue;
+    }
+
+    case '"': {
+      bool key = (expect == Expect::KEY || expect == Expect::KEY_OR_CLOSE);
+      if (!key && !valueAllowed()) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      size_t start = ++pos;
+      while (pos < len && json[pos] != '"') {
+        unsigned char ch = (unsigned char)json[pos];
+        if (ch < 0x20) {
+          return ESP_ERR_INVALID_ARG;
+        }
+        if (ch == '\\') {
+          if (++pos == len) {
+            return ESP_ERR_INVALID_ARG;
+          }
+          if (json[pos] == 'u') {
+            for (int k = 0; k < 4; k++) {
+              if (++pos == len || hexValue(json[pos]) < 0) {
+                return ESP_ERR_INVALID_ARG;
+              }
+            }
+          } else if (!isOneOf(json[pos], "\"\\/bfnrt")) {
+            return ESP_ERR_INVALID_ARG;
+          }
+        }
+        pos++;
+      }
+      if (pos == len) {
+        return ESP_ERR_INVALID_ARG; // Unterminated
+      }
+      Token *tok = alloc(Type::STRING, start, super);
+      if (!tok) {
+        return ESP_ERR_NO_MEM;
+      }
+      tok->end = pos;
+      if (key) {
+        expect = Expect::COLON;
+      } else {
+        valueDone();
+      }
+      pos++;
+      continue;
+    }
+
+    case ':':
+      if (expect != Expect::COLON) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      // The key just read: its value attaches to it
+      super = (int)m_count - 1;
+      expect = Expect::VALUE;
+      pos++;
+      continue;
+
+    case ',':
+      if (expect != Expect::COMMA_OR_CLOSE) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      expect = (m_tokens[super].type == Type::OBJECT) ? Expect::KEY
+                                                      : Expect::VALUE;
+      pos++;
+      continue;
+
+    default: {
+      // Number, true, false or null
+      if (!valueAllowed()) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      size_t start = pos;
+      while (pos < len && !isOneOf(json[pos], " \t\r\n,]}:")) {
+        pos++;
+      }
+      if (!validPrimitive(json + start, pos - start)) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      Token *tok = alloc(Type::PRIMITIVE, start, super);
+      if (!tok) {
+        return ESP_ERR_NO_MEM;
+      }
+      tok->end = pos;
+      valueDone();
+      continue;
+    }
+    }
+  }
+
+  // Exactly one complete top-level value
+  return (expect == Expect::END) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+int JsonTokenizer::skip(int index) const {
+  if (!isContainer(m_tokens[index])) {
+    return index + 1;
+  }
+  uint32_t end = m_tokens[index].end;
+  int next = index + 1;
+  while (next < (int)m_count && m_tokens[next].start < end) {
+    next++;
+  }
+  return next;
+}
+
+int JsonTokenizer::find(int object, const char *key) const {
+  if (object < 0 || object >= (int)m_count || !key ||
+      m_tokens[object].type != Type::OBJECT) {
+    return -1;
+  }
+  int keyIndex = object + 1;
+  for (uint16_t k = 0; k < m_tokens[object].size; k++) {
+    if (keyIndex + 1 >= (int)m_count) {
+      break;
+    }
+    if (equals(keyIndex, key)) {
+      return keyIndex + 1;
+    }
+    keyIndex = skip(keyIndex + 1);
+  }
+  return -1;
+}
+
+bool JsonTokenizer::equals(int index, const char *str) const {
+  if (index < 0 || index >= (int)m_count || !str ||
+      m_tokens[index].type != Type::STRING) {
+    return false;
+  }
+  const Token &tok = m_tokens[index];
+  size_t len = tok.end - tok.start;
+  return strlen(str) == len && memcmp(m_json + tok.start, str, len) == 0;
+}
+
+esp_err_t JsonTokenizer::copyString(int index, char *out,
+                                    size_t outSize) const {
+  if (index < 0 || index >= (int)m_count ||
+      m_tokens[index].type != Type::STRING) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (!out || outSize == 0) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  const Token &tok = m_tokens[index];
+  size_t n = 0;
+  for (uint32_t i = tok.start; i < tok.end; i++) {
+    char utf8[3];
+    size_t utf8Len = 1;
+    utf8[0] = m_json[i];
+    if (utf8[0] == '\\') {
+      char esc = m_json[++i]; // parse() checked every escape
+      switch (esc) {
+      case 'b': utf8[0] = '\b'; break;
+      case 'f': utf8[0] = '\f'; break;
+      case 'n': utf8[0] = '\n'; break;
+      case 'r': utf8[0] = '\r'; break;
+      case 't': utf8[0] = '\t'; break;
+      case 'u': {
+        uint32_t cp = 0;
+        for (int k = 0; k < 4; k++) {
+          cp = (cp << 4) | (uint32_t)hexValue(m_json[++i]);
+        }
+        // Basic plane only; surrogate pairs come out as two sequences
+        if (cp < 0x80) {
+          utf8[0] = (char)cp;
+        } else if (cp < 0x800) {
+          utf8[0] = (char)(0xC0 | (cp >> 6));
+          utf8[1] = (char)(0x80 | (cp & 0x3F));
+          utf8Len = 2;
+        } else {
+          utf8[0] = (char)(0xE0 | (cp >> 12));
+          utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+          utf8[2] = (char)(0x80 | (cp & 0x3F));
+          utf8Len = 3;
+        }
+        break;
+      }
+      default: utf8[0] = esc; break; // \" \\ and \/
+      }
+    }
+    if (n + utf8Len >= outSize) {
+      out[0] = '\0';
+      return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(out + n, utf8, utf8Len);
+    n += utf8Len;
+  }
+  out[n] = '\0';
+  return ESP_OK;
+}
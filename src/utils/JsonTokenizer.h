@@ -0,0 +1,91 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief JsonTokenizer - In-place JSON tokenizer with no heap use
+ *
+ * Splits a JSON document into a caller-provided token array (jsmn style)
+ * without copying or allocating: every token is an offset range into the
+ * original buffer, which does not need to be NUL-terminated. Tokens are
+ * stored in document order, so a value always directly follows its key and
+ * the children of a container follow the container.
+ *
+ * Meant for small documents where only a few fields are read, such as MQTT
+ * commands; strings are only unescaped when copied out with copyString().
+ *
+ * @code
+ *   JsonTokenizer::Token tokens[32];
+ *   JsonTokenizer json(tokens, 32);
+ *   if (json.parse(payload, len) == ESP_OK) {
+ *     char command[32];
+ *     json.copyString(json.find(0, "command"), command, sizeof(command));
+ *   }
+ * @endcode
+ */
+class JsonTokenizer {
+public:
+  enum class Type : uint8_t {
+    OBJECT,    ///< {...}
+    ARRAY,     ///< [...]
+    STRING,    ///< Range excludes the quotes, escapes are left as is
+    PRIMITIVE  ///< Number, true, false or null
+  };
+
+  struct Token {
+    Type type;
+    uint16_t size;  ///< Keys of an object, elements of an array, 1 for a key
+    int16_t parent; ///< Index of the enclosing token, -1 at top level
+    uint32_t start; ///< First byte in the document
+    uint32_t end;   ///< One past the last byte (0 while a container is open)
+  };
+
+  JsonTokenizer(Token *tokens, size_t maxTokens);
+
+  JsonTokenizer(const JsonTokenizer &) = delete;
+  JsonTokenizer &operator=(const JsonTokenizer &) = delete;
+
+  /**
+   * @brief Tokenize a document
+   *
+   * @p json must stay valid while the tokens are used. The document must
+   * be exactly one JSON value: members need their ':' and value and are
+   * separated by commas, and numbers and literals are checked as well.
+   * @return ESP_OK, ESP_ERR_NO_MEM if the token array is too small,
+   *         ESP_ERR_INVALID_ARG if the document is malformed or incomplete
+   */
+  esp_err_t parse(const char *json, size_t len);
+
+  /// Tokens produced by the last successful parse()
+  size_t count() const { return m_count; }
+  const Token &token(size_t index) const { return m_tokens[index]; }
+
+  /**
+   * @brief Find a key in an object
+   * @param object Index of an OBJECT token (0 for the document root)
+   * @return Index of the key's value token, -1 if absent
+   */
+  int find(int object, const char *key) const;
+
+  /// Check if a STRING token holds exactly @p str (no unescaping)
+  bool equals(int index, const char *str) const;
+
+  /**
+   * @brief Copy a STRING token out, unescaped and NUL-terminated
+   * @return ESP_OK, ESP_ERR_NOT_FOUND if @p index is not a string (or -1),
+   *         ESP_ERR_INVALID_SIZE if it does not fit in @p outSize
+   */
+  esp_err_t copyString(int index, char *out, size_t outSize) const;
+
+private:
+  Token *m_tokens;
+  size_t m_max;
+  size_t m_count = 0;
+  const char *m_json = nullptr;
+
+  esp_err_t tokenize(size_t len);
+  Token *alloc(Type type, uint32_t start, int parent);
+  int skip(int index) const;
+};
@@ -0,0 +1,282 @@
+#include "JsonWriter.h"
+#include <cmath>
+#include <cstring>
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+JsonWriter::JsonWriter(char *buf, size_t size) : m_buf(buf), m_size(size) {
+  if (!buf || size == 0) {
+    m_buf = nullptr;
+    m_size = 0;
+    m_status = ESP_ERR_INVALID_ARG;
+  } else {
+    m_size = size - 1; // Room for the terminator
+    m_buf[0] = '\0';
+  }
+}
+
+JsonWriter::JsonWriter(char *buf, size_t size, Sink sink, void *ctx)
+    : m_buf(buf), m_size(size), m_sink(sink), m_ctx(ctx) {
+  if (!buf || size == 0 || !sink) {
+    m_size = 0;
+    m_status = ESP_ERR_INVALID_ARG;
+  }
+}
+
+// --- Output ---
+
+bool JsonWriter::flush() {
+  if (m_pos == 0) {
+    return true;
+  }
+  if (!m_sink(m_ctx, m_buf, m_pos)) {
+    m_status = ESP_FAIL;
+    return false;
+  }
+  m_flushed += m_pos;
+  m_pos = 0;
+  return true;
+}
+
+void JsonWriter::put(char c) {
+  if (m_status != ESP_OK) {
+    return;
+  }
+  if (m_pos == m_size) {
+    if (!m_sink) {
+      m_status = ESP_ERR_NO_MEM;
+      return;
+    }
+    if (!flush()) {
+      return;
+    }
+  }
+  m_buf[m_pos++] = c;
+}
+
+void JsonWriter::write(const char *data, size_t len) {
+  while (len > 0 && m_status == ESP_OK) {
+    if (m_pos == m_size) {
+      if (!m_sink) {
+        m_status = ESP_ERR_NO_MEM;
+        return;
+      }
+      if (!flush()) {
+        return;
+      }
+    }
+    size_t n = m_size - m_pos;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(m_buf + m_pos, data, n);
+    m_pos += n;
+    data += n;
+    len -= n;
+  }
+}
+
+// Copies runs of plain characters in one go and escapes the rest
+void JsonWriter::writeEscaped(const char *str, size_t len) {
+  put('"');
+  size_t runStart = 0;
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)str[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    write(str + runStart, i - runStart);
+    runStart = i + 1;
+    char esc[6] = {'\\', 0};
+    size_t escLen = 2;
+    switch (c) {
+    case '"':  esc[1] = '"';  break;
+    case '\\': esc[1] = '\\'; break;
+    case '\n': esc[1] = 'n';  break;
+    case '\r': esc[1] = 'r';  break;
+    case '\t': esc[1] = 't';  break;
+    case '\b': esc[1] = 'b';  break;
+    case '\f': esc[1] = 'f';  break;
+    default:
+      esc[1] = 'u';
+      esc[2] = '0';
+      esc[3] = '0';
+      esc[4] = HEX_DIGITS[c >> 4];
+      esc[5] = HEX_DIGITS[c & 0x0F];
+      escLen = 6;
+      break;
+    }
+    write(esc, escLen);
+  }
+  write(str + runStart, len - runStart);
+  put('"');
+}
+
+void JsonWriter::writeUnsigned(uint64_t v) {
+  char digits[20];
+  size_t n = 0;
+  do {
+    digits[sizeof(digits) - 1 - n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v > 0);
+  write(digits + sizeof(digits) - n, n);
+}
+
+// --- Structure ---
+
+void JsonWriter::separate() {
+  if (m_afterKey) {
+    m_afterKey = false;
+  } else if (m_needComma) {
+    put(',');
+  }
+  m_needComma = true;
+}
+
+void JsonWriter::open(char c) {
+  separate();
+  if (m_depth == MAX_DEPTH) {
+    if (m_status == ESP_OK) {
+      m_status = ESP_ERR_NO_MEM;
+    }
+    return;
+  }
+  m_depth++;
+  put(c);
+  m_needComma = false;
+}
+
+void JsonWriter::close(char c) {
+  if (m_depth > 0) {
+    m_depth--;
+  }
+  put(c);
+  m_needComma = true;
+  m_afterKey = false;
+}
+
+void JsonWriter::beginObject() { open('{'); }
+void JsonWriter::endObject() { close('}'); }
+void JsonWriter::beginArray() { open('['); }
+void JsonWriter::endArray() { close(']'); }
+
+void JsonWriter::key(const char *name) {
+  separate();
+  writeEscaped(name, strlen(name));
+  put(':');
+  m_afterKey = true;
+}
+
+// --- Values ---
+
+void JsonWriter::value(const char *str) {
+  if (!str) {
+    valueNull();
+    return;
+  }
+  value(str, strlen(str));
+}
+
+void JsonWriter::value(const char *str, size_t len) {
+  separate();
+  writeEscaped(str, len);
+}
+
+void JsonWriter::value(bool b) {
+  separate();
+  if (b) {
+    write("true", 4);
+  } else {
+    write("false", 5);
+  }
+}
+
+void JsonWriter::value(long long v) {
+  separate();
+  if (v < 0) {
+    put('-');
+    writeUnsigned(0 - (uint64_t)v);
+  } else {
+    writeUnsigned((uint64_t)v);
+  }
+}
+
+void JsonWriter::value(unsigned long long v) {
+  separate();
+  writeUnsigned(v);
+}
+
+void JsonWriter::value(double v, uint8_t decimals) {
+  // Beyond 2^63 fixed notation stops making sense for telemetry
+  if (std::isnan(v) || std::isinf(v) || std::fabs(v) >= 9.2e18) {
+    valueNull();
+    return;
+  }
+  if (decimals > 9) {
+    decimals = 9;
+  }
+  separate();
+
+  uint64_t scale = 1;
+  for (uint8_t i = 0; i < decimals; i++) {
+    scale *= 10;
+  }
+  double mag = std::fabs(v);
+  uint64_t whole = (uint64_t)mag;
+  uint64_t frac = (uint64_t)((mag - (double)whole) * (double)scale + 0.5);
+  if (frac >= scale) { // Rounded up into the next integer
+    whole++;
+    frac -= scale;
+  }
+  if (v < 0 && (whole > 0 || frac > 0)) {
+    put('-');
+  }
+  writeUnsigned(whole);
+  if (decimals > 0) {
+    char digits[10];
+    digits[0] = '.';
+    for (uint8_t i = decimals; i > 0; i--) {
+      digits[i] = (char)('0' + frac % 10);
+      frac /= 10;
+    }
+    write(digits, decimals + 1);
+  }
+}
+
+void JsonWriter::valueNull() {
+  separate();
+  write("null", 4);
+}
+
+void JsonWriter::valueIp(const uint8_t addr[4]) {
+  separate();
+  put('"');
+  for (int i = 0; i < 4; i++) {
+    if (i > 0) {
+      put('.');
+    }
+    writeUnsigned(addr[i]);
+  }
+  put('"');
+}
+
+void JsonWriter::raw(const char *json, size_t len) {
+  separate();
+  write(json, len);
+}
+
+void JsonWriter::raw(const char *json) { raw(json, strlen(json)); }
+
+esp_err_t JsonWriter::finish() {
+  if (m_status == ESP_OK && m_depth != 0) {
+    m_status = ESP_ERR_INVALID_STATE; // Unbalanced begin/end
+  }
+  if (m_sink) {
+    if (m_status == ESP_OK) {
+      flush();
+    }
+  } else if (m_buf) {
+    m_buf[m_pos] = '\0';
+  }
+  return m_status;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief JsonWriter - Streaming JSON emitter with no heap use
+ *
+ * Writes JSON straight into a caller buffer. In buffer mode the whole
+ * document must fit; in sink mode the buffer is only a staging area that
+ * is handed to the sink each time it fills (e.g. httpd_resp_send_chunk),
+ * so documents of any size stream out through a few hundred bytes.
+ *
+ * Commas and nesting are tracked by the writer, strings are escaped in a
+ * single pass and numbers are formatted without printf. Running out of
+ * space, or a sink refusing data, is sticky: later calls do nothing and
+ * status() reports it, so callers check once at the end instead of after
+ * every field.
+ *
+ * @code
+ *   JsonWriter json(buf, sizeof(buf));
+ *   json.beginObject();
+ *   json.field("status", "ok");
+ *   json.field("bytes", stats.usedBytes);
+ *   json.endObject();
+ *   if (json.finish() != ESP_OK) { ... truncated ... }
+ * @endcode
+ */
+class JsonWriter {
+public:
+  /**
+   * @brief Output callback for sink mode
+   * @return false to abort the document (reported as ESP_FAIL)
+   */
+  typedef bool (*Sink)(void *ctx, const char *data, size_t len);
+
+  /// Deepest object/array nesting supported
+  static constexpr size_t MAX_DEPTH = 16;
+
+  /**
+   * @brief Buffer mode: the document is built in @p buf
+   *
+   * finish() NUL-terminates it; one byte of @p size is kept for that.
+   */
+  JsonWriter(char *buf, size_t size);
+
+  /**
+   * @brief Sink mode: @p buf stages output for @p sink
+   */
+  JsonWriter(char *buf, size_t size, Sink sink, void *ctx);
+
+  JsonWriter(const JsonWriter &) = delete;
+  JsonWriter &operator=(const JsonWriter &) = delete;
+
+  void beginObject();
+  void endObject();
+  void beginArray();
+  void endArray();
+
+  /// Object key; the next value call supplies its value
+  void key(const char *name);
+
+  void value(const char *str); ///< String (nullptr writes null)
+  void value(const char *str, size_t len);
+  void value(bool b);
+  // Every integer type, so size_t, uint32_t and friends resolve on any target
+  void value(int v) { value((long long)v); }
+  void value(unsigned v) { value((unsigned long long)v); }
+  void value(long v) { value((long long)v); }
+  void value(unsigned long v) { value((unsigned long long)v); }
+  void value(long long v);
+  void value(unsigned long long v);
+  void value(double v, uint8_t decimals = 6); ///< NaN and infinity write null
+  void valueNull();
+
+  /// IPv4 address as "a.b.c.d"
+  void valueIp(const uint8_t addr[4]);
+
+  /// Pre-built JSON value, copied as is
+  void raw(const char *json, size_t len);
+  void raw(const char *json);
+
+  /// key() followed by value()
+  template <typename T> void field(const char *name, T v) {
+    key(name);
+    value(v);
+  }
+  void field(const char *name, double v, uint8_t decimals) {
+    key(name);
+    value(v, decimals);
+  }
+
+  /**
+   * @brief End the document
+   *
+   * Flushes the remaining output to the sink (sink mode) or terminates the
+   * buffer (buffer mode).
+   * @return ESP_OK, ESP_ERR_NO_MEM if the buffer filled up (buffer mode) or
+   *         nesting overflowed, ESP_ERR_INVALID_STATE if a begin has no
+   *         matching end, ESP_FAIL if the sink refused data
+   */
+  esp_err_t finish();
+
+  /// Error so far (see finish())
+  esp_err_t status() const { return m_status; }
+
+  /// Bytes produced so far, including those already passed to the sink
+  size_t length() const { return m_flushed + m_pos; }
+
+  /// Document text (buffer mode, after finish())
+  const char *c_str() const { return m_buf; }
+
+private:
+  char *m_buf;
+  size_t m_size;
+  size_t m_pos = 0;
+  size_t m_flushed = 0;
+  Sink m_sink = nullptr;
+  void *m_ctx = nullptr;
+  esp_err_t m_status = ESP_OK;
+  uint8_t m_depth = 0;
+  bool m_needComma = false;
+  bool m_afterKey = false;
+
+  void separate();
+  void open(char c);
+  void close(char c);
+  bool flush();
+  void put(char c);
+  void write(const char *data, size_t len);
+  void writeEscaped(const char *str, size_t len);
+  void writeUnsigned(uint64_t v);
+};
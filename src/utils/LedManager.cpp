@@ -7,7 +7,7 @@
 namespace LedManager {
 
 static const char *TAG = "LedManager";
-static const gpio_num_t LED_GPIO = GPIO_NUM_2; // Default onboard LED
+static gpio_num_t s_gpio = GPIO_NUM_NC;
 
 struct LedParams {
   uint32_t onTimeMs;
@@ -28,6 +28,12 @@ static esp_timer_handle_t s_ledTimer = nullptr;
 static bool s_ledOn = false;
 static bool s_dataActive = false;
 
+static void setLevel(uint32_t level) {
+  if (s_gpio != GPIO_NUM_NC) {
+    gpio_set_level(s_gpio, level);
+  }
+}
+
 static void led_timer_callback(void *arg) {
   State state = s_currentState.load();
 
@@ -40,7 +46,7 @@ static void led_timer_callback(void *arg) {
   LedParams params = s_stateParams[index];
 
   if (params.onTimeMs == 0) {
-    gpio_set_level(LED_GPIO, 0);
+    setLevel(0);
     s_ledOn = false;
     // Reschedule for a default time to check again
     esp_timer_start_once(s_ledTimer, 100000); // 100ms
@@ -48,7 +54,7 @@ static void led_timer_callback(void *arg) {
   }
 
   if (params.offTimeMs == 0) {
-    gpio_set_level(LED_GPIO, 1);
+    setLevel(1);
     s_ledOn = true;
     // Reschedule for a default time to check again
     esp_timer_start_once(s_ledTimer, 100000); // 100ms
@@ -57,20 +63,23 @@ static void led_timer_callback(void *arg) {
 
   // Toggling logic
   s_ledOn = !s_ledOn;
-  gpio_set_level(LED_GPIO, s_ledOn ? 1 : 0);
+  setLevel(s_ledOn ? 1 : 0);
 
   uint32_t nextIntervalMs = s_ledOn ? params.onTimeMs : params.offTimeMs;
   esp_timer_start_once(s_ledTimer, nextIntervalMs * 1000);
 }
 
-esp_err_t init() {
-  gpio_config_t io_conf = {};
-  io_conf.intr_type = GPIO_INTR_DISABLE;
-  io_conf.mode = GPIO_MODE_OUTPUT;
-  io_conf.pin_bit_mask = (1ULL << LED_GPIO);
-  io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-  io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
-  gpio_config(&io_conf);
+esp_err_t init(int gpio) {
+  s_gpio = gpio < 0 ? GPIO_NUM_NC : (gpio_num_t)gpio;
+  if (s_gpio != GPIO_NUM_NC) {
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_OUTPUT;
+    io_conf.pin_bit_mask = (1ULL << s_gpio);
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    gpio_config(&io_conf);
+  }
 
   const esp_timer_create_args_t timer_args = {.callback = &led_timer_callback,
                                               .name = "led_timer"};
@@ -79,7 +88,7 @@ esp_err_t init() {
   if (ret == ESP_OK) {
     s_currentState = State::STARTUP;
     esp_timer_start_once(s_ledTimer, 10000); // Start in 10ms
-    ESP_LOGI(TAG, "Initialized with GPIO %d", LED_GPIO);
+    ESP_LOGI(TAG, "Initialized with GPIO %d", (int)s_gpio);
   }
 
   return ret;
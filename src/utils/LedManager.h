@@ -18,15 +18,22 @@ enum class State {
   FACTORY_READY  ///< Continuous ON (Button >8s)
 };
 
+/// Onboard LED GPIO of many ESP32 boards
+constexpr int DEFAULT_GPIO = 2;
+
+/// No LED: states are tracked but nothing is driven
+constexpr int NO_GPIO = -1;
+
 /**
  * @brief Initialize the LED manager
  *
  * Sets up the GPIO and the hardware timer to control LED patterns.
- * Default LED GPIO is 2 (common for many ESP32 boards).
  *
+ * @param gpio LED GPIO, or NO_GPIO when the pin has another use (GPIO 2 is
+ *             the SDMMC D0 line on the ESP32)
  * @return ESP_OK on success
  */
-esp_err_t init();
+esp_err_t init(int gpio = DEFAULT_GPIO);
 
 /**
  * @brief Set the current LED state
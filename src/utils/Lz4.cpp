@@ -0,0 +1,196 @@
+#include "Lz4.h"
+#include <cstring>
+
+namespace Lz4 {
+
+// Format limits (see the LZ4 block format description)
+static const size_t MIN_MATCH = 4;
+static const size_t LAST_LITERALS = 5;  // Block always ends with literals
+static const size_t MF_LIMIT = 12;      // No match may start past len - 12
+static const size_t MAX_OFFSET = 65535;
+static const int HASH_SHIFT = 32 - 12;  // log2(HASH_ENTRIES) == 12
+
+static inline uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t hash(uint32_t v) {
+  return (v * 2654435761u) >> HASH_SHIFT;
+}
+
+// Write a length continuation (bytes of 255 followed by the remainder)
+static bool putLength(uint8_t *&op, const uint8_t *end, size_t len) {
+  while (len >= 255) {
+    if (op >= end) {
+      return false;
+    }
+    *op++ = 255;
+    len -= 255;
+  }
+  if (op >= end) {
+    return false;
+  }
+  *op++ = (uint8_t)len;
+  return true;
+}
+
+// Emit one sequence: literals, then a match (matchLen == 0 for the last one)
+static bool putSequence(uint8_t *&op, const uint8_t *end,
+                        const uint8_t *literals, size_t literalLen,
+                        size_t offset, size_t matchLen) {
+  if (op >= end) {
+    return false;
+  }
+  size_t matchCode = matchLen ? matchLen - MIN_MATCH : 0;
+  uint8_t *token = op++;
+  *token = (uint8_t)(((literalLen < 15 ? literalLen : 15) << 4) |
+                     (matchCode < 15 ? matchCode : 15));
+
+  if (literalLen >= 15 && !putLength(op, end, literalLen - 15)) {
+    return false;
+  }
+  if ((size_t)(end - op) < literalLen) {
+    return false;
+  }
+  memcpy(op, literals, literalLen);
+  op += literalLen;
+
+  if (matchLen == 0) {
+    return true;
+  }
+  if (end - op < 2) {
+    return false;
+  }
+  *op++ = (uint8_t)offset;
+  *op++ = (uint8_t)(offset >> 8);
+  return matchCode < 15 || putLength(op, end, matchCode - 15);
+}
+
+size_t compress(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity,
+                void *work) {
+  if (!src || !dst || !work || len > MAX_INPUT_SIZE) {
+    return 0;
+  }
+
+  uint16_t *table = static_cast<uint16_t *>(work);
+  memset(table, 0, WORK_SIZE);
+
+  uint8_t *op = dst;
+  const uint8_t *end = dst + capacity;
+  size_t anchor = 0;
+  size_t ip = 0;
+
+  if (len >= MF_LIMIT) {
+    size_t limit = len - MF_LIMIT;
+    size_t matchLimit = len - LAST_LITERALS;
+
+    while (ip <= limit) {
+      uint32_t h = hash(read32(src + ip));
+      size_t candidate = table[h];
+      table[h] = (uint16_t)ip;
+
+      if (candidate >= ip || ip - candidate > MAX_OFFSET ||
+          read32(src + candidate) != read32(src + ip)) {
+        ip++;
+        continue;
+      }
+
+      // Extend backwards into pending literals, then forwards
+      while (ip > anchor && candidate > 0 &&
+             src[ip - 1] == src[candidate - 1]) {
+        ip--;
+        candidate--;
+      }
+      size_t matchLen = MIN_MATCH;
+      while (ip + matchLen < matchLimit &&
+             src[candidate + matchLen] == src[ip + matchLen]) {
+        matchLen++;
+      }
+
+      if (!putSequence(op, end, src + anchor, ip - anchor, ip - candidate,
+                       matchLen)) {
+        return 0;
+      }
+      ip += matchLen;
+      anchor = ip;
+
+      // Seed the table inside the match so runs keep matching
+      if (ip >= 2 && ip - 2 <= limit) {
+        table[hash(read32(src + ip - 2))] = (uint16_t)(ip - 2);
+      }
+    }
+  }
+
+  if (!putSequence(op, end, src + anchor, len - anchor, 0, 0)) {
+    return 0;
+  }
+  return op - dst;
+}
+
+// Read a length continuation, false if it runs past the input
+static bool getLength(const uint8_t *src, size_t len, size_t &ip,
+                      size_t &value) {
+  uint8_t b;
+  do {
+    if (ip >= len) {
+      return false;
+    }
+    b = src[ip++];
+    value += b;
+  } while (b == 255);
+  return true;
+}
+
+size_t decompress(const uint8_t *src, size_t len, uint8_t *dst,
+                  size_t capacity) {
+  if (!src || !dst) {
+    return 0;
+  }
+
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < len) {
+    uint8_t token = src[ip++];
+
+    size_t literalLen = token >> 4;
+    if (literalLen == 15 && !getLength(src, len, ip, literalLen)) {
+      return 0;
+    }
+    if (literalLen > len - ip || literalLen > capacity - op) {
+      return 0;
+    }
+    memcpy(dst + op, src + ip, literalLen);
+    ip += literalLen;
+    op += literalLen;
+
+    if (ip == len) {
+      break; // Last sequence has no match
+    }
+    if (len - ip < 2) {
+      return 0;
+    }
+    size_t offset = src[ip] | (src[ip + 1] << 8);
+    ip += 2;
+
+    size_t matchLen = token & 15;
+    if (matchLen == 15 && !getLength(src, len, ip, matchLen)) {
+      return 0;
+    }
+    matchLen += MIN_MATCH;
+    if (offset == 0 || offset > op || matchLen > capacity - op) {
+      return 0;
+    }
+
+    // Byte by byte: the match may overlap the bytes it produces
+    const uint8_t *match = dst + op - offset;
+    for (size_t i = 0; i < matchLen; i++) {
+      dst[op + i] = match[i];
+    }
+    op += matchLen;
+  }
+  return op;
+}
+
+} // namespace Lz4
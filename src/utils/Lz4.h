@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Lz4 - Minimal LZ4 block codec
+ *
+ * Produces the standard LZ4 block format (no frame header), so the output
+ * can be decoded with any LZ4 implementation, e.g. LZ4_decompress_safe()
+ * or python's lz4.block.decompress(data, uncompressed_size=n).
+ *
+ * Greedy single-pass matcher with a caller-provided hash table: no heap
+ * use and a fixed 8KB of working memory, fast enough to run inline on the
+ * uplink and flash write paths. Input is limited to 64KB per block.
+ */
+
+namespace Lz4 {
+
+/// Largest input accepted by compress()
+constexpr size_t MAX_INPUT_SIZE = 65535;
+
+/// Entries in the match finder hash table
+constexpr size_t HASH_ENTRIES = 4096;
+
+/// Working memory required by compress()
+constexpr size_t WORK_SIZE = HASH_ENTRIES * sizeof(uint16_t);
+
+/**
+ * @brief Worst-case compressed size for @p len input bytes
+ */
+constexpr size_t compressBound(size_t len) { return len + len / 255 + 16; }
+
+/**
+ * @brief Compress one block
+ *
+ * @param src      Input data (at most MAX_INPUT_SIZE bytes)
+ * @param len      Input length
+ * @param dst      Output buffer
+ * @param capacity Output buffer size
+ * @param work     Working memory of WORK_SIZE bytes
+ * @return Compressed size, or 0 if the output did not fit in @p capacity
+ */
+size_t compress(const uint8_t* src, size_t len, uint8_t* dst, size_t capacity,
+                void* work);
+
+/**
+ * @brief Decompress one block
+ *
+ * Bounds-checked: corrupt or truncated input never writes past @p capacity.
+ *
+ * @param src      Compressed block
+ * @param len      Compressed length
+ * @param dst      Output buffer
+ * @param capacity Output buffer size
+ * @return Decompressed size, or 0 if the input is malformed or does not fit
+ */
+size_t decompress(const uint8_t* src, size_t len, uint8_t* dst, size_t capacity);
+
+} // namespace Lz4
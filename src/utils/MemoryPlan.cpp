@@ -0,0 +1,329 @@
+#include "MemoryPlan.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <cstdlib>
+#include <cstring>
+
+static const char *TAG = "MemoryPlan";
+
+// Regions start on this boundary inside an arena (TCBs need 8)
+static const size_t ALIGN = 16;
+
+namespace MemoryPlan {
+
+static constexpr size_t REGION_COUNT = (size_t)Region::COUNT;
+static constexpr size_t PLACEMENT_COUNT = 2;
+
+struct Slot {
+  uint8_t *block;       // Reserved memory, nullptr if not reserved
+  void *owner;          // Current buffer, in block or from the heap
+  uint32_t used;
+  uint32_t peak;
+  uint32_t spills;
+  TaskHandle_t task;    // Last task created in block
+  volatile bool exited; // That task called exitTask()
+};
+
+static Slot s_slots[REGION_COUNT] = {};
+static uint8_t *s_arena[PLACEMENT_COUNT] = {};
+static uint32_t s_arenaBytes[PLACEMENT_COUNT] = {};
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t alignUp(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+
+static bool validRegion(Region region) {
+  return (size_t)region < REGION_COUNT;
+}
+
+static const Entry &entry(Region region) { return PLAN[(size_t)region]; }
+
+// Bytes a region takes in its arena
+static size_t footprint(const Entry &e) {
+  return alignUp(e.budget) + (e.task ? alignUp(sizeof(StaticTask_t)) : 0);
+}
+
+static bool reservedAtInit(const Entry &e, bool capture, bool compress) {
+  return e.reserve == Reserve::BOOT ||
+         (capture && e.reserve == Reserve::CAPTURE) ||
+         (capture && compress && e.reserve == Reserve::COMPRESS);
+}
+
+static uint32_t heapCaps(Placement placement) {
+  return placement == Placement::PSRAM ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+                                       : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+esp_err_t init(bool capture, bool compress) {
+  if (s_arena[0] || s_arena[1]) {
+    return ESP_OK;
+  }
+
+  size_t total[PLACEMENT_COUNT] = {};
+  for (size_t i = 0; i < REGION_COUNT; i++) {
+    if (reservedAtInit(PLAN[i], capture, compress)) {
+      total[(size_t)PLAN[i].placement] += footprint(PLAN[i]);
+    }
+  }
+
+  esp_err_t ret = ESP_OK;
+  for (size_t p = 0; p < PLACEMENT_COUNT; p++) {
+    if (total[p] == 0) {
+      continue;
+    }
+    s_arena[p] = (uint8_t *)heap_caps_aligned_alloc(ALIGN, total[p],
+                                                    heapCaps((Placement)p));
+    if (!s_arena[p]) {
+      ESP_LOGE(TAG, "No %u bytes for the %s arena, regions use the heap",
+               total[p], p == 0 ? "DRAM" : "PSRAM");
+      ret = ESP_ERR_NO_MEM;
+      continue;
+    }
+    s_arenaBytes[p] = total[p];
+  }
+
+  // Carve the regions in plan order
+  size_t offset[PLACEMENT_COUNT] = {};
+  for (size_t i = 0; i < REGION_COUNT; i++) {
+    size_t p = (size_t)PLAN[i].placement;
+    if (!reservedAtInit(PLAN[i], capture, compress) || !s_arena[p]) {
+      continue;
+    }
+    s_slots[i].block = s_arena[p] + offset[p];
+    offset[p] += footprint(PLAN[i]);
+  }
+
+  ESP_LOGI(TAG, "Arenas reserved: DRAM %lu bytes, PSRAM %lu bytes",
+           s_arenaBytes[0], s_arenaBytes[1]);
+  return ret;
+}
+
+void *alloc(Region region, size_t size) {
+  if (!validRegion(region)) {
+    return heap_caps_malloc(size, heapCaps(Placement::DRAM));
+  }
+  const Entry &e = entry(region);
+  Slot &slot = s_slots[(size_t)region];
+
+  portENTER_CRITICAL(&s_lock);
+  bool first = (slot.owner == nullptr);
+  bool fits = first && slot.block && !e.task && size <= e.budget;
+  if (fits) {
+    slot.owner = slot.block;
+  }
+  portEXIT_CRITICAL(&s_lock);
+
+  void *ptr = fits ? slot.block : heap_caps_malloc(size, heapCaps(e.placement));
+  if (!ptr) {
+    return nullptr;
+  }
+
+  portENTER_CRITICAL(&s_lock);
+  if (first) {
+    slot.owner = ptr;
+    slot.used = size;
+  }
+  if (size > slot.peak) {
+    slot.peak = size;
+  }
+  if (!fits) {
+    slot.spills++;
+  }
+  portEXIT_CRITICAL(&s_lock);
+
+  if (!fits && (size > e.budget || slot.block)) {
+    ESP_LOGW(TAG, "%s: %u bytes from the heap (budget %lu)", e.name, size,
+             e.budget);
+  }
+  return ptr;
+}
+
+void release(Region region, void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  if (!validRegion(region)) {
+    heap_caps_free(ptr);
+    return;
+  }
+  Slot &slot = s_slots[(size_t)region];
+
+  portENTER_CRITICAL(&s_lock);
+  if (slot.owner == ptr) {
+    slot.owner = nullptr;
+    slot.used = 0;
+  }
+  portEXIT_CRITICAL(&s_lock);
+
+  if (ptr != slot.block) {
+    heap_caps_free(ptr);
+  }
+}
+
+// Delete a static task that is no longer running on any core, so FreeRTOS
+// releases its TCB at once instead of leaving it to the idle task
+static void reap(TaskHandle_t task) {
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+    while (xTaskGetCurrentTaskHandleForCore(core) == task) {
+      vTaskDelay(1);
+    }
+  }
+  vTaskDelete(task);
+}
+
+BaseType_t createTask(Region region, TaskFunction_t function, const char *name,
+                      uint32_t stackBytes, void *arg, UBaseType_t priority,
+                      TaskHandle_t *handle, BaseType_t coreId) {
+  // A second task while the region's one still runs (e.g. two merged
+  // UART captures) also takes a heap stack
+  if (!validRegion(region) || !s_slots[(size_t)region].block ||
+      !entry(region).task || stackBytes > entry(region).budget ||
+      (s_slots[(size_t)region].task && !s_slots[(size_t)region].exited)) {
+    if (validRegion(region)) {
+      portENTER_CRITICAL(&s_lock);
+      s_slots[(size_t)region].spills++;
+      portEXIT_CRITICAL(&s_lock);
+    }
+    return xTaskCreatePinnedToCore(function, name, stackBytes, arg, priority,
+                                   handle, coreId);
+  }
+  const Entry &e = entry(region);
+  Slot &slot = s_slots[(size_t)region];
+
+  // The previous instance parks itself in exitTask(); delete it before its
+  // stack and TCB are reused
+  if (slot.task) {
+    while (!slot.exited || eTaskGetState(slot.task) != eSuspended) {
+      vTaskDelay(1);
+    }
+    reap(slot.task);
+    slot.task = nullptr;
+  }
+
+  StackType_t *stack = (StackType_t *)slot.block;
+  StaticTask_t *tcb = (StaticTask_t *)(slot.block + alignUp(e.budget));
+  slot.exited = false;
+  TaskHandle_t task = xTaskCreateStaticPinnedToCore(
+      function, name, stackBytes, arg, priority, stack, tcb, coreId);
+  if (!task) {
+    return pdFAIL;
+  }
+
+  portENTER_CRITICAL(&s_lock);
+  slot.task = task;
+  slot.owner = slot.block;
+  slot.used = stackBytes;
+  if (stackBytes > slot.peak) {
+    slot.peak = stackBytes;
+  }
+  portEXIT_CRITICAL(&s_lock);
+
+  if (handle) {
+    *handle = task;
+  }
+  return pdPASS;
+}
+
+void exitTask(Region region) {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  if (validRegion(region) && s_slots[(size_t)region].task == self) {
+    Slot &slot = s_slots[(size_t)region];
+    portENTER_CRITICAL(&s_lock);
+    slot.owner = nullptr;
+    slot.used = 0;
+    portEXIT_CRITICAL(&s_lock);
+    slot.exited = true;
+    // Deleted by the next createTask() (or never, the region stays ours)
+    while (true) {
+      vTaskSuspend(nullptr);
+    }
+  }
+  vTaskDelete(nullptr);
+}
+
+void deleteTask(Region region, TaskHandle_t handle) {
+  if (!handle) {
+    return;
+  }
+  if (validRegion(region) && s_slots[(size_t)region].task == handle) {
+    Slot &slot = s_slots[(size_t)region];
+    vTaskSuspend(handle);
+    reap(handle);
+    portENTER_CRITICAL(&s_lock);
+    slot.task = nullptr;
+    slot.owner = nullptr;
+    slot.used = 0;
+    portEXIT_CRITICAL(&s_lock);
+    return;
+  }
+  vTaskDelete(handle);
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(stats, 0, sizeof(*stats));
+  for (size_t p = 0; p < PLACEMENT_COUNT; p++) {
+    stats->arenaBytes[p] = s_arenaBytes[p];
+  }
+  stats->internalFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  stats->internalMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  stats->internalLargest =
+      heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  stats->psramFree = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+  portENTER_CRITICAL(&s_lock);
+  for (size_t i = 0; i < REGION_COUNT; i++) {
+    const Slot &slot = s_slots[i];
+    RegionStats &out = stats->region[i];
+    out.name = PLAN[i].name;
+    out.placement = PLAN[i].placement;
+    out.reserve = PLAN[i].reserve;
+    out.task = PLAN[i].task;
+    out.budget = PLAN[i].budget;
+    out.reserved = (slot.block != nullptr);
+    out.used = slot.used;
+    out.peak = slot.peak;
+    out.spills = slot.spills;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+void report() {
+  static Stats stats; // Too large for the caller's stack
+  getStats(&stats);
+
+  ESP_LOGI(TAG, "%-16s %-5s %-8s %8s %8s %8s %6s", "region", "ram", "reserve",
+           "budget", "used", "peak", "spills");
+  uint32_t budgetTotal = 0;
+  uint32_t peakTotal = 0;
+  for (size_t i = 0; i < REGION_COUNT; i++) {
+    const RegionStats &r = stats.region[i];
+    const char *reserve = r.reserved                       ? "arena"
+                          : r.reserve == Reserve::ON_DEMAND ? "demand"
+                                                            : "heap";
+    if (r.spills > 0 || r.peak > r.budget) {
+      ESP_LOGW(TAG, "%-16s %-5s %-8s %8lu %8lu %8lu %6lu", r.name,
+               r.placement == Placement::PSRAM ? "psram" : "dram", reserve,
+               r.budget, r.used, r.peak, r.spills);
+    } else {
+      ESP_LOGI(TAG, "%-16s %-5s %-8s %8lu %8lu %8lu %6lu", r.name,
+               r.placement == Placement::PSRAM ? "psram" : "dram", reserve,
+               r.budget, r.used, r.peak, r.spills);
+    }
+    if (r.reserved) {
+      budgetTotal += r.budget;
+      peakTotal += r.peak;
+    }
+  }
+  ESP_LOGI(TAG, "Reserved: %lu of %lu bytes used at peak (arena DRAM %lu, "
+                "PSRAM %lu)",
+           peakTotal, budgetTotal, stats.arenaBytes[0], stats.arenaBytes[1]);
+  ESP_LOGI(TAG, "Heap: internal %lu free (min %lu, largest block %lu), "
+                "PSRAM %lu free",
+           stats.internalFree, stats.internalMinFree, stats.internalLargest,
+           stats.psramFree);
+}
+
+} // namespace MemoryPlan
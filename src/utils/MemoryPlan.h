@@ -0,0 +1,178 @@
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief MemoryPlan - Compile-time budget for long-lived buffers and tasks
+ *
+ * Every long-lived buffer and task stack on the capture and storage path
+ * has a region in PLAN[] with its placement and budget. init() reserves
+ * the regions marked for boot from one arena per placement, before the
+ * heap sees any other allocation, so weeks of short-lived allocations
+ * (HTTP, MQTT, JSON) cannot fragment the space they need. Their owners
+ * take the reserved block with alloc() and create their tasks with
+ * createTask() (static stack and TCB from the region).
+ *
+ * A request above the budget, or for an on-demand region, is served from
+ * the heap instead and shows up in the report, so the plan can be
+ * corrected from field logs. Without init() (host tests) everything comes
+ * from the heap.
+ *
+ * A static task cannot free its own stack: tasks end with exitTask(),
+ * which parks them suspended until createTask() or deleteTask() deletes
+ * them from another task, so the region is never reused while FreeRTOS
+ * still references it.
+ */
+
+namespace MemoryPlan {
+
+/// Where a region lives
+enum class Placement : uint8_t {
+    DRAM,  ///< Internal RAM (8-bit capable)
+    PSRAM, ///< External RAM (alloc() fails without PSRAM)
+};
+
+/// When a region is reserved
+enum class Reserve : uint8_t {
+    BOOT,      ///< Always, at init()
+    CAPTURE,   ///< At init() when the device captures (endpoint)
+    COMPRESS,  ///< At init() when the device captures with compression
+    ON_DEMAND, ///< Heap on first use, only tracked against the budget
+};
+
+/// Planned regions
+enum class Region : uint8_t {
+    // Buffers
+    CAPTURE_RING,       ///< Transport staging ring, internal RAM
+    CAPTURE_RING_PSRAM, ///< Transport staging ring, PSRAM tier
+    PIPELINE_PAGES,     ///< Flash writer page buffers
+    PIPELINE_STAGES,    ///< Filter stage ping-pong buffers
+    PIPELINE_LZ4,       ///< LZ4 block buffers and hash table
+    RECORD_INDEX,       ///< RecordStore sparse index
+    // Task stacks
+    TASK_CAPTURE,       ///< uart_capture
+    TASK_FLASH_WRITER,  ///< flash_writer
+    TASK_FLASH_PROGRAM, ///< flash_program
+    TASK_HOUSEKEEPING,  ///< housekeeping
+    TASK_NET_MANAGER,   ///< net_manager
+    COUNT,
+    NONE = COUNT ///< Not planned: plain heap / dynamic task
+};
+
+/// One plan entry
+struct Entry {
+    const char* name;
+    Placement placement;
+    Reserve reserve;
+    bool task;       ///< Budget is a stack size (the TCB is added)
+    uint32_t budget; ///< Bytes
+};
+
+/// The plan, in Region order
+constexpr Entry PLAN[] = {
+    {"capture_ring", Placement::DRAM, Reserve::CAPTURE, false, 32 * 1024},
+    {"capture_psram", Placement::PSRAM, Reserve::ON_DEMAND, false, 4 * 1024 * 1024},
+    {"pipeline_pages", Placement::DRAM, Reserve::CAPTURE, false, 3 * 4096},
+    {"pipeline_stages", Placement::DRAM, Reserve::ON_DEMAND, false, 10 * 1024},
+    {"pipeline_lz4", Placement::DRAM, Reserve::COMPRESS, false, 16 * 1024 + 512},
+    {"record_index", Placement::DRAM, Reserve::BOOT, false, 6 * 1024},
+    {"uart_capture", Placement::DRAM, Reserve::CAPTURE, true, 4096},
+    {"flash_writer", Placement::DRAM, Reserve::CAPTURE, true, 4096},
+    {"flash_program", Placement::DRAM, Reserve::BOOT, true, 4096},
+    {"housekeeping", Placement::DRAM, Reserve::BOOT, true, 4096},
+    {"net_manager", Placement::DRAM, Reserve::BOOT, true, 3072},
+};
+static_assert(sizeof(PLAN) / sizeof(PLAN[0]) == (size_t)Region::COUNT,
+              "One plan entry per region");
+
+/**
+ * @brief Budget of a region, for static_assert in its owner
+ */
+constexpr uint32_t budget(Region region) {
+    return PLAN[(size_t)region].budget;
+}
+
+/// Per-region usage
+struct RegionStats {
+    const char* name;
+    Placement placement;
+    Reserve reserve;
+    bool task;
+    uint32_t budget;
+    bool reserved;    ///< Backed by the arena
+    uint32_t used;    ///< Current owner's size (0 = free)
+    uint32_t peak;    ///< Largest request seen
+    uint32_t spills;  ///< Requests served from the heap instead
+};
+
+/// Statistics for the boot report and monitoring
+struct Stats {
+    uint32_t arenaBytes[2];    ///< Reserved per placement (DRAM, PSRAM)
+    uint32_t internalFree;     ///< Internal heap free now
+    uint32_t internalMinFree;  ///< Internal heap low-water mark
+    uint32_t internalLargest;  ///< Largest free internal block
+    uint32_t psramFree;        ///< PSRAM heap free (0 without PSRAM)
+    RegionStats region[(size_t)Region::COUNT];
+};
+
+/**
+ * @brief Reserve the arenas (call first thing at boot)
+ * @param capture Also reserve the Reserve::CAPTURE regions
+ * @param compress Also reserve the Reserve::COMPRESS regions (with capture)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if a region could not be reserved
+ *         (it is then served from the heap)
+ */
+esp_err_t init(bool capture, bool compress = false);
+
+/**
+ * @brief Get a region's buffer
+ *
+ * The first owner gets the reserved block if @p size fits the budget;
+ * anything else comes from the heap with the region's placement.
+ *
+ * @return Buffer, or nullptr if out of memory
+ */
+void* alloc(Region region, size_t size);
+
+/**
+ * @brief Release a buffer from alloc() (the reserved block stays reserved)
+ */
+void release(Region region, void* ptr);
+
+/**
+ * @brief xTaskCreatePinnedToCore with the stack and TCB from the region
+ *
+ * Falls back to a heap stack if the region is not reserved, too small or
+ * still holds a running task.
+ * A task created here must end with exitTask(), or be deleted with
+ * deleteTask().
+ */
+BaseType_t createTask(Region region, TaskFunction_t function, const char* name,
+                      uint32_t stackBytes, void* arg, UBaseType_t priority,
+                      TaskHandle_t* handle, BaseType_t coreId);
+
+/**
+ * @brief End the calling task (instead of vTaskDelete(nullptr))
+ */
+void exitTask(Region region);
+
+/**
+ * @brief Delete a task from another task (instead of vTaskDelete(handle))
+ */
+void deleteTask(Region region, TaskHandle_t handle);
+
+/**
+ * @brief Get plan usage and heap figures
+ */
+esp_err_t getStats(Stats* stats);
+
+/**
+ * @brief Log the budget against actual usage
+ */
+void report();
+
+} // namespace MemoryPlan
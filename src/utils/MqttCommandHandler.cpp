@@ -2,7 +2,7 @@
 #include "CommandSystem.h"
 #include "../config/ConfigManager.h"
 #include "esp_log.h"
-#include "cJSON.h"
+#include "JsonTokenizer.h"
 #include <cstring>
 
 static const char *TAG = "MqttCmdHandler";
@@ -17,14 +17,12 @@ static char s_deviceName[32] = {0}; // Device name for responses
 static bool s_initialized = false;
 static bool s_handlerActive = false;
 
-// Helper function to extract JSON string value
-static const char *getJsonString(cJSON *obj, const char *key, const char *defaultValue = "") {
-  cJSON *item = cJSON_GetObjectItem(obj, key);
-  if (item && cJSON_IsString(item)) {
-    return item->valuestring;
-  }
-  return defaultValue;
-}
+// Tokens for one command object; commands only carry a handful of fields
+static constexpr size_t MAX_COMMAND_TOKENS = 32;
+
+// Command output, embedded whole in the response message. Commands only
+// arrive on the MQTT task, so one buffer serves them all
+static char s_outputBuffer[CommandSystem::DEFAULT_OUTPUT_SIZE];
 
 // Helper function to publish command response using MqttManager
 static void publishResponse(const char *requestId, const char *command,
@@ -82,62 +80,59 @@ void processMessage(const char *topic, const uint8_t *payload, size_t payloadLen
     return;
   }
 
-  // Null-terminate payload for JSON parsing
-  char *payloadStr = (char *)malloc(payloadLen + 1);
-  if (!payloadStr) {
-    ESP_LOGE(TAG, "Failed to allocate memory for payload");
-    return;
-  }
-
-  memcpy(payloadStr, payload, payloadLen);
-  payloadStr[payloadLen] = '\0';
-
   ESP_LOGI(TAG, "Received MQTT command from topic '%s': %.*s", topic,
-           (int)(payloadLen > 128 ? 128 : payloadLen), payloadStr);
-
-  // Parse JSON
-  cJSON *json = cJSON_Parse(payloadStr);
-  if (!json) {
-    ESP_LOGE(TAG, "Failed to parse JSON: %s", cJSON_GetErrorPtr());
-    free(payloadStr);
+           (int)(payloadLen > 128 ? 128 : payloadLen), (const char *)payload);
+
+  // Tokenize in place: no payload copy and no heap allocation per command
+  JsonTokenizer::Token tokens[MAX_COMMAND_TOKENS];
+  JsonTokenizer json(tokens, MAX_COMMAND_TOKENS);
+  esp_err_t ret = json.parse((const char *)payload, payloadLen);
+  if (ret != ESP_OK || json.token(0).type != JsonTokenizer::Type::OBJECT) {
+    ESP_LOGE(TAG, "Failed to parse JSON command: %s",
+             ret == ESP_ERR_NO_MEM ? "too many fields" : "malformed");
     return;
   }
 
   // Check device ID target (if specified)
-  const char *targetDeviceId = getJsonString(json, "deviceId", nullptr);
-  if (targetDeviceId && strlen(targetDeviceId) > 0) {
+  int targetTok = json.find(0, "deviceId");
+  const JsonTokenizer::Token *target = targetTok >= 0 ? &json.token(targetTok) : nullptr;
+  if (target && target->type == JsonTokenizer::Type::STRING && target->end > target->start) {
     // Command has a target device ID - check if it's for this device
-    if (strlen(s_deviceId) > 0 && strcmp(targetDeviceId, s_deviceId) != 0) {
-      ESP_LOGD(TAG, "Command ignored - target device ID '%s' does not match this device '%s'",
-               targetDeviceId, s_deviceId);
-      cJSON_Delete(json);
-      free(payloadStr);
+    if (strlen(s_deviceId) > 0 && !json.equals(targetTok, s_deviceId)) {
+      ESP_LOGD(TAG, "Command ignored - target device ID '%.*s' does not match this device '%s'",
+               (int)(target->end - target->start), (const char *)payload + target->start,
+               s_deviceId);
       return;
     }
     ESP_LOGI(TAG, "Command targeted for this device (ID: %s)", s_deviceId);
   } else {
     // No device ID specified - command is ignored for security
     ESP_LOGW(TAG, "Command ignored - missing 'deviceId' field (required for security)");
-    cJSON_Delete(json);
-    free(payloadStr);
     return;
   }
 
   // Extract command fields
-  const char *command = getJsonString(json, "command");
-  const char *args = getJsonString(json, "args");
-  const char *requestId = getJsonString(json, "id", nullptr);
-
-  if (!command || strlen(command) == 0) {
-    ESP_LOGE(TAG, "Missing 'command' field in JSON");
-    cJSON_Delete(json);
-    free(payloadStr);
+  char command[32];
+  char args[96] = "";
+  char requestIdBuf[48];
+  ret = json.copyString(json.find(0, "command"), command, sizeof(command));
+  if (ret != ESP_OK || strlen(command) == 0) {
+    ESP_LOGE(TAG, "%s 'command' field in JSON",
+             ret == ESP_ERR_INVALID_SIZE ? "Oversized" : "Missing");
+    return;
+  }
+  if (json.copyString(json.find(0, "args"), args, sizeof(args)) == ESP_ERR_INVALID_SIZE) {
+    ESP_LOGE(TAG, "Oversized 'args' field for command '%s'", command);
     return;
   }
+  const char *requestId = nullptr;
+  if (json.copyString(json.find(0, "id"), requestIdBuf, sizeof(requestIdBuf)) == ESP_OK) {
+    requestId = requestIdBuf;
+  }
 
   // Build command string
-  char cmdStr[128];
-  if (args && strlen(args) > 0) {
+  char cmdStr[sizeof(command) + sizeof(args)];
+  if (args[0] != '\0') {
     snprintf(cmdStr, sizeof(cmdStr), "%s %s", command, args);
   } else {
     strncpy(cmdStr, command, sizeof(cmdStr) - 1);
@@ -145,15 +140,14 @@ void processMessage(const char *topic, const uint8_t *payload, size_t payloadLen
   }
 
   // Execute command through CommandSystem
-  CommandSystem::CommandResult result = 
-      CommandSystem::executeCommand(CommandSystem::Medium::MQTT, cmdStr);
+  CommandSystem::Context ctx = {.medium = CommandSystem::Medium::MQTT,
+                                .buf = s_outputBuffer,
+                                .bufSize = sizeof(s_outputBuffer)};
+  CommandSystem::CommandResult result =
+      CommandSystem::executeCommand(&ctx, cmdStr);
 
   // Publish response
   publishResponse(requestId, command, &result);
-
-  // Cleanup
-  cJSON_Delete(json);
-  free(payloadStr);
 }
 
 // Connection callback to activate/deactivate handler
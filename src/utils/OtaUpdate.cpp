@@ -0,0 +1,443 @@
+#include "OtaUpdate.h"
+#include "JsonWriter.h"
+#include "esp_app_desc.h"
+#include "esp_app_format.h"
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "pipeline/DataPipeline.h"
+#include "storage/FlashRing.h"
+#include "transport/IDataSource.h"
+#include <algorithm>
+#include <cstring>
+
+static const char *TAG = "OtaUpdate";
+
+// Download task: TLS needs the larger stack. Core 0, off the flash writer.
+static const uint32_t DOWNLOAD_STACK = 8192;
+static const BaseType_t DOWNLOAD_CORE = 0;
+static const int DOWNLOAD_TIMEOUT_MS = 10000;
+
+// Ring fill is polled this often while backing off
+static const uint32_t BACKOFF_POLL_MS = 20;
+
+namespace OtaUpdate {
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static Status s_status = {};
+static IDataSource *s_capture = nullptr;
+static DoneFn s_done = nullptr;
+static esp_ota_handle_t s_handle = 0;
+static const esp_partition_t *s_partition = nullptr;
+static int64_t s_startUs = 0;
+static int64_t s_nextWriteUs = 0; // Bandwidth ceiling: earliest next write
+static uint64_t s_droppedBase = 0;
+static uint32_t s_overflowBase = 0;
+
+// Download task arguments (one update at a time)
+static char s_url[MAX_URL + 1];
+static uint32_t s_downloadRate = 0;
+static bool s_downloadReboot = false;
+static uint8_t s_chunk[CHUNK_SIZE];
+
+static void captureCounters(uint64_t *dropped, uint32_t *overflows) {
+  DataPipeline::Stats ps;
+  *dropped = (DataPipeline::getStats(&ps) == ESP_OK) ? ps.bytesDropped : 0;
+  Transport::Stats ts;
+  *overflows = (s_capture && s_capture->getStats(&ts) == ESP_OK)
+                   ? ts.overflowCount
+                   : 0;
+}
+
+static bool captureBusy() {
+  DataPipeline::Stats ps;
+  return DataPipeline::getStats(&ps) == ESP_OK && ps.running &&
+         ps.ringFillPct >= BACKOFF_FILL_PCT;
+}
+
+// Freezes the counters of a finished update and reports it
+static void end(State state, esp_err_t error) {
+  uint64_t dropped;
+  uint32_t overflows;
+  captureCounters(&dropped, &overflows);
+  portENTER_CRITICAL(&s_lock);
+  s_status.state = state;
+  s_status.error = error;
+  s_status.elapsedMs = (uint32_t)((esp_timer_get_time() - s_startUs) / 1000);
+  s_status.captureDroppedBytes = dropped - s_droppedBase;
+  s_status.captureOverflows = overflows - s_overflowBase;
+  Status status = s_status;
+  portEXIT_CRITICAL(&s_lock);
+
+  if (state == State::READY) {
+    ESP_LOGI(TAG, "Image %s ready in %s: %lu bytes in %lu ms, capture lost "
+             "%llu bytes, %lu overflows",
+             status.version, status.partition, (unsigned long)status.written,
+             (unsigned long)status.elapsedMs,
+             (unsigned long long)status.captureDroppedBytes,
+             (unsigned long)status.captureOverflows);
+  } else {
+    ESP_LOGW(TAG, "Update failed after %lu bytes: %s",
+             (unsigned long)status.written, esp_err_to_name(error));
+  }
+  if (s_done) {
+    s_done(status);
+  }
+}
+
+// A failure before begin(): recorded unless another update is running
+static void failEarly(esp_err_t error, bool download) {
+  portENTER_CRITICAL(&s_lock);
+  bool running = (s_status.state == State::RUNNING);
+  if (!running) {
+    s_status = {};
+    s_status.state = State::FAILED;
+    s_status.download = download;
+    s_status.error = error;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  ESP_LOGW(TAG, "Update not started: %s", esp_err_to_name(error));
+}
+
+// The app description follows the image and first segment headers; an
+// image for another chip or project is refused before it is written
+static esp_err_t checkImage(const uint8_t *data, size_t len) {
+  const size_t descOffset =
+      sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t);
+  if (len < descOffset + sizeof(esp_app_desc_t)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  esp_image_header_t header;
+  esp_app_desc_t desc;
+  memcpy(&header, data, sizeof(header));
+  memcpy(&desc, data + descOffset, sizeof(desc));
+  if (header.magic != ESP_IMAGE_HEADER_MAGIC ||
+      desc.magic_word != ESP_APP_DESC_MAGIC_WORD) {
+    ESP_LOGE(TAG, "Not an app image");
+    return ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+  if (header.chip_id != CONFIG_IDF_FIRMWARE_CHIP_ID) {
+    ESP_LOGE(TAG, "Image is for chip %d", (int)header.chip_id);
+    return ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+  const esp_app_desc_t *running = esp_app_get_description();
+  if (strncmp(desc.project_name, running->project_name,
+              sizeof(desc.project_name)) != 0) {
+    ESP_LOGE(TAG, "Image is for project %.32s", desc.project_name);
+    return ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+
+  portENTER_CRITICAL(&s_lock);
+  strncpy(s_status.version, desc.version, sizeof(s_status.version) - 1);
+  portEXIT_CRITICAL(&s_lock);
+  ESP_LOGI(TAG, "Receiving %.32s %.32s (running %.32s)", desc.project_name,
+           desc.version, running->version);
+  return ESP_OK;
+}
+
+void init(IDataSource *capture) { s_capture = capture; }
+
+esp_err_t confirmImage() {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  esp_ota_img_states_t state;
+  if (!running || esp_ota_get_state_partition(running, &state) != ESP_OK ||
+      state != ESP_OTA_IMG_PENDING_VERIFY) {
+    return ESP_OK;
+  }
+  ESP_LOGI(TAG, "New image in %s confirmed", running->label);
+  return esp_ota_mark_app_valid_cancel_rollback();
+}
+
+void setDoneCallback(DoneFn fn) { s_done = fn; }
+
+esp_err_t begin(size_t imageSize, uint32_t rateKBps, bool download) {
+  portENTER_CRITICAL(&s_lock);
+  bool running = (s_status.state == State::RUNNING);
+  if (!running) {
+    s_status = {};
+    s_status.state = State::RUNNING;
+    s_status.download = download;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  if (running) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  const esp_partition_t *partition = esp_ota_get_next_update_partition(nullptr);
+  esp_err_t ret = ESP_OK;
+  if (!partition) {
+    // partitions.csv (2MB flash) has a single app slot
+    ESP_LOGE(TAG, "No second app slot, flash partitions_ota.csv to update");
+    ret = ESP_ERR_NOT_FOUND;
+  } else if (imageSize > partition->size) {
+    ret = ESP_ERR_INVALID_SIZE;
+  } else {
+    // Erased sector by sector as it is written, not all up front
+    ret = esp_ota_begin(partition, OTA_WITH_SEQUENTIAL_WRITES, &s_handle);
+  }
+  if (ret != ESP_OK) {
+    portENTER_CRITICAL(&s_lock);
+    s_status.state = State::FAILED;
+    s_status.error = ret;
+    portEXIT_CRITICAL(&s_lock);
+    ESP_LOGE(TAG, "Cannot start update (%u bytes): %s", (unsigned)imageSize,
+             esp_err_to_name(ret));
+    return ret;
+  }
+
+  s_partition = partition;
+  captureCounters(&s_droppedBase, &s_overflowBase);
+  s_startUs = esp_timer_get_time();
+  s_nextWriteUs = s_startUs;
+  if (rateKBps == 0) {
+    rateKBps = DEFAULT_RATE_KBPS;
+  }
+  portENTER_CRITICAL(&s_lock);
+  s_status.imageSize = (uint32_t)imageSize;
+  s_status.rateKBps = std::min(rateKBps, MAX_RATE_KBPS);
+  strncpy(s_status.partition, partition->label, sizeof(s_status.partition) - 1);
+  portEXIT_CRITICAL(&s_lock);
+
+  ESP_LOGI(TAG, "Update into %s started (%u bytes, %lu KB/s)", partition->label,
+           (unsigned)imageSize, (unsigned long)s_status.rateKBps);
+  return ESP_OK;
+}
+
+esp_err_t write(const uint8_t *data, size_t len) {
+  if (s_status.state != State::RUNNING) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!data || len == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_err_t ret = ESP_OK;
+  if (s_status.written == 0) {
+    ret = checkImage(data, len);
+  }
+  if (ret == ESP_OK && s_status.written + len > s_partition->size) {
+    ret = ESP_ERR_INVALID_SIZE;
+  }
+  if (ret != ESP_OK) {
+    abort(ret);
+    return ret;
+  }
+
+  // Below the capture, flash writer and network tasks while writing
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  UBaseType_t priority = uxTaskPriorityGet(self);
+  if (priority > TASK_PRIORITY) {
+    vTaskPrioritySet(self, TASK_PRIORITY);
+  }
+
+  // Let the writer drain a filling capture ring first
+  int64_t waitStart = esp_timer_get_time();
+  while (captureBusy() &&
+         esp_timer_get_time() - waitStart < (int64_t)MAX_BACKOFF_MS * 1000) {
+    vTaskDelay(pdMS_TO_TICKS(BACKOFF_POLL_MS));
+  }
+  int64_t now = esp_timer_get_time();
+  uint32_t backoffMs = (uint32_t)((now - waitStart) / 1000);
+
+  // Bandwidth ceiling; time lost to backoff is not made up afterwards
+  if (s_nextWriteUs > now) {
+    vTaskDelay(pdMS_TO_TICKS((uint32_t)((s_nextWriteUs - now + 999) / 1000)));
+    now = esp_timer_get_time();
+  }
+  s_nextWriteUs = std::max(s_nextWriteUs, now) +
+                  (int64_t)len * 1000000 / ((int64_t)s_status.rateKBps * 1024);
+
+  ret = esp_ota_write(s_handle, data, len);
+
+  if (priority > TASK_PRIORITY) {
+    vTaskPrioritySet(self, priority);
+  }
+  if (ret != ESP_OK) {
+    abort(ret);
+    return ret;
+  }
+
+  portENTER_CRITICAL(&s_lock);
+  s_status.written += len;
+  s_status.backoffMs += backoffMs;
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+esp_err_t finish() {
+  if (s_status.state != State::RUNNING) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  esp_err_t ret = esp_ota_end(s_handle); // Verifies the image
+  if (ret == ESP_OK) {
+    ret = esp_ota_set_boot_partition(s_partition);
+  }
+  end(ret == ESP_OK ? State::READY : State::FAILED, ret);
+  return ret;
+}
+
+void abort(esp_err_t reason) {
+  if (s_status.state != State::RUNNING) {
+    return;
+  }
+  esp_ota_abort(s_handle);
+  end(State::FAILED, reason);
+}
+
+// Streams the image from s_url through write(), one chunk at a time
+static void downloadTask(void *arg) {
+  (void)arg;
+  esp_http_client_config_t config = {};
+  config.url = s_url;
+  config.timeout_ms = DOWNLOAD_TIMEOUT_MS;
+  config.crt_bundle_attach = esp_crt_bundle_attach;
+  esp_http_client_handle_t client = esp_http_client_init(&config);
+
+  esp_err_t ret = client ? esp_http_client_open(client, 0) : ESP_ERR_NO_MEM;
+  int64_t length = 0;
+  if (ret == ESP_OK) {
+    length = esp_http_client_fetch_headers(client);
+    int status = esp_http_client_get_status_code(client);
+    if (status != 200) {
+      ESP_LOGE(TAG, "Download failed: HTTP %d", status);
+      ret = ESP_ERR_INVALID_RESPONSE;
+    }
+  }
+  if (ret == ESP_OK) {
+    ret = begin(length > 0 ? (size_t)length : 0, s_downloadRate, true);
+  } else {
+    failEarly(ret, true);
+  }
+
+  if (ret == ESP_OK) {
+    bool done = false;
+    while (ret == ESP_OK && !done) {
+      // Whole chunks, so the first one holds the app description
+      size_t fill = 0;
+      while (fill < sizeof(s_chunk)) {
+        int n = esp_http_client_read(client, (char *)s_chunk + fill,
+                                     sizeof(s_chunk) - fill);
+        if (n < 0) {
+          ret = ESP_ERR_INVALID_RESPONSE;
+          break;
+        }
+        if (n == 0) {
+          done = true;
+          break;
+        }
+        fill += n;
+      }
+      if (ret == ESP_OK && fill > 0) {
+        ret = write(s_chunk, fill);
+      }
+    }
+    if (ret == ESP_OK && !esp_http_client_is_complete_data_received(client)) {
+      ret = ESP_ERR_INVALID_SIZE; // Connection closed early
+    }
+    if (ret == ESP_OK) {
+      ret = finish();
+    } else {
+      abort(ret);
+    }
+  }
+
+  if (client) {
+    esp_http_client_cleanup(client);
+  }
+  if (ret == ESP_OK && s_downloadReboot) {
+    restart();
+  }
+  vTaskDelete(nullptr);
+}
+
+esp_err_t startDownload(const char *url, uint32_t rateKBps, bool reboot) {
+  if (!url || url[0] == '\0' || strlen(url) > MAX_URL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  portENTER_CRITICAL(&s_lock);
+  bool running = (s_status.state == State::RUNNING);
+  portEXIT_CRITICAL(&s_lock);
+  if (running) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  strcpy(s_url, url);
+  s_downloadRate = rateKBps;
+  s_downloadReboot = reboot;
+  if (xTaskCreatePinnedToCore(downloadTask, "ota_download", DOWNLOAD_STACK,
+                              nullptr, TASK_PRIORITY, nullptr,
+                              DOWNLOAD_CORE) != pdPASS) {
+    return ESP_ERR_NO_MEM;
+  }
+  ESP_LOGI(TAG, "Downloading %s", url);
+  return ESP_OK;
+}
+
+void restart() {
+  ESP_LOGW(TAG, "Restarting into the new image...");
+  DataPipeline::flush();
+  FlashRing::waitIdle(pdMS_TO_TICKS(1000));
+  FlashRing::flushMetadata();
+  vTaskDelay(pdMS_TO_TICKS(500)); // Let responses go out
+  esp_restart();
+}
+
+esp_err_t getStatus(Status *status) {
+  if (!status) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  uint64_t dropped;
+  uint32_t overflows;
+  captureCounters(&dropped, &overflows);
+  portENTER_CRITICAL(&s_lock);
+  *status = s_status;
+  if (status->state == State::RUNNING) {
+    status->elapsedMs = (uint32_t)((esp_timer_get_time() - s_startUs) / 1000);
+    status->captureDroppedBytes = dropped - s_droppedBase;
+    status->captureOverflows = overflows - s_overflowBase;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+const char *stateName(State state) {
+  switch (state) {
+  case State::IDLE:
+    return "idle";
+  case State::RUNNING:
+    return "running";
+  case State::READY:
+    return "ready";
+  case State::FAILED:
+    return "failed";
+  }
+  return "?";
+}
+
+void toJson(const Status &status, JsonWriter *json) {
+  json->beginObject();
+  json->field("state", stateName(status.state));
+  json->field("running", esp_app_get_description()->version);
+  if (status.state != State::IDLE) {
+    json->field("source", status.download ? "url" : "upload");
+    json->field("version", status.version);
+    json->field("partition", status.partition);
+    json->field("imageSize", status.imageSize);
+    json->field("written", status.written);
+    json->field("rateKBps", status.rateKBps);
+    json->field("elapsedMs", status.elapsedMs);
+    json->field("backoffMs", status.backoffMs);
+    json->field("captureDroppedBytes", status.captureDroppedBytes);
+    json->field("captureOverflows", status.captureOverflows);
+    if (status.state == State::FAILED) {
+      json->field("error", esp_err_to_name(status.error));
+    }
+  }
+  json->endObject();
+}
+
+} // namespace OtaUpdate
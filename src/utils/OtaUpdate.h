@@ -0,0 +1,166 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+class IDataSource;
+class JsonWriter;
+
+/**
+ * @brief OtaUpdate - Streaming firmware update that keeps capture running
+ *
+ * The new image is written to the other app slot (app0/app1) as it
+ * arrives, in CHUNK_SIZE pieces, either from an HTTP upload
+ * (POST /api/system/ota) or downloaded from a URL (ota command, also over
+ * MQTT). Nothing is buffered beyond one chunk.
+ *
+ * Needs the two-slot partitions_ota.csv (4MB flash); with the default
+ * single-slot table begin() fails with ESP_ERR_NOT_FOUND.
+ *
+ * Capture has priority over the update:
+ * - The slot is erased sector by sector as it is written
+ *   (OTA_WITH_SEQUENTIAL_WRITES), not all at once up front, so no single
+ *   flash operation holds the flash writer for long.
+ * - Writes are paced to a bandwidth ceiling (rateKBps), which also bounds
+ *   the share of flash time the update takes.
+ * - The writing task runs at TASK_PRIORITY, below the capture, flash
+ *   writer and network tasks.
+ * - While the capture ring fills past BACKOFF_FILL_PCT the update waits,
+ *   up to MAX_BACKOFF_MS per chunk.
+ *
+ * Capture bytes dropped by the pipeline and transport overflows while the
+ * update runs are counted and reported in the status.
+ *
+ * The first chunk must hold the app description; an image built for
+ * another project is refused before anything is written. The image is
+ * verified by esp_ota_end() and only then set as the boot image. A new
+ * image boots once and stays only if it calls confirmImage() (after
+ * System Ready); otherwise the bootloader rolls back.
+ */
+
+namespace OtaUpdate {
+
+/// Bytes handed to esp_ota_write() at a time
+constexpr size_t CHUNK_SIZE = 4096;
+
+/// Default bandwidth ceiling
+constexpr uint32_t DEFAULT_RATE_KBPS = 32;
+
+/// Highest accepted ceiling
+constexpr uint32_t MAX_RATE_KBPS = 512;
+
+/// Capture ring fill at which the update pauses
+constexpr uint32_t BACKOFF_FILL_PCT = 25;
+
+/// Longest pause per chunk before the update goes on anyway
+constexpr uint32_t MAX_BACKOFF_MS = 5000;
+
+/// Priority of the task writing the image (httpd and MQTT run at 5)
+constexpr uint32_t TASK_PRIORITY = 2;
+
+/// Longest URL accepted by startDownload()
+constexpr size_t MAX_URL = 159;
+
+enum class State : uint8_t {
+    IDLE,     ///< No update since boot
+    RUNNING,  ///< Receiving and writing the image
+    READY,    ///< Verified and set as boot image, reboot to run it
+    FAILED    ///< Aborted, the running image stays
+};
+
+/// Progress and result of the current or last update
+struct Status {
+    State state;
+    bool download;                  ///< From a URL (else an HTTP upload)
+    uint32_t imageSize;             ///< 0 if unknown
+    uint32_t written;               ///< Bytes written to the slot
+    uint32_t rateKBps;              ///< Bandwidth ceiling
+    uint32_t elapsedMs;
+    uint32_t backoffMs;             ///< Time paused for capture
+    uint64_t captureDroppedBytes;   ///< Pipeline drops during the update
+    uint32_t captureOverflows;      ///< Transport overflows during the update
+    esp_err_t error;                ///< Cause of FAILED
+    char partition[17];             ///< Slot written
+    char version[32];               ///< Version of the new image
+};
+
+/**
+ * @brief Called when an update ends (READY or FAILED), on the writing task
+ */
+typedef void (*DoneFn)(const Status& status);
+
+/**
+ * @brief Set the capture source whose overflows are reported (may be null)
+ */
+void init(IDataSource* capture);
+
+/**
+ * @brief Keep the running image if it is a new one waiting for approval
+ *
+ * Call once the system is up; until then a reset rolls back.
+ */
+esp_err_t confirmImage();
+
+/**
+ * @brief Set a callback for finished updates
+ */
+void setDoneCallback(DoneFn fn);
+
+/**
+ * @brief Start an update into the other app slot
+ * @param imageSize Image size, 0 if unknown (checked against the slot)
+ * @param rateKBps Bandwidth ceiling, 0 for DEFAULT_RATE_KBPS
+ * @param download Whether the image comes from a URL (status only)
+ * @return ESP_ERR_INVALID_STATE if an update is running,
+ *         ESP_ERR_NOT_FOUND without a second app slot,
+ *         ESP_ERR_INVALID_SIZE if the image cannot fit the slot
+ */
+esp_err_t begin(size_t imageSize, uint32_t rateKBps, bool download);
+
+/**
+ * @brief Write the next piece of the image, paced for capture
+ *
+ * Blocks for the bandwidth ceiling and capture backoff. Runs the caller at
+ * TASK_PRIORITY meanwhile. On error the update is aborted.
+ */
+esp_err_t write(const uint8_t* data, size_t len);
+
+/**
+ * @brief Verify the image and make it the boot image
+ */
+esp_err_t finish();
+
+/**
+ * @brief Abort the running update with @p reason
+ */
+void abort(esp_err_t reason);
+
+/**
+ * @brief Download and write an image from @p url on a task of its own
+ * @param reboot Restart into the new image once it is ready
+ * @return ESP_OK once the download task started
+ */
+esp_err_t startDownload(const char* url, uint32_t rateKBps, bool reboot);
+
+/**
+ * @brief Flush captured data and restart into the new image
+ */
+void restart();
+
+/**
+ * @brief Get the status of the current or last update
+ */
+esp_err_t getStatus(Status* status);
+
+/**
+ * @brief Short name of a state (JSON)
+ */
+const char* stateName(State state);
+
+/**
+ * @brief Format a status as a JSON object
+ */
+void toJson(const Status& status, JsonWriter* json);
+
+} // namespace OtaUpdate
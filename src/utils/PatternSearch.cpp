@@ -0,0 +1,192 @@
+#include "PatternSearch.h"
+#include <cstring>
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+static void addByte(uint8_t *set, uint8_t byte, bool ignoreCase) {
+  set[byte >> 3] |= (uint8_t)(1 << (byte & 7));
+  if (ignoreCase) {
+    uint8_t other = byte;
+    if (byte >= 'a' && byte <= 'z')
+      other = byte - 'a' + 'A';
+    else if (byte >= 'A' && byte <= 'Z')
+      other = byte - 'A' + 'a';
+    set[other >> 3] |= (uint8_t)(1 << (other & 7));
+  }
+}
+
+// One possibly escaped byte at *p, advancing past it; -1 if malformed
+static int parseByte(const char *&p) {
+  if (*p != '\\')
+    return (uint8_t)*p++;
+  p++;
+  switch (*p) {
+  case '\0':
+    return -1; // Trailing backslash
+  case 'n': p++; return '\n';
+  case 'r': p++; return '\r';
+  case 't': p++; return '\t';
+  case '0': p++; return 0;
+  case 'x': {
+    int hi = hexValue(p[1]);
+    int lo = (hi >= 0) ? hexValue(p[2]) : -1;
+    if (lo < 0)
+      return -1;
+    p += 3;
+    return (hi << 4) | lo;
+  }
+  default:
+    return (uint8_t)*p++;
+  }
+}
+
+esp_err_t PatternSearch::compile(const char *pattern, bool ignoreCase) {
+  m_length = 0;
+  if (!pattern || pattern[0] == '\0') {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(m_sets, 0, sizeof(m_sets));
+  const char *p = pattern;
+  size_t length = 0;
+  while (*p) {
+    if (length == MAX_PATTERN) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t *set = m_sets[length++];
+
+    if (*p == '.') {
+      memset(set, 0xFF, sizeof(m_sets[0]));
+      p++;
+      continue;
+    }
+    if (*p != '[') {
+      int byte = parseByte(p);
+      if (byte < 0) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      addByte(set, (uint8_t)byte, ignoreCase);
+      continue;
+    }
+
+    // Byte class; "]" right after "[" or "[^" is a member
+    p++;
+    bool negate = (*p == '^');
+    if (negate)
+      p++;
+    bool first = true;
+    while (*p && (*p != ']' || first)) {
+      first = false;
+      int lo = parseByte(p);
+      int hi = lo;
+      if (lo >= 0 && p[0] == '-' && p[1] && p[1] != ']') {
+        p++;
+        hi = parseByte(p);
+      }
+      if (lo < 0 || hi < lo) {
+        return ESP_ERR_INVALID_ARG;
+      }
+      for (int b = lo; b <= hi; b++) {
+        addByte(set, (uint8_t)b, ignoreCase);
+      }
+    }
+    if (*p != ']') {
+      return ESP_ERR_INVALID_ARG; // Unterminated class
+    }
+    p++;
+    if (negate) {
+      for (size_t i = 0; i < sizeof(m_sets[0]); i++) {
+        set[i] = (uint8_t)~set[i];
+      }
+    }
+  }
+
+  // Jump so the window's last byte lines up with the rightmost earlier
+  // position that accepts it, the whole length if none does
+  for (size_t b = 0; b < 256; b++) {
+    m_shift[b] = (uint8_t)length;
+  }
+  for (size_t i = 0; i + 1 < length; i++) {
+    for (size_t b = 0; b < 256; b++) {
+      if (accepts(i, (uint8_t)b)) {
+        m_shift[b] = (uint8_t)(length - 1 - i);
+      }
+    }
+  }
+
+  m_length = length;
+  reset(0);
+  return ESP_OK;
+}
+
+void PatternSearch::reset(uint64_t position) {
+  m_position = position;
+  m_carryLen = 0;
+}
+
+// Report matches in @p data that start before @p limit
+bool PatternSearch::scan(const uint8_t *data, size_t len, size_t limit,
+                         uint64_t base, MatchCallback callback,
+                         void *ctx) const {
+  const size_t last = m_length - 1;
+  size_t i = 0;
+  while (i < limit && i + last < len) {
+    uint8_t tail = data[i + last];
+    if (accepts(last, tail)) {
+      size_t k = 0;
+      while (k < last && accepts(k, data[i + k])) {
+        k++;
+      }
+      if (k == last && !callback(base + i, ctx)) {
+        return false;
+      }
+    }
+    i += m_shift[tail];
+  }
+  return true;
+}
+
+bool PatternSearch::feed(const uint8_t *data, size_t len,
+                         MatchCallback callback, void *ctx) {
+  if (m_length == 0 || !data || len == 0 || !callback) {
+    return true;
+  }
+  const size_t keep = m_length - 1;
+
+  // Matches starting in the kept tail of the previous piece
+  if (m_carryLen > 0) {
+    uint8_t stitch[2 * (MAX_PATTERN - 1)];
+    size_t head = (len < keep) ? len : keep;
+    memcpy(stitch, m_carry, m_carryLen);
+    memcpy(stitch + m_carryLen, data, head);
+    if (!scan(stitch, m_carryLen + head, m_carryLen, m_position - m_carryLen,
+              callback, ctx)) {
+      return false;
+    }
+  }
+
+  if (!scan(data, len, len, m_position, callback, ctx)) {
+    return false;
+  }
+
+  // Keep the last length() - 1 bytes of the stream
+  if (len >= keep) {
+    memcpy(m_carry, data + len - keep, keep);
+    m_carryLen = keep;
+  } else {
+    size_t drop = (m_carryLen + len > keep) ? m_carryLen + len - keep : 0;
+    memmove(m_carry, m_carry + drop, m_carryLen - drop);
+    memcpy(m_carry + m_carryLen - drop, data, len);
+    m_carryLen = m_carryLen - drop + len;
+  }
+  m_position += len;
+  return true;
+}
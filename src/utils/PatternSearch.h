@@ -0,0 +1,84 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief PatternSearch - Horspool byte-pattern matcher for streamed data
+ *
+ * Patterns are fixed-length sequences of byte classes, a small regex
+ * subset without repetition:
+ *   - any byte stands for itself
+ *   - "."              any byte
+ *   - "[abc]", "[a-z]" one byte of a set, "[^...]" outside of it
+ *   - "\xHH"           a hex byte; "\n", "\r", "\t" and "\0" as usual
+ *   - "\c"             c literally (e.g. "\." or "\[")
+ *
+ * Matching is Boyer-Moore-Horspool over classes: the byte under the last
+ * pattern position selects how far the window jumps, so the scan usually
+ * looks at one byte in every few. Data is fed in pieces (flash pages,
+ * mapped spans). Matches that straddle two pieces are found from the last
+ * length() - 1 bytes, which are kept between feed() calls.
+ *
+ * @code
+ *   PatternSearch search;
+ *   if (search.compile("ERR[0-9]", true) == ESP_OK) {
+ *     search.reset(startPosition);
+ *     search.feed(data, len, onMatch, ctx);
+ *   }
+ * @endcode
+ */
+class PatternSearch {
+public:
+  /// Longest pattern, in byte positions
+  static constexpr size_t MAX_PATTERN = 32;
+
+  /**
+   * @brief Called for every match, in stream order
+   * @param position Stream position of the first matched byte
+   * @return false to stop the search
+   */
+  typedef bool (*MatchCallback)(uint64_t position, void *ctx);
+
+  PatternSearch() = default;
+
+  PatternSearch(const PatternSearch &) = delete;
+  PatternSearch &operator=(const PatternSearch &) = delete;
+
+  /**
+   * @brief Compile a pattern
+   * @param pattern    NUL-terminated pattern (syntax above)
+   * @param ignoreCase Letters match either case
+   * @return ESP_OK, ESP_ERR_INVALID_ARG if malformed or empty,
+   *         ESP_ERR_INVALID_SIZE if longer than MAX_PATTERN
+   */
+  esp_err_t compile(const char *pattern, bool ignoreCase);
+
+  /// Byte positions in the compiled pattern
+  size_t length() const { return m_length; }
+
+  /// Start a new stream whose first byte is at @p position
+  void reset(uint64_t position);
+
+  /**
+   * @brief Search the next piece of the stream
+   * @return false if the callback stopped the search
+   */
+  bool feed(const uint8_t *data, size_t len, MatchCallback callback, void *ctx);
+
+private:
+  uint8_t m_sets[MAX_PATTERN][32] = {}; ///< Bitmap of accepted bytes per position
+  uint8_t m_shift[256] = {};            ///< Horspool jump for the window's last byte
+  size_t m_length = 0;
+
+  uint8_t m_carry[MAX_PATTERN - 1] = {}; ///< Stream tail kept for straddling matches
+  size_t m_carryLen = 0;
+  uint64_t m_position = 0;               ///< Stream position of the next fed byte
+
+  bool accepts(size_t index, uint8_t byte) const {
+    return (m_sets[index][byte >> 3] >> (byte & 7)) & 1;
+  }
+  bool scan(const uint8_t *data, size_t len, size_t limit, uint64_t base,
+            MatchCallback callback, void *ctx) const;
+};
@@ -0,0 +1,161 @@
+#include "PerfCounters.h"
+#include "JsonWriter.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <cstring>
+
+namespace PerfCounters {
+
+// Throughput window state behind each Counter
+struct Window {
+  uint64_t totalBytes;
+  uint32_t windowBytes; // Bytes in the current second
+  int64_t windowSec;    // esp_timer second of the current window
+  uint32_t lastBps;
+  uint32_t peakBps;
+};
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static Histogram s_stages[(size_t)Stage::COUNT] = {};
+static Window s_windows[(size_t)Counter::COUNT] = {};
+
+static const char *const STAGE_NAMES[] = {"captureToRing", "ringToWriter",
+                                          "flashWrite", "flashErase"};
+static const char *const COUNTER_NAMES[] = {"captured", "flashed"};
+
+static inline size_t bucketOf(uint32_t us) {
+  size_t bucket = (us > 1) ? 31 - __builtin_clz(us) : 0;
+  return (bucket < BUCKETS) ? bucket : BUCKETS - 1;
+}
+
+// Close the windows that ended before second @p sec (s_lock held)
+static void rollWindow(Window &w, int64_t sec) {
+  if (sec == w.windowSec) {
+    return;
+  }
+  w.lastBps = (sec == w.windowSec + 1) ? w.windowBytes : 0;
+  if (w.lastBps > w.peakBps) {
+    w.peakBps = w.lastBps;
+  }
+  w.windowBytes = 0;
+  w.windowSec = sec;
+}
+
+void record(Stage stage, uint32_t us) {
+  size_t bucket = bucketOf(us);
+  portENTER_CRITICAL(&s_lock);
+  Histogram &h = s_stages[(size_t)stage];
+  h.count++;
+  h.totalUs += us;
+  if (us > h.maxUs) {
+    h.maxUs = us;
+  }
+  h.buckets[bucket]++;
+  portEXIT_CRITICAL(&s_lock);
+}
+
+void recordSince(Stage stage, int64_t startUs) {
+  int64_t elapsed = esp_timer_get_time() - startUs;
+  record(stage, (elapsed > 0) ? (uint32_t)elapsed : 0);
+}
+
+void addBytes(Counter counter, size_t bytes) {
+  int64_t sec = esp_timer_get_time() / 1000000;
+  portENTER_CRITICAL(&s_lock);
+  Window &w = s_windows[(size_t)counter];
+  rollWindow(w, sec);
+  w.windowBytes += bytes;
+  w.totalBytes += bytes;
+  portEXIT_CRITICAL(&s_lock);
+}
+
+void snapshot(Snapshot *out) {
+  int64_t sec = esp_timer_get_time() / 1000000;
+  portENTER_CRITICAL(&s_lock);
+  memcpy(out->stages, s_stages, sizeof(s_stages));
+  for (size_t i = 0; i < (size_t)Counter::COUNT; i++) {
+    // Idle counters see their windows close here
+    rollWindow(s_windows[i], sec);
+    out->counters[i] = {s_windows[i].totalBytes, s_windows[i].lastBps,
+                        s_windows[i].peakBps};
+  }
+  portEXIT_CRITICAL(&s_lock);
+}
+
+void reset() {
+  portENTER_CRITICAL(&s_lock);
+  memset(s_stages, 0, sizeof(s_stages));
+  memset(s_windows, 0, sizeof(s_windows));
+  portEXIT_CRITICAL(&s_lock);
+}
+
+uint32_t percentileUs(const Histogram &h, uint32_t pct) {
+  if (h.count == 0) {
+    return 0;
+  }
+  uint64_t target = ((uint64_t)h.count * pct + 99) / 100;
+  uint64_t seen = 0;
+  for (size_t b = 0; b < BUCKETS - 1; b++) {
+    seen += h.buckets[b];
+    if (seen >= target) {
+      uint32_t bound = (2u << b) - 1; // Last value of bucket b
+      return (bound < h.maxUs) ? bound : h.maxUs;
+    }
+  }
+  return h.maxUs;
+}
+
+const char *stageName(Stage stage) {
+  return (stage < Stage::COUNT) ? STAGE_NAMES[(size_t)stage] : "?";
+}
+
+const char *counterName(Counter counter) {
+  return (counter < Counter::COUNT) ? COUNTER_NAMES[(size_t)counter] : "?";
+}
+
+void writeFields(const Snapshot &snap, JsonWriter *json, bool histograms) {
+  json->key("latencyUs");
+  json->beginObject();
+  for (size_t i = 0; i < (size_t)Stage::COUNT; i++) {
+    const Histogram &h = snap.stages[i];
+    json->key(STAGE_NAMES[i]);
+    json->beginObject();
+    json->field("count", h.count);
+    json->field("avg", h.count ? h.totalUs / h.count : 0);
+    json->field("max", h.maxUs);
+    if (histograms) {
+      size_t used = BUCKETS;
+      while (used > 0 && h.buckets[used - 1] == 0) {
+        used--;
+      }
+      json->key("log2");
+      json->beginArray();
+      for (size_t b = 0; b < used; b++) {
+        json->value(h.buckets[b]);
+      }
+      json->endArray();
+    }
+    json->endObject();
+  }
+  json->endObject();
+  json->key("throughput");
+  json->beginObject();
+  for (size_t i = 0; i < (size_t)Counter::COUNT; i++) {
+    const Throughput &t = snap.counters[i];
+    json->key(COUNTER_NAMES[i]);
+    json->beginObject();
+    json->field("total", t.totalBytes);
+    json->field("bps", t.lastBps);
+    json->field("peakBps", t.peakBps);
+    json->endObject();
+  }
+  json->endObject();
+}
+
+void toJson(const Snapshot &snap, JsonWriter *json, bool histograms) {
+  json->beginObject();
+  writeFields(snap, json, histograms);
+  json->endObject();
+}
+
+} // namespace PerfCounters
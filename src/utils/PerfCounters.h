@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class JsonWriter;
+
+/**
+ * @brief PerfCounters - Latency histograms and throughput windows
+ *
+ * Instrumentation for the capture -> flash pipeline, cheap enough to stay
+ * enabled in production.
+ *
+ * Each stage keeps a histogram of durations in log2 microsecond buckets
+ * (bucket i holds [2^i, 2^(i+1)) µs, bucket 0 also holds 0) plus count,
+ * sum and maximum. Stages are timed with esp_timer rather than CPU cycle
+ * counters, because capture and writer run on different cores and the
+ * per-core cycle counters are not comparable.
+ *
+ * Throughput counters keep per-second windows: the last complete second
+ * and the peak second since reset.
+ *
+ * Updates and snapshot() take one spinlock for a few dozen cycles, so a
+ * snapshot is always consistent across cores. Hot paths record sampled
+ * events only (e.g. one capture latency per time mark, not per byte).
+ */
+
+namespace PerfCounters {
+
+/// Timed pipeline stages
+enum class Stage : uint8_t {
+  CAPTURE_TO_RING, ///< Strobe/DMA capture time until the bytes are in the ring
+  RING_TO_WRITER,  ///< Capture time until the writer takes the bytes
+  FLASH_WRITE,     ///< One esp_partition_write() call
+  FLASH_ERASE,     ///< One page erase
+  COUNT
+};
+
+/// Byte counters with throughput windows
+enum class Counter : uint8_t {
+  CAPTURED, ///< Bytes taken by the writer from the transports
+  FLASHED,  ///< Bytes programmed to flash
+  COUNT
+};
+
+/// Histogram buckets (the last one holds everything from 2^(BUCKETS-1) µs)
+constexpr size_t BUCKETS = 20;
+
+struct Histogram {
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t buckets[BUCKETS];
+};
+
+struct Throughput {
+  uint64_t totalBytes;
+  uint32_t lastBps; ///< Bytes in the last complete second
+  uint32_t peakBps; ///< Busiest second since reset
+};
+
+struct Snapshot {
+  Histogram stages[(size_t)Stage::COUNT];
+  Throughput counters[(size_t)Counter::COUNT];
+};
+
+/**
+ * @brief Record one duration of @p stage
+ */
+void record(Stage stage, uint32_t us);
+
+/**
+ * @brief Record a duration of @p stage that started at @p startUs (esp_timer)
+ */
+void recordSince(Stage stage, int64_t startUs);
+
+/**
+ * @brief Count bytes on @p counter in the current second
+ */
+void addBytes(Counter counter, size_t bytes);
+
+/**
+ * @brief Get a consistent copy of all counters
+ */
+void snapshot(Snapshot *out);
+
+/**
+ * @brief Clear all histograms and counters
+ */
+void reset();
+
+/**
+ * @brief Upper bound of the @p pct percentile of @p h, in microseconds
+ *
+ * Resolution is one log2 bucket; never above the histogram maximum.
+ * @return 0 for an empty histogram
+ */
+uint32_t percentileUs(const Histogram &h, uint32_t pct);
+
+/**
+ * @brief Short name of a stage or counter (JSON keys)
+ */
+const char *stageName(Stage stage);
+const char *counterName(Counter counter);
+
+/**
+ * @brief Format a snapshot as a JSON object
+ *
+ * Histograms are listed up to their last non-empty bucket; without
+ * @p histograms only count/avg/max are included.
+ *
+ * The caller owns the writer and checks JsonWriter::finish().
+ */
+void toJson(const Snapshot &snap, JsonWriter *json, bool histograms);
+
+/**
+ * @brief Same as toJson(), as fields of an object the caller has open
+ */
+void writeFields(const Snapshot &snap, JsonWriter *json, bool histograms);
+
+} // namespace PerfCounters
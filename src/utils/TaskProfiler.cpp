@@ -0,0 +1,332 @@
+#include "TaskProfiler.h"
+#include "Housekeeping.h"
+#include "JsonWriter.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <cstring>
+
+static const char *TAG = "TaskProfiler";
+
+namespace TaskProfiler {
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+
+// A task seen by the sampler; shares are per sample, in s_next order
+struct TaskSlot {
+  bool used;
+  bool seen; // In the latest sample
+  UBaseType_t number;
+  char name[configMAX_TASK_NAME_LEN];
+  int8_t core;
+  uint8_t priority;
+  uint32_t stackFree;
+  configRUN_TIME_COUNTER_TYPE lastRunTime;
+  uint16_t share[HISTORY];
+};
+
+static TaskStatus_t s_status[MAX_TASKS];
+static TaskSlot s_tasks[MAX_TASKS];
+static uint16_t s_elapsedMs[HISTORY]; // Length of each sample, 0 = none yet
+static uint16_t s_coreShare[HISTORY][portNUM_PROCESSORS];
+static configRUN_TIME_COUNTER_TYPE s_lastIdle[portNUM_PROCESSORS];
+static int64_t s_lastSampleUs = 0;
+static size_t s_next = 0; // History slot of the next sample
+static uint32_t s_samples = 0;
+static uint32_t s_missed = 0;
+
+static SemaphoreHandle_t s_mutex = nullptr;
+static Housekeeping::JobId s_job = Housekeeping::INVALID_JOB;
+static SinkFn s_sink = nullptr;
+static uint32_t s_sinkIntervalMs = 0;
+static int64_t s_lastSinkUs = 0;
+static Snapshot s_sinkSnapshot; // Too large for the housekeeping stack
+
+// Share of one core for @p runUs out of @p elapsedUs
+static uint16_t shareOf(uint32_t runUs, uint32_t elapsedUs) {
+  if (elapsedUs == 0) {
+    return 0;
+  }
+  uint64_t share = (uint64_t)runUs * FULL_SHARE / elapsedUs;
+  return share > FULL_SHARE ? FULL_SHARE : (uint16_t)share;
+}
+
+static TaskSlot *findSlot(UBaseType_t number) {
+  TaskSlot *free = nullptr;
+  for (TaskSlot &slot : s_tasks) {
+    if (slot.used && slot.number == number) {
+      return &slot;
+    }
+    if (!slot.used && !free) {
+      free = &slot;
+    }
+  }
+  return free;
+}
+
+// Caller holds s_mutex
+static void takeSample() {
+  UBaseType_t count = uxTaskGetSystemState(s_status, MAX_TASKS, nullptr);
+  int64_t now = esp_timer_get_time();
+  configRUN_TIME_COUNTER_TYPE idle[portNUM_PROCESSORS];
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+    idle[core] = ulTaskGetIdleRunTimeCounterForCore(core);
+  }
+  if (count == 0) {
+    // More tasks than MAX_TASKS: the next sample covers this one too
+    if (s_missed++ == 0) {
+      ESP_LOGW(TAG, "More than %u tasks, samples skipped",
+               (unsigned)MAX_TASKS);
+    }
+    return;
+  }
+
+  bool first = (s_lastSampleUs == 0);
+  uint32_t elapsedUs = (uint32_t)(now - s_lastSampleUs);
+  s_lastSampleUs = now;
+
+  for (TaskSlot &slot : s_tasks) {
+    slot.seen = false;
+  }
+  for (UBaseType_t i = 0; i < count; i++) {
+    const TaskStatus_t &status = s_status[i];
+    TaskSlot *slot = findSlot(status.xTaskNumber);
+    if (!slot) {
+      continue;
+    }
+    bool known = slot->used;
+    if (!known) {
+      memset(slot, 0, sizeof(*slot));
+      slot->used = true;
+      slot->number = status.xTaskNumber;
+      strncpy(slot->name, status.pcTaskName, sizeof(slot->name) - 1);
+      BaseType_t core = xTaskGetCoreID(status.xHandle);
+      slot->core = (core >= 0 && core < portNUM_PROCESSORS) ? (int8_t)core : -1;
+    }
+    slot->seen = true;
+    slot->priority = (uint8_t)status.uxCurrentPriority;
+    slot->stackFree = status.usStackHighWaterMark;
+    // A new task is counted from its second sample on
+    slot->share[s_next] =
+        known ? shareOf((uint32_t)(status.ulRunTimeCounter - slot->lastRunTime),
+                        elapsedUs)
+              : 0;
+    slot->lastRunTime = status.ulRunTimeCounter;
+  }
+  for (TaskSlot &slot : s_tasks) {
+    if (slot.used && !slot.seen) {
+      slot.used = false; // Deleted since the last sample
+    }
+  }
+
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+    s_coreShare[s_next][core] =
+        FULL_SHARE -
+        shareOf((uint32_t)(idle[core] - s_lastIdle[core]), elapsedUs);
+    s_lastIdle[core] = idle[core];
+  }
+  if (first) {
+    return; // Baseline only: counters to compare the next sample with
+  }
+
+  // Samples are weighted by their length, in ms (a late one counts more)
+  uint32_t elapsedMs = (elapsedUs + 500) / 1000;
+  s_elapsedMs[s_next] = elapsedMs > UINT16_MAX ? UINT16_MAX : (uint16_t)elapsedMs;
+
+  s_next = (s_next + 1) % HISTORY;
+  s_samples++;
+}
+
+static uint32_t sampleJob(void *ctx) {
+  (void)ctx;
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  takeSample();
+  xSemaphoreGive(s_mutex);
+
+  SinkFn sink = s_sink;
+  int64_t now = esp_timer_get_time();
+  if (sink && now - s_lastSinkUs >= (int64_t)s_sinkIntervalMs * 1000) {
+    s_lastSinkUs = now;
+    if (getSnapshot(&s_sinkSnapshot) == ESP_OK) {
+      sink(s_sinkSnapshot);
+    }
+  }
+  return SAMPLE_MS;
+}
+
+esp_err_t init() {
+  if (s_job != Housekeeping::INVALID_JOB) {
+    return ESP_OK;
+  }
+  if (!s_mutex) {
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  memset(s_tasks, 0, sizeof(s_tasks));
+  memset(s_elapsedMs, 0, sizeof(s_elapsedMs));
+  s_lastSampleUs = 0;
+  s_next = 0;
+  s_samples = 0;
+  s_missed = 0;
+  takeSample(); // Baseline for the first window
+  xSemaphoreGive(s_mutex);
+
+  Housekeeping::JobId job = Housekeeping::INVALID_JOB;
+  esp_err_t ret =
+      Housekeeping::add("cpu_profile", sampleJob, nullptr, SAMPLE_MS, &job);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register sampler: %s", esp_err_to_name(ret));
+    return ret;
+  }
+  s_job = job;
+  ESP_LOGI(TAG, "Sampling %u tasks every %lu ms", uxTaskGetNumberOfTasks(),
+           (unsigned long)SAMPLE_MS);
+  return ESP_OK;
+}
+
+void deinit() {
+  Housekeeping::remove(s_job);
+  s_job = Housekeeping::INVALID_JOB;
+  s_sink = nullptr;
+}
+
+void setSink(SinkFn sink, uint32_t intervalMs) {
+  s_sinkIntervalMs = intervalMs;
+  s_lastSinkUs = esp_timer_get_time();
+  s_sink = sink;
+}
+
+esp_err_t getSnapshot(Snapshot *snap) {
+  if (!snap) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (s_job == Housekeeping::INVALID_JOB) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  memset(snap, 0, sizeof(*snap));
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  snap->samples = s_samples;
+  snap->missed = s_missed;
+
+  // Weighted sums per window, newest sample first
+  uint64_t coreSum[portNUM_PROCESSORS][WINDOWS] = {};
+  for (size_t w = 0; w < WINDOWS; w++) {
+    for (size_t n = 0; n < WINDOW_SAMPLES[w]; n++) {
+      size_t h = (s_next + HISTORY - 1 - n) % HISTORY;
+      snap->windowMs[w] += s_elapsedMs[h];
+      for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        coreSum[core][w] += (uint64_t)s_coreShare[h][core] * s_elapsedMs[h];
+      }
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+      snap->coreLoad[core][w] =
+          snap->windowMs[w] ? (uint16_t)(coreSum[core][w] / snap->windowMs[w])
+                            : 0;
+    }
+  }
+
+  for (const TaskSlot &slot : s_tasks) {
+    if (!slot.used) {
+      continue;
+    }
+    TaskLoad &task = snap->task[snap->taskCount++];
+    memcpy(task.name, slot.name, sizeof(task.name));
+    task.core = slot.core;
+    task.priority = slot.priority;
+    task.stackFree = slot.stackFree;
+    for (size_t w = 0; w < WINDOWS; w++) {
+      uint64_t sum = 0;
+      for (size_t n = 0; n < WINDOW_SAMPLES[w]; n++) {
+        size_t h = (s_next + HISTORY - 1 - n) % HISTORY;
+        sum += (uint64_t)slot.share[h] * s_elapsedMs[h];
+      }
+      task.share[w] = snap->windowMs[w] ? (uint16_t)(sum / snap->windowMs[w]) : 0;
+    }
+  }
+  xSemaphoreGive(s_mutex);
+
+  // Busiest first over the longest window (insertion sort, few tasks)
+  for (uint32_t i = 1; i < snap->taskCount; i++) {
+    TaskLoad moved = snap->task[i];
+    uint32_t j = i;
+    while (j > 0 && snap->task[j - 1].share[WINDOWS - 1] <
+                        moved.share[WINDOWS - 1]) {
+      snap->task[j] = snap->task[j - 1];
+      j--;
+    }
+    snap->task[j] = moved;
+  }
+  return ESP_OK;
+}
+
+#else // No trace facility or run time stats: nothing to sample
+
+esp_err_t init() {
+  ESP_LOGW(TAG, "Needs CONFIG_FREERTOS_USE_TRACE_FACILITY and "
+                "CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS");
+  return ESP_ERR_NOT_SUPPORTED;
+}
+
+void deinit() {}
+
+void setSink(SinkFn sink, uint32_t intervalMs) {
+  (void)sink;
+  (void)intervalMs;
+}
+
+esp_err_t getSnapshot(Snapshot *snap) {
+  (void)snap;
+  return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
+// One percentage per window, from hundredths of a percent
+static void writeShares(JsonWriter *json, const uint16_t share[WINDOWS]) {
+  json->beginArray();
+  for (size_t w = 0; w < WINDOWS; w++) {
+    json->value(share[w] / 100.0, 2);
+  }
+  json->endArray();
+}
+
+void toJson(const Snapshot &snap, JsonWriter *json, size_t maxTasks) {
+  json->beginObject();
+  json->field("samples", snap.samples);
+  json->field("missed", snap.missed);
+  json->key("windowMs");
+  json->beginArray();
+  for (size_t w = 0; w < WINDOWS; w++) {
+    json->value(snap.windowMs[w]);
+  }
+  json->endArray();
+  json->key("coreLoad");
+  json->beginArray();
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+    writeShares(json, snap.coreLoad[core]);
+  }
+  json->endArray();
+  json->key("tasks");
+  json->beginArray();
+  for (uint32_t i = 0; i < snap.taskCount && i < maxTasks; i++) {
+    const TaskLoad &task = snap.task[i];
+    json->beginObject();
+    json->field("name", task.name);
+    json->field("core", (int)task.core);
+    json->field("prio", (unsigned)task.priority);
+    json->field("stackFree", task.stackFree);
+    json->key("load");
+    writeShares(json, task.share);
+    json->endObject();
+  }
+  json->endArray();
+  json->endObject();
+}
+
+} // namespace TaskProfiler
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <cstddef>
+#include <cstdint>
+
+class JsonWriter;
+
+/**
+ * @brief TaskProfiler - CPU use per core and per task over sliding windows
+ *
+ * A housekeeping job samples the FreeRTOS run time counters of every task
+ * (uxTaskGetSystemState) every SAMPLE_MS, plus the idle time of each core.
+ * Each sample keeps the share of one core each task used since the
+ * previous one, so the capture tasks pinned to a core can be compared with
+ * the tasks that float (httpd, w5500_tsk, WiFi, MQTT) under real load.
+ *
+ * Utilization is reported over WINDOWS sliding windows of the last
+ * 1, 5 and HISTORY samples. Core load is the share of the window not spent
+ * in that core's idle task; task load is a share of one core, so a task
+ * that keeps a core busy reads 100% whichever core it runs on.
+ *
+ * Each task also reports its stack high-water mark (the least free stack
+ * since it started).
+ *
+ * Requires CONFIG_FREERTOS_USE_TRACE_FACILITY and
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS; without them init() fails with
+ * ESP_ERR_NOT_SUPPORTED.
+ */
+
+namespace TaskProfiler {
+
+/// Tasks tracked (uxTaskGetSystemState fails beyond this)
+constexpr size_t MAX_TASKS = 32;
+
+/// Time between samples
+constexpr uint32_t SAMPLE_MS = 2000;
+
+/// Samples kept (the longest window)
+constexpr size_t HISTORY = 30;
+
+/// Sliding windows reported
+constexpr size_t WINDOWS = 3;
+
+/// Samples in each window: 2 s, 10 s and 60 s
+constexpr size_t WINDOW_SAMPLES[WINDOWS] = {1, 5, HISTORY};
+
+/// CPU shares are in hundredths of a percent of one core
+constexpr uint16_t FULL_SHARE = 10000;
+
+/// One task, as seen by the latest sample
+struct TaskLoad {
+    char name[configMAX_TASK_NAME_LEN];
+    int8_t core;                ///< Pinned core, -1 if it floats
+    uint8_t priority;
+    uint32_t stackFree;         ///< Stack high-water mark in bytes
+    uint16_t share[WINDOWS];    ///< Share of one core per window
+};
+
+/// Utilization over all windows, busiest task first (longest window)
+struct Snapshot {
+    uint32_t samples;                           ///< Samples taken since init
+    uint32_t windowMs[WINDOWS];                 ///< Time each window covers
+    uint16_t coreLoad[portNUM_PROCESSORS][WINDOWS]; ///< Non-idle share per core
+    uint32_t taskCount;                         ///< Entries used in task[]
+    TaskLoad task[MAX_TASKS];
+    uint32_t missed;                            ///< Samples lost (too many tasks)
+};
+
+/**
+ * @brief Receives a snapshot every publish interval, on the housekeeping task
+ *
+ * Must not block (e.g. MqttManager::sendBinary, not publish).
+ */
+typedef void (*SinkFn)(const Snapshot& snap);
+
+/**
+ * @brief Start sampling
+ */
+esp_err_t init();
+
+/**
+ * @brief Stop sampling and forget the history
+ */
+void deinit();
+
+/**
+ * @brief Hand a snapshot to @p sink every @p intervalMs (nullptr to stop)
+ */
+void setSink(SinkFn sink, uint32_t intervalMs);
+
+/**
+ * @brief Compute utilization over the samples taken so far
+ * @return ESP_ERR_INVALID_STATE before init()
+ */
+esp_err_t getSnapshot(Snapshot* snap);
+
+/**
+ * @brief Format a snapshot as a JSON object, at most @p maxTasks tasks
+ *
+ * Shares are written as percentages. The caller owns the writer and checks
+ * JsonWriter::finish().
+ */
+void toJson(const Snapshot& snap, JsonWriter* json, size_t maxTasks = MAX_TASKS);
+
+} // namespace TaskProfiler
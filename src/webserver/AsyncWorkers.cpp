@@ -0,0 +1,199 @@
+#include "AsyncWorkers.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <cstdio>
+
+static const char *TAG = "AsyncWorkers";
+
+// Seconds a rejected client is told to wait before retrying
+static const char *RETRY_AFTER_S = "2";
+
+namespace AsyncWorkers {
+
+struct Route {
+  esp_err_t (*handler)(httpd_req_t *req);
+  void *userCtx;
+};
+
+// A detached request; req == nullptr tells a worker to exit
+struct Job {
+  httpd_req_t *req;
+  const Route *route;
+};
+
+static Route s_routes[MAX_ROUTES];
+static size_t s_routeCount = 0;
+
+static QueueHandle_t s_jobQueue = nullptr;
+static SemaphoreHandle_t s_freeWorkers = nullptr; // One count per idle worker
+static TaskHandle_t s_workers[WORKER_COUNT] = {};
+static volatile bool s_running = false;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static Stats s_stats = {};
+
+static void workerTask(void *arg);
+
+esp_err_t start() {
+  if (s_running)
+    return ESP_OK;
+
+  s_jobQueue = xQueueCreate(WORKER_COUNT, sizeof(Job));
+  s_freeWorkers = xSemaphoreCreateCounting(WORKER_COUNT, WORKER_COUNT);
+  if (!s_jobQueue || !s_freeWorkers) {
+    ESP_LOGE(TAG, "Failed to create job queue");
+    stop();
+    return ESP_ERR_NO_MEM;
+  }
+
+  s_running = true;
+  for (size_t i = 0; i < WORKER_COUNT; i++) {
+    char name[16];
+    snprintf(name, sizeof(name), "http_worker%u", (unsigned)i);
+    // Below the httpd task, so request parsing always wins over bulk work
+    if (xTaskCreate(workerTask, name, WORKER_STACK_SIZE, &s_workers[i],
+                    tskIDLE_PRIORITY + 4, &s_workers[i]) != pdPASS) {
+      ESP_LOGE(TAG, "Failed to create worker %u", (unsigned)i);
+      stop();
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  ESP_LOGI(TAG, "%u workers ready", (unsigned)WORKER_COUNT);
+  return ESP_OK;
+}
+
+esp_err_t stop() {
+  if (s_freeWorkers) {
+    // Each count is an idle worker: wait for running jobs, then retire it
+    for (size_t i = 0; i < WORKER_COUNT; i++) {
+      if (!s_workers[i]) {
+        continue;
+      }
+      xSemaphoreTake(s_freeWorkers, portMAX_DELAY);
+      Job quit = {nullptr, nullptr};
+      xQueueSend(s_jobQueue, &quit, portMAX_DELAY);
+    }
+    for (size_t i = 0; i < WORKER_COUNT; i++) {
+      while (s_workers[i]) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+      }
+    }
+  }
+  s_running = false;
+
+  if (s_jobQueue) {
+    vQueueDelete(s_jobQueue);
+    s_jobQueue = nullptr;
+  }
+  if (s_freeWorkers) {
+    vSemaphoreDelete(s_freeWorkers);
+    s_freeWorkers = nullptr;
+  }
+  s_routeCount = 0; // URIs are registered again on the next start
+  return ESP_OK;
+}
+
+bool isRunning() { return s_running; }
+
+esp_err_t bind(esp_err_t (*handler)(httpd_req_t *req), void *userCtx,
+               void **route) {
+  if (!handler || !route)
+    return ESP_ERR_INVALID_ARG;
+  if (s_routeCount == MAX_ROUTES)
+    return ESP_ERR_NO_MEM;
+
+  s_routes[s_routeCount] = {handler, userCtx};
+  *route = &s_routes[s_routeCount++];
+  return ESP_OK;
+}
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  portENTER_CRITICAL(&s_lock);
+  *stats = s_stats;
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+static esp_err_t sendBusy(httpd_req_t *req) {
+  portENTER_CRITICAL(&s_lock);
+  s_stats.rejected++;
+  portEXIT_CRITICAL(&s_lock);
+
+  ESP_LOGW(TAG, "All workers busy, rejecting %s", req->uri);
+  httpd_resp_set_status(req, "503 Service Unavailable");
+  httpd_resp_set_hdr(req, "Retry-After", RETRY_AFTER_S);
+  httpd_resp_set_type(req, "application/json");
+  return httpd_resp_sendstr(
+      req, "{\"success\":false,\"message\":\"BUSY\",\"error\":\"Server busy, "
+           "retry shortly\"}");
+}
+
+esp_err_t dispatch(httpd_req_t *req) {
+  const Route *route = (const Route *)req->user_ctx;
+  if (!s_running || !route) {
+    return sendBusy(req);
+  }
+
+  // Claim a worker before detaching, so a job never waits in the queue
+  if (xSemaphoreTake(s_freeWorkers, 0) != pdTRUE) {
+    return sendBusy(req);
+  }
+
+  httpd_req_t *copy = nullptr;
+  esp_err_t ret = httpd_req_async_handler_begin(req, &copy);
+  if (ret != ESP_OK) {
+    xSemaphoreGive(s_freeWorkers);
+    ESP_LOGE(TAG, "Failed to detach %s: %s", req->uri, esp_err_to_name(ret));
+    return ESP_FAIL;
+  }
+
+  Job job = {copy, route};
+  if (xQueueSend(s_jobQueue, &job, 0) != pdTRUE) {
+    httpd_req_async_handler_complete(copy);
+    xSemaphoreGive(s_freeWorkers);
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
+static void workerTask(void *arg) {
+  TaskHandle_t *self = (TaskHandle_t *)arg;
+  Job job;
+  while (xQueueReceive(s_jobQueue, &job, portMAX_DELAY) == pdTRUE) {
+    if (!job.req) {
+      break;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.active++;
+    if (s_stats.active > s_stats.highWater) {
+      s_stats.highWater = s_stats.active;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    job.req->user_ctx = job.route->userCtx;
+    if (job.route->handler(job.req) != ESP_OK) {
+      // What httpd does when a handler fails
+      httpd_sess_trigger_close(job.req->handle, httpd_req_to_sockfd(job.req));
+    }
+    httpd_req_async_handler_complete(job.req);
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.active--;
+    s_stats.completed++;
+    portEXIT_CRITICAL(&s_lock);
+    xSemaphoreGive(s_freeWorkers);
+  }
+
+  *self = nullptr;
+  vTaskDelete(nullptr);
+}
+
+} // namespace AsyncWorkers
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief AsyncWorkers - Worker pool for long-running HTTP handlers
+ *
+ * esp_http_server runs every handler on its single task, so a flash format,
+ * an MQTT connection test or a full log download would stall every other
+ * request, /api/status included. Routes bound here are detached from the
+ * httpd task with httpd_req_async_handler_begin() and run on one of
+ * WORKER_COUNT worker tasks instead; the httpd task goes straight back to
+ * serving other sockets.
+ *
+ * At most WORKER_COUNT heavy jobs run at once. A request arriving while all
+ * workers are busy is answered 503 with Retry-After rather than queued, so
+ * a burst of bulk operations cannot pile up sockets.
+ */
+
+namespace AsyncWorkers {
+
+/// Heavy handlers running concurrently
+constexpr size_t WORKER_COUNT = 2;
+
+/// Routes that can be bound with bind()
+constexpr size_t MAX_ROUTES = 8;
+
+/// Worker task stack (the MQTT test builds a whole MqttManager)
+constexpr uint32_t WORKER_STACK_SIZE = 10240;
+
+/// Statistics for debugging and monitoring
+struct Stats {
+  uint32_t active;     ///< Jobs running now
+  uint32_t completed;  ///< Jobs finished since start
+  uint32_t rejected;   ///< Requests answered 503 (all workers busy)
+  uint32_t highWater;  ///< Most jobs that ran at once
+};
+
+/**
+ * @brief Create the worker tasks
+ * @return ESP_OK on success
+ */
+esp_err_t start();
+
+/**
+ * @brief Stop the workers once their current job is done
+ *
+ * Call before httpd_stop().
+ */
+esp_err_t stop();
+
+/**
+ * @brief Check if the workers are running
+ */
+bool isRunning();
+
+/**
+ * @brief Bind a handler to run on the worker pool
+ *
+ * Register the URI with dispatch() as handler and @p route as user_ctx.
+ * The handler sees @p userCtx in req->user_ctx, as it would on httpd.
+ * @param handler Handler to run on a worker
+ * @param userCtx User context for the handler
+ * @param route Output opaque route, valid until stop()
+ * @return ESP_OK, ESP_ERR_NO_MEM if MAX_ROUTES are bound
+ */
+esp_err_t bind(esp_err_t (*handler)(httpd_req_t *req), void *userCtx,
+               void **route);
+
+/**
+ * @brief httpd handler that hands the request to a worker
+ */
+esp_err_t dispatch(httpd_req_t *req);
+
+/**
+ * @brief Get worker pool statistics
+ */
+esp_err_t getStats(Stats *stats);
+
+} // namespace AsyncWorkers
@@ -0,0 +1,292 @@
+#include "LiveFeed.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+static const char *TAG = "LiveFeed";
+
+// Largest frame a client may send (anything longer closes the session)
+static const size_t MAX_RX_FRAME = 64;
+
+// Every field as "key":value, plus the "full" marker and braces
+static const size_t FRAME_BUF_SIZE = 512;
+
+namespace LiveFeed {
+
+static const char *const FIELD_KEYS[FIELD_COUNT] = {
+    "eip", "wip", "fu", "ff", "fs", "fw", "ft", "rx",
+    "rb",  "ro",  "ra", "pw", "pd", "pr", "pf"};
+
+struct Client {
+  int fd;
+  bool needsFull; // Nothing sent yet: next push is a full snapshot
+};
+
+static httpd_handle_t s_server = nullptr;
+static uint32_t s_periodMs = 1000;
+static CollectCallback s_collect = nullptr;
+static volatile bool s_running = false;
+static volatile bool s_stopRequested = false;
+static TaskHandle_t s_taskHandle = nullptr;
+
+// Clients are added by the httpd task and serviced by the push task
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static Client s_clients[MAX_CLIENTS];
+static Stats s_stats = {};
+
+static Sample s_last = {};
+static bool s_haveLast = false;
+static char s_fullFrame[FRAME_BUF_SIZE];
+static char s_deltaFrame[FRAME_BUF_SIZE];
+
+static void pushTask(void *arg);
+
+esp_err_t start(httpd_handle_t server, uint32_t periodMs,
+                CollectCallback collect) {
+  if (s_running)
+    return ESP_OK;
+  if (!server || !collect || periodMs < MIN_PERIOD_MS)
+    return ESP_ERR_INVALID_ARG;
+#ifndef CONFIG_HTTPD_WS_SUPPORT
+  ESP_LOGE(TAG, "Enable CONFIG_HTTPD_WS_SUPPORT for the live feed");
+  return ESP_ERR_NOT_SUPPORTED;
+#endif
+
+  s_server = server;
+  s_periodMs = periodMs;
+  s_collect = collect;
+  s_haveLast = false;
+  for (Client &client : s_clients) {
+    client.fd = -1;
+  }
+  s_stats.clients = 0;
+
+  s_stopRequested = false;
+  BaseType_t ret = xTaskCreate(pushTask, "live_feed", 3072, nullptr,
+                               tskIDLE_PRIORITY + 3, &s_taskHandle);
+  if (ret != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create push task");
+    return ESP_ERR_NO_MEM;
+  }
+
+  s_running = true;
+  ESP_LOGI(TAG, "Pushing every %lu ms on the WebSocket", s_periodMs);
+  return ESP_OK;
+}
+
+esp_err_t stop() {
+  if (!s_running)
+    return ESP_OK;
+
+  s_stopRequested = true;
+  xTaskNotifyGive(s_taskHandle);
+  while (s_taskHandle) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  s_running = false;
+  return ESP_OK;
+}
+
+bool isRunning() { return s_running; }
+
+esp_err_t getStats(Stats *stats) {
+  if (!stats) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  portENTER_CRITICAL(&s_lock);
+  *stats = s_stats;
+  portEXIT_CRITICAL(&s_lock);
+  return ESP_OK;
+}
+
+static bool addClient(int fd) {
+  bool added = false;
+  portENTER_CRITICAL(&s_lock);
+  // A closed session's fd can come back before the push task noticed the
+  // close: take over its entry instead of sending everything twice
+  Client *slot = nullptr;
+  for (Client &client : s_clients) {
+    if (client.fd == fd) {
+      slot = &client;
+      break;
+    }
+    if (client.fd < 0 && !slot) {
+      slot = &client;
+    }
+  }
+  if (slot) {
+    if (slot->fd < 0) {
+      s_stats.clients++;
+    }
+    slot->needsFull = true;
+    slot->fd = fd;
+    s_stats.accepted++;
+    added = true;
+  } else {
+    s_stats.rejected++;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  return added;
+}
+
+static void removeClient(Client &client) {
+  portENTER_CRITICAL(&s_lock);
+  client.fd = -1;
+  s_stats.clients--;
+  portEXIT_CRITICAL(&s_lock);
+}
+
+// Encode the fields selected by @p all (or those that differ from s_last)
+static size_t encode(const Sample &sample, bool all, char *buf) {
+  size_t len = snprintf(buf, FRAME_BUF_SIZE, all ? "{\"full\":true" : "{");
+  bool first = !all;
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    if (!all && sample.values[i] == s_last.values[i]) {
+      continue;
+    }
+    len += snprintf(buf + len, FRAME_BUF_SIZE - len, "%s\"%s\":%" PRIu64,
+                    first ? "" : ",", FIELD_KEYS[i], sample.values[i]);
+    first = false;
+  }
+  if (!all && first) {
+    return 0; // Nothing changed
+  }
+  len += snprintf(buf + len, FRAME_BUF_SIZE - len, "}");
+  return len;
+}
+
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+esp_err_t handleRequest(httpd_req_t *req) {
+  if (req->method == HTTP_GET) {
+    // Handshake done: the session is now a WebSocket
+    int fd = httpd_req_to_sockfd(req);
+    if (!s_running || !addClient(fd)) {
+      ESP_LOGW(TAG, "Client limit reached, rejecting WebSocket");
+      return ESP_FAIL;
+    }
+    // Pushes block at most this long on a client that stopped reading
+    struct timeval timeout = {.tv_sec = 0,
+                              .tv_usec = SEND_TIMEOUT_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    xTaskNotifyGive(s_taskHandle); // Send the full snapshot right away
+    ESP_LOGI(TAG, "Client connected (fd %d)", fd);
+    return ESP_OK;
+  }
+
+  // Client frames carry nothing we use; read them to keep the session in sync
+  httpd_ws_frame_t frame = {};
+  esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+  if (ret != ESP_OK || frame.len > MAX_RX_FRAME) {
+    return ESP_FAIL;
+  }
+  if (frame.len > 0) {
+    uint8_t discard[MAX_RX_FRAME];
+    frame.payload = discard;
+    ret = httpd_ws_recv_frame(req, &frame, frame.len);
+  }
+  return ret;
+}
+
+// Send one text frame, returns false if the client must be dropped
+static bool sendFrame(int fd, const char *data, size_t len) {
+  if (httpd_ws_get_fd_info(s_server, fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+    ESP_LOGI(TAG, "Client disconnected (fd %d)", fd);
+    return false;
+  }
+  httpd_ws_frame_t frame = {};
+  frame.type = HTTPD_WS_TYPE_TEXT;
+  frame.final = true;
+  frame.payload = (uint8_t *)data;
+  frame.len = len;
+  if (httpd_ws_send_data(s_server, fd, &frame) != ESP_OK) {
+    // Send buffer still full after SEND_TIMEOUT_MS: too slow, close it
+    ESP_LOGW(TAG, "Client too slow (fd %d), dropping", fd);
+    portENTER_CRITICAL(&s_lock);
+    s_stats.droppedSlow++;
+    portEXIT_CRITICAL(&s_lock);
+    httpd_sess_trigger_close(s_server, fd);
+    return false;
+  }
+  portENTER_CRITICAL(&s_lock);
+  s_stats.bytesSent += len;
+  portEXIT_CRITICAL(&s_lock);
+  return true;
+}
+#else
+esp_err_t handleRequest(httpd_req_t *req) { return ESP_ERR_NOT_SUPPORTED; }
+
+static bool sendFrame(int fd, const char *data, size_t len) {
+  return false;
+}
+#endif
+
+static void pushTask(void *arg) {
+  while (!s_stopRequested) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(s_periodMs));
+    if (s_stopRequested) {
+      break;
+    }
+    portENTER_CRITICAL(&s_lock);
+    bool idle = s_stats.clients == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (idle) {
+      s_haveLast = false;
+      continue;
+    }
+
+    // One snapshot, each frame kind encoded at most once for all clients
+    Sample sample;
+    s_collect(&sample);
+    size_t deltaLen = s_haveLast ? encode(sample, false, s_deltaFrame) : 0;
+    size_t fullLen = 0;
+
+    for (Client &client : s_clients) {
+      // Take the flag together with the fd: addClient() may re-arm it for a
+      // reused fd while this push is in flight, and that must not be lost
+      portENTER_CRITICAL(&s_lock);
+      int fd = client.fd;
+      bool needsFull = client.needsFull;
+      client.needsFull = false;
+      portEXIT_CRITICAL(&s_lock);
+      if (fd < 0) {
+        continue;
+      }
+      const char *data = s_deltaFrame;
+      size_t len = deltaLen;
+      if (needsFull || !s_haveLast) {
+        if (fullLen == 0) {
+          fullLen = encode(sample, true, s_fullFrame);
+        }
+        data = s_fullFrame;
+        len = fullLen;
+      }
+      if (len == 0) {
+        continue;
+      }
+      if (!sendFrame(fd, data, len)) {
+        removeClient(client);
+        continue;
+      }
+      portENTER_CRITICAL(&s_lock);
+      s_stats.pushes++;
+      portEXIT_CRITICAL(&s_lock);
+    }
+
+    s_last = sample;
+    s_haveLast = true;
+  }
+
+  for (Client &client : s_clients) {
+    if (client.fd >= 0) {
+      removeClient(client);
+    }
+  }
+  s_taskHandle = nullptr;
+  vTaskDelete(nullptr);
+}
+
+} // namespace LiveFeed
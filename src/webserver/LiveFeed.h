@@ -0,0 +1,107 @@
+#pragma once
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief LiveFeed - Push-based dashboard stats over WebSocket
+ *
+ * Clients open a WebSocket on /api/live and receive a JSON text frame
+ * every period instead of polling /api/status and /api/datalogger/stats.
+ * The first frame for a client holds every field and "full":true; later
+ * frames only carry the fields that changed since the previous push, and
+ * nothing is sent when nothing changed.
+ *
+ * One snapshot is collected and encoded per period for all clients, and
+ * nothing at all is collected while no client is connected. The push task
+ * sends with a short socket timeout (SEND_TIMEOUT_MS); a client that does
+ * not drain its socket in time is closed, so a slow browser cannot stall
+ * the other clients or the httpd task.
+ *
+ * Requires CONFIG_HTTPD_WS_SUPPORT.
+ */
+
+namespace LiveFeed {
+
+/// Maximum simultaneous WebSocket clients
+constexpr size_t MAX_CLIENTS = 4;
+
+/// Longest a push may block on one client before it is dropped
+constexpr uint32_t SEND_TIMEOUT_MS = 200;
+
+/// Shortest accepted push period
+constexpr uint32_t MIN_PERIOD_MS = 100;
+
+/// Pushed fields (JSON key in brackets)
+enum Field : uint8_t {
+  ETH_IP,          ///< Ethernet IPv4, first octet in the top byte, 0 = offline ["eip"]
+  WIFI_IP,         ///< WiFi IPv4, same encoding ["wip"]
+  FLASH_USED,      ///< FlashRing used bytes ["fu"]
+  FLASH_FREE,      ///< FlashRing free bytes ["ff"]
+  FLASH_SIZE,      ///< Partition size ["fs"]
+  FLASH_WRAPS,     ///< Ring wraps ["fw"]
+  FLASH_TOTAL,     ///< Lifetime bytes written ["ft"]
+  RX_BYTES,        ///< Transport bytes received ["rx"]
+  RX_BURSTS,       ///< Transport bursts ["rb"]
+  RX_OVERFLOWS,    ///< Transport ring overflows ["ro"]
+  RX_BURST_ACTIVE, ///< 1 while a burst is being captured ["ra"]
+  PIPE_WRITTEN,    ///< Pipeline bytes written to flash ["pw"]
+  PIPE_DROPPED,    ///< Pipeline bytes dropped ["pd"]
+  PIPE_RATE,       ///< Smoothed ingest rate, bytes/s ["pr"]
+  PIPE_RING_FILL,  ///< Fullest source ring, percent ["pf"]
+  FIELD_COUNT
+};
+
+/// One snapshot of every field
+struct Sample {
+  uint64_t values[FIELD_COUNT];
+};
+
+/// Fills a snapshot; called from the push task once per period
+typedef void (*CollectCallback)(Sample *sample);
+
+/// Statistics for debugging and monitoring
+struct Stats {
+  uint32_t clients;     ///< Connected clients
+  uint32_t accepted;    ///< Clients accepted since start
+  uint32_t rejected;    ///< Handshakes refused (MAX_CLIENTS reached)
+  uint32_t droppedSlow; ///< Clients closed for exceeding SEND_TIMEOUT_MS
+  uint32_t pushes;      ///< Frames sent (full or delta), summed over clients
+  uint64_t bytesSent;   ///< Bytes sent, summed over clients
+};
+
+/**
+ * @brief Start the push task
+ * @param server Running httpd instance the WebSocket URI is registered on
+ * @param periodMs Push period (at least MIN_PERIOD_MS)
+ * @param collect Snapshot source
+ * @return ESP_OK on success
+ */
+esp_err_t start(httpd_handle_t server, uint32_t periodMs,
+                CollectCallback collect);
+
+/**
+ * @brief Stop the push task and forget all clients
+ *
+ * Call before httpd_stop(); the sessions themselves are closed by httpd.
+ */
+esp_err_t stop();
+
+/**
+ * @brief Check if the push task is running
+ */
+bool isRunning();
+
+/**
+ * @brief httpd handler for the WebSocket URI (register with is_websocket)
+ */
+esp_err_t handleRequest(httpd_req_t *req);
+
+/**
+ * @brief Get live feed statistics
+ */
+esp_err_t getStats(Stats *stats);
+
+} // namespace LiveFeed
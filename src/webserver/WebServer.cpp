@@ -5,14 +5,23 @@
 #include "../storage/FlashRing.h"
 #include "../transport/TransportTypes.h"
 #include "../utils/CommandSystem.h"
+#include "../utils/JsonWriter.h"
+#include "../utils/OtaUpdate.h"
+#include "AsyncWorkers.h"
+#include "LiveFeed.h"
+#include "esp_crc.h"
 #include "esp_http_server.h"
 #include "esp_log.h"
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "logo_data.h"
+#include "mbedtls/base64.h"
+#include <algorithm>
+#include <cinttypes>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <initializer_list>
 
 static const char *TAG = "WebServer";
 
@@ -27,20 +36,29 @@ static INetworkInterface *s_ethInterface = nullptr;
 static INetworkInterface *s_wifiInterface = nullptr;
 static httpd_handle_t s_serverHandle = nullptr;
 static uint16_t s_port = 80;
+static uint32_t s_livePushMs = 0;
 static bool s_initialized = false;
 static bool s_running = false;
 static DataLoggerCallbacks s_dataloggerCallbacks = {};
 
 // Handlers
+static void initAssetEtags();
+static void collectLiveSample(LiveFeed::Sample *sample);
 static esp_err_t rootHandler(httpd_req_t *req);
 static esp_err_t logoHandler(httpd_req_t *req);
 static esp_err_t apiLoginHandler(httpd_req_t *req);
 static esp_err_t apiStatusHandler(httpd_req_t *req);
 static esp_err_t apiDataLoggerStatsHandler(httpd_req_t *req);
 static esp_err_t apiDataLoggerFormatHandler(httpd_req_t *req);
+static esp_err_t apiDataLoggerMetricsHandler(httpd_req_t *req);
+static esp_err_t apiDataLoggerDecodedHandler(httpd_req_t *req);
+static esp_err_t apiDataLoggerDownloadHandler(httpd_req_t *req);
+static esp_err_t apiDataLoggerSearchHandler(httpd_req_t *req);
 static esp_err_t apiWifiConfigHandler(httpd_req_t *req);
 static esp_err_t apiUserConfigHandler(httpd_req_t *req);
 static esp_err_t apiSystemRebootHandler(httpd_req_t *req);
+static esp_err_t apiSystemOtaHandler(httpd_req_t *req);
+static esp_err_t apiSystemOtaStatusHandler(httpd_req_t *req);
 static esp_err_t apiGetFullConfigHandler(httpd_req_t *req);
 static esp_err_t apiSaveFullConfigHandler(httpd_req_t *req);
 static esp_err_t apiTestMqttHandler(httpd_req_t *req);
@@ -51,9 +69,12 @@ static void sendWebCommandResponse(httpd_req_t *req,
 static void webResponseCallback(CommandSystem::Medium medium,
                                 const CommandSystem::CommandResult *result,
                                 void *userCtx);
+static void runWebCommand(httpd_req_t *req, const char *cmdStr);
+static esp_err_t streamWebCommand(httpd_req_t *req, const char *cmdStr);
 
 esp_err_t init(INetworkInterface *ethInterface,
-               INetworkInterface *wifiInterface, uint16_t port) {
+               INetworkInterface *wifiInterface, uint16_t port,
+               uint32_t livePushMs) {
   if (s_initialized) {
     ESP_LOGW(TAG, "Already initialized");
     return ESP_OK;
@@ -61,6 +82,7 @@ esp_err_t init(INetworkInterface *ethInterface,
   s_ethInterface = ethInterface;
   s_wifiInterface = wifiInterface;
   s_port = port;
+  s_livePushMs = livePushMs;
   s_initialized = true;
   ESP_LOGI(TAG, "Web server initialized (port: %d)", s_port);
   return ESP_OK;
@@ -75,7 +97,10 @@ esp_err_t start() {
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
   config.server_port = s_port;
   config.max_uri_handlers = 20;
-  config.stack_size = 12288; // 12KB - sufficient for MQTT test handler (MqttManager + FullConfig need ~3KB)
+  config.stack_size = 8192; // Config save (2KB body + FullConfig); heavy handlers run on AsyncWorkers
+  // Keep a socket free for the UI: when all are taken, close the idlest one
+  config.max_open_sockets = 7;
+  config.lru_purge_enable = true;
 
   esp_err_t ret = httpd_start(&s_serverHandle, &config);
   if (ret != ESP_OK) {
@@ -83,25 +108,57 @@ esp_err_t start() {
     return ret;
   }
 
+  // Without the pool the heavy handlers simply run inline as before
+  bool asyncReady = AsyncWorkers::start() == ESP_OK;
+  if (!asyncReady)
+    ESP_LOGW(TAG, "Worker pool unavailable, bulk operations run inline");
+
+  initAssetEtags();
   UriHandler handlers[] = {
       {"/", HTTP_GET, rootHandler},
       {"/logo.png", HTTP_GET, logoHandler},
       {"/api/login", HTTP_POST, apiLoginHandler},
       {"/api/status", HTTP_GET, apiStatusHandler},
       {"/api/datalogger/stats", HTTP_GET, apiDataLoggerStatsHandler},
-      {"/api/datalogger/format", HTTP_POST, apiDataLoggerFormatHandler},
+      {"/api/datalogger/metrics", HTTP_GET, apiDataLoggerMetricsHandler},
+      {"/api/datalogger/decoded", HTTP_GET, apiDataLoggerDecodedHandler},
       {"/api/wifi/config", HTTP_POST, apiWifiConfigHandler},
       {"/api/user/config", HTTP_POST, apiUserConfigHandler},
-      {"/api/system/reboot", HTTP_POST, apiSystemRebootHandler},
       {"/api/config", HTTP_GET, apiGetFullConfigHandler},
       {"/api/config", HTTP_POST, apiSaveFullConfigHandler},
-      {"/api/mqtt/test", HTTP_POST, apiTestMqttHandler},
+      {"/api/system/ota", HTTP_GET, apiSystemOtaStatusHandler},
   };
 
   for (const auto &handler : handlers) {
     registerUri(handler);
   }
 
+  // Bulk operations, off the httpd task so the rest of the UI keeps answering
+  UriHandler heavyHandlers[] = {
+      {"/api/datalogger/format", HTTP_POST, apiDataLoggerFormatHandler},
+      {"/api/datalogger/download", HTTP_GET, apiDataLoggerDownloadHandler},
+      {"/api/datalogger/search", HTTP_GET, apiDataLoggerSearchHandler},
+      {"/api/system/reboot", HTTP_POST, apiSystemRebootHandler},
+      {"/api/system/ota", HTTP_POST, apiSystemOtaHandler},
+      {"/api/mqtt/test", HTTP_POST, apiTestMqttHandler},
+  };
+
+  for (auto &handler : heavyHandlers) {
+    handler.async = asyncReady;
+    registerUri(handler);
+  }
+
+  // Push-based dashboard (the UI polls the endpoints above without it)
+  if (s_livePushMs > 0) {
+    UriHandler live = {"/api/live", HTTP_GET, LiveFeed::handleRequest};
+    live.websocket = true;
+    if (registerUri(live) != ESP_OK ||
+        LiveFeed::start(s_serverHandle, s_livePushMs, collectLiveSample) !=
+            ESP_OK) {
+      ESP_LOGW(TAG, "Live feed unavailable, dashboard will poll");
+    }
+  }
+
   // Register WEB response callback for CommandSystem
   // Note: Individual handlers will pass their httpd_req_t as userCtx
   CommandSystem::registerResponseCallback(
@@ -115,6 +172,8 @@ esp_err_t start() {
 esp_err_t stop() {
   if (!s_running)
     return ESP_OK;
+  LiveFeed::stop();
+  AsyncWorkers::stop();
   if (s_serverHandle) {
     httpd_stop(s_serverHandle);
     s_serverHandle = nullptr;
@@ -139,6 +198,21 @@ esp_err_t registerUri(const UriHandler &handler) {
                      .handler = handler.handler,
                      .user_ctx =
                          handler.userCtx ? handler.userCtxData : nullptr};
+  if (handler.async) {
+    // The worker pool restores the handler and its context
+    void *route = nullptr;
+    esp_err_t ret = AsyncWorkers::bind(handler.handler, uri.user_ctx, &route);
+    if (ret != ESP_OK)
+      return ret;
+    uri.handler = AsyncWorkers::dispatch;
+    uri.user_ctx = route;
+  }
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+  uri.is_websocket = handler.websocket;
+#else
+  if (handler.websocket)
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
   esp_err_t ret = httpd_register_uri_handler(s_serverHandle, &uri);
   return ret;
 }
@@ -152,773 +226,114 @@ void setDataLoggerCallbacks(const DataLoggerCallbacks *cb) {
     memset(&s_dataloggerCallbacks, 0, sizeof(s_dataloggerCallbacks));
 }
 
-// ============== HTML SPA ==============
-static esp_err_t rootHandler(httpd_req_t *req) {
-  const char *html = R"HTML(
-<!DOCTYPE html>
-<html lang="es">
-<head>
-<meta charset="UTF-8">
-<meta name="viewport" content="width=device-width,initial-scale=1">
-<title>DataLogger Pro</title>
-<link rel="stylesheet" href="https://fonts.googleapis.com/css2?family=Material+Symbols+Outlined:opsz,wght,FILL,GRAD@20..48,100..700,0..1,-50..200" />
-<style>
-:root{
-  --bg:#0d1117; --card:#161b22; --border:#30363d; --text:#c9d1d9; --sub:#8b949e;
-  --accent:#58a6ff; --accent-hover:#1f6feb; --success:#238636; --danger:#da3633;
-  --font-size:14px;
-}
-*{box-sizing:border-box;margin:0;padding:0;scrollbar-width:thin;scrollbar-color:var(--border) var(--bg)}
-body{font-family:-apple-system,BlinkMacSystemFont,'Segoe UI',Roboto,Helvetica,Arial,sans-serif;background:var(--bg);color:var(--text);font-size:var(--font-size);line-height:1.5;overflow-x:hidden}
-.hidden{display:none!important}
-.container{max-width:1000px;margin:0 auto;padding:15px;animation:fadeIn 0.3s ease}
-@keyframes fadeIn{from{opacity:0;transform:translateY(5px)}to{opacity:1;transform:translateY(0)}}
-
-.header{display:flex;align-items:center;gap:15px;padding:10px 0;border-bottom:1px solid var(--border);margin-bottom:20px}
-.header img{height:40px;object-fit:contain}
-
-.nav{display:flex;gap:6px;margin-left:auto}
-.nav button{background:transparent;border:1px solid transparent;color:var(--sub);padding:10px 18px;border-radius:6px;cursor:pointer;font-size:13px;display:flex;align-items:center;gap:8px;transition:0.2s}
-.nav button:hover{background:var(--card);border-color:var(--border)}
-.nav button.active{background:var(--accent-hover);border-color:rgba(255,255,255,0.1);color:#fff}
-
-.card{background:var(--card);border-radius:8px;padding:18px;margin-bottom:18px;border:1px solid var(--border);box-shadow:0 1px 4px rgba(0,0,0,0.3)}
-.card h2{font-size:16px;color:var(--accent);margin-bottom:15px;display:flex;align-items:center;gap:10px;font-weight:600;text-transform:uppercase;letter-spacing:0.4px}
-.card h2 .material-symbols-outlined{font-size:22px}
-
-.stats-grid{display:grid;grid-template-columns:repeat(auto-fit,minmax(180px,1fr));gap:12px}
-.stat-item{background:var(--bg);padding:12px;border-radius:6px;border:1px solid #21262d}
-.stat-label{font-size:12px;color:var(--sub);margin-bottom:4px;font-weight:500}
-.stat-value{font-size:18px;font-weight:600;color:#f0f6fc;font-family:monospace}
-
-.progress-container{margin:12px 0}
-.progress-meta{display:flex;justify-content:space-between;font-size:12px;color:var(--sub);margin-bottom:6px}
-.progress{height:10px;background:var(--border);border-radius:5px;overflow:hidden}
-.progress-bar{height:100%;background:linear-gradient(90deg, #238636, #3fb950);width:0%;transition:width 0.5s ease}
-
-.form-row{display:grid;grid-template-columns:1fr 1fr;gap:15px;margin-bottom:15px}
-.form-group{margin-bottom:15px}
-.form-group label{display:block;font-size:13px;color:var(--text);margin-bottom:6px;font-weight:500}
-.form-group input, .form-group select{width:100%;padding:10px 12px;background:var(--bg);border:1px solid var(--border);border-radius:6px;color:#f0f6fc;font-size:14px;outline:none;transition:border-color 0.2s}
-.form-group input:focus{border-color:var(--accent)}
-.form-group input:disabled{color:var(--sub);background:rgba(255,255,255,0.02)}
-
-.btn{background:var(--success);color:#fff;border:1px solid rgba(240,246,252,0.1);padding:10px 22px;border-radius:6px;cursor:pointer;font-size:13px;font-weight:600;display:inline-flex;align-items:center;gap:10px;transition:0.2s;justify-content:center}
-.btn:hover{filter:brightness(1.1)}
-.btn:active{transform:scale(0.98)}
-.btn-danger{background:var(--danger)}
-.btn-secondary{background:var(--border);color:var(--text)}
-.btn-accent{background:var(--accent-hover)}
-.btn-success{background:var(--success)}
-.btn-error{background:var(--danger)}
-.btn .material-symbols-outlined{font-size:20px}
-
-.status-row{display:flex;gap:15px;margin-bottom:20px;flex-wrap:wrap}
-.status-badge{padding:8px 16px;border-radius:20px;font-size:13px;font-weight:600;display:inline-flex;align-items:center;gap:8px}
-.status-badge.ok{background:#23863620;color:#3fb950;border:1px solid #238636}
-.status-badge.err{background:#da363320;color:#f85149;border:1px solid #da3633}
-
-/* UI Elements */
-.switch-group{display:flex;align-items:center;justify-content:space-between;padding:12px;background:rgba(255,255,255,0.02);border-radius:8px;border:1px solid var(--border);margin-bottom:15px}
-.config-group{border:1px solid var(--border);border-radius:8px;margin-bottom:15px;overflow:hidden;background:rgba(255,255,255,0.01)}
-.group-header{display:flex;align-items:center;justify-content:space-between;padding:12px;background:rgba(255,255,255,0.02);border-bottom:1px solid transparent;transition:0.2s}
-.group-header.open{border-bottom-color:var(--border);background:rgba(255,255,255,0.03)}
-.group-content{padding:15px;animation:slideDown 0.2s ease}
-@keyframes slideDown{from{opacity:0;transform:translateY(-5px)}to{opacity:1;transform:translateY(0)}}
-
-.switch{position:relative;display:inline-block;width:44px;height:22px}
-.switch input{opacity:0;width:0;height:0}
-.slider{position:absolute;cursor:pointer;top:0;left:0;right:0;bottom:0;background-color:#ccc;transition:.4s;border-radius:22px}
-.slider:before{position:absolute;content:"";height:16px;width:16px;left:3px;bottom:3px;background-color:white;transition:.4s;border-radius:50%}
-input:checked + .slider{background-color:var(--success)}
-input:focus + .slider{box-shadow:0 0 1px var(--success)}
-input:checked + .slider:before{transform:translateX(22px)}
-
-.sub-card{border-top:1px solid var(--border);margin-top:15px;padding-top:15px}
-.sub-card h3{font-size:14px;color:var(--sub);margin-bottom:12px;display:flex;align-items:center;gap:8px;text-transform:uppercase;letter-spacing:1px}
-
-/* Login */
-.login-page{display:flex;height:100vh;align-items:center;justify-content:center;background:radial-gradient(circle at center, #161b22 0%, #0d1117 100%)}
-.login-card{width:400px;text-align:center;padding:40px;overflow:hidden}
-.login-card img{max-width:100%;height:auto;max-height:75px;width:auto;object-fit:contain;margin-bottom:35px;display:block;margin-left:auto;margin-right:auto}
-
-.msg{margin-top:15px;font-size:13px;padding:10px;border-radius:6px;text-align:center}
-.msg.ok{background:#23863620;color:#3fb950}
-.msg.err{background:#da363320;color:#f85149}
-
-.mac-label{font-family:monospace;background:var(--bg);padding:6px 12px;border-radius:4px;border:1px solid var(--border);color:var(--accent)}
-
-.material-symbols-outlined{font-variation-settings:'FILL' 0,'wght' 400,'GRAD' 0,'opsz' 24;vertical-align:middle}
-</style>
-</head>
-<body>
-
-<!-- LOGIN VIEW -->
-<div id="v-login" class="login-page">
-<div class="card login-card">
-  <img src="/logo.png" alt="Logo">
-  <div class="form-group"><label>Usuario</label><input type="text" id="lUser"></div>
-  <div class="form-group"><label>Contraseña</label><input type="password" id="lPass"></div>
-  <button class="btn" style="width:100%;justify-content:center;margin-top:15px" onclick="doLogin()">
-    <span class="material-symbols-outlined">key</span> Ingresar
-  </button>
-  <div id="lMsg" class="msg hidden"></div>
-</div>
-</div>
-
-<!-- MAIN DASHBOARD -->
-<div id="v-dash" class="container hidden">
-<div class="header">
-  <img src="/logo.png" alt="Logo">
-  <div class="nav">
-    <button class="active" onclick="showView('dash')"><span class="material-symbols-outlined">monitoring</span> Estado</button>
-    <button onclick="showView('config')"><span class="material-symbols-outlined">settings</span> Configuración</button>
-    <button onclick="logout()"><span class="material-symbols-outlined">logout</span></button>
-  </div>
-</div>
-
-<div class="status-row">
-  <div id="ethStat" class="status-badge err">Ethernet: Offline</div>
-  <div id="wifiStat" class="status-badge err">WiFi: Offline</div>
-</div>
-
-<div class="card">
-  <h2><span class="material-symbols-outlined">storage</span> Memoria Datalog</h2>
-  <div class="progress-container">
-    <div class="progress-meta"><span id="flashLabels">- / -</span><span id="flashPct">0%</span></div>
-    <div class="progress"><div id="flashBar" class="progress-bar"></div></div>
-  </div>
-  <div class="stats-grid">
-    <div class="stat-item"><div class="stat-label">Usado</div><div id="sUsed" class="stat-value">-</div></div>
-    <div class="stat-item"><div class="stat-label">Libre</div><div id="sFree" class="stat-value">-</div></div>
-    <div class="stat-item"><div class="stat-label">Vueltas</div><div id="sWrap" class="stat-value">-</div></div>
-    <div class="stat-item"><div class="stat-label">Total Escrito</div><div id="sTot" class="stat-value">-</div></div>
-  </div>
-</div>
-
-<div style="display:grid;grid-template-columns:1fr 1fr;gap:15px">
-  <div class="card">
-    <h2><span class="material-symbols-outlined">cable</span> Transporte</h2>
-    <div style="margin-bottom:10px"><div class="stat-label">Modo</div><div id="tType" class="stat-value">-</div></div>
-    <div class="grid" style="grid-template-columns:1fr 1fr">
-      <div class="stat-item"><div class="stat-label">Total MiB</div><div id="tBytes" class="stat-value">-</div></div>
-      <div class="stat-item"><div class="stat-label">Ráfagas</div><div id="tBurst" class="stat-value">-</div></div>
-    </div>
-  </div>
-  <div class="card">
-    <h2><span class="material-symbols-outlined">schema</span> Pipeline</h2>
-    <div style="margin-bottom:10px"><div class="stat-label">Estado</div><div id="pStat" class="stat-value">-</div></div>
-    <div class="grid" style="grid-template-columns:1fr 1fr">
-      <div class="stat-item"><div class="stat-label">Escrito</div><div id="pWr" class="stat-value">-</div></div>
-      <div class="stat-item"><div class="stat-label">Descartado</div><div id="pDr" class="stat-value">-</div></div>
-    </div>
-  </div>
-</div>
-</div>
-
-<!-- CONFIGURATION VIEW -->
-<div id="v-config" class="container hidden">
-<div class="header">
-  <img src="/logo.png" alt="Logo">
-  <div class="nav">
-    <button onclick="showView('dash')"><span class="material-symbols-outlined">monitoring</span> Estado</button>
-    <button class="active" onclick="showView('config')"><span class="material-symbols-outlined">settings</span> Configuración</button>
-    <button onclick="logout()"><span class="material-symbols-outlined">logout</span></button>
-  </div>
-</div>
-
-<!-- 1. BLOQUE DISPOSITIVO -->
-<div class="card">
-  <h2><span class="material-symbols-outlined">router</span> Dispositivo</h2>
-  <div class="form-row">
-    <div class="form-group"><label>Nombre del Dispositivo</label><input type="text" id="devName" placeholder="Ej: Planta 1"></div>
-    <div class="form-group"><label>Tipo de Dispositivo</label>
-      <select id="devType" onchange="uiUpdateBlocks()">
-        <option value="COORDINADOR">COORDINADOR</option>
-        <option value="ENDPOINT">ENDPOINT</option>
-      </select>
-    </div>
-  </div>
-  <div class="form-group">
-    <label>ID del Dispositivo</label>
-    <span id="devMac" class="mac-label">C0:4E:30:XX:XX:XX</span>
-  </div>
-</div>
-
-<!-- 2. BLOQUE COMUNICACIONES -->
-<div class="card">
-  <h2><span class="material-symbols-outlined">hub</span> Comunicaciones</h2>
-  
-  <!-- A. LAN -->
-  <div class="config-group">
-    <div id="lanHead" class="group-header">
-      <div style="display:flex;align-items:center;gap:10px"><span class="material-symbols-outlined">lan</span> <strong>LAN (Ethernet W5500)</strong></div>
-      <label class="switch"><input type="checkbox" id="lanEn" onchange="uiToggleGroup('lan', this.checked)"><span class="slider"></span></label>
-    </div>
-    <div id="lanSet" class="group-content hidden">
-      <div class="form-row">
-        <div class="form-group"><label>DHCP</label>
-          <select id="lanDhcp" onchange="uiToggleSection('lanIpSet', this.value=='static')">
-            <option value="dhcp">Activado (Auto)</option>
-            <option value="static">Desactivado (Manual)</option>
-          </select>
-        </div>
-        <div></div>
-      </div>
-      <div id="lanIpSet" class="hidden">
-        <div class="form-row">
-          <div class="form-group"><label>Dirección IP</label><input type="text" id="lanIp"></div>
-          <div class="form-group"><label>Máscara de Subred</label><input type="text" id="lanMask"></div>
-        </div>
-        <div class="form-group"><label>Puerta de Enlace</label><input type="text" id="lanGw"></div>
-      </div>
-    </div>
-  </div>
-
-  <!-- B. WLAN-OP (STA) -->
-  <div class="config-group">
-    <div id="staHead" class="group-header">
-      <div style="display:flex;align-items:center;gap:10px"><span class="material-symbols-outlined">wifi</span> <strong>WLAN-OP (Modo STA)</strong></div>
-      <label class="switch"><input type="checkbox" id="staEn" onchange="uiToggleGroup('sta', this.checked)"><span class="slider"></span></label>
-    </div>
-    <div id="staSet" class="group-content hidden">
-      <div class="form-row">
-        <div class="form-group"><label>SSID</label><input type="text" id="staSsid"></div>
-        <div class="form-group"><label>Contraseña</label><input type="password" id="staPass"></div>
-      </div>
-      <div class="form-row">
-        <div class="form-group"><label>Modo IP</label>
-          <select id="staDhcp" onchange="uiToggleSection('staIpSet', this.value=='static')">
-            <option value="dhcp">DHCP</option>
-            <option value="static">Estática</option>
-          </select>
-        </div>
-        <div></div>
-      </div>
-      <div id="staIpSet" class="hidden">
-        <div class="form-row">
-          <div class="form-group"><label>Dirección IP</label><input type="text" id="staIp"></div>
-          <div class="form-group"><label>Máscara de Subred</label><input type="text" id="staMask"></div>
-        </div>
-        <div class="form-group"><label>Puerta de Enlace</label><input type="text" id="staGw"></div>
-      </div>
-    </div>
-  </div>
-
-  <!-- C. WLAN-SAFE (AP) -->
-  <div class="config-group">
-    <div class="group-header open">
-      <div style="display:flex;align-items:center;gap:10px"><span class="material-symbols-outlined">security</span> <strong>WLAN-SAFE (Modo AP)</strong></div>
-      <div></div>
-    </div>
-    <div class="group-content">
-      <div class="form-row">
-        <div class="form-group"><label>SSID del AP</label><input type="text" id="apSsid"></div>
-        <div class="form-group"><label>Contraseña</label><input type="password" id="apPass"></div>
-      </div>
-      <div class="form-row">
-        <div class="form-group"><label>Canal</label>
-          <select id="apChan">
-            <option value="1">Canal 1</option><option value="2">Canal 2</option><option value="3">Canal 3</option>
-            <option value="4">Canal 4</option><option value="5">Canal 5</option><option value="6">Canal 6</option>
-            <option value="7">Canal 7</option><option value="8">Canal 8</option><option value="9">Canal 9</option>
-            <option value="10">Canal 10</option><option value="11">Canal 11</option>
-          </select>
-        </div>
-        <div class="form-group"><label>Visibilidad</label>
-          <select id="apHid"><option value="0">Visible</option><option value="1">Oculto</option></select>
-        </div>
-      </div>
-      <div class="form-group"><label>IP Local del AP</label><input type="text" id="apIp" value="192.168.4.1"></div>
-    </div>
-  </div>
-</div>
-
-<!-- 3. BLOQUES CONDICIONALES -->
-<!-- COORDINADOR -->
-<div id="blkCoord" class="card hidden">
-  <h2><span class="material-symbols-outlined">hub</span> Configuración de Coordinador</h2>
-  <div style="padding:20px;text-align:center;color:var(--sub)">Sin parámetros adicionales por el momento.</div>
-</div>
-
-<!-- ENDPOINT -->
-<div id="blkEnd" class="card hidden">
-  <h2><span class="material-symbols-outlined">data_saver_on</span> Configuracion del END POINT</h2>
-  <div class="form-group"><label>Nombre del Huesped</label><input type="text" id="hostName"></div>
-  <div class="form-group"><label>Origen de Datos</label>
-    <select id="srcType" onchange="uiUpdateDataSource()">
-      <option value="SERIE">SERIE</option>
-      <option value="PARALELO">PARALELO</option>
-      <option value="DESHABILITADO">DESHABILITADO</option>
-    </select>
-  </div>
-
-  <div id="srcSerie" class="sub-card hidden">
-    <h3><span class="material-symbols-outlined">settings_input_component</span> Configuración Serie</h3>
-    <div class="form-row">
-      <div class="form-group"><label>Interfaz Física</label>
-        <select id="serIf"><option value="RS232">RS232</option><option value="RS485">RS485</option></select>
-      </div>
-      <div class="form-group"><label>Baudios</label>
-        <select id="serBaud">
-          <option value="9600">9600</option><option value="19200">19200</option><option value="38400">38400</option>
-          <option value="57600">57600</option><option value="115200" selected>115200</option><option value="230400">230400</option>
-          <option value="460800">460800</option><option value="921600">921600</option>
-        </select>
-      </div>
-    </div>
-    <div class="form-row">
-      <div class="form-group"><label>Bits de Datos</label>
-        <select id="serBits"><option value="5">5</option><option value="6">6</option><option value="7">7</option><option value="8" selected>8</option></select>
-      </div>
-      <div class="form-group"><label>Paridad</label>
-        <select id="serPari"><option value="none">Ninguna</option><option value="even">Par</option><option value="odd">Impar</option></select>
-      </div>
-    </div>
-    <div class="form-group"><label>Bits de Parada</label>
-      <select id="serStop"><option value="1">1</option><option value="1.5">1.5</option><option value="2">2</option></select>
-    </div>
-  </div>
-</div>
-
-<!-- MQTT BROKER (Sólo ENDPOINT) -->
-<div id="blkMqtt" class="card hidden">
-  <h2><span class="material-symbols-outlined">cloud_queue</span> MQTT Broker</h2>
-  <div class="form-row">
-    <div class="form-group" style="display:flex;align-items:flex-end;gap:8px">
-      <div style="flex:1"><label>Host / IP</label><input type="text" id="mqHost" placeholder="iot.eclipse.org"></div>
-      <button class="btn btn-secondary" onclick="testMqttConnection()" id="mqTestBtn" style="white-space:nowrap;padding:10px 16px">
-        <span class="material-symbols-outlined">network_check</span> Test
-      </button>
-    </div>
-    <div class="form-group"><label>Puerto</label><input type="number" id="mqPort" value="1883"></div>
-    <div class="form-group"><label>QoS</label><input type="number" id="mqQos" value="1" min="0" max="2"></div>
-  </div>
-  <div class="switch-group" style="margin-bottom:12px">
-    <div style="display:flex;align-items:center;gap:10px"><span class="material-symbols-outlined">security</span> <strong>Usar Autenticación</strong></div>
-    <label class="switch"><input type="checkbox" id="mqAuth" onchange="uiMqttAuthToggle(this.checked)"><span class="slider"></span></label>
-  </div>
-  <div class="form-row">
-    <div class="form-group"><label>Usuario</label><input type="text" id="mqUser" disabled></div>
-    <div class="form-group"><label>Contraseña</label><input type="password" id="mqPass" disabled></div>
-  </div>
-  <div class="form-row">
-    <div class="form-group"><label>Topic Publicación (pub)</label><input type="text" id="mqPub"></div>
-    <div class="form-group"><label>Topic Suscripción (sub)</label><input type="text" id="mqSub"></div>
-  </div>
-</div>
-
-<!-- 4. BLOQUE SISTEMA -->
-<div class="card">
-  <h2><span class="material-symbols-outlined">settings</span> Sistema</h2>
-  
-  <div class="form-row">
-    <!-- Memoria -->
-    <div class="sub-card" style="margin-top:0;padding-top:0">
-      <h3><span class="material-symbols-outlined">memory</span> Memoria</h3>
-      <div style="display:flex;flex-direction:column;gap:12px">
-        <button class="btn btn-secondary" onclick="uiFlashDownload()"><span class="material-symbols-outlined">download_for_offline</span> Descargar Flash</button>
-        <button class="btn btn-danger" onclick="formatFlash()"><span class="material-symbols-outlined">delete_forever</span> Formatear Flash</button>
-      </div>
-    </div>
-    <!-- Backup -->
-    <div class="sub-card" style="margin-top:0;padding-top:0">
-      <h3><span class="material-symbols-outlined">cloud_download</span> Backup</h3>
-      <div style="display:flex;flex-direction:column;gap:12px">
-        <button class="btn btn-secondary" onclick="uiBackupDownload()"><span class="material-symbols-outlined">download</span> Descargar JSON</button>
-        <div style="border:1px dashed var(--border);padding:10px;border-radius:6px">
-          <input type="file" id="bkFile" style="width:100%;font-size:12px" accept=".json">
-          <button class="btn btn-secondary" style="width:100%;margin-top:8px" onclick="uiBackupUpload()"><span class="material-symbols-outlined">upload</span> Cargar Backup</button>
-        </div>
-      </div>
-    </div>
-  </div>
-
-  <div class="sub-card">
-    <h3><span class="material-symbols-outlined">lock</span> Acceso WEB</h3>
-    <div class="form-row">
-      <div class="form-group"><label>Usuario Operador</label><input type="text" id="nuName"></div>
-      <div class="form-group"><label>Nueva Contraseña</label><input type="password" id="nuPass"></div>
-    </div>
-  </div>
-
-  <div class="sub-card" style="display:flex;gap:12px;justify-content:flex-end">
-    <button class="btn btn-accent" onclick="saveAll()"><span class="material-symbols-outlined">save</span> GUARDAR</button>
-    <button class="btn btn-secondary" onclick="loadConfig()"><span class="material-symbols-outlined">history</span> RESTAURAR</button>
-    <button class="btn btn-danger" onclick="reboot()"><span class="material-symbols-outlined">restart_alt</span> REINICIAR</button>
-  </div>
-</div>
-
-<div id="cfgMsg" class="msg hidden"></div>
-</div>
-
-<script>
-let token=sessionStorage.getItem('auth')||'';
-let pollInt;
-
-function showView(v){
-  const views=['v-login','v-dash','v-config'];
-  views.forEach(id=>document.getElementById(id).classList.add('hidden'));
-  document.getElementById('v-'+v).classList.remove('hidden');
-  document.querySelectorAll('.nav button').forEach(b=>b.classList.remove('active'));
-  const btns=document.querySelectorAll('.nav button');
-  if(v==='dash'&&btns[0])btns[0].classList.add('active');
-  if(v==='config'&&btns[1])btns[1].classList.add('active');
-  if(v==='config'){ loadConfig(); }
-}
-
-/* UI Dynamics */
-function uiUpdateBlocks(){
-  const type=document.getElementById('devType').value;
-  document.getElementById('blkCoord').classList.toggle('hidden', type!=='COORDINADOR');
-  document.getElementById('blkEnd').classList.toggle('hidden', type!=='ENDPOINT');
-  document.getElementById('blkMqtt').classList.toggle('hidden', type!=='ENDPOINT');
-  if(type==='ENDPOINT') uiUpdateDataSource();
+// ============== Static assets ==============
+// Embedded by src/CMakeLists.txt from webserver/www. The SPA is stored
+// gzipped; every browser sends Accept-Encoding: gzip, so it is served as is.
+extern const uint8_t indexHtmlGzStart[] asm("_binary_index_html_gz_start");
+extern const uint8_t indexHtmlGzEnd[] asm("_binary_index_html_gz_end");
+extern const uint8_t logoPngStart[] asm("_binary_logo_png_start");
+extern const uint8_t logoPngEnd[] asm("_binary_logo_png_end");
+
+struct StaticAsset {
+  const uint8_t *start;
+  const uint8_t *end;
+  const char *type;
+  const char *encoding;     ///< Content-Encoding, nullptr if stored plain
+  const char *cacheControl;
+  char etag[24];            ///< Strong ETag, filled in by initAssetEtags()
+};
+
+// The SPA is revalidated on every load so a firmware update shows up at
+// once (the check is a bodyless 304); the logo is cached for a week
+static StaticAsset s_indexAsset = {indexHtmlGzStart, indexHtmlGzEnd,
+                                   "text/html", "gzip", "no-cache", {}};
+static StaticAsset s_logoAsset = {logoPngStart, logoPngEnd, "image/png",
+                                  nullptr, "public, max-age=604800", {}};
+
+// ETags come from the embedded bytes, so they change with the content
+static void initAssetEtags() {
+  for (StaticAsset *asset : {&s_indexAsset, &s_logoAsset}) {
+    size_t size = asset->end - asset->start;
+    uint32_t crc = esp_crc32_le(0, asset->start, size);
+    snprintf(asset->etag, sizeof(asset->etag), "\"%08" PRIx32 "-%x\"", crc,
+             (unsigned)size);
+  }
 }
 
-function uiUpdateDataSource(){
-  const src=document.getElementById('srcType').value;
-  document.getElementById('srcSerie').classList.toggle('hidden', src!=='SERIE');
-}
+static esp_err_t sendStaticAsset(httpd_req_t *req, const StaticAsset &asset) {
+  httpd_resp_set_hdr(req, "ETag", asset.etag);
+  httpd_resp_set_hdr(req, "Cache-Control", asset.cacheControl);
+  if (asset.encoding) {
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+  }
 
-function uiToggleSection(id, show){
-  document.getElementById(id).classList.toggle('hidden', !show);
-}
+  // Revalidation: answer 304 without the body when the client's copy matches
+  char ifNoneMatch[96];
+  if (httpd_req_get_hdr_value_str(req, "If-None-Match", ifNoneMatch,
+                                  sizeof(ifNoneMatch)) == ESP_OK &&
+      (strstr(ifNoneMatch, asset.etag) || strcmp(ifNoneMatch, "*") == 0)) {
+    httpd_resp_set_status(req, "304 Not Modified");
+    return httpd_resp_send(req, nullptr, 0);
+  }
 
-function uiToggleGroup(prefix, show){
-  const head = document.getElementById(prefix + 'Head');
-  const body = document.getElementById(prefix + 'Set');
-  if(head) head.classList.toggle('open', show);
-  if(body) body.classList.toggle('hidden', !show);
+  httpd_resp_set_type(req, asset.type);
+  if (asset.encoding) {
+    httpd_resp_set_hdr(req, "Content-Encoding", asset.encoding);
+  }
+  return httpd_resp_send(req, (const char *)asset.start,
+                         asset.end - asset.start);
 }
 
-function uiMqttAuthToggle(show){
-  document.getElementById('mqUser').disabled = !show;
-  document.getElementById('mqPass').disabled = !show;
+static esp_err_t rootHandler(httpd_req_t *req) {
+  return sendStaticAsset(req, s_indexAsset);
 }
 
-function testMqttConnection(){
-  const btn=document.getElementById('mqTestBtn');
-  const host=document.getElementById('mqHost').value;
-  const port=parseInt(document.getElementById('mqPort').value)||1883;
-  const qos=parseInt(document.getElementById('mqQos').value)||1;
-  const useAuth=document.getElementById('mqAuth').checked;
-  const username=document.getElementById('mqUser').value;
-  const password=document.getElementById('mqPass').value;
-  
-  if(!host){
-    const m=document.getElementById('cfgMsg');
-    if(m){m.className='msg err';m.textContent='Por favor ingrese un Host/IP';m.classList.remove('hidden');setTimeout(()=>m.classList.add('hidden'),3000);}
-    return;
-  }
-  
-  if(btn){
-    btn.disabled=true;
-    // Guardar estado original
-    const originalText=btn.innerHTML;
-    const originalClasses=btn.className;
-    // Estado de prueba
-    btn.className='btn btn-secondary';
-    btn.innerHTML='<span class="material-symbols-outlined">hourglass_empty</span> Probando...';
-    
-    const testCfg={
-      host:host,
-      port:port,
-      qos:qos,
-      useAuth:useAuth,
-      username:useAuth?username:'',
-      password:useAuth?password:''
-    };
-    
-    fetch('/api/mqtt/test',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(testCfg)})
-      .then(r=>r.json())
-      .then(d=>{
-        const m=document.getElementById('cfgMsg');
-        if(m){
-          m.className='msg '+(d.success?'ok':'err');
-          m.textContent=d.success?(d.message||'Conexión exitosa'):(d.error||'Error de conexión');
-          m.classList.remove('hidden');
-          setTimeout(()=>m.classList.add('hidden'),5000);
-        }
-        // Cambiar color del botón según resultado
-        if(d.success){
-          btn.className='btn btn-success';
-          btn.innerHTML='<span class="material-symbols-outlined">check_circle</span> OK';
-        }else{
-          btn.className='btn btn-error';
-          btn.innerHTML='<span class="material-symbols-outlined">error</span> Error';
-        }
-        btn.disabled=false;
-        // Restaurar estado original después de 3 segundos
-        setTimeout(()=>{
-          btn.className=originalClasses;
-          btn.innerHTML=originalText;
-        },3000);
-      })
-      .catch(e=>{
-        const m=document.getElementById('cfgMsg');
-        if(m){m.className='msg err';m.textContent='Error de conexión: '+e.message;m.classList.remove('hidden');setTimeout(()=>m.classList.add('hidden'),5000);}
-        // Botón en rojo por error
-        btn.className='btn btn-error';
-        btn.innerHTML='<span class="material-symbols-outlined">error</span> Error';
-        btn.disabled=false;
-        // Restaurar estado original después de 3 segundos
-        setTimeout(()=>{
-          btn.className=originalClasses;
-          btn.innerHTML=originalText;
-        },3000);
-      });
-  }
+static esp_err_t logoHandler(httpd_req_t *req) {
+  return sendStaticAsset(req, s_logoAsset);
 }
 
-/* Save Configuration */
-function saveAll(){
-  const cfg={
-    device:{
-      type:document.getElementById('devType').value==='COORDINADOR'?0:1,
-      name:document.getElementById('devName').value||'DataLogger',
-      id:document.getElementById('devMac')?document.getElementById('devMac').textContent:''
-    },
-    network:{
-      lan:{
-        enabled:document.getElementById('lanEn')?document.getElementById('lanEn').checked:true,
-        useDhcp:document.getElementById('lanDhcp')?document.getElementById('lanDhcp').value==='dhcp':false,
-        staticIp:document.getElementById('lanIp')?document.getElementById('lanIp').value:'192.168.29.10',
-        netmask:document.getElementById('lanMask')?document.getElementById('lanMask').value:'255.255.255.0',
-        gateway:document.getElementById('lanGw')?document.getElementById('lanGw').value:'192.168.29.1'
-      },
-      wlanOp:{
-        enabled:document.getElementById('staEn')?document.getElementById('staEn').checked:false,
-        ssid:document.getElementById('staSsid')?document.getElementById('staSsid').value:'',
-        password:document.getElementById('staPass')?document.getElementById('staPass').value:'',
-        useDhcp:document.getElementById('staDhcp')?document.getElementById('staDhcp').value==='dhcp':true,
-        staticIp:document.getElementById('staIp')?document.getElementById('staIp').value:'192.168.1.50',
-        netmask:document.getElementById('staMask')?document.getElementById('staMask').value:'255.255.255.0',
-        gateway:document.getElementById('staGw')?document.getElementById('staGw').value:'192.168.1.1'
-      },
-      wlanSafe:{
-        ssid:document.getElementById('apSsid')?document.getElementById('apSsid').value:'DataLogger-AP',
-        password:document.getElementById('apPass')?document.getElementById('apPass').value:'12345678',
-        channel:parseInt(document.getElementById('apCh')?document.getElementById('apCh').value:6),
-        hidden:document.getElementById('apHidden')?document.getElementById('apHidden').checked:false,
-        apIp:document.getElementById('apIp')?document.getElementById('apIp').value:'192.168.4.1'
-      },
-      webServerPort:80
-    },
-    endpoint:{
-      hostName:document.getElementById('hostName')?document.getElementById('hostName').value:'Device01',
-      source:document.getElementById('srcType')&&document.getElementById('srcType').value==='SERIE'?1:0,
-      serial:{
-        interface:document.getElementById('serInt')&&document.getElementById('serInt').value==='RS485'?1:0,
-        baudRate:parseInt(document.getElementById('serBaud')?document.getElementById('serBaud').value:115200),
-        dataBits:8,
-        parity:0,
-        stopBits:1
-      }
-    },
-    mqtt:{
-      host:document.getElementById('mqHost')?document.getElementById('mqHost').value:'mqtt.example.com',
-      port:parseInt(document.getElementById('mqPort')?document.getElementById('mqPort').value:1883),
-      qos:parseInt(document.getElementById('mqQos')?document.getElementById('mqQos').value:1),
-      useAuth:document.getElementById('mqAuth')?document.getElementById('mqAuth').checked:false,
-      username:document.getElementById('mqUser')?document.getElementById('mqUser').value:'',
-      password:document.getElementById('mqPass')?document.getElementById('mqPass').value:'',
-      topicPub:document.getElementById('mqPub')?document.getElementById('mqPub').value:'datalogger/telemetry',
-      topicSub:document.getElementById('mqSub')?document.getElementById('mqSub').value:'datalogger/commands'
-    },
-    webUser:{
-      username:document.getElementById('nuName')?document.getElementById('nuName').value:'admin',
-      password:document.getElementById('nuPass')?document.getElementById('nuPass').value:'admin'
-    }
-  };
-  fetch('/api/config',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(cfg)}).then(r=>r.json()).then(d=>{
-    const m=document.getElementById('cfgMsg');
-    if(m){m.className='msg '+(d.success?'ok':'err');m.textContent=d.success?'Configuración guardada correctamente':(d.error||'Error al guardar');m.classList.remove('hidden');setTimeout(()=>m.classList.add('hidden'),5000);}
-  }).catch(e=>{
-    const m=document.getElementById('cfgMsg');
-    if(m){m.className='msg err';m.textContent='Error de conexión';m.classList.remove('hidden');setTimeout(()=>m.classList.add('hidden'),5000);}
-  });
-}
-function uiBackupDownload(){ alert('Descargando backup.json...'); }
-function uiBackupUpload(){ alert('Cargando backup.json...'); }
-function uiFlashDownload(){ alert('Descargando volcado de flash (bin)...'); }
-
-/* Standard Actions */
-function doLogin(){
-  const u=document.getElementById('lUser').value;
-  const p=document.getElementById('lPass').value;
-  const msg=document.getElementById('lMsg');
-  fetch('/api/login',{method:'POST',body:JSON.stringify({user:u,pass:p})}).then(r=>r.json()).then(d=>{
-    if(d.success){token=d.token;sessionStorage.setItem('auth',token);showView('dash');startPolling();}
-    else{msg.className='msg err';msg.textContent=d.error;msg.classList.remove('hidden');}
-  });
-}
-function logout(){token='';sessionStorage.removeItem('auth');stopPolling();showView('login');}
-function fmtB(b){if(b===0)return'0 B';const k=1024,s=['B','KiB','MiB','GiB'];const i=Math.floor(Math.log(b)/Math.log(k));return(b/Math.pow(k,i)).toFixed(2)+' '+s[i];}
-
-function refresh(){
-  fetch('/api/status').then(r=>r.json()).then(d=>{
-    const e=document.getElementById('ethStat');
-    if(d.ethernet&&d.ethernet.connected){ e.className='status-badge ok'; e.innerHTML='<span class="material-symbols-outlined">lan</span> Ethernet: '+d.ethernet.ip; } 
-    else { e.className='status-badge err'; e.innerHTML='<span class="material-symbols-outlined">link_off</span> Ethernet: Offline'; }
-    const w=document.getElementById('wifiStat');
-    if(d.wifi&&d.wifi.connected){ w.className='status-badge ok'; w.innerHTML='<span class="material-symbols-outlined">wifi</span> WiFi: '+d.wifi.ip; } 
-    else { w.className='status-badge err'; w.innerHTML='<span class="material-symbols-outlined">wifi_off</span> WiFi: Offline'; }
-  });
-  fetch('/api/datalogger/stats').then(r=>r.json()).then(d=>{
-    if(d.flash){
-      document.getElementById('sUsed').textContent=fmtB(d.flash.usedBytes);
-      document.getElementById('sFree').textContent=fmtB(d.flash.freeBytes);
-      document.getElementById('sTot').textContent=fmtB(d.flash.totalWritten);
-      document.getElementById('sWrap').textContent=d.flash.wrapCount;
-      document.getElementById('flashBar').style.width=d.flash.usedPercent+'%';
-      document.getElementById('flashPct').textContent=Math.round(d.flash.usedPercent)+'%';
-      document.getElementById('flashLabels').textContent=fmtB(d.flash.usedBytes)+' / '+fmtB(d.flash.partitionSize);
-    }
-  });
+/**
+ * @brief Root account or the configured web user
+ */
+static bool credentialsValid(const char *user, const char *pass) {
+  if (strcmp(user, ROOT_USER) == 0 && strcmp(pass, ROOT_PASS) == 0)
+    return true;
+  ConfigManager::FullConfig cfg;
+  if (ConfigManager::getSections(ConfigManager::SECTION_WEB_USER, &cfg) !=
+      ESP_OK)
+    return false;
+  return strcmp(user, cfg.webUser.username) == 0 &&
+         strcmp(pass, cfg.webUser.password) == 0;
 }
 
-function loadConfig(){
-  fetch('/api/config').then(r=>r.json()).then(d=>{
-    if(d.device){
-      const devTypeEl=document.getElementById('devType');
-      if(devTypeEl){
-        devTypeEl.value=d.device.type===0?'COORDINADOR':'ENDPOINT';
-        // Actualizar bloques después de establecer el tipo de dispositivo
-        uiUpdateBlocks();
-      }
-      document.getElementById('devName').value=d.device.name||'';
-      const macEl=document.getElementById('devMac');
-      if(macEl)macEl.textContent=d.device.id||'';
-    }
-    if(d.network&&d.network.lan){
-      const lanEn=document.getElementById('lanEn');
-      if(lanEn){lanEn.checked=d.network.lan.enabled;uiToggleGroup('lan',d.network.lan.enabled);}
-      const lanDhcp=document.getElementById('lanDhcp');
-      if(lanDhcp){
-        lanDhcp.value=d.network.lan.useDhcp?'dhcp':'static';
-        // Actualizar visibilidad de campos IP según el modo DHCP
-        uiToggleSection('lanIpSet', lanDhcp.value==='static');
-      }
-      const lanIp=document.getElementById('lanIp');
-      if(lanIp)lanIp.value=d.network.lan.staticIp||'';
-      const lanMask=document.getElementById('lanMask');
-      if(lanMask)lanMask.value=d.network.lan.netmask||'';
-      const lanGw=document.getElementById('lanGw');
-      if(lanGw)lanGw.value=d.network.lan.gateway||'';
+/**
+ * @brief Check an "Authorization: Basic" header against the /api/login
+ *        credentials; on failure the 401 is already sent
+ */
+static bool requireLogin(httpd_req_t *req) {
+  // "Basic " + base64 of a 31-char user, ':' and a 31-char password
+  char header[96];
+  unsigned char decoded[72];
+  size_t len = 0;
+  bool valid = false;
+  if (httpd_req_get_hdr_value_str(req, "Authorization", header,
+                                  sizeof(header)) == ESP_OK &&
+      strncmp(header, "Basic ", 6) == 0 &&
+      mbedtls_base64_decode(decoded, sizeof(decoded) - 1, &len,
+                            (const unsigned char *)header + 6,
+                            strlen(header + 6)) == 0) {
+    decoded[len] = '\0';
+    char *colon = strchr((char *)decoded, ':');
+    if (colon) {
+      *colon = '\0';
+      valid = credentialsValid((const char *)decoded, colon + 1);
     }
-    if(d.network&&d.network.wlanOp){
-      const staEn=document.getElementById('staEn');
-      if(staEn){staEn.checked=d.network.wlanOp.enabled;uiToggleGroup('sta',d.network.wlanOp.enabled);}
-      const staSsid=document.getElementById('staSsid');
-      if(staSsid)staSsid.value=d.network.wlanOp.ssid||'';
-      const staPass=document.getElementById('staPass');
-      if(staPass)staPass.value=d.network.wlanOp.password||'';
-      const staDhcp=document.getElementById('staDhcp');
-      if(staDhcp){
-        staDhcp.value=d.network.wlanOp.useDhcp?'dhcp':'static';
-        // Actualizar visibilidad de campos IP según el modo DHCP
-        uiToggleSection('staIpSet', staDhcp.value==='static');
-      }
-      const staIp=document.getElementById('staIp');
-      if(staIp)staIp.value=d.network.wlanOp.staticIp||'';
-      const staMask=document.getElementById('staMask');
-      if(staMask)staMask.value=d.network.wlanOp.netmask||'';
-      const staGw=document.getElementById('staGw');
-      if(staGw)staGw.value=d.network.wlanOp.gateway||'';
-    }
-    if(d.network&&d.network.wlanSafe){
-      const apSsid=document.getElementById('apSsid');
-      if(apSsid)apSsid.value=d.network.wlanSafe.ssid||'';
-      const apPass=document.getElementById('apPass');
-      if(apPass)apPass.value=d.network.wlanSafe.password||'';
-      const apCh=document.getElementById('apCh');
-      if(apCh)apCh.value=d.network.wlanSafe.channel||6;
-    }
-    if(d.endpoint){
-      const epHost=document.getElementById('hostName');
-      if(epHost)epHost.value=d.endpoint.hostName||'';
-      const srcType=document.getElementById('srcType');
-      if(srcType){
-        if(d.endpoint.source===1)srcType.value='SERIE';
-        else if(d.endpoint.source===2)srcType.value='PARALELO';
-        else srcType.value='DESHABILITADO';
-        // Actualizar visibilidad del bloque de fuente de datos
-        uiUpdateDataSource();
-      }
-      if(d.endpoint.serial){
-        const serBaud=document.getElementById('serBaud');
-        if(serBaud)serBaud.value=d.endpoint.serial.baudRate||115200;
-        const serIf=document.getElementById('serIf');
-        if(serIf)serIf.value=d.endpoint.serial.interface===1?'RS485':'RS232';
-        const serBits=document.getElementById('serBits');
-        if(serBits)serBits.value=d.endpoint.serial.dataBits||8;
-        const serPari=document.getElementById('serPari');
-        if(serPari){
-          if(d.endpoint.serial.parity===1)serPari.value='even';
-          else if(d.endpoint.serial.parity===2)serPari.value='odd';
-          else serPari.value='none';
-        }
-        const serStop=document.getElementById('serStop');
-        if(serStop)serStop.value=d.endpoint.serial.stopBits===2?2:1;
-      }
-    }
-    if(d.mqtt){
-      const mqHost=document.getElementById('mqHost');
-      if(mqHost)mqHost.value=d.mqtt.host||'';
-      const mqPort=document.getElementById('mqPort');
-      if(mqPort)mqPort.value=d.mqtt.port||1883;
-      const mqQos=document.getElementById('mqQos');
-      if(mqQos)mqQos.value=d.mqtt.qos!==undefined?d.mqtt.qos:1;
-      const mqAuth=document.getElementById('mqAuth');
-      if(mqAuth){mqAuth.checked=d.mqtt.useAuth;uiMqttAuthToggle(d.mqtt.useAuth);}
-      const mqUser=document.getElementById('mqUser');
-      if(mqUser)mqUser.value=d.mqtt.username||'';
-      const mqPass=document.getElementById('mqPass');
-      if(mqPass)mqPass.value=d.mqtt.password||'';
-      const mqPub=document.getElementById('mqPub');
-      if(mqPub)mqPub.value=d.mqtt.topicPub||'';
-      const mqSub=document.getElementById('mqSub');
-      if(mqSub)mqSub.value=d.mqtt.topicSub||'';
-    }
-    if(d.webUser){
-      const nuName=document.getElementById('nuName');
-      if(nuName)nuName.value=d.webUser.username||'';
-      const nuPass=document.getElementById('nuPass');
-      if(nuPass)nuPass.value=d.webUser.password||'';
-    }
-  });
-}
-function saveUser(){
-  const u=document.getElementById('nuName').value, p=document.getElementById('nuPass').value;
-  fetch('/api/user/config',{method:'POST',body:JSON.stringify({user:u,pass:p})}).then(r=>r.json()).then(showMsg);
-}
-function showMsg(d){
-  const m=document.getElementById('cfgMsg');
-  m.className='msg '+(d.success?'ok':'err');
-  m.textContent=d.success?(d.message||'Realizado'):(d.error||'Error');
-  m.classList.remove('hidden');
-  setTimeout(()=>m.classList.add('hidden'),5000);
-}
-function formatFlash(){if(confirm('¿Borrar todos los datos?'))fetch('/api/datalogger/format',{method:'POST'}).then(r=>r.json()).then(showMsg);}
-function reboot(){if(confirm('¿Reiniciar sistema?'))fetch('/api/system/reboot',{method:'POST'});}
-function startPolling(){refresh();pollInt=setInterval(refresh,3000);}
-function stopPolling(){clearInterval(pollInt);}
-
-if(token){showView('dash');startPolling();}else showView('login');
-</script>
-</body>
-</html>
-)HTML";
-  httpd_resp_set_type(req, "text/html");
-  httpd_resp_send(req, html, strlen(html));
-  return ESP_OK;
-}
-
-static esp_err_t logoHandler(httpd_req_t *req) {
-  httpd_resp_set_type(req, "image/png");
-  httpd_resp_send(req, (const char *)LOGO_PNG_DATA, LOGO_PNG_SIZE);
-  return ESP_OK;
+  }
+  if (!valid) {
+    httpd_resp_set_hdr(req, "WWW-Authenticate", "Basic realm=\"DataLogger\"");
+    httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "Login required");
+  }
+  return valid;
 }
 
 static esp_err_t apiLoginHandler(httpd_req_t *req) {
@@ -960,14 +375,7 @@ static esp_err_t apiLoginHandler(httpd_req_t *req) {
       }
     }
   }
-  bool valid = (strcmp(user, ROOT_USER) == 0 && strcmp(pass, ROOT_PASS) == 0);
-  if (!valid) {
-    ConfigManager::FullConfig cfg;
-    if (ConfigManager::getConfig(&cfg) == ESP_OK) {
-      valid = (strcmp(user, cfg.webUser.username) == 0 &&
-               strcmp(pass, cfg.webUser.password) == 0);
-    }
-  }
+  bool valid = credentialsValid(user, pass);
   httpd_resp_set_type(req, "application/json");
   if (valid)
     httpd_resp_send(req, "{\"success\":true,\"token\":\"ok\"}", -1);
@@ -1002,13 +410,80 @@ static esp_err_t apiStatusHandler(httpd_req_t *req) {
   return ESP_OK;
 }
 
+// Snapshot for the live feed: the numbers /api/status and the stats command
+// report, read straight from the modules
+static void collectLiveSample(LiveFeed::Sample *sample) {
+  memset(sample, 0, sizeof(*sample));
+  auto ipOf = [](INetworkInterface *iface) -> uint64_t {
+    Network::IpAddress ip;
+    if (!iface || !iface->isConnected() || iface->getIpAddress(&ip) != ESP_OK)
+      return 0;
+    return ((uint32_t)ip.addr[0] << 24) | ((uint32_t)ip.addr[1] << 16) |
+           ((uint32_t)ip.addr[2] << 8) | ip.addr[3];
+  };
+  uint64_t *v = sample->values;
+  v[LiveFeed::ETH_IP] = ipOf(s_ethInterface);
+  v[LiveFeed::WIFI_IP] = ipOf(s_wifiInterface);
+
+  FlashRing::Stats fs;
+  if (s_dataloggerCallbacks.getFlashStats &&
+      s_dataloggerCallbacks.getFlashStats(&fs) == ESP_OK) {
+    v[LiveFeed::FLASH_USED] = fs.usedBytes;
+    v[LiveFeed::FLASH_FREE] = fs.freeBytes;
+    v[LiveFeed::FLASH_SIZE] = fs.partitionSize;
+    v[LiveFeed::FLASH_WRAPS] = fs.wrapCount;
+    v[LiveFeed::FLASH_TOTAL] = fs.totalWritten;
+  }
+  Transport::Stats ts;
+  if (s_dataloggerCallbacks.getTransportStats &&
+      s_dataloggerCallbacks.getTransportStats(&ts) == ESP_OK) {
+    v[LiveFeed::RX_BYTES] = ts.totalBytesReceived;
+    v[LiveFeed::RX_BURSTS] = ts.burstCount;
+    v[LiveFeed::RX_OVERFLOWS] = ts.overflowCount;
+    v[LiveFeed::RX_BURST_ACTIVE] = ts.burstActive ? 1 : 0;
+  }
+  DataPipeline::Stats ps;
+  if (s_dataloggerCallbacks.getPipelineStats &&
+      s_dataloggerCallbacks.getPipelineStats(&ps) == ESP_OK) {
+    v[LiveFeed::PIPE_WRITTEN] = ps.bytesWrittenToFlash;
+    v[LiveFeed::PIPE_DROPPED] = ps.bytesDropped;
+    v[LiveFeed::PIPE_RATE] = ps.ingestRateBps;
+    v[LiveFeed::PIPE_RING_FILL] = ps.ringFillPct;
+  }
+}
+
 static esp_err_t apiDataLoggerStatsHandler(httpd_req_t *req) {
   // Execute stats command through CommandSystem
-  CommandSystem::CommandResult result = CommandSystem::executeCommand(
-      CommandSystem::Medium::WEB, "stats");
-  
-  sendWebCommandResponse(req, &result);
-  return ESP_OK;
+  return streamWebCommand(req, "stats");
+}
+
+static esp_err_t apiDataLoggerMetricsHandler(httpd_req_t *req) {
+  // Latency histograms and throughput windows (stats metrics command)
+  return streamWebCommand(req, "stats metrics");
+}
+
+static esp_err_t apiDataLoggerDecodedHandler(httpd_req_t *req) {
+  // Recent protocol frames and decoder counters (decoded command)
+  return streamWebCommand(req, "decoded");
+}
+
+// ============== Streamed JSON responses ==============
+// Staging buffer for JSON streamed as chunks; any document size fits
+static const size_t JSON_CHUNK_SIZE = 512;
+
+static bool sendJsonChunk(void *ctx, const char *data, size_t len) {
+  return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len) == ESP_OK;
+}
+
+// Flush the writer and close the chunked response
+static esp_err_t finishJsonChunks(httpd_req_t *req, JsonWriter &json) {
+  esp_err_t ret = json.finish();
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "JSON response aborted after %u bytes: %s",
+             (unsigned)json.length(), esp_err_to_name(ret));
+    return ESP_FAIL;
+  }
+  return httpd_resp_send_chunk(req, nullptr, 0);
 }
 
 static esp_err_t apiGetFullConfigHandler(httpd_req_t *req) {
@@ -1016,116 +491,12 @@ static esp_err_t apiGetFullConfigHandler(httpd_req_t *req) {
   if (ConfigManager::getConfig(&cfg) != ESP_OK)
     return ESP_FAIL;
 
-  // Build complete JSON response with all configuration fields
-  char resp[2048];
-  int len = snprintf(
-      resp, sizeof(resp),
-      "{"
-      "\"device\":{"
-      "\"type\":%d,"
-      "\"name\":\"%s\","
-      "\"id\":\"%s\""
-      "},"
-      "\"network\":{"
-      "\"lan\":{"
-      "\"enabled\":%s,"
-      "\"useDhcp\":%s,"
-      "\"staticIp\":\"%d.%d.%d.%d\","
-      "\"netmask\":\"%d.%d.%d.%d\","
-      "\"gateway\":\"%d.%d.%d.%d\""
-      "},"
-      "\"wlanOp\":{"
-      "\"enabled\":%s,"
-      "\"ssid\":\"%s\","
-      "\"password\":\"%s\","
-      "\"useDhcp\":%s,"
-      "\"staticIp\":\"%d.%d.%d.%d\","
-      "\"netmask\":\"%d.%d.%d.%d\","
-      "\"gateway\":\"%d.%d.%d.%d\""
-      "},"
-      "\"wlanSafe\":{"
-      "\"ssid\":\"%s\","
-      "\"password\":\"%s\","
-      "\"channel\":%d,"
-      "\"hidden\":%s,"
-      "\"apIp\":\"%d.%d.%d.%d\""
-      "},"
-      "\"webServerPort\":%d"
-      "},"
-      "\"endpoint\":{"
-      "\"hostName\":\"%s\","
-      "\"source\":%d,"
-      "\"serial\":{"
-      "\"interface\":%d,"
-      "\"baudRate\":%lu,"
-      "\"dataBits\":%d,"
-      "\"parity\":%d,"
-      "\"stopBits\":%d"
-      "}"
-      "},"
-      "\"mqtt\":{"
-      "\"host\":\"%s\","
-      "\"port\":%d,"
-      "\"qos\":%d,"
-      "\"useAuth\":%s,"
-      "\"username\":\"%s\","
-      "\"password\":\"%s\","
-      "\"topicPub\":\"%s\","
-      "\"topicSub\":\"%s\""
-      "},"
-      "\"webUser\":{"
-      "\"username\":\"%s\","
-      "\"password\":\"%s\""
-      "}"
-      "}",
-      // Device
-      (int)cfg.device.type, cfg.device.name, cfg.device.id,
-      // Network - LAN
-      cfg.network.lan.enabled ? "true" : "false",
-      cfg.network.lan.useDhcp ? "true" : "false",
-      cfg.network.lan.staticIp.addr[0], cfg.network.lan.staticIp.addr[1],
-      cfg.network.lan.staticIp.addr[2], cfg.network.lan.staticIp.addr[3],
-      cfg.network.lan.netmask.addr[0], cfg.network.lan.netmask.addr[1],
-      cfg.network.lan.netmask.addr[2], cfg.network.lan.netmask.addr[3],
-      cfg.network.lan.gateway.addr[0], cfg.network.lan.gateway.addr[1],
-      cfg.network.lan.gateway.addr[2], cfg.network.lan.gateway.addr[3],
-      // Network - WLAN-OP
-      cfg.network.wlanOp.enabled ? "true" : "false", cfg.network.wlanOp.ssid,
-      cfg.network.wlanOp.password,
-      cfg.network.wlanOp.useDhcp ? "true" : "false",
-      cfg.network.wlanOp.staticIp.addr[0], cfg.network.wlanOp.staticIp.addr[1],
-      cfg.network.wlanOp.staticIp.addr[2], cfg.network.wlanOp.staticIp.addr[3],
-      cfg.network.wlanOp.netmask.addr[0], cfg.network.wlanOp.netmask.addr[1],
-      cfg.network.wlanOp.netmask.addr[2], cfg.network.wlanOp.netmask.addr[3],
-      cfg.network.wlanOp.gateway.addr[0], cfg.network.wlanOp.gateway.addr[1],
-      cfg.network.wlanOp.gateway.addr[2], cfg.network.wlanOp.gateway.addr[3],
-      // Network - WLAN-SAFE
-      cfg.network.wlanSafe.ssid, cfg.network.wlanSafe.password,
-      cfg.network.wlanSafe.channel,
-      cfg.network.wlanSafe.hidden ? "true" : "false",
-      cfg.network.wlanSafe.apIp.addr[0], cfg.network.wlanSafe.apIp.addr[1],
-      cfg.network.wlanSafe.apIp.addr[2], cfg.network.wlanSafe.apIp.addr[3],
-      cfg.network.webServerPort,
-      // Endpoint
-      cfg.endpoint.hostName, (int)cfg.endpoint.source,
-      (int)cfg.endpoint.serial.interface, cfg.endpoint.serial.baudRate,
-      cfg.endpoint.serial.dataBits, (int)cfg.endpoint.serial.parity,
-      (int)cfg.endpoint.serial.stopBits,
-      // MQTT
-      cfg.mqtt.host, cfg.mqtt.port, cfg.mqtt.qos,
-      cfg.mqtt.useAuth ? "true" : "false",
-      cfg.mqtt.username, cfg.mqtt.password, cfg.mqtt.topicPub,
-      cfg.mqtt.topicSub,
-      // Web User
-      cfg.webUser.username, cfg.webUser.password);
-
-  if (len >= sizeof(resp)) {
-    ESP_LOGW("WebServer", "JSON response truncated");
-  }
-
+  // Streamed to the socket as it is built, no full-size response buffer
   httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, resp, strlen(resp));
-  return ESP_OK;
+  char chunk[JSON_CHUNK_SIZE];
+  JsonWriter json(chunk, sizeof(chunk), sendJsonChunk, req);
+  ConfigManager::toJson(&cfg, &json);
+  return finishJsonChunks(req, json);
 }
 
 static esp_err_t apiSaveFullConfigHandler(httpd_req_t *req) {
@@ -1235,6 +606,11 @@ static esp_err_t apiSaveFullConfigHandler(httpd_req_t *req) {
     parseString(findValue(wlanOp, "password"), cfg.network.wlanOp.password,
                 sizeof(cfg.network.wlanOp.password));
     cfg.network.wlanOp.useDhcp = parseBool(findValue(wlanOp, "useDhcp"));
+    // Optional, older UI pages omit them
+    if (const char *pos = findValue(wlanOp, "profile"))
+      cfg.network.wlanOp.profile = (ConfigManager::WifiProfile)parseInt(pos);
+    if (const char *pos = findValue(wlanOp, "fixedChannel"))
+      cfg.network.wlanOp.fixedChannel = parseInt(pos);
   }
 
   // Parse Network - WLAN-SAFE
@@ -1248,6 +624,12 @@ static esp_err_t apiSaveFullConfigHandler(httpd_req_t *req) {
     cfg.network.wlanSafe.hidden = parseBool(findValue(wlanSafe, "hidden"));
   }
 
+  // Parse Network - TCP tap (optional)
+  if (const char *tapPortPos = findValue(buf, "tapPort"))
+    cfg.network.tapPort = parseInt(tapPortPos);
+  if (const char *livePos = findValue(buf, "livePushMs"))
+    cfg.network.livePushMs = parseInt(livePos);
+
   // Parse Endpoint
   const char *endpoint = strstr(buf, "\"endpoint\"");
   if (endpoint) {
@@ -1303,10 +685,50 @@ static esp_err_t apiSaveFullConfigHandler(httpd_req_t *req) {
           parseString(topicSubPos, cfg.mqtt.topicSub, sizeof(cfg.mqtt.topicSub));
           ESP_LOGI(TAG, "Parsed topicSub: [%s] (len=%zu)", cfg.mqtt.topicSub, strlen(cfg.mqtt.topicSub));
         }
+        // Data forwarding fields are optional (older UI pages omit them)
+        if (const char *pos = findValueInSection("dataEnabled"))
+          cfg.mqtt.dataEnabled = parseBool(pos);
+        if (const char *pos = findValueInSection("topicData"))
+          parseString(pos, cfg.mqtt.topicData, sizeof(cfg.mqtt.topicData));
+        if (const char *pos = findValueInSection("dataBatchSize"))
+          cfg.mqtt.dataBatchSize = parseInt(pos);
+        if (const char *pos = findValueInSection("dataCompress"))
+          cfg.mqtt.dataCompress = parseBool(pos);
       }
     }
   }
 
+  // Parse capture filters (optional, older UI pages omit them)
+  const char *filter = strstr(buf, "\"filter\"");
+  if (filter) {
+    if (const char *pos = findValue(filter, "stripBytes"))
+      parseString(pos, cfg.filter.stripBytes, sizeof(cfg.filter.stripBytes));
+    if (const char *pos = findValue(filter, "dropRunMin"))
+      cfg.filter.dropRunMin = parseInt(pos);
+    if (const char *pos = findValue(filter, "dedupeMax"))
+      cfg.filter.dedupeMax = parseInt(pos);
+  }
+
+  // Parse protocol decoder (optional, older UI pages omit it)
+  const char *decoder = strstr(buf, "\"decoder\"");
+  if (decoder) {
+    if (const char *pos = findValue(decoder, "type"))
+      cfg.decoder.type = (ConfigManager::DecoderType)parseInt(pos);
+    if (const char *pos = findValue(decoder, "topic"))
+      parseString(pos, cfg.decoder.topic, sizeof(cfg.decoder.topic));
+  }
+
+  // Parse second UART (optional, older UI pages omit it)
+  const char *serial2 = strstr(buf, "\"serial2\"");
+  if (serial2) {
+    if (const char *pos = findValue(serial2, "enabled"))
+      cfg.serial2.enabled = parseBool(pos);
+    if (const char *pos = findValue(serial2, "baudRate"))
+      cfg.serial2.baudRate = parseInt(pos);
+    if (const char *pos = findValue(serial2, "rxPin"))
+      cfg.serial2.rxPin = parseInt(pos);
+  }
+
   // Parse WebUser
   const char *webUser = strstr(buf, "\"webUser\"");
   if (webUser) {
@@ -1361,12 +783,14 @@ static esp_err_t apiWifiConfigHandler(httpd_req_t *req) {
       sscanf(p + 1, "%[^\"]", pass);
   }
 
+  // Only the network section is read and rewritten
   ConfigManager::FullConfig cfg;
-  if (ConfigManager::getConfig(&cfg) == ESP_OK) {
+  if (ConfigManager::getSections(ConfigManager::SECTION_NETWORK, &cfg) ==
+      ESP_OK) {
     cfg.network.wlanOp.enabled = true;
     strncpy(cfg.network.wlanOp.ssid, ssid, 32);
     strncpy(cfg.network.wlanOp.password, pass, 64);
-    ConfigManager::saveConfig(&cfg);
+    ConfigManager::saveSections(ConfigManager::SECTION_NETWORK, &cfg);
     httpd_resp_send(req, "{\"success\":true}", -1);
   } else {
     httpd_resp_send(req, "{\"success\":false}", -1);
@@ -1398,10 +822,11 @@ static esp_err_t apiUserConfigHandler(httpd_req_t *req) {
       sscanf(p + 1, "%[^\"]", pass);
   }
   ConfigManager::FullConfig cfg;
-  if (ConfigManager::getConfig(&cfg) == ESP_OK) {
+  if (ConfigManager::getSections(ConfigManager::SECTION_WEB_USER, &cfg) ==
+      ESP_OK) {
     strncpy(cfg.webUser.username, user, 31);
     strncpy(cfg.webUser.password, pass, 31);
-    ConfigManager::saveConfig(&cfg);
+    ConfigManager::saveSections(ConfigManager::SECTION_WEB_USER, &cfg);
     httpd_resp_send(req, "{\"success\":true}", -1);
   } else
     httpd_resp_send(req, "{\"success\":false}", -1);
@@ -1414,37 +839,60 @@ static void sendWebCommandResponse(httpd_req_t *req,
     return;
   }
 
-  // Format response as JSON
-  char response[1024];
+  httpd_resp_set_type(req, "application/json");
+  char chunk[JSON_CHUNK_SIZE];
+  JsonWriter json(chunk, sizeof(chunk), sendJsonChunk, req);
+  json.beginObject();
+  json.field("success", result->status == ESP_OK);
+  json.field("message", result->message);
   if (result->status == ESP_OK) {
     if (result->data && result->dataLen > 0) {
-      // Special handling for stats command - return JSON directly for compatibility
-      if (strcmp(result->message, "STATS_DATA") == 0 && result->data[0] == '{') {
-        // Return the JSON data directly (web expects direct JSON, not wrapped)
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, result->data, result->dataLen);
-        return;
-      }
-      // If data is already JSON (like config), wrap it
+      json.key("data");
+      // If data is already JSON (like config), embed it
       if (result->data[0] == '{') {
-        snprintf(response, sizeof(response), "{\"success\":true,\"message\":\"%s\",\"data\":%s}",
-                 result->message, result->data);
+        json.raw(result->data, result->dataLen);
       } else {
-        snprintf(response, sizeof(response), "{\"success\":true,\"message\":\"%s\",\"data\":\"%s\"}",
-                 result->message, result->data);
+        json.value(result->data, result->dataLen);
       }
-    } else {
-      snprintf(response, sizeof(response), "{\"success\":true,\"message\":\"%s\"}",
-               result->message);
     }
   } else {
-    snprintf(response, sizeof(response),
-             "{\"success\":false,\"message\":\"%s\",\"error\":\"%s\"}",
-             result->message, result->data ? result->data : esp_err_to_name(result->status));
+    json.field("error", result->data ? result->data
+                                     : esp_err_to_name(result->status));
   }
-  
+  json.endObject();
+  finishJsonChunks(req, json);
+}
+
+// Run a command with its output collected in a per-request buffer, then
+// reply with the {"success",...} envelope
+static void runWebCommand(httpd_req_t *req, const char *cmdStr) {
+  char output[CommandSystem::DEFAULT_OUTPUT_SIZE];
+  CommandSystem::Context ctx = {.medium = CommandSystem::Medium::WEB,
+                                .buf = output,
+                                .bufSize = sizeof(output)};
+  CommandSystem::CommandResult result =
+      CommandSystem::executeCommand(&ctx, cmdStr);
+  sendWebCommandResponse(req, &result);
+}
+
+// Run a command whose output is a JSON document and stream that document
+// as the response body (web expects direct JSON, not wrapped); a command
+// that fails before producing output gets the envelope instead
+static esp_err_t streamWebCommand(httpd_req_t *req, const char *cmdStr) {
   httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, response, HTTPD_RESP_USE_STRLEN);
+  CommandSystem::Context ctx = {.medium = CommandSystem::Medium::WEB,
+                                .sink = sendJsonChunk,
+                                .sinkCtx = req};
+  CommandSystem::CommandResult result =
+      CommandSystem::executeCommand(&ctx, cmdStr);
+  if (ctx.length == 0) {
+    sendWebCommandResponse(req, &result);
+    return ESP_OK;
+  }
+  if (ctx.outputStatus != ESP_OK) {
+    return ESP_FAIL; // Client went away mid-stream
+  }
+  return httpd_resp_send_chunk(req, nullptr, 0);
 }
 
 static void webResponseCallback(CommandSystem::Medium medium,
@@ -1459,24 +907,320 @@ static void webResponseCallback(CommandSystem::Medium medium,
 
 static esp_err_t apiDataLoggerFormatHandler(httpd_req_t *req) {
   // Execute format command through CommandSystem
-  CommandSystem::CommandResult result = CommandSystem::executeCommand(
-      CommandSystem::Medium::WEB, "format");
-  
-  sendWebCommandResponse(req, &result);
+  runWebCommand(req, "format");
+  return ESP_OK;
+}
+
+/**
+ * Parse a single "bytes=" range against the stored logical window.
+ * Supports "a-", "a-b" and "-n" (last n bytes). end is exclusive.
+ */
+static bool parseByteRange(const char *value, uint64_t head, uint64_t *start,
+                           uint64_t *end) {
+  if (strncmp(value, "bytes=", 6) != 0)
+    return false;
+  const char *p = value + 6;
+  char *next = nullptr;
+
+  if (*p == '-') {
+    // Suffix range: last n bytes
+    uint64_t n = strtoull(p + 1, &next, 10);
+    if (next == p + 1 || n == 0)
+      return false;
+    *start = (n < head) ? head - n : 0;
+    *end = head;
+    return true;
+  }
+
+  uint64_t first = strtoull(p, &next, 10);
+  if (next == p || *next != '-')
+    return false;
+  p = next + 1;
+
+  uint64_t last = UINT64_MAX;
+  if (*p != '\0') {
+    last = strtoull(p, &next, 10);
+    if (next == p || last < first)
+      return false;
+  }
+
+  *start = first;
+  *end = (last == UINT64_MAX || last >= head) ? head : last + 1;
+  return true;
+}
+
+/**
+ * Stream the flash ring as application/octet-stream.
+ *
+ * Byte positions are FlashRing logical positions (bytes written since the
+ * last format), so a client can resume or fetch only new data with
+ * "Range: bytes=<last position>-". X-Ring-Tail/X-Ring-Head report the
+ * stored window; ranges below the tail have been overwritten (416).
+ * With "?cursor=<name>" and no Range header the transfer starts at that
+ * FlashRing cursor, which is advanced once the data has been sent, so a
+ * periodic puller only gets what it has not fetched yet. The cursor must
+ * already exist (cursor command on the debug console): an unread cursor
+ * holds back the pre-erase window, so HTTP never creates one.
+ * Data is sent straight from the memory-mapped partition, without copying
+ * it through a buffer.
+ */
+static esp_err_t apiDataLoggerDownloadHandler(httpd_req_t *req) {
+  uint64_t tail = FlashRing::getLogicalTail();
+  uint64_t head = FlashRing::getLogicalHead();
+  uint64_t start = tail;
+  uint64_t end = head;
+  bool partial = false;
+
+  FlashRing::CursorId cursor = -1;
+  char query[64], cursorName[FlashRing::CURSOR_NAME_LEN + 1];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+      httpd_query_key_value(query, "cursor", cursorName, sizeof(cursorName)) ==
+          ESP_OK) {
+    if (FlashRing::findCursor(cursorName, &cursor) != ESP_OK) {
+      httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Unknown cursor");
+      return ESP_FAIL;
+    }
+  }
+
+  char tailHdr[24], headHdr[24], rangeHdr[72];
+  snprintf(tailHdr, sizeof(tailHdr), "%" PRIu64, tail);
+  snprintf(headHdr, sizeof(headHdr), "%" PRIu64, head);
+  httpd_resp_set_hdr(req, "X-Ring-Tail", tailHdr);
+  httpd_resp_set_hdr(req, "X-Ring-Head", headHdr);
+  httpd_resp_set_hdr(req, "Accept-Ranges", "bytes");
+
+  char range[64];
+  if (httpd_req_get_hdr_value_str(req, "Range", range, sizeof(range)) == ESP_OK) {
+    if (!parseByteRange(range, head, &start, &end) || start < tail ||
+        start >= end) {
+      snprintf(rangeHdr, sizeof(rangeHdr), "bytes */%" PRIu64, head);
+      httpd_resp_set_status(req, "416 Range Not Satisfiable");
+      httpd_resp_set_hdr(req, "Content-Range", rangeHdr);
+      httpd_resp_send(req, nullptr, 0);
+      return ESP_OK;
+    }
+    partial = true;
+  } else if (cursor >= 0) {
+    FlashRing::CursorInfo info;
+    if (FlashRing::getCursor(cursor, &info) == ESP_OK) {
+      start = std::max(info.position, tail);
+    }
+  }
+
+  if (partial) {
+    snprintf(rangeHdr, sizeof(rangeHdr), "bytes %" PRIu64 "-%" PRIu64 "/%" PRIu64,
+             start, end - 1, head);
+    httpd_resp_set_status(req, "206 Partial Content");
+    httpd_resp_set_hdr(req, "Content-Range", rangeHdr);
+  }
+  httpd_resp_set_type(req, "application/octet-stream");
+  httpd_resp_set_hdr(req, "Content-Disposition",
+                     "attachment; filename=\"datalog.bin\"");
+
+  ESP_LOGI(TAG, "Download %" PRIu64 "-%" PRIu64 " (%" PRIu64 " bytes)", start,
+           end, end - start);
+
+  esp_err_t ret = ESP_OK;
+  uint8_t fallback[512];
+  for (uint64_t pos = start; pos < end;) {
+    FlashRing::Span spans[2];
+    size_t count = 0;
+    size_t sent = 0;
+    size_t left = (size_t)std::min<uint64_t>(SIZE_MAX, end - pos);
+    ret = FlashRing::mapLogical(pos, left, spans, &count);
+    bool mapped = (ret == ESP_OK);
+    if (ret == ESP_ERR_NO_MEM) {
+      // Every window is held by other readers: copy this piece instead
+      size_t bytesRead = 0;
+      ret = FlashRing::readLogical(pos, fallback,
+                                   std::min(left, sizeof(fallback)), &bytesRead);
+      spans[0] = {fallback, bytesRead};
+      count = (bytesRead > 0) ? 1 : 0;
+    }
+    for (size_t i = 0; ret == ESP_OK && i < count; i++) {
+      ret = httpd_resp_send_chunk(req, (const char *)spans[i].data,
+                                  spans[i].len);
+      sent += spans[i].len;
+    }
+    if (mapped) {
+      FlashRing::unmapSpans(spans, count);
+    }
+    if (ret == ESP_OK && (count == 0 || FlashRing::getLogicalTail() > pos)) {
+      ret = ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK) {
+      // Overwritten while streaming (or client gone): drop the connection
+      // so the client sees an incomplete transfer and can resume from the
+      // new tail
+      ESP_LOGW(TAG, "Download aborted at %" PRIu64 ": %s", pos,
+               esp_err_to_name(ret));
+      break;
+    }
+    pos += sent;
+  }
+
+  if (ret != ESP_OK)
+    return ESP_FAIL;
+  httpd_resp_send_chunk(req, nullptr, 0);
+
+  if (cursor >= 0 && !partial) {
+    FlashRing::seekCursor(cursor, end);
+    FlashRing::flushMetadataAsync();
+  }
   return ESP_OK;
 }
 
+// Decode a query value in place ("%41" and "+"); false if malformed
+static bool urlDecode(char *value) {
+  char *out = value;
+  for (const char *p = value; *p; p++) {
+    if (*p == '+') {
+      *out++ = ' ';
+    } else if (*p == '%') {
+      char hex[3] = {p[1], p[1] ? p[2] : '\0', '\0'};
+      char *end = nullptr;
+      long byte = strtol(hex, &end, 16);
+      if (end != hex + 2 || byte == 0)
+        return false;
+      *out++ = (char)byte;
+      p += 2;
+    } else {
+      *out++ = *p;
+    }
+  }
+  *out = '\0';
+  return true;
+}
+
+/**
+ * Search the stored data (grep command):
+ * ?q=<pattern>[&icase=1][&max=<n>][&context=<n>]
+ * Matches are streamed as the scan finds them.
+ */
+static esp_err_t apiDataLoggerSearchHandler(httpd_req_t *req) {
+  char query[256], pattern[160], value[12];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+      httpd_query_key_value(query, "q", pattern, sizeof(pattern)) != ESP_OK ||
+      !urlDecode(pattern) || pattern[0] == '\0') {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing search pattern");
+    return ESP_FAIL;
+  }
+
+  bool ignoreCase = httpd_query_key_value(query, "icase", value,
+                                          sizeof(value)) == ESP_OK &&
+                    strcmp(value, "0") != 0;
+  unsigned long maxMatches = 50, context = 16;
+  if (httpd_query_key_value(query, "max", value, sizeof(value)) == ESP_OK)
+    maxMatches = strtoul(value, nullptr, 10);
+  if (httpd_query_key_value(query, "context", value, sizeof(value)) == ESP_OK)
+    context = strtoul(value, nullptr, 10);
+
+  // Options take up to ~60 bytes; a cut pattern would search for
+  // something else, so refuse it instead
+  char cmd[sizeof(pattern) + 64];
+  int len = snprintf(cmd, sizeof(cmd), "grep %s-m %lu -C %lu -- %s",
+                     ignoreCase ? "-i " : "", maxMatches, context, pattern);
+  if (len < 0 || (size_t)len >= sizeof(cmd)) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Search pattern too long");
+    return ESP_FAIL;
+  }
+  return streamWebCommand(req, cmd);
+}
+
 static esp_err_t apiSystemRebootHandler(httpd_req_t *req) {
   // Execute reset command through CommandSystem
   // Note: reset command sends response to DEBUG before rebooting
-  CommandSystem::CommandResult result = CommandSystem::executeCommand(
-      CommandSystem::Medium::WEB, "reset");
-  
   // Send response through web (command will reboot after)
-  sendWebCommandResponse(req, &result);
+  runWebCommand(req, "reset");
   return ESP_OK;
 }
 
+/**
+ * Firmware update: the request body is the raw app image (.bin), written
+ * to the other app slot as it arrives (see OtaUpdate).
+ * ?rate=<KB/s> sets the bandwidth ceiling, ?reboot=1 restarts into the new
+ * image once it is verified. Capture keeps running meanwhile.
+ *
+ * Requires HTTP Basic auth with the /api/login credentials. Beyond that
+ * the image must be for this project and chip and must verify.
+ */
+static esp_err_t apiSystemOtaHandler(httpd_req_t *req) {
+  if (!requireLogin(req))
+    return ESP_FAIL;
+  uint32_t rateKBps = 0;
+  bool reboot = false;
+  char query[64], value[12];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+    if (httpd_query_key_value(query, "rate", value, sizeof(value)) == ESP_OK)
+      rateKBps = strtoul(value, nullptr, 10);
+    if (httpd_query_key_value(query, "reboot", value, sizeof(value)) == ESP_OK)
+      reboot = strcmp(value, "0") != 0;
+  }
+  if (req->content_len == 0) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing firmware image");
+    return ESP_FAIL;
+  }
+
+  esp_err_t ret = OtaUpdate::begin(req->content_len, rateKBps, false);
+  if (ret == ESP_ERR_INVALID_STATE) {
+    httpd_resp_set_status(req, "409 Conflict");
+    httpd_resp_send(req, "Update already running", HTTPD_RESP_USE_STRLEN);
+    return ESP_FAIL;
+  }
+  if (ret != ESP_OK) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(ret));
+    return ESP_FAIL;
+  }
+
+  // One upload at a time (begin() refuses a second one)
+  static uint8_t chunk[OtaUpdate::CHUNK_SIZE];
+  size_t remaining = req->content_len;
+  int timeouts = 0;
+  while (ret == ESP_OK && remaining > 0) {
+    // Whole chunks, so the first one holds the app description
+    size_t want = std::min(remaining, sizeof(chunk));
+    size_t fill = 0;
+    while (fill < want) {
+      int n = httpd_req_recv(req, (char *)chunk + fill, want - fill);
+      if (n == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= 3)
+        continue;
+      if (n <= 0) {
+        ret = ESP_ERR_TIMEOUT;
+        break;
+      }
+      timeouts = 0;
+      fill += n;
+    }
+    if (ret == ESP_OK) {
+      ret = OtaUpdate::write(chunk, fill);
+      remaining -= fill;
+    }
+  }
+  if (ret == ESP_OK) {
+    ret = OtaUpdate::finish();
+  } else {
+    OtaUpdate::abort(ret);
+  }
+
+  OtaUpdate::Status status;
+  OtaUpdate::getStatus(&status);
+  if (ret != ESP_OK)
+    httpd_resp_set_status(req, HTTPD_400);
+  httpd_resp_set_type(req, "application/json");
+  char buf[JSON_CHUNK_SIZE];
+  JsonWriter json(buf, sizeof(buf), sendJsonChunk, req);
+  OtaUpdate::toJson(status, &json);
+  esp_err_t sent = finishJsonChunks(req, json);
+
+  if (ret == ESP_OK && reboot)
+    OtaUpdate::restart();
+  return sent;
+}
+
+static esp_err_t apiSystemOtaStatusHandler(httpd_req_t *req) {
+  return streamWebCommand(req, "ota");
+}
+
 static esp_err_t apiTestMqttHandler(httpd_req_t *req) {
   char buf[512];
   int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
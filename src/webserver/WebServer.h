@@ -26,6 +26,8 @@ struct UriHandler {
   HttpHandler handler;
   bool userCtx = false; ///< If true, pass user context to handler
   void *userCtxData = nullptr;
+  bool websocket = false; ///< If true, the URI is a WebSocket endpoint
+  bool async = false;     ///< If true, run on the AsyncWorkers pool
 };
 
 /**
@@ -33,10 +35,13 @@ struct UriHandler {
  * @param ethInterface Ethernet network interface (optional)
  * @param wifiInterface WiFi network interface (optional)
  * @param port HTTP server port (default: 80)
+ * @param livePushMs Dashboard push period on the /api/live WebSocket
+ *        (0 = disabled, the UI falls back to polling)
  * @return ESP_OK on success
  */
 esp_err_t init(INetworkInterface *ethInterface,
-               INetworkInterface *wifiInterface, uint16_t port = 80);
+               INetworkInterface *wifiInterface, uint16_t port = 80,
+               uint32_t livePushMs = 1000);
 
 /**
  * @brief Start web server
@@ -0,0 +1,30 @@
+"""
+Gzip a web UI asset for embedding in the firmware image.
+
+Usage:
+    python gzip_asset.py <input> <output.gz>
+
+The output is reproducible (no timestamp or file name in the gzip header),
+so the ETag derived from it only changes when the asset does.
+"""
+
+import gzip
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 2
+    src, dst = sys.argv[1], sys.argv[2]
+    with open(src, "rb") as f:
+        data = f.read()
+    with open(dst, "wb") as out:
+        with gzip.GzipFile(filename="", mode="wb", compresslevel=9,
+                           fileobj=out, mtime=0) as gz:
+            gz.write(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
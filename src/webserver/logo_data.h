@@ -1,6 +0,0 @@
-#pragma once
-
-static const unsigned char LOGO_PNG_DATA[] = {
-0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x05, 0xcb, 0x00, 0x00, 0x01, 0x27, 0x08, 0x03, 0x00, 0x00, 0x00, 0x41, 0x83, 0xeb, 0x0e, 0x00, 0x00, 0x00, 0x01, 0x73, 0x52, 0x47, 0x42, 0x01, 0xd9, 0xc9, 0x2c, 0x7f, 0x00, 0x00, 0x00, 0x09, 0x70, 0x48, 0x59, 0x73, 0x00, 0x00, 0x0b, 0x13, 0x00, 0x00, 0x0b, 0x13, 0x01, 0x00, 0x9a, 0x9c, 0x18, 0x00, 0x00, 0x01, 0x11, 0x50, 0x4c, 0x54, 0x45, 0x00, 0x00, 0x00, 0x00, 0x84, 0xaa, 0xc3, 0xd1, 0xdc, 0x5e, 0x84, 0x9e, 0xff, 0xff, 0xff, 0x01, 0x76, 0x9e, 0x02, 0x67, 0x90, 0x04, 0x57, 0x81, 0x6f, 0x94, 0xaf, 0x75, 0x98, 0xb1, 0x00, 0x7b, 0xa2, 0x5d, 0x89, 0xa5, 0x88, 0xa5, 0xbb, 0x04, 0x5b, 0x86, 0x01, 0x79, 0xa1, 0x4a, 0x7d, 0x9c, 0x01, 0x72, 0x99, 0x03, 0x64, 0x8d, 0x69, 0x90, 0xaa, 0x01, 0x74, 0x9c, 0x04, 0x58, 0x82, 0x03, 0x66, 0x90, 0x69, 0x90, 0xab, 0xf8, 0xf9, 0xfb, 0x02, 0x71, 0x99, 0xc7, 0xd2, 0xdc, 0x03, 0x62, 0x8c, 0xa2, 0xb6, 0xc8, 0x03, 0x60, 0x8a, 0x01, 0x78, 0x9f, 0x00, 0x81, 0xa7, 0xfc, 0xfc, 0xfc, 0x00, 0x80, 0xa7, 0x82, 0xa1, 0xb7, 0xb4, 0xc4, 0xd2, 0x00, 0x7f, 0xa5, 0x02, 0x70, 0x98, 0x6f, 0x94, 0xae, 0x0a, 0x5a, 0x84, 0x03, 0x65, 0x8f, 0x8f, 0xa9, 0xbe, 0xba, 0xc8, 0xd5, 0x02, 0x69, 0x91, 0x00, 0x82, 0xa8, 0x00, 0x7f, 0xa6, 0x3d, 0x76, 0x97, 0xd3, 0xdc, 0xe4, 0x7c, 0x9d, 0xb4, 0xa7, 0xbb, 0xcb, 0x63, 0x8c, 0xa8, 0x04, 0x5c, 0x86, 0x36, 0x72, 0x95, 0x04, 0x5e, 0x88, 0x02, 0x6f, 0x97, 0x02, 0x68, 0x92, 0x01, 0x7a, 0xa1, 0x01, 0x77, 0x9e, 0x05, 0x53, 0x7f, 0x5d, 0x89, 0xa6, 0x4a, 0x7d, 0x9d, 0x01, 0x74, 0x9d, 0xae, 0xc0, 0xcf, 0x3d, 0x76, 0x98, 0xc1, 0xcd, 0xd9, 0x00, 0x7e, 0xa4, 0xd9, 0xe0, 0xe7, 0x01, 0x73, 0x9b, 0x01, 0x75, 0x9d, 0x50, 0x81, 0xa0, 0x1e, 0x64, 0x8c, 0x23, 0x67, 0x8e, 0x04, 0x57, 0x82, 0x04, 0x59, 0x84, 0x02, 0x6d, 0x96, 0x01, 0x78, 0xa0, 0x02, 0x6c, 0x94, 0x03, 0x5e, 0x87, 0x03, 0x63, 0x8e, 0xe0, 0xe6, 0xeb, 0x95, 0xad, 0xc1, 0x04, 0x5a, 0x84, 0x03, 0x64, 0x8e, 0x00, 0x7c, 0xa2, 0x01, 0x73, 0x9c, 0x00, 0x7d, 0xa4, 0x02, 0x67, 0x91, 0xe6, 0xea, 0xef, 0x00, 0x7e, 0xa5, 0x01, 0x71, 0x99, 0xfe, 0xfe, 0xfe, 0xfd, 0xfd, 0xfd, 0x4d, 0xf9, 0xfa, 0xe9, 0x00, 0x00, 0x00, 0x5b, 0x74, 0x52, 0x4e, 0x53, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x86, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x85, 0x86, 0x8e, 0xfa, 0x13, 0x5a, 0x00, 0x00, 0x18, 0x1e, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0xed, 0xdd, 0xfb, 0xaf, 0x6c, 0x49, 0x55, 0xc0, 0xf1, 0x6e, 0xe6, 0x8e, 0x42, 0x9c, 0xe0, 0x63, 0x7e, 0x40, 0x1c, 0x51, 0x70, 0x32, 0xa2, 0x23, 0x48, 0x7c, 0x44, 0x34, 0x48, 0x04, 0x8d, 0x12, 0x25, 0x51, 0xc4, 0x47, 0x22, 0x7f, 0xa0, 0x46, 0xd0, 0x18, 0xdf, 0xc6, 0x44, 0x22, 0xfe, 0x20, 0x11, 0x51, 0x09, 0x22, 0x18, 0xc0, 0x11, 0x98, 0x88, 0xc6, 0xc7, 0xe8, 0xe0, 0x0f, 0x80, 0x5c, 0xb8, 0xce, 0xe9, 0x73, 0xcf, 0x3d, 0x7b, 0xf7, 0xae, 0x5a, 0x55, 0x6b, 0xd5, 0xaa, 0x5d, 0xab, 0xfa, 0x7c, 0xbf, 0x3f, 0xc8, 0x3d, 0x7d, 0xf6, 0xa9, 0xaa, 0xde, 0xbd, 0xf7, 0x67, 0x8e, 0x7d, 0xba, 0x77, 0x1f, 0x0f, 0x13, 0x74, 0x2c, 0x6d, 0xf0, 0xa0, 0x7a, 0xa8, 0x97, 0x95, 0x36, 0xf8, 0x5a, 0xf5, 0x50, 0x44, 0x44, 0x61, 0x2a, 0x32, 0x39, 0xbc, 0xca, 0x15, 0xd6, 0x70, 0x5e, 0x84, 0xfc, 0x61, 0x78, 0x4e, 0x44, 0x93, 0x15, 0xdd, 0x72, 0xc5, 0xfa, 0x4a, 0x9a, 0xd7, 0x4a, 0x7e, 0x00, 0x73, 0x22, 0x9a, 0xad, 0xd8, 0x96, 0xeb, 0x56, 0x27, 0x63, 0xae, 0xa0, 0xfc, 0x80, 0xe6, 0x44, 0x34, 0x57, 0xa1, 0x2d, 0x57, 0x2f, 0x2e, 0xaf, 0xb9, 0x4e, 0xf2, 0x03, 0x98, 0x13, 0xd1, 0x54, 0x45, 0xb6, 0xdc, 0xb0, 0xb6, 0x1c, 0xe6, 0x6a, 0xca, 0xc1, 0x9c, 0x88, 0x66, 0x2a, 0xb0, 0xe5, 0x96, 0xa5, 0x39, 0x5a, 0x0e, 0xe6, 0x44, 0x34, 0x4f, 0x71, 0x2d, 0xb7, 0xad, 0x2c, 0x8d, 0xb9, 0x85, 0x72, 0x30, 0x27, 0xa2, 0x79, 0xba, 0x34, 0xcb, 0x93, 0x98, 0xdb, 0x28, 0xc7, 0x72, 0x22, 0x9a, 0xa6, 0xb0, 0x96, 0x5b, 0x17, 0xe6, 0x68, 0x39, 0x98, 0x13, 0xd1, 0x2c, 0x5d, 0x9c, 0xe5, 0x09, 0xcc, 0xad, 0x94, 0x63, 0x39, 0x11, 0xcd, 0x12, 0x96, 0x0b, 0x61, 0x39, 0x11, 0x4d, 0x52, 0x54, 0xcb, 0xed, 0xeb, 0x72, 0xb4, 0x1c, 0xcc, 0x89, 0x68, 0x92, 0xb0, 0x5c, 0x0a, 0xcb, 0x89, 0x68, 0x8e, 0x2e, 0xcf, 0xf2, 0x0d, 0xe6, 0x76, 0xca, 0xb1, 0x9c, 0x88, 0x26, 0x09, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0x08, 0xcb, 0xa5, 0xb0, 0x9c, 0x88, 0xe6, 0xe8, 0x0e, 0x58, 0xde, 0x80, 0x39, 0x96, 0x13, 0xd1, 0x1c, 0x5d, 0x9e, 0xe5, 0x1b, 0xca, 0xb1, 0x9c, 0x88, 0x2e, 0xbe, 0xa8, 0x96, 0xdb, 0x17, 0x86, 0xe5, 0x44, 0x74, 0xf7, 0xc2, 0x72, 0x21, 0x28, 0x27, 0xa2, 0x49, 0xba, 0x38, 0xcb, 0xb7, 0x94, 0xdb, 0x31, 0xc7, 0x72, 0x22, 0x9a, 0xa4, 0xb0, 0x96, 0x5b, 0x57, 0xe6, 0x68, 0x39, 0x94, 0x13, 0xd1, 0x2c, 0x5d, 0x9a, 0xe5, 0x29, 0xca, 0xad, 0x98, 0x63, 0x39, 0x11, 0xcd, 0x52, 0x5c, 0xcb, 0x6d, 0x4b, 0x73, 0xb4, 0x1c, 0xca, 0x89, 0x68, 0x9a, 0x02, 0x5b, 0x6e, 0x59, 0x5b, 0x9a, 0x72, 0x13, 0xe6, 0x50, 0x4e, 0x44, 0xf3, 0x14, 0xd9, 0x72, 0xfd, 0xe2, 0x72, 0x94, 0x1b, 0x30, 0x87, 0x72, 0x22, 0x9a, 0xa8, 0xd0, 0x96, 0x6b, 0x57, 0x97, 0xa7, 0x5c, 0x8d, 0x39, 0x94, 0x13, 0xd1, 0x4c, 0xc5, 0xb6, 0x5c, 0xb5, 0x3c, 0x49, 0xf2, 0xab, 0x34, 0x9a, 0x43, 0x39, 0x11, 0x4d, 0x55, 0x70, 0xcb, 0x15, 0x0b, 0x2c, 0x51, 0xae, 0xc0, 0x1c, 0xc9, 0x89, 0x68, 0xb2, 0xc2, 0x5b, 0x7e, 0xa8, 0x5a, 0x63, 0x19, 0xf2, 0xeb, 0x2a, 0x38, 0x07, 0x72, 0x22, 0x9a, 0xaf, 0x19, 0x2c, 0x27, 0x22, 0x22, 0x39, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0x3f, 0x2c, 0x27, 0x22, 0x9a, 0xbf, 0x4e, 0x96, 0x3f, 0x56, 0xb3, 0xd1, 0x57, 0xeb, 0xc6, 0xaa, 0x5a, 0x62, 0xdd, 0x07, 0x7e, 0x56, 0x7d, 0x7a, 0x33, 0x1f, 0xf8, 0x49, 0x44, 0xd3, 0xb5, 0x84, 0xd2, 0x4d, 0xba, 0x2a, 0xc9, 0x4f, 0x15, 0x39, 0xaf, 0xff, 0x6f, 0x4d, 0x59, 0xf3, 0xaa, 0xfb, 0x77, 0x0a, 0xce, 0x89, 0x68, 0xae, 0x6e, 0xad, 0xac, 0x96, 0xae, 0x04, 0x5d, 0xbd, 0xe4, 0x87, 0x22, 0xe6, 0xaa, 0xff, 0xb7, 0x41, 0xd6, 0xbc, 0x5e, 0xf2, 0x03, 0x98, 0x13, 0xd1, 0x64, 0xdd, 0x60, 0xe9, 0x27, 0x9d, 0x8a, 0xf2, 0x83, 0xa8, 0xb9, 0xf6, 0x09, 0x20, 0x09, 0x73, 0xd5, 0x1d, 0x3c, 0xa0, 0x39, 0x11, 0x4d, 0xd5, 0x43, 0x2e, 0x95, 0xd2, 0x09, 0xd0, 0x69, 0x29, 0x17, 0x30, 0xd7, 0x3f, 0x97, 0x9f, 0xc7, 0x5c, 0x4b, 0x39, 0x98, 0x13, 0xd1, 0x4c, 0x5d, 0x7b, 0xa9, 0x96, 0x2e, 0x0b, 0x9d, 0x9e, 0xf2, 0x2c, 0xe6, 0x96, 0x3f, 0xcb, 0xe6, 0x30, 0xd7, 0x53, 0x1e, 0x0a, 0xf3, 0xc7, 0x2a, 0xff, 0x4c, 0x4c, 0x44, 0x77, 0xb5, 0x13, 0x98, 0x06, 0xe9, 0x32, 0xd0, 0x59, 0x28, 0xf7, 0xb4, 0x3c, 0x83, 0xb9, 0x85, 0xf2, 0x50, 0x96, 0x57, 0xbf, 0xe8, 0x87, 0x88, 0xee, 0x66, 0x57, 0x60, 0x3a, 0x4a, 0x67, 0xb2, 0x3c, 0xed, 0x94, 0xf1, 0xd5, 0x92, 0x49, 0xcc, 0x4d, 0xf7, 0x30, 0x10, 0xe6, 0x57, 0xbb, 0x15, 0xcc, 0x89, 0x28, 0xdf, 0xd1, 0x0a, 0x5d, 0x52, 0x3a, 0x1b, 0xe5, 0x69, 0xa7, 0x1c, 0x2d, 0x37, 0xde, 0xc3, 0x38, 0x98, 0x9f, 0xf6, 0x2b, 0x98, 0x13, 0x51, 0xb6, 0xb0, 0x96, 0x9b, 0xdf, 0xc4, 0x94, 0xc0, 0xfc, 0x32, 0x2c, 0x47, 0x73, 0x22, 0xca, 0x76, 0x34, 0x43, 0x97, 0x90, 0xce, 0x4a, 0x79, 0x67, 0xcb, 0x1d, 0xef, 0xe1, 0xa0, 0x6e, 0x76, 0x2c, 0x98, 0x13, 0x51, 0xba, 0x18, 0x96, 0x6f, 0x91, 0xb2, 0x5f, 0x5b, 0xc0, 0xd1, 0xf2, 0x30, 0x98, 0x3f, 0xda, 0xb1, 0x60, 0x4e, 0x44, 0xc9, 0xb0, 0x5c, 0xaa, 0x97, 0xe5, 0xa5, 0x1d, 0x75, 0xbe, 0x3b, 0x1e, 0xcb, 0x7e, 0xc7, 0x39, 0xfb, 0xc2, 0x06, 0x17, 0x76, 0x61, 0xc1, 0x56, 0xd6, 0x7c, 0xd1, 0x8c, 0xba, 0x0b, 0x1f, 0x75, 0x6d, 0xc8, 0xf5, 0x00, 0xf3, 0xf7, 0x7b, 0xd0, 0xe5, 0x09, 0xb7, 0x0b, 0x3a, 0x7a, 0x42, 0x17, 0xc2, 0xf2, 0xed, 0x9d, 0xbc, 0x24, 0xcb, 0x3b, 0x6b, 0x8e, 0xe5, 0xee, 0x45, 0x5b, 0x59, 0xe3, 0x55, 0x33, 0x86, 0x5b, 0x3e, 0xec, 0xca, 0xae, 0xb9, 0x7b, 0x1e, 0x66, 0x41, 0x0d, 0x96, 0x6f, 0xa4, 0x6b, 0x38, 0x4a, 0x7b, 0x5a, 0xee, 0x78, 0x0f, 0xbd, 0x6a, 0x22, 0xb3, 0x27, 0xe6, 0x58, 0xee, 0x5e, 0xbc, 0x95, 0x89, 0x07, 0x50, 0x74, 0xcb, 0x07, 0x5e, 0xa4, 0x3b, 0x73, 0xd7, 0xc3, 0xac, 0x08, 0xcb, 0xa5, 0x42, 0x5a, 0xde, 0x13, 0x73, 0x2c, 0x77, 0x2f, 0xe0, 0xca, 0xa4, 0x03, 0x28, 0xb6, 0xe5, 0x83, 0x3f, 0x6e, 0x21, 0x79, 0xe7, 0x47, 0xae, 0x69, 0xb5, 0x20, 0x2c, 0x97, 0x8a, 0x69, 0x79, 0x47, 0xcd, 0xb1, 0xdc, 0xbd, 0x88, 0x2b, 0x6b, 0xb8, 0x9e, 0xdd, 0x50, 0xcb, 0x87, 0x7f, 0x72, 0x4e, 0xea, 0xde, 0x0f, 0x5d, 0xd4, 0x72, 0x41, 0x58, 0x2e, 0x15, 0xd5, 0xf2, 0x6e, 0x98, 0x63, 0xb9, 0x7b, 0x21, 0x57, 0x96, 0x3f, 0x7e, 0x22, 0x5b, 0x3e, 0x9c, 0xf2, 0xe4, 0xdd, 0x1f, 0xbb, 0xaa, 0xc5, 0x82, 0xb0, 0x5c, 0x2a, 0xac, 0xe5, 0xbd, 0x30, 0xc7, 0x72, 0xf7, 0x62, 0xae, 0xcc, 0x7c, 0x71, 0x52, 0x2c, 0x3f, 0x2f, 0xcc, 0xf3, 0x3e, 0x58, 0x2e, 0x15, 0xd7, 0xf2, 0x4e, 0x98, 0x63, 0xb9, 0x7b, 0x41, 0x57, 0x96, 0x3b, 0x7e, 0x02, 0x5b, 0x1e, 0x80, 0xf2, 0xe4, 0x4b, 0x01, 0x07, 0xac, 0x62, 0xd9, 0xa3, 0x15, 0x61, 0xb9, 0x54, 0x60, 0xcb, 0xfb, 0x68, 0x8e, 0xe5, 0xee, 0x05, 0x5d, 0x19, 0x96, 0x1b, 0xdb, 0xec, 0x80, 0xd1, 0xcb, 0xc2, 0xf2, 0xaa, 0x42, 0x5b, 0xde, 0x03, 0x73, 0x2c, 0x77, 0x2f, 0xea, 0xca, 0x8c, 0x57, 0x9a, 0x1e, 0x67, 0xf9, 0x68, 0x33, 0x1f, 0x16, 0xce, 0xf2, 0x47, 0x2b, 0xc2, 0x72, 0xa9, 0xd8, 0x96, 0x77, 0xc0, 0x1c, 0xcb, 0xdd, 0x8b, 0xba, 0x32, 0x2c, 0xb7, 0x85, 0xe5, 0x85, 0xb0, 0x7c, 0x55, 0xf5, 0xf9, 0xef, 0xad, 0x39, 0x96, 0xbb, 0x17, 0x75, 0x65, 0xb3, 0x59, 0x3e, 0x9c, 0xcc, 0x9b, 0x36, 0x6f, 0xb7, 0x1c, 0xb2, 0x8a, 0x45, 0x58, 0x5e, 0x53, 0x78, 0xcb, 0xbd, 0x31, 0xc7, 0x72, 0xf7, 0xc2, 0xae, 0x2c, 0x7d, 0xe8, 0x60, 0x79, 0x29, 0x2c, 0x97, 0xc3, 0xf2, 0x55, 0x8a, 0xf3, 0xdf, 0x17, 0x73, 0x2c, 0x77, 0x2f, 0xec, 0xca, 0xb0, 0xdc, 0x56, 0x38, 0xcb, 0x6f, 0x56, 0x84, 0xe5, 0x52, 0x13, 0x58, 0xee, 0x8b, 0x39, 0x96, 0xbb, 0x17, 0x76, 0x65, 0x58, 0x6e, 0x0b, 0xcb, 0xe5, 0xb0, 0x7c, 0x95, 0xee, 0xfc, 0x77, 0xd4, 0x1c, 0xcb, 0xdd, 0x0b, 0xbb, 0x32, 0x2c, 0xb7, 0x85, 0xe5, 0x72, 0x58, 0xbe, 0x4a, 0x79, 0xfe, 0xfb, 0x61, 0x8e, 0xe5, 0xee, 0x85, 0x5d, 0x19, 0x96, 0xdb, 0xc2, 0x72, 0x39, 0x2c, 0x5f, 0xa5, 0x3d, 0xff, 0xdd, 0x30, 0xc7, 0x72, 0xf7, 0xc2, 0xae, 0x0c, 0xcb, 0x6d, 0x61, 0xb9, 0x1c, 0x96, 0xaf, 0x52, 0x9f, 0xff, 0x5e, 0x98, 0x63, 0xb9, 0x7b, 0x61, 0x57, 0x86, 0xe5, 0xb6, 0xb0, 0x5c, 0x0e, 0xcb, 0x57, 0x19, 0xce, 0x7f, 0x1f, 0xcd, 0xb1, 0xdc, 0xbd, 0xb0, 0x2b, 0xc3, 0x72, 0x5b, 0x58, 0x2e, 0x87, 0xe5, 0xab, 0x2c, 0xe7, 0xbf, 0x0b, 0xe6, 0x58, 0xee, 0x5e, 0xd8, 0x95, 0x61, 0xb9, 0x2d, 0x2c, 0x97, 0xc3, 0xf2, 0x55, 0xa6, 0xf3, 0xdf, 0x03, 0x73, 0x2c, 0x77, 0x2f, 0xec, 0xca, 0xb0, 0xdc, 0x16, 0x96, 0xcb, 0x61, 0xf9, 0x2a, 0xe3, 0xf9, 0xdf, 0xae, 0x39, 0x96, 0xbb, 0x17, 0x76, 0x65, 0x58, 0x6e, 0x0b, 0xcb, 0xe5, 0xb0, 0x7c, 0x95, 0xf5, 0xfc, 0x6f, 0xc6, 0x1c, 0xcb, 0xdd, 0x0b, 0xbb, 0x32, 0x2c, 0xb7, 0x85, 0xe5, 0x72, 0x58, 0xbe, 0xca, 0x7c, 0xfe, 0xb7, 0x62, 0x8e, 0xe5, 0xee, 0x85, 0x5d, 0x19, 0x96, 0xdb, 0xc2, 0x72, 0x39, 0x2c, 0x5f, 0x65, 0x3f, 0xff, 0x1b, 0x31, 0xc7, 0x72, 0xf7, 0xc2, 0xae, 0x0c, 0xcb, 0x6d, 0x61, 0xb9, 0x1c, 0x96, 0xaf, 0x6a, 0x39, 0xff, 0x9b, 0x34, 0xc7, 0x72, 0xf7, 0xc2, 0xae, 0x0c, 0xcb, 0x6d, 0x61, 0xb9, 0x1c, 0x96, 0xaf, 0x6a, 0x3a, 0xff, 0x5b, 0x30, 0xdf, 0xe5, 0x0d, 0xa6, 0x7b, 0x4c, 0xb2, 0xdb, 0x3b, 0x65, 0xd5, 0x85, 0x7d, 0x0f, 0xef, 0x75, 0xd3, 0x5a, 0xee, 0xb6, 0x30, 0xed, 0x44, 0xfd, 0x17, 0x56, 0x39, 0x03, 0x96, 0x4b, 0x4d, 0x69, 0x79, 0x8b, 0x06, 0x58, 0xde, 0x3d, 0x2c, 0xb7, 0x85, 0xe5, 0xa5, 0x19, 0xb0, 0x5c, 0x6a, 0x4e, 0xcb, 0x1b, 0x3c, 0xc0, 0xf2, 0xee, 0x61, 0xb9, 0x2d, 0x2c, 0x2f, 0xcd, 0x80, 0xe5, 0x52, 0xb3, 0x5a, 0x6e, 0x06, 0x01, 0xcb, 0xbb, 0x87, 0xe5, 0xb6, 0xb0, 0xbc, 0x34, 0x03, 0x96, 0x4b, 0x4d, 0x6b, 0xb9, 0x55, 0x04, 0x2c, 0xef, 0x1e, 0x96, 0xdb, 0xc2, 0xf2, 0xd2, 0x0c, 0x9e, 0x96, 0x37, 0x60, 0x8e, 0xe5, 0xab, 0x1c, 0x5e, 0xfb, 0x60, 0x23, 0x01, 0xcb, 0xbb, 0x87, 0xe5, 0xb6, 0xb0, 0xbc, 0x34, 0xc3, 0xe5, 0x59, 0xbe, 0xdd, 0x75, 0xf6, 0xbb, 0x38, 0xb1, 0xe5, 0x36, 0x14, 0xb0, 0xbc, 0x7b, 0x58, 0x6e, 0x0b, 0xcb, 0x4b, 0x33, 0x34, 0x58, 0xbe, 0x85, 0x0e, 0xcb, 0x2b, 0xdb, 0xe7, 0x65, 0xdc, 0x06, 0x15, 0xb0, 0xbc, 0x7b, 0x58, 0x6e, 0x0b, 0xcb, 0x4b, 0x33, 0xc4, 0xb0, 0x3c, 0x71, 0x58, 0x99, 0x31, 0x77, 0xb4, 0xbc, 0x17, 0xe5, 0x7b, 0xbd, 0x25, 0x47, 0xcf, 0x02, 0x96, 0x77, 0x0f, 0xcb, 0x6d, 0x61, 0x79, 0x69, 0x86, 0xa3, 0xab, 0x74, 0x56, 0xcc, 0xfb, 0x5a, 0x6e, 0xbe, 0x8b, 0xb3, 0x5b, 0xae, 0x87, 0x01, 0xcb, 0xbb, 0x87, 0xe5, 0xb6, 0xb0, 0xbc, 0x34, 0x43, 0x58, 0xcb, 0xad, 0x98, 0xa7, 0xf6, 0xdc, 0xdd, 0xb5, 0x5c, 0x2b, 0x03, 0x96, 0x77, 0x0f, 0xcb, 0x6d, 0x61, 0x79, 0x69, 0x86, 0xa3, 0x59, 0xba, 0x24, 0x74, 0x8e, 0x4f, 0xec, 0x8e, 0xb7, 0xbc, 0x1b, 0xe5, 0x7b, 0x5e, 0xf6, 0x44, 0x47, 0x03, 0x96, 0x77, 0x0f, 0xcb, 0x6d, 0x61, 0x79, 0x69, 0x86, 0x08, 0x96, 0x67, 0x8e, 0x5e, 0x13, 0xe6, 0xe9, 0x1d, 0x67, 0xba, 0x8b, 0xfd, 0x28, 0xdf, 0xf5, 0x12, 0x56, 0x2a, 0x1b, 0xb0, 0xbc, 0x7b, 0x58, 0x6e, 0x0b, 0xcb, 0x4b, 0x33, 0x5c, 0x6d, 0xe6, 0x29, 0x9d, 0x45, 0x1d, 0x47, 0xcb, 0x73, 0xfb, 0xcd, 0x72, 0x17, 0x2f, 0xc4, 0x72, 0x95, 0x0e, 0x58, 0xde, 0x3d, 0x2c, 0xb7, 0x85, 0xe5, 0xa5, 0x19, 0xac, 0x96, 0x67, 0xa1, 0x73, 0x7c, 0x8b, 0xa2, 0x1e, 0xf3, 0xfc, 0x6e, 0xd3, 0xdf, 0xc7, 0x8e, 0x94, 0xef, 0x7d, 0x69, 0xd9, 0x7a, 0x1e, 0xb0, 0xbc, 0x7b, 0x58, 0x6e, 0x0b, 0xcb, 0x4b, 0x33, 0x9c, 0x36, 0x73, 0x85, 0xce, 0xf1, 0x3a, 0x50, 0x5a, 0xcc, 0xa5, 0xbd, 0xa6, 0xbd, 0x8f, 0x3d, 0x29, 0xdf, 0xfd, 0x32, 0xe1, 0xd5, 0x3e, 0x60, 0x79, 0xf7, 0xb0, 0xdc, 0x16, 0x96, 0x97, 0x66, 0xb8, 0xde, 0xcc, 0x15, 0x3a, 0xcf, 0x0b, 0xb4, 0xaa, 0x34, 0x97, 0x77, 0x9a, 0xee, 0x3e, 0x76, 0xa5, 0x7c, 0x77, 0xcb, 0xab, 0x85, 0xc0, 0xf2, 0xee, 0x61, 0xb9, 0x2d, 0x2c, 0x2f, 0xcd, 0x70, 0xb3, 0x99, 0x4a, 0xba, 0x12, 0x74, 0xf5, 0xf4, 0x14, 0x0f, 0xdc, 0x7a, 0xcc, 0xcb, 0xbb, 0xac, 0xfe, 0x3e, 0xf6, 0x95, 0x7c, 0x84, 0xe5, 0x95, 0x44, 0x60, 0x79, 0xf7, 0xb0, 0xdc, 0x16, 0x96, 0x97, 0x66, 0x78, 0xb4, 0x99, 0x02, 0xf3, 0x0a, 0xe9, 0xea, 0xf0, 0xa9, 0x3a, 0x6c, 0xeb, 0x34, 0xaf, 0xdb, 0x61, 0x75, 0x77, 0xb2, 0xb7, 0xe4, 0x43, 0x2c, 0xaf, 0xdb, 0xd9, 0x58, 0xde, 0x3d, 0x2c, 0xb7, 0x85, 0xe5, 0xa5, 0x19, 0x16, 0x9b, 0x55, 0x6a, 0xde, 0x5f, 0xba, 0xcb, 0x6f, 0x84, 0xe5, 0x55, 0x48, 0x60, 0x79, 0xf7, 0xb0, 0xdc, 0x16, 0x96, 0x97, 0x66, 0x38, 0xdf, 0x4c, 0x04, 0x1d, 0xc6, 0x9d, 0x1a, 0x62, 0x79, 0x0d, 0x13, 0x58, 0xde, 0x3d, 0x2c, 0xb7, 0x85, 0xe5, 0xa5, 0x09, 0x1a, 0xae, 0x13, 0x4e, 0xe6, 0x06, 0x59, 0x5e, 0x76, 0x02, 0xcb, 0xbb, 0x87, 0xe5, 0xb6, 0xb0, 0xbc, 0x34, 0x01, 0x96, 0x8f, 0x68, 0x94, 0xe5, 0x45, 0x28, 0xb0, 0xbc, 0x7b, 0x58, 0x6e, 0x0b, 0xcb, 0x4b, 0x13, 0x60, 0xf9, 0x88, 0x86, 0x59, 0x5e, 0x92, 0x02, 0xcb, 0xbb, 0x87, 0xe5, 0xb6, 0xb0, 0xbc, 0x34, 0x3e, 0x96, 0x8f, 0x68, 0x9c, 0xe5, 0x05, 0x2b, 0xb0, 0xbc, 0x7b, 0x58, 0x6e, 0x0b, 0xcb, 0x4b, 0xe3, 0x63, 0xf9, 0x88, 0x46, 0x5a, 0x2e, 0x62, 0x81, 0xe5, 0xdd, 0xc3, 0x72, 0x5b, 0x58, 0x5e, 0x1a, 0x1e, 0xcb, 0x47, 0x34, 0xd4, 0x72, 0x49, 0x8b, 0x3b, 0x63, 0xb9, 0x5f, 0xda, 0xd5, 0x62, 0xb9, 0xad, 0x69, 0x2d, 0xef, 0xdb, 0x62, 0x35, 0x58, 0x3e, 0xa2, 0xb1, 0x96, 0x0b, 0x5e, 0x60, 0xb9, 0x3a, 0x2c, 0xdf, 0x27, 0x2c, 0x4f, 0xb5, 0x5c, 0x0c, 0x96, 0x8f, 0x68, 0xb4, 0xe5, 0x59, 0x30, 0xb0, 0x5c, 0x1d, 0x96, 0xef, 0x13, 0x96, 0xa7, 0xc2, 0xf2, 0xd1, 0x0d, 0xb7, 0x3c, 0x27, 0x06, 0x96, 0xab, 0xc3, 0xf2, 0x7d, 0xc2, 0xf2, 0x4c, 0xfc, 0xed, 0x73, 0x68, 0xe3, 0x2d, 0xcf, 0x9c, 0xc9, 0x58, 0xae, 0x0e, 0xcb, 0xf7, 0x09, 0xcb, 0xb3, 0x65, 0xde, 0xc3, 0x4f, 0x7b, 0xe4, 0x6d, 0xf9, 0x57, 0x2d, 0x74, 0xa5, 0xce, 0x65, 0x2c, 0x57, 0x87, 0xe5, 0xfb, 0x84, 0xe5, 0xf9, 0xae, 0x97, 0x14, 0x60, 0x21, 0x77, 0x30, 0x77, 0xcb, 0x4d, 0x76, 0x25, 0x4e, 0x66, 0x2c, 0x57, 0x87, 0xe5, 0xfb, 0x84, 0xe5, 0x52, 0x57, 0x8b, 0x0a, 0xb1, 0x90, 0x3b, 0x97, 0xbf, 0xe5, 0x26, 0xbd, 0xb6, 0x67, 0x33, 0x96, 0xab, 0xc3, 0xf2, 0x7d, 0xc2, 0x72, 0x29, 0x2c, 0x1f, 0x55, 0x0f, 0xcb, 0x5d, 0x7e, 0x35, 0xc7, 0x72, 0x75, 0x58, 0xbe, 0x4f, 0x58, 0x2e, 0xf6, 0x20, 0xca, 0x42, 0xee, 0x5a, 0x5d, 0x2c, 0xf7, 0xc0, 0x1c, 0xcb, 0xd5, 0x61, 0xf9, 0x3e, 0x61, 0xb9, 0xdc, 0x83, 0x28, 0x0b, 0xb9, 0x63, 0xf5, 0xb1, 0xdc, 0x01, 0x73, 0x2c, 0x57, 0x87, 0xe5, 0xfb, 0x84, 0xe5, 0x85, 0x1e, 0x44, 0x59, 0xc8, 0xdd, 0xaa, 0x93, 0xe5, 0xed, 0x4f, 0x9a, 0x63, 0xb9, 0x3a, 0x2c, 0xdf, 0x27, 0x2c, 0x2f, 0x84, 0xe5, 0x43, 0xea, 0x66, 0x79, 0xeb, 0xaf, 0xe6, 0x58, 0xae, 0x0e, 0xcb, 0xf7, 0x09, 0xcb, 0x0b, 0x9d, 0x59, 0x5e, 0xfc, 0xc8, 0x4f, 0x3e, 0x25, 0xce, 0xa5, 0x7e, 0x96, 0x37, 0x62, 0x8e, 0xe5, 0xea, 0xbc, 0x2d, 0xdf, 0xad, 0x0b, 0xb3, 0x7c, 0xb7, 0xa2, 0x5a, 0xce, 0x67, 0x37, 0x0f, 0xa9, 0xa3, 0xe5, 0x6d, 0xcf, 0xb3, 0x60, 0xb9, 0x3a, 0x2c, 0xdf, 0xa7, 0x30, 0x64, 0xc6, 0xb7, 0xbc, 0x52, 0xf2, 0xab, 0x2a, 0x34, 0xaf, 0x3a, 0x60, 0x2b, 0xcf, 0x82, 0xaa, 0x7d, 0x55, 0x77, 0x88, 0x39, 0x0e, 0xd5, 0x54, 0x57, 0xcb, 0x5b, 0x7e, 0x35, 0xc7, 0x72, 0x75, 0x58, 0xbe, 0x4f, 0x61, 0xc8, 0x8c, 0x6e, 0xb9, 0x42, 0xf2, 0xab, 0x0a, 0x9a, 0xd7, 0x1f, 0xae, 0xc5, 0x13, 0xa1, 0x7e, 0x47, 0x95, 0x0f, 0x32, 0xcf, 0xb1, 0xda, 0xea, 0x6b, 0x79, 0x03, 0xe6, 0x58, 0xae, 0x0e, 0xcb, 0xf7, 0x29, 0x0c, 0x99, 0xc1, 0x2d, 0x57, 0x52, 0x2e, 0x63, 0xae, 0x3a, 0x58, 0x0b, 0x67, 0x82, 0x6a, 0x3f, 0xc9, 0x87, 0x99, 0xe3, 0x50, 0xcd, 0x75, 0xb6, 0xdc, 0x8e, 0x39, 0x96, 0xab, 0xc3, 0xf2, 0x7d, 0x0a, 0x43, 0x66, 0x6c, 0xcb, 0xd5, 0x94, 0x4b, 0x98, 0x6b, 0x8f, 0x55, 0xe1, 0x5c, 0xd0, 0xee, 0x25, 0xe9, 0x38, 0xf3, 0x1c, 0xab, 0xb9, 0xde, 0x96, 0x9b, 0x9f, 0x34, 0xc7, 0x72, 0x75, 0x58, 0xbe, 0x4f, 0x61, 0xc8, 0x0c, 0x6d, 0xb9, 0x81, 0xf2, 0x3c, 0xe6, 0xfa, 0x43, 0x35, 0x7b, 0x32, 0xe8, 0x77, 0x52, 0xfe, 0x40, 0xf3, 0x1c, 0xab, 0xbd, 0xfe, 0x96, 0x1b, 0x7f, 0x35, 0xc7, 0x72, 0x75, 0x58, 0xbe, 0x4f, 0x61, 0xc8, 0x8c, 0x6c, 0xb9, 0x89, 0xf2, 0x9c, 0xe5, 0x5e, 0x17, 0x5f, 0xbd, 0xca, 0xb0, 0x93, 0x72, 0x47, 0x9a, 0x65, 0x7f, 0x77, 0x3c, 0x6a, 0x77, 0xb0, 0xdc, 0xf6, 0x48, 0x60, 0xb9, 0x3a, 0x2c, 0xdf, 0xa7, 0x30, 0x64, 0x5e, 0x9e, 0xe5, 0x69, 0xcc, 0x4d, 0x07, 0x6a, 0xe6, 0x6c, 0x30, 0xed, 0xa3, 0xf4, 0xa1, 0xe6, 0x38, 0x94, 0x4b, 0x7b, 0x58, 0xde, 0x45, 0x0d, 0x2c, 0xdf, 0x84, 0xe5, 0xfb, 0x14, 0x86, 0xcc, 0xc0, 0x96, 0x1b, 0x29, 0x77, 0xb4, 0x3c, 0x7d, 0x54, 0x19, 0x77, 0x51, 0xf2, 0x58, 0xb3, 0x8d, 0xd5, 0xef, 0xb0, 0xdd, 0xc7, 0xf2, 0x0e, 0x6c, 0x60, 0xf9, 0x26, 0x2c, 0xdf, 0xa7, 0x30, 0x64, 0x5e, 0xa0, 0xe5, 0x29, 0xcc, 0xad, 0xc7, 0x69, 0xea, 0xb0, 0x72, 0xb4, 0xdc, 0xba, 0xb7, 0xbb, 0x1d, 0xb7, 0x3b, 0x59, 0xee, 0xef, 0x06, 0x96, 0x6f, 0xc2, 0xf2, 0x7d, 0x0a, 0x43, 0x26, 0x96, 0x8b, 0x25, 0x0e, 0x2b, 0x4f, 0x7f, 0xef, 0xac, 0xe5, 0xee, 0x70, 0x60, 0xf9, 0x26, 0x2c, 0xdf, 0xa7, 0x30, 0x64, 0xc6, 0xb5, 0xdc, 0x4c, 0x79, 0xc2, 0x72, 0xf3, 0x61, 0xea, 0x68, 0x79, 0xe2, 0x60, 0x73, 0x1c, 0xca, 0xa9, 0xdd, 0x2c, 0xf7, 0xa6, 0x03, 0xcb, 0x37, 0x61, 0xf9, 0x3e, 0x85, 0x21, 0xf3, 0x12, 0x2d, 0xdf, 0x62, 0x6e, 0x3f, 0x4c, 0x37, 0xc7, 0x95, 0x7d, 0x07, 0x39, 0x5a, 0xde, 0xed, 0xc0, 0xdd, 0xd1, 0x72, 0x5f, 0x3b, 0x2e, 0xc6, 0x72, 0xb7, 0xab, 0x11, 0xaa, 0xc3, 0x72, 0x5b, 0x61, 0xc8, 0xd4, 0x5a, 0xbe, 0xdb, 0x05, 0x1c, 0xb1, 0x5c, 0x37, 0x96, 0x4f, 0x7b, 0x5a, 0xee, 0x8a, 0x07, 0x96, 0x37, 0x17, 0xc5, 0x72, 0xe3, 0xab, 0xc7, 0xb0, 0x1c, 0xcb, 0xe5, 0x1c, 0x2d, 0xdf, 0xee, 0xbb, 0x3b, 0x6e, 0xb9, 0xa7, 0x1e, 0x58, 0xde, 0x1c, 0x96, 0xdb, 0xc2, 0xf2, 0x3d, 0x2d, 0x6f, 0x38, 0x4a, 0x7b, 0x5a, 0xee, 0xf9, 0x9f, 0x05, 0xa7, 0xf6, 0xb5, 0xdc, 0xd1, 0x0f, 0x2c, 0x6f, 0x0e, 0xcb, 0x6d, 0x61, 0x39, 0x96, 0x63, 0x79, 0xc5, 0x00, 0xb5, 0x61, 0x79, 0x73, 0x41, 0x2c, 0xb7, 0xbe, 0xd9, 0x1a, 0xcb, 0xb1, 0x5c, 0x0e, 0xcb, 0x57, 0xb9, 0x5b, 0xee, 0x25, 0x08, 0x96, 0x37, 0x87, 0xe5, 0xb6, 0xb0, 0x1c, 0xcb, 0xb1, 0xbc, 0x6e, 0x8c, 0xaa, 0xb0, 0xbc, 0xb9, 0x18, 0x96, 0x9b, 0x2f, 0x68, 0x87, 0xe5, 0x58, 0x2e, 0x87, 0xe5, 0xab, 0x7a, 0x58, 0xee, 0x82, 0x08, 0x96, 0x37, 0x17, 0xc2, 0xf2, 0xfc, 0xdd, 0xc7, 0xf2, 0x52, 0x58, 0x2e, 0x87, 0xe5, 0xab, 0xba, 0x58, 0xee, 0xa1, 0x08, 0x96, 0x37, 0x17, 0xc1, 0xf2, 0x86, 0xcf, 0x0c, 0xc0, 0x72, 0x2c, 0x97, 0xc3, 0xf2, 0x55, 0x7d, 0x2c, 0x77, 0x60, 0x04, 0xcb, 0x9b, 0x0b, 0x60, 0xb9, 0x74, 0xe7, 0xb1, 0xbc, 0x14, 0x96, 0xcb, 0x61, 0xf9, 0xaa, 0x4e, 0x96, 0xb7, 0x43, 0x82, 0xe5, 0xcd, 0x8d, 0xb7, 0x5c, 0xbc, 0xef, 0x58, 0x5e, 0x0a, 0xcb, 0xe5, 0xb0, 0x7c, 0x55, 0x37, 0xcb, 0x5b, 0x25, 0xc1, 0xf2, 0xe6, 0x86, 0x5b, 0x2e, 0xdf, 0x75, 0x2c, 0x2f, 0x85, 0xe5, 0x72, 0x58, 0xbe, 0xaa, 0x9f, 0xe5, 0x8d, 0x94, 0x60, 0x79, 0x73, 0x63, 0x2d, 0x2f, 0xde, 0x6f, 0x2c, 0x2f, 0x85, 0xe5, 0x72, 0x58, 0xbe, 0xaa, 0xa3, 0xe5, 0x6d, 0x98, 0x60, 0x79, 0x73, 0xee, 0x2b, 0xab, 0x7b, 0x3c, 0x6b, 0x87, 0x9d, 0xd6, 0xf2, 0xdd, 0xc8, 0xc4, 0x72, 0x39, 0x2c, 0x5f, 0xd5, 0xd5, 0x72, 0xd7, 0xc7, 0xc9, 0x12, 0x96, 0x4b, 0xe9, 0x57, 0xe6, 0x8a, 0x39, 0x96, 0x63, 0xf9, 0x01, 0xcb, 0xeb, 0x1b, 0x6b, 0xb9, 0xe7, 0x35, 0xd0, 0x2c, 0x61, 0xb9, 0x14, 0x96, 0xa7, 0x0b, 0x43, 0x26, 0x96, 0xcb, 0x61, 0xf9, 0xaa, 0xce, 0x96, 0xbb, 0x7e, 0x68, 0x88, 0x3e, 0x2c, 0x97, 0x32, 0xac, 0xcc, 0x13, 0x73, 0x2c, 0xc7, 0xf2, 0x03, 0x96, 0xd7, 0x37, 0xda, 0x72, 0xf3, 0x63, 0x85, 0xe5, 0xcd, 0xf5, 0x58, 0x59, 0xd5, 0xa3, 0x89, 0xe5, 0x7d, 0x26, 0x0a, 0xb3, 0x30, 0x2c, 0xd7, 0x0c, 0xe5, 0xd5, 0x78, 0xcb, 0x8d, 0x0f, 0x16, 0x96, 0x37, 0x37, 0xcc, 0xf2, 0xba, 0x91, 0xb1, 0x1c, 0xcb, 0x0f, 0x58, 0x5e, 0x5f, 0x00, 0xcb, 0x6d, 0x8f, 0x16, 0x96, 0x37, 0xd7, 0x65, 0x65, 0x7e, 0x98, 0xfb, 0xc8, 0x74, 0x6f, 0xfd, 0xe5, 0xfd, 0xaa, 0x1f, 0x92, 0x0b, 0x41, 0xe6, 0xbd, 0xe3, 0xf1, 0xb8, 0xbe, 0x33, 0xf7, 0x63, 0x2c, 0xec, 0xf4, 0x7d, 0x2c, 0x57, 0x0c, 0xe5, 0x55, 0x04, 0xcb, 0x4d, 0x8f, 0x17, 0x96, 0x37, 0x77, 0xf1, 0x96, 0xdf, 0x4b, 0xdf, 0x9c, 0xf6, 0x3c, 0xb3, 0x71, 0xa2, 0xc7, 0x33, 0xb7, 0x1f, 0xbf, 0x78, 0xfd, 0xbf, 0x76, 0x7d, 0xce, 0x56, 0x96, 0xd9, 0x03, 0x8f, 0x3f, 0xfe, 0xe5, 0xf4, 0x37, 0x5e, 0x7e, 0x3c, 0xfe, 0xef, 0xf9, 0x6d, 0xaf, 0xfc, 0xbf, 0xdb, 0x7f, 0x7f, 0x25, 0x31, 0x47, 0xaa, 0xcd, 0xae, 0x38, 0xff, 0x19, 0x2c, 0xc7, 0x72, 0xf3, 0x32, 0xdc, 0x26, 0xd2, 0x4d, 0x8b, 0xe5, 0xfe, 0xa3, 0x56, 0x8f, 0xdd, 0x6a, 0xb9, 0x84, 0xf3, 0x16, 0xb4, 0x7a, 0xca, 0xb3, 0x3d, 0xf1, 0xe2, 0xf5, 0xff, 0xf6, 0xb4, 0xfc, 0x9b, 0x8e, 0x5f, 0x90, 0x87, 0xf8, 0xfa, 0x97, 0xbf, 0xb0, 0xfa, 0x7a, 0xb3, 0x18, 0x2c, 0x37, 0x85, 0xe5, 0x6e, 0xeb, 0x70, 0x9b, 0x48, 0x35, 0x2b, 0x96, 0x77, 0x18, 0xb6, 0x76, 0xec, 0x36, 0xcb, 0x4b, 0x36, 0x9f, 0xf3, 0x34, 0x83, 0xe5, 0x4f, 0xfe, 0x4f, 0xd5, 0x28, 0xdf, 0xfc, 0x9f, 0x8b, 0x2f, 0xb0, 0x7c, 0x11, 0x96, 0xb7, 0x6c, 0xef, 0xb6, 0x10, 0xb7, 0x89, 0x34, 0x93, 0x62, 0x79, 0x87, 0x61, 0x6b, 0x07, 0x6f, 0xb1, 0xbc, 0x46, 0xe6, 0x35, 0x50, 0xe1, 0x2d, 0x7f, 0xc5, 0x13, 0xeb, 0x5f, 0xb8, 0x85, 0x9e, 0xfc, 0xe2, 0xed, 0x53, 0x2d, 0x58, 0xbe, 0x08, 0xcb, 0x5b, 0xb6, 0x77, 0x5c, 0x8a, 0xdb, 0x44, 0xf5, 0x53, 0x62, 0x79, 0x8f, 0x71, 0x2b, 0x47, 0x6f, 0xb0, 0xbc, 0x0a, 0xe6, 0x78, 0x96, 0x0b, 0x64, 0xbe, 0xea, 0xf8, 0x1f, 0x9a, 0x91, 0x6e, 0x77, 0x2e, 0x96, 0x2f, 0xc2, 0xf2, 0x96, 0xed, 0x3d, 0xd7, 0xe2, 0x36, 0x51, 0xf5, 0x8c, 0x58, 0xde, 0x63, 0xdc, 0xca, 0xd1, 0xcd, 0x96, 0x57, 0xb2, 0xbc, 0x02, 0xca, 0x81, 0xf2, 0x8e, 0x96, 0xbf, 0xfa, 0xdf, 0x75, 0x03, 0xbd, 0xea, 0xf3, 0x8f, 0xfe, 0x89, 0xe5, 0x8b, 0xb0, 0xbc, 0x65, 0x7b, 0x55, 0x9a, 0x87, 0x0d, 0xcb, 0x9b, 0x1b, 0xfc, 0x7c, 0x59, 0x69, 0x78, 0xab, 0xe5, 0xb5, 0x2c, 0x4f, 0x63, 0xf9, 0xb7, 0xbc, 0xa8, 0x1d, 0xe8, 0x5b, 0xff, 0xe5, 0xd1, 0x3f, 0xb1, 0x7c, 0x11, 0x96, 0xb7, 0x6c, 0xaf, 0xac, 0xfe, 0x81, 0xbb, 0x18, 0xcb, 0xf7, 0x6b, 0xbf, 0xc7, 0xd2, 0xe5, 0xcf, 0x9f, 0xc6, 0xb3, 0xe5, 0xdb, 0xff, 0xb5, 0x6e, 0xbb, 0x6f, 0x7b, 0x7e, 0xf9, 0x95, 0xc7, 0xa3, 0xd4, 0x6a, 0xf9, 0x53, 0x9f, 0x3d, 0xbb, 0xe1, 0xb4, 0x07, 0xbe, 0xf3, 0xf8, 0x7c, 0x62, 0x5b, 0xb9, 0xc5, 0x7d, 0x3b, 0x5f, 0xcc, 0x77, 0xfc, 0x73, 0xf9, 0xc7, 0xcf, 0x7f, 0xe6, 0x95, 0xff, 0xad, 0x9c, 0x1f, 0xcb, 0x35, 0x43, 0x79, 0x15, 0xcc, 0xf2, 0xfa, 0x47, 0x0e, 0xcb, 0xd5, 0x05, 0xb3, 0xbc, 0x34, 0xbe, 0xed, 0x6c, 0xf9, 0xae, 0x73, 0x10, 0xab, 0x66, 0x7f, 0xcd, 0xe7, 0x73, 0x9b, 0x29, 0x6a, 0xb5, 0x7c, 0xf3, 0x1b, 0xf3, 0xd5, 0x1e, 0x78, 0xfa, 0x33, 0x86, 0x91, 0x16, 0xf7, 0x0d, 0xcb, 0x17, 0x61, 0x79, 0xcb, 0xf6, 0xea, 0x6a, 0x1f, 0x3a, 0x2c, 0x57, 0x17, 0xee, 0xef, 0xd8, 0xf2, 0x04, 0xb6, 0xb3, 0xa5, 0x76, 0x77, 0xbf, 0xee, 0xd3, 0xcb, 0xaf, 0xb4, 0x4f, 0x48, 0x27, 0xeb, 0x61, 0x79, 0xe5, 0xcb, 0x10, 0xd7, 0x2d, 0xed, 0xc5, 0xf2, 0x45, 0x58, 0xde, 0xb2, 0xbd, 0xbe, 0xca, 0xc7, 0x0e, 0xcb, 0xd5, 0xdd, 0x05, 0xcb, 0x9f, 0x79, 0xae, 0x72, 0xc3, 0xa7, 0x3f, 0xb9, 0xfc, 0xea, 0xf5, 0x9f, 0xce, 0x6d, 0xa7, 0xa8, 0x83, 0xe5, 0xdf, 0xf3, 0x29, 0xcb, 0x40, 0xdf, 0xfd, 0x89, 0xdb, 0x7f, 0x63, 0xf9, 0x22, 0x2c, 0x6f, 0xd9, 0xde, 0x92, 0xd7, 0x9b, 0x4d, 0xda, 0x67, 0xc2, 0x72, 0x6b, 0x0e, 0x98, 0x5b, 0xce, 0x96, 0xfa, 0xe7, 0x4a, 0x5e, 0xff, 0xf1, 0xe5, 0x57, 0x2e, 0x0f, 0x52, 0xa3, 0xe5, 0xdb, 0x3f, 0x4a, 0xbe, 0xe1, 0x1f, 0x6d, 0x23, 0x2d, 0x77, 0x2b, 0x96, 0x2f, 0xc2, 0xf2, 0x96, 0xed, 0x4d, 0xd5, 0x3c, 0x7c, 0x58, 0xae, 0x2e, 0xe0, 0x6b, 0x92, 0xa4, 0x29, 0x2c, 0x67, 0xcb, 0x1b, 0x3e, 0x51, 0xde, 0x26, 0x31, 0x73, 0xf5, 0x93, 0xec, 0x62, 0xde, 0x96, 0x9b, 0x5f, 0x5b, 0x33, 0xb3, 0xe5, 0xe7, 0x94, 0xb7, 0x9c, 0x40, 0x58, 0xbe, 0x6a, 0x88, 0xe5, 0x35, 0x0f, 0x1f, 0x96, 0xab, 0xbb, 0x03, 0x96, 0xa7, 0x67, 0x7d, 0xf6, 0xf8, 0xc9, 0x97, 0x7e, 0x11, 0xff, 0xd8, 0xf2, 0xa6, 0x37, 0x7e, 0x64, 0xf9, 0xd5, 0x0f, 0x7c, 0xd4, 0x30, 0xd7, 0x26, 0x67, 0xcb, 0xcd, 0x94, 0xbf, 0xe9, 0x6f, 0x17, 0x5f, 0x8c, 0xb1, 0xfc, 0x60, 0xc6, 0x3c, 0xa8, 0xe5, 0x5b, 0x7f, 0x3d, 0xc7, 0xf2, 0x29, 0xa6, 0xe5, 0x15, 0x0f, 0x20, 0x96, 0xab, 0xdb, 0xf7, 0xb1, 0x6c, 0xc6, 0xdc, 0x70, 0xb2, 0xfc, 0xd0, 0x47, 0xb6, 0xb7, 0x3d, 0xf3, 0xc4, 0x87, 0x1f, 0xfe, 0xeb, 0xfb, 0x5e, 0xf8, 0xc2, 0x97, 0x6e, 0x6e, 0xfd, 0xc1, 0xbf, 0x5e, 0x6e, 0xf3, 0xba, 0xcf, 0xe9, 0xe7, 0xda, 0xe6, 0x6b, 0xb9, 0xfd, 0x15, 0xef, 0xaf, 0xfd, 0xa7, 0xc5, 0x17, 0x58, 0xbe, 0x08, 0xcb, 0x5b, 0xb6, 0x37, 0x17, 0xe2, 0xc9, 0x1c, 0x2c, 0xb7, 0x37, 0xc2, 0xf2, 0x37, 0x7e, 0xfc, 0xfc, 0x96, 0x67, 0x5f, 0xf1, 0xa1, 0xd5, 0xd7, 0x6f, 0x7e, 0xf1, 0x53, 0x89, 0x79, 0x7f, 0x34, 0xf1, 0xdf, 0x80, 0x9b, 0xbe, 0xb2, 0xb9, 0xa5, 0xcf, 0x35, 0x6f, 0x95, 0xbf, 0x96, 0x3f, 0xf9, 0xf4, 0xe7, 0x5e, 0xfd, 0x77, 0xf7, 0x93, 0x5b, 0xae, 0xee, 0xdb, 0x64, 0x96, 0x6f, 0x29, 0xb7, 0x9f, 0x40, 0x89, 0x63, 0xcb, 0x0c, 0xb0, 0xa3, 0xe5, 0xdd, 0x3e, 0x43, 0x25, 0xac, 0xe5, 0xa5, 0x99, 0xb0, 0x5c, 0x5d, 0xc8, 0xf7, 0x7d, 0xe5, 0x27, 0x31, 0x9c, 0x2c, 0x9b, 0x29, 0xdf, 0xfc, 0x97, 0x9b, 0x6d, 0xde, 0x72, 0xfc, 0xa0, 0x38, 0xed, 0x79, 0x6f, 0xdd, 0x0c, 0x51, 0xfa, 0x59, 0xcb, 0x5b, 0x2d, 0x37, 0x49, 0x94, 0xbf, 0xe5, 0xa3, 0x6f, 0xfa, 0xc0, 0xd5, 0xff, 0xae, 0x54, 0x78, 0xf4, 0x03, 0x6f, 0xfd, 0x73, 0x69, 0x31, 0x3b, 0x59, 0x6e, 0xc5, 0x3c, 0x61, 0xb9, 0xf9, 0x0c, 0xea, 0x6b, 0xb9, 0x79, 0xac, 0x3b, 0x68, 0x79, 0x61, 0x2a, 0x2c, 0x57, 0x17, 0xf3, 0x7d, 0x5f, 0xd9, 0x59, 0xf4, 0xe7, 0xca, 0xdb, 0xff, 0xa2, 0x6a, 0xf0, 0x9f, 0xfc, 0xc0, 0xe1, 0x6d, 0x7f, 0x56, 0x3d, 0xe8, 0x18, 0xcb, 0x05, 0xca, 0xdf, 0xfe, 0xdc, 0xcd, 0xeb, 0x2e, 0xcf, 0x55, 0x78, 0xdb, 0xd7, 0xbd, 0xff, 0xa5, 0xff, 0xfb, 0x53, 0x7f, 0x2a, 0x2d, 0x26, 0xb6, 0xe5, 0x29, 0xca, 0x23, 0x58, 0x9e, 0xf2, 0x17, 0xcb, 0x35, 0x49, 0x93, 0x61, 0xb9, 0xba, 0x8b, 0xb7, 0x7c, 0xf3, 0x74, 0xf9, 0xea, 0x4a, 0xde, 0x8b, 0xde, 0xf1, 0x5f, 0x1f, 0x4e, 0x7f, 0x23, 0xd1, 0x10, 0xcb, 0xf3, 0x94, 0xff, 0xf4, 0x9f, 0xdc, 0xfe, 0x3b, 0xf1, 0xda, 0x8a, 0x67, 0x9e, 0x3b, 0xfc, 0xcc, 0x1f, 0x4b, 0x8b, 0xd9, 0xcb, 0x72, 0x1b, 0xe6, 0x49, 0xcb, 0x8d, 0xa7, 0x50, 0xf2, 0x61, 0x32, 0x02, 0xec, 0x68, 0x79, 0xbf, 0x8f, 0xa9, 0x0d, 0x6d, 0xb9, 0x34, 0x1b, 0x96, 0xab, 0x0b, 0xfa, 0x1e, 0xde, 0xdc, 0x34, 0xfa, 0x73, 0xe5, 0xc7, 0x3e, 0x74, 0x76, 0x83, 0xc7, 0xe3, 0x17, 0xca, 0xf2, 0x77, 0xfc, 0xd1, 0xf2, 0xab, 0xe4, 0xeb, 0xe4, 0xde, 0xf9, 0x87, 0xe2, 0x62, 0x76, 0xb3, 0xdc, 0x82, 0x79, 0x9a, 0x72, 0xdb, 0x29, 0x94, 0x79, 0x94, 0x4c, 0x02, 0xa7, 0xfd, 0x75, 0x1c, 0xca, 0xa5, 0xd8, 0x96, 0x0b, 0xd3, 0x61, 0xb9, 0xba, 0xa0, 0xef, 0xe1, 0xf5, 0xb3, 0xfc, 0xfb, 0xff, 0x61, 0xfd, 0xf5, 0xb3, 0x7f, 0xaf, 0x1e, 0x62, 0xdb, 0x08, 0xcb, 0x33, 0x94, 0xff, 0xec, 0x1f, 0xac, 0xbf, 0xae, 0x79, 0xcd, 0xf3, 0x38, 0xcb, 0xf5, 0x98, 0x67, 0x28, 0xb7, 0x9d, 0x43, 0x8e, 0x96, 0xe7, 0xfc, 0xf5, 0x1c, 0xcb, 0xa1, 0xe0, 0x96, 0xe7, 0xe7, 0xc3, 0x72, 0x75, 0x41, 0x2d, 0xf7, 0x3b, 0xeb, 0xce, 0xdf, 0x89, 0xff, 0x9a, 0xcf, 0xa8, 0x87, 0xd8, 0x16, 0xc6, 0xf2, 0x9f, 0xfb, 0xfd, 0xf3, 0x5b, 0x82, 0x5b, 0xae, 0xc5, 0x3c, 0x4b, 0xb9, 0xe5, 0x24, 0x72, 0x7c, 0xea, 0x2e, 0xcf, 0xaf, 0xe7, 0x58, 0xed, 0x45, 0xb7, 0x3c, 0x3b, 0x23, 0x96, 0xab, 0x1b, 0xf0, 0x58, 0xb6, 0x60, 0xae, 0x3f, 0x51, 0xbe, 0xe1, 0x4b, 0xeb, 0xaf, 0x15, 0x7f, 0xe1, 0xcc, 0x37, 0xc0, 0xf2, 0x24, 0xe5, 0x09, 0x50, 0xa3, 0x5b, 0xae, 0xc2, 0x5c, 0x90, 0xfc, 0xa0, 0x3f, 0x8b, 0x1c, 0x5f, 0xeb, 0x2a, 0xf1, 0xeb, 0x39, 0x56, 0x73, 0xf1, 0x2d, 0xcf, 0x4c, 0x89, 0xe5, 0xea, 0x2e, 0xde, 0xf2, 0x73, 0x76, 0xdf, 0xf9, 0x7b, 0xea, 0x21, 0xca, 0x83, 0x0e, 0xb2, 0xfc, 0x7b, 0x3f, 0xb6, 0xbd, 0x2d, 0xaa, 0xe5, 0x0f, 0x6e, 0x17, 0x52, 0xad, 0xb9, 0x4c, 0xb9, 0xf6, 0x34, 0x72, 0xbc, 0x6a, 0x9b, 0xcc, 0xaf, 0xee, 0x20, 0xed, 0x4a, 0xf9, 0x0c, 0x96, 0xa7, 0xe7, 0xc4, 0x72, 0x75, 0x61, 0xaf, 0x93, 0xe6, 0xf5, 0x92, 0x83, 0x5f, 0x38, 0x7b, 0x3e, 0x79, 0xd2, 0xbf, 0x7d, 0xa6, 0x28, 0xbf, 0xf7, 0xe5, 0xc4, 0x8d, 0x13, 0x58, 0x7e, 0xa8, 0xe2, 0xbc, 0x04, 0xf9, 0xa9, 0xfa, 0x13, 0xa9, 0xf8, 0xb0, 0x2b, 0x0e, 0xad, 0x22, 0xbf, 0xf5, 0x63, 0xf5, 0x95, 0x7c, 0x0e, 0xcb, 0x93, 0xb3, 0x62, 0xb9, 0xba, 0xb0, 0xd7, 0x49, 0xf3, 0xb2, 0xfc, 0x5d, 0xe7, 0xcf, 0x28, 0xff, 0xfc, 0xef, 0xa8, 0xc7, 0xd8, 0x14, 0xc3, 0xf2, 0xe4, 0x9c, 0x41, 0x2d, 0x7f, 0xd0, 0x72, 0xe1, 0x29, 0xa9, 0xe6, 0xb7, 0x12, 0xdf, 0x56, 0xb7, 0xc2, 0x3a, 0x7d, 0x3d, 0xc7, 0x6a, 0x69, 0x0e, 0xcb, 0x13, 0xd3, 0x62, 0xb9, 0xba, 0xb8, 0x96, 0x27, 0xa7, 0xd2, 0x83, 0xf0, 0xee, 0xdf, 0x3d, 0xbb, 0xc1, 0xe3, 0x8f, 0x9f, 0xbb, 0x5b, 0x9e, 0xa2, 0xfc, 0x5d, 0xbf, 0x9d, 0xda, 0xf2, 0xae, 0x59, 0x4e, 0x62, 0x93, 0x58, 0xbe, 0x9d, 0x17, 0xcb, 0xd5, 0x8d, 0x79, 0x2c, 0xcd, 0x98, 0x7b, 0xbc, 0x87, 0xff, 0x27, 0xde, 0xaf, 0x1f, 0xe4, 0xac, 0x08, 0x96, 0xff, 0xe2, 0x6f, 0x25, 0xb7, 0x8c, 0x69, 0xf9, 0x83, 0xa6, 0x0b, 0xc2, 0x92, 0xb9, 0x59, 0x2c, 0xdf, 0x4c, 0x8c, 0xe5, 0xea, 0x2e, 0xdf, 0xf2, 0x1f, 0xff, 0x60, 0xc5, 0xb8, 0xca, 0x02, 0x58, 0xfe, 0xee, 0xf7, 0xa5, 0xb7, 0x0c, 0x69, 0xf9, 0x83, 0xcc, 0x42, 0xa8, 0x77, 0xd3, 0x58, 0x7e, 0x3e, 0x35, 0x96, 0xab, 0x1b, 0xf4, 0x58, 0x5a, 0x31, 0x37, 0x80, 0xf0, 0xd4, 0xbf, 0x9d, 0xdf, 0xb2, 0xbe, 0x38, 0x89, 0xa5, 0x00, 0x96, 0xff, 0xf0, 0x5f, 0xa5, 0xb7, 0x8c, 0x68, 0xf9, 0x83, 0xdc, 0x42, 0xa8, 0x77, 0x13, 0x59, 0xbe, 0x9e, 0x1b, 0xcb, 0xd5, 0x8d, 0x7a, 0x2c, 0x8d, 0x7f, 0xfe, 0xf4, 0xf9, 0x2c, 0x8a, 0x6f, 0x7c, 0xc1, 0x30, 0xcc, 0xb2, 0xbd, 0x2d, 0xdf, 0x52, 0xbe, 0xbe, 0xf0, 0xe1, 0xa2, 0x80, 0x96, 0x3f, 0xc8, 0x2e, 0x84, 0x7a, 0x37, 0x93, 0xe5, 0xab, 0xc9, 0xb1, 0x5c, 0x5d, 0x68, 0xcb, 0xb7, 0xb3, 0x59, 0x40, 0x78, 0xed, 0xf3, 0x9b, 0x9b, 0x7e, 0xe9, 0xbd, 0x86, 0x71, 0x16, 0x8d, 0xb7, 0xfc, 0x97, 0x7f, 0x33, 0xb3, 0x69, 0x38, 0xcb, 0x6f, 0x16, 0x84, 0xe5, 0x23, 0x9a, 0xca, 0xf2, 0xe5, 0xf4, 0x58, 0xae, 0x6e, 0xd8, 0x63, 0x69, 0xc3, 0xdc, 0x02, 0xc2, 0x8f, 0xfc, 0x4d, 0x79, 0x5c, 0x65, 0xe3, 0x2d, 0xcf, 0xce, 0x17, 0xcc, 0xf2, 0xdb, 0xe5, 0x60, 0x39, 0x95, 0x7b, 0x74, 0x98, 0x75, 0xfe, 0x8f, 0x06, 0xcd, 0x59, 0xea, 0x05, 0x7d, 0x96, 0x8f, 0x82, 0x90, 0x46, 0x2c, 0x8d, 0xb7, 0xf9, 0x89, 0x46, 0xcb, 0x9b, 0xd6, 0x6f, 0x59, 0x4c, 0xdb, 0x1d, 0x38, 0x60, 0x39, 0x55, 0x75, 0x83, 0x39, 0x96, 0x53, 0xa2, 0xe4, 0xa5, 0x4c, 0x7c, 0x31, 0xd4, 0x5b, 0x5e, 0xea, 0xa9, 0xcf, 0x8a, 0x3f, 0xec, 0xbc, 0x7c, 0x43, 0x58, 0x4e, 0x3d, 0x7a, 0x88, 0x39, 0x96, 0x53, 0x2a, 0x77, 0xcc, 0x77, 0xb0, 0x7c, 0x39, 0xa0, 0xf3, 0xaf, 0xe5, 0x58, 0x4e, 0x91, 0x3b, 0x69, 0x8e, 0xe5, 0x94, 0xac, 0x12, 0xf3, 0x7b, 0xe9, 0x9b, 0x6b, 0xc6, 0xc3, 0xf2, 0x52, 0x58, 0x4e, 0x95, 0x5d, 0x61, 0x8e, 0xe5, 0x94, 0x2c, 0x8d, 0x57, 0x06, 0xf3, 0xe4, 0x77, 0x4a, 0xe3, 0x61, 0x79, 0x29, 0x2c, 0xa7, 0xda, 0x1e, 0xc3, 0x72, 0xca, 0xa4, 0xb5, 0x3c, 0xfd, 0x5d, 0x69, 0x3c, 0x6f, 0xcb, 0x57, 0xe3, 0x61, 0x39, 0xdd, 0xb1, 0x1e, 0xc3, 0x72, 0x4a, 0x94, 0xa5, 0x6b, 0xc3, 0xd1, 0x3d, 0xf1, 0xbb, 0xd2, 0x88, 0x58, 0x5e, 0x0a, 0xcb, 0x89, 0xa8, 0x29, 0x41, 0xae, 0x73, 0x8f, 0xee, 0x89, 0xdf, 0x95, 0x86, 0xc4, 0xf2, 0x52, 0x58, 0x4e, 0x44, 0x0d, 0xc9, 0x6e, 0x9d, 0x81, 0x84, 0xe5, 0xf5, 0x61, 0x39, 0x11, 0xed, 0x57, 0x89, 0xad, 0xb5, 0x48, 0x61, 0x2c, 0x97, 0x96, 0x55, 0x33, 0x9d, 0x1c, 0x96, 0x13, 0xd1, 0x5c, 0x15, 0xd5, 0xfa, 0x95, 0xdf, 0xc8, 0x6f, 0x8e, 0xe5, 0x52, 0x58, 0x4e, 0x44, 0x7b, 0x55, 0x81, 0x96, 0xf0, 0x64, 0x06, 0x96, 0x4b, 0x61, 0x39, 0x11, 0xed, 0x55, 0x0d, 0x5a, 0xf9, 0x17, 0x72, 0x63, 0xb9, 0x14, 0x96, 0x13, 0xd1, 0x4e, 0xd5, 0x99, 0xb5, 0x40, 0x29, 0x8a, 0xe5, 0xe2, 0x9f, 0x64, 0x6b, 0xa6, 0x93, 0x0b, 0x60, 0xf9, 0xcb, 0x4a, 0x9b, 0x7f, 0xad, 0x7a, 0xe0, 0xe2, 0x15, 0x37, 0x79, 0xa9, 0x32, 0xd1, 0xdc, 0xd5, 0x92, 0x75, 0xab, 0x12, 0x96, 0xd7, 0xd7, 0x60, 0x79, 0x11, 0xf2, 0xeb, 0x6a, 0x38, 0xaf, 0xbd, 0x7a, 0x34, 0x9e, 0x13, 0xcd, 0x5b, 0x8a, 0x40, 0xf9, 0xfa, 0xb7, 0xd3, 0x58, 0x3e, 0xf3, 0x75, 0x12, 0x2b, 0x25, 0xbf, 0xaa, 0xa4, 0xb9, 0xe6, 0x73, 0x00, 0xd0, 0x9c, 0x68, 0xd2, 0xd2, 0xe0, 0x8a, 0x98, 0xef, 0x68, 0xb9, 0x86, 0xc2, 0xee, 0x96, 0xef, 0x78, 0xfd, 0x72, 0x85, 0xe4, 0x57, 0x89, 0x9a, 0xeb, 0x3e, 0xd2, 0x05, 0xcc, 0x89, 0xe6, 0x2c, 0xad, 0x8f, 0x78, 0xc9, 0xc4, 0xa0, 0x96, 0xbf, 0x67, 0xfb, 0x91, 0x76, 0xb3, 0x5a, 0xae, 0xa4, 0x5c, 0xc2, 0x5c, 0xfd, 0xe1, 0x5c, 0x60, 0x4e, 0x34, 0x65, 0xe7, 0xfa, 0xdc, 0x4f, 0xdf, 0x9c, 0xff, 0x5e, 0x18, 0xcb, 0x2f, 0xe7, 0x73, 0x85, 0xd4, 0x94, 0xe7, 0x31, 0x37, 0x7c, 0xce, 0x22, 0x98, 0x13, 0x4d, 0x58, 0x16, 0x9f, 0x3c, 0xe6, 0xf7, 0x12, 0xb7, 0xd5, 0x8d, 0xbd, 0xbb, 0xe5, 0xbe, 0x1f, 0xa5, 0xb1, 0x97, 0xe5, 0x06, 0xca, 0xb3, 0x98, 0x5b, 0x3e, 0x33, 0x17, 0xcc, 0x89, 0xe6, 0x2b, 0x8f, 0x4f, 0x16, 0x73, 0x2c, 0xf7, 0xfd, 0x99, 0x55, 0xce, 0x96, 0xdb, 0x3e, 0xfe, 0x1c, 0xcc, 0x89, 0xa6, 0x2b, 0xf3, 0x14, 0x4b, 0xea, 0x5b, 0x37, 0xdf, 0xc6, 0x72, 0xdf, 0x9f, 0x59, 0x75, 0x34, 0x52, 0x9e, 0xc6, 0xdc, 0x46, 0x39, 0x96, 0x13, 0xcd, 0x97, 0x60, 0x79, 0x0e, 0xf3, 0x99, 0x2c, 0x6f, 0xc1, 0x7c, 0x90, 0xe5, 0x46, 0xca, 0x3d, 0x2d, 0x07, 0x73, 0xa2, 0xe9, 0x92, 0x2c, 0x4f, 0xe3, 0x58, 0x4d, 0xf9, 0xee, 0x96, 0x3b, 0x63, 0x3e, 0x99, 0xe5, 0x09, 0xcc, 0xad, 0x94, 0x63, 0x39, 0xd1, 0x6c, 0x15, 0xec, 0xd1, 0x5e, 0x75, 0xab, 0x30, 0x38, 0x96, 0x17, 0x8b, 0x61, 0x39, 0x98, 0x13, 0x4d, 0xd6, 0xe5, 0x5b, 0x6e, 0xc7, 0x7c, 0x8c, 0xe5, 0x66, 0xca, 0xb1, 0x9c, 0xe8, 0x0e, 0x57, 0xb2, 0xa7, 0x8c, 0x79, 0x24, 0xcb, 0x7d, 0x31, 0x9f, 0xcd, 0xf2, 0x2d, 0xe6, 0x58, 0x4e, 0x74, 0x57, 0x2a, 0xda, 0xa3, 0xfb, 0xc4, 0xa1, 0xd2, 0xcf, 0x0e, 0xb1, 0xdc, 0x8a, 0x39, 0x96, 0x13, 0xd1, 0x2c, 0x95, 0xb9, 0x2d, 0x60, 0x1e, 0xcb, 0xf2, 0xf4, 0x6a, 0x7f, 0xf5, 0xd7, 0x95, 0xa3, 0xd8, 0x17, 0x13, 0xca, 0x72, 0x3b, 0xe5, 0x58, 0x4e, 0x34, 0x59, 0x15, 0xdc, 0xca, 0x98, 0xcf, 0x60, 0xb9, 0xf1, 0x17, 0x73, 0x2c, 0x27, 0xa2, 0x69, 0xaa, 0xc0, 0x47, 0xc2, 0x5c, 0xa4, 0x2a, 0x8c, 0xe5, 0x36, 0xcd, 0xb1, 0x9c, 0x88, 0xa6, 0xa9, 0xc2, 0xdb, 0x5f, 0x7b, 0x5f, 0xfe, 0xc7, 0xa3, 0x59, 0xee, 0x89, 0x39, 0x96, 0x13, 0xd1, 0x34, 0xd5, 0x78, 0x2b, 0xfc, 0x62, 0x1e, 0xce, 0xf2, 0xfc, 0x62, 0xdb, 0xff, 0xb3, 0x80, 0xe5, 0x44, 0x14, 0xb5, 0xaa, 0x6b, 0x98, 0x18, 0x7d, 0x8c, 0x65, 0x79, 0x1d, 0xc5, 0xd2, 0xf5, 0x68, 0xb0, 0x9c, 0x88, 0xa2, 0x56, 0xf7, 0x56, 0x49, 0xdb, 0x33, 0x17, 0x43, 0x2c, 0x37, 0xff, 0x7f, 0x11, 0xd7, 0x3f, 0x89, 0xe5, 0xa7, 0xb0, 0x9c, 0x68, 0xb6, 0x5a, 0x30, 0xaf, 0xb0, 0x51, 0xf5, 0x03, 0x2e, 0x96, 0xcb, 0x2f, 0xbc, 0x29, 0x5d, 0x09, 0x0c, 0xcb, 0x4f, 0x61, 0x39, 0xd1, 0x6c, 0x55, 0x2a, 0x6d, 0x79, 0x47, 0x65, 0x44, 0xcb, 0xd3, 0x63, 0xde, 0x4b, 0x7d, 0x13, 0xcb, 0x89, 0x68, 0x9e, 0x32, 0xf2, 0x55, 0xbd, 0x65, 0xa8, 0xbf, 0xe5, 0x95, 0xa9, 0xaf, 0x22, 0xf3, 0xe8, 0x67, 0x34, 0xd7, 0x6f, 0xc7, 0x72, 0x22, 0x8a, 0x5b, 0xc5, 0x1f, 0x36, 0x8d, 0x2f, 0xf4, 0x1b, 0x65, 0xb9, 0x79, 0x98, 0x03, 0x96, 0x3f, 0x0c, 0xcb, 0x89, 0xa6, 0xab, 0x01, 0xbe, 0xfe, 0x7f, 0xfb, 0x34, 0x2e, 0xc4, 0x7e, 0x9f, 0xb0, 0xfc, 0x14, 0x96, 0x13, 0xcd, 0x57, 0x37, 0xcc, 0xc7, 0x59, 0xee, 0x32, 0x10, 0x96, 0x13, 0xd1, 0x54, 0xf5, 0xc2, 0x7c, 0xa0, 0xe5, 0x1e, 0xcf, 0xd6, 0x60, 0x39, 0x11, 0x4d, 0x55, 0x8b, 0xe5, 0x9d, 0xaf, 0x5f, 0x6e, 0x5f, 0x85, 0x71, 0x28, 0x2c, 0x3f, 0x85, 0xe5, 0x44, 0x33, 0xd6, 0x09, 0xf3, 0x1d, 0x2d, 0x77, 0xc3, 0x1c, 0xcb, 0x4f, 0x61, 0x39, 0xd1, 0x94, 0xf5, 0x79, 0x96, 0x65, 0xac, 0xe5, 0xb6, 0xc1, 0xb0, 0xfc, 0x14, 0x96, 0x13, 0xcd, 0x59, 0x17, 0xcc, 0x07, 0x5b, 0x6e, 0x1a, 0x0e, 0xcb, 0x4f, 0x61, 0x39, 0xd1, 0xa4, 0xf5, 0xc0, 0x7c, 0xb8, 0xe5, 0x86, 0x01, 0xb1, 0xfc, 0x14, 0x96, 0x13, 0x4d, 0x9b, 0xcf, 0x1b, 0x6c, 0xe4, 0x11, 0xfb, 0x59, 0x9e, 0x1b, 0xfa, 0x3d, 0xef, 0x35, 0x0f, 0x83, 0xe5, 0x44, 0x34, 0x63, 0x95, 0x6f, 0x7d, 0xaf, 0xbb, 0x18, 0x57, 0x7a, 0xc0, 0xfd, 0x2d, 0xd7, 0x0e, 0x8a, 0xe5, 0xa7, 0xb0, 0x9c, 0x68, 0xe6, 0xca, 0xea, 0xdd, 0xcf, 0x6c, 0x55, 0xf9, 0x74, 0xf5, 0x10, 0xcb, 0x55, 0xc3, 0x62, 0xf9, 0x29, 0x2c, 0x27, 0x9a, 0x3b, 0x59, 0xbd, 0xfb, 0xd9, 0x8d, 0xc6, 0x5b, 0xae, 0x7d, 0x0b, 0x6a, 0x79, 0x0c, 0x2c, 0x27, 0xa2, 0x79, 0xab, 0xf9, 0x0c, 0xa1, 0x4a, 0xcc, 0x03, 0x59, 0x5e, 0x35, 0x76, 0xe9, 0xa2, 0x2e, 0x58, 0x4e, 0x44, 0x33, 0x55, 0xfb, 0x7b, 0xf7, 0x84, 0x19, 0x3f, 0xed, 0x6e, 0xbf, 0xb0, 0x9c, 0x88, 0x5c, 0x4b, 0x7e, 0x3c, 0xc3, 0x85, 0xb4, 0x14, 0x3d, 0xd8, 0xbd, 0xc3, 0x72, 0x22, 0xa2, 0xf9, 0xc3, 0x72, 0x22, 0xa2, 0xf9, 0xc3, 0x72, 0x22, 0xa2, 0xf9, 0xc3, 0x72, 0x22, 0xa2, 0xf9, 0xc3, 0x72, 0x22, 0xa2, 0xf9, 0xf3, 0xb4, 0xbc, 0x01, 0x73, 0x2c, 0x27, 0x22, 0x6a, 0xa8, 0xc1, 0xf2, 0x0d, 0xe5, 0x58, 0x4e, 0x44, 0x34, 0xa6, 0xe3, 0xc1, 0x8c, 0x39, 0x96, 0x13, 0x11, 0x05, 0x29, 0x86, 0xe5, 0x50, 0x4e, 0x44, 0xd4, 0x92, 0xdd, 0xf2, 0x2d, 0xe5, 0x76, 0xcc, 0xb1, 0x9c, 0x88, 0xa8, 0xa5, 0xe3, 0xc1, 0x8a, 0xb9, 0xa3, 0xe5, 0x50, 0x4e, 0x44, 0xd4, 0x94, 0xd9, 0xf2, 0x14, 0xe5, 0x56, 0xcc, 0xb1, 0x9c, 0x88, 0xa8, 0xa9, 0x97, 0x2c, 0xb7, 0x61, 0xee, 0x68, 0x39, 0x94, 0x13, 0x11, 0xb5, 0x75, 0x65, 0xb9, 0x05, 0xf3, 0x34, 0xe5, 0x26, 0xcc, 0xa1, 0x9c, 0x88, 0xa8, 0xb1, 0x93, 0xe5, 0x7a, 0xcc, 0x73, 0x94, 0x1b, 0x30, 0x87, 0x72, 0x22, 0xa2, 0xd6, 0xae, 0x2d, 0xd7, 0x62, 0x9e, 0xa7, 0x5c, 0x8d, 0x39, 0x94, 0x13, 0x11, 0x35, 0xf7, 0xd0, 0x72, 0x15, 0xe6, 0x92, 0xe4, 0x57, 0x69, 0x34, 0x87, 0x72, 0x22, 0xa2, 0xf6, 0x8e, 0x8f, 0xfe, 0x55, 0xad, 0x79, 0x89, 0xf2, 0x43, 0xbd, 0xe6, 0x48, 0x4e, 0x44, 0xe4, 0xd1, 0x71, 0xf9, 0x45, 0x05, 0xe7, 0x15, 0x90, 0x9f, 0xaa, 0xd0, 0x1c, 0xc8, 0x89, 0x88, 0x9c, 0xfa, 0x7f, 0x52, 0x13, 0x4f, 0xf6, 0x0e, 0xe1, 0xbe, 0x7d, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
-};
-static const unsigned int LOGO_PNG_SIZE = 6653;
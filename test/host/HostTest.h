@@ -0,0 +1,35 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstdio>
+
+// Minimal checks for the host tests: failures are counted and reported,
+// the test binary exits non-zero if any check failed.
+
+extern int g_failures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      g_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_OK(expr)                                                         \
+  do {                                                                         \
+    esp_err_t check_rc_ = (expr);                                              \
+    if (check_rc_ != ESP_OK) {                                                 \
+      fprintf(stderr, "%s:%d: %s returned %s\n", __FILE__, __LINE__, #expr,    \
+              esp_err_to_name(check_rc_));                                     \
+      g_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define RUN_TEST(fn)                                                           \
+  do {                                                                         \
+    int before_ = g_failures;                                                  \
+    printf("[ RUN  ] %s\n", #fn);                                              \
+    fn();                                                                      \
+    printf("[ %s ] %s\n", g_failures == before_ ? " OK " : "FAIL", #fn);       \
+  } while (0)
@@ -0,0 +1,202 @@
+#include "ReplaySource.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <algorithm>
+#include <cstring>
+
+static const char *TAG = "Replay";
+
+esp_err_t ReplaySource::init(const void* config) {
+    if (m_initialized) {
+        ESP_LOGW(TAG, "Already initialized");
+        return ESP_OK;
+    }
+
+    if (!config) {
+        ESP_LOGE(TAG, "Config is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_config = *static_cast<const Config*>(config);
+    if (!m_config.path || m_config.chunkSize == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_file = fopen(m_config.path, "rb");
+    if (!m_file) {
+        ESP_LOGE(TAG, "Cannot open %s", m_config.path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    fseek(m_file, 0, SEEK_END);
+    m_fileSize = (size_t)ftell(m_file);
+    rewind(m_file);
+    if (m_fileSize == 0) {
+        ESP_LOGE(TAG, "%s is empty", m_config.path);
+        fclose(m_file);
+        m_file = nullptr;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_streamOffset = 0;
+    m_bytesFed = 0;
+    m_running = false;
+    m_finished = false;
+
+    if (m_ring.init(m_config.ringBufSize) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create ring buffer");
+        fclose(m_file);
+        m_file = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t ret = xTaskCreatePinnedToCore(replayTask, "replay", 3072, this,
+                                             configMAX_PRIORITIES - 1,
+                                             &m_taskHandle, 0);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create replay task");
+        m_ring.deinit();
+        fclose(m_file);
+        m_file = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+
+    m_initialized = true;
+    ESP_LOGI(TAG, "Initialized: %s, %u bytes x %lu", m_config.path,
+             (unsigned)m_fileSize, (unsigned long)m_config.repeat);
+    return ESP_OK;
+}
+
+StagingRing* ReplaySource::getRing() {
+    return (m_ring.size() > 0) ? &m_ring : nullptr;
+}
+
+void ReplaySource::setBurstCallback(Transport::BurstCallback callback) {
+    m_burstCallback = callback;
+}
+
+void ReplaySource::setChunkCallback(Transport::ChunkCallback callback) {
+    m_chunkCallback = callback;
+}
+
+esp_err_t ReplaySource::getStats(Transport::Stats* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    m_stats.ringSize = m_ring.size();
+    m_stats.ringHighWater = m_ring.highWater();
+    *stats = m_stats;
+    return ESP_OK;
+}
+
+void ReplaySource::resetStats() {
+    m_stats.totalBytesReceived = 0;
+    m_stats.burstCount = 0;
+    m_stats.overflowCount = 0;
+    m_ring.resetHighWater();
+}
+
+esp_err_t ReplaySource::start() {
+    if (!m_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    m_running = true;
+    xTaskNotifyGive(m_taskHandle);
+    return ESP_OK;
+}
+
+esp_err_t ReplaySource::deinit() {
+    if (m_initialized) {
+        m_running = false;
+        if (m_taskHandle) {
+            vTaskDelete(m_taskHandle);
+            m_taskHandle = nullptr;
+        }
+        m_ring.deinit();
+        fclose(m_file);
+        m_file = nullptr;
+        m_initialized = false;
+        ESP_LOGI(TAG, "Deinitialized");
+    }
+    return ESP_OK;
+}
+
+// --- Task implementation ---
+
+size_t ReplaySource::feedChunk(size_t len) {
+    uint8_t* dst = nullptr;
+    size_t space = m_ring.reserve(&dst);
+    if (space == 0) {
+        return 0;
+    }
+
+    size_t n = fread(dst, 1, std::min(len, space), m_file);
+    if (n == 0) {
+        return 0;
+    }
+    if (m_chunkCallback) {
+        m_chunkCallback(m_streamOffset + n - 1, esp_timer_get_time());
+    }
+    m_ring.commit(n);
+
+    m_streamOffset += n;
+    m_stats.totalBytesReceived += n;
+    m_stats.bytesInCurrentBurst += n;
+    m_bytesFed += n;
+    return n;
+}
+
+void ReplaySource::endBurst() {
+    m_stats.burstActive = false;
+    if (m_burstCallback) {
+        m_burstCallback(true, m_stats.bytesInCurrentBurst);
+    }
+}
+
+void ReplaySource::replayTask(void* arg) {
+    ReplaySource* self = static_cast<ReplaySource*>(arg);
+    const Config& config = self->m_config;
+
+    while (!self->m_running) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    size_t burstLimit = config.burstBytes ? config.burstBytes : self->m_fileSize;
+    for (uint32_t pass = 0; pass < config.repeat && self->m_running; pass++) {
+        rewind(self->m_file);
+        size_t filePos = 0;
+
+        while (filePos < self->m_fileSize && self->m_running) {
+            if (!self->m_stats.burstActive) {
+                self->m_stats.burstActive = true;
+                self->m_stats.bytesInCurrentBurst = 0;
+                self->m_stats.burstCount++;
+            }
+
+            size_t want = std::min({config.chunkSize,
+                                    self->m_fileSize - filePos,
+                                    burstLimit - self->m_stats.bytesInCurrentBurst});
+            size_t fed = self->feedChunk(want);
+            if (fed == 0) {
+                vTaskDelay(1); // Ring full: wait for the writer
+                continue;
+            }
+            filePos += fed;
+
+            if (self->m_stats.bytesInCurrentBurst >= burstLimit ||
+                filePos == self->m_fileSize) {
+                self->endBurst();
+            }
+        }
+    }
+
+    self->m_finished = true;
+    ESP_LOGI(TAG, "Replay done: %llu bytes in %lu bursts",
+             (unsigned long long)self->m_bytesFed,
+             (unsigned long)self->m_stats.burstCount);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "IDataSource.h"
+#include "StagingRing.h"
+#include "TransportTypes.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @brief ReplaySource - Host transport that feeds a recorded capture
+ *
+ * Plays a raw capture file (the bytes a transport received, e.g. a dump
+ * from the "read" command) into DataPipeline through the same StagingRing
+ * the firmware transports use. Nothing is dropped: when the ring is full
+ * the replay waits for the writer, so a run takes as long as the ring
+ * logic needs and no longer.
+ *
+ * The file is cut into bursts of burstBytes (0 = one burst per pass) and
+ * replayed @p repeat times, each chunk reported with its feed time.
+ */
+class ReplaySource : public IDataSource {
+public:
+    /// Configuration structure
+    struct Config {
+        const char* path = nullptr;     ///< Raw capture file
+        size_t burstBytes = 0;          ///< Bytes per burst (0 = whole file)
+        uint32_t repeat = 1;            ///< Passes over the file
+        size_t chunkSize = 512;         ///< Bytes per fed chunk (one time mark each)
+        size_t ringBufSize = 32 * 1024; ///< Ring buffer size
+    };
+
+    // IDataSource interface implementation
+    esp_err_t init(const void* config) override;
+    StagingRing* getRing() override;
+    void setBurstCallback(Transport::BurstCallback callback) override;
+    void setChunkCallback(Transport::ChunkCallback callback) override;
+    esp_err_t getStats(Transport::Stats* stats) override;
+    void resetStats() override;
+    esp_err_t deinit() override;
+    Transport::Type getType() const override { return Transport::Type::SYNTHETIC; }
+
+    /**
+     * @brief Start feeding the file
+     */
+    esp_err_t start();
+
+    /// Whether every pass has been fed (the last burst is ended)
+    bool finished() const { return m_finished; }
+
+    /// Bytes fed to the ring so far
+    uint64_t bytesFed() const { return m_bytesFed; }
+
+    /// Size of the capture file
+    size_t fileSize() const { return m_fileSize; }
+
+private:
+    Config m_config;
+    StagingRing m_ring;
+    FILE* m_file = nullptr;
+    size_t m_fileSize = 0;
+    TaskHandle_t m_taskHandle = nullptr;
+    Transport::BurstCallback m_burstCallback = nullptr;
+    Transport::ChunkCallback m_chunkCallback = nullptr;
+    uint32_t m_streamOffset = 0;
+    bool m_initialized = false;
+    volatile bool m_running = false;
+    volatile bool m_finished = false;
+    Transport::Stats m_stats = {};
+    uint64_t m_bytesFed = 0;
+
+    // Feed up to @p len bytes of the file; returns the bytes fed (0 if
+    // the ring is full)
+    size_t feedChunk(size_t len);
+
+    void endBurst();
+
+    static void replayTask(void* arg);
+};
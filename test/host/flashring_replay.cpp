@@ -0,0 +1,126 @@
+// Replay a recorded capture through DataPipeline, RecordStore and FlashRing
+// on the simulated partition, as fast as the host runs the ring logic.
+//
+//   flashring_replay <capture.bin> [--partition KB] [--burst bytes]
+//                    [--repeat n] [--compress] [--image out.bin]
+//
+// Prints throughput, wraps, records, flash wear and the modelled flash
+// time the same traffic would need on the chip.
+
+#include "DataPipeline.h"
+#include "FlashRing.h"
+#include "RecordStore.h"
+#include "ReplaySource.h"
+#include "SimFlash.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char *LABEL = "datalog";
+
+static void usage() {
+  fprintf(stderr, "Usage: flashring_replay <capture.bin> [--partition KB] "
+                  "[--burst bytes] [--repeat n] [--compress] [--image out.bin]\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return 2;
+  }
+
+  ReplaySource::Config replayConfig;
+  replayConfig.path = argv[1];
+  replayConfig.ringBufSize = 256 * 1024;
+  size_t partitionKB = 64; // Same as the datalog partition in partitions.csv
+  bool compress = false;
+  const char *imagePath = nullptr;
+  for (int i = 2; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--partition") && hasValue) {
+      partitionKB = strtoul(argv[++i], nullptr, 0);
+    } else if (!strcmp(argv[i], "--burst") && hasValue) {
+      replayConfig.burstBytes = strtoul(argv[++i], nullptr, 0);
+    } else if (!strcmp(argv[i], "--repeat") && hasValue) {
+      replayConfig.repeat = strtoul(argv[++i], nullptr, 0);
+    } else if (!strcmp(argv[i], "--compress")) {
+      compress = true;
+    } else if (!strcmp(argv[i], "--image") && hasValue) {
+      imagePath = argv[++i];
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  if (SimFlash::configure(LABEL, partitionKB * 1024) != ESP_OK ||
+      FlashRing::init(LABEL) != ESP_OK || RecordStore::init() != ESP_OK) {
+    fprintf(stderr, "Cannot set up a %zu KB partition\n", partitionKB);
+    return 1;
+  }
+
+  ReplaySource source;
+  if (source.init(&replayConfig) != ESP_OK) {
+    fprintf(stderr, "Cannot open %s\n", replayConfig.path);
+    return 1;
+  }
+  DataPipeline::Config pipeConfig;
+  pipeConfig.compress = compress;
+  pipeConfig.adaptiveFlush = true;
+  if (DataPipeline::init(pipeConfig, &source) != ESP_OK) {
+    fprintf(stderr, "Pipeline init failed\n");
+    return 1;
+  }
+
+  int64_t start = esp_timer_get_time();
+  source.start();
+  while (!source.finished()) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  DataPipeline::flush();
+  FlashRing::waitIdle(pdMS_TO_TICKS(5000));
+  int64_t elapsed = esp_timer_get_time() - start;
+
+  DataPipeline::Stats ps;
+  DataPipeline::getStats(&ps);
+  FlashRing::Stats fs;
+  FlashRing::getStats(&fs);
+  RecordStore::Stats rs;
+  RecordStore::getStats(&rs);
+  SimFlash::Stats flash = SimFlash::getStats();
+  uint64_t fed = source.bytesFed();
+
+  printf("replayed   %llu bytes (%zu x %lu) in %.2f s, %.1f MB/s\n",
+         (unsigned long long)fed, source.fileSize(),
+         (unsigned long)replayConfig.repeat, elapsed / 1e6,
+         elapsed > 0 ? (double)fed / elapsed : 0.0);
+  printf("stored     %zu of %zu bytes, %lu wraps, records %lu..%lu\n",
+         fs.usedBytes, fs.partitionSize, (unsigned long)fs.wrapCount,
+         (unsigned long)rs.firstSeq, (unsigned long)rs.nextSeq);
+  printf("pipeline   %zu dropped, %lu writes, %lu flushes",
+         ps.bytesDropped, (unsigned long)ps.writeOperations,
+         (unsigned long)ps.flushOperations);
+  if (compress && ps.compressInBytes > 0) {
+    printf(", lz4 %.1f%%", 100.0 * ps.compressOutBytes / ps.compressInBytes);
+  }
+  printf("\n");
+  printf("flash      %llu B programmed, %u erases (max %u per sector), "
+         "%u bit violations\n",
+         (unsigned long long)flash.bytesProgrammed, flash.sectorErases,
+         flash.maxSectorErases, flash.bitViolations);
+  printf("modelled   %.1f s of flash time, %.2f MB/s flash-bound\n",
+         flash.busyUs / 1e6, flash.busyUs ? (double)fed / flash.busyUs : 0.0);
+
+  DataPipeline::deinit();
+  source.deinit();
+  FlashRing::deinit();
+
+  if (imagePath && SimFlash::saveImage(imagePath) != ESP_OK) {
+    fprintf(stderr, "Cannot write %s\n", imagePath);
+    return 1;
+  }
+  return (ps.bytesDropped == 0 && flash.bitViolations == 0) ? 0 : 1;
+}
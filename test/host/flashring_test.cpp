@@ -0,0 +1,382 @@
+// FlashRing on the simulated partition: wrap-around, clean reboot,
+// power-loss recovery and memory-mapped reads. Also the MQTT offline
+// queue on its own partition.
+
+#include "FlashRing.h"
+#include "HostTest.h"
+#include "OfflineQueue.h"
+#include "SimFlash.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+int g_failures = 0;
+
+static const char *LABEL = "datalog";
+
+// Same size as the datalog partition in partitions.csv
+static const size_t PARTITION_SIZE = 64 * 1024;
+
+// Content of the byte at a logical position, so any byte can be checked
+static uint8_t patternByte(uint64_t position) {
+  return (uint8_t)(position * 131 + (position >> 11));
+}
+
+// Append @p len pattern bytes at the head, in writes of varying size
+static void writePattern(size_t len) {
+  std::vector<uint8_t> buf(3000);
+  size_t done = 0;
+  size_t step = 0;
+  while (done < len) {
+    size_t n = std::min(len - done, (size_t)(700 + (step++ * 977) % 2300));
+    uint64_t head = FlashRing::getLogicalHead();
+    for (size_t i = 0; i < n; i++) {
+      buf[i] = patternByte(head + i);
+    }
+    if (FlashRing::write(buf.data(), n) != ESP_OK) {
+      return;
+    }
+    done += n;
+  }
+}
+
+// Every stored byte must hold the pattern of its logical position
+static bool verifyStored() {
+  uint64_t tail = FlashRing::getLogicalTail();
+  uint64_t head = FlashRing::getLogicalHead();
+  std::vector<uint8_t> buf(FlashRing::PAGE_SIZE);
+  for (uint64_t pos = tail; pos < head;) {
+    size_t n = 0;
+    if (FlashRing::readLogical(pos, buf.data(), buf.size(), &n) != ESP_OK ||
+        n == 0) {
+      fprintf(stderr, "read failed at %llu\n", (unsigned long long)pos);
+      return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+      if (buf[i] != patternByte(pos + i)) {
+        fprintf(stderr, "mismatch at %llu (tail %llu, head %llu)\n",
+                (unsigned long long)(pos + i), (unsigned long long)tail,
+                (unsigned long long)head);
+        return false;
+      }
+    }
+    pos += n;
+  }
+  return true;
+}
+
+// The pre-erase job drops the oldest page when it extends its window, so
+// head and tail only stay put once the window is full
+static void settleEraseWindow() {
+  FlashRing::Stats stats;
+  for (int i = 0; i < 1000; i++) {
+    CHECK_OK(FlashRing::getStats(&stats));
+    if (stats.erasedAhead >= stats.lookAheadPages) {
+      return;
+    }
+    vTaskDelay(1);
+  }
+  CHECK(stats.erasedAhead >= stats.lookAheadPages);
+}
+
+static void freshRing() {
+  CHECK_OK(SimFlash::configure(LABEL, PARTITION_SIZE));
+  CHECK_OK(FlashRing::init(LABEL));
+}
+
+static void testWrapAround() {
+  freshRing();
+  FlashRing::Stats stats;
+  CHECK_OK(FlashRing::getStats(&stats));
+  size_t ringSize = stats.partitionSize;
+  CHECK(ringSize == PARTITION_SIZE - FlashRing::JOURNAL_SECTORS * FlashRing::PAGE_SIZE);
+
+  size_t total = 5 * ringSize + 1234;
+  writePattern(total);
+  CHECK_OK(FlashRing::getStats(&stats));
+  CHECK(FlashRing::getLogicalHead() == total);
+  CHECK(stats.wrapCount == total / ringSize);
+  CHECK(stats.usedBytes < ringSize);
+  CHECK(stats.usedBytes >= ringSize / 2);
+  CHECK(verifyStored());
+
+  // The first lap is gone
+  uint8_t byte;
+  size_t n;
+  CHECK(FlashRing::readLogical(0, &byte, 1, &n) == ESP_ERR_NOT_FOUND);
+
+  SimFlash::Stats flash = SimFlash::getStats();
+  CHECK(flash.bitViolations == 0);
+  printf("  %zu bytes, %zu used, %lu wraps, %u erases, max %u per sector\n", total, stats.usedBytes,
+         (unsigned long)stats.wrapCount, flash.sectorErases,
+         flash.maxSectorErases);
+  FlashRing::deinit();
+}
+
+static void testReboot() {
+  freshRing();
+  writePattern(3 * PARTITION_SIZE + 777);
+  settleEraseWindow();
+  CHECK_OK(FlashRing::flushMetadata());
+  uint64_t head = FlashRing::getLogicalHead();
+  uint64_t tail = FlashRing::getLogicalTail();
+  FlashRing::deinit();
+
+  CHECK_OK(FlashRing::init(LABEL));
+  CHECK(FlashRing::getLogicalHead() == head);
+  CHECK(FlashRing::getLogicalTail() == tail);
+  CHECK(verifyStored());
+
+  // Data written without a journal entry is found in the head page
+  writePattern(1500);
+  head = FlashRing::getLogicalHead();
+  SimFlash::cutPowerAfter(1);
+  FlashRing::deinit(); // Its final journal entry is lost
+  SimFlash::powerOn();
+  CHECK_OK(FlashRing::init(LABEL));
+  CHECK(FlashRing::getLogicalHead() <= head);
+  CHECK(FlashRing::getLogicalHead() + 1 >= head); // A trailing 0xFF may be lost
+  CHECK(verifyStored());
+  FlashRing::deinit();
+}
+
+// Cut the power at a given operation while writing, reboot and check that
+// the recovered ring holds only intact data and keeps working
+static void powerLossAt(uint32_t cut, size_t preload) {
+  freshRing();
+  writePattern(preload);
+  CHECK_OK(FlashRing::flushMetadata());
+  uint64_t durableHead = FlashRing::getLogicalHead();
+
+  SimFlash::cutPowerAfter(cut);
+  uint64_t submitted = durableHead;
+  for (int i = 0; i < 100 && !SimFlash::poweredOff(); i++) {
+    writePattern(1500);
+    if (i % 7 == 3) {
+      FlashRing::flushMetadata();
+    }
+    submitted = FlashRing::getLogicalHead();
+  }
+  CHECK(SimFlash::poweredOff());
+  FlashRing::deinit();
+
+  SimFlash::powerOn();
+  CHECK_OK(FlashRing::init(LABEL));
+  uint64_t head = FlashRing::getLogicalHead();
+  bool ok = head >= durableHead && head <= submitted && verifyStored();
+  if (!ok) {
+    fprintf(stderr, "  cut %u, preload %zu: head %llu, durable %llu, submitted %llu\n",
+            cut, preload, (unsigned long long)head,
+            (unsigned long long)durableHead, (unsigned long long)submitted);
+  }
+  CHECK(ok);
+
+  // The recovered ring accepts new data, and survives another reboot
+  writePattern(20000);
+  CHECK(verifyStored());
+  CHECK_OK(FlashRing::flushMetadata());
+  head = FlashRing::getLogicalHead();
+  FlashRing::deinit();
+  CHECK_OK(FlashRing::init(LABEL));
+  CHECK(FlashRing::getLogicalHead() == head);
+  CHECK(verifyStored());
+  FlashRing::deinit();
+}
+
+static void testPowerLoss() {
+  static const uint32_t CUTS[] = {1, 2, 3, 4, 5, 7, 9, 12, 16, 21, 28, 37, 50, 66};
+  for (uint32_t cut : CUTS) {
+    powerLossAt(cut, 20000);                  // First lap
+    powerLossAt(cut, 2 * PARTITION_SIZE + 5); // Ring full, pages are reused
+  }
+}
+
+static void testMappedRead() {
+  freshRing();
+  writePattern(3 * PARTITION_SIZE + 777);
+  SimFlash::resetStats();
+
+  uint64_t tail = FlashRing::getLogicalTail();
+  uint64_t head = FlashRing::getLogicalHead();
+  bool sawSplit = false;
+  bool ok = true;
+  for (uint64_t pos = tail; pos < head && ok;) {
+    FlashRing::Span spans[2];
+    size_t count = 0;
+    CHECK_OK(FlashRing::mapLogical(pos, 10000, spans, &count));
+    ok = count > 0;
+    sawSplit |= count == 2;
+    for (size_t k = 0; k < count && ok; k++) {
+      for (size_t i = 0; i < spans[k].len; i++) {
+        if (spans[k].data[i] != patternByte(pos + i)) {
+          fprintf(stderr, "mapped mismatch at %llu\n",
+                  (unsigned long long)(pos + i));
+          ok = false;
+          break;
+        }
+      }
+      pos += spans[k].len;
+    }
+    FlashRing::unmapSpans(spans, count);
+  }
+  CHECK(ok);
+  CHECK(sawSplit); // The stored data wraps around the partition end
+
+  // Sequential reads reuse the mapping, and nothing is copied
+  SimFlash::Stats flash = SimFlash::getStats();
+  CHECK(flash.mmapCalls == 1);
+  CHECK(flash.bytesRead == 0);
+
+  FlashRing::Span spans[2];
+  size_t count = 1;
+  CHECK(FlashRing::mapLogical(head, 16, spans, &count) == ESP_OK && count == 0);
+  CHECK(FlashRing::mapLogical(0, 16, spans, &count) == ESP_ERR_NOT_FOUND);
+  FlashRing::deinit();
+}
+
+// Same size as the mqttq partition in partitions.csv
+static const char *QUEUE_LABEL = "mqttq";
+static const size_t QUEUE_SIZE = 32 * 1024;
+
+static esp_err_t queueMessage(uint32_t n, size_t len) {
+  char msg[OfflineQueue::MAX_MESSAGE];
+  int head = snprintf(msg, sizeof(msg), "{\"n\":%lu}", (unsigned long)n);
+  for (size_t i = head; i < len; i++) {
+    msg[i] = ' ';
+  }
+  return OfflineQueue::append(n % 3 == 0 ? "dl/resp" : nullptr, msg,
+                              len > (size_t)head ? len : head);
+}
+
+// Pending messages must be n = first, first + 1, ... in order
+static bool verifyQueue(uint32_t first, uint32_t count) {
+  static OfflineQueue::Message msg;
+  OfflineQueue::rewind();
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t n = first + i;
+    char expect[32];
+    int len = snprintf(expect, sizeof(expect), "{\"n\":%lu}", (unsigned long)n);
+    if (OfflineQueue::next(&msg) != ESP_OK || msg.length < len ||
+        memcmp(msg.data, expect, len) != 0 ||
+        strcmp(msg.topic, n % 3 == 0 ? "dl/resp" : "") != 0) {
+      fprintf(stderr, "queue mismatch at n=%lu\n", (unsigned long)n);
+      return false;
+    }
+  }
+  return OfflineQueue::next(&msg) == ESP_ERR_NOT_FOUND;
+}
+
+static void testOfflineQueue() {
+  CHECK_OK(SimFlash::configure(QUEUE_LABEL, QUEUE_SIZE));
+  CHECK_OK(OfflineQueue::init(QUEUE_LABEL));
+  OfflineQueue::Stats stats;
+
+  // Sequence numbers start at 1 and follow the messages
+  for (uint32_t n = 1; n <= 5; n++) {
+    CHECK_OK(queueMessage(n, 40));
+  }
+  CHECK(verifyQueue(1, 5));
+  CHECK(verifyQueue(1, 5)); // next() only peeks
+  static OfflineQueue::Message msg;
+  OfflineQueue::rewind();
+  CHECK(OfflineQueue::next(&msg) == ESP_OK && msg.seq == 1);
+
+  // Delivery survives a reboot
+  CHECK_OK(OfflineQueue::markDelivered(2));
+  CHECK(OfflineQueue::pending() == 3);
+  OfflineQueue::deinit();
+  CHECK_OK(OfflineQueue::init(QUEUE_LABEL));
+  CHECK(OfflineQueue::pending() == 3);
+  CHECK(verifyQueue(3, 3));
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  CHECK(stats.nextSeq == 6);
+
+  // Offline for longer than the partition holds: the oldest are dropped
+  uint32_t n = 6;
+  for (; n < 200; n++) {
+    CHECK_OK(queueMessage(n, 300));
+  }
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  CHECK(stats.dropped > 0);
+  CHECK(stats.pending + stats.dropped == 197);
+  CHECK(stats.pendingBytes < QUEUE_SIZE);
+  uint32_t first = 200 - stats.pending;
+  CHECK(verifyQueue(first, stats.pending));
+  OfflineQueue::rewind();
+  CHECK(OfflineQueue::next(&msg) == ESP_OK && msg.seq == first);
+
+  // A torn append is discarded at reboot and the queue goes on after it
+  uint32_t pending = stats.pending;
+  OfflineQueue::deinit();
+  CHECK_OK(OfflineQueue::init(QUEUE_LABEL));
+  SimFlash::cutPowerAfter(1);
+  queueMessage(n, 300);
+  OfflineQueue::deinit();
+  SimFlash::powerOn();
+  CHECK_OK(OfflineQueue::init(QUEUE_LABEL));
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  CHECK(stats.pending == pending);
+  CHECK(verifyQueue(200 - pending, pending));
+  // It sealed its sector: this append opens the next one
+  CHECK_OK(queueMessage(n, 300));
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  CHECK(verifyQueue(n + 1 - stats.pending, stats.pending));
+
+  // An entry corrupted after it was stored is dropped, not replayed
+  n++;
+  CHECK_OK(queueMessage(n, 40));
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  pending = stats.pending;
+  uint32_t dropped = stats.dropped;
+  const char *image = "offline_queue.img";
+  char expect[32];
+  snprintf(expect, sizeof(expect), "{\"n\":%lu}", (unsigned long)n);
+  CHECK_OK(SimFlash::saveImage(image));
+  std::vector<uint8_t> raw(SimFlash::data(), SimFlash::data() + SimFlash::size());
+  auto it = std::search(raw.begin(), raw.end(), expect, expect + strlen(expect));
+  CHECK(it != raw.end());
+  if (it != raw.end()) {
+    *it = 0; // Clearing bits is what a bad program would do
+    FILE *f = fopen(image, "wb");
+    CHECK(f != nullptr && fwrite(raw.data(), 1, raw.size(), f) == raw.size());
+    if (f) {
+      fclose(f);
+    }
+    CHECK_OK(SimFlash::loadImage(image));
+  }
+  remove(image);
+  CHECK(verifyQueue(n - pending + 1, pending - 1));
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  CHECK(stats.pending == pending - 1 && stats.dropped == dropped + 1);
+  // Its sector is closed: the next append goes to a fresh one
+  n++;
+  CHECK_OK(queueMessage(n, 40));
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  OfflineQueue::rewind();
+  for (uint32_t i = 0; i < stats.pending; i++) {
+    CHECK(OfflineQueue::next(&msg) == ESP_OK);
+  }
+  CHECK(msg.seq == stats.nextSeq - 1);
+  CHECK(OfflineQueue::next(&msg) == ESP_ERR_NOT_FOUND);
+
+  // Everything delivered: nothing pending after a reboot
+  CHECK_OK(OfflineQueue::markDelivered(UINT32_MAX));
+  CHECK(OfflineQueue::pending() == 0);
+  OfflineQueue::deinit();
+  CHECK_OK(OfflineQueue::init(QUEUE_LABEL));
+  CHECK(OfflineQueue::pending() == 0);
+  CHECK_OK(OfflineQueue::getStats(&stats));
+  CHECK(stats.nextSeq == n + 1);
+  CHECK(SimFlash::getStats().bitViolations == 0);
+  OfflineQueue::deinit();
+}
+
+int main() {
+  RUN_TEST(testWrapAround);
+  RUN_TEST(testReboot);
+  RUN_TEST(testPowerLoss);
+  RUN_TEST(testMappedRead);
+  RUN_TEST(testOfflineQueue);
+  printf("%s (%d failures)\n", g_failures ? "FAILED" : "PASSED", g_failures);
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// JsonTokenizer on well-formed and malformed documents: what MQTT
+// commands are parsed with, so a bad payload must be rejected rather than
+// read as some other field.
+
+#include "HostTest.h"
+#include "JsonTokenizer.h"
+#include <cstring>
+
+int g_failures = 0;
+
+static const size_t MAX_TOKENS = 32;
+
+static esp_err_t parse(JsonTokenizer &json, const char *doc) {
+  return json.parse(doc, strlen(doc));
+}
+
+static void testWellFormed() {
+  JsonTokenizer::Token tokens[MAX_TOKENS];
+  JsonTokenizer json(tokens, MAX_TOKENS);
+
+  const char *doc = " {\"command\":\"read\", \"args\":{\"n\":-1.5e3,"
+                    "\"list\":[1,true,null,\"x\"]},\"last\":false}\r\n";
+  CHECK_OK(parse(json, doc));
+  CHECK(json.token(0).type == JsonTokenizer::Type::OBJECT);
+  CHECK(json.token(0).size == 3);
+  CHECK(json.equals(json.find(0, "command"), "read"));
+  int args = json.find(0, "args");
+  CHECK(args >= 0 && json.token(args).type == JsonTokenizer::Type::OBJECT);
+  int list = json.find(args, "list");
+  CHECK(list >= 0 && json.token(list).size == 4);
+  int last = json.find(0, "last");
+  CHECK(last >= 0 && json.token(last).type == JsonTokenizer::Type::PRIMITIVE);
+  CHECK(json.find(0, "n") == -1); // Only direct members
+
+  // Scalars and empty containers at the top level
+  const char *good[] = {"0",  "-0.25", "1E+2",    "\"s\"",     "true",
+                        "{}", "[]",    "[[],{}]", "{\"a\":{}}"};
+  for (const char *doc : good) {
+    if (parse(json, doc) != ESP_OK) {
+      fprintf(stderr, "rejected: %s\n", doc);
+      g_failures++;
+    }
+  }
+
+  // Escapes are checked by parse() and decoded by copyString()
+  CHECK_OK(parse(json, "{\"t\":\"a\\\"b\\\\c\\n\\u00e9\"}"));
+  char out[16];
+  CHECK_OK(json.copyString(json.find(0, "t"), out, sizeof(out)));
+  CHECK(strcmp(out, "a\"b\\c\n\xc3\xa9") == 0);
+  CHECK(json.copyString(json.find(0, "t"), out, 4) == ESP_ERR_INVALID_SIZE);
+}
+
+static void testMalformed() {
+  JsonTokenizer::Token tokens[MAX_TOKENS];
+  JsonTokenizer json(tokens, MAX_TOKENS);
+
+  // A missing value must not shift the next key into its place
+  CHECK(parse(json, "{\"a\":,\"b\":1}") == ESP_ERR_INVALID_ARG);
+  CHECK(json.count() == 0);
+  CHECK(json.find(0, "a") == -1);
+
+  const char *bad[] = {
+      // Empty document
+      "", "  ",
+      // Missing ':' or value
+      "{\"a\":}", "{\"a\"}", "{\"a\" 1}", "{\"a\"::1}",
+      // Missing, extra or misplaced commas
+      "{\"a\":1 \"b\":2}", "[1 2]", "{,\"a\":1}", "{\"a\":1,}", "[1,]",
+      "[,1]",
+      // Keys that are not strings, members in arrays
+      "{1:2}", "{\"a\":1:2}", "[\"a\":1]",
+      // Literals and numbers
+      "{\"a\":tru}", "{\"a\":nul}", "{\"a\":truex}", "{\"a\":01}",
+      "{\"a\":1.}", "{\"a\":.5}", "{\"a\":-}", "{\"a\":1e}", "{\"a\":+1}",
+      "{\"a\":0x10}",
+      // Strings
+      "{\"a\":\"x}", "{\"a\":\"\\q\"}", "{\"a\":\"\\u12g4\"}",
+      // Unclosed or mismatched containers
+      "{\"a\":1", "[1,2", "{\"a\":1]", "[1}", "}",
+      // More than one document
+      "{} {}", "1 2", "{}x",
+  };
+  for (const char *doc : bad) {
+    if (parse(json, doc) != ESP_ERR_INVALID_ARG) {
+      fprintf(stderr, "accepted: %s\n", doc);
+      g_failures++;
+    }
+  }
+
+  // Too many tokens is not a syntax error
+  JsonTokenizer small(tokens, 2);
+  CHECK(parse(small, "[1,2,3]") == ESP_ERR_NO_MEM);
+}
+
+int main() {
+  RUN_TEST(testWellFormed);
+  RUN_TEST(testMalformed);
+  printf("%s (%d failures)\n", g_failures ? "FAILED" : "PASSED", g_failures);
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,572 @@
+// DataPipeline end to end on the simulated partition: PatternGenerator ->
+// StagingRing -> writer -> RecordStore/FlashRing, raw and LZ4. Checks that
+// the stored records hold the generated stream and reports throughput.
+// Also runs the filter stages on their own and behind the writer, two
+// merged sources, the protocol decoders on the chunk tap, and the deferred
+// log used on the capture path. The memory plan is reserved first, as on a capturing device.
+
+#include "DataPipeline.h"
+#include "FlashRing.h"
+#include "HostTest.h"
+#include "protocol/EscPosDecoder.h"
+#include "protocol/ModbusRtuDecoder.h"
+#include "PatternGenerator.h"
+#include "PipelineStages.h"
+#include "RecordStore.h"
+#include "SimFlash.h"
+#include "StagingRing.h"
+#include "esp_timer.h"
+#include "utils/DeferredLog.h"
+#include "utils/MemoryPlan.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+int g_failures = 0;
+
+static const char *LABEL = "datalog";
+static const size_t PARTITION_SIZE = 1024 * 1024;
+
+// Walk every stored record and check the counter pattern runs on without
+// a gap (but for @p stripped, if not -1); returns the payload bytes seen
+static uint64_t verifyRecords(int stripped = -1) {
+  RecordStore::Stats rs;
+  CHECK_OK(RecordStore::getStats(&rs));
+  RecordStore::RecordInfo info;
+  if (RecordStore::findBySeq(rs.firstSeq, &info) != ESP_OK) {
+    return 0;
+  }
+
+  std::vector<uint8_t> block(RecordStore::BLOCK_RAW_SIZE);
+  uint64_t total = 0;
+  bool first = true;
+  uint8_t expected = 0;
+  uint32_t records = 0;
+  do {
+    size_t offset = 0;
+    size_t rawLen = 0;
+    while (true) {
+      esp_err_t ret = RecordStore::readBlock(info, &offset, block.data(),
+                                             block.size(), &rawLen);
+      if (ret != ESP_OK) {
+        fprintf(stderr, "record %u: readBlock %s\n", info.seq,
+                esp_err_to_name(ret));
+        g_failures++;
+        return total;
+      }
+      if (rawLen == 0) {
+        break;
+      }
+      for (size_t i = 0; i < rawLen; i++) {
+        if (!first && block[i] != expected) {
+          fprintf(stderr, "record %u: byte %llu is %u, expected %u\n", info.seq,
+                  (unsigned long long)total + i, block[i], expected);
+          g_failures++;
+          return total;
+        }
+        first = false;
+        expected = block[i] + 1;
+        if (expected == stripped) {
+          expected++;
+        }
+      }
+      total += rawLen;
+    }
+    records++;
+  } while (RecordStore::next(info, &info) == ESP_OK);
+
+  printf("  %u records, %llu payload bytes verified\n", records,
+         (unsigned long long)total);
+  return total;
+}
+
+// Generate @p bytes unthrottled in bursts and push them through the pipeline
+static void runPipeline(bool compress, size_t bytes,
+                        IPipelineStage *stage = nullptr, int stripped = -1) {
+  CHECK_OK(FlashRing::erase());
+  RecordStore::reset();
+  SimFlash::resetStats();
+
+  PatternGenerator generator;
+  PatternGenerator::Config genConfig;
+  genConfig.rateBps = 0;
+  genConfig.burstBytes = 64 * 1024;
+  CHECK_OK(generator.init(&genConfig));
+
+  DataPipeline::Config pipeConfig;
+  pipeConfig.compress = compress;
+  pipeConfig.adaptiveFlush = true;
+  CHECK_OK(DataPipeline::init(pipeConfig, &generator));
+  if (stage) {
+    CHECK_OK(DataPipeline::addStage(stage));
+  }
+
+  int64_t start = esp_timer_get_time();
+  generator.start();
+  while (generator.bytesGenerated() < bytes) {
+    vTaskDelay(1);
+  }
+  generator.stop();
+
+  // flush() only signals the writer: let it drain the ring first, then
+  // wait for a flush that covers everything before stopping it
+  while (generator.getRing()->available() > 0) {
+    vTaskDelay(1);
+  }
+  DataPipeline::Stats before;
+  DataPipeline::getStats(&before);
+  DataPipeline::flush();
+  DataPipeline::Stats now;
+  do {
+    vTaskDelay(1);
+    DataPipeline::getStats(&now);
+  } while (now.flushOperations == before.flushOperations);
+  CHECK_OK(FlashRing::waitIdle(pdMS_TO_TICKS(5000)));
+  int64_t elapsed = esp_timer_get_time() - start;
+
+  DataPipeline::Stats ps;
+  DataPipeline::getStats(&ps);
+  uint64_t generated = generator.bytesGenerated();
+  CHECK(generator.bytesDropped() == 0);
+  CHECK(ps.bytesDropped == 0);
+  DataPipeline::deinit();
+  generator.deinit();
+
+  uint64_t stored = verifyRecords(stripped);
+  if (stage) {
+    CHECK(ps.stageInBytes == generated);
+    CHECK(ps.stageOutBytes == stored);
+    CHECK(stored < generated);
+  } else {
+    CHECK(stored == generated);
+  }
+
+  SimFlash::Stats flash = SimFlash::getStats();
+  CHECK(flash.bitViolations == 0);
+  printf("  %s: %llu bytes, %.1f MB/s host, %.2f MB/s modelled flash "
+         "(%llu B programmed, %u erases)\n",
+         compress ? "lz4" : "raw", (unsigned long long)generated,
+         elapsed > 0 ? (double)generated / elapsed : 0.0,
+         flash.busyUs ? (double)generated / flash.busyUs : 0.0,
+         (unsigned long long)flash.bytesProgrammed, flash.sectorErases);
+}
+
+static void testRaw() { runPipeline(false, 600 * 1024); }
+
+static void testCompressed() { runPipeline(true, 600 * 1024); }
+
+// Both runs above took the writer stack and page buffers from the plan,
+// the second one reusing them after the first writer exited
+static void testMemoryPlan() {
+  static MemoryPlan::Stats stats;
+  CHECK_OK(MemoryPlan::getStats(&stats));
+  using MemoryPlan::Region;
+  for (Region region : {Region::PIPELINE_PAGES, Region::TASK_FLASH_WRITER,
+                        Region::TASK_FLASH_PROGRAM, Region::RECORD_INDEX}) {
+    const MemoryPlan::RegionStats &r = stats.region[(size_t)region];
+    CHECK(r.reserved);
+    CHECK(r.spills == 0);
+    CHECK(r.peak > 0 && r.peak <= r.budget);
+  }
+  // Released by deinit, ready for the next owner
+  CHECK(stats.region[(size_t)Region::PIPELINE_PAGES].used == 0);
+}
+
+// Feed @p in to @p stage in pieces of @p piece bytes, ending one frame
+static std::vector<uint8_t> runStage(IPipelineStage &stage, const char *in,
+                                     size_t piece) {
+  std::vector<uint8_t> out;
+  uint8_t buf[64 + IPipelineStage::MAX_HELD];
+  size_t len = strlen(in);
+  for (size_t i = 0; i < len; i += piece) {
+    size_t n = std::min(piece, len - i);
+    size_t produced = stage.process((const uint8_t *)in + i, n, buf);
+    out.insert(out.end(), buf, buf + produced);
+  }
+  size_t produced = stage.endFrame(buf);
+  out.insert(out.end(), buf, buf + produced);
+  return out;
+}
+
+static bool sameAs(const std::vector<uint8_t> &out, const char *expected) {
+  return out.size() == strlen(expected) &&
+         memcmp(out.data(), expected, out.size()) == 0;
+}
+
+static void testStages() {
+  // Results must not depend on how the stream is split
+  for (size_t piece : {1, 3, 64}) {
+    RunDropStage runs;
+    CHECK_OK(runs.init(4));
+    CHECK(sameAs(runStage(runs, "ab------cdd", piece), "abcdd"));
+    CHECK(sameAs(runStage(runs, "xxxyyyyyyyz", piece), "xxxz"));
+    CHECK(sameAs(runStage(runs, "qqq", piece), "qqq"));
+
+    DedupeStage dedupe;
+    CHECK_OK(dedupe.init(16));
+    CHECK(sameAs(runStage(dedupe, "STATUS OK", piece), "STATUS OK"));
+    CHECK(sameAs(runStage(dedupe, "STATUS OK", piece), ""));
+    CHECK(sameAs(runStage(dedupe, "STATUS OK!", piece), "STATUS OK!"));
+    CHECK(sameAs(runStage(dedupe, "STATUS", piece), "STATUS"));
+    CHECK(sameAs(runStage(dedupe, "STATUS", piece), ""));
+    CHECK(sameAs(runStage(dedupe, "A much longer frame here", piece),
+                 "A much longer frame here"));
+    CHECK(sameAs(runStage(dedupe, "A much longer frame here", piece),
+                 "A much longer frame here"));
+    CHECK(dedupe.framesDropped() == 2);
+  }
+
+  // Behind the writer: every 0x00 of the counter pattern is stripped
+  StripStage strip;
+  const uint8_t fill = 0x00;
+  CHECK_OK(strip.init(&fill, 1));
+  runPipeline(false, 600 * 1024, &strip, fill);
+}
+
+// Source fed by the test itself, each chunk with a given capture time
+class ManualSource : public IDataSource {
+public:
+  esp_err_t init(const void *config) override {
+    (void)config;
+    return m_ring.init(16 * 1024);
+  }
+  StagingRing *getRing() override { return &m_ring; }
+  void setBurstCallback(Transport::BurstCallback callback) override {
+    m_burstCallback = callback;
+  }
+  void setChunkCallback(Transport::ChunkCallback callback) override {
+    m_chunkCallback = callback;
+  }
+  esp_err_t getStats(Transport::Stats *stats) override {
+    *stats = {};
+    return ESP_OK;
+  }
+  void resetStats() override {}
+  esp_err_t deinit() override {
+    m_ring.deinit();
+    return ESP_OK;
+  }
+  Transport::Type getType() const override {
+    return Transport::Type::SYNTHETIC;
+  }
+
+  // One burst of @p len bytes of @p value, captured at @p timeUs
+  void feed(uint8_t value, size_t len, int64_t timeUs) {
+    std::vector<uint8_t> data(len, value);
+    if (m_chunkCallback) {
+      m_chunkCallback(m_streamOffset + len - 1, timeUs);
+    }
+    m_ring.push(data.data(), len);
+    m_streamOffset += len;
+    if (m_burstCallback) {
+      m_burstCallback(true, len);
+    }
+  }
+
+private:
+  StagingRing m_ring;
+  Transport::BurstCallback m_burstCallback = nullptr;
+  Transport::ChunkCallback m_chunkCallback = nullptr;
+  uint32_t m_streamOffset = 0;
+};
+
+// Two merged sources: data is written oldest capture time first, and an
+// item is held for mergeSkewMs while the other source has nothing pending
+static void testMergedSources() {
+  CHECK_OK(FlashRing::erase());
+  RecordStore::reset();
+
+  ManualSource first;
+  ManualSource second;
+  CHECK_OK(first.init(nullptr));
+  CHECK_OK(second.init(nullptr));
+  DataPipeline::Config pipeConfig;
+  pipeConfig.mergeSkewMs = 200;
+  CHECK_OK(DataPipeline::init(pipeConfig, &first));
+  uint8_t channel = 0;
+  CHECK_OK(DataPipeline::addSource(&second, &channel));
+  CHECK(channel == 1);
+
+  // The second line's data arrives later but was captured earlier
+  int64_t now = esp_timer_get_time();
+  first.feed('a', 300, now);
+  second.feed('b', 200, now - 10000);
+  // Then one alone, already older than the skew window
+  vTaskDelay(pdMS_TO_TICKS(300));
+  first.feed('c', 100, esp_timer_get_time() - 250000);
+
+  while (first.getRing()->available() > 0 ||
+         second.getRing()->available() > 0) {
+    vTaskDelay(1);
+  }
+  DataPipeline::Stats before;
+  DataPipeline::getStats(&before);
+  DataPipeline::flush();
+  DataPipeline::Stats after;
+  do {
+    vTaskDelay(1);
+    DataPipeline::getStats(&after);
+  } while (after.flushOperations == before.flushOperations);
+  CHECK_OK(FlashRing::waitIdle(pdMS_TO_TICKS(5000)));
+  DataPipeline::deinit();
+  first.deinit();
+  second.deinit();
+
+  // Records in write order as "<channel><byte>" runs, e.g. "1b0a0c"
+  std::string order;
+  size_t bytes[2] = {};
+  RecordStore::Stats rs;
+  CHECK_OK(RecordStore::getStats(&rs));
+  RecordStore::RecordInfo info;
+  std::vector<uint8_t> block(RecordStore::BLOCK_RAW_SIZE);
+  bool found = RecordStore::findBySeq(rs.firstSeq, &info) == ESP_OK;
+  while (found) {
+    std::vector<uint8_t> data;
+    size_t offset = 0;
+    size_t rawLen = 0;
+    while (RecordStore::readBlock(info, &offset, block.data(), block.size(),
+                                  &rawLen) == ESP_OK &&
+           rawLen > 0) {
+      data.insert(data.end(), block.begin(), block.begin() + rawLen);
+    }
+    data.resize(std::min<size_t>(data.size(), info.dataLength));
+    for (uint8_t b : data) {
+      char run[3] = {(char)('0' + info.channel), (char)b, '\0'};
+      if (order.size() < 2 || order.compare(order.size() - 2, 2, run) != 0) {
+        order += run;
+      }
+    }
+    if (info.channel < 2) {
+      bytes[info.channel] += data.size();
+    }
+    found = RecordStore::next(info, &info) == ESP_OK;
+  }
+  printf("  merged order %s\n", order.c_str());
+  CHECK(order == "1b0a0c");
+  CHECK(bytes[0] == 400 && bytes[1] == 200);
+}
+
+// Chunk tap state: the counter pattern must arrive whole and in order
+static uint64_t s_tapBytes = 0;
+static uint32_t s_tapChunks = 0;
+static uint32_t s_tapBursts = 0;
+static bool s_tapBroken = false;
+static uint8_t s_tapNext = 0;
+
+static void onChunk(uint8_t channel, const uint8_t *data, size_t len,
+                    int64_t chunkEndUs) {
+  if (channel != 0) {
+    s_tapBroken = true;
+  }
+  if (len == 0) {
+    s_tapBursts++;
+    return;
+  }
+  for (size_t i = 0; i < len; i++) {
+    if (s_tapBytes + i > 0 && data[i] != s_tapNext) {
+      s_tapBroken = true;
+    }
+    s_tapNext = data[i] + 1;
+  }
+  s_tapBytes += len;
+  s_tapChunks += (chunkEndUs != 0);
+}
+
+static void testChunkTap() {
+  DataPipeline::setChunkTapCallback(onChunk);
+  runPipeline(false, 256 * 1024);
+  DataPipeline::setChunkTapCallback(nullptr);
+  CHECK(s_tapBytes >= 256 * 1024);
+  CHECK(s_tapChunks > 0);
+  CHECK(s_tapBursts > 0);
+  CHECK(!s_tapBroken);
+}
+
+static std::vector<DecodedFrame> s_frames;
+
+static void collectFrame(const DecodedFrame &frame, void *ctx) {
+  (void)ctx;
+  s_frames.push_back(frame);
+}
+
+// Append a Modbus frame with its CRC to @p out
+static void modbusFrame(std::vector<uint8_t> &out,
+                        std::initializer_list<uint8_t> bytes) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t b : bytes) {
+    out.push_back(b);
+    crc ^= b;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+  }
+  out.push_back(crc & 0xFF);
+  out.push_back(crc >> 8);
+}
+
+static void testModbus() {
+  // 9600 8E1: 1.1458 ms per character
+  ModbusRtuDecoder modbus;
+  CHECK_OK(modbus.init(9600, 11));
+  modbus.setOutput(collectFrame, nullptr, 1);
+  s_frames.clear();
+
+  // Read holding registers, split over two pieces of one chunk
+  std::vector<uint8_t> request;
+  modbusFrame(request, {0x11, 0x03, 0x00, 0x6B, 0x00, 0x03});
+  CHECK(request[6] == 0x76 && request[7] == 0x87);
+  int64_t t = 1000000;
+  modbus.feed(request.data(), 3, 0);
+  modbus.feed(request.data() + 3, 5, t);
+  CHECK(s_frames.size() == 1);
+  CHECK(s_frames[0].kind == FrameKind::MODBUS_REQUEST);
+  CHECK(s_frames[0].channel == 1);
+  CHECK(s_frames[0].address == 0x11 && s_frames[0].function == 3);
+  CHECK(s_frames[0].value == 0x6B);
+  CHECK(s_frames[0].timeUs == t);
+
+  // Noise, a silence, then the response: the noise cannot start it
+  const uint8_t noise[] = {0xFF, 0x11, 0x03};
+  t += 20000;
+  modbus.feed(noise, sizeof(noise), t);
+  std::vector<uint8_t> response;
+  modbusFrame(response, {0x11, 0x03, 0x06, 0xAE, 0x41, 0x56, 0x52, 0x43, 0x40});
+  t += 100000;
+  modbus.feed(response.data(), response.size(), t);
+  CHECK(s_frames.size() == 2);
+  CHECK(s_frames[1].kind == FrameKind::MODBUS_RESPONSE);
+  CHECK(s_frames[1].dataLen == 7 && s_frames[1].data[0] == 6);
+  CHECK(modbus.bytesDiscarded() == 3);
+
+  // Write single register and its echo in one chunk, then an exception
+  std::vector<uint8_t> burst;
+  modbusFrame(burst, {0x11, 0x06, 0x00, 0x01, 0x00, 0x03});
+  modbusFrame(burst, {0x11, 0x06, 0x00, 0x01, 0x00, 0x03});
+  modbusFrame(burst, {0x0A, 0x81, 0x02});
+  t += 100000;
+  modbus.feed(burst.data(), burst.size(), t);
+  CHECK(s_frames.size() == 5);
+  CHECK(s_frames[2].kind == FrameKind::MODBUS_REQUEST);
+  CHECK(s_frames[3].kind == FrameKind::MODBUS_RESPONSE);
+  CHECK(s_frames[4].kind == FrameKind::MODBUS_EXCEPTION);
+  CHECK(s_frames[4].value == 2);
+
+  // A corrupted frame is dropped at the burst end
+  std::vector<uint8_t> bad;
+  modbusFrame(bad, {0x11, 0x03, 0x00, 0x6B, 0x00, 0x03});
+  bad[3] ^= 0x01;
+  modbus.feed(bad.data(), bad.size() - 1, 0);
+  modbus.endBurst();
+  CHECK(s_frames.size() == 5);
+  CHECK(modbus.bytesDiscarded() == 3 + 7);
+  CHECK(modbus.framesDecoded() == 5);
+}
+
+static void testEscPos() {
+  // Text, a raster image holding LF and letters, a drawer kick and a cut
+  static const uint8_t receipt[] = {
+      0x1B, '@', 'H', 'E', 'L', 'L', 'O', '\n',
+      0x1D, 'v', '0', 0, 2, 0, 2, 0, '\n', 'A', 0x1B, 'B',
+      'T', 'O', 'T', 'A', 'L', ' ', '1', '0', '\r', '\n',
+      0x1D, 'k', 4, '1', '2', '3', 0,
+      '\n', 0x1B, 'p', 0, 25, 250,
+      0x1D, 'V', 66, 0};
+
+  for (size_t piece : {(size_t)1, (size_t)5, sizeof(receipt)}) {
+    EscPosDecoder escpos;
+    escpos.setOutput(collectFrame, nullptr, 0);
+    s_frames.clear();
+    for (size_t i = 0; i < sizeof(receipt); i += piece) {
+      size_t n = std::min(piece, sizeof(receipt) - i);
+      escpos.feed(receipt + i, n, 0);
+    }
+    CHECK(s_frames.size() == 4);
+    if (s_frames.size() != 4) {
+      continue;
+    }
+    CHECK(s_frames[0].kind == FrameKind::ESCPOS_LINE);
+    CHECK(s_frames[0].dataLen == 5 && memcmp(s_frames[0].data, "HELLO", 5) == 0);
+    CHECK(s_frames[1].kind == FrameKind::ESCPOS_LINE);
+    CHECK(s_frames[1].value == 8 &&
+          memcmp(s_frames[1].data, "TOTAL 10", 8) == 0);
+    CHECK(s_frames[2].kind == FrameKind::ESCPOS_DRAWER);
+    CHECK(s_frames[2].address == 0 && s_frames[2].value == 25);
+    CHECK(s_frames[3].kind == FrameKind::ESCPOS_CUT);
+    CHECK(s_frames[3].value == 2);
+  }
+}
+
+static uint32_t s_logLines = 0;
+static uint32_t s_logSuppressed = 0;
+static char s_logText[DeferredLog::LINE_SIZE];
+
+static void logSink(const DeferredLog::Line &line) {
+  if (strcmp(line.tag, "logtest") != 0) {
+    return;
+  }
+  s_logLines++;
+  s_logSuppressed += line.suppressed;
+  strncpy(s_logText, line.text, sizeof(s_logText) - 1);
+}
+
+static void logBurst(size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    DLOG_LEVEL(ESP_LOG_ERROR, 0, "logtest", "burst %u", (unsigned)i);
+  }
+}
+
+// Repeats fold into one record; a full ring drops instead of waiting
+static void testDeferredLog() {
+  DeferredLog::setSink(logSink, ESP_LOG_WARN);
+  DeferredLog::flush();
+  DeferredLog::Stats before;
+  CHECK_OK(DeferredLog::getStats(&before));
+
+  for (int i = 0; i < 100; i++) {
+    DLOG_LEVEL(ESP_LOG_WARN, 60000, "logtest", "overflow %d of %s", i, "ring");
+  }
+  DeferredLog::flush();
+  CHECK(s_logLines == 1);
+  CHECK(strcmp(s_logText, "overflow 0 of ring") == 0);
+
+  // No rate limit: the ring fills and the rest is dropped
+  logBurst(DeferredLog::RING_RECORDS + 10);
+  DeferredLog::flush();
+  DeferredLog::Stats after;
+  CHECK_OK(DeferredLog::getStats(&after));
+  CHECK(after.suppressed - before.suppressed == 99);
+  CHECK(after.dropped - before.dropped == 10);
+  CHECK(after.written - before.written == 1 + DeferredLog::RING_RECORDS);
+  CHECK(s_logLines == 1 + DeferredLog::RING_RECORDS);
+  CHECK(after.rendered == after.written);
+
+  // The next record of the site reports the dropped calls
+  s_logSuppressed = 0;
+  logBurst(1);
+  DeferredLog::flush();
+  CHECK(s_logSuppressed == 10);
+  DeferredLog::setSink(nullptr, ESP_LOG_NONE);
+}
+
+int main() {
+  CHECK_OK(MemoryPlan::init(true));
+  CHECK_OK(SimFlash::configure(LABEL, PARTITION_SIZE));
+  CHECK_OK(FlashRing::init(LABEL));
+  CHECK_OK(RecordStore::init());
+
+  RUN_TEST(testRaw);
+  RUN_TEST(testCompressed);
+  RUN_TEST(testMemoryPlan);
+  RUN_TEST(testStages);
+  RUN_TEST(testMergedSources);
+  RUN_TEST(testChunkTap);
+  RUN_TEST(testModbus);
+  RUN_TEST(testEscPos);
+  RUN_TEST(testDeferredLog);
+
+  FlashRing::deinit();
+  printf("%s (%d failures)\n", g_failures ? "FAILED" : "PASSED", g_failures);
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief SimFlash - Simulated NOR flash behind the esp_partition shim
+ *
+ * One data partition held in RAM with NOR semantics: erase sets a 4KB
+ * sector to 0xFF, programming can only clear bits. Reads, programs and
+ * erases are checked for range and (erase) alignment like the IDF API.
+ *
+ * Erase and program time is modelled per operation and accumulated in
+ * Stats::busyUs, so a run at native speed still reports the flash-bound
+ * throughput of the real chip. With a timeScale above 0 the model also
+ * sleeps for that fraction of the modelled time.
+ *
+ * Power loss: cutPowerAfter(n) tears the n-th following program or erase
+ * (only the first half of it lands) and turns every later one into a
+ * silent no-op, as if the chip had lost power. powerOn() restores the
+ * supply; the image keeps whatever had landed, ready for a "reboot"
+ * (module deinit + init on the same image).
+ */
+
+namespace SimFlash {
+
+/// Sector (erase unit) size
+constexpr size_t SECTOR_SIZE = 4096;
+
+/// Program page size (programs are timed per page touched)
+constexpr size_t PROGRAM_PAGE = 256;
+
+/// Timing model, defaults roughly match the ESP32 on-module SPI flash
+struct Timing {
+    uint32_t eraseSectorUs = 45000;  ///< One 4KB sector erase
+    uint32_t programPageUs = 700;    ///< One 256-byte page program
+    uint32_t callOverheadUs = 15;    ///< Fixed cost of each API call
+    float timeScale = 0.0f;          ///< Sleep this fraction of the model (0 = native speed)
+};
+
+/// Accumulated activity since configure() or resetStats()
+struct Stats {
+    uint64_t bytesRead;
+    uint64_t bytesProgrammed;
+    uint32_t programCalls;
+    uint32_t sectorErases;
+    uint64_t busyUs;            ///< Modelled erase + program time
+    uint32_t maxSectorErases;   ///< Highest erase count of any sector (wear)
+    uint32_t bitViolations;     ///< Programs that tried to set a 0 bit back to 1
+    uint32_t mmapCalls;         ///< esp_partition_mmap() calls
+};
+
+/**
+ * @brief Create the partition image (fully erased)
+ * @param label Partition label matched by esp_partition_find_first()
+ * @param size  Size in bytes (multiple of SECTOR_SIZE)
+ */
+esp_err_t configure(const char* label, size_t size, const Timing& timing = Timing());
+
+/**
+ * @brief Change the timing model
+ */
+void setTiming(const Timing& timing);
+
+/**
+ * @brief Lose power during the @p operations-th program/erase from now
+ */
+void cutPowerAfter(uint32_t operations);
+
+/**
+ * @brief Whether the simulated supply is off
+ */
+bool poweredOff();
+
+/**
+ * @brief Restore the supply (the image is kept)
+ */
+void powerOn();
+
+/**
+ * @brief Program/erase operations performed since configure()
+ */
+uint32_t operationCount();
+
+/**
+ * @brief Save the partition image to a file
+ */
+esp_err_t saveImage(const char* path);
+
+/**
+ * @brief Load a partition image saved by saveImage() (sizes must match)
+ */
+esp_err_t loadImage(const char* path);
+
+/**
+ * @brief Direct access to the image (tests)
+ */
+const uint8_t* data();
+size_t size();
+
+Stats getStats();
+void resetStats();
+
+} // namespace SimFlash
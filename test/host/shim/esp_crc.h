@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Host shim: same result as the ROM crc32_le (zlib CRC-32 for crc = 0)
+uint32_t esp_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
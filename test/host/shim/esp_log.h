@@ -0,0 +1,29 @@
+#pragma once
+
+// Host shim: ESP_LOGx to stderr. The level is taken from HOST_LOG_LEVEL
+// (E, W, I, D; default W) so test output stays readable.
+
+enum esp_log_level_t {
+  ESP_LOG_NONE,
+  ESP_LOG_ERROR,
+  ESP_LOG_WARN,
+  ESP_LOG_INFO,
+  ESP_LOG_DEBUG,
+  ESP_LOG_VERBOSE
+};
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format,
+                   ...);
+
+#define ESP_LOGE(tag, format, ...)                                             \
+  esp_log_write(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)                                             \
+  esp_log_write(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)                                             \
+  esp_log_write(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)                                             \
+  esp_log_write(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)                                             \
+  esp_log_write(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+#define ESP_LOG_LEVEL(level, tag, format, ...)                                 \
+  esp_log_write(level, tag, format, ##__VA_ARGS__)
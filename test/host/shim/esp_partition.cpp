@@ -0,0 +1,243 @@
+#include "SimFlash.h"
+#include "esp_partition.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SimFlash {
+
+static std::mutex s_lock;
+static esp_partition_t s_partition = {};
+static std::vector<uint8_t> s_image;
+static std::vector<uint32_t> s_sectorErases;
+static Timing s_timing;
+static Stats s_stats = {};
+static uint32_t s_operations = 0;
+static uint32_t s_cutAt = 0;  // Operation count that loses power, 0 = never
+static bool s_off = false;
+
+// Account modelled busy time; sleeps outside the lock when scaled
+static void spend(std::unique_lock<std::mutex>& lock, uint64_t us) {
+    s_stats.busyUs += us;
+    if (s_timing.timeScale > 0.0f) {
+        lock.unlock();
+        std::this_thread::sleep_for(
+            std::chrono::microseconds((uint64_t)(us * s_timing.timeScale)));
+        lock.lock();
+    }
+}
+
+// Count one program/erase; returns how much of it lands (1 = all,
+// 0.5 = torn, 0 = nothing)
+static float beginOperation() {
+    if (s_off) {
+        return 0.0f;
+    }
+    s_operations++;
+    if (s_cutAt != 0 && s_operations >= s_cutAt) {
+        s_off = true;
+        s_cutAt = 0;
+        return 0.5f;
+    }
+    return 1.0f;
+}
+
+esp_err_t configure(const char* label, size_t size, const Timing& timing) {
+    if (size == 0 || size % SECTOR_SIZE != 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_image.assign(size, 0xFF);
+    s_sectorErases.assign(size / SECTOR_SIZE, 0);
+    s_partition = {};
+    s_partition.type = ESP_PARTITION_TYPE_DATA;
+    s_partition.subtype = 0x80;
+    s_partition.address = 0x190000;
+    s_partition.size = (uint32_t)size;
+    s_partition.erase_size = SECTOR_SIZE;
+    strncpy(s_partition.label, label, sizeof(s_partition.label) - 1);
+    s_timing = timing;
+    s_stats = {};
+    s_operations = 0;
+    s_cutAt = 0;
+    s_off = false;
+    return ESP_OK;
+}
+
+void setTiming(const Timing& timing) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_timing = timing;
+}
+
+void cutPowerAfter(uint32_t operations) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_cutAt = s_operations + std::max<uint32_t>(operations, 1);
+}
+
+bool poweredOff() {
+    std::lock_guard<std::mutex> guard(s_lock);
+    return s_off;
+}
+
+void powerOn() {
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_off = false;
+    s_cutAt = 0;
+}
+
+uint32_t operationCount() {
+    std::lock_guard<std::mutex> guard(s_lock);
+    return s_operations;
+}
+
+esp_err_t saveImage(const char* path) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        return ESP_FAIL;
+    }
+    size_t n = fwrite(s_image.data(), 1, s_image.size(), f);
+    fclose(f);
+    return (n == s_image.size()) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t loadImage(const char* path) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    std::vector<uint8_t> image(s_image.size());
+    size_t n = fread(image.data(), 1, image.size(), f);
+    bool extra = fgetc(f) != EOF;
+    fclose(f);
+    if (n != image.size() || extra) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    s_image.swap(image);
+    return ESP_OK;
+}
+
+const uint8_t* data() { return s_image.data(); }
+
+size_t size() { return s_image.size(); }
+
+Stats getStats() {
+    std::lock_guard<std::mutex> guard(s_lock);
+    return s_stats;
+}
+
+void resetStats() {
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_stats = {};
+    std::fill(s_sectorErases.begin(), s_sectorErases.end(), 0);
+}
+
+} // namespace SimFlash
+
+using namespace SimFlash;
+
+static bool inRange(const esp_partition_t* partition, size_t offset, size_t len) {
+    return partition == &s_partition && offset <= s_image.size() &&
+           len <= s_image.size() - offset;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char* label) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    if (s_image.empty() || (type != ESP_PARTITION_TYPE_ANY && type != s_partition.type) ||
+        (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != s_partition.subtype) ||
+        (label && strcmp(label, s_partition.label) != 0)) {
+        return nullptr;
+    }
+    return &s_partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset,
+                             void* dst, size_t size) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    if (!dst || !inRange(partition, src_offset, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(dst, &s_image[src_offset], size);
+    s_stats.bytesRead += size;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset,
+                              const void* src, size_t size) {
+    std::unique_lock<std::mutex> lock(s_lock);
+    if (!src || !inRange(partition, dst_offset, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    float lands = beginOperation();
+    size_t len = (size_t)(size * lands);
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < len; i++) {
+        uint8_t& cell = s_image[dst_offset + i];
+        if (in[i] & ~cell) {
+            s_stats.bitViolations++;
+        }
+        cell &= in[i];
+    }
+    if (lands == 0.0f) {
+        return ESP_OK;
+    }
+
+    size_t pages = (dst_offset + size + PROGRAM_PAGE - 1) / PROGRAM_PAGE -
+                   dst_offset / PROGRAM_PAGE;
+    s_stats.bytesProgrammed += len;
+    s_stats.programCalls++;
+    spend(lock, s_timing.callOverheadUs + (uint64_t)pages * s_timing.programPageUs);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition,
+                                    size_t offset, size_t size) {
+    std::unique_lock<std::mutex> lock(s_lock);
+    if (!inRange(partition, offset, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset % SECTOR_SIZE != 0 || size % SECTOR_SIZE != 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    spend(lock, s_timing.callOverheadUs);
+    for (size_t sector = offset; sector < offset + size; sector += SECTOR_SIZE) {
+        float lands = beginOperation();
+        if (lands == 0.0f) {
+            break;
+        }
+        memset(&s_image[sector], 0xFF, (size_t)(SECTOR_SIZE * lands));
+        uint32_t& count = s_sectorErases[sector / SECTOR_SIZE];
+        count++;
+        s_stats.maxSectorErases = std::max(s_stats.maxSectorErases, count);
+        s_stats.sectorErases++;
+        spend(lock, s_timing.eraseSectorUs);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void** out_ptr,
+                             esp_partition_mmap_handle_t* out_handle) {
+    std::lock_guard<std::mutex> guard(s_lock);
+    if (!out_ptr || !out_handle || size == 0 || !inRange(partition, offset, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    (void)memory;
+    static esp_partition_mmap_handle_t s_nextHandle = 0;
+    *out_ptr = &s_image[offset];
+    *out_handle = ++s_nextHandle;
+    s_stats.mmapCalls++;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {
+    (void)handle;
+}
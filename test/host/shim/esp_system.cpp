@@ -0,0 +1,166 @@
+#include "esp_crc.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "utils/LedManager.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+// --- esp_err ---
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+  case ESP_OK: return "ESP_OK";
+  case ESP_FAIL: return "ESP_FAIL";
+  case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+  case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+  case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+  case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+  case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+  case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+  case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+  case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+  case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+  case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+  case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+  default: return "UNKNOWN ERROR";
+  }
+}
+
+// --- esp_log ---
+
+static esp_log_level_t logLevel() {
+  static const esp_log_level_t level = [] {
+    const char *env = getenv("HOST_LOG_LEVEL");
+    switch (env ? env[0] : 'W') {
+    case 'N': return ESP_LOG_NONE;
+    case 'E': return ESP_LOG_ERROR;
+    case 'I': return ESP_LOG_INFO;
+    case 'D': return ESP_LOG_DEBUG;
+    case 'V': return ESP_LOG_VERBOSE;
+    default: return ESP_LOG_WARN;
+    }
+  }();
+  return level;
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format,
+                   ...) {
+  if (level > logLevel()) {
+    return;
+  }
+  static std::mutex lock;
+  static const char LETTERS[] = "NEWIDV";
+  std::lock_guard<std::mutex> guard(lock);
+  fprintf(stderr, "%c (%lld) %s: ", LETTERS[level],
+          (long long)(esp_timer_get_time() / 1000), tag);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+}
+
+// --- esp_timer ---
+
+int64_t esp_timer_get_time() {
+  using Clock = std::chrono::steady_clock;
+  static const Clock::time_point start = Clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               start)
+      .count();
+}
+
+// --- esp_crc ---
+
+uint32_t esp_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  static uint32_t table[256];
+  static std::once_flag once;
+  std::call_once(once, [] {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      table[i] = c;
+    }
+  });
+
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc = table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+// --- esp_heap_caps ---
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? nullptr : malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? nullptr : calloc(n, size);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps) {
+  if (caps & MALLOC_CAP_SPIRAM) {
+    return nullptr;
+  }
+  size_t rounded = (size + alignment - 1) / alignment * alignment;
+  return aligned_alloc(alignment, rounded);
+}
+
+void heap_caps_free(void *ptr) { free(ptr); }
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? 0 : 256 * 1024;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
+
+// --- nvs ---
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *out) {
+  (void)name;
+  (void)mode;
+  (void)out;
+  return ESP_ERR_NVS_NOT_INITIALIZED;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key) {
+  (void)handle;
+  (void)key;
+  return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+  (void)handle;
+  return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { (void)handle; }
+
+// --- LedManager (no LED on the host) ---
+
+namespace LedManager {
+
+static State s_state = State::IDLE;
+
+esp_err_t init(int) { return ESP_OK; }
+void setState(State state) { s_state = state; }
+State getState() { return s_state; }
+void setDataActivity(bool active) { (void)active; }
+
+} // namespace LedManager
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Host shim: microseconds since process start (monotonic)
+int64_t esp_timer_get_time();
@@ -0,0 +1,297 @@
+#include "freertos/FreeRTOS.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One lock and condition variable for every kernel object: waits are rare
+// and short in the code under test, and it keeps wake-ups trivially
+// correct (every state change notifies all waiters).
+struct Kernel {
+  std::mutex lock;
+  std::condition_variable changed;
+};
+
+// Never destroyed, so detached task threads can outlive static teardown
+static Kernel &kernel() {
+  static Kernel *k = new Kernel;
+  return *k;
+}
+
+struct HostTask {
+  std::string name;
+  BaseType_t coreId = 0;
+  uint32_t notifyCount = 0;
+  bool deleteRequested = false;
+  bool suspended = false;
+  bool exited = false;
+};
+
+struct HostQueue {
+  size_t length;
+  size_t itemSize;
+  size_t count;
+  size_t head;
+  std::vector<uint8_t> storage;
+};
+
+// Thrown inside a task to unwind it on vTaskDelete()
+struct TaskExit {};
+
+static thread_local HostTask *t_self = nullptr;
+
+using Clock = std::chrono::steady_clock;
+
+static Clock::time_point startTime() {
+  static const Clock::time_point start = Clock::now();
+  return start;
+}
+
+static HostTask *self() {
+  if (!t_self) {
+    // Threads not created by xTaskCreate (e.g. main) become tasks lazily
+    t_self = new HostTask;
+    t_self->name = "main";
+  }
+  return t_self;
+}
+
+// Wait on the kernel condition until pred() holds or the ticks run out.
+// Caller holds the kernel lock. Unwinds the task if it gets deleted.
+template <typename Pred>
+static bool waitFor(std::unique_lock<std::mutex> &lock, TickType_t wait,
+                    Pred pred) {
+  HostTask *task = self();
+  Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(wait);
+  while (true) {
+    if (task->deleteRequested) {
+      throw TaskExit();
+    }
+    if (pred()) {
+      return true;
+    }
+    if (wait == 0) {
+      return false;
+    }
+    if (wait == portMAX_DELAY) {
+      kernel().changed.wait(lock);
+    } else if (kernel().changed.wait_until(lock, deadline) ==
+                   std::cv_status::timeout &&
+               !pred()) {
+      if (task->deleteRequested) {
+        throw TaskExit();
+      }
+      return false;
+    }
+  }
+}
+
+BaseType_t xPortGetCoreID() { return self()->coreId; }
+
+// --- Tasks ---
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name,
+                                   uint32_t stackDepth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t coreId) {
+  (void)stackDepth;
+  (void)priority;
+  HostTask *task = new HostTask;
+  task->name = name ? name : "";
+  task->coreId = (coreId == tskNO_AFFINITY) ? 0 : coreId;
+
+  // Published before the task runs, as FreeRTOS does
+  if (handle) {
+    *handle = task;
+  }
+
+  std::thread([function, arg, task]() {
+    t_self = task;
+    try {
+      function(arg);
+    } catch (const TaskExit &) {
+    }
+    std::lock_guard<std::mutex> guard(kernel().lock);
+    task->exited = true;
+    kernel().changed.notify_all();
+  }).detach();
+  return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t function,
+                                           const char *name,
+                                           uint32_t stackDepth, void *arg,
+                                           UBaseType_t priority,
+                                           StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t coreId) {
+  (void)stack;
+  (void)tcb;
+  TaskHandle_t handle = nullptr;
+  xTaskCreatePinnedToCore(function, name, stackDepth, arg, priority, &handle,
+                          coreId);
+  return handle;
+}
+
+void vTaskSuspend(TaskHandle_t task) {
+  HostTask *target = task ? task : self();
+  std::unique_lock<std::mutex> lock(kernel().lock);
+  target->suspended = true;
+  kernel().changed.notify_all();
+  if (target == self()) {
+    waitFor(lock, portMAX_DELAY, [] { return false; });
+  }
+}
+
+eTaskState eTaskGetState(TaskHandle_t task) {
+  std::lock_guard<std::mutex> guard(kernel().lock);
+  if (task->exited) {
+    return eDeleted;
+  }
+  return task->suspended ? eSuspended : eReady;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t coreId) {
+  (void)coreId;
+  return nullptr;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (!task || task == self()) {
+    throw TaskExit();
+  }
+
+  std::unique_lock<std::mutex> lock(kernel().lock);
+  task->deleteRequested = true;
+  kernel().changed.notify_all();
+  kernel().changed.wait(lock, [task] { return task->exited; });
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(kernel().lock);
+  waitFor(lock, ticks ? ticks : 1, [] { return false; });
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+             Clock::now() - startTime())
+      .count();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return self(); }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  std::lock_guard<std::mutex> guard(kernel().lock);
+  task->notifyCount++;
+  kernel().changed.notify_all();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+  xTaskNotifyGive(task);
+  if (woken) {
+    *woken = pdFALSE;
+  }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait) {
+  HostTask *task = self();
+  std::unique_lock<std::mutex> lock(kernel().lock);
+  waitFor(lock, wait, [task] { return task->notifyCount > 0; });
+  uint32_t value = task->notifyCount;
+  if (value > 0) {
+    task->notifyCount = clearOnExit ? 0 : value - 1;
+  }
+  return value;
+}
+
+// --- Queues ---
+
+static HostQueue *createQueue(size_t length, size_t itemSize, size_t count) {
+  HostQueue *queue = new HostQueue;
+  queue->length = length;
+  queue->itemSize = itemSize;
+  queue->count = count;
+  queue->head = 0;
+  queue->storage.resize(length * itemSize);
+  return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  return length ? createQueue(length, itemSize, 0) : nullptr;
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+  std::unique_lock<std::mutex> lock(kernel().lock);
+  if (!waitFor(lock, wait, [queue] { return queue->count < queue->length; })) {
+    return pdFALSE;
+  }
+  if (queue->itemSize > 0) {
+    size_t slot = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[slot * queue->itemSize], item, queue->itemSize);
+  }
+  queue->count++;
+  kernel().changed.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+                             BaseType_t *woken) {
+  if (woken) {
+    *woken = pdFALSE;
+  }
+  return xQueueSend(queue, item, 0);
+}
+
+static BaseType_t takeItem(QueueHandle_t queue, void *item, TickType_t wait,
+                           bool remove) {
+  std::unique_lock<std::mutex> lock(kernel().lock);
+  if (!waitFor(lock, wait, [queue] { return queue->count > 0; })) {
+    return pdFALSE;
+  }
+  if (queue->itemSize > 0 && item) {
+    memcpy(item, &queue->storage[queue->head * queue->itemSize],
+           queue->itemSize);
+  }
+  if (remove) {
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    kernel().changed.notify_all();
+  }
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+  return takeItem(queue, item, wait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait) {
+  return takeItem(queue, item, wait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(kernel().lock);
+  return (UBaseType_t)queue->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(kernel().lock);
+  queue->count = 0;
+  queue->head = 0;
+  kernel().changed.notify_all();
+  return pdPASS;
+}
+
+// --- Semaphores ---
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return createQueue(1, 0, 0); }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return createQueue(1, 0, 1); }
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount,
+                                           UBaseType_t initialCount) {
+  return createQueue(maxCount, 0, initialCount);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Host shim: the FreeRTOS subset used by the storage and pipeline code,
+ * on top of std::thread.
+ *
+ * - Tasks are threads; priorities and core affinity are recorded but not
+ *   enforced (xPortGetCoreID() reports the requested core).
+ * - One tick is one millisecond of wall time.
+ * - Queues, semaphores, mutexes and task notifications share one kernel
+ *   lock and condition variable.
+ * - vTaskDelete() of another task takes effect at that task's next
+ *   blocking call (delay, queue, semaphore or notification), and waits
+ *   for it. Task handles stay valid after the task has exited.
+ * - Critical sections are a recursive mutex per portMUX_TYPE.
+ */
+
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMAX_PRIORITIES 25
+#define configRUN_TIME_COUNTER_TYPE uint32_t
+#define tskIDLE_PRIORITY 0
+#define tskNO_AFFINITY 0x7FFFFFFF
+#define portNUM_PROCESSORS 2
+
+struct HostTask;
+struct HostQueue;
+
+typedef HostTask *TaskHandle_t;
+typedef HostQueue *QueueHandle_t;
+typedef HostQueue *SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// Static task memory is accepted and ignored (tasks are threads)
+struct StaticTask_t {
+  void *reserved[4];
+};
+
+typedef enum { eRunning, eReady, eBlocked, eSuspended, eDeleted, eInvalid } eTaskState;
+
+struct HostSpinlock {
+  std::recursive_mutex mutex;
+};
+typedef HostSpinlock portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux) (mux)->mutex.lock()
+#define portEXIT_CRITICAL(mux) (mux)->mutex.unlock()
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+#define portENTER_CRITICAL_SAFE(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_SAFE(mux) portEXIT_CRITICAL(mux)
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+BaseType_t xPortGetCoreID();
+
+// --- Tasks ---
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name,
+                                   uint32_t stackDepth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t coreId);
+
+#define xTaskCreate(function, name, stackDepth, arg, priority, handle)         \
+  xTaskCreatePinnedToCore(function, name, stackDepth, arg, priority, handle,   \
+                          tskNO_AFFINITY)
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t function,
+                                           const char *name,
+                                           uint32_t stackDepth, void *arg,
+                                           UBaseType_t priority,
+                                           StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t coreId);
+
+void vTaskDelete(TaskHandle_t task);
+// Suspending the calling task blocks it until deleted; suspending another
+// task is recorded but not enforced
+void vTaskSuspend(TaskHandle_t task);
+eTaskState eTaskGetState(TaskHandle_t task);
+// Host threads are never reported as running on a core
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t coreId);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait);
+
+// --- Queues ---
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait);
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+                             BaseType_t *woken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+#define xQueueSendToBack xQueueSend
+
+// --- Semaphores (queues without items, as in FreeRTOS) ---
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount,
+                                           UBaseType_t initialCount);
+
+#define xSemaphoreTake(sem, wait) xQueueReceive(sem, nullptr, wait)
+#define xSemaphoreGive(sem) xQueueSend(sem, nullptr, 0)
+#define xSemaphoreGiveFromISR(sem, woken) xQueueSendFromISR(sem, nullptr, woken)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+#define uxSemaphoreGetCount(sem) uxQueueMessagesWaiting(sem)